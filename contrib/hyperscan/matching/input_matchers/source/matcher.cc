@@ -86,6 +86,27 @@ bool Matcher::match(absl::string_view value) const {
   return matched;
 }
 
+bool Matcher::matchAll(absl::string_view value, std::vector<unsigned int>& ids) const {
+  ScratchThreadLocalPtr local_scratch;
+  hs_scratch_t* scratch = getScratch(local_scratch);
+  hs_error_t err = hs_scan(
+      database_, value.data(), value.size(), 0, scratch,
+      [](unsigned int id, unsigned long long, unsigned long long, unsigned int,
+         void* context) -> int {
+        std::vector<unsigned int>* ids = static_cast<std::vector<unsigned int>*>(context);
+        ids->push_back(id);
+
+        // Continue searching.
+        return 0;
+      },
+      &ids);
+  if (err != HS_SUCCESS) {
+    IS_ENVOY_BUG(fmt::format("unable to scan, error code {}", err));
+    return false;
+  }
+  return true;
+}
+
 std::string Matcher::replaceAll(absl::string_view value, absl::string_view substitution) const {
   // Find matched bounds.
   std::vector<Bound> bounds;
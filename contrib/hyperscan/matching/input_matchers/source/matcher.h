@@ -47,6 +47,15 @@ public:
 
   const std::string& pattern() const override { return EMPTY_STRING; }
 
+  /**
+   * Scan the value once and collect the ids of all expressions that match it.
+   * @param value supplies the value to scan.
+   * @param ids receives the id of every matching expression. An id is reported once per match
+   *        unless the expression was compiled with HS_FLAG_SINGLEMATCH.
+   * @return false if the scan failed.
+   */
+  bool matchAll(absl::string_view value, std::vector<unsigned int>& ids) const;
+
 private:
   hs_database_t* database_{};
   hs_database_t* start_of_match_database_{};
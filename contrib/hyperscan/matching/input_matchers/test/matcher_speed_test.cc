@@ -9,6 +9,7 @@
 
 #include "test/mocks/event/mocks.h"
 
+#include "absl/strings/str_cat.h"
 #include "benchmark/benchmark.h"
 #include "contrib/hyperscan/matching/input_matchers/source/matcher.h"
 
@@ -65,4 +66,81 @@ static void BM_HyperscanMatcher(benchmark::State& state) {
 }
 BENCHMARK(BM_HyperscanMatcher);
 
+// Route table like path regexes, e.g. "^/api/v2/service17/[a-z]+/[0-9]+$", and paths that match
+// the first pattern, no pattern and the last pattern.
+std::vector<std::string> routePatterns(int64_t count) {
+  std::vector<std::string> patterns;
+  patterns.reserve(count);
+  for (int64_t i = 0; i < count; ++i) {
+    patterns.push_back(absl::StrCat("^/api/v", i % 3, "/service", i, "/[a-z]+/[0-9]+$"));
+  }
+  return patterns;
+}
+
+std::vector<std::string> routePaths(int64_t count) {
+  const int64_t last = count - 1;
+  std::vector<std::string> paths{"/api/v0/service0/users/42", "/static/assets/app.js"};
+  paths.push_back(absl::StrCat("/api/v", last % 3, "/service", last, "/orders/7"));
+  return paths;
+}
+
+// Evaluates the patterns one by one until one matches.
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_CompiledGoogleReMatcherSequential(benchmark::State& state) {
+  std::vector<std::unique_ptr<Regex::CompiledGoogleReMatcher>> matchers;
+  for (const std::string& pattern : routePatterns(state.range(0))) {
+    envoy::type::matcher::v3::RegexMatcher config;
+    config.mutable_google_re2();
+    config.set_regex(pattern);
+    matchers.push_back(Regex::CompiledGoogleReMatcher::create(config).value());
+  }
+  const std::vector<std::string> paths = routePaths(state.range(0));
+  uint32_t passes = 0;
+  for (auto _ : state) { // NOLINT
+    for (const std::string& path : paths) {
+      for (const auto& matcher : matchers) {
+        if (matcher->match(path)) {
+          ++passes;
+          break;
+        }
+      }
+    }
+  }
+  RELEASE_ASSERT(passes > 0, "");
+}
+BENCHMARK(BM_CompiledGoogleReMatcherSequential)->Arg(100)->Arg(1000);
+
+// Evaluates all patterns with a single scan of a multi-pattern database.
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_HyperscanMultiPatternMatcher(benchmark::State& state) {
+  Event::MockDispatcher dispatcher;
+  ThreadLocal::InstanceImpl instance;
+  const std::vector<std::string> patterns = routePatterns(state.range(0));
+  std::vector<const char*> expressions;
+  std::vector<unsigned int> flags;
+  std::vector<unsigned int> ids;
+  for (const std::string& pattern : patterns) {
+    expressions.push_back(pattern.c_str());
+    flags.push_back(HS_FLAG_SINGLEMATCH);
+    ids.push_back(static_cast<unsigned int>(ids.size()));
+  }
+  auto matcher = Extensions::Matching::InputMatchers::Hyperscan::Matcher(
+      expressions, flags, ids, dispatcher, instance, false);
+  const std::vector<std::string> paths = routePaths(state.range(0));
+  std::vector<unsigned int> matched;
+  uint32_t passes = 0;
+  for (auto _ : state) { // NOLINT
+    for (const std::string& path : paths) {
+      matched.clear();
+      matcher.matchAll(path, matched);
+      if (!matched.empty()) {
+        ++passes;
+      }
+    }
+  }
+  RELEASE_ASSERT(passes > 0, "");
+  instance.shutdownGlobalThreading();
+}
+BENCHMARK(BM_HyperscanMultiPatternMatcher)->Arg(100)->Arg(1000);
+
 } // namespace Envoy
@@ -1,10 +1,54 @@
 #include "contrib/hyperscan/regex_engines/source/regex.h"
 
+#include <algorithm>
+
 namespace Envoy {
 namespace Extensions {
 namespace Regex {
 namespace Hyperscan {
 
+namespace {
+
+std::unique_ptr<Matching::InputMatchers::Hyperscan::Matcher>
+createSetMatcher(const std::vector<std::string>& regexes, Event::Dispatcher& dispatcher,
+                 ThreadLocal::SlotAllocator& tls) {
+  std::vector<const char*> expressions;
+  std::vector<unsigned int> flags;
+  std::vector<unsigned int> ids;
+  expressions.reserve(regexes.size());
+  flags.reserve(regexes.size());
+  ids.reserve(regexes.size());
+  for (const std::string& regex : regexes) {
+    expressions.push_back(regex.c_str());
+    // Only whether an expression matches is of interest, so stop reporting it after the first
+    // match.
+    flags.push_back(HS_FLAG_UTF8 | HS_FLAG_SINGLEMATCH);
+    ids.push_back(static_cast<unsigned int>(ids.size()));
+  }
+
+  return std::make_unique<Matching::InputMatchers::Hyperscan::Matcher>(expressions, flags, ids,
+                                                                       dispatcher, tls, false);
+}
+
+} // namespace
+
+HyperscanMatcherSet::HyperscanMatcherSet(const std::vector<std::string>& regexes,
+                                         Event::Dispatcher& dispatcher,
+                                         ThreadLocal::SlotAllocator& tls)
+    : size_(regexes.size()), matcher_(createSetMatcher(regexes, dispatcher, tls)) {}
+
+bool HyperscanMatcherSet::match(absl::string_view value, std::vector<uint32_t>& matched) const {
+  std::vector<unsigned int> ids;
+  if (!matcher_->matchAll(value, ids)) {
+    matched.clear();
+    return false;
+  }
+  // Hyperscan reports matches in the order of their end offsets.
+  std::sort(ids.begin(), ids.end());
+  matched.assign(ids.begin(), ids.end());
+  return true;
+}
+
 HyperscanEngine::HyperscanEngine(Event::Dispatcher& dispatcher, ThreadLocal::SlotAllocator& tls)
     : dispatcher_(dispatcher), tls_(tls) {}
 
@@ -18,6 +62,11 @@ HyperscanEngine::matcher(const std::string& regex) const {
                                                                        dispatcher_, tls_, true);
 }
 
+absl::StatusOr<Envoy::Regex::CompiledMatcherSetPtr>
+HyperscanEngine::matcherSet(const std::vector<std::string>& regexes) const {
+  return std::make_unique<HyperscanMatcherSet>(regexes, dispatcher_, tls_);
+}
+
 } // namespace Hyperscan
 } // namespace Regex
 } // namespace Extensions
@@ -9,10 +9,28 @@ namespace Extensions {
 namespace Regex {
 namespace Hyperscan {
 
+// All expressions of the set compiled into a single Hyperscan database, so that matching the set
+// takes one scan of the value regardless of the number of expressions.
+class HyperscanMatcherSet : public Envoy::Regex::CompiledMatcherSet {
+public:
+  HyperscanMatcherSet(const std::vector<std::string>& regexes, Event::Dispatcher& dispatcher,
+                      ThreadLocal::SlotAllocator& tls);
+
+  // Envoy::Regex::CompiledMatcherSet
+  bool match(absl::string_view value, std::vector<uint32_t>& matched) const override;
+  uint32_t size() const override { return size_; }
+
+private:
+  const uint32_t size_;
+  std::unique_ptr<Matching::InputMatchers::Hyperscan::Matcher> matcher_;
+};
+
 class HyperscanEngine : public Envoy::Regex::Engine {
 public:
   explicit HyperscanEngine(Event::Dispatcher& dispatcher, ThreadLocal::SlotAllocator& tls);
   absl::StatusOr<Envoy::Regex::CompiledMatcherPtr> matcher(const std::string& regex) const override;
+  absl::StatusOr<Envoy::Regex::CompiledMatcherSetPtr>
+  matcherSet(const std::vector<std::string>& regexes) const override;
 
 private:
   Event::Dispatcher& dispatcher_;
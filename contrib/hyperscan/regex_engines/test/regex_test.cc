@@ -33,6 +33,47 @@ TEST_F(EngineTest, Matcher) {
   EXPECT_TRUE(engine_->matcher("^/asdf/.+").status().ok());
 }
 
+// Verify that a matcher set reports every matching expression once, in index order, and agrees
+// with the matchers created for the individual expressions.
+TEST_F(EngineTest, MatcherSet) {
+  setup();
+
+  const std::vector<std::string> regexes{"^/api/v[0-9]+/users$", "^/api/.+", "^/static/.+",
+                                         "users", "^/api/v1/users/[0-9]+$"};
+  auto set = engine_->matcherSet(regexes);
+  ASSERT_TRUE(set.ok());
+  EXPECT_EQ(5, (*set)->size());
+
+  std::vector<uint32_t> matched;
+  EXPECT_TRUE((*set)->match("/api/v1/users", matched));
+  EXPECT_EQ((std::vector<uint32_t>{0, 1, 3}), matched);
+
+  (*set)->match("/api/v1/users/42", matched);
+  EXPECT_EQ((std::vector<uint32_t>{1, 3, 4}), matched);
+
+  (*set)->match("/other", matched);
+  EXPECT_TRUE(matched.empty());
+
+  for (absl::string_view value : {"/api/v1/users", "/static/users/a.css", "/users", "/"}) {
+    (*set)->match(value, matched);
+    for (uint32_t i = 0; i < regexes.size(); ++i) {
+      const bool in_set = std::find(matched.begin(), matched.end(), i) != matched.end();
+      EXPECT_EQ(engine_->matcher(regexes[i]).value()->match(value), in_set)
+          << regexes[i] << " " << value;
+    }
+  }
+}
+
+// Verify that an invalid expression in a set is reported.
+TEST_F(EngineTest, MatcherSetInvalidExpression) {
+  setup();
+
+  EXPECT_THROW_WITH_MESSAGE(
+      engine_->matcherSet({"^/valid$", "(invalid"}).IgnoreError(), EnvoyException,
+      "unable to compile pattern '(invalid': Missing close parenthesis for group started at index "
+      "0.");
+}
+
 } // namespace Hyperscan
 } // namespace Regex
 } // namespace Extensions
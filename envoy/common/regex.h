@@ -1,6 +1,8 @@
 #pragma once
 
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "envoy/common/matchers.h"
 #include "envoy/config/typed_config.h"
@@ -34,6 +36,33 @@ public:
 
 using CompiledMatcherPtr = std::unique_ptr<const CompiledMatcher>;
 
+/**
+ * A set of regex expressions compiled together so that all of them can be matched against a value
+ * in a single pass.
+ */
+class CompiledMatcherSet {
+public:
+  virtual ~CompiledMatcherSet() = default;
+
+  /**
+   * Match all expressions of the set against a value.
+   * @param value supplies the value to match.
+   * @param matched receives, in ascending order, the index of every expression that matches the
+   *        value, where indices follow the order of the expressions given to
+   *        Engine::matcherSet(). The vector is cleared first.
+   * @return false if the set could not be evaluated, e.g. because the engine ran out of memory. In
+   *         that case callers must fall back to evaluating the expressions one by one.
+   */
+  virtual bool match(absl::string_view value, std::vector<uint32_t>& matched) const PURE;
+
+  /**
+   * @return the number of expressions in the set.
+   */
+  virtual uint32_t size() const PURE;
+};
+
+using CompiledMatcherSetPtr = std::unique_ptr<const CompiledMatcherSet>;
+
 /**
  * A regular expression engine which turns regular expressions into compiled matchers.
  */
@@ -46,6 +75,19 @@ public:
    * @param regex the regex expression match string
    */
   virtual absl::StatusOr<CompiledMatcherPtr> matcher(const std::string& regex) const PURE;
+
+  /**
+   * Create a @ref CompiledMatcherSet for the given regex expressions. An expression must match in
+   * the set exactly when the matcher created for it by matcher() matches, so that callers can use
+   * the set to evaluate many matchers at once.
+   * @param regexes the regex expressions.
+   * @return the compiled set, or an Unimplemented error if the engine does not support matching
+   *         multiple expressions in a single pass.
+   */
+  virtual absl::StatusOr<CompiledMatcherSetPtr>
+  matcherSet(const std::vector<std::string>& /*regexes*/) const {
+    return absl::UnimplementedError("regex engine does not support matcher sets");
+  }
 };
 
 using EnginePtr = std::shared_ptr<Engine>;
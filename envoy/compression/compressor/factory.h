@@ -13,6 +13,15 @@ public:
   virtual CompressorPtr createCompressor() PURE;
   virtual const std::string& statsPrefix() const PURE;
   virtual const std::string& contentEncoding() const PURE;
+
+  /**
+   * Creates a compressor which spends a reduced amount of CPU on compression.
+   * @param effort supplies the relative effort in the range [0, 1]. 1 corresponds to the
+   *        configured compression level of the library and 0 to its fastest level. Libraries
+   *        that have no notion of a compression level ignore the effort.
+   * @return CompressorPtr the new compressor.
+   */
+  virtual CompressorPtr createCompressorWithEffort(double /*effort*/) { return createCompressor(); }
 };
 
 using CompressorFactoryPtr = std::unique_ptr<CompressorFactory>;
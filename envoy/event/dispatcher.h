@@ -1,5 +1,6 @@
 #pragma once
 
+#include <chrono>
 #include <cstdint>
 #include <functional>
 #include <memory>
@@ -51,6 +52,19 @@ struct DispatcherStats {
 
 using DispatcherStatsPtr = std::unique_ptr<DispatcherStats>;
 
+/**
+ * Configuration of the tracker of slow dispatcher callbacks.
+ * @see Dispatcher::initializeSlowCallbackTracker.
+ */
+struct SlowCallbackTrackerConfig {
+  // Timed callbacks running for at least this long are recorded.
+  std::chrono::milliseconds threshold_;
+  // One in this many callbacks is timed.
+  uint32_t sampling_interval_;
+  // The number of slow callbacks kept per dispatcher.
+  uint32_t max_records_;
+};
+
 /**
  * Callback invoked when a dispatcher post() runs.
  */
@@ -149,6 +163,14 @@ public:
    */
   virtual Event::TimerPtr createScaledTimer(Event::ScaledTimerMinimum minimum, TimerCb cb) PURE;
 
+  /**
+   * Allocates a timer on the dispatcher's timer wheel. @see Timer for docs on how to use the timer.
+   * Wheel timers are cheaper to enable and disable than those from createTimer(), which suits
+   * large numbers of frequently re-armed timers, but fire up to a millisecond late.
+   * @param cb supplies the callback to invoke when the timer fires.
+   */
+  virtual Event::TimerPtr createWheelTimer(TimerCb cb) PURE;
+
   /**
    * Allocates a schedulable callback. @see SchedulableCallback for docs on how to use the wrapped
    * callback.
@@ -187,6 +209,13 @@ public:
   virtual void initializeStats(Stats::Scope& scope,
                                const absl::optional<std::string>& prefix = absl::nullopt) PURE;
 
+  /**
+   * Starts recording the callbacks of this dispatcher which stall its event loop. Like stats, this
+   * is initialized after construction, once the bootstrap has been loaded.
+   * @param config supplies the threshold, sampling interval and number of records to keep.
+   */
+  virtual void initializeSlowCallbackTracker(const SlowCallbackTrackerConfig& config) PURE;
+
   /**
    * Clears any items in the deferred deletion queue.
    */
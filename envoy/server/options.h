@@ -96,6 +96,13 @@ public:
    */
   virtual bool skipHotRestartParentStats() const PURE;
 
+  /**
+   * @return uint64_t the number of counters and gauges to place in shared memory, so that they
+   *         are shared with hot restart parents and children rather than copied from the parent.
+   *         0 if stats are held in process memory.
+   */
+  virtual uint64_t hotRestartStatsCapacity() const PURE;
+
   /**
    * @return const std::string& the dynamic base id output file.
    */
@@ -106,6 +113,12 @@ public:
    */
   virtual uint32_t concurrency() const PURE;
 
+  /**
+   * @return the number of threads to build the TLS contexts of the static configuration on at
+   *         startup, or 0 to build them on the main thread as they are configured.
+   */
+  virtual uint32_t startupConcurrency() const PURE;
+
   /**
    * @return the duration of the drain period in seconds.
    */
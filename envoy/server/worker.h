@@ -2,6 +2,7 @@
 
 #include <functional>
 
+#include "envoy/config/bootstrap/v3/bootstrap.pb.h"
 #include "envoy/event/dispatcher.h"
 #include "envoy/runtime/runtime.h"
 #include "envoy/server/guarddog.h"
@@ -57,6 +58,13 @@ public:
    */
   virtual void initializeStats(Stats::Scope& scope) PURE;
 
+  /**
+   * Starts recording the slow callbacks of this worker's dispatcher.
+   * @param config supplies the slow callback tracker configuration.
+   */
+  virtual void initializeSlowCallbackTracker(
+      const envoy::config::bootstrap::v3::SlowCallbackTracker& config) PURE;
+
   /**
    * Stop the worker thread.
    */
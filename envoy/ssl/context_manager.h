@@ -2,6 +2,7 @@
 
 #include <functional>
 
+#include "envoy/common/callback.h"
 #include "envoy/common/time.h"
 #include "envoy/config/typed_config.h"
 #include "envoy/ssl/context.h"
@@ -22,6 +23,12 @@ namespace Ssl {
 using ContextAdditionalInitFunc =
     std::function<absl::Status(Ssl::TlsContext& context, const Ssl::TlsCertificateConfig& cert)>;
 
+/**
+ * Called on the main thread with a context whose build was deferred, once it is built.
+ */
+using ClientContextReadyCb = std::function<void(ClientContextSharedPtr context)>;
+using ServerContextReadyCb = std::function<void(ServerContextSharedPtr context)>;
+
 /**
  * Manages all of the SSL contexts in the process
  */
@@ -42,6 +49,42 @@ public:
   createSslServerContext(Stats::Scope& scope, const ServerContextConfig& config,
                          ContextAdditionalInitFunc additional_init) PURE;
 
+  /**
+   * Queues the build of a ClientContext while builds are deferred by deferContextBuilds(), if the
+   * context can be built off the main thread.
+   * @param on_ready called on the main thread with the context once it is built.
+   * @return a handle that cancels the build when destroyed, or nullptr if the build was not
+   *         deferred, in which case the caller should use createSslClientContext().
+   */
+  virtual Common::CallbackHandlePtr deferSslClientContext(Stats::Scope& scope,
+                                                          const ClientContextConfig& config,
+                                                          ClientContextReadyCb on_ready) PURE;
+
+  /**
+   * Queues the build of a ServerContext while builds are deferred by deferContextBuilds(), if the
+   * context can be built off the main thread.
+   * @param on_ready called on the main thread with the context once it is built.
+   * @return a handle that cancels the build when destroyed, or nullptr if the build was not
+   *         deferred, in which case the caller should use createSslServerContext().
+   */
+  virtual Common::CallbackHandlePtr deferSslServerContext(Stats::Scope& scope,
+                                                          const ServerContextConfig& config,
+                                                          ServerContextReadyCb on_ready) PURE;
+
+  /**
+   * Starts or stops deferring context builds, so that the contexts of a large static
+   * configuration are built in parallel by buildDeferredContexts() rather than one by one.
+   * @param concurrency the number of threads to build deferred contexts on, or 0 to stop deferring.
+   */
+  virtual void deferContextBuilds(uint32_t concurrency) PURE;
+
+  /**
+   * Builds the contexts queued since the last call in parallel, then passes each to its ready
+   * callback on the main thread.
+   * @return the error building a context, if any, in which case no ready callbacks are called.
+   */
+  virtual absl::Status buildDeferredContexts() PURE;
+
   /**
    * @return the number of days until the next certificate being managed will expire, the value is
    * set when not expired.
@@ -259,10 +259,9 @@ public:
 
   /**
    * Called during the flush process to merge all the thread local histograms. The passed in
-   * callback will be called on the main thread, but it will happen after the method returns
-   * which means that the actual flush process will happen on the main thread after this method
-   * returns. It is expected that only one merge runs at any time and concurrent calls to this
-   * method would be asserted.
+   * callback will be called on the main thread once the merge is complete, which may happen
+   * before or after this method returns. It is expected that only one merge runs at any time and
+   * concurrent calls to this method would be asserted.
    */
   virtual void mergeHistograms(PostMergeCb merge_complete_cb) PURE;
 
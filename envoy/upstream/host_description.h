@@ -1,5 +1,6 @@
 #pragma once
 
+#include <chrono>
 #include <map>
 #include <memory>
 #include <string>
@@ -119,6 +120,33 @@ public:
                                         const StreamInfo::StreamInfo& /*stream_info*/) {
     return absl::OkStatus();
   }
+
+  /**
+   * Invoked when the response headers of an upstream request to this host are received, to update
+   * the host lb policy data with the latency of the request.
+   * NOTE: this method may be called concurrently from multiple threads.
+   * Please ensure that the implementation is thread-safe.
+   *
+   * @param latency supplies the time from the first byte of the request being sent to the first
+   *        byte of the response being received.
+   * @param received_time supplies the time the first byte of the response was received.
+   */
+  virtual void onUpstreamResponseLatency(std::chrono::microseconds /*latency*/,
+                                         MonotonicTime /*received_time*/) {}
+
+  /**
+   * Invoked when an upstream request to this host fails before the response headers: the
+   * connection to the host fails, the stream is reset, or the request times out. A soft per try
+   * timeout, after which the response may still arrive, is not reported.
+   * NOTE: this method may be called concurrently from multiple threads.
+   * Please ensure that the implementation is thread-safe.
+   *
+   * @param elapsed supplies the time from the first byte of the request being sent to the failure,
+   *        or zero if no byte was sent.
+   * @param failure_time supplies the time of the failure.
+   */
+  virtual void onUpstreamRequestFailure(std::chrono::microseconds /*elapsed*/,
+                                        MonotonicTime /*failure_time*/) {}
 };
 
 using HostLbPolicyDataPtr = std::unique_ptr<HostLbPolicyData>;
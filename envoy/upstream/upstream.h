@@ -737,6 +737,8 @@ public:
   COUNTER(upstream_cx_none_healthy)                                                                \
   COUNTER(upstream_cx_overflow)                                                                    \
   COUNTER(upstream_cx_pool_overflow)                                                               \
+  COUNTER(upstream_cx_preconnect_hit)                                                              \
+  COUNTER(upstream_cx_preconnect_wasted)                                                           \
   COUNTER(upstream_cx_protocol_error)                                                              \
   COUNTER(upstream_cx_rx_bytes_total)                                                              \
   COUNTER(upstream_cx_total)                                                                       \
@@ -986,6 +988,17 @@ class TypedLoadBalancerFactory;
 using AddressSelectFn = std::function<const Network::Address::InstanceConstSharedPtr(
     const Network::Address::InstanceConstSharedPtr&)>;
 
+/**
+ * Configuration of adaptive preconnecting, which preconnects based on a moving average of the
+ * stream demand of each connection pool.
+ */
+struct AdaptivePreconnectConfig {
+  // The half-life of the moving average of the pending and active streams of a pool.
+  std::chrono::milliseconds demand_half_life_;
+  // The stream capacity to keep established, as a multiple of the demand.
+  float headroom_ratio_;
+};
+
 /**
  * Information about a given upstream cluster.
  * This includes the information and interfaces for building an upstream filter chain.
@@ -1045,6 +1058,12 @@ public:
    */
   virtual float peekaheadRatio() const PURE;
 
+  /**
+   * @return the adaptive preconnect configuration, if the cluster preconnects adaptively. When
+   *         set, it takes the place of perUpstreamPreconnectRatio().
+   */
+  virtual const absl::optional<AdaptivePreconnectConfig>& adaptivePreconnect() const PURE;
+
   /**
    * @return soft limit on size of the cluster's connections read and write buffers.
    */
@@ -1246,6 +1265,12 @@ public:
    */
   virtual bool connectionPoolPerDownstreamConnection() const PURE;
 
+  /**
+   * @return whether the workers share one set of HTTP/2 or HTTP/3 connection pools to each host of
+   *         the cluster.
+   */
+  virtual bool shareConnectionPoolsAcrossWorkers() const PURE;
+
   /**
    * @return true if this cluster is configured to ignore hosts for the purpose of load balancing
    * computations until they have been health checked for the first time.
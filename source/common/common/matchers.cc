@@ -1,5 +1,7 @@
 #include "source/common/common/matchers.h"
 
+#include <algorithm>
+
 #include "envoy/config/core/v3/base.pb.h"
 #include "envoy/type/matcher/v3/metadata.pb.h"
 #include "envoy/type/matcher/v3/number.pb.h"
@@ -119,6 +121,61 @@ bool DoubleMatcher::match(const Protobuf::Value& value) const {
   PANIC("unexpected");
 }
 
+StringMatcherListImpl::StringMatcherListImpl(
+    const Protobuf::RepeatedPtrField<envoy::type::matcher::v3::StringMatcher>& matchers,
+    Server::Configuration::CommonFactoryContext& context) {
+  matchers_.reserve(matchers.size());
+  std::vector<std::string> regexes;
+  std::vector<uint32_t> regex_set_indices;
+  regex_set_indices.reserve(matchers.size());
+  for (const auto& matcher : matchers) {
+    matchers_.push_back(std::make_unique<StringMatcherImpl>(matcher, context));
+    // Only expressions compiled by the configured engine can be evaluated by its matcher sets.
+    if (matcher.has_safe_regex() && !matcher.safe_regex().has_google_re2()) {
+      regex_set_indices.push_back(regexes.size());
+      regexes.push_back(matcher.safe_regex().regex());
+    } else {
+      regex_set_indices.push_back(NotInSet);
+    }
+  }
+
+  // A single expression is matched as fast on its own.
+  if (regexes.size() < 2) {
+    return;
+  }
+  auto set_or_error = context.regexEngine().matcherSet(regexes);
+  if (set_or_error.ok()) {
+    regex_set_ = std::move(set_or_error.value());
+    regex_set_indices_ = std::move(regex_set_indices);
+  }
+}
+
+absl::optional<uint32_t> StringMatcherListImpl::firstMatch(absl::string_view value) const {
+  // The set is only scanned once the first regex matcher is reached, so that a list whose leading
+  // non-regex matchers match does not pay for it.
+  bool scanned = false;
+  bool scan_ok = false;
+  std::vector<uint32_t> matched;
+  for (uint32_t i = 0; i < matchers_.size(); ++i) {
+    if (regex_set_ != nullptr && regex_set_indices_[i] != NotInSet) {
+      if (!scanned) {
+        scanned = true;
+        scan_ok = regex_set_->match(value, matched);
+      }
+      if (scan_ok) {
+        if (std::binary_search(matched.begin(), matched.end(), regex_set_indices_[i])) {
+          return i;
+        }
+        continue;
+      }
+    }
+    if (matchers_[i]->match(value)) {
+      return i;
+    }
+  }
+  return absl::nullopt;
+}
+
 ListMatcher::ListMatcher(const envoy::type::matcher::v3::ListMatcher& matcher,
                          Server::Configuration::CommonFactoryContext& context) {
   ASSERT(matcher.match_pattern_case() ==
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <limits>
 #include <string>
 
 #include "envoy/common/exception.h"
@@ -309,6 +310,43 @@ private:
   StringMatcherVariant matcher_;
 };
 
+/**
+ * An ordered list of string matchers that are evaluated against the same value. When the regex
+ * engine supports matcher sets, the `safe_regex` matchers of the list are also compiled into a
+ * single Regex::CompiledMatcherSet, so that all of them are evaluated in one pass over the value
+ * instead of one by one. The result is the same as evaluating the matchers in order.
+ */
+class StringMatcherListImpl {
+public:
+  StringMatcherListImpl(
+      const Protobuf::RepeatedPtrField<envoy::type::matcher::v3::StringMatcher>& matchers,
+      Server::Configuration::CommonFactoryContext& context);
+  // Creates a list of matchers that are always evaluated one by one.
+  explicit StringMatcherListImpl(std::vector<StringMatcherPtr>&& matchers)
+      : matchers_(std::move(matchers)) {}
+
+  /**
+   * @return the index of the first matcher of the list that matches the value, if any.
+   */
+  absl::optional<uint32_t> firstMatch(absl::string_view value) const;
+
+  /**
+   * @return true if any matcher of the list matches the value.
+   */
+  bool anyMatch(absl::string_view value) const { return firstMatch(value).has_value(); }
+
+  bool empty() const { return matchers_.empty(); }
+  uint32_t size() const { return matchers_.size(); }
+
+private:
+  static constexpr uint32_t NotInSet = std::numeric_limits<uint32_t>::max();
+
+  std::vector<StringMatcherPtr> matchers_;
+  // Index of each matcher's regex in regex_set_, or NotInSet. Empty if there is no set.
+  std::vector<uint32_t> regex_set_indices_;
+  Regex::CompiledMatcherSetPtr regex_set_;
+};
+
 class StringMatcherExtensionFactory : public Config::TypedFactory {
 public:
   virtual StringMatcherPtr
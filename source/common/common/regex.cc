@@ -1,5 +1,7 @@
 #include "source/common/common/regex.h"
 
+#include <algorithm>
+
 #include "envoy/common/exception.h"
 #include "envoy/extensions/regex_engines/v3/google_re2.pb.h"
 #include "envoy/extensions/regex_engines/v3/google_re2.pb.validate.h"
@@ -92,10 +94,55 @@ CompiledGoogleReMatcher::CompiledGoogleReMatcher(
   }
 }
 
+absl::StatusOr<std::unique_ptr<CompiledGoogleReMatcherSet>>
+CompiledGoogleReMatcherSet::create(const std::vector<std::string>& regexes) {
+  absl::Status creation_status = absl::OkStatus();
+  auto ret = std::unique_ptr<CompiledGoogleReMatcherSet>(
+      new CompiledGoogleReMatcherSet(regexes, creation_status));
+  RETURN_IF_NOT_OK(creation_status);
+  return ret;
+}
+
+CompiledGoogleReMatcherSet::CompiledGoogleReMatcherSet(const std::vector<std::string>& regexes,
+                                                       absl::Status& creation_status)
+    : set_(re2::RE2::Quiet, re2::RE2::ANCHOR_BOTH), size_(regexes.size()) {
+  for (const std::string& regex : regexes) {
+    std::string error;
+    if (set_.Add(regex, &error) < 0) {
+      creation_status = absl::InvalidArgumentError(error);
+      return;
+    }
+  }
+  if (!set_.Compile()) {
+    creation_status = absl::ResourceExhaustedError("unable to compile RE2 set");
+  }
+}
+
+bool CompiledGoogleReMatcherSet::match(absl::string_view value,
+                                       std::vector<uint32_t>& matched) const {
+  matched.clear();
+  std::vector<int> indices;
+  re2::RE2::Set::ErrorInfo error_info;
+  if (!set_.Match(value, &indices, &error_info)) {
+    // The DFA may run out of memory on adversarial input, in which case the caller falls back to
+    // matching the expressions individually.
+    return error_info.kind == re2::RE2::Set::kNoError;
+  }
+  // RE2 does not report the indices in any particular order.
+  std::sort(indices.begin(), indices.end());
+  matched.assign(indices.begin(), indices.end());
+  return true;
+}
+
 absl::StatusOr<CompiledMatcherPtr> GoogleReEngine::matcher(const std::string& regex) const {
   return CompiledGoogleReMatcher::createAndSizeCheck(regex);
 }
 
+absl::StatusOr<CompiledMatcherSetPtr>
+GoogleReEngine::matcherSet(const std::vector<std::string>& regexes) const {
+  return CompiledGoogleReMatcherSet::create(regexes);
+}
+
 EnginePtr GoogleReEngineFactory::createEngine(const Protobuf::Message&,
                                               Server::Configuration::ServerFactoryContext&) {
   return std::make_shared<GoogleReEngine>();
@@ -13,6 +13,7 @@
 #include "source/common/stats/symbol_table.h"
 
 #include "re2/re2.h"
+#include "re2/set.h"
 #include "xds/type/matcher/v3/regex.pb.h"
 
 namespace Envoy {
@@ -67,9 +68,30 @@ public:
       : CompiledGoogleReMatcher(regex) {}
 };
 
+// A set of RE2 expressions that are matched with a single re2::RE2::Set. The set is anchored at
+// both ends so that an expression matches exactly when CompiledGoogleReMatcher::match() does.
+class CompiledGoogleReMatcherSet : public CompiledMatcherSet {
+public:
+  static absl::StatusOr<std::unique_ptr<CompiledGoogleReMatcherSet>>
+  create(const std::vector<std::string>& regexes);
+
+  // CompiledMatcherSet
+  bool match(absl::string_view value, std::vector<uint32_t>& matched) const override;
+  uint32_t size() const override { return size_; }
+
+private:
+  explicit CompiledGoogleReMatcherSet(const std::vector<std::string>& regexes,
+                                      absl::Status& creation_status);
+
+  re2::RE2::Set set_;
+  const uint32_t size_;
+};
+
 class GoogleReEngine : public Engine {
 public:
   absl::StatusOr<CompiledMatcherPtr> matcher(const std::string& regex) const override;
+  absl::StatusOr<CompiledMatcherSetPtr>
+  matcherSet(const std::vector<std::string>& regexes) const override;
 };
 
 class GoogleReEngineFactory : public EngineFactory {
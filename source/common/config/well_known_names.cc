@@ -109,6 +109,12 @@ TagNameValues::TagNameValues() {
   // http.[<stat_prefix>.]fault.(<downstream_cluster>.)*
   addTokenized(FAULT_DOWNSTREAM_CLUSTER, "http.*.fault.$.**");
 
+  // Filter names usually contain dots, so they are matched up to the callback name.
+  // http.[<stat_prefix>.]filter_instrumentation.(<filter_name>.)<callback>.<metric>
+  addRe2(HTTP_FILTER_NAME,
+         R"(^http\.<TAG_VALUE>\.filter_instrumentation\.((.+)\.)(?:decode|encode)_(?:headers|data|trailers)\.\w+$)",
+         ".filter_instrumentation.");
+
   // listener.[<address>.]ssl.ciphers.(<cipher>)
   addRe2(SSL_CIPHER, R"(^listener\..*?\.ssl\.ciphers(\.(<CIPHER>))$)", ".ssl.ciphers.");
 
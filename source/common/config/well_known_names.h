@@ -139,6 +139,8 @@ public:
   const std::string UDP_PREFIX = "envoy.udp_prefix";
   // Downstream cluster for the Fault http filter
   const std::string FAULT_DOWNSTREAM_CLUSTER = "envoy.fault_downstream_cluster";
+  // Filter name of the HTTP filter instrumentation
+  const std::string HTTP_FILTER_NAME = "envoy.http_filter_name";
   // Operation name for the Dynamo http filter
   const std::string DYNAMO_OPERATION = "envoy.dynamo_operation";
   // Table name for the Dynamo http filter
@@ -1,5 +1,9 @@
 #include "source/common/conn_pool/conn_pool_base.h"
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
 #include "envoy/server/overload/load_shed_point.h"
 
 #include "source/common/common/assert.h"
@@ -59,7 +63,8 @@ ConnPoolImplBase::ConnPoolImplBase(
       transport_socket_options_(transport_socket_options), cluster_connectivity_state_(state),
       upstream_ready_cb_(dispatcher_.createSchedulableCallback([this]() { onUpstreamReady(); })),
       create_new_connection_load_shed_(overload_manager.getLoadShedPoint(
-          Server::LoadShedPointName::get().ConnectionPoolNewConnection)) {
+          Server::LoadShedPointName::get().ConnectionPoolNewConnection)),
+      demand_updated_(dispatcher_.timeSource().monotonicTime()) {
   ENVOY_LOG_ONCE_IF(trace, create_new_connection_load_shed_ == nullptr,
                     "LoadShedPoint envoy.load_shed_points.connection_pool_new_connection is not "
                     "found. Is it configured?");
@@ -138,6 +143,17 @@ bool ConnPoolImplBase::shouldCreateNewConnection(float global_preconnect_ratio)
               connecting_and_connected_stream_capacity_, connecting_stream_capacity_,
               global_preconnect_ratio);
     return result;
+  } else if (const auto& adaptive = host_->cluster().adaptivePreconnect(); adaptive.has_value()) {
+    // Keep the provisioned streams, which are the unused capacity plus the active streams, at the
+    // adaptive target.
+    const double target = adaptivePreconnectTarget(*adaptive);
+    bool result = target > connecting_and_connected_stream_capacity_ + num_active_streams_;
+    ENVOY_LOG(trace,
+              "adaptive shouldCreateNewConnection returns {} for pending {} active {} "
+              "connecting_and_connected_capacity {} connecting_capacity {} target {}",
+              result, pending_streams_.size(), num_active_streams_,
+              connecting_and_connected_stream_capacity_, connecting_stream_capacity_, target);
+    return result;
   } else {
     // Ensure this local pool has adequate connections for the given load.
     //
@@ -161,6 +177,49 @@ float ConnPoolImplBase::perUpstreamPreconnectRatio() const {
   return host_->cluster().perUpstreamPreconnectRatio();
 }
 
+void ConnPoolImplBase::updateStreamDemand() {
+  const auto& adaptive = host_->cluster().adaptivePreconnect();
+  if (!adaptive.has_value()) {
+    return;
+  }
+  // The demand has held steady since the last update, so the average decays towards it by the
+  // fraction of a half-life that has passed.
+  const MonotonicTime now = dispatcher_.timeSource().monotonicTime();
+  const double elapsed_ms =
+      std::chrono::duration<double, std::milli>(now - demand_updated_).count();
+  const double weight = std::exp2(-elapsed_ms / adaptive->demand_half_life_.count());
+  const double demand = pending_streams_.size() + num_active_streams_;
+  stream_demand_average_ = demand + (stream_demand_average_ - demand) * weight;
+  demand_updated_ = now;
+}
+
+double ConnPoolImplBase::adaptivePreconnectTarget(const Upstream::AdaptivePreconnectConfig& config,
+                                                  bool anticipate_incoming_stream) const {
+  const double demand =
+      pending_streams_.size() + num_active_streams_ + (anticipate_incoming_stream ? 1 : 0);
+  if (demand == 0) {
+    // The average alone doesn't warrant connecting. Otherwise connections would be re-established
+    // as fast as they fail, or as the pool closes them.
+    return 0;
+  }
+  return std::max(demand, stream_demand_average_) * config.headroom_ratio_;
+}
+
+void ConnPoolImplBase::maybeRetireIdleClient(ActiveClient& client) {
+  const auto& adaptive = host_->cluster().adaptivePreconnect();
+  if (!adaptive.has_value() || client.state() != ActiveClient::State::Ready ||
+      client.numActiveStreams() != 0 || !pending_streams_.empty()) {
+    return;
+  }
+  if (adaptivePreconnectTarget(*adaptive, true) <= connecting_and_connected_stream_capacity_ -
+                                                       client.currentUnusedCapacity() +
+                                                       num_active_streams_) {
+    ENVOY_CONN_LOG(debug, "closing idle connection in excess of the adaptive preconnect target",
+                   client);
+    client.close();
+  }
+}
+
 ConnPoolImplBase::ConnectionResult ConnPoolImplBase::tryCreateNewConnections() {
   ConnPoolImplBase::ConnectionResult result;
   // Somewhat arbitrarily cap the number of connections preconnected due to new
@@ -216,6 +275,9 @@ ConnPoolImplBase::tryCreateNewConnection(float global_preconnect_ratio) {
                   static_cast<uint64_t>(client->currentUnusedCapacity()),
               dumpState());
     ASSERT(client->real_host_description_);
+    // The connection is ahead of demand if the connections already connecting can serve every
+    // pending stream.
+    client->preconnected_ = pending_streams_.size() <= connecting_stream_capacity_;
     // Increase the connecting capacity to reflect the streams this connection can serve.
     incrConnectingAndConnectedStreamCapacity(client->currentUnusedCapacity(), *client);
     LinkedList::moveIntoList(std::move(client), owningList(client->state()));
@@ -236,6 +298,10 @@ void ConnPoolImplBase::attachStreamToClient(Envoy::ConnectionPool::ActiveClient&
   if (client.state() == Envoy::ConnectionPool::ActiveClient::State::ReadyForEarlyData) {
     traffic_stats.upstream_rq_0rtt_.inc();
   }
+  if (client.preconnected_) {
+    traffic_stats.upstream_cx_preconnect_hit_.inc();
+    client.preconnected_ = false;
+  }
 
   if (enforceMaxRequests() && !host_->cluster().resourceManager(priority_).requests().canCreate()) {
     ENVOY_LOG(debug, "max streams overflow");
@@ -281,6 +347,7 @@ void ConnPoolImplBase::onStreamClosed(Envoy::ConnectionPool::ActiveClient& clien
       debug, "destroying stream: {} active remaining, readyForStream {}, currentUnusedCapacity {}",
       client, client.numActiveStreams(), client.readyForStream(), client.currentUnusedCapacity());
   ASSERT(num_active_streams_ > 0, dumpState());
+  updateStreamDemand();
   cluster_connectivity_state_.decrActiveStreams(1);
   num_active_streams_--;
   host_->stats().rq_active_.dec();
@@ -317,6 +384,7 @@ void ConnPoolImplBase::onStreamClosed(Envoy::ConnectionPool::ActiveClient& clien
       }
     }
   }
+  maybeRetireIdleClient(client);
 }
 
 ConnectionPool::Cancellable* ConnPoolImplBase::newStreamImpl(AttachContext& context,
@@ -324,6 +392,7 @@ ConnectionPool::Cancellable* ConnPoolImplBase::newStreamImpl(AttachContext& cont
   ASSERT(!is_draining_for_deletion_, dumpState());
   ASSERT(!deferred_deleting_, dumpState());
   assertCapacityCountsAreCorrect();
+  updateStreamDemand();
 
   if (!ready_clients_.empty()) {
     ActiveClient& client = *ready_clients_.front();
@@ -567,6 +636,10 @@ void ConnPoolImplBase::onConnectionEvent(ActiveClient& client, absl::string_view
     ENVOY_CONN_LOG(debug, "client disconnected, failure reason: {}", client, failure_reason);
 
     Envoy::Upstream::reportUpstreamCxDestroy(host_, event);
+    if (client.preconnected_) {
+      host_->cluster().trafficStats()->upstream_cx_preconnect_wasted_.inc();
+      client.preconnected_ = false;
+    }
     const bool incomplete_stream = client.closingWithIncompleteStream();
     if (incomplete_stream) {
       Envoy::Upstream::reportUpstreamCxDestroyActiveRequest(host_, event);
@@ -726,6 +799,10 @@ void ConnPoolImplBase::purgePendingStreams(
 bool ConnPoolImplBase::connectingConnectionIsExcess(const ActiveClient& client) const {
   ASSERT(!client.hasHandshakeCompleted());
   ENVOY_BUG(connecting_stream_capacity_ >= client.currentUnusedCapacity(), dumpState());
+  if (const auto& adaptive = host_->cluster().adaptivePreconnect(); adaptive.has_value()) {
+    return adaptivePreconnectTarget(*adaptive) <=
+           (connecting_stream_capacity_ - client.currentUnusedCapacity() + num_active_streams_);
+  }
   // If perUpstreamPreconnectRatio is one, this simplifies to checking if there would still be
   // sufficient connecting stream capacity to serve all pending streams if the most recent client
   // were removed from the picture.
@@ -740,6 +817,7 @@ bool ConnPoolImplBase::connectingConnectionIsExcess(const ActiveClient& client)
 void ConnPoolImplBase::onPendingStreamCancel(PendingStream& stream,
                                              Envoy::ConnectionPool::CancelPolicy policy) {
   ENVOY_LOG(debug, "cancelling pending stream");
+  updateStreamDemand();
   if (!pending_streams_to_purge_.empty()) {
     // If pending_streams_to_purge_ is not empty, it means that we are called from
     // with-in a onPoolFailure callback invoked in purgePendingStreams (i.e. purgePendingStreams
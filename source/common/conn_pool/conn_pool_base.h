@@ -1,6 +1,7 @@
 #pragma once
 
 #include "envoy/common/conn_pool.h"
+#include "envoy/common/time.h"
 #include "envoy/event/dispatcher.h"
 #include "envoy/network/connection.h"
 #include "envoy/server/overload/overload_manager.h"
@@ -145,6 +146,8 @@ public:
   Event::TimerPtr connection_duration_timer_;
   bool resources_released_{false};
   bool timed_out_{false};
+  // True if this connection was established ahead of demand, until it serves its first stream.
+  bool preconnected_{false};
   // TODO(danzh) remove this once http codec exposes the handshake state for h3.
   bool has_handshake_completed_{false};
 
@@ -349,6 +352,22 @@ protected:
 
   float perUpstreamPreconnectRatio() const;
 
+  // Folds the time since the last update into the moving average of the pool's stream demand, if
+  // the cluster preconnects adaptively. Called before each change in demand.
+  void updateStreamDemand();
+
+  // Returns the number of streams the pool should be provisioned for when preconnecting
+  // adaptively, which is the greater of its current and average demand times the headroom ratio,
+  // or zero if it has no current demand. If anticipate_incoming_stream is true, the current demand
+  // includes one more stream.
+  double adaptivePreconnectTarget(const Upstream::AdaptivePreconnectConfig& config,
+                                  bool anticipate_incoming_stream = false) const;
+
+  // Closes the given idle client if the rest of the pool's capacity meets the adaptive preconnect
+  // target. The stream which just completed on the client is anticipated to be followed by
+  // another, so that steady traffic doesn't retire and re-establish a connection per stream.
+  void maybeRetireIdleClient(ActiveClient& client);
+
   ConnectionPool::Cancellable*
   addPendingStream(Envoy::ConnectionPool::PendingStreamPtr&& pending_stream) {
     LinkedList::moveIntoList(std::move(pending_stream), pending_streams_);
@@ -411,6 +430,11 @@ private:
   // The number of streams currently attached to clients.
   uint32_t num_active_streams_{0};
 
+  // The moving average of the pending and active streams, as of demand_updated_. Only tracked if
+  // the cluster preconnects adaptively.
+  double stream_demand_average_{0};
+  MonotonicTime demand_updated_;
+
   // Whether the connection pool is currently in the process of closing
   // all connections so that it can be gracefully deleted.
   bool is_draining_for_deletion_{false};
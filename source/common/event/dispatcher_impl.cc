@@ -73,10 +73,14 @@ DispatcherImpl::DispatcherImpl(const std::string& name, Thread::ThreadFactory& t
       scheduler_(time_system.createScheduler(base_scheduler_, base_scheduler_)),
       thread_local_delete_cb_(
           base_scheduler_.createSchedulableCallback([this]() -> void { runThreadLocalDelete(); })),
-      deferred_delete_cb_(base_scheduler_.createSchedulableCallback(
-          [this]() -> void { clearDeferredDeleteList(); })),
+      deferred_delete_cb_(base_scheduler_.createSchedulableCallback([this]() -> void {
+        SlowCallbackTracker::ScopedCallback scoped_callback(
+            slow_callback_tracker_.get(), SlowCallbackTracker::CallbackType::SchedulableCallback);
+        clearDeferredDeleteList();
+      })),
       post_cb_(base_scheduler_.createSchedulableCallback([this]() -> void { runPostCallbacks(); })),
-      current_to_delete_(&to_delete_1_), scaled_timer_manager_(scaled_timer_factory(*this)) {
+      current_to_delete_(&to_delete_1_), scaled_timer_manager_(scaled_timer_factory(*this)),
+      timer_wheel_(std::make_unique<TimerWheelImpl>(*this)) {
   ASSERT(!name_.empty());
   FatalErrorHandler::registerFatalErrorHandler(*this);
   updateApproximateMonotonicTimeInternal();
@@ -111,6 +115,14 @@ void DispatcherImpl::initializeStats(Stats::Scope& scope,
   });
 }
 
+void DispatcherImpl::initializeSlowCallbackTracker(const SlowCallbackTrackerConfig& config) {
+  // The tracker is only accessed by the dispatcher thread, so create it there.
+  post([this, config] {
+    slow_callback_tracker_ = std::make_unique<SlowCallbackTracker>(
+        name_, time_source_, config.threshold_, config.sampling_interval_, config.max_records_);
+  });
+}
+
 void DispatcherImpl::clearDeferredDeleteList() {
   ASSERT(isThreadSafe());
   std::vector<DeferredDeletablePtr>* to_delete = current_to_delete_;
@@ -199,6 +211,8 @@ FileEventPtr DispatcherImpl::createFileEvent(os_fd_t fd, FileReadyCb cb, FileTri
       *this, fd,
       [this, cb](uint32_t events) {
         touchWatchdog();
+        SlowCallbackTracker::ScopedCallback scoped_callback(
+            slow_callback_tracker_.get(), SlowCallbackTracker::CallbackType::FileEvent);
         return cb(events);
       },
       trigger, events)};
@@ -224,10 +238,17 @@ TimerPtr DispatcherImpl::createScaledTimer(ScaledTimerMinimum minimum, TimerCb c
   return scaled_timer_manager_->createTimer(minimum, std::move(cb));
 }
 
+TimerPtr DispatcherImpl::createWheelTimer(TimerCb cb) {
+  ASSERT(isThreadSafe());
+  return timer_wheel_->createTimer(std::move(cb));
+}
+
 Event::SchedulableCallbackPtr DispatcherImpl::createSchedulableCallback(std::function<void()> cb) {
   ASSERT(isThreadSafe());
   return base_scheduler_.createSchedulableCallback([this, cb]() {
     touchWatchdog();
+    SlowCallbackTracker::ScopedCallback scoped_callback(
+        slow_callback_tracker_.get(), SlowCallbackTracker::CallbackType::SchedulableCallback);
     cb();
   });
 }
@@ -236,6 +257,8 @@ TimerPtr DispatcherImpl::createTimerInternal(TimerCb cb) {
   return scheduler_->createTimer(
       [this, cb]() {
         touchWatchdog();
+        SlowCallbackTracker::ScopedCallback scoped_callback(
+            slow_callback_tracker_.get(), SlowCallbackTracker::CallbackType::Timer);
         cb();
       },
       *this);
@@ -375,7 +398,11 @@ void DispatcherImpl::runPostCallbacks() {
     // executing a long list of callbacks.
     touchWatchdog();
     // Run the callback.
-    callbacks.front()();
+    {
+      SlowCallbackTracker::ScopedCallback scoped_callback(slow_callback_tracker_.get(),
+                                                          SlowCallbackTracker::CallbackType::Post);
+      callbacks.front()();
+    }
     // Pop the front so that the destructor of the callback that just executed runs before the next
     // callback executes.
     callbacks.pop_front();
@@ -424,6 +451,9 @@ void DispatcherImpl::popTrackedObject(const ScopeTrackedObject* expected_object)
   RELEASE_ASSERT(!tracked_object_stack_.empty(), "Tracked Object Stack is empty, nothing to pop!");
 
   const ScopeTrackedObject* top = tracked_object_stack_.back();
+  if (slow_callback_tracker_ != nullptr) {
+    slow_callback_tracker_->onTrackedObjectPopped(*top);
+  }
   tracked_object_stack_.pop_back();
   ASSERT(top == expected_object,
          "Popped the top of the tracked object stack, but it wasn't the expected object!");
@@ -0,0 +1,121 @@
+#include "source/common/event/slow_callback_tracker.h"
+
+#include <algorithm>
+#include <array>
+
+#include "source/common/common/assert.h"
+#include "source/common/common/macros.h"
+#include "source/common/common/utility.h"
+
+#include "absl/synchronization/mutex.h"
+
+namespace Envoy {
+namespace Event {
+
+namespace {
+
+ABSL_CONST_INIT absl::Mutex registry_mutex(absl::kConstInit);
+
+std::vector<const SlowCallbackTracker*>& registry() ABSL_EXCLUSIVE_LOCKS_REQUIRED(registry_mutex) {
+  MUTABLE_CONSTRUCT_ON_FIRST_USE(std::vector<const SlowCallbackTracker*>);
+}
+
+} // namespace
+
+SlowCallbackTracker::SlowCallbackTracker(const std::string& dispatcher_name,
+                                         TimeSource& time_source,
+                                         std::chrono::milliseconds threshold,
+                                         uint32_t sampling_interval, uint32_t max_records)
+    : dispatcher_name_(dispatcher_name), time_source_(time_source), threshold_(threshold),
+      sampling_interval_(sampling_interval), max_records_(max_records) {
+  ASSERT(sampling_interval_ > 0);
+  ASSERT(max_records_ > 0);
+  absl::MutexLock lock(&registry_mutex);
+  registry().push_back(this);
+}
+
+SlowCallbackTracker::~SlowCallbackTracker() {
+  absl::MutexLock lock(&registry_mutex);
+  auto& trackers = registry();
+  trackers.erase(std::remove(trackers.begin(), trackers.end(), this), trackers.end());
+}
+
+bool SlowCallbackTracker::startCallback(CallbackType type) {
+  // Callbacks run by a nested event loop are accounted to the outer callback.
+  if (in_callback_ || ++callback_count_ % sampling_interval_ != 0) {
+    return false;
+  }
+  in_callback_ = true;
+  current_type_ = type;
+  current_tracked_object_.clear();
+  sampled_callbacks_.fetch_add(1, std::memory_order_relaxed);
+  current_start_ = time_source_.monotonicTime();
+  return true;
+}
+
+void SlowCallbackTracker::onTrackedObjectPopped(const ScopeTrackedObject& object) {
+  if (!in_callback_ || !current_tracked_object_.empty() ||
+      time_source_.monotonicTime() - current_start_ < threshold_) {
+    return;
+  }
+  std::array<char, MaxTrackedObjectSize> buffer;
+  OutputBufferStream stream(buffer.data(), buffer.size());
+  object.dumpState(stream);
+  current_tracked_object_ = std::string(stream.contents());
+}
+
+void SlowCallbackTracker::endCallback() {
+  ASSERT(in_callback_);
+  in_callback_ = false;
+  const auto duration = time_source_.monotonicTime() - current_start_;
+  if (duration < threshold_) {
+    return;
+  }
+
+  Record record{time_source_.systemTime(), current_type_,
+                std::chrono::duration_cast<std::chrono::microseconds>(duration),
+                std::move(current_tracked_object_)};
+  current_tracked_object_.clear();
+  Thread::LockGuard lock(mutex_);
+  ++slow_callbacks_;
+  if (records_.size() < max_records_) {
+    records_.push_back(std::move(record));
+  } else {
+    records_[next_record_] = std::move(record);
+    next_record_ = (next_record_ + 1) % max_records_;
+  }
+}
+
+std::vector<SlowCallbackTracker::Record> SlowCallbackTracker::records() const {
+  Thread::LockGuard lock(mutex_);
+  std::vector<Record> records;
+  records.reserve(records_.size());
+  for (size_t i = 0; i < records_.size(); ++i) {
+    records.push_back(records_[(next_record_ + i) % records_.size()]);
+  }
+  return records;
+}
+
+uint64_t SlowCallbackTracker::sampledCallbacks() const {
+  return sampled_callbacks_.load(std::memory_order_relaxed);
+}
+
+uint64_t SlowCallbackTracker::slowCallbacks() const {
+  Thread::LockGuard lock(mutex_);
+  return slow_callbacks_;
+}
+
+void SlowCallbackTracker::forEach(const std::function<void(const SlowCallbackTracker&)>& cb) {
+  absl::MutexLock lock(&registry_mutex);
+  std::vector<const SlowCallbackTracker*> trackers = registry();
+  std::stable_sort(trackers.begin(), trackers.end(),
+                   [](const SlowCallbackTracker* a, const SlowCallbackTracker* b) {
+                     return a->dispatcherName() < b->dispatcherName();
+                   });
+  for (const SlowCallbackTracker* tracker : trackers) {
+    cb(*tracker);
+  }
+}
+
+} // namespace Event
+} // namespace Envoy
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/common/scope_tracker.h"
+#include "envoy/common/time.h"
+
+#include "source/common/common/thread.h"
+
+namespace Envoy {
+namespace Event {
+
+/**
+ * Sampled tracker of the dispatcher callbacks which stall the event loop. One in sampling_interval
+ * callbacks is timed, and the ones running for at least the threshold are kept in a fixed-size ring
+ * buffer, along with the state of the innermost ScopeTrackedObject that was active when the
+ * threshold was crossed. This is what attributes a stall to a connection or a stream, as the
+ * callbacks themselves are anonymous.
+ *
+ * Callbacks are timed and recorded on the dispatcher thread, while the records can be read from
+ * any thread, e.g. by the admin endpoint. Every live tracker can be visited with forEach().
+ */
+class SlowCallbackTracker {
+public:
+  // Numbered like envoy::admin::v3::SlowCallback::Type.
+  enum class CallbackType : uint8_t {
+    FileEvent,
+    Timer,
+    SchedulableCallback,
+    Post,
+  };
+
+  struct Record {
+    SystemTime time_;
+    CallbackType type_;
+    std::chrono::microseconds duration_;
+    std::string tracked_object_;
+  };
+
+  // The tracked object state is truncated to this many bytes.
+  static constexpr size_t MaxTrackedObjectSize = 1024;
+
+  SlowCallbackTracker(const std::string& dispatcher_name, TimeSource& time_source,
+                      std::chrono::milliseconds threshold, uint32_t sampling_interval,
+                      uint32_t max_records);
+  ~SlowCallbackTracker();
+
+  /**
+   * Times a dispatcher callback from construction to destruction, if it is sampled.
+   */
+  class ScopedCallback {
+  public:
+    ScopedCallback(SlowCallbackTracker* tracker, CallbackType type)
+        : tracker_(tracker != nullptr && tracker->startCallback(type) ? tracker : nullptr) {}
+    ~ScopedCallback() {
+      if (tracker_ != nullptr) {
+        tracker_->endCallback();
+      }
+    }
+
+  private:
+    SlowCallbackTracker* const tracker_;
+  };
+
+  /**
+   * Called by the dispatcher before a tracked object is popped, while it is still alive. Captures
+   * its state if the current callback is timed, has exceeded the threshold and no object was
+   * captured yet.
+   */
+  void onTrackedObjectPopped(const ScopeTrackedObject& object);
+
+  const std::string& dispatcherName() const { return dispatcher_name_; }
+
+  /**
+   * @return the recorded slow callbacks, oldest first.
+   */
+  std::vector<Record> records() const;
+
+  /**
+   * @return the number of callbacks which were timed.
+   */
+  uint64_t sampledCallbacks() const;
+
+  /**
+   * @return the number of timed callbacks which exceeded the threshold.
+   */
+  uint64_t slowCallbacks() const;
+
+  /**
+   * Calls cb for every live tracker, sorted by dispatcher name. Trackers can't be destroyed while
+   * cb runs.
+   */
+  static void forEach(const std::function<void(const SlowCallbackTracker&)>& cb);
+
+private:
+  bool startCallback(CallbackType type);
+  void endCallback();
+
+  const std::string dispatcher_name_;
+  TimeSource& time_source_;
+  const std::chrono::milliseconds threshold_;
+  const uint32_t sampling_interval_;
+  const uint32_t max_records_;
+
+  // Only accessed on the dispatcher thread.
+  uint64_t callback_count_{};
+  bool in_callback_{};
+  CallbackType current_type_{};
+  MonotonicTime current_start_;
+  std::string current_tracked_object_;
+  // Written on the dispatcher thread without taking the lock, which is only taken for slow
+  // callbacks.
+  std::atomic<uint64_t> sampled_callbacks_{};
+
+  mutable Thread::MutexBasicLockable mutex_;
+  std::vector<Record> records_ ABSL_GUARDED_BY(mutex_);
+  // Index of the oldest record once records_ is full.
+  size_t next_record_ ABSL_GUARDED_BY(mutex_){};
+  uint64_t slow_callbacks_ ABSL_GUARDED_BY(mutex_){};
+};
+
+using SlowCallbackTrackerPtr = std::unique_ptr<SlowCallbackTracker>;
+
+} // namespace Event
+} // namespace Envoy
@@ -0,0 +1,263 @@
+#include "source/common/event/timer_wheel_impl.h"
+
+#include <algorithm>
+#include <chrono>
+
+#include "source/common/common/assert.h"
+#include "source/common/common/scope_tracker.h"
+
+#include "absl/numeric/bits.h"
+
+namespace Envoy {
+namespace Event {
+
+namespace {
+
+constexpr uint64_t MicrosecondsPerTick = 1000;
+// The driver is re-armed when it fires early, so there is no need to arm it for longer than this.
+constexpr uint64_t MaxDriverDelayTicks = uint64_t(1) << 32;
+
+} // namespace
+
+class TimerWheelImpl::WheelTimerImpl final : public Timer {
+public:
+  // The level of a timer which is due at the tick being processed.
+  static constexpr uint32_t Firing = Levels;
+  // The level of a timer which is not enabled.
+  static constexpr uint32_t Unlinked = Levels + 1;
+
+  WheelTimerImpl(TimerCb callback, TimerWheelImpl& wheel)
+      : wheel_(wheel), callback_(std::move(callback)) {}
+
+  ~WheelTimerImpl() override { disableTimer(); }
+
+  // Timer
+  void disableTimer() override {
+    wheel_.disable(*this);
+    scope_ = nullptr;
+  }
+
+  void enableTimer(std::chrono::milliseconds ms, const ScopeTrackedObject* scope) override {
+    scope_ = scope;
+    wheel_.enable(*this, ms);
+  }
+
+  void enableHRTimer(std::chrono::microseconds us, const ScopeTrackedObject* scope) override {
+    enableTimer(std::chrono::ceil<std::chrono::milliseconds>(us), scope);
+  }
+
+  bool enabled() override { return level_ != Unlinked; }
+
+  void trigger() {
+    ASSERT(wheel_.dispatcher_.isThreadSafe());
+    if (scope_ == nullptr) {
+      callback_();
+    } else {
+      ScopeTrackerScopeState scope(scope_, wheel_.dispatcher_);
+      scope_ = nullptr;
+      callback_();
+    }
+  }
+
+  TimerWheelImpl& wheel_;
+  const TimerCb callback_;
+  const ScopeTrackedObject* scope_{};
+  uint64_t deadline_{};
+  uint32_t level_{Unlinked};
+  uint32_t slot_{};
+  WheelTimerImpl* prev_{};
+  WheelTimerImpl* next_{};
+};
+
+TimerWheelImpl::TimerWheelImpl(Dispatcher& dispatcher)
+    : dispatcher_(dispatcher), epoch_(dispatcher.timeSource().monotonicTime()),
+      driver_(dispatcher.createTimer([this]() { onDriverTimer(); })) {}
+
+TimerWheelImpl::~TimerWheelImpl() {
+  // Wheel timers shouldn't outlive the wheel.
+  ASSERT(size_ == 0);
+}
+
+TimerPtr TimerWheelImpl::createTimer(TimerCb callback) {
+  return std::make_unique<WheelTimerImpl>(std::move(callback), *this);
+}
+
+uint64_t TimerWheelImpl::ticksAt(MonotonicTime time, bool round_up) const {
+  if (time <= epoch_) {
+    return 0;
+  }
+  const uint64_t us = std::chrono::duration_cast<std::chrono::microseconds>(time - epoch_).count();
+  return us / MicrosecondsPerTick + (round_up && us % MicrosecondsPerTick != 0 ? 1 : 0);
+}
+
+void TimerWheelImpl::enable(WheelTimerImpl& timer, std::chrono::milliseconds duration) {
+  ASSERT(dispatcher_.isThreadSafe());
+  const MonotonicTime now = dispatcher_.timeSource().monotonicTime();
+  if (timer.enabled()) {
+    unlink(timer);
+  } else {
+    if (size_ == 0 && !advancing_) {
+      // Nothing is pending, so the wheel can catch up with the time it has been idle for.
+      current_tick_ = std::max(current_tick_, ticksAt(now, false));
+    }
+    ++size_;
+  }
+  timer.deadline_ = std::max(ticksAt(now, true) + std::max<int64_t>(duration.count(), 0),
+                             current_tick_);
+  link(timer);
+  if (!advancing_) {
+    // The driver is re-armed once the ticks being processed have been.
+    const uint64_t start = slotStart(timer.level_, timer.deadline_);
+    if (start < driver_tick_) {
+      armDriver(start);
+    }
+  }
+}
+
+void TimerWheelImpl::disable(WheelTimerImpl& timer) {
+  if (!timer.enabled()) {
+    return;
+  }
+  ASSERT(dispatcher_.isThreadSafe());
+  unlink(timer);
+  --size_;
+  if (size_ == 0 && !advancing_) {
+    armDriver(NoTick);
+  }
+}
+
+void TimerWheelImpl::link(WheelTimerImpl& timer) {
+  // The lowest level at which the deadline is in the same slot of the level above as the current
+  // tick.
+  uint32_t level = 0;
+  while (level + 1 < Levels && (timer.deadline_ >> (SlotBits * (level + 1))) !=
+                                   (current_tick_ >> (SlotBits * (level + 1)))) {
+    ++level;
+  }
+  const uint32_t slot = (timer.deadline_ >> (SlotBits * level)) & (SlotsPerLevel - 1);
+  WheelTimerImpl*& head = slots_[level][slot];
+  timer.level_ = level;
+  timer.slot_ = slot;
+  timer.prev_ = nullptr;
+  timer.next_ = head;
+  if (head != nullptr) {
+    head->prev_ = &timer;
+  }
+  head = &timer;
+  occupied_[level] |= uint64_t(1) << slot;
+}
+
+void TimerWheelImpl::unlink(WheelTimerImpl& timer) {
+  ASSERT(timer.enabled());
+  WheelTimerImpl*& head =
+      timer.level_ == WheelTimerImpl::Firing ? firing_ : slots_[timer.level_][timer.slot_];
+  if (timer.prev_ != nullptr) {
+    timer.prev_->next_ = timer.next_;
+  } else {
+    head = timer.next_;
+  }
+  if (timer.next_ != nullptr) {
+    timer.next_->prev_ = timer.prev_;
+  }
+  if (head == nullptr && timer.level_ != WheelTimerImpl::Firing) {
+    occupied_[timer.level_] &= ~(uint64_t(1) << timer.slot_);
+  }
+  timer.prev_ = nullptr;
+  timer.next_ = nullptr;
+  timer.level_ = WheelTimerImpl::Unlinked;
+}
+
+uint64_t TimerWheelImpl::slotStart(uint32_t level, uint64_t tick) const {
+  const uint32_t shift = SlotBits * level;
+  return std::max(current_tick_, (tick >> shift) << shift);
+}
+
+uint64_t TimerWheelImpl::nextPendingTick() const {
+  uint64_t next = NoTick;
+  for (uint32_t level = 0; level < Levels; ++level) {
+    const uint32_t shift = SlotBits * level;
+    const uint32_t digit = (current_tick_ >> shift) & (SlotsPerLevel - 1);
+    const uint64_t pending = occupied_[level] & (~uint64_t(0) << digit);
+    if (pending == 0) {
+      continue;
+    }
+    const uint32_t upper = shift + SlotBits;
+    const uint64_t base = upper >= 64 ? 0 : (current_tick_ >> upper) << upper;
+    next = std::min(next, std::max(current_tick_, base + (uint64_t(absl::countr_zero(pending))
+                                                          << shift)));
+  }
+  return next;
+}
+
+void TimerWheelImpl::cascade(uint64_t tick) {
+  // Move the timers of the slots starting at this tick down to the levels below, from the top so
+  // that a timer moved down from one level can be moved further down from the next.
+  for (uint32_t level = Levels - 1; level > 0; --level) {
+    const uint32_t slot = (tick >> (SlotBits * level)) & (SlotsPerLevel - 1);
+    if ((occupied_[level] & (uint64_t(1) << slot)) == 0) {
+      continue;
+    }
+    WheelTimerImpl* timer = slots_[level][slot];
+    slots_[level][slot] = nullptr;
+    occupied_[level] &= ~(uint64_t(1) << slot);
+    while (timer != nullptr) {
+      WheelTimerImpl* next = timer->next_;
+      link(*timer);
+      timer = next;
+    }
+  }
+}
+
+void TimerWheelImpl::advance(uint64_t target) {
+  while (current_tick_ <= target) {
+    const uint64_t tick = nextPendingTick();
+    if (tick > target) {
+      current_tick_ = target + 1;
+      return;
+    }
+    current_tick_ = tick;
+    cascade(tick);
+
+    const uint32_t slot = tick & (SlotsPerLevel - 1);
+    if ((occupied_[0] & (uint64_t(1) << slot)) != 0) {
+      firing_ = slots_[0][slot];
+      slots_[0][slot] = nullptr;
+      occupied_[0] &= ~(uint64_t(1) << slot);
+      for (WheelTimerImpl* timer = firing_; timer != nullptr; timer = timer->next_) {
+        timer->level_ = WheelTimerImpl::Firing;
+      }
+    }
+    // Timers enabled by the callbacks below are due at the next tick at the earliest.
+    current_tick_ = tick + 1;
+    // A callback may disable or free any of the timers which are yet to fire, so they are popped
+    // one at a time.
+    while (firing_ != nullptr) {
+      WheelTimerImpl& timer = *firing_;
+      unlink(timer);
+      --size_;
+      timer.trigger();
+    }
+  }
+}
+
+void TimerWheelImpl::armDriver(uint64_t tick) {
+  driver_tick_ = tick;
+  if (tick == NoTick) {
+    driver_->disableTimer();
+    return;
+  }
+  const uint64_t now = ticksAt(dispatcher_.timeSource().monotonicTime(), false);
+  const uint64_t delay = tick > now ? std::min(tick - now, MaxDriverDelayTicks) : 0;
+  driver_->enableTimer(std::chrono::milliseconds(delay));
+}
+
+void TimerWheelImpl::onDriverTimer() {
+  driver_tick_ = NoTick;
+  advancing_ = true;
+  advance(ticksAt(dispatcher_.timeSource().monotonicTime(), false));
+  advancing_ = false;
+  armDriver(nextPendingTick());
+}
+
+} // namespace Event
+} // namespace Envoy
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+
+#include "envoy/common/time.h"
+#include "envoy/event/dispatcher.h"
+#include "envoy/event/timer.h"
+
+namespace Envoy {
+namespace Event {
+
+/**
+ * A hierarchical timer wheel, which multiplexes any number of timers onto a single real Timer of
+ * the dispatcher. Enabling and disabling a wheel timer is constant time and allocation free, where
+ * a real timer is a heap operation in libevent, so the wheel suits large numbers of timers which
+ * are frequently re-armed, such as a timer per upstream host.
+ *
+ * Time is divided into ticks of a millisecond. The wheel has a level for each 6 bits of the 64-bit
+ * tick count, and each level has a slot for each value of those bits. A timer is kept in the
+ * lowest level whose higher bits of its deadline match those of the current tick, in the slot for
+ * that level's bits of the deadline. When the current tick reaches the start of a slot above the
+ * lowest level, its timers are moved down to the levels below, so every timer fires exactly at its
+ * deadline tick. The real timer is only armed for the next tick at which a slot needs attention,
+ * and ticks at which no slot does are skipped over.
+ *
+ * Wheel timers fire up to a tick later than their deadline, and enableHRTimer() is rounded up to a
+ * whole tick.
+ */
+class TimerWheelImpl {
+public:
+  explicit TimerWheelImpl(Dispatcher& dispatcher);
+  ~TimerWheelImpl();
+
+  /**
+   * Allocates a timer on the wheel. @see Timer for docs on how to use the timer. The timer must be
+   * freed before the wheel.
+   * @param callback supplies the callback to invoke when the timer fires.
+   */
+  TimerPtr createTimer(TimerCb callback);
+
+  /**
+   * @return the number of enabled timers.
+   */
+  uint64_t size() const { return size_; }
+
+private:
+  class WheelTimerImpl;
+
+  static constexpr uint32_t SlotBits = 6;
+  static constexpr uint32_t SlotsPerLevel = 1 << SlotBits;
+  // Enough levels to cover every bit of the tick count.
+  static constexpr uint32_t Levels = (64 + SlotBits - 1) / SlotBits;
+  static constexpr uint64_t NoTick = UINT64_MAX;
+
+  uint64_t ticksAt(MonotonicTime time, bool round_up) const;
+  void enable(WheelTimerImpl& timer, std::chrono::milliseconds duration);
+  void disable(WheelTimerImpl& timer);
+  void link(WheelTimerImpl& timer);
+  void unlink(WheelTimerImpl& timer);
+  uint64_t slotStart(uint32_t level, uint64_t tick) const;
+  uint64_t nextPendingTick() const;
+  void advance(uint64_t target);
+  void cascade(uint64_t tick);
+  void armDriver(uint64_t tick);
+  void onDriverTimer();
+
+  Dispatcher& dispatcher_;
+  // Tick 0 of the wheel.
+  const MonotonicTime epoch_;
+  // The real timer that drives the wheel.
+  const TimerPtr driver_;
+  // The tick the driver is armed for, or NoTick if it is not.
+  uint64_t driver_tick_{NoTick};
+  // The earliest tick which has not been processed yet.
+  uint64_t current_tick_{};
+  // The heads of the intrusive list of timers in each slot, by level.
+  std::array<std::array<WheelTimerImpl*, SlotsPerLevel>, Levels> slots_{};
+  // A bit per slot of each level, set when the slot holds a timer.
+  std::array<uint64_t, Levels> occupied_{};
+  // The timers due at the tick being processed, which are yet to fire.
+  WheelTimerImpl* firing_{};
+  uint64_t size_{};
+  bool advancing_{};
+};
+
+using TimerWheelImplPtr = std::unique_ptr<TimerWheelImpl>;
+
+} // namespace Event
+} // namespace Envoy
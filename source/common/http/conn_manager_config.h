@@ -15,6 +15,7 @@
 #include "envoy/type/v3/percent.pb.h"
 
 #include "source/common/http/date_provider.h"
+#include "source/common/http/filter_instrumentation.h"
 #include "source/common/local_reply/local_reply.h"
 #include "source/common/network/utility.h"
 #include "source/common/stats/symbol_table.h"
@@ -590,6 +591,12 @@ public:
    *         local address was restored from PROXY protocol.
    */
   virtual const absl::flat_hash_set<uint32_t>& httpDestinationPorts() const PURE;
+
+  /**
+   * @return the instrumentation measuring the cost of the HTTP filters of sampled streams, or
+   *         nullptr if it isn't configured.
+   */
+  virtual FilterInstrumentation* filterInstrumentation() PURE;
 };
 
 using ConnectionManagerConfigSharedPtr = std::shared_ptr<ConnectionManagerConfig>;
@@ -905,6 +905,12 @@ ConnectionManagerImpl::ActiveStream::ActiveStream(ConnectionManagerImpl& connect
   filter_manager_.streamInfo().setShouldSchemeMatchUpstream(
       connection_manager.config_->shouldSchemeMatchUpstream());
 
+  FilterInstrumentation* filter_instrumentation =
+      connection_manager_.config_->filterInstrumentation();
+  if (filter_instrumentation != nullptr && filter_instrumentation->sampleStream()) {
+    filter_manager_.setFilterInstrumentation(*filter_instrumentation);
+  }
+
   // TODO(chaoqin-li1123): can this be moved to the on demand filter?
   auto factory = Envoy::Config::Utility::getFactoryByName<RouteConfigUpdateRequesterFactory>(
       kRouteFactoryName);
@@ -0,0 +1,760 @@
+#include "source/common/http/cross_worker_conn_pool.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "envoy/http/codec.h"
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/common/dump_state_utils.h"
+#include "source/common/common/hash.h"
+#include "source/common/common/linked_object.h"
+#include "source/common/http/codec_helper.h"
+#include "source/common/http/header_map_impl.h"
+#include "source/common/http/header_utility.h"
+#include "source/common/http/response_decoder_impl_base.h"
+#include "source/common/http/utility.h"
+#include "source/common/network/socket_impl.h"
+#include "source/common/stream_info/stream_info_impl.h"
+
+namespace Envoy {
+namespace Http {
+
+// Ties the two halves of a stream together. Each half only runs on its own worker, and clears its
+// pointer here when it is done, so that events posted to it afterwards are dropped.
+struct CrossWorkerStreamLink {
+  CrossWorkerStreamLink(CrossWorkerRelaySharedPtr relay, CrossWorkerRelaySharedPtr carrier)
+      : relay_(std::move(relay)), carrier_(std::move(carrier)) {}
+
+  const CrossWorkerRelaySharedPtr relay_;
+  const CrossWorkerRelaySharedPtr carrier_;
+  // Only touched on the worker that created the stream.
+  CrossWorkerStream* stream_{};
+  // Only touched on the carrier worker.
+  CrossWorkerCarriedStream* carried_stream_{};
+};
+
+using CrossWorkerStreamLinkSharedPtr = std::shared_ptr<CrossWorkerStreamLink>;
+
+// What the carrier worker tells the stream's worker about the upstream connection once the stream
+// is ready.
+struct CarrierConnectionInfo {
+  Network::Address::InstanceConstSharedPtr local_address_;
+  Network::Address::InstanceConstSharedPtr remote_address_;
+  absl::optional<uint64_t> connection_id_;
+  absl::optional<StreamInfo::UpstreamTiming> upstream_timing_;
+  uint64_t upstream_num_streams_{};
+  uint32_t buffer_limit_{};
+};
+
+// The bytes that the carried stream sent and received, passed back when its response ends.
+struct CarriedBytes {
+  uint64_t wire_bytes_sent_{};
+  uint64_t wire_bytes_received_{};
+  uint64_t header_bytes_sent_{};
+  uint64_t header_bytes_received_{};
+};
+
+namespace {
+
+// Bounds the request body posted to the carrier but not yet encoded there when the carried stream
+// has no buffer limit.
+constexpr uint64_t DefaultMaxBytesInFlight = 1024 * 1024;
+
+void postToStream(const CrossWorkerStreamLinkSharedPtr& link,
+                  absl::AnyInvocable<void(CrossWorkerStream&)> callback) {
+  link->relay_->post([link, callback = std::move(callback)]() mutable {
+    if (link->stream_ != nullptr) {
+      callback(*link->stream_);
+    }
+  });
+}
+
+void postToCarriedStream(const CrossWorkerStreamLinkSharedPtr& link,
+                         absl::AnyInvocable<void(CrossWorkerCarriedStream&)> callback) {
+  link->carrier_->post([link, callback = std::move(callback)]() mutable {
+    if (link->carried_stream_ != nullptr) {
+      callback(*link->carried_stream_);
+    }
+  });
+}
+
+} // namespace
+
+// The half of a stream on the worker that created it. It is the request encoder handed to the
+// caller, and forwards everything it is asked to do to the carried stream.
+class CrossWorkerStream : public RequestEncoder,
+                          public Stream,
+                          public StreamCallbackHelper,
+                          public ConnectionPool::Cancellable,
+                          public LinkedObject<CrossWorkerStream>,
+                          public Event::DeferredDeletable {
+public:
+  CrossWorkerStream(CrossWorkerConnPool& parent, ResponseDecoder& response_decoder,
+                    ConnectionPool::Callbacks& callbacks, CrossWorkerStreamLinkSharedPtr link)
+      : parent_(parent), response_decoder_(response_decoder), callbacks_(callbacks),
+        link_(std::move(link)),
+        connection_info_(std::make_shared<Network::ConnectionInfoSetterImpl>(nullptr, nullptr)),
+        bytes_meter_(std::make_shared<StreamInfo::BytesMeter>()) {
+    link_->stream_ = this;
+  }
+  ~CrossWorkerStream() override { link_->stream_ = nullptr; }
+
+  // Events posted by the carried stream.
+  void onPoolFailure(ConnectionPool::PoolFailureReason reason, absl::string_view details,
+                     Upstream::HostDescriptionConstSharedPtr host) {
+    done();
+    callbacks_.onPoolFailure(reason, details, std::move(host));
+  }
+  void onPoolReady(const CarrierConnectionInfo& connection_info,
+                   Upstream::HostDescriptionConstSharedPtr host,
+                   absl::optional<Http::Protocol> protocol) {
+    buffer_limit_ = connection_info.buffer_limit_;
+    connection_info_ = std::make_shared<Network::ConnectionInfoSetterImpl>(
+        connection_info.local_address_, connection_info.remote_address_);
+    if (connection_info.connection_id_.has_value()) {
+      connection_info_->setConnectionID(connection_info.connection_id_.value());
+    }
+    stream_info_ = std::make_unique<StreamInfo::StreamInfoImpl>(
+        parent_.dispatcher().timeSource(), connection_info_,
+        StreamInfo::FilterState::LifeSpan::Connection);
+    if (protocol.has_value()) {
+      stream_info_->protocol(protocol.value());
+    }
+    if (connection_info.upstream_timing_.has_value()) {
+      auto upstream_info = std::make_shared<StreamInfo::UpstreamInfoImpl>();
+      upstream_info->upstreamTiming() = connection_info.upstream_timing_.value();
+      upstream_info->setUpstreamNumStreams(connection_info.upstream_num_streams_);
+      stream_info_->setUpstreamInfo(std::move(upstream_info));
+    }
+    callbacks_.onPoolReady(*this, std::move(host), *stream_info_, protocol);
+  }
+  void decode1xxHeaders(ResponseHeaderMapPtr&& headers) {
+    response_decoder_.decode1xxHeaders(std::move(headers));
+  }
+  void decodeHeaders(ResponseHeaderMapPtr&& headers, bool end_stream) {
+    response_complete_ = end_stream;
+    response_decoder_.decodeHeaders(std::move(headers), end_stream);
+    maybeDone();
+  }
+  void decodeData(Buffer::Instance& data, bool end_stream) {
+    response_complete_ = end_stream;
+    response_decoder_.decodeData(data, end_stream);
+    maybeDone();
+  }
+  void decodeTrailers(ResponseTrailerMapPtr&& trailers) {
+    response_complete_ = true;
+    response_decoder_.decodeTrailers(std::move(trailers));
+    maybeDone();
+  }
+  void decodeMetadata(MetadataMapPtr&& metadata_map) {
+    response_decoder_.decodeMetadata(std::move(metadata_map));
+  }
+  void onCarriedStreamReset(StreamResetReason reason, absl::string_view details) {
+    runResetCallbacks(reason, details);
+    done();
+  }
+  void addCarriedBytes(const CarriedBytes& bytes) {
+    bytes_meter_->addWireBytesSent(bytes.wire_bytes_sent_);
+    bytes_meter_->addWireBytesReceived(bytes.wire_bytes_received_);
+    bytes_meter_->addHeaderBytesSent(bytes.header_bytes_sent_);
+    bytes_meter_->addHeaderBytesReceived(bytes.header_bytes_received_);
+  }
+  void onCodecEncodeComplete() {
+    if (codec_callbacks_ != nullptr) {
+      codec_callbacks_->onCodecEncodeComplete();
+    }
+  }
+  void onCodecLowLevelReset() {
+    if (codec_callbacks_ != nullptr) {
+      codec_callbacks_->onCodecLowLevelReset();
+    }
+  }
+  // The carried stream has handed request body bytes to its codec, whose own watermarks take over.
+  void onDataCarried(uint64_t length) {
+    ASSERT(bytes_in_flight_ >= length);
+    bytes_in_flight_ -= length;
+    if (above_in_flight_limit_ && bytes_in_flight_ <= maxBytesInFlight() / 2) {
+      above_in_flight_limit_ = false;
+      runLowWatermarkCallbacks();
+    }
+  }
+
+  // Fails or resets the stream because its pool is being destroyed.
+  void onPoolDestroyed();
+
+  // Envoy::ConnectionPool::Cancellable
+  void cancel(Envoy::ConnectionPool::CancelPolicy cancel_policy) override;
+
+  // Http::RequestEncoder
+  Status encodeHeaders(const RequestHeaderMap& headers, bool end_stream) override;
+  void encodeTrailers(const RequestTrailerMap& trailers) override;
+  void enableTcpTunneling() override;
+
+  // Http::StreamEncoder
+  void encodeData(Buffer::Instance& data, bool end_stream) override;
+  Stream& getStream() override { return *this; }
+  void encodeMetadata(const MetadataMapVector& metadata_map_vector) override;
+  Http1StreamEncoderOptionsOptRef http1StreamEncoderOptions() override { return absl::nullopt; }
+
+  // Http::Stream
+  void addCallbacks(StreamCallbacks& callbacks) override { addCallbacksHelper(callbacks); }
+  void removeCallbacks(StreamCallbacks& callbacks) override { removeCallbacksHelper(callbacks); }
+  CodecEventCallbacks* registerCodecEventCallbacks(CodecEventCallbacks* codec_callbacks) override {
+    std::swap(codec_callbacks, codec_callbacks_);
+    return codec_callbacks;
+  }
+  void resetStream(StreamResetReason reason) override;
+  void readDisable(bool disable) override;
+  uint32_t bufferLimit() const override { return buffer_limit_; }
+  const Network::ConnectionInfoProvider& connectionInfoProvider() override {
+    return *connection_info_;
+  }
+  void setFlushTimeout(std::chrono::milliseconds timeout) override;
+  Buffer::BufferMemoryAccountSharedPtr account() const override { return account_; }
+  void setAccount(Buffer::BufferMemoryAccountSharedPtr account) override {
+    account_ = std::move(account);
+  }
+  const StreamInfo::BytesMeterSharedPtr& bytesMeter() override { return bytes_meter_; }
+  absl::optional<uint32_t> codecStreamId() const override { return absl::nullopt; }
+
+private:
+  void onLocalEndStream() {
+    local_end_stream_ = true;
+    maybeDone();
+  }
+  void maybeDone() {
+    if (local_end_stream_ && response_complete_) {
+      done();
+    }
+  }
+  uint64_t maxBytesInFlight() const {
+    return buffer_limit_ > 0 ? buffer_limit_ : DefaultMaxBytesInFlight;
+  }
+  void done() {
+    if (done_) {
+      return;
+    }
+    done_ = true;
+    link_->stream_ = nullptr;
+    parent_.onStreamDone(*this);
+  }
+
+  CrossWorkerConnPool& parent_;
+  ResponseDecoder& response_decoder_;
+  ConnectionPool::Callbacks& callbacks_;
+  const CrossWorkerStreamLinkSharedPtr link_;
+  std::shared_ptr<Network::ConnectionInfoSetterImpl> connection_info_;
+  std::unique_ptr<StreamInfo::StreamInfoImpl> stream_info_;
+  StreamInfo::BytesMeterSharedPtr bytes_meter_;
+  Buffer::BufferMemoryAccountSharedPtr account_;
+  CodecEventCallbacks* codec_callbacks_{};
+  uint32_t buffer_limit_{};
+  // Request body bytes posted to the carried stream which it has not encoded yet.
+  uint64_t bytes_in_flight_{};
+  bool above_in_flight_limit_{};
+  bool response_complete_{};
+  bool done_{};
+};
+
+// The half of a stream on the carrier worker. It is the stream on the carrier's connection pool,
+// and posts what happens to it back to the stream on the worker that created it.
+class CrossWorkerCarriedStream : public ResponseDecoderImplBase,
+                                 public ConnectionPool::Callbacks,
+                                 public StreamCallbacks,
+                                 public CodecEventCallbacks,
+                                 public LinkedObject<CrossWorkerCarriedStream>,
+                                 public Event::DeferredDeletable {
+public:
+  CrossWorkerCarriedStream(CrossWorkerRelay& relay, CrossWorkerStreamLinkSharedPtr link)
+      : relay_(relay), link_(std::move(link)) {
+    link_->carried_stream_ = this;
+  }
+  ~CrossWorkerCarriedStream() override { link_->carried_stream_ = nullptr; }
+
+  void start(const CarrierPoolCb& pool_cb, const ConnectionPool::Instance::StreamOptions& options) {
+    ConnectionPool::Instance* pool = pool_cb();
+    if (pool == nullptr) {
+      onPoolFailure(ConnectionPool::PoolFailureReason::LocalConnectionFailure,
+                    "no carrier connection pool", nullptr);
+      return;
+    }
+    // The callbacks may run within newStream(), in which case there is nothing to cancel.
+    ConnectionPool::Cancellable* handle = pool->newStream(*this, *this, options);
+    if (handle != nullptr) {
+      pool_handle_ = handle;
+    }
+  }
+
+  // Requests posted by the stream's worker.
+  void cancel(Envoy::ConnectionPool::CancelPolicy cancel_policy) {
+    if (pool_handle_ != nullptr) {
+      pool_handle_->cancel(cancel_policy);
+      pool_handle_ = nullptr;
+    } else {
+      // The pool became ready before the cancellation got here.
+      resetCodecStream(StreamResetReason::LocalReset);
+    }
+    done();
+  }
+  void encodeHeaders(RequestHeaderMapPtr&& headers, bool end_stream) {
+    request_headers_ = std::move(headers);
+    const Status status = encoder_->encodeHeaders(*request_headers_, end_stream);
+    if (!status.ok()) {
+      resetCodecStream(StreamResetReason::LocalReset);
+      postReset(StreamResetReason::LocalReset, status.message());
+      done();
+      return;
+    }
+    onRequestEncoded(end_stream);
+  }
+  void encodeData(Buffer::Instance& data, bool end_stream) {
+    const uint64_t length = data.length();
+    encoder_->encodeData(data, end_stream);
+    postToStream(link_, [length](CrossWorkerStream& stream) { stream.onDataCarried(length); });
+    onRequestEncoded(end_stream);
+  }
+  void encodeTrailers(RequestTrailerMapPtr&& trailers) {
+    request_trailers_ = std::move(trailers);
+    encoder_->encodeTrailers(*request_trailers_);
+    onRequestEncoded(true);
+  }
+  void encodeMetadata(const MetadataMapVector& metadata_map_vector) {
+    encoder_->encodeMetadata(metadata_map_vector);
+  }
+  void enableTcpTunneling() { encoder_->enableTcpTunneling(); }
+  void resetStream(StreamResetReason reason) {
+    resetCodecStream(reason);
+    done();
+  }
+  void readDisable(bool disable) { encoder_->getStream().readDisable(disable); }
+  void setFlushTimeout(std::chrono::milliseconds timeout) {
+    encoder_->getStream().setFlushTimeout(timeout);
+  }
+
+  // Resets the stream because the carrier worker is shutting down.
+  void onRelayShutdown() {
+    if (pool_handle_ != nullptr) {
+      pool_handle_->cancel(Envoy::ConnectionPool::CancelPolicy::Default);
+      pool_handle_ = nullptr;
+      postToStream(link_, [](CrossWorkerStream& stream) {
+        stream.onPoolFailure(ConnectionPool::PoolFailureReason::LocalConnectionFailure,
+                             "carrier worker shut down", nullptr);
+      });
+    } else {
+      resetCodecStream(StreamResetReason::ConnectionTermination);
+      postReset(StreamResetReason::ConnectionTermination, "carrier worker shut down");
+    }
+    done();
+  }
+
+  // ConnectionPool::Callbacks
+  void onPoolFailure(ConnectionPool::PoolFailureReason reason,
+                     absl::string_view transport_failure_reason,
+                     Upstream::HostDescriptionConstSharedPtr host) override {
+    pool_handle_ = nullptr;
+    postToStream(link_, [reason, details = std::string(transport_failure_reason),
+                         host = std::move(host)](CrossWorkerStream& stream) mutable {
+      stream.onPoolFailure(reason, details, std::move(host));
+    });
+    done();
+  }
+  void onPoolReady(RequestEncoder& encoder, Upstream::HostDescriptionConstSharedPtr host,
+                   StreamInfo::StreamInfo& info,
+                   absl::optional<Http::Protocol> protocol) override {
+    pool_handle_ = nullptr;
+    encoder_ = &encoder;
+    Stream& stream = encoder.getStream();
+    stream.addCallbacks(*this);
+    stream.registerCodecEventCallbacks(this);
+
+    CarrierConnectionInfo connection_info;
+    connection_info.local_address_ = stream.connectionInfoProvider().localAddress();
+    connection_info.remote_address_ = stream.connectionInfoProvider().remoteAddress();
+    connection_info.connection_id_ = stream.connectionInfoProvider().connectionID();
+    if (info.upstreamInfo() != nullptr) {
+      connection_info.upstream_timing_ = info.upstreamInfo()->upstreamTiming();
+      connection_info.upstream_num_streams_ = info.upstreamInfo()->upstreamNumStreams();
+    }
+    connection_info.buffer_limit_ = stream.bufferLimit();
+    postToStream(link_, [connection_info = std::move(connection_info), host = std::move(host),
+                         protocol](CrossWorkerStream& stream) mutable {
+      stream.onPoolReady(connection_info, std::move(host), protocol);
+    });
+  }
+
+  // Http::StreamDecoder
+  void decodeData(Buffer::Instance& data, bool end_stream) override {
+    maybePostBytes(end_stream);
+    auto carried_data = std::make_unique<Buffer::OwnedImpl>();
+    carried_data->move(data);
+    postToStream(link_, [data = std::move(carried_data), end_stream](CrossWorkerStream& stream) {
+      stream.decodeData(*data, end_stream);
+    });
+    onResponseDecoded(end_stream);
+  }
+  void decodeMetadata(MetadataMapPtr&& metadata_map) override {
+    postToStream(link_,
+                 [metadata_map = std::move(metadata_map)](CrossWorkerStream& stream) mutable {
+                   stream.decodeMetadata(std::move(metadata_map));
+                 });
+  }
+
+  // Http::ResponseDecoder
+  void decode1xxHeaders(ResponseHeaderMapPtr&& headers) override {
+    postToStream(link_, [headers = std::move(headers)](CrossWorkerStream& stream) mutable {
+      stream.decode1xxHeaders(std::move(headers));
+    });
+  }
+  void decodeHeaders(ResponseHeaderMapPtr&& headers, bool end_stream) override {
+    maybePostBytes(end_stream);
+    postToStream(link_,
+                 [headers = std::move(headers), end_stream](CrossWorkerStream& stream) mutable {
+                   stream.decodeHeaders(std::move(headers), end_stream);
+                 });
+    onResponseDecoded(end_stream);
+  }
+  void decodeTrailers(ResponseTrailerMapPtr&& trailers) override {
+    maybePostBytes(true);
+    postToStream(link_, [trailers = std::move(trailers)](CrossWorkerStream& stream) mutable {
+      stream.decodeTrailers(std::move(trailers));
+    });
+    onResponseDecoded(true);
+  }
+  void dumpState(std::ostream& os, int indent_level) const override {
+    const char* spaces = spacesForLevel(indent_level);
+    os << spaces << "CrossWorkerCarriedStream " << this << DUMP_MEMBER(request_complete_)
+       << DUMP_MEMBER(response_complete_) << "\n";
+  }
+
+  // Http::StreamCallbacks
+  void onResetStream(StreamResetReason reason,
+                     absl::string_view transport_failure_reason) override {
+    // The codec stream is going away, so it must not be touched again.
+    encoder_ = nullptr;
+    maybePostBytes(true);
+    postReset(reason, transport_failure_reason);
+    done();
+  }
+  void onAboveWriteBufferHighWatermark() override {
+    postToStream(link_, [](CrossWorkerStream& stream) { stream.runHighWatermarkCallbacks(); });
+  }
+  void onBelowWriteBufferLowWatermark() override {
+    postToStream(link_, [](CrossWorkerStream& stream) { stream.runLowWatermarkCallbacks(); });
+  }
+
+  // Http::CodecEventCallbacks
+  void onCodecEncodeComplete() override {
+    postToStream(link_, [](CrossWorkerStream& stream) { stream.onCodecEncodeComplete(); });
+  }
+  void onCodecLowLevelReset() override {
+    postToStream(link_, [](CrossWorkerStream& stream) { stream.onCodecLowLevelReset(); });
+  }
+
+private:
+  void onRequestEncoded(bool end_stream) {
+    request_complete_ = end_stream;
+    maybeDone();
+  }
+  void onResponseDecoded(bool end_stream) {
+    response_complete_ = end_stream;
+    maybeDone();
+  }
+  void maybeDone() {
+    if (request_complete_ && response_complete_) {
+      detachFromCodecStream();
+      done();
+    }
+  }
+  // Passes the bytes counted by the codec back with the end of the response.
+  void maybePostBytes(bool end_stream) {
+    if (!end_stream || encoder_ == nullptr) {
+      return;
+    }
+    const StreamInfo::BytesMeterSharedPtr& bytes_meter = encoder_->getStream().bytesMeter();
+    if (bytes_meter == nullptr) {
+      return;
+    }
+    CarriedBytes bytes{bytes_meter->wireBytesSent(), bytes_meter->wireBytesReceived(),
+                       bytes_meter->headerBytesSent(), bytes_meter->headerBytesReceived()};
+    postToStream(link_, [bytes](CrossWorkerStream& stream) { stream.addCarriedBytes(bytes); });
+  }
+  void postReset(StreamResetReason reason, absl::string_view details) {
+    postToStream(link_, [reason, details = std::string(details)](CrossWorkerStream& stream) {
+      stream.onCarriedStreamReset(reason, details);
+    });
+  }
+  void detachFromCodecStream() {
+    if (encoder_ == nullptr) {
+      return;
+    }
+    Stream& stream = encoder_->getStream();
+    stream.removeCallbacks(*this);
+    stream.registerCodecEventCallbacks(nullptr);
+    encoder_ = nullptr;
+  }
+  void resetCodecStream(StreamResetReason reason) {
+    if (encoder_ == nullptr) {
+      return;
+    }
+    Stream& stream = encoder_->getStream();
+    detachFromCodecStream();
+    stream.resetStream(reason);
+  }
+  void done() {
+    if (!inserted()) {
+      return;
+    }
+    link_->carried_stream_ = nullptr;
+    relay_.dispatcher().deferredDelete(removeFromList(relay_.carried_streams_));
+  }
+
+  CrossWorkerRelay& relay_;
+  const CrossWorkerStreamLinkSharedPtr link_;
+  ConnectionPool::Cancellable* pool_handle_{};
+  RequestEncoder* encoder_{};
+  // The codecs may refer to the request headers and trailers until the stream is done.
+  RequestHeaderMapPtr request_headers_;
+  RequestTrailerMapPtr request_trailers_;
+  bool request_complete_{};
+  bool response_complete_{};
+};
+
+void CrossWorkerStream::onPoolDestroyed() {
+  if (stream_info_ != nullptr) {
+    resetStream(StreamResetReason::ConnectionTermination);
+    return;
+  }
+  postToCarriedStream(link_, [](CrossWorkerCarriedStream& stream) {
+    stream.cancel(Envoy::ConnectionPool::CancelPolicy::Default);
+  });
+  done();
+  callbacks_.onPoolFailure(ConnectionPool::PoolFailureReason::LocalConnectionFailure,
+                           "cross worker pool teardown", parent_.host());
+}
+
+void CrossWorkerStream::cancel(Envoy::ConnectionPool::CancelPolicy cancel_policy) {
+  postToCarriedStream(link_, [cancel_policy](CrossWorkerCarriedStream& stream) {
+    stream.cancel(cancel_policy);
+  });
+  done();
+}
+
+Status CrossWorkerStream::encodeHeaders(const RequestHeaderMap& headers, bool end_stream) {
+#ifndef ENVOY_ENABLE_UHV
+  // Fail the same way the carrier's codec would, while the caller can still handle the error.
+  RETURN_IF_ERROR(HeaderUtility::checkRequiredRequestHeaders(headers));
+  RETURN_IF_ERROR(HeaderUtility::checkValidRequestHeaders(headers));
+#endif
+  RequestHeaderMapPtr carried_headers = createHeaderMap<RequestHeaderMapImpl>(headers);
+  postToCarriedStream(link_, [headers = std::move(carried_headers),
+                              end_stream](CrossWorkerCarriedStream& stream) mutable {
+    stream.encodeHeaders(std::move(headers), end_stream);
+  });
+  if (end_stream) {
+    onLocalEndStream();
+  }
+  return okStatus();
+}
+
+void CrossWorkerStream::encodeData(Buffer::Instance& data, bool end_stream) {
+  // The caller keeps reading the downstream until the watermark callbacks tell it to stop, so
+  // count what is on its way to the carrier as buffered by this stream.
+  bytes_in_flight_ += data.length();
+  if (!above_in_flight_limit_ && bytes_in_flight_ > maxBytesInFlight()) {
+    above_in_flight_limit_ = true;
+    runHighWatermarkCallbacks();
+  }
+  auto carried_data = std::make_unique<Buffer::OwnedImpl>();
+  if (account_ != nullptr) {
+    // Slices charged to this worker's accounts must be released on this worker.
+    carried_data->add(data);
+    data.drain(data.length());
+  } else {
+    carried_data->move(data);
+  }
+  postToCarriedStream(link_, [data = std::move(carried_data),
+                              end_stream](CrossWorkerCarriedStream& stream) {
+    stream.encodeData(*data, end_stream);
+  });
+  if (end_stream) {
+    onLocalEndStream();
+  }
+}
+
+void CrossWorkerStream::encodeTrailers(const RequestTrailerMap& trailers) {
+  RequestTrailerMapPtr carried_trailers = createHeaderMap<RequestTrailerMapImpl>(trailers);
+  postToCarriedStream(link_, [trailers = std::move(carried_trailers)](
+                                 CrossWorkerCarriedStream& stream) mutable {
+    stream.encodeTrailers(std::move(trailers));
+  });
+  onLocalEndStream();
+}
+
+void CrossWorkerStream::encodeMetadata(const MetadataMapVector& metadata_map_vector) {
+  MetadataMapVector carried_metadata;
+  carried_metadata.reserve(metadata_map_vector.size());
+  for (const MetadataMapPtr& metadata_map : metadata_map_vector) {
+    carried_metadata.push_back(std::make_unique<MetadataMap>(*metadata_map));
+  }
+  postToCarriedStream(link_, [metadata = std::move(carried_metadata)](
+                                 CrossWorkerCarriedStream& stream) {
+    stream.encodeMetadata(metadata);
+  });
+}
+
+void CrossWorkerStream::enableTcpTunneling() {
+  postToCarriedStream(link_,
+                      [](CrossWorkerCarriedStream& stream) { stream.enableTcpTunneling(); });
+}
+
+void CrossWorkerStream::resetStream(StreamResetReason reason) {
+  if (done_) {
+    return;
+  }
+  postToCarriedStream(link_,
+                      [reason](CrossWorkerCarriedStream& stream) { stream.resetStream(reason); });
+  runResetCallbacks(reason, "");
+  done();
+}
+
+void CrossWorkerStream::readDisable(bool disable) {
+  postToCarriedStream(
+      link_, [disable](CrossWorkerCarriedStream& stream) { stream.readDisable(disable); });
+}
+
+void CrossWorkerStream::setFlushTimeout(std::chrono::milliseconds timeout) {
+  postToCarriedStream(
+      link_, [timeout](CrossWorkerCarriedStream& stream) { stream.setFlushTimeout(timeout); });
+}
+
+CrossWorkerRelay::CrossWorkerRelay(Event::Dispatcher& dispatcher) : dispatcher_(dispatcher) {}
+
+CrossWorkerRelay::~CrossWorkerRelay() = default;
+
+bool CrossWorkerRelay::post(Event::PostCb callback) {
+  absl::MutexLock lock(&mutex_);
+  if (shut_down_) {
+    return false;
+  }
+  dispatcher_.post(std::move(callback));
+  return true;
+}
+
+bool CrossWorkerRelay::isShutDown() const {
+  absl::MutexLock lock(&mutex_);
+  return shut_down_;
+}
+
+void CrossWorkerRelay::shutdown() {
+  {
+    absl::MutexLock lock(&mutex_);
+    shut_down_ = true;
+  }
+  ENVOY_LOG(debug, "cross worker relay shutting down with {} carried streams",
+            carried_streams_.size());
+  while (!carried_streams_.empty()) {
+    carried_streams_.front()->onRelayShutdown();
+  }
+}
+
+void CrossWorkerRelay::carryStream(CrossWorkerStreamLinkSharedPtr link,
+                                   const CarrierPoolCb& pool_cb,
+                                   const ConnectionPool::Instance::StreamOptions& options) {
+  auto stream = std::make_unique<CrossWorkerCarriedStream>(*this, std::move(link));
+  CrossWorkerCarriedStream& carried_stream = *stream;
+  LinkedList::moveIntoList(std::move(stream), carried_streams_);
+  carried_stream.start(pool_cb, options);
+}
+
+bool CrossWorkerCarriers::add(CrossWorkerRelaySharedPtr relay) {
+  absl::MutexLock lock(&mutex_);
+  if (num_added_ == relays_.size()) {
+    return false;
+  }
+  relays_[num_added_++] = std::move(relay);
+  return true;
+}
+
+CrossWorkerRelaySharedPtr
+CrossWorkerCarriers::carrierFor(const Upstream::HostDescription& host) const {
+  CrossWorkerRelaySharedPtr relay;
+  {
+    absl::MutexLock lock(&mutex_);
+    if (relays_.empty()) {
+      return nullptr;
+    }
+    relay = relays_[HashUtil::xxHash64(host.address()->asStringView()) % relays_.size()];
+  }
+  if (relay == nullptr || relay->isShutDown()) {
+    return nullptr;
+  }
+  return relay;
+}
+
+CrossWorkerConnPool::CrossWorkerConnPool(CrossWorkerRelaySharedPtr relay,
+                                         CrossWorkerRelaySharedPtr carrier,
+                                         Upstream::HostConstSharedPtr host,
+                                         Http::Protocol protocol, CarrierPoolCb carrier_pool_cb)
+    : relay_(std::move(relay)), carrier_(std::move(carrier)), host_(std::move(host)),
+      protocol_(protocol), carrier_pool_cb_(std::move(carrier_pool_cb)) {}
+
+CrossWorkerConnPool::~CrossWorkerConnPool() {
+  // Ignore idle callbacks while the streams are torn down below.
+  destroying_ = true;
+  while (!streams_.empty()) {
+    streams_.front()->onPoolDestroyed();
+  }
+}
+
+ConnectionPool::Cancellable*
+CrossWorkerConnPool::newStream(ResponseDecoder& response_decoder,
+                               ConnectionPool::Callbacks& callbacks,
+                               const StreamOptions& options) {
+  auto link = std::make_shared<CrossWorkerStreamLink>(relay_, carrier_);
+  LinkedList::moveIntoList(
+      std::make_unique<CrossWorkerStream>(*this, response_decoder, callbacks, link), streams_);
+  CrossWorkerStream& stream = *streams_.front();
+  if (!carrier_->post([link, pool_cb = carrier_pool_cb_, options]() {
+        link->carrier_->carryStream(link, pool_cb, options);
+      })) {
+    stream.onPoolFailure(ConnectionPool::PoolFailureReason::LocalConnectionFailure,
+                         "carrier worker shut down", host_);
+    return nullptr;
+  }
+  ENVOY_LOG(trace, "handed stream to {} to carrier worker {}", host_->address()->asStringView(),
+            carrier_->dispatcher().name());
+  return &stream;
+}
+
+absl::string_view CrossWorkerConnPool::protocolDescription() const {
+  return Utility::getProtocolString(protocol_);
+}
+
+void CrossWorkerConnPool::drainConnections(Envoy::ConnectionPool::DrainBehavior drain_behavior) {
+  // The carrier worker drains its own connections. All this pool has to do is to go away once its
+  // streams are done.
+  if (drain_behavior == Envoy::ConnectionPool::DrainBehavior::DrainAndDelete) {
+    draining_for_deletion_ = true;
+    checkForIdleAndNotify();
+  }
+}
+
+void CrossWorkerConnPool::onStreamDone(CrossWorkerStream& stream) {
+  dispatcher().deferredDelete(stream.removeFromList(streams_));
+  checkForIdleAndNotify();
+}
+
+void CrossWorkerConnPool::checkForIdleAndNotify() {
+  if (destroying_ || !draining_for_deletion_ || !streams_.empty()) {
+    return;
+  }
+  for (const IdleCb& cb : idle_callbacks_) {
+    cb();
+  }
+  idle_callbacks_.clear();
+}
+
+} // namespace Http
+} // namespace Envoy
@@ -0,0 +1,173 @@
+#pragma once
+
+#include <functional>
+#include <list>
+#include <memory>
+#include <vector>
+
+#include "envoy/event/dispatcher.h"
+#include "envoy/http/conn_pool.h"
+#include "envoy/upstream/upstream.h"
+
+#include "source/common/common/logger.h"
+
+#include "absl/base/thread_annotations.h"
+#include "absl/synchronization/mutex.h"
+
+namespace Envoy {
+namespace Http {
+
+// The two halves of a stream that one worker carries on a connection pool of another. See
+// cross_worker_conn_pool.cc.
+struct CrossWorkerStreamLink;
+class CrossWorkerStream;
+class CrossWorkerCarriedStream;
+
+/**
+ * Returns the connection pool that a worker carries the streams of other workers on. It is called
+ * on that worker, and returns nullptr if the pool is not available there, for example because the
+ * cluster has been removed.
+ */
+using CarrierPoolCb = std::function<ConnectionPool::Instance*()>;
+
+/**
+ * The per-worker end of cross-worker connection pools. Other workers post the streams they want
+ * carried on this worker's connection pools to it, and this worker posts the events of those
+ * streams back through theirs. Posts are dropped once the worker has shut down, so a relay may be
+ * kept alive by other workers after its dispatcher is gone.
+ */
+class CrossWorkerRelay : protected Logger::Loggable<Logger::Id::pool> {
+public:
+  explicit CrossWorkerRelay(Event::Dispatcher& dispatcher);
+  ~CrossWorkerRelay();
+
+  /**
+   * Posts a callback to the relay's worker. May be called from any thread.
+   * @return false if the worker has shut down, in which case the callback is dropped.
+   */
+  bool post(Event::PostCb callback) ABSL_LOCKS_EXCLUDED(mutex_);
+
+  /**
+   * @return whether the relay's worker has shut down. May be called from any thread.
+   */
+  bool isShutDown() const ABSL_LOCKS_EXCLUDED(mutex_);
+
+  /**
+   * Stops accepting posts and resets the streams carried for other workers. Called on the relay's
+   * worker before its connection pools are destroyed.
+   */
+  void shutdown() ABSL_LOCKS_EXCLUDED(mutex_);
+
+  /**
+   * Carries a stream of another worker on a connection pool of this worker. Called on this worker.
+   */
+  void carryStream(std::shared_ptr<CrossWorkerStreamLink> link, const CarrierPoolCb& pool_cb,
+                   const ConnectionPool::Instance::StreamOptions& options);
+
+  Event::Dispatcher& dispatcher() { return dispatcher_; }
+
+private:
+  friend class CrossWorkerCarriedStream;
+
+  Event::Dispatcher& dispatcher_;
+  std::list<std::unique_ptr<CrossWorkerCarriedStream>> carried_streams_;
+  mutable absl::Mutex mutex_;
+  bool shut_down_ ABSL_GUARDED_BY(mutex_){};
+};
+
+using CrossWorkerRelaySharedPtr = std::shared_ptr<CrossWorkerRelay>;
+
+/**
+ * The relays of the workers that carry streams for each other. The streams to a host are carried by
+ * one worker, chosen by hashing the host's address, so that all workers hand them to the same one.
+ * Workers take the slots in the order they start, and a slot keeps its worker for the life of the
+ * process, so the carrier of a host never changes once its worker has started.
+ */
+class CrossWorkerCarriers {
+public:
+  explicit CrossWorkerCarriers(uint32_t num_workers) : relays_(num_workers) {}
+
+  /**
+   * Adds the relay of a worker that has started.
+   * @return false if all the slots are taken.
+   */
+  bool add(CrossWorkerRelaySharedPtr relay) ABSL_LOCKS_EXCLUDED(mutex_);
+
+  /**
+   * @return the relay of the worker that carries the streams to the host, or nullptr if that worker
+   *         has not started yet or has shut down, in which case each worker uses its own pool.
+   */
+  CrossWorkerRelaySharedPtr carrierFor(const Upstream::HostDescription& host) const
+      ABSL_LOCKS_EXCLUDED(mutex_);
+
+private:
+  mutable absl::Mutex mutex_;
+  std::vector<CrossWorkerRelaySharedPtr> relays_ ABSL_GUARDED_BY(mutex_);
+  size_t num_added_ ABSL_GUARDED_BY(mutex_){};
+};
+
+/**
+ * An HTTP/2 or HTTP/3 connection pool which carries its streams on the connection pool of another
+ * worker, the carrier, so that the workers of a process share one set of upstream connections to
+ * a host instead of each opening their own.
+ *
+ * Each stream is handed to the carrier worker when it is created. From then on the request is
+ * copied to the carrier and the response, resets and watermark events are posted back, so the
+ * caller sees an ordinary stream on its own worker. Flow control works across the hop: read
+ * disabling the stream read disables the carried stream, and the carried stream's watermarks are
+ * raised on this one. The request body posted to the carrier and not yet encoded there counts
+ * against the buffer limit of the carried stream, and raises this stream's watermarks too, so
+ * that the caller stops reading the downstream while the carrier worker is behind.
+ *
+ * The stream info handed to onPoolReady() is a copy of the upstream connection's addresses,
+ * connection ID and timing. The TLS session and the filter state of the connection stay on the
+ * carrier worker.
+ */
+class CrossWorkerConnPool : public ConnectionPool::Instance,
+                            protected Logger::Loggable<Logger::Id::pool> {
+public:
+  CrossWorkerConnPool(CrossWorkerRelaySharedPtr relay, CrossWorkerRelaySharedPtr carrier,
+                      Upstream::HostConstSharedPtr host, Http::Protocol protocol,
+                      CarrierPoolCb carrier_pool_cb);
+  ~CrossWorkerConnPool() override;
+
+  // ConnectionPool::Instance
+  bool hasActiveConnections() const override { return !streams_.empty(); }
+  ConnectionPool::Cancellable* newStream(ResponseDecoder& response_decoder,
+                                         ConnectionPool::Callbacks& callbacks,
+                                         const StreamOptions& options) override;
+  absl::string_view protocolDescription() const override;
+
+  // Envoy::ConnectionPool::Instance
+  void addIdleCallback(IdleCb cb) override { idle_callbacks_.push_back(std::move(cb)); }
+  bool isIdle() const override { return streams_.empty(); }
+  void drainConnections(Envoy::ConnectionPool::DrainBehavior drain_behavior) override;
+  Upstream::HostDescriptionConstSharedPtr host() const override { return host_; }
+  bool maybePreconnect(float) override {
+    return false; // The carrier worker's pool preconnects for its own streams.
+  }
+
+  /**
+   * Called by a stream when it is done, either because both directions completed or because it was
+   * cancelled, failed or reset.
+   */
+  void onStreamDone(CrossWorkerStream& stream);
+
+  Event::Dispatcher& dispatcher() { return relay_->dispatcher(); }
+
+private:
+  void checkForIdleAndNotify();
+
+  const CrossWorkerRelaySharedPtr relay_;
+  const CrossWorkerRelaySharedPtr carrier_;
+  const Upstream::HostConstSharedPtr host_;
+  const Http::Protocol protocol_;
+  const CarrierPoolCb carrier_pool_cb_;
+  std::list<std::unique_ptr<CrossWorkerStream>> streams_;
+  std::list<IdleCb> idle_callbacks_;
+  bool draining_for_deletion_{};
+  bool destroying_{};
+};
+
+} // namespace Http
+} // namespace Envoy
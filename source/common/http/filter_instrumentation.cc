@@ -0,0 +1,127 @@
+#include "source/common/http/filter_instrumentation.h"
+
+#include <ctime>
+
+#include "source/common/protobuf/utility.h"
+#include "source/common/stats/utility.h"
+
+#include "absl/base/call_once.h"
+#include "absl/strings/str_cat.h"
+
+#if defined(GPERFTOOLS_TCMALLOC)
+#include "gperftools/malloc_hook.h"
+#endif
+
+namespace Envoy {
+namespace Http {
+
+namespace {
+
+#if defined(GPERFTOOLS_TCMALLOC)
+// Counted by the allocation hook for every allocation of the thread, and read before and after a
+// filter callback.
+thread_local uint64_t thread_allocated_bytes = 0;
+
+void onAllocation(const void*, size_t size) { thread_allocated_bytes += size; }
+
+void installAllocationHook() {
+  static absl::once_flag once;
+  absl::call_once(once, []() { RELEASE_ASSERT(MallocHook::AddNewHook(&onAllocation), ""); });
+}
+#else
+void installAllocationHook() {}
+#endif
+
+} // namespace
+
+FilterInstrumentation::FilterInstrumentation(
+    const envoy::extensions::filters::network::http_connection_manager::v3::HttpConnectionManager::
+        FilterInstrumentation& config,
+    const std::string& stat_prefix, Stats::Scope& scope, TimeSource& time_source,
+    Random::RandomGenerator& random)
+    : sampling_interval_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, sampling_interval, 100)),
+      record_allocated_bytes_(config.record_allocated_bytes() && allocationHookSupported()),
+      scope_(scope), time_source_(time_source), random_(random), pool_(scope.symbolTable()),
+      prefix_(pool_.add(absl::StrCat(stat_prefix, "filter_instrumentation"))),
+      callback_names_({pool_.add("decode_headers"), pool_.add("decode_data"),
+                       pool_.add("decode_trailers"), pool_.add("encode_headers"),
+                       pool_.add("encode_data"), pool_.add("encode_trailers")}),
+      wall_time_us_(pool_.add("wall_time_us")), cpu_time_us_(pool_.add("cpu_time_us")),
+      allocated_bytes_(pool_.add("allocated_bytes")) {
+  if (record_allocated_bytes_) {
+    installAllocationHook();
+  }
+}
+
+std::chrono::nanoseconds FilterInstrumentation::threadCpuTime() {
+#ifdef __linux__
+  struct timespec ts;
+  if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) == 0) {
+    return std::chrono::seconds(ts.tv_sec) + std::chrono::nanoseconds(ts.tv_nsec);
+  }
+#endif
+  return std::chrono::nanoseconds(0);
+}
+
+uint64_t FilterInstrumentation::threadAllocatedBytes() {
+#if defined(GPERFTOOLS_TCMALLOC)
+  return thread_allocated_bytes;
+#else
+  return 0;
+#endif
+}
+
+bool FilterInstrumentation::allocationHookSupported() {
+#if defined(GPERFTOOLS_TCMALLOC)
+  return true;
+#else
+  return false;
+#endif
+}
+
+const FilterInstrumentation::FilterStats&
+FilterInstrumentation::filterStats(absl::string_view filter_name) {
+  Thread::LockGuard lock(mutex_);
+  auto it = filter_stats_.find(filter_name);
+  if (it != filter_stats_.end()) {
+    return it->second;
+  }
+
+  const Stats::DynamicName filter(filter_name);
+  FilterStats& stats = filter_stats_[filter_name];
+  for (uint32_t i = 0; i < NumCallbacks; ++i) {
+    auto histogram = [&](Stats::StatName metric, Stats::Histogram::Unit unit) {
+      return &Stats::Utility::histogramFromElements(
+          scope_, {prefix_, filter, callback_names_[i], metric}, unit);
+    };
+    stats[i] = {histogram(wall_time_us_, Stats::Histogram::Unit::Microseconds),
+                histogram(cpu_time_us_, Stats::Histogram::Unit::Microseconds),
+                record_allocated_bytes_ ? histogram(allocated_bytes_, Stats::Histogram::Unit::Bytes)
+                                        : nullptr};
+  }
+  return stats;
+}
+
+FilterInstrumentation::ScopedSample::ScopedSample(FilterInstrumentation& parent,
+                                                  const FilterStats& stats, Callback callback)
+    : parent_(parent), stats_(stats[static_cast<uint32_t>(callback)]),
+      start_wall_time_(parent.time_source_.monotonicTime()), start_cpu_time_(threadCpuTime()),
+      start_allocated_bytes_(threadAllocatedBytes()) {}
+
+FilterInstrumentation::ScopedSample::~ScopedSample() {
+  // Read the allocation counter first, so that recording the sample isn't accounted to the filter.
+  const uint64_t allocated_bytes = threadAllocatedBytes() - start_allocated_bytes_;
+  const std::chrono::nanoseconds cpu_time = threadCpuTime() - start_cpu_time_;
+  const MonotonicTime end_wall_time = parent_.time_source_.monotonicTime();
+  stats_.wall_time_us_->recordValue(
+      std::chrono::duration_cast<std::chrono::microseconds>(end_wall_time - start_wall_time_)
+          .count());
+  stats_.cpu_time_us_->recordValue(
+      std::chrono::duration_cast<std::chrono::microseconds>(cpu_time).count());
+  if (stats_.allocated_bytes_ != nullptr) {
+    stats_.allocated_bytes_->recordValue(allocated_bytes);
+  }
+}
+
+} // namespace Http
+} // namespace Envoy
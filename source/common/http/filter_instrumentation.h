@@ -0,0 +1,147 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "envoy/common/random_generator.h"
+#include "envoy/common/time.h"
+#include "envoy/extensions/filters/network/http_connection_manager/v3/http_connection_manager.pb.h"
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats.h"
+
+#include "source/common/common/thread.h"
+#include "source/common/stats/symbol_table.h"
+
+#include "absl/container/node_hash_map.h"
+
+namespace Envoy {
+namespace Http {
+
+/**
+ * Sampled measurement of the cost of the HTTP filter callbacks. For one in sampling_interval
+ * streams, the wall time, the CPU time of the worker thread and optionally the bytes it allocated
+ * are recorded for each filter callback, in histograms named
+ * <stat_prefix>filter_instrumentation.<filter_name>.<callback>.<metric>. Measurements include
+ * anything the filter calls synchronously, e.g. the encoder filters run by a local reply.
+ *
+ * Streams that are not sampled never see the instrumentation, so that the only cost of the
+ * feature for them is a null check per filter callback.
+ */
+class FilterInstrumentation {
+public:
+  enum class Callback : uint8_t {
+    DecodeHeaders,
+    DecodeData,
+    DecodeTrailers,
+    EncodeHeaders,
+    EncodeData,
+    EncodeTrailers,
+  };
+  static constexpr uint32_t NumCallbacks = static_cast<uint32_t>(Callback::EncodeTrailers) + 1;
+
+  FilterInstrumentation(
+      const envoy::extensions::filters::network::http_connection_manager::v3::
+          HttpConnectionManager::FilterInstrumentation& config,
+      const std::string& stat_prefix, Stats::Scope& scope, TimeSource& time_source,
+      Random::RandomGenerator& random);
+
+  /**
+   * @return whether a new stream should be instrumented.
+   */
+  bool sampleStream() { return random_.random() % sampling_interval_ == 0; }
+
+  // The histograms of one callback of a filter. allocated_bytes_ is null unless allocations are
+  // recorded.
+  struct CallbackStats {
+    Stats::Histogram* wall_time_us_;
+    Stats::Histogram* cpu_time_us_;
+    Stats::Histogram* allocated_bytes_;
+  };
+  using FilterStats = std::array<CallbackStats, NumCallbacks>;
+
+  /**
+   * @return the histograms of all the callbacks of a filter, which are created the first time the
+   *         filter is sampled. The result lives as long as the instrumentation, so that callers
+   *         can look it up once per filter rather than once per callback.
+   */
+  const FilterStats& filterStats(absl::string_view filter_name);
+
+  /**
+   * Measures a filter callback from construction to destruction.
+   */
+  class ScopedSample {
+  public:
+    ScopedSample(FilterInstrumentation& parent, const FilterStats& stats, Callback callback);
+    ~ScopedSample();
+
+  private:
+    FilterInstrumentation& parent_;
+    const CallbackStats& stats_;
+    const MonotonicTime start_wall_time_;
+    const std::chrono::nanoseconds start_cpu_time_;
+    const uint64_t start_allocated_bytes_;
+  };
+
+  /**
+   * Runs a filter callback, measuring it if the stream is instrumented.
+   * @param instrumentation the instrumentation of the stream, or nullptr if it isn't sampled.
+   * @param stats the histograms of the filter, resolved on the first measured callback and kept
+   *        by the caller for the next ones.
+   * @param filter_name the config name of the filter.
+   * @param callback the callback being run.
+   * @param call runs the callback.
+   * @return the result of call.
+   */
+  template <class Call>
+  static auto measure(FilterInstrumentation* instrumentation, const FilterStats*& stats,
+                      absl::string_view filter_name, Callback callback, Call call)
+      -> decltype(call()) {
+    if (instrumentation == nullptr) {
+      return call();
+    }
+    if (stats == nullptr) {
+      stats = &instrumentation->filterStats(filter_name);
+    }
+    ScopedSample sample(*instrumentation, *stats, callback);
+    return call();
+  }
+
+  /**
+   * @return the CPU time consumed by the calling thread, or zero where this isn't supported.
+   */
+  static std::chrono::nanoseconds threadCpuTime();
+
+  /**
+   * @return the bytes allocated by the calling thread since the allocation hook was installed.
+   */
+  static uint64_t threadAllocatedBytes();
+
+  /**
+   * @return whether the allocations of each thread can be counted in this build.
+   */
+  static bool allocationHookSupported();
+
+private:
+  const uint64_t sampling_interval_;
+  const bool record_allocated_bytes_;
+  Stats::Scope& scope_;
+  TimeSource& time_source_;
+  Random::RandomGenerator& random_;
+  Stats::StatNamePool pool_;
+  const Stats::StatName prefix_;
+  const std::array<Stats::StatName, NumCallbacks> callback_names_;
+  const Stats::StatName wall_time_us_;
+  const Stats::StatName cpu_time_us_;
+  const Stats::StatName allocated_bytes_;
+  // Only taken the first time a filter of a sampled stream is measured.
+  Thread::MutexBasicLockable mutex_;
+  absl::node_hash_map<std::string, FilterStats> filter_stats_ ABSL_GUARDED_BY(mutex_);
+};
+
+using FilterInstrumentationPtr = std::unique_ptr<FilterInstrumentation>;
+
+} // namespace Http
+} // namespace Envoy
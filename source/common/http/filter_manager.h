@@ -18,6 +18,7 @@
 #include "source/common/common/linked_object.h"
 #include "source/common/common/logger.h"
 #include "source/common/grpc/common.h"
+#include "source/common/http/filter_instrumentation.h"
 #include "source/common/http/header_utility.h"
 #include "source/common/http/headers.h"
 #include "source/common/http/matching/data_impl.h"
@@ -235,6 +236,8 @@ struct ActiveStreamFilterBase : public virtual StreamFilterCallbacks,
   bool end_stream_{};
   // If true, the filter has processed headers.
   bool processed_headers_{};
+  // The histograms measuring this filter, resolved when it is first sampled.
+  const FilterInstrumentation::FilterStats* instrumentation_stats_{};
 };
 
 /**
@@ -914,6 +917,14 @@ public:
   void onDownstreamReset() { state_.saw_downstream_reset_ = true; }
   bool sawDownstreamReset() { return state_.saw_downstream_reset_; }
 
+  /**
+   * Measures the cost of each filter callback of this stream, see FilterInstrumentation.
+   * @param instrumentation the instrumentation, which must outlive the stream.
+   */
+  void setFilterInstrumentation(FilterInstrumentation& instrumentation) {
+    filter_instrumentation_ = &instrumentation;
+  }
+
   virtual bool shouldLoadShed() { return false; };
 
   void sendGoAwayAndClose(bool graceful = false) {
@@ -1116,6 +1127,15 @@ private:
 
   bool isTerminalDecoderFilter(const ActiveStreamDecoderFilter& filter) const;
 
+  // Runs a filter callback, measuring it if this stream is instrumented.
+  template <class Call>
+  auto instrumentFilterCall(ActiveStreamFilterBase& filter,
+                            FilterInstrumentation::Callback callback, Call call)
+      -> decltype(call()) {
+    return FilterInstrumentation::measure(filter_instrumentation_, filter.instrumentation_stats_,
+                                          filter.filter_context_.config_name, callback, call);
+  }
+
   FilterManagerCallbacks& filter_manager_callbacks_;
   Event::Dispatcher& dispatcher_;
   // This is unset if there is no downstream connection, e.g. for health check or
@@ -1124,6 +1144,7 @@ private:
   const uint64_t stream_id_;
   Buffer::BufferMemoryAccountSharedPtr account_;
   const bool proxy_100_continue_;
+  FilterInstrumentation* filter_instrumentation_{};
 
   StreamDecoderFilters decoder_filters_;
   StreamEncoderFilters encoder_filters_;
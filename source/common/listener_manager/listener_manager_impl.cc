@@ -1065,6 +1065,9 @@ absl::Status ListenerManagerImpl::startWorkers(OptRef<GuardDog> guard_dog,
     if (enable_dispatcher_stats_) {
       worker->initializeStats(*scope_);
     }
+    if (server_.bootstrap().has_slow_callback_tracker()) {
+      worker->initializeSlowCallbackTracker(server_.bootstrap().slow_callback_tracker());
+    }
     i++;
   }
 
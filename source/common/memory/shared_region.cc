@@ -0,0 +1,164 @@
+#include "source/common/memory/shared_region.h"
+
+#include <algorithm>
+#include <thread>
+
+#include "source/common/api/os_sys_calls_impl.h"
+#include "source/common/common/assert.h"
+#include "source/common/common/fmt.h"
+#include "source/common/common/utility.h"
+
+#include "absl/numeric/bits.h"
+
+namespace Envoy {
+namespace Memory {
+
+namespace {
+
+// The states of a region. The first process to find the memory empty lays the region out, and
+// the others wait for it to become ready.
+constexpr uint64_t RegionEmpty = 0;
+constexpr uint64_t RegionInitializing = 1;
+constexpr uint64_t RegionReady = 2;
+
+// Waits until done() returns true, or the timeout expires.
+bool waitFor(std::chrono::milliseconds timeout, const std::function<bool()>& done) {
+  RealTimeSource time_source;
+  const MonotonicTime deadline = time_source.monotonicTime() + timeout;
+  while (!done()) {
+    if (time_source.monotonicTime() >= deadline) {
+      return false;
+    }
+    std::this_thread::yield();
+  }
+  return true;
+}
+
+} // namespace
+
+SharedRegion::SharedRegion(absl::string_view name, uint64_t magic, uint64_t version,
+                           uint64_t header_bytes, uint64_t slot_bytes)
+    : name_(name), magic_(magic), version_(version), header_bytes_(header_bytes),
+      slot_bytes_(slot_bytes) {
+  ASSERT(header_bytes_ >= sizeof(Header));
+}
+
+uint64_t SharedRegion::roundedCapacity(uint64_t capacity) {
+  return absl::bit_ceil(std::max<uint64_t>(capacity, 1));
+}
+
+uint64_t SharedRegion::bytesRequired(uint64_t capacity) const {
+  return header_bytes_ + roundedCapacity(capacity) * slot_bytes_;
+}
+
+uint64_t SharedRegion::create(void* memory, uint64_t capacity,
+                              const std::function<void(uint64_t)>& lay_out) const {
+  RELEASE_ASSERT((reinterpret_cast<uintptr_t>(memory) % alignof(Header)) == 0, "");
+  Header* header = reinterpret_cast<Header*>(memory);
+  uint64_t state = RegionEmpty;
+  RELEASE_ASSERT(header->state_.compare_exchange_strong(state, RegionInitializing),
+                 fmt::format("{} is already in use", name_));
+  capacity = roundedCapacity(capacity);
+  header->magic_ = magic_;
+  header->version_ = version_;
+  header->capacity_ = capacity;
+  lay_out(capacity);
+  header->state_.store(RegionReady, std::memory_order_release);
+  return capacity;
+}
+
+absl::StatusOr<uint64_t> SharedRegion::attach(const void* memory, uint64_t size) const {
+  RELEASE_ASSERT((reinterpret_cast<uintptr_t>(memory) % alignof(Header)) == 0, "");
+  if (size < header_bytes_) {
+    return absl::InvalidArgumentError(fmt::format("{} of {} bytes is too small", name_, size));
+  }
+  const Header* header = reinterpret_cast<const Header*>(memory);
+  if (header->state_.load(std::memory_order_acquire) != RegionReady ||
+      header->magic_ != magic_ || header->version_ != version_) {
+    return absl::InvalidArgumentError(fmt::format("{} has an incompatible layout", name_));
+  }
+  if (!absl::has_single_bit(header->capacity_) || size < bytesRequired(header->capacity_)) {
+    return absl::InvalidArgumentError(fmt::format("{} of {} bytes does not fit a capacity of {}",
+                                                  name_, size, header->capacity_));
+  }
+  return header->capacity_;
+}
+
+absl::StatusOr<uint64_t>
+SharedRegion::createOrAttach(void* memory, uint64_t size, uint64_t capacity,
+                             std::chrono::milliseconds timeout,
+                             const std::function<void(uint64_t)>& lay_out) const {
+  RELEASE_ASSERT((reinterpret_cast<uintptr_t>(memory) % alignof(Header)) == 0, "");
+  if (size < header_bytes_) {
+    return absl::InvalidArgumentError(fmt::format("{} of {} bytes is too small", name_, size));
+  }
+  Header* header = reinterpret_cast<Header*>(memory);
+  uint64_t state = RegionEmpty;
+  if (header->state_.compare_exchange_strong(state, RegionInitializing)) {
+    if (size < bytesRequired(capacity)) {
+      // Leave the memory empty for a process asking for a capacity which fits.
+      header->state_.store(RegionEmpty);
+      return absl::InvalidArgumentError(fmt::format("{} of {} bytes does not fit a capacity of {}",
+                                                    name_, size, roundedCapacity(capacity)));
+    }
+    header->magic_ = magic_;
+    header->version_ = version_;
+    header->capacity_ = roundedCapacity(capacity);
+    lay_out(header->capacity_);
+    header->state_.store(RegionReady, std::memory_order_release);
+  } else if (!waitFor(timeout, [header]() {
+               return header->state_.load(std::memory_order_acquire) != RegionInitializing;
+             })) {
+    return absl::UnavailableError(
+        fmt::format("{} was not laid out within {}ms; the process laying it out may have exited, "
+                    "in which case it must be removed",
+                    name_, timeout.count()));
+  }
+  return attach(memory, size);
+}
+
+absl::StatusOr<SharedRegion::Mapping> SharedRegion::mapFile(os_fd_t fd, absl::string_view path,
+                                                            uint64_t size,
+                                                            std::chrono::milliseconds timeout) {
+  Api::OsSysCalls& os_sys_calls = Api::OsSysCallsSingleton::get();
+  if (size > 0) {
+    const Api::SysCallIntResult result = os_sys_calls.ftruncate(fd, size);
+    if (result.return_value_ == -1) {
+      return absl::InvalidArgumentError(
+          fmt::format("unable to size {}: {}", path, errorDetails(result.errno_)));
+    }
+  } else {
+    struct stat stat_buf;
+    Api::SysCallIntResult result{};
+    const bool sized = waitFor(timeout, [&]() {
+      result = os_sys_calls.fstat(fd, &stat_buf);
+      return result.return_value_ == -1 || stat_buf.st_size > 0;
+    });
+    if (result.return_value_ == -1) {
+      return absl::InvalidArgumentError(
+          fmt::format("unable to stat {}: {}", path, errorDetails(result.errno_)));
+    }
+    if (!sized) {
+      return absl::UnavailableError(
+          fmt::format("{} was not sized within {}ms; the process creating it may have exited, in "
+                      "which case it must be removed",
+                      path, timeout.count()));
+    }
+    size = stat_buf.st_size;
+  }
+
+  const Api::SysCallPtrResult result =
+      os_sys_calls.mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (result.return_value_ == MAP_FAILED) {
+    return absl::InvalidArgumentError(
+        fmt::format("unable to map {}: {}", path, errorDetails(result.errno_)));
+  }
+  return Mapping{result.return_value_, size};
+}
+
+void SharedRegion::unmapFile(const Mapping& mapping) {
+  Api::OsSysCallsSingleton::get().munmap(mapping.memory_, mapping.size_);
+}
+
+} // namespace Memory
+} // namespace Envoy
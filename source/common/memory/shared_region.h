@@ -0,0 +1,130 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+#include "envoy/common/platform.h"
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+
+namespace Envoy {
+namespace Memory {
+
+/**
+ * The layout of a block of memory shared by several processes, holding a header followed by a
+ * power of two number of fixed-size slots, e.g. the hot restart shared stat region. The header
+ * starts with a SharedRegion::Header, which records the kind of region and the version of its
+ * layout, so that a process only uses a region laid out by a compatible version of Envoy.
+ *
+ * The first process to find the memory empty lays the region out. Processes attaching to it only
+ * wait for a bounded time for it to be ready, so that a process which exits while laying the
+ * region out, or while sizing the file holding it, doesn't leave the others waiting forever.
+ */
+class SharedRegion {
+public:
+  struct Header {
+    std::atomic<uint64_t> state_;
+    uint64_t magic_;
+    uint64_t version_;
+    uint64_t capacity_;
+  };
+
+  // The region is shared between processes, so its atomics must not rely on process local locks.
+  static_assert(std::atomic<uint64_t>::is_always_lock_free);
+
+  /**
+   * A file mapped by mapFile().
+   */
+  struct Mapping {
+    void* memory_;
+    uint64_t size_;
+  };
+
+  /**
+   * @param name describes the region in errors, e.g. "shared stat region".
+   * @param magic identifies the kind of region.
+   * @param version the version of the layout of the region, to be incremented when it changes.
+   * @param header_bytes the size of the region's header, which starts with a Header.
+   * @param slot_bytes the number of bytes of memory needed per slot.
+   */
+  SharedRegion(absl::string_view name, uint64_t magic, uint64_t version, uint64_t header_bytes,
+               uint64_t slot_bytes);
+
+  /**
+   * @return the capacity rounded up to a power of two, as the regions are laid out with.
+   */
+  static uint64_t roundedCapacity(uint64_t capacity);
+
+  /**
+   * @param capacity the number of slots, rounded up to a power of two.
+   * @return the number of bytes of memory needed for a region of the given capacity.
+   */
+  uint64_t bytesRequired(uint64_t capacity) const;
+
+  /**
+   * Lays out a region in memory which no other process uses yet.
+   * @param memory zero-filled memory of bytesRequired(capacity) bytes, aligned to 8 bytes.
+   * @param capacity the number of slots, rounded up to a power of two.
+   * @param lay_out initializes the rest of the header, given the rounded capacity, before the
+   *        region is published as ready.
+   * @return the rounded capacity.
+   */
+  uint64_t create(void* memory, uint64_t capacity,
+                  const std::function<void(uint64_t)>& lay_out) const;
+
+  /**
+   * Checks that memory holds a compatible region which is ready to use.
+   * @param memory the region's memory, aligned to 8 bytes.
+   * @param size the number of bytes of memory mapped.
+   * @return the capacity of the region, or an error if the memory does not hold a compatible
+   *         region.
+   */
+  absl::StatusOr<uint64_t> attach(const void* memory, uint64_t size) const;
+
+  /**
+   * Lays out a region in memory if it is empty, or attaches to the region laid out in it by
+   * another process. Safe to call from several processes at once.
+   * @param memory zero-filled or previously laid out memory, aligned to 8 bytes.
+   * @param size the number of bytes of memory mapped.
+   * @param capacity the number of slots to lay the region out with, if it is empty.
+   * @param timeout how long to wait for another process to finish laying the region out.
+   * @param lay_out initializes the rest of the header, as for create().
+   * @return the capacity of the region, or an error if the memory holds an incompatible region,
+   *         or the process laying it out did not finish in time, e.g. because it exited.
+   */
+  absl::StatusOr<uint64_t> createOrAttach(void* memory, uint64_t size, uint64_t capacity,
+                                          std::chrono::milliseconds timeout,
+                                          const std::function<void(uint64_t)>& lay_out) const;
+
+  /**
+   * Maps a file shared by the processes, read-write. The process which created the file sizes it,
+   * and the others wait for it to be sized.
+   * @param fd the file, which the caller closes once it is mapped.
+   * @param path the path of the file, for errors.
+   * @param size the size to give the file, or 0 if another process created it.
+   * @param timeout how long to wait for another process to size the file.
+   * @return the mapping, or an error if the file could not be sized or mapped in time.
+   */
+  static absl::StatusOr<Mapping> mapFile(os_fd_t fd, absl::string_view path, uint64_t size,
+                                         std::chrono::milliseconds timeout);
+
+  /**
+   * Unmaps a file mapped by mapFile().
+   */
+  static void unmapFile(const Mapping& mapping);
+
+private:
+  const std::string name_;
+  const uint64_t magic_;
+  const uint64_t version_;
+  const uint64_t header_bytes_;
+  const uint64_t slot_bytes_;
+};
+
+} // namespace Memory
+} // namespace Envoy
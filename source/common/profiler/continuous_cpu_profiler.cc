@@ -0,0 +1,508 @@
+#include "source/common/profiler/continuous_cpu_profiler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+
+#include "source/common/common/assert.h"
+#include "source/common/common/fmt.h"
+#include "source/common/common/macros.h"
+#include "source/common/profiler/profiler.h"
+#include "source/common/protobuf/utility.h"
+
+#include "absl/debugging/stacktrace.h"
+#include "absl/debugging/symbolize.h"
+#include "absl/synchronization/mutex.h"
+
+#ifdef __linux__
+#include <csignal>
+#include <sys/time.h>
+#include <ucontext.h>
+#endif
+
+namespace Envoy {
+namespace Profiler {
+
+namespace {
+
+// Appends protobuf wire format fields to a string. The pprof profile isn't one of the API protos,
+// so it is encoded field by field.
+class ProtoEncoder {
+public:
+  void addVarint(uint32_t field, uint64_t value) {
+    writeVarint(static_cast<uint64_t>(field) << 3);
+    writeVarint(value);
+  }
+
+  void addBytes(uint32_t field, absl::string_view value) {
+    writeVarint((static_cast<uint64_t>(field) << 3) | 2);
+    writeVarint(value.size());
+    out_.append(value.data(), value.size());
+  }
+
+  void addPacked(uint32_t field, const std::vector<uint64_t>& values) {
+    ProtoEncoder packed;
+    for (const uint64_t value : values) {
+      packed.writeVarint(value);
+    }
+    addBytes(field, packed.out_);
+  }
+
+  const std::string& data() const { return out_; }
+
+private:
+  void writeVarint(uint64_t value) {
+    while (value >= 0x80) {
+      out_.push_back(static_cast<char>(value | 0x80));
+      value >>= 7;
+    }
+    out_.push_back(static_cast<char>(value));
+  }
+
+  std::string out_;
+};
+
+// Builds the pprof Profile message, interning the strings, functions and locations of the
+// samples as they are added.
+class PprofBuilder {
+public:
+  PprofBuilder() { stringId(""); }
+
+  void addSample(absl::string_view thread_label, absl::Span<const uintptr_t> stack, uint64_t count,
+                 uint64_t cpu_nanos) {
+    std::vector<uint64_t> location_ids;
+    location_ids.reserve(stack.size());
+    for (size_t i = 0; i < stack.size(); ++i) {
+      // Callers are identified by their return address, which may already belong to the next
+      // line, or the next function for a call at the end of a function.
+      location_ids.push_back(locationId(stack[i], i == 0 ? stack[i] : stack[i] - 1));
+    }
+    ProtoEncoder label;
+    label.addVarint(1, stringId("thread"));
+    label.addVarint(2, stringId(thread_label));
+
+    ProtoEncoder sample;
+    sample.addPacked(1, location_ids);
+    sample.addPacked(2, {count, cpu_nanos});
+    sample.addBytes(3, label.data());
+    samples_.push_back(sample.data());
+  }
+
+  void addDroppedSamples(uint64_t count, uint64_t cpu_nanos) {
+    ProtoEncoder sample;
+    sample.addPacked(1, {functionLocationId("[dropped samples]")});
+    sample.addPacked(2, {count, cpu_nanos});
+    samples_.push_back(sample.data());
+  }
+
+  std::string build(int64_t time_nanos, int64_t duration_nanos, int64_t period_nanos) {
+    ProtoEncoder profile;
+    profile.addBytes(1, valueType("samples", "count"));
+    profile.addBytes(1, valueType("cpu", "nanoseconds"));
+    for (const std::string& sample : samples_) {
+      profile.addBytes(2, sample);
+    }
+    for (const std::string& location : locations_) {
+      profile.addBytes(4, location);
+    }
+    for (const std::string& function : functions_) {
+      profile.addBytes(5, function);
+    }
+    // Interned last, so that it is included in the string table.
+    const std::string period_type = valueType("cpu", "nanoseconds");
+    for (const std::string& string : strings_) {
+      profile.addBytes(6, string);
+    }
+    profile.addVarint(9, time_nanos);
+    profile.addVarint(10, duration_nanos);
+    profile.addBytes(11, period_type);
+    profile.addVarint(12, period_nanos);
+    return profile.data();
+  }
+
+private:
+  uint64_t stringId(absl::string_view string) {
+    auto [it, inserted] = string_ids_.try_emplace(string, strings_.size());
+    if (inserted) {
+      strings_.emplace_back(string);
+    }
+    return it->second;
+  }
+
+  std::string valueType(absl::string_view type, absl::string_view unit) {
+    ProtoEncoder value_type;
+    value_type.addVarint(1, stringId(type));
+    value_type.addVarint(2, stringId(unit));
+    return value_type.data();
+  }
+
+  uint64_t functionId(const std::string& name) {
+    auto [it, inserted] = function_ids_.try_emplace(name, functions_.size() + 1);
+    if (inserted) {
+      ProtoEncoder function;
+      function.addVarint(1, it->second);
+      function.addVarint(2, stringId(name));
+      function.addVarint(3, stringId(name));
+      functions_.push_back(function.data());
+    }
+    return it->second;
+  }
+
+  uint64_t addLocation(uint64_t address, uint64_t function_id) {
+    const uint64_t id = locations_.size() + 1;
+    ProtoEncoder line;
+    line.addVarint(1, function_id);
+    ProtoEncoder location;
+    location.addVarint(1, id);
+    location.addVarint(3, address);
+    location.addBytes(4, line.data());
+    locations_.push_back(location.data());
+    return id;
+  }
+
+  uint64_t locationId(uintptr_t address, uintptr_t symbolize_address) {
+    auto it = location_ids_.find(address);
+    if (it != location_ids_.end()) {
+      return it->second;
+    }
+    char name[1024];
+    const uint64_t function_id =
+        functionId(absl::Symbolize(reinterpret_cast<const void*>(symbolize_address), name,
+                                   sizeof(name))
+                       ? std::string(name)
+                       : fmt::format("{:#x}", address));
+    const uint64_t id = addLocation(address, function_id);
+    location_ids_.emplace(address, id);
+    return id;
+  }
+
+  uint64_t functionLocationId(const std::string& name) {
+    auto it = pseudo_location_ids_.find(name);
+    if (it != pseudo_location_ids_.end()) {
+      return it->second;
+    }
+    const uint64_t id = addLocation(0, functionId(name));
+    pseudo_location_ids_.emplace(name, id);
+    return id;
+  }
+
+  std::vector<std::string> strings_;
+  absl::flat_hash_map<std::string, uint64_t> string_ids_;
+  std::vector<std::string> functions_;
+  absl::flat_hash_map<std::string, uint64_t> function_ids_;
+  std::vector<std::string> locations_;
+  absl::flat_hash_map<uintptr_t, uint64_t> location_ids_;
+  absl::flat_hash_map<std::string, uint64_t> pseudo_location_ids_;
+  std::vector<std::string> samples_;
+};
+
+constexpr std::chrono::seconds FlushInterval(1);
+constexpr absl::string_view UnlabelledThread = "other";
+
+// Samples are handed from the signal handlers to the main thread through a bounded
+// multi-producer, single-consumer ring buffer: a producer claims a slot by advancing
+// ring_enqueue_pos, and publishes it by setting the slot's sequence. Samples taken while the ring
+// is full are counted in ring_dropped. The ring has static storage, so that a signal handled while
+// the profiler is being stopped never touches freed memory.
+constexpr uint64_t RingSize = 4096;
+static_assert((RingSize & (RingSize - 1)) == 0, "RingSize must be a power of two");
+
+struct RingSlot {
+  std::atomic<uint64_t> sequence_;
+  int32_t thread_label_;
+  uint32_t depth_;
+  void* stack_[ContinuousCpuProfiler::MaxStackDepth];
+};
+
+RingSlot ring[RingSize];
+std::atomic<uint64_t> ring_enqueue_pos{0};
+std::atomic<uint64_t> ring_dropped{0};
+std::atomic<bool> sampling{false};
+// Only accessed on the main thread.
+uint64_t ring_dequeue_pos = 0;
+ContinuousCpuProfiler* active_profiler = nullptr;
+
+// Index into thread_labels(), or -1. Trivially initialized, so that it can be read by the signal
+// handler.
+thread_local int32_t current_thread_label = -1;
+
+ABSL_CONST_INIT absl::Mutex thread_labels_mutex(absl::kConstInit);
+
+std::vector<std::string>& threadLabels() ABSL_EXCLUSIVE_LOCKS_REQUIRED(thread_labels_mutex) {
+  MUTABLE_CONSTRUCT_ON_FIRST_USE(std::vector<std::string>);
+}
+
+#ifdef __linux__
+// The SIGPROF disposition before the profiler started, restored when it stops.
+struct sigaction previous_profiling_action;
+
+uintptr_t interruptedPc(const void* ucontext) {
+  const auto* context = static_cast<const ucontext_t*>(ucontext);
+#if defined(__x86_64__)
+  return context->uc_mcontext.gregs[REG_RIP];
+#elif defined(__aarch64__)
+  return context->uc_mcontext.pc;
+#else
+  UNREFERENCED_PARAMETER(context);
+  return 0;
+#endif
+}
+
+// Must be async-signal-safe.
+void onProfilingSignal(int, siginfo_t*, void* ucontext) {
+  if (!sampling.load(std::memory_order_relaxed)) {
+    return;
+  }
+  const int saved_errno = errno;
+  uint64_t pos = ring_enqueue_pos.load(std::memory_order_relaxed);
+  RingSlot* slot;
+  while (true) {
+    slot = &ring[pos & (RingSize - 1)];
+    const uint64_t sequence = slot->sequence_.load(std::memory_order_acquire);
+    if (sequence == pos) {
+      if (ring_enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+        break;
+      }
+    } else if (sequence < pos) {
+      // The slot of the previous lap hasn't been drained yet.
+      ring_dropped.fetch_add(1, std::memory_order_relaxed);
+      errno = saved_errno;
+      return;
+    } else {
+      pos = ring_enqueue_pos.load(std::memory_order_relaxed);
+    }
+  }
+
+  slot->thread_label_ = current_thread_label;
+  uint32_t depth = 0;
+  const uintptr_t pc = interruptedPc(ucontext);
+  if (pc != 0) {
+    slot->stack_[depth++] = reinterpret_cast<void*>(pc);
+  }
+  // Skip the frames of this handler and of the signal trampoline, which unwinds to the caller of
+  // the interrupted function. The unwinder follows frame pointers, which unlike a DWARF unwinder
+  // is async-signal-safe, so the stack stops at the first function built without them.
+  depth += absl::GetStackTraceWithContext(slot->stack_ + depth,
+                                          ContinuousCpuProfiler::MaxStackDepth - depth, 2, ucontext,
+                                          nullptr);
+  slot->depth_ = depth;
+  slot->sequence_.store(pos + 1, std::memory_order_release);
+  errno = saved_errno;
+}
+#endif
+
+} // namespace
+
+CpuProfileTable::CpuProfileTable(uint32_t max_stacks, std::chrono::seconds max_window,
+                                 std::chrono::nanoseconds sampling_period, MonotonicTime now)
+    : max_stacks_(max_stacks), max_window_(max_window), sampling_period_(sampling_period) {
+  buckets_.push_back(Bucket{now, now, {}, 0});
+}
+
+void CpuProfileTable::addSample(absl::string_view thread_label,
+                                absl::Span<const uintptr_t> stack) {
+  Bucket& bucket = buckets_.back();
+  StackKey key{std::string(thread_label), std::vector<uintptr_t>(stack.begin(), stack.end())};
+  uint32_t id;
+  auto it = stack_ids_.find(key);
+  if (it != stack_ids_.end()) {
+    id = it->second;
+  } else {
+    if (stack_ids_.size() >= max_stacks_) {
+      ++bucket.dropped_;
+      return;
+    }
+    if (free_stack_ids_.empty()) {
+      id = stacks_.size();
+      stacks_.emplace_back();
+    } else {
+      id = free_stack_ids_.back();
+      free_stack_ids_.pop_back();
+    }
+    it = stack_ids_.emplace(std::move(key), id).first;
+    stacks_[id] = Stack{&it->first, 0};
+  }
+
+  auto [count, inserted] = bucket.counts_.try_emplace(id, 0);
+  if (inserted) {
+    ++stacks_[id].buckets_;
+  }
+  ++count->second;
+}
+
+void CpuProfileTable::releaseBucket(const Bucket& bucket) {
+  for (const auto& [id, count] : bucket.counts_) {
+    Stack& stack = stacks_[id];
+    ASSERT(stack.buckets_ > 0);
+    if (--stack.buckets_ == 0) {
+      stack_ids_.erase(*stack.key_);
+      stack.key_ = nullptr;
+      free_stack_ids_.push_back(id);
+    }
+  }
+}
+
+void CpuProfileTable::flush(MonotonicTime now) {
+  buckets_.back().end_ = now;
+  buckets_.push_back(Bucket{now, now, {}, 0});
+  while (buckets_.front().end_ < now - max_window_) {
+    releaseBucket(buckets_.front());
+    buckets_.pop_front();
+  }
+}
+
+std::string CpuProfileTable::profile(std::chrono::seconds window, MonotonicTime now,
+                                     SystemTime system_now) const {
+  const MonotonicTime window_start = now - window;
+  MonotonicTime start = now;
+  absl::flat_hash_map<uint32_t, uint64_t> counts;
+  uint64_t dropped = 0;
+  for (const Bucket& bucket : buckets_) {
+    // The open bucket always overlaps the window.
+    if (&bucket != &buckets_.back() && bucket.end_ <= window_start) {
+      continue;
+    }
+    start = std::min(start, bucket.start_);
+    for (const auto& [id, count] : bucket.counts_) {
+      counts[id] += count;
+    }
+    dropped += bucket.dropped_;
+  }
+
+  PprofBuilder builder;
+  const uint64_t period = sampling_period_.count();
+  for (const auto& [id, count] : counts) {
+    const StackKey& key = *stacks_[id].key_;
+    builder.addSample(key.thread_label_, key.stack_, count, count * period);
+  }
+  if (dropped > 0) {
+    builder.addDroppedSamples(dropped, dropped * period);
+  }
+  const std::chrono::nanoseconds duration = now - start;
+  const std::chrono::nanoseconds time =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(system_now.time_since_epoch()) -
+      duration;
+  return builder.build(time.count(), duration.count(), period);
+}
+
+ContinuousCpuProfiler::ContinuousCpuProfiler(std::chrono::seconds max_window, uint32_t max_stacks,
+                                             std::chrono::nanoseconds sampling_period,
+                                             Event::Dispatcher& dispatcher)
+    : dispatcher_(dispatcher), max_window_(max_window),
+      table_(max_stacks, max_window, sampling_period, dispatcher.timeSource().monotonicTime()) {
+  active_profiler = this;
+  flush_timer_ = dispatcher_.createTimer([this]() {
+    drain();
+    table_.flush(dispatcher_.timeSource().monotonicTime());
+    flush_timer_->enableTimer(FlushInterval);
+  });
+  flush_timer_->enableTimer(FlushInterval);
+}
+
+ContinuousCpuProfiler::~ContinuousCpuProfiler() {
+#ifdef __linux__
+  itimerval timer{};
+  setitimer(ITIMER_PROF, &timer, nullptr);
+  sampling.store(false, std::memory_order_relaxed);
+  // A SIGPROF which is still pending would terminate the process with the default action, so in
+  // that case the handler, which does nothing once sampling stopped, stays installed.
+  if (previous_profiling_action.sa_handler != SIG_DFL ||
+      (previous_profiling_action.sa_flags & SA_SIGINFO) != 0) {
+    sigaction(SIGPROF, &previous_profiling_action, nullptr);
+  }
+#endif
+  active_profiler = nullptr;
+}
+
+absl::StatusOr<std::unique_ptr<ContinuousCpuProfiler>>
+ContinuousCpuProfiler::create(const envoy::config::bootstrap::v3::ContinuousCpuProfiler& config,
+                              Event::Dispatcher& dispatcher) {
+#ifdef __linux__
+  if (active_profiler != nullptr) {
+    return absl::FailedPreconditionError("the continuous CPU profiler is already running");
+  }
+  if (Cpu::profilerEnabled()) {
+    return absl::FailedPreconditionError("the gperftools CPU profiler is running");
+  }
+
+  const uint32_t frequency = PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, sampling_frequency, 19);
+  const std::chrono::microseconds period(1000000 / frequency);
+  const std::chrono::seconds max_window(
+      PROTOBUF_GET_SECONDS_OR_DEFAULT(config, max_window, 60));
+  const uint32_t max_stacks = PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_stacks, 10000);
+
+  // Nothing can be sampling at this point, so the ring can be reset.
+  for (uint64_t i = 0; i < RingSize; ++i) {
+    ring[i].sequence_.store(i, std::memory_order_relaxed);
+  }
+  ring_enqueue_pos.store(0, std::memory_order_relaxed);
+  ring_dropped.store(0, std::memory_order_relaxed);
+  ring_dequeue_pos = 0;
+
+  struct sigaction action {};
+  action.sa_sigaction = onProfilingSignal;
+  action.sa_flags = SA_SIGINFO | SA_RESTART;
+  sigemptyset(&action.sa_mask);
+  if (sigaction(SIGPROF, &action, &previous_profiling_action) != 0) {
+    return absl::InternalError(fmt::format("failed to install the SIGPROF handler: {}", errno));
+  }
+  sampling.store(true, std::memory_order_release);
+
+  std::unique_ptr<ContinuousCpuProfiler> profiler(
+      new ContinuousCpuProfiler(max_window, max_stacks, period, dispatcher));
+  itimerval timer{};
+  timer.it_interval.tv_sec = period.count() / 1000000;
+  timer.it_interval.tv_usec = period.count() % 1000000;
+  timer.it_value = timer.it_interval;
+  if (setitimer(ITIMER_PROF, &timer, nullptr) != 0) {
+    return absl::InternalError(fmt::format("failed to start the profiling timer: {}", errno));
+  }
+  return profiler;
+#else
+  UNREFERENCED_PARAMETER(config);
+  UNREFERENCED_PARAMETER(dispatcher);
+  return absl::UnimplementedError("the continuous CPU profiler is only supported on Linux");
+#endif
+}
+
+ContinuousCpuProfiler* ContinuousCpuProfiler::instance() { return active_profiler; }
+
+void ContinuousCpuProfiler::setThreadLabel(absl::string_view label) {
+  absl::MutexLock lock(&thread_labels_mutex);
+  std::vector<std::string>& labels = threadLabels();
+  auto it = std::find(labels.begin(), labels.end(), label);
+  if (it == labels.end()) {
+    it = labels.emplace(labels.end(), label);
+  }
+  current_thread_label = it - labels.begin();
+}
+
+std::string ContinuousCpuProfiler::profile(std::chrono::seconds window) {
+  drain();
+  TimeSource& time_source = dispatcher_.timeSource();
+  return table_.profile(window, time_source.monotonicTime(), time_source.systemTime());
+}
+
+void ContinuousCpuProfiler::drain() {
+  absl::MutexLock lock(&thread_labels_mutex);
+  const std::vector<std::string>& labels = threadLabels();
+  while (true) {
+    RingSlot& slot = ring[ring_dequeue_pos & (RingSize - 1)];
+    if (slot.sequence_.load(std::memory_order_acquire) != ring_dequeue_pos + 1) {
+      break;
+    }
+    const absl::string_view label =
+        slot.thread_label_ >= 0 && static_cast<size_t>(slot.thread_label_) < labels.size()
+            ? absl::string_view(labels[slot.thread_label_])
+            : UnlabelledThread;
+    table_.addSample(label, absl::MakeConstSpan(reinterpret_cast<const uintptr_t*>(slot.stack_),
+                                                slot.depth_));
+    // Hand the slot back to the producers for the next lap.
+    slot.sequence_.store(ring_dequeue_pos + RingSize, std::memory_order_release);
+    ++ring_dequeue_pos;
+  }
+  table_.addDroppedSamples(ring_dropped.exchange(0, std::memory_order_relaxed));
+}
+
+} // namespace Profiler
+} // namespace Envoy
@@ -0,0 +1,168 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/common/time.h"
+#include "envoy/config/bootstrap/v3/bootstrap.pb.h"
+#include "envoy/event/dispatcher.h"
+#include "envoy/event/timer.h"
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/node_hash_map.h"
+#include "absl/hash/hash.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+
+namespace Envoy {
+namespace Profiler {
+
+/**
+ * Aggregates sampled stacks into one bucket per flush interval, and encodes the buckets of a
+ * window as a pprof profile (https://github.com/google/pprof/blob/main/proto/profile.proto).
+ * The number of distinct stacks across all the buckets is bounded: samples of a new stack beyond
+ * that bound are counted as dropped. Not thread-safe.
+ */
+class CpuProfileTable {
+public:
+  CpuProfileTable(uint32_t max_stacks, std::chrono::seconds max_window,
+                  std::chrono::nanoseconds sampling_period, MonotonicTime now);
+
+  /**
+   * Adds a sample to the open bucket.
+   * @param thread_label supplies the name of the thread the sample was taken on, e.g. worker_0.
+   * @param stack supplies the program counters of the sample, innermost first.
+   */
+  void addSample(absl::string_view thread_label, absl::Span<const uintptr_t> stack);
+
+  /**
+   * Counts samples which were lost before reaching the table.
+   */
+  void addDroppedSamples(uint64_t count) { buckets_.back().dropped_ += count; }
+
+  /**
+   * Closes the open bucket, opens a new one and discards the buckets older than the max window.
+   */
+  void flush(MonotonicTime now);
+
+  /**
+   * @return the samples of the buckets which overlap the last window, encoded as pprof.
+   */
+  std::string profile(std::chrono::seconds window, MonotonicTime now, SystemTime system_now) const;
+
+  /**
+   * @return the number of distinct stacks currently kept.
+   */
+  size_t numStacks() const { return stack_ids_.size(); }
+
+private:
+  struct StackKey {
+    std::string thread_label_;
+    std::vector<uintptr_t> stack_;
+
+    bool operator==(const StackKey& other) const {
+      return thread_label_ == other.thread_label_ && stack_ == other.stack_;
+    }
+    template <typename H> friend H AbslHashValue(H h, const StackKey& key) {
+      return H::combine(std::move(h), key.thread_label_, key.stack_);
+    }
+  };
+
+  struct Stack {
+    // Owned by stack_ids_.
+    const StackKey* key_{};
+    // The number of buckets with samples of this stack. The stack is forgotten when it drops to 0.
+    uint32_t buckets_{};
+  };
+
+  struct Bucket {
+    MonotonicTime start_;
+    MonotonicTime end_;
+    absl::flat_hash_map<uint32_t, uint64_t> counts_;
+    uint64_t dropped_{};
+  };
+
+  void releaseBucket(const Bucket& bucket);
+
+  const uint32_t max_stacks_;
+  const std::chrono::seconds max_window_;
+  const std::chrono::nanoseconds sampling_period_;
+  absl::node_hash_map<StackKey, uint32_t> stack_ids_;
+  std::vector<Stack> stacks_;
+  std::vector<uint32_t> free_stack_ids_;
+  // The last bucket is the open one.
+  std::deque<Bucket> buckets_;
+};
+
+/**
+ * Always-on sampling CPU profiler. ITIMER_PROF delivers SIGPROF to the thread which is consuming
+ * CPU time, whose signal handler captures the stack into a fixed-size lock-free ring buffer along
+ * with the label of the thread. Once a second, the ring buffer is drained into a CpuProfileTable on
+ * the main thread, from which profiles of the recent past are served.
+ *
+ * Only one profiler can run at a time, and not concurrently with the gperftools CPU profiler, since
+ * both rely on SIGPROF. The SIGPROF handler found at start is restored when the profiler stops. The
+ * profiler must be created and destroyed on the main thread.
+ *
+ * Stacks are unwound by following frame pointers, since DWARF unwinding isn't async-signal-safe.
+ * Without -fno-omit-frame-pointer, e.g. --config=frame-pointers, a stack ends at the first frame
+ * of a function built without them and often only has the interrupted function.
+ */
+class ContinuousCpuProfiler {
+public:
+  ~ContinuousCpuProfiler();
+
+  /**
+   * Starts the profiler.
+   * @param config supplies the profiler configuration.
+   * @param dispatcher supplies the main thread dispatcher, which drains the samples.
+   * @return the running profiler, or an error if profiling isn't supported on this platform or
+   *         another profiler is running.
+   */
+  static absl::StatusOr<std::unique_ptr<ContinuousCpuProfiler>>
+  create(const envoy::config::bootstrap::v3::ContinuousCpuProfiler& config,
+         Event::Dispatcher& dispatcher);
+
+  /**
+   * @return the running profiler, or nullptr. Must be called on the main thread.
+   */
+  static ContinuousCpuProfiler* instance();
+
+  /**
+   * Labels the samples taken on the calling thread, e.g. with the name of its dispatcher. Samples
+   * of threads without a label are labelled "other". Takes a lock, so call it once per thread.
+   */
+  static void setThreadLabel(absl::string_view label);
+
+  /**
+   * @return the profile of the last window, encoded as pprof.
+   */
+  std::string profile(std::chrono::seconds window);
+
+  std::chrono::seconds maxWindow() const { return max_window_; }
+
+  // The deepest stack kept for a sample.
+  static constexpr uint32_t MaxStackDepth = 64;
+
+private:
+  ContinuousCpuProfiler(std::chrono::seconds max_window, uint32_t max_stacks,
+                        std::chrono::nanoseconds sampling_period, Event::Dispatcher& dispatcher);
+
+  // Moves the samples from the ring buffer into the table.
+  void drain();
+
+  Event::Dispatcher& dispatcher_;
+  const std::chrono::seconds max_window_;
+  CpuProfileTable table_;
+  Event::TimerPtr flush_timer_;
+};
+
+using ContinuousCpuProfilerPtr = std::unique_ptr<ContinuousCpuProfiler>;
+
+} // namespace Profiler
+} // namespace Envoy
@@ -594,6 +594,16 @@ RouteEntryImplBase::RouteEntryImplBase(const CommonVirtualHostSharedPtr& vhost,
     SET_AND_RETURN_IF_NOT_OK(parser_or_error.status(), creation_status);
     response_headers_parser_ = std::move(parser_or_error.value());
   }
+  // Routes without header mutations of their own share the plans of their virtual host.
+  const bool specificity_ascend = vhost_->globalRouteConfig().mostSpecificHeaderMutationsWins();
+  request_headers_plan_ = request_headers_parser_ == nullptr
+                              ? vhost_->requestHeadersPlan()
+                              : HeaderMutationPlan::compile(getRequestHeaderParsers(
+                                    /*specificity_ascend=*/specificity_ascend));
+  response_headers_plan_ = response_headers_parser_ == nullptr
+                               ? vhost_->responseHeadersPlan()
+                               : HeaderMutationPlan::compile(getResponseHeaderParsers(
+                                     /*specificity_ascend=*/specificity_ascend));
   if (route.has_metadata()) {
     metadata_ = std::make_unique<RouteMetadataPack>(route.metadata());
   }
@@ -986,11 +996,7 @@ void RouteEntryImplBase::finalizeRequestHeaders(Http::RequestHeaderMap& headers,
                                                 bool keep_original_host_or_path) const {
   // Apply header transformations configured via request_headers_to_add first.
   // This is important because host/path rewriting may depend on headers added here.
-  for (const HeaderParser* header_parser : getRequestHeaderParsers(
-           /*specificity_ascend=*/vhost_->globalRouteConfig().mostSpecificHeaderMutationsWins())) {
-    // Later evaluated header parser wins.
-    header_parser->evaluateHeaders(headers, context, stream_info);
-  }
+  request_headers_plan_->evaluateHeaders(headers, context, stream_info);
 
   // Restore the port if this was a CONNECT request.
   // Note this will restore the port for HTTP/2 CONNECT-upgrades as well as as HTTP/1.1 style
@@ -1013,11 +1019,7 @@ void RouteEntryImplBase::finalizeRequestHeaders(Http::RequestHeaderMap& headers,
 void RouteEntryImplBase::finalizeResponseHeaders(Http::ResponseHeaderMap& headers,
                                                  const Formatter::Context& context,
                                                  const StreamInfo::StreamInfo& stream_info) const {
-  for (const HeaderParser* header_parser : getResponseHeaderParsers(
-           /*specificity_ascend=*/vhost_->globalRouteConfig().mostSpecificHeaderMutationsWins())) {
-    // Later evaluated header parser wins.
-    header_parser->evaluateHeaders(headers, context, stream_info);
-  }
+  response_headers_plan_->evaluateHeaders(headers, context, stream_info);
 }
 
 Http::HeaderTransforms
@@ -1621,6 +1623,14 @@ CommonVirtualHostImpl::CommonVirtualHostImpl(
                                                       virtual_host.response_headers_to_remove()),
                               Router::HeaderParserPtr);
   }
+  // Routes without header mutations of their own use these plans, see RouteEntryImplBase.
+  const bool specificity_ascend = global_route_config_->mostSpecificHeaderMutationsWins();
+  request_headers_plan_ = HeaderMutationPlan::compile(
+      getHeaderParsers(&global_route_config_->requestHeaderParser(), &requestHeaderParser(),
+                       &HeaderParser::defaultParser(), specificity_ascend));
+  response_headers_plan_ = HeaderMutationPlan::compile(
+      getHeaderParsers(&global_route_config_->responseHeaderParser(), &responseHeaderParser(),
+                       &HeaderParser::defaultParser(), specificity_ascend));
 
   // Retry and Hedge policies must be set before routes, since they may use them.
   if (virtual_host.has_retry_policy()) {
@@ -1796,17 +1806,79 @@ VirtualHostImpl::VirtualHostImpl(const envoy::config::route::v3::VirtualHost& vi
       SET_AND_RETURN_IF_NOT_OK(route_or_error.status(), creation_status);
       routes_.emplace_back(route_or_error.value());
     }
+    initializeRegexRouteMatcherSet(virtual_host, factory_context);
+  }
+}
+
+void VirtualHostImpl::initializeRegexRouteMatcherSet(
+    const envoy::config::route::v3::VirtualHost& virtual_host,
+    Server::Configuration::ServerFactoryContext& factory_context) {
+  ASSERT(static_cast<size_t>(virtual_host.routes().size()) == routes_.size());
+  if (!Runtime::runtimeFeatureEnabled("envoy.reloadable_features.route_regex_matcher_set")) {
+    return;
+  }
+
+  std::vector<std::string> regexes;
+  std::vector<uint8_t> set_ids(routes_.size(), NotInRegexRouteSet);
+  for (uint32_t i = 0; i < routes_.size() && regexes.size() < MaxRegexRouteSetSize; ++i) {
+    const auto& match = virtual_host.routes(i).match();
+    // Regexes using the deprecated google_re2 field are always compiled with RE2 rather than the
+    // configured engine, so they cannot be part of a set built by that engine.
+    if (match.path_specifier_case() ==
+            envoy::config::route::v3::RouteMatch::PathSpecifierCase::kSafeRegex &&
+        !match.safe_regex().has_google_re2()) {
+      set_ids[i] = regexes.size();
+      regexes.push_back(match.safe_regex().regex());
+    }
+  }
+
+  // A set only pays off when it replaces several individual regex matches.
+  if (regexes.size() > 1) {
+    auto set_or_error = factory_context.regexEngine().matcherSet(regexes);
+    if (set_or_error.ok()) {
+      regex_route_matcher_set_ = std::move(set_or_error.value());
+      regex_route_set_ids_ = std::move(set_ids);
+    }
   }
 }
 
+bool VirtualHostImpl::RegexRouteFilter::skip(uint32_t index) {
+  const uint8_t id = virtual_host_.regex_route_set_ids_[index];
+  if (id == NotInRegexRouteSet) {
+    return false;
+  }
+
+  if (!scanned_) {
+    scanned_ = true;
+    // The path is prepared in the same way as RegexRouteEntryImpl::matches() does before
+    // matching. Path sanitization only depends on the route configuration, so any route can do it.
+    const absl::string_view path = Http::PathUtil::removeQueryAndFragment(
+        virtual_host_.routes_[index]->sanitizePathBeforePathMatching(headers_.getPathValue()));
+    std::vector<uint32_t> matched;
+    if (virtual_host_.regex_route_matcher_set_->match(path, matched)) {
+      for (const uint32_t matched_id : matched) {
+        matched_ |= uint64_t{1} << matched_id;
+      }
+    } else {
+      // Fall back to matching every regex route individually.
+      matched_ = ~uint64_t{0};
+    }
+  }
+  return (matched_ & (uint64_t{1} << id)) == 0;
+}
+
 RouteConstSharedPtr VirtualHostImpl::getRouteFromRoutes(
     const RouteCallback& cb, const Http::RequestHeaderMap& headers,
     const StreamInfo::StreamInfo& stream_info, uint64_t random_value,
-    absl::Span<const RouteEntryImplBaseConstSharedPtr> routes) const {
+    absl::Span<const RouteEntryImplBaseConstSharedPtr> routes,
+    RegexRouteFilter* regex_route_filter) const {
   for (auto route = routes.begin(); route != routes.end(); ++route) {
     if (!headers.Path() && !(*route)->supportsPathlessHeaders()) {
       continue;
     }
+    if (regex_route_filter != nullptr && regex_route_filter->skip(route - routes.begin())) {
+      continue;
+    }
 
     RouteConstSharedPtr route_entry = (*route)->matches(headers, stream_info, random_value);
     if (route_entry == nullptr) {
@@ -1886,6 +1958,11 @@ RouteConstSharedPtr VirtualHostImpl::getRouteFromEntries(const RouteCallback& cb
   }
 
   // Check for a route that matches the request.
+  if (regex_route_matcher_set_ != nullptr && headers.Path() != nullptr) {
+    RegexRouteFilter regex_route_filter(*this, headers);
+    return getRouteFromRoutes(cb, headers, stream_info, random_value, routes_,
+                              &regex_route_filter);
+  }
   return getRouteFromRoutes(cb, headers, stream_info, random_value, routes_);
 }
 
@@ -254,6 +254,14 @@ public:
     }
     return HeaderParser::defaultParser();
   }
+  // Header mutation plans of the route configuration and virtual host levels, which are shared by
+  // all routes without header mutations of their own.
+  const HeaderMutationPlanConstSharedPtr& requestHeadersPlan() const {
+    return request_headers_plan_;
+  }
+  const HeaderMutationPlanConstSharedPtr& responseHeadersPlan() const {
+    return response_headers_plan_;
+  }
   absl::optional<bool> filterDisabled(absl::string_view config_name) const;
 
   // Router::VirtualHost
@@ -349,6 +357,8 @@ private:
   const CommonConfigSharedPtr global_route_config_;
   HeaderParserPtr request_headers_parser_;
   HeaderParserPtr response_headers_parser_;
+  HeaderMutationPlanConstSharedPtr request_headers_plan_;
+  HeaderMutationPlanConstSharedPtr response_headers_plan_;
   std::unique_ptr<PerFilterConfigs> per_filter_configs_;
   RetryPolicyConstSharedPtr retry_policy_;
   std::unique_ptr<envoy::config::route::v3::HedgePolicy> hedge_policy_;
@@ -378,16 +388,47 @@ public:
                                           const StreamInfo::StreamInfo& stream_info,
                                           uint64_t random_value) const;
 
+  /**
+   * Skips the regex routes of a lookup whose path regex is known not to match the request path.
+   * The regex route set is only scanned when the lookup first reaches a regex route in it, so a
+   * request matched by an earlier route never pays for the scan.
+   */
+  class RegexRouteFilter {
+  public:
+    RegexRouteFilter(const VirtualHostImpl& virtual_host, const Http::RequestHeaderMap& headers)
+        : virtual_host_(virtual_host), headers_(headers) {}
+
+    // Returns whether routes_[index] is a regex route whose regex does not match the path.
+    bool skip(uint32_t index);
+
+  private:
+    const VirtualHostImpl& virtual_host_;
+    const Http::RequestHeaderMap& headers_;
+    bool scanned_{};
+    // Bit i is set if expression i of the set matched the path. All bits are set if the set could
+    // not be evaluated, so that every regex route is matched individually.
+    uint64_t matched_{};
+  };
+
   RouteConstSharedPtr
   getRouteFromRoutes(const RouteCallback& cb, const Http::RequestHeaderMap& headers,
                      const StreamInfo::StreamInfo& stream_info, uint64_t random_value,
-                     absl::Span<const RouteEntryImplBaseConstSharedPtr> routes) const;
+                     absl::Span<const RouteEntryImplBaseConstSharedPtr> routes,
+                     RegexRouteFilter* regex_route_filter = nullptr) const;
 
   VirtualHostConstSharedPtr virtualHost() const { return shared_virtual_host_; }
 
 private:
   enum class SslRequirements : uint8_t { None, ExternalOnly, All };
 
+  void initializeRegexRouteMatcherSet(const envoy::config::route::v3::VirtualHost& virtual_host,
+                                      Server::Configuration::ServerFactoryContext& factory_context);
+
+  // The set holds at most this many regexes, so that its matches fit in a RegexRouteFilter's
+  // bitmask. Later regex routes are matched individually.
+  static constexpr uint32_t MaxRegexRouteSetSize = 64;
+  static constexpr uint8_t NotInRegexRouteSet = 0xff;
+
   CommonVirtualHostSharedPtr shared_virtual_host_;
 
   std::shared_ptr<const SslRedirectRoute> ssl_redirect_route_;
@@ -395,6 +436,12 @@ private:
 
   absl::InlinedVector<RouteEntryImplBaseConstSharedPtr, 2> routes_;
   Matcher::MatchTreeSharedPtr<Http::HttpMatchingData> matcher_;
+  // The path regexes of the regex routes in routes_, compiled into a single set when the regex
+  // engine supports it and envoy.reloadable_features.route_regex_matcher_set is enabled, so that
+  // a lookup scans the path once instead of once per regex route.
+  Regex::CompiledMatcherSetPtr regex_route_matcher_set_;
+  // For each entry of routes_, the index of its regex in the set, or NotInRegexRouteSet.
+  std::vector<uint8_t> regex_route_set_ids_;
 };
 
 using VirtualHostImplSharedPtr = std::shared_ptr<VirtualHostImpl>;
@@ -898,6 +945,9 @@ private:
   TlsContextMatchCriteriaConstPtr tls_context_match_criteria_;
   HeaderParserPtr request_headers_parser_;
   HeaderParserPtr response_headers_parser_;
+  // The header parsers of all levels compiled into single plans, see HeaderMutationPlan.
+  HeaderMutationPlanConstSharedPtr request_headers_plan_;
+  HeaderMutationPlanConstSharedPtr response_headers_plan_;
   RouteMetadataPackPtr metadata_;
   const std::vector<Envoy::Matchers::MetadataMatcher> dynamic_metadata_;
   const std::vector<Envoy::Matchers::FilterStateMatcher> filter_state_;
@@ -15,6 +15,8 @@
 #include "source/common/protobuf/utility.h"
 #include "source/common/runtime/runtime_features.h"
 
+#include "absl/container/flat_hash_set.h"
+#include "absl/strings/match.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_replace.h"
 
@@ -54,6 +56,15 @@ parseHttpHeaderFormatter(const envoy::config::core::v3::HeaderValue& header_valu
   return Envoy::Formatter::FormatterImpl::create(header_value.value(), true, command_parsers);
 }
 
+// Substitution commands, including the legacy ones, and escaped percent signs all start with '%',
+// so a value without one formats to itself.
+bool isConstantValue(absl::string_view value) { return !absl::StrContains(value, '%'); }
+
+bool isAppendAction(HeaderAppendAction append_action) {
+  return append_action == HeaderValueOption::APPEND_IF_EXISTS_OR_ADD ||
+         append_action == HeaderValueOption::ADD_IF_ABSENT;
+}
+
 } // namespace
 
 HeadersToAddEntry::HeadersToAddEntry(const HeaderValueOption& header_value_option,
@@ -80,6 +91,7 @@ HeadersToAddEntry::HeadersToAddEntry(const HeaderValueOption& header_value_optio
   auto formatter_or_error = parseHttpHeaderFormatter(header_value_option.header(), command_parsers);
   SET_AND_RETURN_IF_NOT_OK(formatter_or_error.status(), creation_status);
   formatter_ = std::move(formatter_or_error.value());
+  constant_ = isConstantValue(original_value_);
 }
 
 HeadersToAddEntry::HeadersToAddEntry(const HeaderValue& header_value,
@@ -90,6 +102,15 @@ HeadersToAddEntry::HeadersToAddEntry(const HeaderValue& header_value,
   auto formatter_or_error = parseHttpHeaderFormatter(header_value, command_parsers);
   SET_AND_RETURN_IF_NOT_OK(formatter_or_error.status(), creation_status);
   formatter_ = std::move(formatter_or_error.value());
+  constant_ = isConstantValue(original_value_);
+}
+
+void HeaderParser::addHeaderToAdd(Http::LowerCaseString&& key,
+                                  std::unique_ptr<HeadersToAddEntry>&& entry) {
+  if (!entry->constant_) {
+    ++formatted_headers_;
+  }
+  headers_to_add_.emplace_back(std::move(key), std::move(entry));
 }
 
 absl::StatusOr<HeaderParserPtr>
@@ -99,9 +120,8 @@ HeaderParser::configure(const Protobuf::RepeatedPtrField<HeaderValueOption>& hea
   for (const auto& header_value_option : headers_to_add) {
     auto entry_or_error = HeadersToAddEntry::create(header_value_option);
     RETURN_IF_NOT_OK_REF(entry_or_error.status());
-    header_parser->headers_to_add_.emplace_back(
-        Http::LowerCaseString(header_value_option.header().key()),
-        std::move(entry_or_error.value()));
+    header_parser->addHeaderToAdd(Http::LowerCaseString(header_value_option.header().key()),
+                                  std::move(entry_or_error.value()));
   }
 
   return header_parser;
@@ -116,8 +136,8 @@ absl::StatusOr<HeaderParserPtr> HeaderParser::configure(
   for (const auto& header_value : headers_to_add) {
     auto entry_or_error = HeadersToAddEntry::create(header_value, append_action);
     RETURN_IF_NOT_OK_REF(entry_or_error.status());
-    header_parser->headers_to_add_.emplace_back(Http::LowerCaseString(header_value.key()),
-                                                std::move(entry_or_error.value()));
+    header_parser->addHeaderToAdd(Http::LowerCaseString(header_value.key()),
+                                  std::move(entry_or_error.value()));
   }
 
   return header_parser;
@@ -151,6 +171,12 @@ void HeaderParser::evaluateHeaders(Http::HeaderMap& headers, const Formatter::Co
 
 void HeaderParser::evaluateHeaders(Http::HeaderMap& headers, const Formatter::Context& context,
                                    const StreamInfo::StreamInfo* stream_info) const {
+  evaluateHeaders(headers, context, stream_info, {});
+}
+
+void HeaderParser::evaluateHeaders(Http::HeaderMap& headers, const Formatter::Context& context,
+                                   const StreamInfo::StreamInfo* stream_info,
+                                   absl::Span<const HeaderToAdd* const> folded_headers) const {
   // Removing headers in the headers_to_remove_ list first makes
   // remove-before-add the default behavior as expected by users.
   for (const auto& header : headers_to_remove_) {
@@ -166,26 +192,28 @@ void HeaderParser::evaluateHeaders(Http::HeaderMap& headers, const Formatter::Co
   // header_formatter_speed_test.cc provides micro-benchmark for evaluating speed of adding and
   // replacing headers and should be used when modifying the code below to access the performance
   // impact of code changes.
-  absl::InlinedVector<std::pair<const Http::LowerCaseString&, const std::string>, 4> headers_to_add,
-      headers_to_overwrite;
-  // value_buffer is used only when stream_info is a valid pointer and stores header value
-  // created by a formatter. It is declared outside of 'for' loop for performance reason to avoid
-  // stack allocation and unnecessary std::string's memory adjustments for each iteration. The
-  // actual value of the header is accessed via 'value' variable which is initialized differently
-  // depending whether stream_info and valid or nullptr. Based on performance tests implemented in
-  // header_formatter_speed_test.cc this approach strikes the best balance between performance and
-  // readability.
-  std::string value_buffer;
-  for (const auto& [key, entry] : headers_to_add_) {
+  absl::InlinedVector<std::pair<const Http::LowerCaseString&, absl::string_view>, 4>
+      headers_to_add, headers_to_overwrite;
+  // formatted_values stores the values created by formatters, which are only invoked when
+  // stream_info is a valid pointer and the value is not constant. Constant values are referenced
+  // from the configuration, so that they are neither formatted nor copied before being added to
+  // the header map. The capacity is reserved up front so that the views of the formatted values
+  // stay valid.
+  absl::InlinedVector<std::string, 4> formatted_values;
+  if (stream_info != nullptr) {
+    formatted_values.reserve(formatted_headers_);
+  }
+  const auto evaluate_header = [&](const Http::LowerCaseString& key,
+                                   const HeadersToAddEntry& entry) {
     absl::string_view value;
-    if (stream_info != nullptr) {
-      value_buffer = entry->formatter_->format(context, *stream_info);
-      value = value_buffer;
+    if (stream_info != nullptr && !entry.constant_) {
+      formatted_values.push_back(entry.formatter_->format(context, *stream_info));
+      value = formatted_values.back();
     } else {
-      value = entry->original_value_;
+      value = entry.original_value_;
     }
-    if (!value.empty() || entry->add_if_empty_) {
-      switch (entry->append_action_) {
+    if (!value.empty() || entry.add_if_empty_) {
+      switch (entry.append_action_) {
         PANIC_ON_PROTO_ENUM_SENTINEL_VALUES;
       case HeaderValueOption::APPEND_IF_EXISTS_OR_ADD:
         headers_to_add.emplace_back(key, value);
@@ -205,6 +233,12 @@ void HeaderParser::evaluateHeaders(Http::HeaderMap& headers, const Formatter::Co
         break;
       }
     }
+  };
+  for (const auto& [key, entry] : headers_to_add_) {
+    evaluate_header(key, *entry);
+  }
+  for (const HeaderToAdd* header : folded_headers) {
+    evaluate_header(header->first, *header->second);
   }
 
   // First overwrite all headers which need to be overwritten.
@@ -262,5 +296,55 @@ Http::HeaderTransforms HeaderParser::getHeaderTransforms(const StreamInfo::Strea
   return transforms;
 }
 
+HeaderMutationPlanConstSharedPtr
+HeaderMutationPlan::compile(absl::Span<const HeaderParser* const> parsers) {
+  auto plan = std::make_shared<HeaderMutationPlan>();
+  // Keys that the current pass may add. A later parser cannot be folded into the pass if it
+  // overwrites one of them: the pass applies all overwrites before all additions, while evaluating
+  // the parsers one after the other would overwrite the added header.
+  absl::flat_hash_set<absl::string_view> added_keys;
+  for (const HeaderParser* parser : parsers) {
+    if (parser->empty()) {
+      continue;
+    }
+
+    // A parser can be folded if it does not remove headers, and if its headers neither depend on
+    // the request (formatted values) nor on headers that earlier parsers may have changed
+    // (conditional actions).
+    bool foldable = !plan->passes_.empty() && parser->headers_to_remove_.empty();
+    for (const auto& [key, entry] : parser->headers_to_add_) {
+      if (!foldable) {
+        break;
+      }
+      foldable = entry->constant_ &&
+                 (entry->append_action_ == HeaderValueOption::APPEND_IF_EXISTS_OR_ADD ||
+                  (entry->append_action_ == HeaderValueOption::OVERWRITE_IF_EXISTS_OR_ADD &&
+                   !added_keys.contains(key.get())));
+    }
+
+    if (!foldable) {
+      plan->passes_.push_back({parser, {}});
+      added_keys.clear();
+    }
+    for (const auto& header : parser->headers_to_add_) {
+      if (foldable) {
+        plan->passes_.back().folded_headers_.push_back(&header);
+      }
+      if (isAppendAction(header.second->append_action_)) {
+        added_keys.insert(header.first.get());
+      }
+    }
+  }
+  return plan;
+}
+
+void HeaderMutationPlan::evaluateHeaders(Http::HeaderMap& headers,
+                                         const Formatter::Context& context,
+                                         const StreamInfo::StreamInfo& stream_info) const {
+  for (const Pass& pass : passes_) {
+    pass.parser_->evaluateHeaders(headers, context, &stream_info, pass.folded_headers_);
+  }
+}
+
 } // namespace Router
 } // namespace Envoy
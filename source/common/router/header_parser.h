@@ -12,12 +12,17 @@
 #include "source/common/http/header_map_impl.h"
 #include "source/common/protobuf/protobuf.h"
 
+#include "absl/types/span.h"
+
 namespace Envoy {
 namespace Router {
 
 class HeaderParser;
 using HeaderParserPtr = std::unique_ptr<HeaderParser>;
 
+class HeaderMutationPlan;
+using HeaderMutationPlanConstSharedPtr = std::shared_ptr<const HeaderMutationPlan>;
+
 using HeaderAppendAction = envoy::config::core::v3::HeaderValueOption::HeaderAppendAction;
 using HeaderValueOption = envoy::config::core::v3::HeaderValueOption;
 using HeaderValue = envoy::config::core::v3::HeaderValue;
@@ -47,6 +52,9 @@ struct HeadersToAddEntry {
   HeaderAppendAction append_action_;
   // Keep small members (bools and enums) at the end of class, to reduce alignment overhead.
   bool add_if_empty_ = false;
+  // True if the value contains no substitution commands, in which case it is used as is instead of
+  // being formatted for every request.
+  bool constant_ = false;
 
 protected:
   HeadersToAddEntry(const HeaderValue& header_value, HeaderAppendAction append_action,
@@ -129,12 +137,64 @@ public:
   static std::string translateMetadataFormat(const std::string& header_value);
   static std::string translatePerRequestState(const std::string& header_value);
 
+  /**
+   * @return true if the parser neither adds nor removes any header.
+   */
+  bool empty() const { return headers_to_add_.empty() && headers_to_remove_.empty(); }
+
 protected:
   HeaderParser() = default;
 
 private:
-  std::vector<std::pair<Http::LowerCaseString, std::unique_ptr<HeadersToAddEntry>>> headers_to_add_;
+  friend class HeaderMutationPlan;
+
+  using HeaderToAdd = std::pair<Http::LowerCaseString, std::unique_ptr<HeadersToAddEntry>>;
+
+  // Evaluates the headers of this parser followed by the given constant headers of other parsers,
+  // in a single pass over the header map.
+  void evaluateHeaders(Http::HeaderMap& headers, const Formatter::Context& context,
+                       const StreamInfo::StreamInfo* stream_info,
+                       absl::Span<const HeaderToAdd* const> folded_headers) const;
+  void addHeaderToAdd(Http::LowerCaseString&& key, std::unique_ptr<HeadersToAddEntry>&& entry);
+
+  std::vector<HeaderToAdd> headers_to_add_;
   std::vector<Http::LowerCaseString> headers_to_remove_;
+  // Number of headers whose value must be formatted for every request.
+  uint32_t formatted_headers_{};
+};
+
+/**
+ * A HeaderMutationPlan applies the header mutations of a sequence of HeaderParsers, e.g. those of
+ * the route configuration, the virtual host and the route, with the same result as evaluating the
+ * parsers one after the other. Parsers without mutations are dropped when the plan is compiled.
+ * The headers of a parser that only appends or overwrites constant values are folded into the pass
+ * of the preceding parser when that cannot change the result, so that typical configurations apply
+ * all levels in a single pass over the header map.
+ */
+class HeaderMutationPlan {
+public:
+  /**
+   * @param parsers supplies the parsers in evaluation order. They must outlive the plan.
+   * @return the compiled plan.
+   */
+  static HeaderMutationPlanConstSharedPtr compile(absl::Span<const HeaderParser* const> parsers);
+
+  void evaluateHeaders(Http::HeaderMap& headers, const Formatter::Context& context,
+                       const StreamInfo::StreamInfo& stream_info) const;
+
+  /**
+   * @return the number of passes over the header map made by evaluateHeaders().
+   */
+  uint32_t passes() const { return passes_.size(); }
+
+private:
+  struct Pass {
+    const HeaderParser* parser_;
+    // Constant headers of later parsers, in evaluation order.
+    std::vector<const HeaderParser::HeaderToAdd*> folded_headers_;
+  };
+
+  std::vector<Pass> passes_;
 };
 
 } // namespace Router
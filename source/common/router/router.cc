@@ -1269,6 +1269,7 @@ void Filter::onResponseTimeout() {
         updateOutlierDetection(Upstream::Outlier::Result::LocalOriginTimeout, *upstream_request,
                                absl::optional<uint64_t>(enumToInt(timeout_response_code_)));
       }
+      upstream_request->reportFailureToHost();
 
       chargeUpstreamAbort(timeout_response_code_, false, *upstream_request);
     }
@@ -1340,6 +1341,11 @@ void Filter::onPerTryTimeoutCommon(UpstreamRequest& upstream_request, Stats::Cou
   if (upstream_request.upstreamHost()) {
     upstream_request.upstreamHost()->stats().rq_timeout_.inc();
   }
+  // The per try idle timeout may fire once the response has started, which is then not slow to
+  // arrive.
+  if (upstream_request.awaitingHeaders()) {
+    upstream_request.reportFailureToHost();
+  }
 
   upstream_request.resetStream();
 
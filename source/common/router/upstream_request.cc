@@ -307,6 +307,7 @@ void UpstreamRequest::decodeHeaders(Http::ResponseHeaderMapPtr&& headers, bool e
   }
 
   awaiting_headers_ = false;
+  reportResponseLatencyToHost();
   if (span_ != nullptr) {
     Tracing::HttpTracerUtility::onUpstreamResponseHeaders(*span_, headers.get());
   }
@@ -321,6 +322,46 @@ void UpstreamRequest::decodeHeaders(Http::ResponseHeaderMapPtr&& headers, bool e
   parent_.onUpstreamHeaders(response_code, std::move(headers), *this, end_stream);
 }
 
+void UpstreamRequest::reportResponseLatencyToHost() {
+  if (upstream_host_ == nullptr || upstream_host_->lbPolicyDataCount() == 0) {
+    return;
+  }
+  const StreamInfo::UpstreamTiming& timing = upstreamTiming();
+  if (!timing.first_upstream_tx_byte_sent_.has_value() ||
+      !timing.first_upstream_rx_byte_received_.has_value()) {
+    return;
+  }
+  const auto latency = std::chrono::duration_cast<std::chrono::microseconds>(
+      timing.first_upstream_rx_byte_received_.value() -
+      timing.first_upstream_tx_byte_sent_.value());
+  for (size_t i = 0; i < upstream_host_->lbPolicyDataCount(); ++i) {
+    auto host_lb_policy_data = upstream_host_->lbPolicyDataAt(i);
+    if (host_lb_policy_data.has_value()) {
+      host_lb_policy_data->onUpstreamResponseLatency(
+          latency, timing.first_upstream_rx_byte_received_.value());
+    }
+  }
+}
+
+void UpstreamRequest::reportFailureToHost() {
+  if (upstream_host_ == nullptr || upstream_host_->lbPolicyDataCount() == 0) {
+    return;
+  }
+  const MonotonicTime now = parent_.callbacks()->dispatcher().timeSource().monotonicTime();
+  const StreamInfo::UpstreamTiming& timing = upstreamTiming();
+  std::chrono::microseconds elapsed{0};
+  if (timing.first_upstream_tx_byte_sent_.has_value()) {
+    elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+        now - timing.first_upstream_tx_byte_sent_.value());
+  }
+  for (size_t i = 0; i < upstream_host_->lbPolicyDataCount(); ++i) {
+    auto host_lb_policy_data = upstream_host_->lbPolicyDataAt(i);
+    if (host_lb_policy_data.has_value()) {
+      host_lb_policy_data->onUpstreamRequestFailure(elapsed, now);
+    }
+  }
+}
+
 void UpstreamRequest::maybeHandleDeferredReadDisable() {
   for (; deferred_read_disabling_count_ > 0; --deferred_read_disabling_count_) {
     // If the deferred read disabling count hasn't been cancelled out by read
@@ -485,6 +526,11 @@ void UpstreamRequest::onResetStream(Http::StreamResetReason reason,
     span_->setTag(Tracing::Tags::get().ErrorReason, Http::Utility::resetReasonToString(reason));
   }
   clearRequestEncoder();
+  // A reset before the response is a request which failed without one. Overflow resets come from
+  // the circuit breakers rather than the host.
+  if (awaiting_headers_ && reason != Http::StreamResetReason::Overflow) {
+    reportFailureToHost();
+  }
   awaiting_headers_ = false;
 
   stream_info_.setResponseFlag(Filter::streamResetReasonToResponseFlag(reason));
@@ -125,6 +125,10 @@ public:
 
   void clearRequestEncoder();
   void onStreamMaxDurationReached();
+  // Reports a request which failed without a response to the load balancing policies of the
+  // upstream host: a reset or a timeout before the response headers, but not a soft per try
+  // timeout, which may still be followed by the response.
+  void reportFailureToHost();
 
   // Either disable upstream reading immediately or defer it and keep tracking
   // of how many read disabling has happened.
@@ -178,6 +182,9 @@ private:
   StreamInfo::UpstreamTiming& upstreamTiming() {
     return stream_info_.upstreamInfo()->upstreamTiming();
   }
+  // Reports the time to the first byte of the response to the load balancing policies of the
+  // upstream host.
+  void reportResponseLatencyToHost();
   // Records the latency from when the upstream request was first created to
   // when the pool callback fires. This latency can be useful to track excessive
   // queuing.
@@ -163,11 +163,46 @@ public:
   void reset() override { value_ = 0; }
   uint64_t value() const override { return value_; }
 
-private:
+protected:
   std::atomic<uint64_t> value_{0};
   std::atomic<uint64_t> pending_increment_{0};
 };
 
+// A counter whose value lives in a SharedStatRegion slot, so that it is shared with the other
+// processes attached to the region. The slot also holds the value as of the last latch(), as the
+// process that latches changes when a hot restart parent stops flushing and its child takes over.
+class SharedCounterImpl : public CounterImpl {
+public:
+  SharedCounterImpl(StatName name, Allocator& alloc, StatName tag_extracted_name,
+                    const StatNameTagVector& stat_name_tags, SharedStatRegion::Slot& slot)
+      : CounterImpl(name, alloc, tag_extracted_name, stat_name_tags), slot_(slot) {}
+
+  // Metric
+  bool used() const override { return CounterImpl::used() || value() != 0; }
+
+  // Stats::Counter
+  void add(uint64_t amount) override {
+    slot_.value_ += amount;
+    flags_ |= Flags::Used;
+  }
+  void inc() override { add(1); }
+  uint64_t latch() override {
+    const uint64_t value = slot_.value_;
+    uint64_t latched = slot_.latched_;
+    while (latched < value && !slot_.latched_.compare_exchange_weak(latched, value)) {
+    }
+    return latched < value ? value - latched : 0;
+  }
+  // Resetting only affects the value seen by this process, as the other processes attached to the
+  // region haven't asked for it.
+  void reset() override { reset_value_ = slot_.value_.load(); }
+  uint64_t value() const override { return slot_.value_ - reset_value_; }
+
+private:
+  SharedStatRegion::Slot& slot_;
+  std::atomic<uint64_t> reset_value_{0};
+};
+
 class GaugeImpl : public StatsSharedImpl<Gauge> {
 public:
   GaugeImpl(StatName name, Allocator& alloc, StatName tag_extracted_name,
@@ -264,11 +299,59 @@ public:
 
   void setParentValue(uint64_t value) override { parent_value_ = value; }
 
-private:
+protected:
   std::atomic<uint64_t> parent_value_{0};
   std::atomic<uint64_t> child_value_{0};
 };
 
+// An accumulated gauge whose value lives in a SharedStatRegion slot. The slot holds the
+// contribution of each attached process; each process tracks its own in child_value_ and
+// withdraws it when the gauge is destroyed, e.g. when a hot restart parent exits. The contribution
+// of a process which doesn't withdraw it is dropped by the region when the process's epoch is
+// retired.
+class SharedGaugeImpl : public GaugeImpl {
+public:
+  SharedGaugeImpl(StatName name, Allocator& alloc, StatName tag_extracted_name,
+                  const StatNameTagVector& stat_name_tags, ImportMode import_mode,
+                  SharedStatRegion& region, SharedStatRegion::Slot& slot)
+      : GaugeImpl(name, alloc, tag_extracted_name, stat_name_tags, import_mode), region_(region),
+        slot_(slot), contribution_(region.gaugeContribution(slot)) {}
+
+  ~SharedGaugeImpl() override { contribution_ -= child_value_; }
+
+  // Metric
+  bool used() const override { return GaugeImpl::used() || value() != 0; }
+
+  // Stats::Gauge
+  void add(uint64_t amount) override {
+    child_value_ += amount;
+    contribution_ += amount;
+    flags_ |= Flags::Used;
+  }
+  void dec() override { sub(1); }
+  void inc() override { add(1); }
+  void set(uint64_t value) override {
+    // Unsigned wraparound makes this correct whether the value goes up or down.
+    contribution_ += value - child_value_.exchange(value);
+    flags_ |= Flags::Used;
+  }
+  void sub(uint64_t amount) override {
+    ASSERT(child_value_ >= amount);
+    ASSERT(used() || amount == 0);
+    child_value_ -= amount;
+    contribution_ -= amount;
+  }
+  uint64_t value() const override { return region_.gaugeValue(slot_); }
+
+  // The parent's contribution is already in the slot, so there is nothing to import.
+  void setParentValue(uint64_t) override {}
+
+private:
+  const SharedStatRegion& region_;
+  const SharedStatRegion::Slot& slot_;
+  std::atomic<uint64_t>& contribution_;
+};
+
 class TextReadoutImpl : public StatsSharedImpl<TextReadout> {
 public:
   TextReadoutImpl(StatName name, Allocator& alloc, StatName tag_extracted_name,
@@ -327,8 +410,17 @@ GaugeSharedPtr Allocator::makeGauge(StatName name, StatName tag_extracted_name,
   if (iter != gauges_.end()) {
     return {*iter};
   }
-  auto gauge =
-      GaugeSharedPtr(new GaugeImpl(name, *this, tag_extracted_name, stat_name_tags, import_mode));
+  // Only gauges transferred across hot restarts are shared; the others start at 0 in each process.
+  SharedStatRegion::Slot* slot = nullptr;
+  if (import_mode == Gauge::ImportMode::Accumulate ||
+      import_mode == Gauge::ImportMode::HiddenAccumulate) {
+    slot = sharedSlot(name);
+  }
+  auto gauge = GaugeSharedPtr(
+      slot != nullptr
+          ? new SharedGaugeImpl(name, *this, tag_extracted_name, stat_name_tags, import_mode,
+                                *shared_stat_region_, *slot)
+          : new GaugeImpl(name, *this, tag_extracted_name, stat_name_tags, import_mode));
   gauges_.insert(gauge.get());
   // Add gauge to sinked_gauges_ if it matches the sink predicate.
   if (sink_predicates_ != nullptr && sink_predicates_->includeGauge(*gauge)) {
@@ -368,9 +460,27 @@ bool Allocator::isMutexLockedForTest() {
 
 Counter* Allocator::makeCounterInternal(StatName name, StatName tag_extracted_name,
                                         const StatNameTagVector& stat_name_tags) {
+  SharedStatRegion::Slot* slot = sharedSlot(name);
+  if (slot != nullptr) {
+    return new SharedCounterImpl(name, *this, tag_extracted_name, stat_name_tags, *slot);
+  }
   return new CounterImpl(name, *this, tag_extracted_name, stat_name_tags);
 }
 
+SharedStatRegion::Slot* Allocator::sharedSlot(StatName name) {
+  if (shared_stat_region_ == nullptr) {
+    return nullptr;
+  }
+  SharedStatRegion::Slot* slot = shared_stat_region_->findOrAllocate(symbolTable().toString(name));
+  if (slot == nullptr && !shared_stat_region_full_.exchange(true)) {
+    ENVOY_LOG_MISC(warn,
+                   "shared stat region of capacity {} is full; stats created from now on, "
+                   "starting with {}, will not be transferred across hot restarts",
+                   shared_stat_region_->capacity(), symbolTable().toString(name));
+  }
+  return slot;
+}
+
 void Allocator::forEachCounter(SizeFn f_size, StatFn<Counter> f_stat) const {
   Thread::LockGuard lock(mutex_);
   if (f_size != nullptr) {
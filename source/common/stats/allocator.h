@@ -1,5 +1,6 @@
 #pragma once
 
+#include <atomic>
 #include <vector>
 
 #include "envoy/stats/sink.h"
@@ -8,6 +9,7 @@
 #include "source/common/common/thread.h"
 #include "source/common/common/thread_synchronizer.h"
 #include "source/common/stats/metric_impl.h"
+#include "source/common/stats/shared_stat_region.h"
 
 #include "absl/container/flat_hash_set.h"
 
@@ -80,6 +82,14 @@ public:
    * Set the predicates to filter stats for sink.
    */
   void setSinkPredicates(std::unique_ptr<SinkPredicates>&& sink_predicates);
+
+  /**
+   * Places the values of counters and accumulated gauges created from now on in a region shared
+   * with other processes, e.g. a hot restart parent, so that they share the values rather than
+   * having them merged. Stats that don't fit in the region are held in process memory.
+   * @param region the region, which must outlive the stats created from it.
+   */
+  void setSharedStatRegion(SharedStatRegion* region) { shared_stat_region_ = region; }
 #ifndef ENVOY_CONFIG_COVERAGE
   void debugPrint();
 #endif
@@ -115,6 +125,9 @@ private:
   friend class GaugeImpl;
   friend class TextReadoutImpl;
 
+  // Returns the shared slot for a stat, or nullptr if it is held in process memory.
+  SharedStatRegion::Slot* sharedSlot(StatName name);
+
   // A mutex is needed here to protect both the stats_ object from both
   // alloc() and free() operations. Although alloc() operations are called under existing locking,
   // free() operations are made from the destructors of the individual stat objects, which are not
@@ -133,6 +146,8 @@ private:
 
   // Predicates used to filter stats to be flushed.
   std::unique_ptr<SinkPredicates> sink_predicates_;
+  SharedStatRegion* shared_stat_region_{};
+  std::atomic<bool> shared_stat_region_full_{};
   SymbolTable& symbol_table_;
 
   Thread::ThreadSynchronizer sync_;
@@ -1,11 +1,13 @@
 #include "source/common/stats/histogram_impl.h"
 
 #include <algorithm>
+#include <limits>
 #include <string>
 
 #include "source/common/common/utility.h"
 #include "source/common/protobuf/utility.h"
 
+#include "absl/numeric/bits.h"
 #include "absl/strings/str_join.h"
 
 namespace Envoy {
@@ -13,7 +15,25 @@ namespace Stats {
 
 namespace {
 const ConstSupportedBuckets default_buckets{};
+
+constexpr std::array<uint64_t, 19> powersOf10() {
+  std::array<uint64_t, 19> powers{};
+  uint64_t power = 1;
+  for (uint64_t& entry : powers) {
+    entry = power;
+    power *= 10;
+  }
+  return powers;
 }
+constexpr std::array<uint64_t, 19> PowersOf10 = powersOf10();
+
+// Number of decimal digits of a non-zero value, using log10(2) ~= 1233 / 4096 to guess from the
+// number of bits.
+uint32_t decimalDigits(uint64_t value) {
+  const uint32_t guess = (absl::bit_width(value) * 1233) >> 12;
+  return guess + 1 - (value < PowersOf10[guess]);
+}
+} // namespace
 
 HistogramStatisticsImpl::HistogramStatisticsImpl()
     : supported_buckets_(default_buckets), computed_quantiles_(supportedQuantiles().size(), 0.0) {}
@@ -141,5 +161,58 @@ const ConstSupportedBuckets& HistogramSettingsImpl::defaultBuckets() {
                           60000, 300000, 600000, 1800000, 3600000});
 }
 
+AtomicLogLinearHistogram::~AtomicLogLinearHistogram() {
+  for (std::atomic<Decade*>& decade : decades_) {
+    delete decade.load(std::memory_order_relaxed);
+  }
+}
+
+void AtomicLogLinearHistogram::recordValue(uint64_t value) {
+  if (value == 0) {
+    zero_count_.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  value = std::min<uint64_t>(value, std::numeric_limits<int64_t>::max());
+  // Same as circllhist's int_scale_to_hist_bucket(): a value with d digits goes to the bucket with
+  // exponent d - 1 and its two leading digits as mantissa, where single digit values are
+  // multiplied by 10.
+  const uint32_t digits = decimalDigits(value);
+  const uint64_t mantissa = digits == 1 ? value * 10 : value / PowersOf10[digits - 2];
+  std::atomic<Decade*>& slot = decades_[digits - 1];
+  Decade* decade = slot.load(std::memory_order_acquire);
+  if (decade == nullptr) {
+    // There is a single writer, so the decade can be published without a compare-and-swap.
+    decade = new Decade{};
+    slot.store(decade, std::memory_order_release);
+  }
+  (*decade)[mantissa - 10].fetch_add(1, std::memory_order_relaxed);
+}
+
+uint64_t AtomicLogLinearHistogram::drainTo(histogram_t* target) {
+  uint64_t drained = 0;
+  if (zero_count_.load(std::memory_order_relaxed) != 0) {
+    const uint64_t count = zero_count_.exchange(0, std::memory_order_relaxed);
+    hist_insert_raw(target, hist_bucket_t{0, 0}, count);
+    drained += count;
+  }
+  // Buckets are visited in increasing order, which keeps insertion into the circllhist cheap.
+  for (uint32_t exp = 0; exp < NumDecades; ++exp) {
+    Decade* decade = decades_[exp].load(std::memory_order_acquire);
+    if (decade == nullptr) {
+      continue;
+    }
+    for (uint32_t i = 0; i < BucketsPerDecade; ++i) {
+      if ((*decade)[i].load(std::memory_order_relaxed) == 0) {
+        continue;
+      }
+      const uint64_t count = (*decade)[i].exchange(0, std::memory_order_relaxed);
+      hist_insert_raw(target,
+                      hist_bucket_t{static_cast<int8_t>(i + 10), static_cast<int8_t>(exp)}, count);
+      drained += count;
+    }
+  }
+  return drained;
+}
+
 } // namespace Stats
 } // namespace Envoy
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <array>
+#include <atomic>
 #include <cstdint>
 #include <string>
 
@@ -78,6 +80,42 @@ private:
   const Histogram::Unit unit_{Histogram::Unit::Unspecified};
 };
 
+/**
+ * Fixed-layout log-linear histogram using the bucketing of circllhist's integer insertion
+ * (hist_insert_intscale with a scale of 0): each value is counted in the bucket of its two most
+ * significant decimal digits. Recording is a relaxed atomic increment of the bucket counter, so a
+ * single writer thread can record while another thread drains the counts into a circllhist
+ * without any locking or handoff. Counters are allocated one decade at a time, the first time a
+ * value of that magnitude is recorded.
+ */
+class AtomicLogLinearHistogram : NonCopyable {
+public:
+  AtomicLogLinearHistogram() = default;
+  ~AtomicLogLinearHistogram();
+
+  /**
+   * Records a value. Must only be called by one thread at a time. Values above INT64_MAX, which
+   * circllhist would record as negative, are clamped to INT64_MAX.
+   */
+  void recordValue(uint64_t value);
+
+  /**
+   * Moves the counts recorded so far into target. May run concurrently with recordValue();
+   * every sample is moved exactly once.
+   * @return the number of samples moved.
+   */
+  uint64_t drainTo(histogram_t* target);
+
+private:
+  // INT64_MAX has 19 decimal digits, and each decade has buckets for mantissas 1.0 to 9.9.
+  static constexpr uint32_t NumDecades = 19;
+  static constexpr uint32_t BucketsPerDecade = 90;
+  using Decade = std::array<std::atomic<uint64_t>, BucketsPerDecade>;
+
+  std::atomic<uint64_t> zero_count_{0};
+  std::array<std::atomic<Decade*>, NumDecades> decades_{};
+};
+
 class HistogramImplHelper : public MetricImpl<Histogram> {
 public:
   HistogramImplHelper(StatName name, StatName tag_extracted_name,
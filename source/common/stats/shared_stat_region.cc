@@ -0,0 +1,144 @@
+#include "source/common/stats/shared_stat_region.h"
+
+#include <cstring>
+
+#include "envoy/common/exception.h"
+
+#include "source/common/common/assert.h"
+#include "source/common/common/fmt.h"
+#include "source/common/common/hash.h"
+#include "source/common/common/macros.h"
+
+namespace Envoy {
+namespace Stats {
+
+namespace {
+
+// The layout of a slot's name_: the offset of the name in the arena plus one, so that no claimed
+// slot reads as empty, and the size of the name in the low bits.
+constexpr uint64_t NameSizeBits = 24;
+constexpr uint64_t NameSizeMask = (uint64_t(1) << NameSizeBits) - 1;
+constexpr uint64_t MaxNameOffset = (uint64_t(1) << (64 - NameSizeBits)) - 2;
+
+uint64_t epochParity(uint32_t epoch) { return epoch % 2; }
+
+} // namespace
+
+struct SharedStatRegion::Header {
+  Memory::SharedRegion::Header region_;
+  uint64_t name_bytes_;
+  std::atomic<uint64_t> slots_used_;
+  std::atomic<uint64_t> name_bytes_used_;
+  // The epoch plus one of the process whose gauge contributions count, for even and odd epochs.
+  std::atomic<uint64_t> live_epochs_[2];
+};
+
+const Memory::SharedRegion& SharedStatRegion::layout() {
+  // "envoystr". Increment the version whenever the layout of the region changes.
+  CONSTRUCT_ON_FIRST_USE(Memory::SharedRegion, "shared stat region", 0x656e766f79737472, 2,
+                         sizeof(Header), sizeof(Slot) + NameBytesPerSlot);
+}
+
+uint64_t SharedStatRegion::bytesRequired(uint64_t capacity) {
+  return layout().bytesRequired(capacity);
+}
+
+std::unique_ptr<SharedStatRegion> SharedStatRegion::create(void* memory, uint64_t capacity,
+                                                           uint32_t epoch) {
+  Header* header = reinterpret_cast<Header*>(memory);
+  layout().create(memory, capacity, [header](uint64_t rounded_capacity) {
+    header->name_bytes_ = rounded_capacity * NameBytesPerSlot;
+  });
+  return std::unique_ptr<SharedStatRegion>(new SharedStatRegion(memory, epoch));
+}
+
+absl::StatusOr<std::unique_ptr<SharedStatRegion>>
+SharedStatRegion::attach(void* memory, uint64_t size, uint32_t epoch) {
+  absl::StatusOr<uint64_t> capacity = layout().attach(memory, size);
+  RETURN_IF_NOT_OK_REF(capacity.status());
+  if (reinterpret_cast<const Header*>(memory)->name_bytes_ != *capacity * NameBytesPerSlot) {
+    return absl::InvalidArgumentError("shared stat region has an incompatible layout");
+  }
+  return std::unique_ptr<SharedStatRegion>(new SharedStatRegion(memory, epoch));
+}
+
+SharedStatRegion::SharedStatRegion(void* memory, uint32_t epoch)
+    : header_(reinterpret_cast<Header*>(memory)),
+      slots_(reinterpret_cast<Slot*>(reinterpret_cast<char*>(memory) + sizeof(Header))),
+      names_(reinterpret_cast<char*>(slots_ + header_->region_.capacity_)), epoch_(epoch) {
+  // Any process of the same epoch parity is an ancestor which hot restart has terminated, so its
+  // gauge contributions are replaced by ours.
+  header_->live_epochs_[epochParity(epoch_)].store(uint64_t(epoch_) + 1, std::memory_order_release);
+}
+
+uint64_t SharedStatRegion::capacity() const { return header_->region_.capacity_; }
+
+uint64_t SharedStatRegion::size() const { return header_->slots_used_.load(); }
+
+absl::string_view SharedStatRegion::slotName(uint64_t name) const {
+  return {names_ + (name >> NameSizeBits) - 1, name & NameSizeMask};
+}
+
+SharedStatRegion::Slot* SharedStatRegion::findOrAllocate(absl::string_view name) {
+  if (name.size() > NameSizeMask) {
+    return nullptr;
+  }
+  const uint64_t mask = header_->region_.capacity_ - 1;
+  const uint64_t hash = HashUtil::xxHash64(name);
+  for (uint64_t probe = 0; probe <= mask; ++probe) {
+    Slot& slot = slots_[(hash + probe) & mask];
+    uint64_t slot_name = slot.name_.load(std::memory_order_acquire);
+    if (slot_name == 0) {
+      // Copy the name into the arena before claiming the slot, so that the claim publishes it. The
+      // bytes are lost if another process claims the slot first.
+      const uint64_t offset = header_->name_bytes_used_.fetch_add(name.size());
+      if (offset + name.size() > header_->name_bytes_ || offset > MaxNameOffset) {
+        return nullptr;
+      }
+      memcpy(names_ + offset, name.data(), name.size()); // NOLINT(safe-memcpy)
+      const uint64_t new_name = ((offset + 1) << NameSizeBits) | name.size();
+      if (slot.name_.compare_exchange_strong(slot_name, new_name, std::memory_order_acq_rel)) {
+        ++header_->slots_used_;
+        return &slot;
+      }
+      // Another process claimed the slot first, possibly for the same name.
+    }
+    if (slotName(slot_name) == name) {
+      return &slot;
+    }
+  }
+  return nullptr;
+}
+
+std::atomic<uint64_t>& SharedStatRegion::gaugeContribution(Slot& slot) {
+  const uint64_t parity = epochParity(epoch_);
+  if (slot.gauge_epochs_[parity].load(std::memory_order_acquire) != uint64_t(epoch_) + 1) {
+    slot.gauge_values_[parity].store(0, std::memory_order_relaxed);
+    slot.gauge_epochs_[parity].store(uint64_t(epoch_) + 1, std::memory_order_release);
+  }
+  return slot.gauge_values_[parity];
+}
+
+uint64_t SharedStatRegion::gaugeValue(const Slot& slot) const {
+  uint64_t value = 0;
+  for (uint64_t parity = 0; parity < 2; ++parity) {
+    const uint64_t live_epoch = header_->live_epochs_[parity].load(std::memory_order_acquire);
+    if (live_epoch != 0 &&
+        slot.gauge_epochs_[parity].load(std::memory_order_acquire) == live_epoch) {
+      value += slot.gauge_values_[parity].load(std::memory_order_relaxed);
+    }
+  }
+  return value;
+}
+
+void SharedStatRegion::retireParentEpoch() {
+  if (epoch_ == 0) {
+    return;
+  }
+  // The parent's slot may already be taken by our own child, whose contributions do count.
+  uint64_t parent_epoch = epoch_;
+  header_->live_epochs_[epochParity(epoch_ - 1)].compare_exchange_strong(parent_epoch, 0);
+}
+
+} // namespace Stats
+} // namespace Envoy
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+#include "source/common/memory/shared_region.h"
+
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+
+namespace Envoy {
+namespace Stats {
+
+/**
+ * A fixed-capacity table of stat values keyed by stat name, laid out in a caller-provided block of
+ * memory so that it can be placed in a shared memory segment and used by several processes at
+ * once. Across a hot restart the child attaches to the parent's region, and its counters and
+ * gauges continue from the values the parent left there, instead of being merged from the parent
+ * over RPC.
+ *
+ * Stat names are elaborated strings held in a name arena following the slots, as symbol encodings
+ * are local to a process. Slots are claimed lock-free and are never released, so the region must be
+ * sized for every stat name created over the lifetime of the processes attached to it.
+ *
+ * Each process attaches with its hot restart epoch. Gauges hold one contribution per live epoch,
+ * so that the contribution of a process which exits without withdrawing it, e.g. because it
+ * crashed, stops counting once its epoch is retired or its epoch's successor attaches.
+ */
+class SharedStatRegion {
+public:
+  // The number of bytes of name arena reserved per slot.
+  static constexpr uint64_t NameBytesPerSlot = 128;
+
+  /**
+   * The value of a stat. Counters use value_, and latched_ to track the value as of their last
+   * latch(), so that the child picks up the increments its parent has not flushed to sinks yet.
+   * Gauges use gauge_values_, see gaugeContribution().
+   */
+  struct Slot {
+    // The location of the name in the arena, or 0 while the slot is empty. The slot is claimed and
+    // its name published with a single compare-and-swap, so that a process which dies while adding
+    // a stat never leaves a slot that the others would have to wait on.
+    std::atomic<uint64_t> name_;
+    std::atomic<uint64_t> value_;
+    std::atomic<uint64_t> latched_;
+    // The contributions to a gauge of the processes of even and odd restart epochs, and the epoch
+    // plus one that made each of them.
+    std::atomic<uint64_t> gauge_values_[2];
+    std::atomic<uint64_t> gauge_epochs_[2];
+  };
+
+  /**
+   * @param capacity the number of stats the region can hold, rounded up to a power of two.
+   * @return the number of bytes of memory needed for a region of the given capacity.
+   */
+  static uint64_t bytesRequired(uint64_t capacity);
+
+  /**
+   * Lays out an empty region in the given memory.
+   * @param memory zero-filled memory of bytesRequired(capacity) bytes, aligned to 8 bytes.
+   * @param capacity the number of stats the region can hold, rounded up to a power of two.
+   * @param epoch the hot restart epoch of the calling process.
+   */
+  static std::unique_ptr<SharedStatRegion> create(void* memory, uint64_t capacity, uint32_t epoch);
+
+  /**
+   * Attaches to a region laid out by create(), possibly in another process. The gauge
+   * contributions left by the previous process of the same epoch parity are discarded, as hot
+   * restart runs at most a parent and its child at once.
+   * @param memory the region's memory.
+   * @param size the number of bytes of memory mapped.
+   * @param epoch the hot restart epoch of the calling process.
+   * @return the region, or an error if the memory does not hold a compatible region.
+   */
+  static absl::StatusOr<std::unique_ptr<SharedStatRegion>> attach(void* memory, uint64_t size,
+                                                                  uint32_t epoch);
+
+  /**
+   * Finds the slot for a stat name, claiming a new zero-valued slot if the name is not in the
+   * region yet. Safe to call concurrently from any thread of any attached process.
+   * @param name the elaborated stat name.
+   * @return the slot, or nullptr if the region is full or the name does not fit in it.
+   */
+  Slot* findOrAllocate(absl::string_view name);
+
+  /**
+   * @return the contribution of the calling process to a gauge, reset to zero if it was left by
+   *         an earlier epoch.
+   */
+  std::atomic<uint64_t>& gaugeContribution(Slot& slot);
+
+  /**
+   * @return the value of a gauge, summing the contributions of the live epochs.
+   */
+  uint64_t gaugeValue(const Slot& slot) const;
+
+  /**
+   * Stops counting the gauge contributions of the parent of the calling process. Called when the
+   * parent is terminated, so that its contributions are dropped even if it exits without
+   * withdrawing them.
+   */
+  void retireParentEpoch();
+
+  /**
+   * @return the number of stats the region can hold.
+   */
+  uint64_t capacity() const;
+
+  /**
+   * @return the number of slots in use.
+   */
+  uint64_t size() const;
+
+private:
+  struct Header;
+
+  static const Memory::SharedRegion& layout();
+
+  SharedStatRegion(void* memory, uint32_t epoch);
+
+  absl::string_view slotName(uint64_t name) const;
+
+  Header* header_;
+  Slot* slots_;
+  char* names_;
+  const uint32_t epoch_;
+};
+
+using SharedStatRegionPtr = std::unique_ptr<SharedStatRegion>;
+
+} // namespace Stats
+} // namespace Envoy
@@ -261,11 +261,8 @@ bool StatName::startsWith(StatName prefix) const {
 
 std::vector<absl::string_view> SymbolTable::decodeStrings(StatName stat_name) const {
   std::vector<absl::string_view> strings;
-  Thread::LockGuard lock(lock_);
   Encoding::decodeTokens(
-      stat_name,
-      [this, &strings](Symbol symbol)
-          ABSL_NO_THREAD_SAFETY_ANALYSIS { strings.push_back(fromSymbol(symbol)); },
+      stat_name, [this, &strings](Symbol symbol) { strings.push_back(fromSymbol(symbol)); },
       [&strings](absl::string_view str) { strings.push_back(str); });
   return strings;
 }
@@ -298,6 +295,55 @@ SymbolTable::~SymbolTable() {
   ASSERT(numSymbols() == 0);
 }
 
+SymbolTable::DecodeTable::~DecodeTable() {
+  for (std::atomic<Mid*>& mid_ptr : root_) {
+    Mid* mid = mid_ptr.load(std::memory_order_relaxed);
+    if (mid == nullptr) {
+      continue;
+    }
+    for (std::atomic<Leaf*>& leaf_ptr : *mid) {
+      Leaf* leaf = leaf_ptr.load(std::memory_order_relaxed);
+      if (leaf != nullptr) {
+        for (Slot& slot : *leaf) {
+          delete slot.str_.load(std::memory_order_relaxed);
+        }
+        delete leaf;
+      }
+    }
+    delete mid;
+  }
+}
+
+SymbolTable::DecodeTable::Slot* SymbolTable::DecodeTable::find(Symbol symbol) const {
+  const Mid* mid = root_[symbol >> (MidBits + LeafBits)].load(std::memory_order_acquire);
+  if (mid == nullptr) {
+    return nullptr;
+  }
+  Leaf* leaf = (*mid)[(symbol >> LeafBits) & ((1 << MidBits) - 1)].load(std::memory_order_acquire);
+  if (leaf == nullptr) {
+    return nullptr;
+  }
+  return &(*leaf)[symbol & ((1 << LeafBits) - 1)];
+}
+
+SymbolTable::DecodeTable::Slot& SymbolTable::DecodeTable::getOrCreate(Symbol symbol) {
+  // Chunks are only allocated with the table's lock held exclusively, so there is no competing
+  // writer, but lock-free readers may observe the new chunks as soon as they are published.
+  std::atomic<Mid*>& mid_ptr = root_[symbol >> (MidBits + LeafBits)];
+  Mid* mid = mid_ptr.load(std::memory_order_relaxed);
+  if (mid == nullptr) {
+    mid = new Mid{};
+    mid_ptr.store(mid, std::memory_order_release);
+  }
+  std::atomic<Leaf*>& leaf_ptr = (*mid)[(symbol >> LeafBits) & ((1 << MidBits) - 1)];
+  Leaf* leaf = leaf_ptr.load(std::memory_order_relaxed);
+  if (leaf == nullptr) {
+    leaf = new Leaf{};
+    leaf_ptr.store(leaf, std::memory_order_release);
+  }
+  return (*leaf)[symbol & ((1 << LeafBits) - 1)];
+}
+
 // TODO(ambuc): There is a possible performance optimization here for avoiding
 // the encoding of IPs / numbers if they appear in stat names. We don't want to
 // waste time symbolizing an integer as an integer, if we can help it.
@@ -312,17 +358,36 @@ void SymbolTable::addTokensToEncoding(const absl::string_view name, Encoding& en
   std::vector<Symbol> symbols;
   symbols.reserve(tokens.size());
 
-  // Now take the lock and populate the Symbol objects, which involves bumping
-  // ref-counts in this.
-  {
-    Thread::LockGuard lock(lock_);
+  if (recent_lookups_enabled_.load(std::memory_order_relaxed)) {
+    Thread::LockGuard lock(recent_lookups_lock_);
     recent_lookups_.lookup(name);
-    for (auto& token : tokens) {
+  } else {
+    untracked_lookups_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  // Now populate the Symbol objects, which involves bumping ref-counts in
+  // this. Stat names are almost always composed of tokens that are already in
+  // the table, so we look them up while sharing the lock with other threads,
+  // and only take it exclusively if any token has to be added.
+  size_t num_found = 0;
+  {
+    absl::ReaderMutexLock lock{lock_};
+    for (; num_found < tokens.size(); ++num_found) {
+      Symbol symbol;
+      if (!findSymbol(tokens[num_found], symbol)) {
+        break;
+      }
+      symbols.push_back(symbol);
+    }
+  }
+  if (num_found < tokens.size()) {
+    absl::MutexLock lock{lock_};
+    for (size_t i = num_found; i < tokens.size(); ++i) {
       // TODO(jmarantz): consider using StatNameDynamicStorage for tokens with
       // length below some threshold, say 4 bytes. It might be preferable not to
       // reserve Symbols for every 3 digit number found (for example) in ipv4
       // addresses.
-      symbols.push_back(toSymbol(token));
+      symbols.push_back(toSymbol(tokens[i]));
     }
   }
 
@@ -331,8 +396,7 @@ void SymbolTable::addTokensToEncoding(const absl::string_view name, Encoding& en
 }
 
 uint64_t SymbolTable::numSymbols() const {
-  Thread::LockGuard lock(lock_);
-  ASSERT(encode_map_.size() == decode_map_.size());
+  absl::ReaderMutexLock lock{lock_};
   return encode_map_.size();
 }
 
@@ -341,66 +405,66 @@ std::string SymbolTable::toString(const StatName& stat_name) const {
 }
 
 void SymbolTable::incRefCount(const StatName& stat_name) {
-  // Before taking the lock, decode the array of symbols from the SymbolTable::Storage.
+  // The caller holds a reference to each symbol in stat_name, so none of them
+  // can be erased concurrently, and the counts can be bumped without the lock.
   const SymbolVec symbols = Encoding::decodeSymbols(stat_name);
-
-  Thread::LockGuard lock(lock_);
   for (Symbol symbol : symbols) {
-    auto decode_search = decode_map_.find(symbol);
-
-    ASSERT(decode_search != decode_map_.end(),
-           "Please see "
-           "https://github.com/envoyproxy/envoy/blob/main/source/docs/stats.md#"
-           "debugging-symbol-table-assertions");
-    auto encode_search = encode_map_.find(decode_search->second->toStringView());
-    ASSERT(encode_search != encode_map_.end(),
+    DecodeTable::Slot* slot = decode_table_.find(symbol);
+    ASSERT(slot != nullptr && slot->str_.load(std::memory_order_relaxed) != nullptr,
            "Please see "
            "https://github.com/envoyproxy/envoy/blob/main/source/docs/stats.md#"
            "debugging-symbol-table-assertions");
-
-    ++encode_search->second.ref_count_;
+    slot->ref_count_.fetch_add(1, std::memory_order_relaxed);
   }
 }
 
 void SymbolTable::free(const StatName& stat_name) {
-  // Before taking the lock, decode the array of symbols from the SymbolTable::Storage.
   const SymbolVec symbols = Encoding::decodeSymbols(stat_name);
-
-  Thread::LockGuard lock(lock_);
   for (Symbol symbol : symbols) {
-    auto decode_search = decode_map_.find(symbol);
-    ASSERT(decode_search != decode_map_.end());
-
-    auto encode_search = encode_map_.find(decode_search->second->toStringView());
-    ASSERT(encode_search != encode_map_.end());
+    DecodeTable::Slot* slot = decode_table_.find(symbol);
+    ASSERT(slot != nullptr && slot->str_.load(std::memory_order_relaxed) != nullptr);
 
     // If that was the last remaining client usage of the symbol, erase the
-    // current mappings and add the now-unused symbol to the reuse pool.
-    //
-    // The "if (--EXPR.ref_count_)" pattern speeds up BM_CreateRace by 20% in
-    // symbol_table_speed_test.cc, relative to breaking out the decrement into a
-    // separate step, likely due to the non-trivial dereferences in EXPR.
-    if (--encode_search->second.ref_count_ == 0) {
-      decode_map_.erase(decode_search);
-      encode_map_.erase(encode_search);
-      pool_.push(symbol);
+    // current mappings and add the now-unused symbol to the reuse pool. Another
+    // thread may look the token up again before we get the lock, in which case
+    // eraseIfUnused() leaves it alone.
+    if (slot->ref_count_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      absl::MutexLock lock{lock_};
+      eraseIfUnused(symbol);
     }
   }
 }
 
+void SymbolTable::eraseIfUnused(Symbol symbol) {
+  DecodeTable::Slot* slot = decode_table_.find(symbol);
+  ASSERT(slot != nullptr);
+  const InlineString* str = slot->str_.load(std::memory_order_relaxed);
+  // The symbol may already have been erased, and possibly re-used for a new
+  // token, by a thread that released its last reference after we did.
+  if (str == nullptr || slot->ref_count_.load(std::memory_order_relaxed) != 0) {
+    return;
+  }
+  const size_t erased = encode_map_.erase(str->toStringView());
+  ASSERT(erased == 1);
+  slot->str_.store(nullptr, std::memory_order_relaxed);
+  delete str;
+  pool_.push(symbol);
+}
+
 uint64_t SymbolTable::getRecentLookups(const RecentLookupsFn& iter) const {
   uint64_t total = 0;
   absl::flat_hash_map<std::string, uint64_t> name_count_map;
 
-  // We don't want to hold lock_ while calling the iterator, but we need it to
-  // access recent_lookups_, so we buffer in name_count_map.
+  // We don't want to hold recent_lookups_lock_ while calling the iterator, but
+  // we need it to access recent_lookups_, so we buffer in name_count_map.
   {
-    Thread::LockGuard lock(lock_);
+    Thread::LockGuard lock(recent_lookups_lock_);
     recent_lookups_.forEach(
         [&name_count_map](absl::string_view str, uint64_t count)
             ABSL_NO_THREAD_SAFETY_ANALYSIS { name_count_map[std::string(str)] += count; });
     total += recent_lookups_.total();
   }
+  total += untracked_lookups_.load(std::memory_order_relaxed);
 
   // Now we have the collated name-count map data: we need to vectorize and
   // sort. We define the pair with the count first as std::pair::operator<
@@ -444,17 +508,19 @@ DynamicSpans SymbolTable::getDynamicSpans(StatName stat_name) const {
 }
 
 void SymbolTable::setRecentLookupCapacity(uint64_t capacity) {
-  Thread::LockGuard lock(lock_);
+  Thread::LockGuard lock(recent_lookups_lock_);
   recent_lookups_.setCapacity(capacity);
+  recent_lookups_enabled_.store(capacity > 0, std::memory_order_relaxed);
 }
 
 void SymbolTable::clearRecentLookups() {
-  Thread::LockGuard lock(lock_);
+  Thread::LockGuard lock(recent_lookups_lock_);
   recent_lookups_.clear();
+  untracked_lookups_.store(0, std::memory_order_relaxed);
 }
 
 uint64_t SymbolTable::recentLookupCapacity() const {
-  Thread::LockGuard lock(lock_);
+  Thread::LockGuard lock(recent_lookups_lock_);
   return recent_lookups_.capacity();
 }
 
@@ -464,40 +530,50 @@ StatNameSetPtr SymbolTable::makeSet(absl::string_view name) {
   return stat_name_set;
 }
 
-Symbol SymbolTable::toSymbol(absl::string_view sv) {
-  Symbol result;
+bool SymbolTable::findSymbol(absl::string_view sv, Symbol& symbol) {
   auto encode_find = encode_map_.find(sv);
-  // If the string segment doesn't already exist,
   if (encode_find == encode_map_.end()) {
-    // We create the actual string, place it in the decode_map_, and then insert
-    // a string_view pointing to it in the encode_map_. This allows us to only
-    // store the string once. We use unique_ptr so copies are not made as
-    // flat_hash_map moves values around.
-    InlineStringPtr str = InlineString::create(sv);
-    auto encode_insert = encode_map_.insert({str->toStringView(), SharedSymbol(next_symbol_)});
-    ASSERT(encode_insert.second);
-    auto decode_insert = decode_map_.insert({next_symbol_, std::move(str)});
-    ASSERT(decode_insert.second);
-
-    result = next_symbol_;
-    newSymbol();
-  } else {
-    // If the insertion didn't take place, return the actual value at that location and up the
-    // refcount at that location
-    result = encode_find->second.symbol_;
-    ++(encode_find->second.ref_count_);
+    return false;
   }
+  symbol = encode_find->second;
+  decode_table_.find(symbol)->ref_count_.fetch_add(1, std::memory_order_relaxed);
+  return true;
+}
+
+Symbol SymbolTable::toSymbol(absl::string_view sv) {
+  Symbol result;
+  // The token may have been added by another thread since it was looked up
+  // with the shared lock.
+  if (findSymbol(sv, result)) {
+    return result;
+  }
+
+  // We create the actual string, place it in the decode table, and then insert
+  // a string_view pointing to it in the encode_map_. This allows us to only
+  // store the string once. The reference count is set before the string is
+  // published, as lock-free readers only use slots with a string.
+  const InlineString* str = InlineString::create(sv).release();
+  auto encode_insert = encode_map_.insert({str->toStringView(), next_symbol_});
+  ASSERT(encode_insert.second);
+  DecodeTable::Slot& slot = decode_table_.getOrCreate(next_symbol_);
+  ASSERT(slot.str_.load(std::memory_order_relaxed) == nullptr);
+  slot.ref_count_.store(1, std::memory_order_relaxed);
+  slot.str_.store(str, std::memory_order_release);
+
+  result = next_symbol_;
+  newSymbol();
   return result;
 }
 
-absl::string_view SymbolTable::fromSymbol(const Symbol symbol) const
-    ABSL_EXCLUSIVE_LOCKS_REQUIRED(lock_) {
-  auto search = decode_map_.find(symbol);
-  RELEASE_ASSERT(search != decode_map_.end(), "no such symbol");
-  return search->second->toStringView();
+absl::string_view SymbolTable::fromSymbol(const Symbol symbol) const {
+  const DecodeTable::Slot* slot = decode_table_.find(symbol);
+  const InlineString* str =
+      slot == nullptr ? nullptr : slot->str_.load(std::memory_order_acquire);
+  RELEASE_ASSERT(str != nullptr, "no such symbol");
+  return str->toStringView();
 }
 
-void SymbolTable::newSymbol() ABSL_EXCLUSIVE_LOCKS_REQUIRED(lock_) {
+void SymbolTable::newSymbol() {
   if (pool_.empty()) {
     next_symbol_ = ++monotonic_counter_;
   } else {
@@ -509,15 +585,12 @@ void SymbolTable::newSymbol() ABSL_EXCLUSIVE_LOCKS_REQUIRED(lock_) {
 }
 
 bool SymbolTable::lessThan(const StatName& a, const StatName& b) const {
-  // Proactively take the table lock in anticipation that we'll need to
-  // convert at least one symbol to a string_view, and it's easier not to
-  // bother to lazily take the lock.
-  Thread::LockGuard lock(lock_);
-  return lessThanLockHeld(a, b);
+  // Symbols referenced by a and b are held by the callers, so they can be
+  // converted to strings without taking the table lock.
+  return lessThanNoLock(a, b);
 }
 
-bool SymbolTable::lessThanLockHeld(const StatName& a, const StatName& b) const
-    ABSL_EXCLUSIVE_LOCKS_REQUIRED(lock_) {
+bool SymbolTable::lessThanNoLock(const StatName& a, const StatName& b) const {
   Encoding::TokenIter a_iter(a), b_iter(b);
   while (true) {
     Encoding::TokenIter::TokenType a_type = a_iter.next();
@@ -547,16 +620,16 @@ bool SymbolTable::lessThanLockHeld(const StatName& a, const StatName& b) const
 
 #ifndef ENVOY_CONFIG_COVERAGE
 void SymbolTable::debugPrint() const {
-  Thread::LockGuard lock(lock_);
+  absl::ReaderMutexLock lock{lock_};
   std::vector<Symbol> symbols;
-  for (const auto& p : decode_map_) {
-    symbols.push_back(p.first);
+  for (const auto& p : encode_map_) {
+    symbols.push_back(p.second);
   }
   std::sort(symbols.begin(), symbols.end());
   for (Symbol symbol : symbols) {
-    const InlineString& token = *decode_map_.find(symbol)->second;
-    const SharedSymbol& shared_symbol = encode_map_.find(token.toStringView())->second;
-    ENVOY_LOG_MISC(info, "{}: '{}' ({})", symbol, token.toStringView(), shared_symbol.ref_count_);
+    const DecodeTable::Slot& slot = *decode_table_.find(symbol);
+    ENVOY_LOG_MISC(info, "{}: '{}' ({})", symbol, fromSymbol(symbol),
+                   slot.ref_count_.load(std::memory_order_relaxed));
   }
 }
 #endif
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <algorithm>
+#include <array>
+#include <atomic>
 #include <memory>
 #include <stack>
 #include <string>
@@ -19,6 +21,7 @@
 #include "absl/container/inlined_vector.h"
 #include "absl/strings/str_join.h"
 #include "absl/strings/str_split.h"
+#include "absl/synchronization/mutex.h"
 
 namespace Envoy {
 namespace Stats {
@@ -324,7 +327,9 @@ public:
    */
   DynamicSpans getDynamicSpans(StatName stat_name) const;
 
-  bool lessThanLockHeld(const StatName& a, const StatName& b) const;
+  // Compares two stat names without taking the table lock. The symbols of both names must be
+  // referenced by the caller, as for lessThan().
+  bool lessThanNoLock(const StatName& a, const StatName& b) const;
 
   template <class GetStatName, class Obj> struct StatNameCompare {
     StatNameCompare(const SymbolTable& symbol_table, GetStatName getter)
@@ -338,8 +343,8 @@ public:
 
   /**
    * Sorts a range by StatName. This API is more efficient than
-   * calling std::sort directly as it takes a single lock for the
-   * entire sort, rather than locking on each comparison.
+   * calling std::sort with lessThan() as the comparator, as it extracts
+   * the StatName of each object with the supplied functor.
    *
    * @param begin the beginning of the range to sort
    * @param end the end of the range to sort
@@ -347,9 +352,6 @@ public:
    */
   template <class Obj, class Iter, class GetStatName>
   void sortByStatNames(Iter begin, Iter end, GetStatName get_stat_name) const {
-    // Grab the lock once before sorting begins, so we don't have to re-take
-    // it on every comparison.
-    Thread::LockGuard lock(lock_);
     StatNameCompare<GetStatName, Obj> compare(*this, get_stat_name);
     std::sort(begin, end, compare);
   }
@@ -395,15 +397,46 @@ private:
    */
   void incRefCount(const StatName& stat_name);
 
-  struct SharedSymbol {
-    SharedSymbol(Symbol symbol) : symbol_(symbol) {}
+  /**
+   * Maps symbols to their strings and reference counts. Symbols are small integers that are
+   * recycled when freed, so the table is a three-level array of fixed-size chunks indexed by
+   * symbol. Chunks are allocated on first use and only freed with the table, which makes lookups
+   * wait-free: a symbol that a caller holds a reference to can neither be erased nor moved.
+   * Setting or clearing a symbol's string requires lock_ to be held exclusively.
+   */
+  class DecodeTable {
+  public:
+    struct Slot {
+      // Owned by the slot; null if the symbol is not in use.
+      std::atomic<const InlineString*> str_;
+      std::atomic<uint32_t> ref_count_;
+    };
+
+    ~DecodeTable();
+
+    /**
+     * @return the slot of the symbol, or nullptr if no chunk was ever allocated for it.
+     */
+    Slot* find(Symbol symbol) const;
+
+    /**
+     * @return the slot of the symbol, allocating its chunk if needed.
+     */
+    Slot& getOrCreate(Symbol symbol);
 
-    Symbol symbol_;
-    uint32_t ref_count_{1};
+  private:
+    static constexpr uint32_t LeafBits = 12;
+    static constexpr uint32_t MidBits = 10;
+    static constexpr uint32_t RootBits = 32 - LeafBits - MidBits;
+    using Leaf = std::array<Slot, 1 << LeafBits>;
+    using Mid = std::array<std::atomic<Leaf*>, 1 << MidBits>;
+
+    std::array<std::atomic<Mid*>, 1 << RootBits> root_{};
   };
 
-  // This must be held during both encode() and free().
-  mutable Thread::MutexBasicLockable lock_;
+  // Held exclusively to add or erase symbols, and shared to look up the symbols of existing
+  // tokens. Decoding and reference counting of symbols held by the caller do not need it.
+  mutable absl::Mutex lock_;
 
   /**
    * Decodes a uint8_t array into an array of period-delimited strings. Note
@@ -420,6 +453,15 @@ private:
    */
   std::vector<absl::string_view> decodeStrings(StatName stat_name) const;
 
+  /**
+   * Looks up the symbol of an existing token and bumps its reference count.
+   *
+   * @param sv the individual string to be looked up.
+   * @param symbol receives the symbol if found.
+   * @return true if the token was found.
+   */
+  bool findSymbol(absl::string_view sv, Symbol& symbol) ABSL_SHARED_LOCKS_REQUIRED(lock_);
+
   /**
    * Convenience function for encode(), symbolizing one string segment at a time.
    *
@@ -429,17 +471,24 @@ private:
   Symbol toSymbol(absl::string_view sv) ABSL_EXCLUSIVE_LOCKS_REQUIRED(lock_);
 
   /**
-   * Convenience function for decode(), decoding one symbol at a time.
+   * Convenience function for decode(), decoding one symbol at a time. The caller
+   * must hold a reference to the symbol.
    *
    * @param symbol the individual symbol to be decoded.
    * @return absl::string_view the decoded string.
    */
-  absl::string_view fromSymbol(Symbol symbol) const ABSL_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+  absl::string_view fromSymbol(Symbol symbol) const;
+
+  /**
+   * Erases a symbol whose reference count dropped to zero, unless it was
+   * looked up again in the meantime.
+   */
+  void eraseIfUnused(Symbol symbol) ABSL_EXCLUSIVE_LOCKS_REQUIRED(lock_);
 
   /**
    * Stages a new symbol for use. To be called after a successful insertion.
    */
-  void newSymbol();
+  void newSymbol() ABSL_EXCLUSIVE_LOCKS_REQUIRED(lock_);
 
   /**
    * Tokenizes name, finds or allocates symbols for each token, and adds them
@@ -451,7 +500,7 @@ private:
   void addTokensToEncoding(absl::string_view name, Encoding& encoding);
 
   Symbol monotonicCounter() {
-    Thread::LockGuard lock(lock_);
+    absl::ReaderMutexLock lock{lock_};
     return monotonic_counter_;
   }
 
@@ -460,21 +509,25 @@ private:
   Symbol next_symbol_ ABSL_GUARDED_BY(lock_);
 
   // If the free pool is exhausted, we monotonically increase this counter.
-  Symbol monotonic_counter_;
+  Symbol monotonic_counter_ ABSL_GUARDED_BY(lock_);
 
-  // Bitmap implementation.
-  // The encode map stores both the symbol and the ref count of that symbol.
-  // Using absl::string_view lets us only store the complete string once, in the decode map.
-  using EncodeMap = absl::flat_hash_map<absl::string_view, SharedSymbol>;
-  using DecodeMap = absl::flat_hash_map<Symbol, InlineStringPtr>;
+  // The encode map stores the symbol of each token. The string is only stored once, in the decode
+  // table, which also holds the reference counts.
+  using EncodeMap = absl::flat_hash_map<absl::string_view, Symbol>;
   EncodeMap encode_map_ ABSL_GUARDED_BY(lock_);
-  DecodeMap decode_map_ ABSL_GUARDED_BY(lock_);
+  DecodeTable decode_table_;
 
   // Free pool of symbols for re-use.
   // TODO(ambuc): There might be an optimization here relating to storing ranges of freed symbols
   // using an Envoy::IntervalSet.
   std::stack<Symbol> pool_ ABSL_GUARDED_BY(lock_);
-  RecentLookups recent_lookups_ ABSL_GUARDED_BY(lock_);
+
+  // Recent lookups are only recorded, under their own lock, while tracking is enabled. Otherwise
+  // lookups are just counted.
+  mutable Thread::MutexBasicLockable recent_lookups_lock_;
+  RecentLookups recent_lookups_ ABSL_GUARDED_BY(recent_lookups_lock_);
+  std::atomic<bool> recent_lookups_enabled_{false};
+  std::atomic<uint64_t> untracked_lookups_{0};
 };
 
 // Base class for holding the backing-storing for a StatName. The two derived
@@ -1065,7 +1118,7 @@ template <class GetStatName, class Obj>
 bool SymbolTable::StatNameCompare<GetStatName, Obj>::operator()(const Obj& a, const Obj& b) const {
   StatName a_stat_name = getter_(a);
   StatName b_stat_name = getter_(b);
-  return symbol_table_.lessThanLockHeld(a_stat_name, b_stat_name);
+  return symbol_table_.lessThanNoLock(a_stat_name, b_stat_name);
 }
 
 using SymbolTablePtr = std::unique_ptr<SymbolTable>;
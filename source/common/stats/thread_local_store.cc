@@ -243,17 +243,12 @@ void ThreadLocalStoreImpl::shutdownThreading() {
 }
 
 void ThreadLocalStoreImpl::mergeHistograms(PostMergeCb merge_complete_cb) {
+  // Thread local histograms are drained with atomic operations while workers keep recording, so
+  // the merge runs directly on the main thread without posting to the workers first.
   if (!shutting_down_) {
     ASSERT(!merge_in_progress_);
     merge_in_progress_ = true;
-    tls_cache_->runOnAllThreads(
-        [](OptRef<TlsCache> tls_cache) {
-          for (const auto& id_hist : tls_cache->tls_histogram_cache_) {
-            const TlsHistogramSharedPtr& tls_hist = id_hist.second;
-            tls_hist->beginMerge();
-          }
-        },
-        [this, merge_complete_cb]() -> void { mergeInternal(merge_complete_cb); });
+    mergeInternal(merge_complete_cb);
   } else {
     // If server is shutting down, just call the callback to allow flush to continue.
     merge_complete_cb();
@@ -263,8 +258,10 @@ void ThreadLocalStoreImpl::mergeHistograms(PostMergeCb merge_complete_cb) {
 void ThreadLocalStoreImpl::mergeInternal(PostMergeCb merge_complete_cb) {
   if (!shutting_down_) {
     forEachHistogram(nullptr, [](ParentHistogram& histogram) { histogram.merge(); });
-    merge_complete_cb();
+    // The merge now completes synchronously, so clear the flag first in case the callback starts
+    // another flush.
     merge_in_progress_ = false;
+    merge_complete_cb();
   }
 }
 
@@ -587,7 +584,7 @@ Counter& ThreadLocalStoreImpl::ScopeImpl::counterFromStatNameWithTags(
   // initialized currently.
   StatRefMap<Counter>* tls_cache = nullptr;
   StatNameHashSet* tls_rejected_stats = nullptr;
-  if (!parent_.shutting_down_ && parent_.tls_cache_) {
+  if (parent_.useTlsCache()) {
     TlsCacheEntry& entry = parent_.tlsCache().insertScope(this->scope_id_);
     tls_cache = &entry.counters_;
     tls_rejected_stats = &entry.rejected_stats_;
@@ -644,7 +641,7 @@ Gauge& ThreadLocalStoreImpl::ScopeImpl::gaugeFromStatNameWithTags(
 
   StatRefMap<Gauge>* tls_cache = nullptr;
   StatNameHashSet* tls_rejected_stats = nullptr;
-  if (!parent_.shutting_down_ && parent_.tls_cache_) {
+  if (parent_.useTlsCache()) {
     TlsCacheEntry& entry = parent_.tlsCache().insertScope(this->scope_id_);
     tls_cache = &entry.gauges_;
     tls_rejected_stats = &entry.rejected_stats_;
@@ -683,7 +680,7 @@ Histogram& ThreadLocalStoreImpl::ScopeImpl::histogramFromStatNameWithTags(
 
   StatNameHashMap<ParentHistogramSharedPtr>* tls_cache = nullptr;
   StatNameHashSet* tls_rejected_stats = nullptr;
-  if (!parent_.shutting_down_ && parent_.tls_cache_) {
+  if (parent_.useTlsCache()) {
     TlsCacheEntry& entry = parent_.tlsCache().insertScope(this->scope_id_);
     tls_cache = &entry.parent_histograms_;
     auto iter = tls_cache->find(final_stat_name);
@@ -768,7 +765,7 @@ TextReadout& ThreadLocalStoreImpl::ScopeImpl::textReadoutFromStatNameWithTags(
   // initialized currently.
   StatRefMap<TextReadout>* tls_cache = nullptr;
   StatNameHashSet* tls_rejected_stats = nullptr;
-  if (!parent_.shutting_down_ && parent_.tls_cache_) {
+  if (parent_.useTlsCache()) {
     TlsCacheEntry& entry = parent_.tlsCache().insertScope(this->scope_id_);
     tls_cache = &entry.text_readouts_;
     tls_rejected_stats = &entry.rejected_stats_;
@@ -835,7 +832,7 @@ Histogram& ThreadLocalStoreImpl::tlsHistogram(ParentHistogramImpl& parent, uint6
 
   TlsHistogramSharedPtr hist_tls_ptr(
       new ThreadLocalHistogramImpl(parent.statName(), parent.unit(), tag_helper.tagExtractedName(),
-                                   tag_helper.statNameTags(), symbolTable(), parent.bins()));
+                                   tag_helper.statNameTags(), symbolTable()));
 
   parent.addTlsHistogram(hist_tls_ptr);
 
@@ -849,32 +846,18 @@ Histogram& ThreadLocalStoreImpl::tlsHistogram(ParentHistogramImpl& parent, uint6
 ThreadLocalHistogramImpl::ThreadLocalHistogramImpl(StatName name, Histogram::Unit unit,
                                                    StatName tag_extracted_name,
                                                    const StatNameTagVector& stat_name_tags,
-                                                   SymbolTable& symbol_table,
-                                                   absl::optional<uint32_t> bins)
+                                                   SymbolTable& symbol_table)
     : HistogramImplHelper(name, tag_extracted_name, stat_name_tags, symbol_table), unit_(unit),
-      used_(false), created_thread_id_(std::this_thread::get_id()), symbol_table_(symbol_table) {
-  histograms_[0] = bins ? hist_alloc_nbins(bins.value()) : hist_alloc();
-  histograms_[1] = bins ? hist_alloc_nbins(bins.value()) : hist_alloc();
-}
+      used_(false), created_thread_id_(std::this_thread::get_id()), symbol_table_(symbol_table) {}
 
-ThreadLocalHistogramImpl::~ThreadLocalHistogramImpl() {
-  MetricImpl::clear(symbol_table_);
-  hist_free(histograms_[0]);
-  hist_free(histograms_[1]);
-}
+ThreadLocalHistogramImpl::~ThreadLocalHistogramImpl() { MetricImpl::clear(symbol_table_); }
 
 void ThreadLocalHistogramImpl::recordValue(uint64_t value) {
   ASSERT(std::this_thread::get_id() == created_thread_id_);
-  hist_insert_intscale(histograms_[current_active_], value, 0, 1);
+  histogram_.recordValue(value);
   used_ = true;
 }
 
-void ThreadLocalHistogramImpl::merge(histogram_t* target) {
-  histogram_t** other_histogram = &histograms_[otherHistogramIndex()];
-  hist_accumulate(target, other_histogram, 1);
-  hist_clear(*other_histogram);
-}
-
 ParentHistogramImpl::ParentHistogramImpl(StatName name, Histogram::Unit unit,
                                          ThreadLocalStoreImpl& thread_local_store,
                                          StatName tag_extracted_name,
@@ -882,8 +865,9 @@ ParentHistogramImpl::ParentHistogramImpl(StatName name, Histogram::Unit unit,
                                          ConstSupportedBuckets& supported_buckets,
                                          absl::optional<uint32_t> bins, uint64_t id)
     : MetricImpl(name, tag_extracted_name, stat_name_tags, thread_local_store.symbolTable()),
-      unit_(unit), bins_(bins), thread_local_store_(thread_local_store),
-      interval_histogram_(hist_alloc()), cumulative_histogram_(hist_alloc()),
+      unit_(unit), thread_local_store_(thread_local_store),
+      interval_histogram_(bins ? hist_alloc_nbins(bins.value()) : hist_alloc()),
+      cumulative_histogram_(bins ? hist_alloc_nbins(bins.value()) : hist_alloc()),
       interval_statistics_(interval_histogram_, unit, supported_buckets),
       cumulative_statistics_(cumulative_histogram_, unit, supported_buckets), id_(id) {}
 
@@ -974,14 +958,22 @@ void ParentHistogramImpl::merge() {
     // then release the lock before we do the actual merge. However it is not a big deal
     // because the tls_histogram merge is not that expensive as it is a single histogram
     // merge and adding TLS histograms is rare.
+    uint64_t sample_count = 0;
     for (const TlsHistogramSharedPtr& tls_histogram : tls_histograms_) {
-      tls_histogram->merge(interval_histogram_);
+      sample_count += tls_histogram->merge(interval_histogram_);
     }
     // Since TLS merge is done, we can release the lock here.
     lock.release();
-    hist_accumulate(cumulative_histogram_, &interval_histogram_, 1);
-    cumulative_statistics_.refresh(cumulative_histogram_);
-    interval_statistics_.refresh(interval_histogram_);
+    // The statistics only change if this interval or the previous one had samples, which is
+    // rarely the case for most histograms of a large deployment.
+    if (sample_count > 0) {
+      hist_accumulate(cumulative_histogram_, &interval_histogram_, 1);
+      cumulative_statistics_.refresh(cumulative_histogram_);
+    }
+    if (sample_count > 0 || interval_sample_count_ > 0) {
+      interval_statistics_.refresh(interval_histogram_);
+    }
+    interval_sample_count_ = sample_count;
     merged_ = true;
   }
 }
@@ -35,21 +35,16 @@ namespace Stats {
 class ThreadLocalHistogramImpl : public HistogramImplHelper {
 public:
   ThreadLocalHistogramImpl(StatName name, Histogram::Unit unit, StatName tag_extracted_name,
-                           const StatNameTagVector& stat_name_tags, SymbolTable& symbol_table,
-                           absl::optional<uint32_t> bins);
+                           const StatNameTagVector& stat_name_tags, SymbolTable& symbol_table);
   ~ThreadLocalHistogramImpl() override;
 
-  void merge(histogram_t* target);
-
   /**
-   * Called in the beginning of merge process. Swaps the histogram used for collection so that we do
-   * not have to lock the histogram in high throughput TLS writes.
+   * Called on the main thread during the merge process. Moves the samples recorded since the
+   * previous merge into target. The owning worker keeps recording concurrently, so no handoff
+   * with the worker is needed.
+   * @return the number of samples moved.
    */
-  void beginMerge() {
-    // This switches the current_active_ between 1 and 0.
-    ASSERT(std::this_thread::get_id() == created_thread_id_);
-    current_active_ = otherHistogramIndex();
-  }
+  uint64_t merge(histogram_t* target) { return histogram_.drainTo(target); }
 
   // Stats::Histogram
   Histogram::Unit unit() const override {
@@ -67,9 +62,7 @@ public:
 
 private:
   const Histogram::Unit unit_;
-  uint64_t otherHistogramIndex() const { return 1 - current_active_; }
-  uint64_t current_active_{0};
-  histogram_t* histograms_[2];
+  AtomicLogLinearHistogram histogram_;
   std::atomic<bool> used_;
   const std::thread::id created_thread_id_;
   SymbolTable& symbol_table_;
@@ -132,7 +125,6 @@ public:
   // Indicates that the ThreadLocalStore is shutting down, so no need to clear its histogram_set_.
   void setShuttingDown(bool shutting_down) { shutting_down_ = shutting_down; }
   bool shuttingDown() const { return shutting_down_; }
-  absl::optional<uint32_t> bins() const { return bins_; }
 
 private:
   bool usedLockHeld() const ABSL_EXCLUSIVE_LOCKS_REQUIRED(merge_lock_);
@@ -140,7 +132,6 @@ private:
   detailedlBucketsHelper(const histogram_t& histogram) const;
 
   const Histogram::Unit unit_;
-  const absl::optional<uint32_t> bins_;
   ThreadLocalStoreImpl& thread_local_store_;
   histogram_t* interval_histogram_;
   histogram_t* cumulative_histogram_;
@@ -149,6 +140,8 @@ private:
   mutable Thread::MutexBasicLockable merge_lock_;
   std::list<TlsHistogramSharedPtr> tls_histograms_ ABSL_GUARDED_BY(merge_lock_);
   bool merged_{false};
+  // Number of samples in the last interval, so that idle histograms skip recomputing statistics.
+  uint64_t interval_sample_count_{0};
   std::atomic<bool> shutting_down_{false};
   std::atomic<uint32_t> ref_count_{0};
   const uint64_t id_; // Index into TlsCache::histogram_cache_.
@@ -559,6 +552,11 @@ private:
                                  StatNameStorageSet& central_rejected_stats,
                                  StatNameHashSet* tls_rejected_stats, const StatsMatcher& matcher);
   TlsCache& tlsCache() { return **tls_cache_; }
+  // Stats may be looked up on threads that are not registered with thread local storage, such as
+  // the threads building TLS contexts at startup. Those use the central cache directly.
+  bool useTlsCache() {
+    return !shutting_down_ && tls_cache_ && tls_cache_->currentThreadRegistered();
+  }
   void addScope(std::shared_ptr<ScopeImpl>& new_scope);
 
   OptRef<SinkPredicates> sink_predicates_;
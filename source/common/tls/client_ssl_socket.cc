@@ -42,7 +42,12 @@ ClientSslSocketFactory::ClientSslSocketFactory(Envoy::Ssl::ClientContextConfigPt
                                                absl::Status& creation_status)
     : manager_(manager), stats_scope_(stats_scope), stats_(generateStats(stats_scope)),
       config_(std::move(config)) {
-  {
+  deferred_ctx_build_ = manager_.deferSslClientContext(
+      stats_scope_, *config_, [this](Envoy::Ssl::ClientContextSharedPtr ssl_ctx) {
+        absl::WriterMutexLock l(ssl_ctx_mu_);
+        ssl_ctx_ = std::move(ssl_ctx);
+      });
+  if (deferred_ctx_build_ == nullptr) {
     absl::WriterMutexLock l(ssl_ctx_mu_);
     auto ctx_or_error = manager_.createSslClientContext(stats_scope_, *config_);
     SET_AND_RETURN_IF_NOT_OK(ctx_or_error.status(), creation_status);
@@ -83,6 +88,8 @@ bool ClientSslSocketFactory::implementsSecureTransport() const { return true; }
 
 absl::Status ClientSslSocketFactory::onAddOrUpdateSecret() {
   ENVOY_LOG(debug, "Secret is updated.");
+  // A context built from the updated secret supersedes one still waiting to be built.
+  deferred_ctx_build_.reset();
   auto ctx_or_error = manager_.createSslClientContext(stats_scope_, *config_);
   RETURN_IF_NOT_OK(ctx_or_error.status());
   {
@@ -1,6 +1,7 @@
 #include "source/common/tls/context_manager_impl.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cstddef>
 #include <functional>
 #include <limits>
@@ -17,6 +18,24 @@ namespace Extensions {
 namespace TransportSockets {
 namespace Tls {
 
+namespace {
+
+// Cancels a deferred build when destroyed, unless it has already run.
+class DeferredBuildHandle : public Common::CallbackHandle {
+public:
+  explicit DeferredBuildHandle(std::weak_ptr<bool> cancelled) : cancelled_(std::move(cancelled)) {}
+  ~DeferredBuildHandle() override {
+    if (auto cancelled = cancelled_.lock(); cancelled != nullptr) {
+      *cancelled = true;
+    }
+  }
+
+private:
+  std::weak_ptr<bool> cancelled_;
+};
+
+} // namespace
+
 ContextManagerImpl::ContextManagerImpl(Server::Configuration::CommonFactoryContext& factory_context)
     : factory_context_(factory_context) {}
 
@@ -56,6 +75,138 @@ ContextManagerImpl::createSslServerContext(Stats::Scope& scope,
   return *context_or_error;
 }
 
+bool ContextManagerImpl::canDeferBuild(const Envoy::Ssl::ContextConfig& config) const {
+  if (deferred_build_concurrency_ == 0 || !config.isReady()) {
+    return false;
+  }
+  // Key log files are opened through the access log manager, and private key method providers,
+  // SSL_CTX callbacks and custom certificate validators may depend on state that is only safe to
+  // use on the main thread, so contexts using any of them are built right away.
+  if (!config.tlsKeyLogPath().empty() || config.sslctxCb() != nullptr) {
+    return false;
+  }
+  for (const Envoy::Ssl::TlsCertificateConfig& tls_certificate : config.tlsCertificates()) {
+    if (tls_certificate.privateKeyMethod() != nullptr) {
+      return false;
+    }
+  }
+  const Envoy::Ssl::CertificateValidationContextConfig* validation_context =
+      config.certificateValidationContext();
+  return validation_context == nullptr || !validation_context->customValidatorConfig().has_value();
+}
+
+Common::CallbackHandlePtr
+ContextManagerImpl::addDeferredBuild(std::function<absl::Status()> build,
+                                     std::function<void()> commit) {
+  auto deferred_build = std::make_shared<DeferredBuild>();
+  deferred_build->build_ = std::move(build);
+  deferred_build->commit_ = std::move(commit);
+  deferred_builds_.push_back(deferred_build);
+  return std::make_unique<DeferredBuildHandle>(
+      std::shared_ptr<bool>(deferred_build, &deferred_build->cancelled_));
+}
+
+Common::CallbackHandlePtr
+ContextManagerImpl::deferSslClientContext(Stats::Scope& scope,
+                                          const Envoy::Ssl::ClientContextConfig& config,
+                                          Ssl::ClientContextReadyCb on_ready) {
+  ASSERT_IS_MAIN_OR_TEST_THREAD();
+  if (!canDeferBuild(config) || config.tlsCertificateSelectorFactory().has_value()) {
+    return nullptr;
+  }
+  auto context = std::make_shared<Envoy::Ssl::ClientContextSharedPtr>();
+  return addDeferredBuild(
+      [this, &scope, &config, context]() {
+        auto context_or_error = ClientContextImpl::create(scope, config, factory_context_);
+        RETURN_IF_NOT_OK(context_or_error.status());
+        *context = std::move(context_or_error.value());
+        return absl::OkStatus();
+      },
+      [this, context, on_ready = std::move(on_ready)]() {
+        contexts_.insert(*context);
+        on_ready(*context);
+      });
+}
+
+Common::CallbackHandlePtr
+ContextManagerImpl::deferSslServerContext(Stats::Scope& scope,
+                                          const Envoy::Ssl::ServerContextConfig& config,
+                                          Ssl::ServerContextReadyCb on_ready) {
+  ASSERT_IS_MAIN_OR_TEST_THREAD();
+  if (!canDeferBuild(config)) {
+    return nullptr;
+  }
+  auto factory = Envoy::Config::Utility::getFactoryByName<ServerContextFactory>(
+      "envoy.ssl.server_context_factory.default");
+  if (!factory) {
+    return nullptr;
+  }
+  auto context = std::make_shared<Envoy::Ssl::ServerContextSharedPtr>();
+  return addDeferredBuild(
+      [this, factory, &scope, &config, context]() {
+        auto context_or_error =
+            factory->createServerContext(scope, config, factory_context_, nullptr);
+        RETURN_IF_NOT_OK(context_or_error.status());
+        *context = std::move(context_or_error.value());
+        return absl::OkStatus();
+      },
+      [this, context, on_ready = std::move(on_ready)]() {
+        contexts_.insert(*context);
+        on_ready(*context);
+      });
+}
+
+void ContextManagerImpl::deferContextBuilds(uint32_t concurrency) {
+  ASSERT_IS_MAIN_OR_TEST_THREAD();
+  deferred_build_concurrency_ = concurrency;
+}
+
+absl::Status ContextManagerImpl::buildDeferredContexts() {
+  ASSERT_IS_MAIN_OR_TEST_THREAD();
+  std::vector<DeferredBuildSharedPtr> builds;
+  builds.reserve(deferred_builds_.size());
+  for (DeferredBuildSharedPtr& build : deferred_builds_) {
+    if (!build->cancelled_) {
+      builds.push_back(std::move(build));
+    }
+  }
+  deferred_builds_.clear();
+  if (builds.empty()) {
+    return absl::OkStatus();
+  }
+
+  // The main thread takes a share of the builds, as it would otherwise sit idle.
+  std::vector<absl::Status> statuses(builds.size());
+  std::atomic<size_t> next_build{0};
+  auto run_builds = [&builds, &statuses, &next_build]() {
+    for (size_t i = next_build++; i < builds.size(); i = next_build++) {
+      statuses[i] = builds[i]->build_();
+    }
+  };
+  const size_t num_threads =
+      std::min<size_t>(std::max<uint32_t>(deferred_build_concurrency_, 1), builds.size()) - 1;
+  std::vector<Thread::ThreadPtr> threads;
+  threads.reserve(num_threads);
+  for (size_t i = 0; i < num_threads; ++i) {
+    threads.push_back(factory_context_.api().threadFactory().createThread(
+        run_builds, Thread::Options{"ssl_ctx_build"}));
+  }
+  run_builds();
+  for (Thread::ThreadPtr& thread : threads) {
+    thread->join();
+  }
+  ENVOY_LOG(debug, "built {} deferred ssl contexts on {} threads", builds.size(),
+            num_threads + 1);
+
+  for (const absl::Status& status : statuses) {
+    RETURN_IF_NOT_OK(status);
+  }
+  for (DeferredBuildSharedPtr& build : builds) {
+    build->commit_();
+  }
+  return absl::OkStatus();
+}
+
 absl::optional<uint32_t> ContextManagerImpl::daysUntilFirstCertExpires() const {
   absl::optional<uint32_t> ret = absl::make_optional(std::numeric_limits<uint32_t>::max());
   for (const auto& context : contexts_) {
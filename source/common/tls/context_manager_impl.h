@@ -3,6 +3,8 @@
 #include <cstdint>
 #include <functional>
 #include <list>
+#include <memory>
+#include <vector>
 
 #include "envoy/common/time.h"
 #include "envoy/server/factory_context.h"
@@ -10,6 +12,7 @@
 #include "envoy/ssl/private_key/private_key.h"
 #include "envoy/stats/scope.h"
 
+#include "source/common/common/logger.h"
 #include "source/common/tls/private_key/private_key_manager_impl.h"
 
 namespace Envoy {
@@ -22,8 +25,14 @@ namespace Tls {
  * Contexts can be allocated the main thread. They can be released from any thread (and in practice
  * are since cluster information can be released from any thread). Context allocation/free is a very
  * uncommon thing so we just do a global lock to protect it all.
+ *
+ * At startup, the builds of contexts that depend only on their config may be deferred and run on
+ * a set of short lived threads by buildDeferredContexts(), which blocks the main thread until they
+ * are done. The built contexts are only added to the manager, and handed to their socket factories,
+ * on the main thread.
  */
-class ContextManagerImpl final : public Envoy::Ssl::ContextManager {
+class ContextManagerImpl final : public Envoy::Ssl::ContextManager,
+                                 Logger::Loggable<Logger::Id::config> {
 public:
   explicit ContextManagerImpl(Server::Configuration::CommonFactoryContext& factory_context);
   ~ContextManagerImpl() override = default;
@@ -35,6 +44,14 @@ public:
   absl::StatusOr<Ssl::ServerContextSharedPtr>
   createSslServerContext(Stats::Scope& scope, const Envoy::Ssl::ServerContextConfig& config,
                          Ssl::ContextAdditionalInitFunc additional_init) override;
+  Common::CallbackHandlePtr deferSslClientContext(Stats::Scope& scope,
+                                                  const Envoy::Ssl::ClientContextConfig& config,
+                                                  Ssl::ClientContextReadyCb on_ready) override;
+  Common::CallbackHandlePtr deferSslServerContext(Stats::Scope& scope,
+                                                  const Envoy::Ssl::ServerContextConfig& config,
+                                                  Ssl::ServerContextReadyCb on_ready) override;
+  void deferContextBuilds(uint32_t concurrency) override;
+  absl::Status buildDeferredContexts() override;
   absl::optional<uint32_t> daysUntilFirstCertExpires() const override;
   absl::optional<uint64_t> secondsUntilFirstOcspResponseExpires() const override;
   void iterateContexts(std::function<void(const Envoy::Ssl::Context&)> callback) override;
@@ -44,8 +61,24 @@ public:
   void removeContext(const Envoy::Ssl::ContextSharedPtr& old_context) override;
 
 private:
+  struct DeferredBuild {
+    // Builds the context. Runs on a build thread.
+    std::function<absl::Status()> build_;
+    // Adds the built context to the manager and hands it to its socket factory. Runs on the main
+    // thread.
+    std::function<void()> commit_;
+    bool cancelled_{};
+  };
+  using DeferredBuildSharedPtr = std::shared_ptr<DeferredBuild>;
+
+  bool canDeferBuild(const Envoy::Ssl::ContextConfig& config) const;
+  Common::CallbackHandlePtr addDeferredBuild(std::function<absl::Status()> build,
+                                             std::function<void()> commit);
+
   Server::Configuration::CommonFactoryContext& factory_context_;
   absl::flat_hash_set<Envoy::Ssl::ContextSharedPtr> contexts_;
+  uint32_t deferred_build_concurrency_{};
+  std::vector<DeferredBuildSharedPtr> deferred_builds_;
   PrivateKeyMethodManagerImpl private_key_method_manager_{};
 };
 
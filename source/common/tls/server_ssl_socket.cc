@@ -42,10 +42,17 @@ ServerSslSocketFactory::ServerSslSocketFactory(Envoy::Ssl::ServerContextConfigPt
                                                absl::Status& creation_status)
     : manager_(manager), stats_scope_(stats_scope), stats_(generateStats(stats_scope)),
       config_(std::move(config)) {
-  auto ctx_or_error = manager_.createSslServerContext(stats_scope_, *config_, nullptr);
-  SET_AND_RETURN_IF_NOT_OK(ctx_or_error.status(), creation_status);
+  deferred_ctx_build_ = manager_.deferSslServerContext(
+      stats_scope_, *config_, [this](Envoy::Ssl::ServerContextSharedPtr ssl_ctx) {
+        absl::WriterMutexLock l(ssl_ctx_mu_);
+        ssl_ctx_ = std::move(ssl_ctx);
+      });
+  if (deferred_ctx_build_ == nullptr) {
+    auto ctx_or_error = manager_.createSslServerContext(stats_scope_, *config_, nullptr);
+    SET_AND_RETURN_IF_NOT_OK(ctx_or_error.status(), creation_status);
 
-  ssl_ctx_ = *ctx_or_error;
+    ssl_ctx_ = *ctx_or_error;
+  }
   config_->setSecretUpdateCallback([this]() { return onAddOrUpdateSecret(); });
 }
 
@@ -78,6 +85,8 @@ bool ServerSslSocketFactory::implementsSecureTransport() const { return true; }
 
 absl::Status ServerSslSocketFactory::onAddOrUpdateSecret() {
   ENVOY_LOG(debug, "Secret is updated.");
+  // A context built from the updated secret supersedes one still waiting to be built.
+  deferred_ctx_build_.reset();
   auto ctx_or_error = manager_.createSslServerContext(stats_scope_, *config_, nullptr);
   RETURN_IF_NOT_OK(ctx_or_error.status());
   {
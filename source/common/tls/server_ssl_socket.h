@@ -58,6 +58,8 @@ private:
   Envoy::Ssl::ServerContextConfigPtr config_;
   mutable absl::Mutex ssl_ctx_mu_;
   Envoy::Ssl::ServerContextSharedPtr ssl_ctx_ ABSL_GUARDED_BY(ssl_ctx_mu_);
+  // Cancels the deferred build of ssl_ctx_, if any, when the factory is destroyed.
+  Common::CallbackHandlePtr deferred_ctx_build_;
 };
 
 } // namespace Tls
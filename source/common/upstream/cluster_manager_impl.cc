@@ -331,7 +331,7 @@ ClusterManagerImpl::ClusterManagerImpl(const envoy::config::bootstrap::v3::Boots
           std::make_shared<SharedPool::ObjectSharedPool<
               const envoy::config::cluster::v3::Cluster::CommonLbConfig, MessageUtil, MessageUtil>>(
               dispatcher_)),
-      shutdown_(false) {
+      cross_worker_carriers_(context.options().concurrency()), shutdown_(false) {
   if (auto admin = context.admin(); admin.has_value()) {
     config_tracker_entry_ = admin->getConfigTracker().add(
         "clusters", [this](const Matchers::StringMatcher& name_matcher) {
@@ -402,6 +402,8 @@ ClusterManagerImpl::initialize(const envoy::config::bootstrap::v3::Bootstrap& bo
       RETURN_IF_NOT_OK_REF(status_or_cluster.status());
     }
   }
+  // Finish building any TLS contexts deferred by a parallel startup, as ADS may use them.
+  RETURN_IF_NOT_OK(context_.sslContextManager().buildDeferredContexts());
 
   // Now setup ADS if needed, this might rely on a primary cluster.
   RETURN_IF_NOT_OK(xds_manager_.initializeAdsConnections(bootstrap));
@@ -423,6 +425,7 @@ ClusterManagerImpl::initialize(const envoy::config::bootstrap::v3::Bootstrap& bo
       }
     }
   }
+  RETURN_IF_NOT_OK(context_.sslContextManager().buildDeferredContexts());
 
   cm_stats_.cluster_added_.add(bootstrap.static_resources().clusters().size());
   updateClusterCounts();
@@ -1750,8 +1753,13 @@ ClusterManagerImpl::dumpClusterConfigs(const Matchers::StringMatcher& name_match
 ClusterManagerImpl::ThreadLocalClusterManagerImpl::ThreadLocalClusterManagerImpl(
     ClusterManagerImpl& parent, Event::Dispatcher& dispatcher,
     const absl::optional<LocalClusterParams>& local_cluster_params)
-    : parent_(parent), thread_local_dispatcher_(dispatcher), cdm_(dispatcher.name(), *this),
+    : parent_(parent), thread_local_dispatcher_(dispatcher),
+      cross_worker_relay_(std::make_shared<Http::CrossWorkerRelay>(dispatcher)),
+      cdm_(dispatcher.name(), *this),
       local_stats_(generateStats(*parent.stats_.rootScope(), dispatcher.name())) {
+  if (!Thread::MainThread::isMainOrTestThread()) {
+    carries_for_other_workers_ = parent_.cross_worker_carriers_.add(cross_worker_relay_);
+  }
   // If local cluster is defined then we need to initialize it first.
   if (local_cluster_params.has_value()) {
     const auto& local_cluster_name = local_cluster_params->info_->name();
@@ -1770,6 +1778,8 @@ ClusterManagerImpl::ThreadLocalClusterManagerImpl::~ThreadLocalClusterManagerImp
   // member update callback registered with the local cluster.
   ENVOY_LOG(debug, "shutting down thread local cluster manager");
   destroying_ = true;
+  // Reset the streams carried for other workers while the pools they are on still exist.
+  cross_worker_relay_->shutdown();
   host_http_conn_pool_map_.clear();
   host_tcp_conn_pool_map_.clear();
   ASSERT(host_tcp_conn_map_.empty());
@@ -2006,18 +2016,48 @@ ClusterManagerImpl::ThreadLocalClusterManagerImpl::ClusterEntry::httpConnPoolImp
     context->downstreamConnection()->hashKey(hash_key);
   }
 
+  const bool share_across_workers = shareConnectionPoolsAcrossWorkers(
+      upstream_protocols, *upstream_options, have_transport_socket_options, context);
+  if (cluster_info_->shareConnectionPoolsAcrossWorkers() && !share_across_workers) {
+    // Keep the streams which can't be carried by another worker off the shared pools. The hash key
+    // of a shared pool is the protocol alone, so this one can't collide with it.
+    hash_key.push_back(0xff);
+  }
+
   ConnPoolsContainer& container = *parent_.getHttpConnPoolsContainer(host, true);
 
   // Note: to simplify this, we assume that the factory is only called in the scope of this
   // function. Otherwise, we'd need to capture a few of these variables by value.
   ConnPoolsContainer::ConnPools::PoolOptRef pool =
-      container.pools_->getPool(priority, hash_key, [&]() {
-        auto pool = parent_.parent_.factory_.allocateConnPool(
-            parent_.thread_local_dispatcher_, host, priority, upstream_protocols,
-            alternate_protocol_options, !upstream_options->empty() ? upstream_options : nullptr,
-            have_transport_socket_options ? context->upstreamTransportSocketOptions() : nullptr,
-            parent_.parent_.time_source_, parent_.cluster_manager_state_, quic_info_,
-            parent_.getNetworkObserverRegistry());
+      container.pools_->getPool(priority, hash_key, [&]() -> Http::ConnectionPool::InstancePtr {
+        Http::ConnectionPool::InstancePtr pool;
+        Http::CrossWorkerRelaySharedPtr carrier;
+        if (share_across_workers) {
+          carrier = parent_.parent_.cross_worker_carriers_.carrierFor(*host);
+        }
+        if (carrier != nullptr && carrier != parent_.cross_worker_relay_) {
+          // The carrier worker looks up its own pool for the host, with no load balancer context
+          // since sharing is limited to streams which don't need one.
+          pool = std::make_unique<Http::CrossWorkerConnPool>(
+              parent_.cross_worker_relay_, std::move(carrier), host, upstream_protocols[0],
+              [&cluster_manager = parent_.parent_, cluster_name = cluster_info_->name(), host,
+               priority, downstream_protocol]() -> Http::ConnectionPool::Instance* {
+                auto* cluster_entry = static_cast<ClusterEntry*>(
+                    cluster_manager.getThreadLocalCluster(cluster_name));
+                if (cluster_entry == nullptr) {
+                  return nullptr;
+                }
+                return cluster_entry->httpConnPoolImpl(host, priority, downstream_protocol,
+                                                       nullptr);
+              });
+        } else {
+          pool = parent_.parent_.factory_.allocateConnPool(
+              parent_.thread_local_dispatcher_, host, priority, upstream_protocols,
+              alternate_protocol_options, !upstream_options->empty() ? upstream_options : nullptr,
+              have_transport_socket_options ? context->upstreamTransportSocketOptions() : nullptr,
+              parent_.parent_.time_source_, parent_.cluster_manager_state_, quic_info_,
+              parent_.getNetworkObserverRegistry());
+        }
 
         pool->addIdleCallback([&parent = parent_, host, priority, hash_key]() {
           parent.httpConnPoolIsIdle(host, priority, hash_key);
@@ -2033,6 +2073,33 @@ ClusterManagerImpl::ThreadLocalClusterManagerImpl::ClusterEntry::httpConnPoolImp
   }
 }
 
+bool ClusterManagerImpl::ThreadLocalClusterManagerImpl::ClusterEntry::
+    shareConnectionPoolsAcrossWorkers(const std::vector<Http::Protocol>& upstream_protocols,
+                                      const Network::Socket::Options& upstream_options,
+                                      bool have_transport_socket_options,
+                                      LoadBalancerContext* context) const {
+  // Only workers share pools: the main thread is not a carrier, and its streams are few.
+  if (!cluster_info_->shareConnectionPoolsAcrossWorkers() || !parent_.carries_for_other_workers_) {
+    return false;
+  }
+  // Only pools whose key is the host and protocol alone are shared, since the carrier worker
+  // cannot see the socket or transport socket options of the streams it carries.
+  if (upstream_protocols.size() != 1 ||
+      (upstream_protocols[0] != Http::Protocol::Http2 &&
+       upstream_protocols[0] != Http::Protocol::Http3) ||
+      !upstream_options.empty() || have_transport_socket_options ||
+      cluster_info_->connectionPoolPerDownstreamConnection()) {
+    return false;
+  }
+  // The carrier looks its pool up without a load balancer context, so neither are the streams
+  // whose context could select a host or shape the pool: a hash policy, an override host or
+  // subset metadata.
+  return context == nullptr ||
+         (!context->computeHashKey().has_value() &&
+          !context->overrideHostToSelect().has_value() &&
+          context->metadataMatchCriteria() == nullptr);
+}
+
 void ClusterManagerImpl::ThreadLocalClusterManagerImpl::httpConnPoolIsIdle(
     HostConstSharedPtr host, ResourcePriority priority, const std::vector<uint8_t>& hash_key) {
   if (destroying_) {
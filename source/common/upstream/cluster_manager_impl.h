@@ -32,6 +32,7 @@
 #include "source/common/common/cleanup.h"
 #include "source/common/common/thread.h"
 #include "source/common/http/async_client_impl.h"
+#include "source/common/http/cross_worker_conn_pool.h"
 #include "source/common/http/http_server_properties_cache_impl.h"
 #include "source/common/http/http_server_properties_cache_manager_impl.h"
 #include "source/common/quic/envoy_quic_network_observer_registry_factory.h"
@@ -648,6 +649,10 @@ private:
       httpConnPoolImpl(HostConstSharedPtr host, ResourcePriority priority,
                        absl::optional<Http::Protocol> downstream_protocol,
                        LoadBalancerContext* context);
+      bool shareConnectionPoolsAcrossWorkers(const std::vector<Http::Protocol>& upstream_protocols,
+                                             const Network::Socket::Options& upstream_options,
+                                             bool have_transport_socket_options,
+                                             LoadBalancerContext* context) const;
 
       Tcp::ConnectionPool::Instance* tcpConnPoolImpl(HostConstSharedPtr host,
                                                      ResourcePriority priority,
@@ -746,6 +751,12 @@ private:
 
     ClusterManagerImpl& parent_;
     Event::Dispatcher& thread_local_dispatcher_;
+    // Carries the streams that other workers hand to this one, and receives the events of the
+    // streams this worker hands to others.
+    const Http::CrossWorkerRelaySharedPtr cross_worker_relay_;
+    // Whether the relay is one of the carriers, which is only the case on workers. Only those share
+    // connection pools with each other.
+    bool carries_for_other_workers_{};
     // Known clusters will exclusively exist in either `thread_local_clusters_`
     // or `thread_local_deferred_clusters_`.
     absl::flat_hash_map<std::string, ClusterEntryPtr> thread_local_clusters_;
@@ -970,6 +981,8 @@ private:
   std::shared_ptr<SharedPool::ObjectSharedPool<
       const envoy::config::cluster::v3::Cluster::CommonLbConfig, MessageUtil, MessageUtil>>
       common_lb_config_pool_;
+  // The workers that carry the streams of clusters that share connection pools across workers.
+  Http::CrossWorkerCarriers cross_worker_carriers_;
 
   ClusterSet primary_clusters_;
 
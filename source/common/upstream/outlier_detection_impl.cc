@@ -1,5 +1,6 @@
 #include "source/common/upstream/outlier_detection_impl.h"
 
+#include <array>
 #include <chrono>
 #include <cstdint>
 #include <memory>
@@ -301,7 +302,7 @@ DetectorImpl::DetectorImpl(const Cluster& cluster,
                            Random::RandomGenerator& random)
     : config_(config), dispatcher_(dispatcher), runtime_(runtime), time_source_(time_source),
       stats_(generateStats(cluster.info()->statsScope())),
-      interval_timer_(dispatcher.createTimer([this]() -> void { onIntervalTimer(); })),
+      interval_timer_(dispatcher.createWheelTimer([this]() -> void { onIntervalTimer(); })),
       event_logger_(event_logger), random_generator_(random) {
   // Insert success rate initial numbers for each type of SR detector
   external_origin_sr_num_ = {-1, -1};
@@ -736,9 +737,50 @@ void DetectorImpl::onConsecutiveErrorWorker(HostSharedPtr host,
   }
 }
 
-DetectorImpl::EjectionPair DetectorImpl::successRateEjectionThreshold(
-    double success_rate_sum, const std::vector<HostSuccessRatePair>& valid_success_rate_hosts,
-    double success_rate_stdev_factor) {
+namespace {
+
+// The sums below are kept in independent lanes, so that the compiler can vectorize them without
+// reassociating the floating point additions itself.
+constexpr size_t SumLanes = 4;
+
+double sum(const std::vector<double>& values) {
+  std::array<double, SumLanes> lanes{};
+  const size_t size = values.size();
+  const size_t vectorized = size - size % SumLanes;
+  for (size_t i = 0; i < vectorized; i += SumLanes) {
+    for (size_t lane = 0; lane < SumLanes; ++lane) {
+      lanes[lane] += values[i + lane];
+    }
+  }
+  for (size_t i = vectorized; i < size; ++i) {
+    lanes[i - vectorized] += values[i];
+  }
+  return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+}
+
+double sumOfSquaredDeviations(const std::vector<double>& values, double mean) {
+  std::array<double, SumLanes> lanes{};
+  const size_t size = values.size();
+  const size_t vectorized = size - size % SumLanes;
+  for (size_t i = 0; i < vectorized; i += SumLanes) {
+    for (size_t lane = 0; lane < SumLanes; ++lane) {
+      const double deviation = values[i + lane] - mean;
+      lanes[lane] += deviation * deviation;
+    }
+  }
+  for (size_t i = vectorized; i < size; ++i) {
+    const double deviation = values[i] - mean;
+    lanes[i - vectorized] += deviation * deviation;
+  }
+  return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+}
+
+} // namespace
+
+DetectorImpl::EjectionPair
+DetectorImpl::successRateEjectionThreshold(const std::vector<double>& success_rates,
+                                           double success_rate_stdev_factor) {
+  ASSERT(!success_rates.empty());
   // This function is using mean and standard deviation as statistical measures for outlier
   // detection. First the mean is calculated by dividing the sum of success rate data over the
   // number of data points. Then variance is calculated by taking the mean of the
@@ -754,14 +796,9 @@ DetectorImpl::EjectionPair DetectorImpl::successRateEjectionThreshold(
   // variance = 400
   // stdev = 20
   // threshold returned = 52
-  double mean = success_rate_sum / valid_success_rate_hosts.size();
-  double variance = 0;
-  std::for_each(valid_success_rate_hosts.begin(), valid_success_rate_hosts.end(),
-                [&variance, mean](HostSuccessRatePair v) {
-                  variance += std::pow(v.success_rate_ - mean, 2);
-                });
-  variance /= valid_success_rate_hosts.size();
-  double stdev = std::sqrt(variance);
+  const double mean = sum(success_rates) / success_rates.size();
+  const double variance = sumOfSquaredDeviations(success_rates, mean) / success_rates.size();
+  const double stdev = std::sqrt(variance);
 
   return {mean, (mean - (success_rate_stdev_factor * stdev))};
 }
@@ -777,10 +814,6 @@ void DetectorImpl::processSuccessRateEjections(
   uint64_t failure_percentage_request_volume = runtime_.snapshot().getInteger(
       FailurePercentageRequestVolumeRuntime, config_.failurePercentageRequestVolume());
 
-  std::vector<HostSuccessRatePair> valid_success_rate_hosts;
-  std::vector<HostSuccessRatePair> valid_failure_percentage_hosts;
-  double success_rate_sum = 0;
-
   // Reset the Detector's success rate mean and stdev.
   getSRNums(monitor_type) = {-1, -1};
 
@@ -790,9 +823,11 @@ void DetectorImpl::processSuccessRateEjections(
     return;
   }
 
+  SuccessRateSamples& success_rate_samples = success_rate_samples_;
+  SuccessRateSamples& failure_percentage_samples = failure_percentage_samples_;
   // reserve upper bound of vector size to avoid reallocation.
-  valid_success_rate_hosts.reserve(host_monitors_.size());
-  valid_failure_percentage_hosts.reserve(host_monitors_.size());
+  success_rate_samples.reserve(host_monitors_.size());
+  failure_percentage_samples.reserve(host_monitors_.size());
 
   for (const auto& host : host_monitors_) {
     // Don't do work if the host is already ejected.
@@ -814,44 +849,40 @@ void DetectorImpl::processSuccessRateEjections(
       }
 
       if (request_volume >= success_rate_request_volume) {
-        valid_success_rate_hosts.emplace_back(HostSuccessRatePair(host.first, success_rate));
-        success_rate_sum += success_rate;
+        success_rate_samples.add(host.first, host.second, success_rate);
       }
       if (request_volume >= failure_percentage_request_volume) {
-        valid_failure_percentage_hosts.emplace_back(HostSuccessRatePair(host.first, success_rate));
+        failure_percentage_samples.add(host.first, host.second, success_rate);
       }
     }
   }
 
-  if (!valid_success_rate_hosts.empty() &&
-      valid_success_rate_hosts.size() >= success_rate_minimum_hosts) {
+  if (!success_rate_samples.empty() && success_rate_samples.size() >= success_rate_minimum_hosts) {
     const double success_rate_stdev_factor =
         runtime_.snapshot().getInteger(SuccessRateStdevFactorRuntime,
                                        config_.successRateStdevFactor()) /
         1000.0;
-    getSRNums(monitor_type) = successRateEjectionThreshold(
-        success_rate_sum, valid_success_rate_hosts, success_rate_stdev_factor);
+    getSRNums(monitor_type) = successRateEjectionThreshold(success_rate_samples.success_rates_,
+                                                           success_rate_stdev_factor);
     const double success_rate_ejection_threshold = getSRNums(monitor_type).ejection_threshold_;
-    for (const auto& host_success_rate_pair : valid_success_rate_hosts) {
-      if (host_success_rate_pair.success_rate_ < success_rate_ejection_threshold) {
+    for (size_t i = 0; i < success_rate_samples.size(); ++i) {
+      if (success_rate_samples.success_rates_[i] < success_rate_ejection_threshold) {
         stats_.ejections_success_rate_.inc(); // Deprecated.
         const envoy::data::cluster::v3::OutlierEjectionType type =
-            host_monitors_[host_success_rate_pair.host_]
-                ->getSRMonitor(monitor_type)
-                .getEjectionType();
+            success_rate_samples.monitors_[i]->getSRMonitor(monitor_type).getEjectionType();
         updateDetectedEjectionStats(type);
-        ejectHost(host_success_rate_pair.host_, type);
+        ejectHost(success_rate_samples.hosts_[i], type);
       }
     }
   }
 
-  if (!valid_failure_percentage_hosts.empty() &&
-      valid_failure_percentage_hosts.size() >= failure_percentage_minimum_hosts) {
+  if (!failure_percentage_samples.empty() &&
+      failure_percentage_samples.size() >= failure_percentage_minimum_hosts) {
     const double failure_percentage_threshold = runtime_.snapshot().getInteger(
         FailurePercentageThresholdRuntime, config_.failurePercentageThreshold());
 
-    for (const auto& host_success_rate_pair : valid_failure_percentage_hosts) {
-      if ((100.0 - host_success_rate_pair.success_rate_) >= failure_percentage_threshold) {
+    for (size_t i = 0; i < failure_percentage_samples.size(); ++i) {
+      if ((100.0 - failure_percentage_samples.success_rates_[i]) >= failure_percentage_threshold) {
         // We should eject.
 
         // The ejection type returned by the SuccessRateMonitor's getEjectionType() will be a
@@ -861,10 +892,14 @@ void DetectorImpl::processSuccessRateEjections(
                 ? envoy::data::cluster::v3::FAILURE_PERCENTAGE
                 : envoy::data::cluster::v3::FAILURE_PERCENTAGE_LOCAL_ORIGIN;
         updateDetectedEjectionStats(type);
-        ejectHost(host_success_rate_pair.host_, type);
+        ejectHost(failure_percentage_samples.hosts_[i], type);
       }
     }
   }
+
+  // Don't hold on to the hosts until the next interval.
+  success_rate_samples.clear();
+  failure_percentage_samples.clear();
 }
 
 void DetectorImpl::onIntervalTimer() {
@@ -40,16 +40,6 @@ public:
                    EventLoggerSharedPtr event_logger, Random::RandomGenerator& random);
 };
 
-/**
- * Thin struct to facilitate calculations for success rate outlier detection.
- */
-struct HostSuccessRatePair {
-  HostSuccessRatePair(HostSharedPtr host, double success_rate)
-      : host_(host), success_rate_(success_rate) {}
-  HostSharedPtr host_;
-  double success_rate_;
-};
-
 struct SuccessRateAccumulatorBucket {
   std::atomic<uint64_t> success_request_counter_;
   std::atomic<uint64_t> total_request_counter_;
@@ -115,6 +105,37 @@ private:
 };
 
 class DetectorImpl;
+class DetectorHostMonitorImpl;
+
+/**
+ * The success rates of the hosts taking part in success rate or failure percentage outlier
+ * detection over an interval. The rates are laid out apart from their hosts, so that the statistics
+ * over them run over contiguous doubles.
+ */
+struct SuccessRateSamples {
+  void add(const HostSharedPtr& host, DetectorHostMonitorImpl* monitor, double success_rate) {
+    success_rates_.push_back(success_rate);
+    hosts_.push_back(host);
+    monitors_.push_back(monitor);
+  }
+  // Empties the samples, keeping their memory for the next interval.
+  void clear() {
+    success_rates_.clear();
+    hosts_.clear();
+    monitors_.clear();
+  }
+  void reserve(size_t size) {
+    success_rates_.reserve(size);
+    hosts_.reserve(size);
+    monitors_.reserve(size);
+  }
+  size_t size() const { return success_rates_.size(); }
+  bool empty() const { return success_rates_.empty(); }
+
+  std::vector<double> success_rates_;
+  std::vector<HostSharedPtr> hosts_;
+  std::vector<DetectorHostMonitorImpl*> monitors_;
+};
 
 /**
  * Implementation of DetectorHostMonitor for the generic detector.
@@ -422,19 +443,18 @@ public:
    * This function returns pair of double values for success rate outlier detection. The pair
    * contains the average success rate of all valid hosts in the cluster and the ejection threshold.
    * If a host's success rate is under this threshold, the host is an outlier.
-   * @param success_rate_sum is the sum of the data in the success_rate_data vector.
-   * @param valid_success_rate_hosts is the vector containing the individual success rate data
-   *        points.
+   * @param success_rates is the vector containing the individual success rate data points. It
+   *        must not be empty.
+   * @param success_rate_stdev_factor is the factor of the standard deviation below the average
+   *        at which the threshold is set.
    * @return EjectionPair
    */
   struct EjectionPair {
     double success_rate_average_; // average success rate of all valid hosts in the cluster
     double ejection_threshold_;   // ejection threshold for the cluster
   };
-  static EjectionPair
-  successRateEjectionThreshold(double success_rate_sum,
-                               const std::vector<HostSuccessRatePair>& valid_success_rate_hosts,
-                               double success_rate_stdev_factor);
+  static EjectionPair successRateEjectionThreshold(const std::vector<double>& success_rates,
+                                                   double success_rate_stdev_factor);
 
   const absl::node_hash_map<HostSharedPtr, DetectorHostMonitorImpl*>& getHostMonitors() {
     return host_monitors_;
@@ -503,6 +523,9 @@ private:
   // for external events and local_origin_sr_num_ is used for local origin events.
   EjectionPair external_origin_sr_num_;
   EjectionPair local_origin_sr_num_;
+  // Reused by each interval, so that their memory is only allocated once.
+  SuccessRateSamples success_rate_samples_;
+  SuccessRateSamples failure_percentage_samples_;
 
   const EjectionPair& getSRNums(DetectorHostMonitor::SuccessRateMonitorType monitor_type) const {
     return (DetectorHostMonitor::SuccessRateMonitorType::ExternalOrigin == monitor_type)
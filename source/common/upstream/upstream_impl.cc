@@ -405,6 +405,19 @@ createUpstreamLocalAddressSelector(
   return selector_or_error.value();
 }
 
+absl::optional<AdaptivePreconnectConfig> adaptivePreconnectConfig(
+    const envoy::config::cluster::v3::Cluster::PreconnectPolicy& preconnect_policy) {
+  if (!preconnect_policy.has_adaptive_preconnect()) {
+    return absl::nullopt;
+  }
+  const auto& adaptive_preconnect = preconnect_policy.adaptive_preconnect();
+  return AdaptivePreconnectConfig{
+      std::chrono::milliseconds(
+          PROTOBUF_GET_MS_OR_DEFAULT(adaptive_preconnect, demand_half_life, 1000)),
+      static_cast<float>(
+          PROTOBUF_GET_WRAPPED_OR_DEFAULT(adaptive_preconnect, headroom_ratio, 1.25))};
+}
+
 } // namespace
 
 // Allow disabling ALPN checks for transport sockets. See
@@ -1150,6 +1163,7 @@ ClusterInfoImpl::ClusterInfoImpl(
           config.preconnect_policy(), per_upstream_preconnect_ratio, 1.0)),
       peekahead_ratio_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config.preconnect_policy(),
                                                        predictive_preconnect_ratio, 0)),
+      adaptive_preconnect_(adaptivePreconnectConfig(config.preconnect_policy())),
       socket_matcher_(std::move(socket_matcher)), stats_scope_(std::move(stats_scope)),
       traffic_stats_(generateStats(
           stats_scope_, factory_context.serverFactoryContext().clusterManager().clusterStatNames(),
@@ -1239,6 +1253,7 @@ ClusterInfoImpl::ClusterInfoImpl(
       drain_connections_on_host_removal_(config.ignore_health_on_host_removal()),
       connection_pool_per_downstream_connection_(
           config.connection_pool_per_downstream_connection()),
+      share_connection_pools_across_workers_(config.share_connection_pools_across_workers()),
       warm_hosts_(!config.health_checks().empty() &&
                   common_lb_config_->ignore_new_hosts_until_first_hc()),
       set_local_interface_name_on_upstream_connections_(
@@ -107,12 +107,11 @@ void StrippedMainBase::configureHotRestarter(Random::RandomGenerator& random_gen
 #ifdef ENVOY_HOT_RESTART
   if (!options_.hotRestartDisabled()) {
     uint32_t base_id = options_.baseId();
+    std::unique_ptr<Server::HotRestartImpl> restarter;
 
     if (options_.useDynamicBaseId()) {
       ASSERT(options_.restartEpoch() == 0, "cannot use dynamic base id during hot restart");
 
-      std::unique_ptr<Server::HotRestart> restarter;
-
       // Try 100 times to get an unused base ID and then give up under the assumption
       // that some other problem has occurred to prevent binding the domain socket.
       for (int i = 0; i < 100 && restarter == nullptr; i++) {
@@ -122,7 +121,8 @@ void StrippedMainBase::configureHotRestarter(Random::RandomGenerator& random_gen
         TRY_ASSERT_MAIN_THREAD {
           restarter = std::make_unique<Server::HotRestartImpl>(
               base_id, 0, options_.socketPath(), options_.socketMode(),
-              options_.skipHotRestartOnNoParent(), options_.skipHotRestartParentStats());
+              options_.skipHotRestartOnNoParent(), options_.skipHotRestartParentStats(),
+              options_.hotRestartStatsCapacity());
         }
         END_TRY
         CATCH(Server::HotRestartDomainSocketInUseException & ex, {
@@ -134,14 +134,17 @@ void StrippedMainBase::configureHotRestarter(Random::RandomGenerator& random_gen
       if (restarter == nullptr) {
         throw EnvoyException("unable to select a dynamic base id");
       }
-
-      restarter_.swap(restarter);
     } else {
-      restarter_ = std::make_unique<Server::HotRestartImpl>(
+      restarter = std::make_unique<Server::HotRestartImpl>(
           base_id, options_.restartEpoch(), options_.socketPath(), options_.socketMode(),
-          options_.skipHotRestartOnNoParent(), options_.skipHotRestartParentStats());
+          options_.skipHotRestartOnNoParent(), options_.skipHotRestartParentStats(),
+          options_.hotRestartStatsCapacity());
     }
 
+    // No stats have been created yet, as the stats store is created after the restarter.
+    stats_allocator_.setSharedStatRegion(restarter->sharedStatRegion());
+    restarter_ = std::move(restarter);
+
     // Write the base-id to the requested path whether we selected it
     // dynamically or not.
     if (!options_.baseIdPath().empty()) {
@@ -48,6 +48,7 @@ DnsCacheImpl::DnsCacheImpl(
       refresh_interval_(PROTOBUF_GET_MS_OR_DEFAULT(config, dns_refresh_rate, 60000)),
       min_refresh_interval_(PROTOBUF_GET_MS_OR_DEFAULT(config, dns_min_refresh_rate, 5000)),
       timeout_interval_(PROTOBUF_GET_MS_OR_DEFAULT(config, dns_query_timeout, 5000)),
+      negative_cache_ttl_(PROTOBUF_GET_MS_OR_DEFAULT(config, dns_negative_cache_ttl, 0)),
       file_system_(context.serverFactoryContext().api().fileSystem()),
       validation_visitor_(context.messageValidationVisitor()),
       host_ttl_(PROTOBUF_GET_MS_OR_DEFAULT(config, host_ttl, 300000)),
@@ -125,6 +126,7 @@ DnsCacheImpl::loadDnsCacheEntryWithForceRefresh(absl::string_view raw_host, uint
 
   bool is_overflow = false;
   absl::optional<DnsHostInfoSharedPtr> host_info = absl::nullopt;
+  bool negatively_cached = false;
   bool ignore_cached_entries = force_refresh;
 
   {
@@ -133,11 +135,18 @@ DnsCacheImpl::loadDnsCacheEntryWithForceRefresh(absl::string_view raw_host, uint
     auto tls_host = primary_hosts_.find(host);
     if (tls_host != primary_hosts_.end() && tls_host->second->host_info_->firstResolveComplete()) {
       host_info = tls_host->second->host_info_;
+      negatively_cached = tls_host->second->host_info_->isNegativelyCached();
     }
   }
 
   if (host_info) {
     ENVOY_LOG(debug, "cache hit for host '{}'", host);
+    if (force_refresh && config_.stale_while_revalidate() && (*host_info)->address() != nullptr) {
+      ENVOY_LOG(debug, "serving cached addresses for host '{}' while refreshing it", host);
+      stats_.stale_hit_.inc();
+      main_thread_dispatcher_.post([this, host]() { refreshHost(host); });
+      return {LoadDnsCacheEntryStatus::InCache, nullptr, host_info};
+    }
     if (Runtime::runtimeFeatureEnabled("envoy.reloadable_features.reresolve_null_addresses") &&
         !is_proxy_lookup && *host_info && (*host_info)->address() == nullptr) {
       ENVOY_LOG(debug, "ignoring null address cache hit for miss for host '{}'", host);
@@ -148,6 +157,11 @@ DnsCacheImpl::loadDnsCacheEntryWithForceRefresh(absl::string_view raw_host, uint
       ENVOY_LOG(debug, "ignoring failed address cache hit for miss for host '{}'", host);
       ignore_cached_entries = true;
     }
+    if (ignore_cached_entries && !force_refresh && negatively_cached) {
+      ENVOY_LOG(debug, "negative cache hit for host '{}'", host);
+      stats_.negative_cache_hit_.inc();
+      ignore_cached_entries = false;
+    }
     if (!ignore_cached_entries) {
       return {LoadDnsCacheEntryStatus::InCache, nullptr, host_info};
     }
@@ -157,11 +171,19 @@ DnsCacheImpl::loadDnsCacheEntryWithForceRefresh(absl::string_view raw_host, uint
     stats_.host_overflow_.inc();
     return {LoadDnsCacheEntryStatus::Overflow, nullptr, absl::nullopt};
   }
-  ENVOY_LOG(debug, "cache miss for host '{}', posting to main thread", host);
-  main_thread_dispatcher_.post(
-      [this, host = std::string(host), default_port, is_proxy_lookup, ignore_cached_entries]() {
-        startCacheLoad(host, default_port, is_proxy_lookup, ignore_cached_entries);
-      });
+  if (Runtime::runtimeFeatureEnabled(
+          "envoy.reloadable_features.dfp_coalesce_pending_cache_loads") &&
+      tls_host_info.pending_resolutions_.contains(host)) {
+    // The load already posted for this host by this thread completes this request too.
+    ENVOY_LOG(debug, "cache miss for host '{}', waiting for the pending load", host);
+    stats_.cache_load_coalesced_.inc();
+  } else {
+    ENVOY_LOG(debug, "cache miss for host '{}', posting to main thread", host);
+    main_thread_dispatcher_.post(
+        [this, host = std::string(host), default_port, is_proxy_lookup, ignore_cached_entries]() {
+          startCacheLoad(host, default_port, is_proxy_lookup, ignore_cached_entries);
+        });
+  }
   return {LoadDnsCacheEntryStatus::Loading,
           std::make_unique<LoadDnsCacheEntryHandleImpl>(tls_host_info.pending_resolutions_, host,
                                                         callbacks),
@@ -301,6 +323,25 @@ void DnsCacheImpl::onReResolveAlarm(const std::string& host) {
   }
 }
 
+void DnsCacheImpl::refreshHost(const std::string& host) {
+  ASSERT(main_thread_dispatcher_.isThreadSafe());
+
+  // Functions like this one that modify primary_hosts_ are only called in the main thread so we
+  // know it is safe to use the PrimaryHostInfo pointers outside of the lock.
+  auto* primary_host = [&]() {
+    absl::ReaderMutexLock reader_lock{primary_hosts_lock_};
+    auto host_it = primary_hosts_.find(host);
+    return host_it != primary_hosts_.end() ? host_it->second.get() : nullptr;
+  }();
+  // The host may have been removed since the refresh was posted, or be resolving already.
+  if (primary_host == nullptr || primary_host->active_query_ != nullptr) {
+    ENVOY_LOG(debug, "background refresh for host '{}' skipped", host);
+    return;
+  }
+  primary_host->refresh_timer_->disableTimer();
+  startResolve(host, *primary_host);
+}
+
 void DnsCacheImpl::removeHost(const std::string& host, const PrimaryHostInfo& primary_host,
                               bool update_threads) {
   // If we need to erase the host, hold onto the PrimaryHostInfo object that owns this callback.
@@ -543,6 +584,10 @@ void DnsCacheImpl::finishResolve(const std::string& host,
     // previously resolved address + details.
     primary_host_info->host_info_->setDetails(details_with_maybe_trace);
     primary_host_info->host_info_->setResolutionStatus(status);
+    if (failure && negative_cache_ttl_.count() > 0) {
+      primary_host_info->host_info_->updateNegativeCache(resolution_time.value() +
+                                                         negative_cache_ttl_);
+    }
   }
 
   if (first_resolve) {
@@ -782,6 +827,15 @@ bool DnsCacheImpl::DnsHostInfoImpl::isStale() {
          static_cast<MonotonicTime>(stale_at_time_);
 }
 
+void DnsCacheImpl::DnsHostInfoImpl::updateNegativeCache(MonotonicTime expiry) {
+  negative_cache_expiry_ = expiry;
+}
+
+bool DnsCacheImpl::DnsHostInfoImpl::isNegativelyCached() const {
+  return parent_.main_thread_dispatcher_.timeSource().monotonicTime() <
+         static_cast<MonotonicTime>(negative_cache_expiry_);
+}
+
 void DnsCacheImpl::DnsHostInfoImpl::setAddresses(
     std::vector<Network::Address::InstanceConstSharedPtr>&& list, absl::string_view details,
     Network::DnsResolver::ResolutionStatus resolution_status) {
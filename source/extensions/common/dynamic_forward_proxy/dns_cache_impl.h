@@ -34,6 +34,9 @@ namespace DynamicForwardProxy {
   COUNTER(host_overflow)                                                                           \
   COUNTER(host_removed)                                                                            \
   COUNTER(dns_rq_pending_overflow)                                                                 \
+  COUNTER(cache_load_coalesced)                                                                    \
+  COUNTER(negative_cache_hit)                                                                      \
+  COUNTER(stale_hit)                                                                               \
   GAUGE(num_hosts, NeverImport)
 
 /**
@@ -120,6 +123,8 @@ private:
     void touch() final;
     void updateStale(MonotonicTime resolution_time, std::chrono::seconds ttl);
     bool isStale();
+    void updateNegativeCache(MonotonicTime expiry);
+    bool isNegativelyCached() const;
     void setAddresses(std::vector<Network::Address::InstanceConstSharedPtr>&& list,
                       absl::string_view details,
                       Network::DnsResolver::ResolutionStatus resolution_status);
@@ -146,6 +151,8 @@ private:
     // using MonotonicTime.
     std::atomic<std::chrono::steady_clock::duration> last_used_time_;
     std::atomic<MonotonicTime> stale_at_time_;
+    // Until when a failed resolution is served to requests without re-resolving the host.
+    std::atomic<MonotonicTime> negative_cache_expiry_{};
     bool first_resolve_complete_ ABSL_GUARDED_BY(resolve_lock_){false};
   };
 
@@ -196,6 +203,7 @@ private:
   void runRemoveCallbacks(const std::string& host);
   void notifyThreads(const std::string& host, const DnsHostInfoImplSharedPtr& resolved_info);
   void onReResolveAlarm(const std::string& host);
+  void refreshHost(const std::string& host);
   void removeHost(const std::string& host, const PrimaryHostInfo& host_info, bool update_threads);
   void onResolveTimeout(const std::string& host);
   PrimaryHostInfo& getPrimaryHost(const std::string& host);
@@ -227,6 +235,7 @@ private:
   const std::chrono::milliseconds refresh_interval_;
   const std::chrono::milliseconds min_refresh_interval_;
   const std::chrono::milliseconds timeout_interval_;
+  const std::chrono::milliseconds negative_cache_ttl_;
   Filesystem::Instance& file_system_;
   ProtobufMessage::ValidationVisitor& validation_visitor_;
   const std::chrono::milliseconds host_ttl_;
@@ -22,6 +22,15 @@ Envoy::Compression::Compressor::CompressorPtr BrotliCompressorFactory::createCom
                                                 chunk_size_);
 }
 
+Envoy::Compression::Compressor::CompressorPtr
+BrotliCompressorFactory::createCompressorWithEffort(double effort) {
+  const uint32_t quality = static_cast<uint32_t>(
+      Common::Compressor::scaledCompressionLevel(BROTLI_MIN_QUALITY, quality_, effort));
+  return std::make_unique<BrotliCompressorImpl>(quality, window_bits_, input_block_bits_,
+                                                disable_literal_context_modeling_, encoder_mode_,
+                                                chunk_size_);
+}
+
 BrotliCompressorImpl::EncoderMode BrotliCompressorFactory::encoderModeEnum(
     envoy::extensions::compression::brotli::compressor::v3::Brotli::EncoderMode encoder_mode) {
   switch (encoder_mode) {
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <algorithm>
+
 #include "envoy/compression/compressor/config.h"
 #include "envoy/compression/compressor/factory.h"
 #include "envoy/server/filter_config.h"
@@ -10,6 +12,24 @@ namespace Compression {
 namespace Common {
 namespace Compressor {
 
+/**
+ * Maps a relative compression effort onto the level range of a compression library.
+ * @param fastest_level supplies the level of the library that spends the least CPU.
+ * @param configured_level supplies the level the library was configured with.
+ * @param effort supplies the relative effort in the range [0, 1], where 1 yields the configured
+ *        level and 0 yields the fastest level.
+ * @return the level to use for a compressor.
+ */
+inline int64_t scaledCompressionLevel(int64_t fastest_level, int64_t configured_level,
+                                      double effort) {
+  if (configured_level <= fastest_level) {
+    return configured_level;
+  }
+  const double clamped_effort = std::clamp(effort, 0.0, 1.0);
+  return fastest_level +
+         static_cast<int64_t>((configured_level - fastest_level) * clamped_effort + 0.5);
+}
+
 template <class ConfigProto>
 class CompressorLibraryFactoryBase
     : public Envoy::Compression::Compressor::NamedCompressorLibraryConfigFactory {
@@ -65,6 +65,22 @@ Envoy::Compression::Compressor::CompressorPtr GzipCompressorFactory::createCompr
   return compressor;
 }
 
+Envoy::Compression::Compressor::CompressorPtr
+GzipCompressorFactory::createCompressorWithEffort(double effort) {
+  if (effort >= 1.0) {
+    return createCompressor();
+  }
+  const int64_t configured_level =
+      compression_level_ == ZlibCompressorImpl::CompressionLevel::Standard
+          ? ZlibDefaultLevel
+          : static_cast<int64_t>(compression_level_);
+  const auto level = static_cast<ZlibCompressorImpl::CompressionLevel>(
+      Common::Compressor::scaledCompressionLevel(Z_BEST_SPEED, configured_level, effort));
+  auto compressor = std::make_unique<ZlibCompressorImpl>(chunk_size_);
+  compressor->init(level, compression_strategy_, window_bits_, memory_level_);
+  return compressor;
+}
+
 Envoy::Compression::Compressor::CompressorFactoryPtr
 GzipCompressorLibraryFactory::createCompressorFactoryFromProtoTyped(
     const envoy::extensions::compression::gzip::compressor::v3::Gzip& proto_config,
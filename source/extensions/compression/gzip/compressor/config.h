@@ -27,6 +27,9 @@ const uint64_t GzipHeaderValue = 16;
 // Default zlib chunk size.
 const uint32_t DefaultChunkSize = 4096;
 
+// The level zlib uses for Z_DEFAULT_COMPRESSION.
+const int64_t ZlibDefaultLevel = 6;
+
 namespace {
 
 const std::string& gzipStatsPrefix() { CONSTRUCT_ON_FIRST_USE(std::string, "gzip."); }
@@ -42,6 +45,7 @@ public:
 
   // Envoy::Compression::Compressor::CompressorFactory
   Envoy::Compression::Compressor::CompressorPtr createCompressor() override;
+  Envoy::Compression::Compressor::CompressorPtr createCompressorWithEffort(double effort) override;
   const std::string& statsPrefix() const override { return gzipStatsPrefix(); }
   const std::string& contentEncoding() const override {
     return Http::CustomHeaders::get().ContentEncodingValues.Gzip;
@@ -29,6 +29,18 @@ Envoy::Compression::Compressor::CompressorPtr ZstdCompressorFactory::createCompr
                                               cdict_manager_, chunk_size_);
 }
 
+Envoy::Compression::Compressor::CompressorPtr
+ZstdCompressorFactory::createCompressorWithEffort(double effort) {
+  // The level of a dictionary compressor is fixed when the dictionary is loaded.
+  if (cdict_manager_ != nullptr) {
+    return createCompressor();
+  }
+  const uint32_t level = static_cast<uint32_t>(
+      Common::Compressor::scaledCompressionLevel(1, compression_level_, effort));
+  return std::make_unique<ZstdCompressorImpl>(level, enable_checksum_, strategy_, cdict_manager_,
+                                              chunk_size_);
+}
+
 Envoy::Compression::Compressor::CompressorFactoryPtr
 ZstdCompressorLibraryFactory::createCompressorFactoryFromProtoTyped(
     const envoy::extensions::compression::zstd::compressor::v3::Zstd& proto_config,
@@ -34,10 +34,11 @@ namespace ExtAuthz {
 HeaderKeyMatcher::HeaderKeyMatcher(std::vector<Matchers::StringMatcherPtr>&& list)
     : matchers_(std::move(list)) {}
 
-bool HeaderKeyMatcher::matches(absl::string_view key) const {
-  return std::any_of(matchers_.begin(), matchers_.end(),
-                     [&key](auto& matcher) { return matcher->match(key); });
-}
+HeaderKeyMatcher::HeaderKeyMatcher(const envoy::type::matcher::v3::ListStringMatcher& list,
+                                   Server::Configuration::CommonFactoryContext& context)
+    : matchers_(list.patterns(), context) {}
+
+bool HeaderKeyMatcher::matches(absl::string_view key) const { return matchers_.anyMatch(key); }
 
 NotHeaderKeyMatcher::NotHeaderKeyMatcher(std::vector<Matchers::StringMatcherPtr>&& list)
     : matcher_(std::move(list)) {}
@@ -299,31 +300,20 @@ MatcherSharedPtr
 CheckRequestUtils::toRequestMatchers(const envoy::type::matcher::v3::ListStringMatcher& list,
                                      bool add_http_headers,
                                      Server::Configuration::CommonFactoryContext& context) {
-  std::vector<Matchers::StringMatcherPtr> matchers(createStringMatchers(list, context));
-
-  if (add_http_headers) {
-    const std::vector<Http::LowerCaseString> keys{
-        {Http::CustomHeaders::get().Authorization, Http::Headers::get().Method,
-         Http::Headers::get().Path, Http::Headers::get().Host}};
-
-    for (const auto& key : keys) {
-      envoy::type::matcher::v3::StringMatcher matcher;
-      matcher.set_exact(key.get());
-      matchers.push_back(std::make_unique<Matchers::StringMatcherImpl>(matcher, context));
-    }
+  if (!add_http_headers) {
+    return std::make_shared<HeaderKeyMatcher>(list, context);
   }
 
-  return std::make_shared<HeaderKeyMatcher>(std::move(matchers));
-}
+  envoy::type::matcher::v3::ListStringMatcher matchers(list);
+  const std::vector<Http::LowerCaseString> keys{
+      {Http::CustomHeaders::get().Authorization, Http::Headers::get().Method,
+       Http::Headers::get().Path, Http::Headers::get().Host}};
 
-std::vector<Matchers::StringMatcherPtr>
-CheckRequestUtils::createStringMatchers(const envoy::type::matcher::v3::ListStringMatcher& list,
-                                        Server::Configuration::CommonFactoryContext& context) {
-  std::vector<Matchers::StringMatcherPtr> matchers;
-  for (const auto& matcher : list.patterns()) {
-    matchers.push_back(std::make_unique<Matchers::StringMatcherImpl>(matcher, context));
+  for (const auto& key : keys) {
+    matchers.add_patterns()->set_exact(key.get());
   }
-  return matchers;
+
+  return std::make_shared<HeaderKeyMatcher>(matchers, context);
 }
 
 } // namespace ExtAuthz
@@ -20,6 +20,7 @@
 #include "envoy/upstream/cluster_manager.h"
 
 #include "source/common/common/logger.h"
+#include "source/common/common/matchers.h"
 #include "source/common/http/async_client_impl.h"
 #include "source/common/singleton/const_singleton.h"
 
@@ -50,11 +51,13 @@ public:
 class HeaderKeyMatcher : public Matcher {
 public:
   HeaderKeyMatcher(std::vector<Matchers::StringMatcherPtr>&& list);
+  HeaderKeyMatcher(const envoy::type::matcher::v3::ListStringMatcher& list,
+                   Server::Configuration::CommonFactoryContext& context);
 
   bool matches(absl::string_view key) const override;
 
 private:
-  const std::vector<Matchers::StringMatcherPtr> matchers_;
+  const Matchers::StringMatcherListImpl matchers_;
 };
 
 class NotHeaderKeyMatcher : public Matcher {
@@ -122,9 +125,6 @@ public:
   static MatcherSharedPtr toRequestMatchers(const envoy::type::matcher::v3::ListStringMatcher& list,
                                             bool add_http_headers,
                                             Server::Configuration::CommonFactoryContext& context);
-  static std::vector<Matchers::StringMatcherPtr>
-  createStringMatchers(const envoy::type::matcher::v3::ListStringMatcher& list,
-                       Server::Configuration::CommonFactoryContext& context);
 
 private:
   static void setAttrContextPeer(envoy::service::auth::v3::AttributeContext::Peer& peer,
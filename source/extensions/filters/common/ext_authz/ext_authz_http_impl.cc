@@ -227,28 +227,22 @@ ClientConfig::ClientConfig(
 MatcherSharedPtr
 ClientConfig::toClientMatchersOnSuccess(const envoy::type::matcher::v3::ListStringMatcher& list,
                                         Server::Configuration::CommonFactoryContext& context) {
-  std::vector<Matchers::StringMatcherPtr> matchers(
-      CheckRequestUtils::createStringMatchers(list, context));
-  return std::make_shared<HeaderKeyMatcher>(std::move(matchers));
+  return std::make_shared<HeaderKeyMatcher>(list, context);
 }
 
 MatcherSharedPtr
 ClientConfig::toDynamicMetadataMatchers(const envoy::type::matcher::v3::ListStringMatcher& list,
                                         Server::Configuration::CommonFactoryContext& context) {
-  std::vector<Matchers::StringMatcherPtr> matchers(
-      CheckRequestUtils::createStringMatchers(list, context));
-  return std::make_shared<HeaderKeyMatcher>(std::move(matchers));
+  return std::make_shared<HeaderKeyMatcher>(list, context);
 }
 
 MatcherSharedPtr
 ClientConfig::toClientMatchers(const envoy::type::matcher::v3::ListStringMatcher& list,
                                Server::Configuration::CommonFactoryContext& context) {
-  std::vector<Matchers::StringMatcherPtr> matchers(
-      CheckRequestUtils::createStringMatchers(list, context));
-
   // If list is empty, all authorization response headers, except Host, should be added to
   // the client response.
-  if (matchers.empty()) {
+  if (list.patterns().empty()) {
+    std::vector<Matchers::StringMatcherPtr> matchers;
     envoy::type::matcher::v3::StringMatcher matcher;
     matcher.set_exact(Http::Headers::get().Host.get());
     matchers.push_back(std::make_unique<Matchers::StringMatcherImpl>(matcher, context));
@@ -258,23 +252,22 @@ ClientConfig::toClientMatchers(const envoy::type::matcher::v3::ListStringMatcher
 
   // If not empty, all user defined matchers and default matcher's list will
   // be used instead.
+  envoy::type::matcher::v3::ListStringMatcher matchers(list);
   std::vector<Http::LowerCaseString> keys{
       {Http::Headers::get().Status, Http::Headers::get().ContentLength,
        Http::Headers::get().WWWAuthenticate, Http::Headers::get().Location}};
 
   for (const auto& key : keys) {
-    envoy::type::matcher::v3::StringMatcher matcher;
-    matcher.set_exact(key.get());
-    matchers.push_back(std::make_unique<Matchers::StringMatcherImpl>(matcher, context));
+    matchers.add_patterns()->set_exact(key.get());
   }
 
-  return std::make_shared<HeaderKeyMatcher>(std::move(matchers));
+  return std::make_shared<HeaderKeyMatcher>(matchers, context);
 }
 
 MatcherSharedPtr
 ClientConfig::toUpstreamMatchers(const envoy::type::matcher::v3::ListStringMatcher& list,
                                  Server::Configuration::CommonFactoryContext& context) {
-  return std::make_unique<HeaderKeyMatcher>(CheckRequestUtils::createStringMatchers(list, context));
+  return std::make_unique<HeaderKeyMatcher>(list, context);
 }
 
 RawHttpClientImpl::RawHttpClientImpl(Upstream::ClusterManager& cm, ClientConfigSharedPtr config)
@@ -42,8 +42,43 @@ void LuaLoggable::scriptLog(spdlog::level::level_enum level, absl::string_view m
   }
 }
 
-Coroutine::Coroutine(const std::pair<lua_State*, lua_State*>& new_thread_state)
-    : coroutine_state_(new_thread_state, false) {}
+lua_State* CoroutinePool::acquire() {
+  if (idle_threads_.empty()) {
+    return lua_newthread(state_);
+  }
+
+  const int ref = idle_threads_.back();
+  idle_threads_.pop_back();
+  lua_rawgeti(state_, LUA_REGISTRYINDEX, ref);
+  luaL_unref(state_, LUA_REGISTRYINDEX, ref);
+  return lua_tothread(state_, -1);
+}
+
+void CoroutinePool::release(Coroutine& coroutine) {
+  if (idle_threads_.size() < max_size_ && coroutine.reusable()) {
+    // Drop whatever the previous function left behind (arguments, return values) so the next
+    // coroutine starts from an empty stack, then keep the thread alive via the registry.
+    lua_State* thread = coroutine.luaState();
+    lua_settop(thread, 0);
+    lua_pushthread(thread);
+    lua_xmove(thread, state_, 1);
+    idle_threads_.push_back(luaL_ref(state_, LUA_REGISTRYINDEX));
+  }
+
+  if (gc_step_size_kb_ > 0) {
+    lua_gc(state_, LUA_GCSTEP, gc_step_size_kb_);
+  }
+}
+
+Coroutine::Coroutine(const std::pair<lua_State*, lua_State*>& new_thread_state,
+                     CoroutinePool* pool)
+    : coroutine_state_(new_thread_state, false), pool_(pool) {}
+
+Coroutine::~Coroutine() {
+  if (pool_ != nullptr) {
+    pool_->release(*this);
+  }
+}
 
 void Coroutine::start(int function_ref, int num_args, const std::function<void()>& yield_callback) {
   ASSERT(state_ == State::NotStarted);
@@ -60,8 +95,24 @@ void Coroutine::start(int function_ref, int num_args, const std::function<void()
 
 void Coroutine::resume(int num_args, const std::function<void()>& yield_callback) {
   ASSERT(state_ == State::Yielded);
+  MonotonicTime start_time;
+  uint64_t heap_bytes_before = 0;
+  if (time_source_ != nullptr) {
+    start_time = time_source_->monotonicTime();
+    heap_bytes_before = heapBytesUsed();
+  }
+
   int rc = lua_resume(coroutine_state_.get(), num_args);
 
+  if (time_source_ != nullptr) {
+    execution_time_ += std::chrono::duration_cast<std::chrono::microseconds>(
+        time_source_->monotonicTime() - start_time);
+    const uint64_t heap_bytes_after = heapBytesUsed();
+    if (heap_bytes_after > heap_bytes_before) {
+      heap_growth_bytes_ += heap_bytes_after - heap_bytes_before;
+    }
+  }
+
   if (0 == rc) {
     state_ = State::Finished;
     ENVOY_LOG(debug, "coroutine finished");
@@ -71,6 +122,7 @@ void Coroutine::resume(int num_args, const std::function<void()>& yield_callback
     yield_callback();
   } else {
     state_ = State::Finished;
+    failed_ = true;
     const char* error = lua_tostring(coroutine_state_.get(), -1);
     if (!error) {
       error = "unspecified lua error";
@@ -79,7 +131,14 @@ void Coroutine::resume(int num_args, const std::function<void()>& yield_callback
   }
 }
 
-ThreadLocalState::ThreadLocalState(const std::string& code, ThreadLocal::SlotAllocator& tls)
+uint64_t Coroutine::heapBytesUsed() {
+  lua_State* state = coroutine_state_.get();
+  return static_cast<uint64_t>(lua_gc(state, LUA_GCCOUNT, 0)) * 1024 +
+         lua_gc(state, LUA_GCCOUNTB, 0);
+}
+
+ThreadLocalState::ThreadLocalState(const std::string& code, ThreadLocal::SlotAllocator& tls,
+                                   const ThreadLocalStateOptions& options)
     : tls_slot_(ThreadLocal::TypedSlot<LuaThreadLocal>::makeUnique(tls)) {
 
   // First verify that the supplied code can be parsed.
@@ -92,7 +151,9 @@ ThreadLocalState::ThreadLocalState(const std::string& code, ThreadLocal::SlotAll
   }
 
   // Now initialize on all threads.
-  tls_slot_->set([code](Event::Dispatcher&) { return std::make_shared<LuaThreadLocal>(code); });
+  tls_slot_->set([code, options](Event::Dispatcher&) {
+    return std::make_shared<LuaThreadLocal>(code, options);
+  });
 }
 
 int ThreadLocalState::getGlobalRef(uint64_t slot) {
@@ -121,15 +182,24 @@ uint64_t ThreadLocalState::registerGlobal(const std::string& global,
 }
 
 CoroutinePtr ThreadLocalState::createCoroutine() {
-  lua_State* state = tlsState().get();
-  return std::make_unique<Coroutine>(std::make_pair(lua_newthread(state), state));
+  LuaThreadLocal& tls = **tls_slot_;
+  lua_State* state = tls.state_.get();
+  return std::make_unique<Coroutine>(std::make_pair(tls.coroutine_pool_.acquire(), state),
+                                     &tls.coroutine_pool_);
 }
 
-ThreadLocalState::LuaThreadLocal::LuaThreadLocal(const std::string& code)
-    : state_(luaL_newstate()) {
+ThreadLocalState::LuaThreadLocal::LuaThreadLocal(const std::string& code,
+                                                 const ThreadLocalStateOptions& options)
+    : state_(luaL_newstate()), coroutine_pool_(state_.get(), options) {
 
   RELEASE_ASSERT(state_.get() != nullptr, "unable to create new Lua state object");
   luaL_openlibs(state_.get());
+  if (options.gc_pause > 0) {
+    lua_gc(state_.get(), LUA_GCSETPAUSE, options.gc_pause);
+  }
+  if (options.gc_step_multiplier > 0) {
+    lua_gc(state_.get(), LUA_GCSETSTEPMUL, options.gc_step_multiplier);
+  }
   int rc = luaL_dostring(state_.get(), code.c_str());
   ASSERT(rc == 0);
 }
@@ -5,6 +5,7 @@
 #include <vector>
 
 #include "envoy/common/exception.h"
+#include "envoy/common/time.h"
 #include "envoy/thread_local/thread_local.h"
 
 #include "source/common/common/assert.h"
@@ -423,6 +424,58 @@ public:
   }
 };
 
+class Coroutine;
+
+/**
+ * Options that tune the per-worker Lua states of a ThreadLocalState.
+ */
+struct ThreadLocalStateOptions {
+  // Maximum number of finished coroutines each worker keeps for reuse. Zero disables pooling.
+  uint32_t coroutine_pool_size{};
+  // Amount of incremental GC work, in KB, done every time a coroutine is released. Zero disables
+  // stepping.
+  uint32_t gc_step_size_kb{};
+  // Values for LUA_GCSETPAUSE and LUA_GCSETSTEPMUL. Zero keeps the Lua defaults.
+  uint32_t gc_pause{};
+  uint32_t gc_step_multiplier{};
+};
+
+/**
+ * A per-worker free list of Lua threads whose coroutines completed without error. Handing these
+ * threads out again saves allocating a thread and its stack for every script invocation. The pool
+ * also performs the configured incremental GC step whenever a coroutine is released, which spreads
+ * collection work evenly across script invocations.
+ */
+class CoroutinePool {
+public:
+  CoroutinePool(lua_State* state, const ThreadLocalStateOptions& options)
+      : state_(state), max_size_(options.coroutine_pool_size),
+        gc_step_size_kb_(options.gc_step_size_kb) {}
+
+  /**
+   * @return an idle thread if one is available, or a new thread otherwise. In both cases the
+   *         thread is left on the top of the stack of the owning state.
+   */
+  lua_State* acquire();
+
+  /**
+   * Called when a coroutine created via acquire() is destroyed. The thread is kept for reuse if
+   * the coroutine is reusable and the pool is not full.
+   */
+  void release(Coroutine& coroutine);
+
+  /**
+   * @return the number of idle threads in the pool.
+   */
+  uint64_t size() const { return idle_threads_.size(); }
+
+private:
+  lua_State* const state_;
+  const uint32_t max_size_;
+  const uint32_t gc_step_size_kb_;
+  std::vector<int> idle_threads_;
+};
+
 /**
  * This is a wrapper for a Lua coroutine. Lua intermixes coroutine and "thread." Lua does not have
  * real threads, only cooperatively scheduled coroutines.
@@ -431,10 +484,39 @@ class Coroutine : Logger::Loggable<Logger::Id::lua> {
 public:
   enum class State { NotStarted, Yielded, Finished };
 
-  Coroutine(const std::pair<lua_State*, lua_State*>& new_thread_state);
+  Coroutine(const std::pair<lua_State*, lua_State*>& new_thread_state,
+            CoroutinePool* pool = nullptr);
+  ~Coroutine();
   lua_State* luaState() { return coroutine_state_.get(); }
   State state() { return state_; }
 
+  /**
+   * @return whether the underlying Lua thread can run another function, i.e. the coroutine was
+   *         never started or it finished without raising an error.
+   */
+  bool reusable() const {
+    return state_ == State::NotStarted || (state_ == State::Finished && !failed_);
+  }
+
+  /**
+   * Start tracking the time spent running the coroutine and the growth of the Lua heap while it
+   * runs. Must be called before start().
+   * @param time_source supplies the time source used to measure execution time.
+   */
+  void enableAccounting(TimeSource& time_source) { time_source_ = &time_source; }
+
+  /**
+   * @return the total time spent running the coroutine. Only tracked if accounting is enabled.
+   */
+  std::chrono::microseconds executionTime() const { return execution_time_; }
+
+  /**
+   * @return the total growth of the Lua heap while the coroutine was running. Collection that
+   *         happens during a resume offsets allocation in that resume. Only tracked if accounting
+   *         is enabled.
+   */
+  uint64_t heapGrowthBytes() const { return heap_growth_bytes_; }
+
   /**
    * Start a coroutine.
    * @param function_ref supplies the previously registered function to call. Registered with
@@ -454,8 +536,15 @@ public:
   void resume(int num_args, const std::function<void()>& yield_callback);
 
 private:
+  uint64_t heapBytesUsed();
+
   LuaRef<lua_State> coroutine_state_;
+  CoroutinePool* const pool_;
+  TimeSource* time_source_{};
+  std::chrono::microseconds execution_time_{};
+  uint64_t heap_growth_bytes_{};
   State state_{State::NotStarted};
+  bool failed_{};
 };
 
 using CoroutinePtr = std::unique_ptr<Coroutine>;
@@ -469,10 +558,12 @@ using InitializerList = std::vector<Initializer>;
  */
 class ThreadLocalState : Logger::Loggable<Logger::Id::lua> {
 public:
-  ThreadLocalState(const std::string& code, ThreadLocal::SlotAllocator& tls);
+  ThreadLocalState(const std::string& code, ThreadLocal::SlotAllocator& tls,
+                   const ThreadLocalStateOptions& options = {});
 
   /**
-   * @return CoroutinePtr a new coroutine.
+   * @return CoroutinePtr a new coroutine. If coroutine pooling is enabled the coroutine may run on
+   *         a previously used Lua thread.
    */
   CoroutinePtr createCoroutine();
 
@@ -514,12 +605,19 @@ public:
    */
   void runtimeGC() { lua_gc(tlsState().get(), LUA_GCCOLLECT, 0); }
 
+  /**
+   * Return the number of idle coroutines pooled by the current worker.
+   */
+  uint64_t pooledCoroutines() { return (*tls_slot_)->coroutine_pool_.size(); }
+
 private:
   struct LuaThreadLocal : public ThreadLocal::ThreadLocalObject {
-    LuaThreadLocal(const std::string& code);
+    LuaThreadLocal(const std::string& code, const ThreadLocalStateOptions& options);
 
     CSmartPtr<lua_State, lua_close> state_;
     std::vector<int> global_slots_;
+    // Declared after state_ so that it is destroyed first.
+    CoroutinePool coroutine_pool_;
   };
 
   CSmartPtr<lua_State, lua_close>& tlsState() { return (*tls_slot_)->state_; }
@@ -91,21 +91,29 @@ void compressAndUpdateStats(const Compression::Compressor::CompressorPtr& compre
 CompressorFilterConfig::DirectionConfig::DirectionConfig(
     const envoy::extensions::filters::http::compressor::v3::Compressor::CommonDirectionConfig&
         proto_config,
-    const std::string& stats_prefix, Stats::Scope& scope, Runtime::Loader& runtime)
+    const std::string& stats_prefix, Stats::Scope& scope, Runtime::Loader& runtime,
+    OptRef<Server::OverloadManager> overload_manager)
     : compression_enabled_(proto_config.enabled(), runtime),
       min_content_length_{contentLengthUint(proto_config.min_content_length().value())},
       content_type_values_(contentTypeSet(proto_config.content_type())),
-      stats_{generateStats(stats_prefix, scope)} {}
+      stats_{generateStats(stats_prefix, scope)},
+      adaptive_effort_enabled_(proto_config.has_adaptive_effort()),
+      adaptive_effort_min_content_length_(
+          proto_config.adaptive_effort().min_content_length().value()),
+      overload_manager_(overload_manager) {}
 
 CompressorFilterConfig::CompressorFilterConfig(
     const envoy::extensions::filters::http::compressor::v3::Compressor& proto_config,
     const std::string& stats_prefix, Stats::Scope& scope, Runtime::Loader& runtime,
-    Compression::Compressor::CompressorFactoryPtr compressor_factory)
+    Compression::Compressor::CompressorFactoryPtr compressor_factory,
+    OptRef<Server::OverloadManager> overload_manager)
     : common_stats_prefix_(fmt::format("{}compressor.{}.{}", stats_prefix,
                                        proto_config.compressor_library().name(),
                                        compressor_factory->statsPrefix())),
-      request_direction_config_(proto_config, common_stats_prefix_, scope, runtime),
-      response_direction_config_(proto_config, common_stats_prefix_, scope, runtime),
+      request_direction_config_(proto_config, common_stats_prefix_, scope, runtime,
+                                overload_manager),
+      response_direction_config_(proto_config, common_stats_prefix_, scope, runtime,
+                                 overload_manager),
       content_encoding_(compressor_factory->contentEncoding()),
       compressor_factory_(std::move(compressor_factory)),
       choose_first_(proto_config.choose_first()) {}
@@ -124,9 +132,10 @@ uint32_t CompressorFilterConfig::DirectionConfig::contentLengthUint(Protobuf::ui
 
 CompressorFilterConfig::RequestDirectionConfig::RequestDirectionConfig(
     const envoy::extensions::filters::http::compressor::v3::Compressor& proto_config,
-    const std::string& stats_prefix, Stats::Scope& scope, Runtime::Loader& runtime)
+    const std::string& stats_prefix, Stats::Scope& scope, Runtime::Loader& runtime,
+    OptRef<Server::OverloadManager> overload_manager)
     : DirectionConfig(proto_config.request_direction_config().common_config(),
-                      stats_prefix + "request.", scope, runtime),
+                      stats_prefix + "request.", scope, runtime, overload_manager),
       is_set_{proto_config.has_request_direction_config()} {}
 
 absl::flat_hash_set<uint32_t>
@@ -136,11 +145,12 @@ uncompressibleResponseCodesSet(const Protobuf::RepeatedField<uint32_t>& codes) {
 
 CompressorFilterConfig::ResponseDirectionConfig::ResponseDirectionConfig(
     const envoy::extensions::filters::http::compressor::v3::Compressor& proto_config,
-    const std::string& stats_prefix, Stats::Scope& scope, Runtime::Loader& runtime)
+    const std::string& stats_prefix, Stats::Scope& scope, Runtime::Loader& runtime,
+    OptRef<Server::OverloadManager> overload_manager)
     : DirectionConfig(commonConfig(proto_config),
                       proto_config.has_response_direction_config() ? stats_prefix + "response."
                                                                    : stats_prefix,
-                      scope, runtime),
+                      scope, runtime, overload_manager),
       disable_on_etag_header_(
           proto_config.has_response_direction_config()
               ? proto_config.response_direction_config().disable_on_etag_header()
@@ -182,8 +192,9 @@ CompressorFilterConfig::ResponseDirectionConfig::commonConfig(
   return config;
 }
 
-Envoy::Compression::Compressor::CompressorPtr CompressorFilterConfig::makeCompressor() {
-  return compressor_factory_->createCompressor();
+Envoy::Compression::Compressor::CompressorPtr
+CompressorFilterConfig::makeCompressor(UnitFloat effort) {
+  return compressor_factory_->createCompressorWithEffort(effort.value());
 }
 
 CompressorFilter::CompressorFilter(const CompressorFilterConfigSharedPtr config)
@@ -268,10 +279,11 @@ Http::FilterHeadersStatus CompressorFilter::decodeHeaders(Http::RequestHeaderMap
       request_config.isContentTypeAllowed(headers) &&
       !headers.getInline(request_content_encoding_handle.handle()) &&
       isTransferEncodingAllowed(headers)) {
+    const UnitFloat effort = request_config.compressionEffort(headers);
     headers.removeContentLength();
     headers.setInline(request_content_encoding_handle.handle(), getContentEncoding());
     request_config.stats().compressed_.inc();
-    request_compressor_ = getCompressorFactory().createCompressor();
+    request_compressor_ = getCompressorFactory().createCompressorWithEffort(effort.value());
   } else {
     request_config.stats().not_compressed_.inc();
   }
@@ -365,11 +377,12 @@ Http::FilterHeadersStatus CompressorFilter::encodeHeaders(Http::ResponseHeaderMa
     } else {
       sanitizeEtagHeader(headers);
     }
+    const UnitFloat effort = config.compressionEffort(headers);
     headers.removeContentLength();
     headers.setInline(response_content_encoding_handle.handle(), getContentEncoding());
     config.stats().compressed_.inc();
     // Finally instantiate the compressor.
-    response_compressor_ = getCompressorFactory().createCompressor();
+    response_compressor_ = getCompressorFactory().createCompressorWithEffort(effort.value());
   } else {
     config.stats().not_compressed_.inc();
   }
@@ -455,11 +468,12 @@ Http::FilterHeadersStatus CompressorFilter::encodeHeadersWithStatusHeader(
     sanitizeEtagHeader(headers);
   }
   std::string content_length = std::string(headers.getContentLengthValue());
+  const UnitFloat effort = config.compressionEffort(headers);
   headers.removeContentLength();
   headers.setInline(response_content_encoding_handle.handle(), getContentEncoding());
   config.stats().compressed_.inc();
   // Finally instantiate the compressor.
-  response_compressor_ = config_->makeCompressor();
+  response_compressor_ = config_->makeCompressor(effort);
   insertEnvoyCompressionStatusHeader(headers, getContentEncoding(),
                                      Http::Headers::get().EnvoyCompressionStatusValues.Compressed,
                                      content_length);
@@ -768,6 +782,30 @@ bool CompressorFilterConfig::DirectionConfig::isMinimumContentLength(
   return true;
 }
 
+UnitFloat CompressorFilterConfig::DirectionConfig::compressionEffort(
+    const Http::RequestOrResponseHeaderMap& headers) const {
+  if (!adaptive_effort_enabled_ || !overload_manager_.has_value()) {
+    return UnitFloat::max();
+  }
+  if (adaptive_effort_min_content_length_ > 0) {
+    const Http::HeaderEntry* content_length = headers.ContentLength();
+    uint64_t length;
+    if (content_length != nullptr &&
+        absl::SimpleAtoi(content_length->value().getStringView(), &length) &&
+        length < adaptive_effort_min_content_length_) {
+      return UnitFloat::max();
+    }
+  }
+  const Server::OverloadActionState& state =
+      overload_manager_->getThreadLocalOverloadState().getState(
+          Server::OverloadActionNames::get().ReduceCompressionEffort);
+  const UnitFloat effort = state.value().invert();
+  if (effort < UnitFloat::max()) {
+    stats_.reduced_effort_.inc();
+  }
+  return effort;
+}
+
 bool CompressorFilter::isTransferEncodingAllowed(Http::RequestOrResponseHeaderMap& headers) const {
   const Http::HeaderEntry* transfer_encoding = headers.TransferEncoding();
   if (transfer_encoding != nullptr) {
@@ -1,10 +1,13 @@
 #pragma once
 
+#include "envoy/common/optref.h"
 #include "envoy/compression/compressor/factory.h"
 #include "envoy/extensions/filters/http/compressor/v3/compressor.pb.h"
 #include "envoy/server/factory_context.h"
+#include "envoy/server/overload/overload_manager.h"
 #include "envoy/stats/stats_macros.h"
 
+#include "source/common/common/interval_value.h"
 #include "source/common/common/logger.h"
 #include "source/common/protobuf/protobuf.h"
 #include "source/common/runtime/runtime_protos.h"
@@ -23,13 +26,16 @@ namespace Compressor {
  * compression. If the request (or response) was not marked for compression, the filter increments
  *  "not_compressed", but does not add to "total_uncompressed_bytes". This way, the user can
  *  measure the memory performance of the compression.
+ * "reduced_effort" is a number of requests (or responses) compressed below the configured level
+ * because of the adaptive effort configuration.
  */
 #define COMMON_COMPRESSOR_STATS(COUNTER)                                                           \
   COUNTER(compressed)                                                                              \
   COUNTER(not_compressed)                                                                          \
   COUNTER(total_uncompressed_bytes)                                                                \
   COUNTER(total_compressed_bytes)                                                                  \
-  COUNTER(content_length_too_small)
+  COUNTER(content_length_too_small)                                                                \
+  COUNTER(reduced_effort)
 
 /**
  * Compressor filter stats specific to responses only. @see stats_macros.h
@@ -68,7 +74,8 @@ public:
     DirectionConfig(
         const envoy::extensions::filters::http::compressor::v3::Compressor::CommonDirectionConfig&
             proto_config,
-        const std::string& stats_prefix, Stats::Scope& scope, Runtime::Loader& runtime);
+        const std::string& stats_prefix, Stats::Scope& scope, Runtime::Loader& runtime,
+        OptRef<Server::OverloadManager> overload_manager);
 
     virtual ~DirectionConfig() = default;
 
@@ -79,6 +86,10 @@ public:
     uint32_t minimumLength() const { return min_content_length_; }
     bool isMinimumContentLength(const Http::RequestOrResponseHeaderMap& headers) const;
     bool isContentTypeAllowed(const Http::RequestOrResponseHeaderMap& headers) const;
+    // Returns the relative effort a new compressor should spend on the message, based on the
+    // adaptive effort configuration and the current overload state of the calling thread. Must be
+    // called before the Content-Length header is removed from the message.
+    UnitFloat compressionEffort(const Http::RequestOrResponseHeaderMap& headers) const;
 
   protected:
     const Runtime::FeatureFlag compression_enabled_;
@@ -96,13 +107,17 @@ public:
     const uint32_t min_content_length_;
     const StringUtil::CaseUnorderedSet content_type_values_;
     const CompressorStats stats_;
+    const bool adaptive_effort_enabled_;
+    const uint32_t adaptive_effort_min_content_length_;
+    OptRef<Server::OverloadManager> overload_manager_;
   };
 
   class RequestDirectionConfig : public DirectionConfig {
   public:
     RequestDirectionConfig(
         const envoy::extensions::filters::http::compressor::v3::Compressor& proto_config,
-        const std::string& stats_prefix, Stats::Scope& scope, Runtime::Loader& runtime);
+        const std::string& stats_prefix, Stats::Scope& scope, Runtime::Loader& runtime,
+        OptRef<Server::OverloadManager> overload_manager);
 
     bool compressionEnabled() const override { return is_set_ && compression_enabled_.enabled(); }
 
@@ -114,7 +129,8 @@ public:
   public:
     ResponseDirectionConfig(
         const envoy::extensions::filters::http::compressor::v3::Compressor& proto_config,
-        const std::string& stats_prefix, Stats::Scope& scope, Runtime::Loader& runtime);
+        const std::string& stats_prefix, Stats::Scope& scope, Runtime::Loader& runtime,
+        OptRef<Server::OverloadManager> overload_manager);
 
     bool compressionEnabled() const override { return compression_enabled_.enabled(); }
     const ResponseCompressorStats& responseStats() const { return response_stats_; }
@@ -148,9 +164,10 @@ public:
   CompressorFilterConfig(
       const envoy::extensions::filters::http::compressor::v3::Compressor& proto_config,
       const std::string& stats_prefix, Stats::Scope& scope, Runtime::Loader& runtime,
-      Envoy::Compression::Compressor::CompressorFactoryPtr compressor_factory);
+      Envoy::Compression::Compressor::CompressorFactoryPtr compressor_factory,
+      OptRef<Server::OverloadManager> overload_manager = {});
 
-  Envoy::Compression::Compressor::CompressorPtr makeCompressor();
+  Envoy::Compression::Compressor::CompressorPtr makeCompressor(UnitFloat effort = UnitFloat::max());
 
   const std::string contentEncoding() const { return content_encoding_; };
   bool chooseFirst() const { return choose_first_; };
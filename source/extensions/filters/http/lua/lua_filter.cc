@@ -12,6 +12,7 @@
 
 #include "source/common/buffer/buffer_impl.h"
 #include "source/common/common/assert.h"
+#include "source/common/common/hash.h"
 #include "source/common/common/enum_to_int.h"
 #include "source/common/config/datasource.h"
 #include "source/common/crypto/crypto_impl.h"
@@ -19,6 +20,7 @@
 #include "source/common/http/message_impl.h"
 
 #include "absl/strings/escaping.h"
+#include "absl/strings/str_cat.h"
 
 namespace Envoy {
 namespace Extensions {
@@ -195,8 +197,10 @@ Http::AsyncClient::Request* makeHttpCall(lua_State* state, Filter& filter,
 
 } // namespace
 
-PerLuaCodeSetup::PerLuaCodeSetup(const std::string& lua_code, ThreadLocal::SlotAllocator& tls)
-    : lua_state_(lua_code, tls) {
+PerLuaCodeSetup::PerLuaCodeSetup(const std::string& lua_code, ThreadLocal::SlotAllocator& tls,
+                                 Stats::Scope& scope,
+                                 const Filters::Common::Lua::ThreadLocalStateOptions& options)
+    : lua_state_(lua_code, tls, options), script_stats_(generateScriptStats(lua_code, scope)) {
   lua_state_.registerType<Filters::Common::Lua::BufferWrapper>();
   lua_state_.registerType<Filters::Common::Lua::MetadataMapWrapper>();
   lua_state_.registerType<Filters::Common::Lua::MetadataMapIterator>();
@@ -240,6 +244,16 @@ PerLuaCodeSetup::PerLuaCodeSetup(const std::string& lua_code, ThreadLocal::SlotA
   }
 }
 
+LuaScriptStats PerLuaCodeSetup::generateScriptStats(const std::string& lua_code,
+                                                    Stats::Scope& scope) {
+  // Keyed by the source code rather than by filter, so that the filters running the same script
+  // share its stats.
+  const std::string prefix =
+      absl::StrCat("lua.script.", absl::Hex(HashUtil::xxHash64(lua_code), absl::kZeroPad16), ".");
+  ENVOY_LOG(debug, "lua script stats are emitted under {}", prefix);
+  return {ALL_LUA_SCRIPT_STATS(POOL_HISTOGRAM_PREFIX(scope, prefix))};
+}
+
 StreamHandleWrapper::StreamHandleWrapper(Filters::Common::Lua::Coroutine& coroutine,
                                          Http::RequestOrResponseHeaderMap& headers, bool end_stream,
                                          Filter& filter, FilterCallbacks& callbacks,
@@ -833,7 +847,15 @@ FilterConfig::FilterConfig(const envoy::extensions::filters::http::lua::v3::Lua&
     : cluster_manager_(cluster_manager),
       clear_route_cache_(
           proto_config.has_clear_route_cache() ? proto_config.clear_route_cache().value() : true),
+      execution_stats_enabled_(proto_config.runtime().execution_stats()),
       stats_(generateStats(stats_prefix, proto_config.stat_prefix(), scope)) {
+  const auto& runtime = proto_config.runtime();
+  Filters::Common::Lua::ThreadLocalStateOptions options;
+  options.coroutine_pool_size = runtime.coroutine_pool_size();
+  options.gc_step_size_kb = runtime.gc_step_size_kb();
+  options.gc_pause = PROTOBUF_GET_WRAPPED_OR_DEFAULT(runtime, gc_pause, 0);
+  options.gc_step_multiplier = PROTOBUF_GET_WRAPPED_OR_DEFAULT(runtime, gc_step_multiplier, 0);
+
   if (proto_config.has_default_source_code()) {
     if (!proto_config.inline_code().empty()) {
       throw EnvoyException("Error: Only one of `inline_code` or `default_source_code` can be set "
@@ -842,15 +864,16 @@ FilterConfig::FilterConfig(const envoy::extensions::filters::http::lua::v3::Lua&
 
     const std::string code = THROW_OR_RETURN_VALUE(
         Config::DataSource::read(proto_config.default_source_code(), true, api), std::string);
-    default_lua_code_setup_ = std::make_unique<PerLuaCodeSetup>(code, tls);
+    default_lua_code_setup_ = std::make_unique<PerLuaCodeSetup>(code, tls, scope, options);
   } else if (!proto_config.inline_code().empty()) {
-    default_lua_code_setup_ = std::make_unique<PerLuaCodeSetup>(proto_config.inline_code(), tls);
+    default_lua_code_setup_ =
+        std::make_unique<PerLuaCodeSetup>(proto_config.inline_code(), tls, scope, options);
   }
 
   for (const auto& source : proto_config.source_codes()) {
     const std::string code =
         THROW_OR_RETURN_VALUE(Config::DataSource::read(source.second, true, api), std::string);
-    auto per_lua_code_setup_ptr = std::make_unique<PerLuaCodeSetup>(code, tls);
+    auto per_lua_code_setup_ptr = std::make_unique<PerLuaCodeSetup>(code, tls, scope, options);
     if (!per_lua_code_setup_ptr) {
       continue;
     }
@@ -869,7 +892,8 @@ FilterConfigPerRoute::FilterConfigPerRoute(
     // Read and parse the inline Lua code defined in the route configuration.
     const std::string code_str = THROW_OR_RETURN_VALUE(
         Config::DataSource::read(config.source_code(), true, context.api()), std::string);
-    per_lua_code_setup_ptr_ = std::make_unique<PerLuaCodeSetup>(code_str, context.threadLocal());
+    per_lua_code_setup_ptr_ =
+        std::make_unique<PerLuaCodeSetup>(code_str, context.threadLocal(), context.scope());
   }
 }
 
@@ -881,17 +905,37 @@ void Filter::onDestroy() {
   if (response_stream_wrapper_.get()) {
     response_stream_wrapper_.get()->onReset();
   }
+
+  if (config_->executionStatsEnabled()) {
+    if (request_coroutine_ != nullptr) {
+      recordExecutionStats(*request_coroutine_, *request_script_stats_);
+    }
+    if (response_coroutine_ != nullptr) {
+      recordExecutionStats(*response_coroutine_, *response_script_stats_);
+    }
+  }
+}
+
+void Filter::recordExecutionStats(const Filters::Common::Lua::Coroutine& coroutine,
+                                  const LuaScriptStats& script_stats) {
+  script_stats.execution_time_.recordValue(coroutine.executionTime().count());
+  script_stats.heap_growth_.recordValue(coroutine.heapGrowthBytes());
 }
 
 Http::FilterHeadersStatus
 Filter::doHeaders(StreamHandleRef& handle, Filters::Common::Lua::CoroutinePtr& coroutine,
-                  FilterCallbacks& callbacks, int function_ref, PerLuaCodeSetup* setup,
+                  const LuaScriptStats*& script_stats, FilterCallbacks& callbacks,
+                  int function_ref, PerLuaCodeSetup* setup,
                   Http::RequestOrResponseHeaderMap& headers, bool end_stream) {
   if (function_ref == LUA_REFNIL) {
     return Http::FilterHeadersStatus::Continue;
   }
   ASSERT(setup);
   coroutine = setup->createCoroutine();
+  script_stats = &setup->scriptStats();
+  if (config_->executionStatsEnabled()) {
+    coroutine->enableAccounting(time_source_);
+  }
 
   handle.reset(StreamHandleWrapper::create(coroutine->luaState(), *coroutine, headers, end_stream,
                                            *this, callbacks, time_source_),
@@ -29,9 +29,26 @@ struct LuaFilterStats {
   ALL_LUA_FILTER_STATS(GENERATE_COUNTER_STRUCT)
 };
 
+/**
+ * All per-script lua stats, emitted under lua.script.<hash of the source code>, so that the
+ * filters running the same script record into the same stats. @see stats_macros.h
+ */
+#define ALL_LUA_SCRIPT_STATS(HISTOGRAM)                                                            \
+  HISTOGRAM(execution_time, Microseconds)                                                          \
+  HISTOGRAM(heap_growth, Bytes)
+
+/**
+ * Struct definition for all per-script Lua stats. @see stats_macros.h
+ */
+struct LuaScriptStats {
+  ALL_LUA_SCRIPT_STATS(GENERATE_HISTOGRAM_STRUCT)
+};
+
 class PerLuaCodeSetup : Logger::Loggable<Logger::Id::lua> {
 public:
-  PerLuaCodeSetup(const std::string& lua_code, ThreadLocal::SlotAllocator& tls);
+  PerLuaCodeSetup(const std::string& lua_code, ThreadLocal::SlotAllocator& tls,
+                  Stats::Scope& scope,
+                  const Filters::Common::Lua::ThreadLocalStateOptions& options = {});
 
   Extensions::Filters::Common::Lua::CoroutinePtr createCoroutine() {
     return lua_state_.createCoroutine();
@@ -42,12 +59,17 @@ public:
 
   uint64_t runtimeBytesUsed() { return lua_state_.runtimeBytesUsed(); }
   void runtimeGC() { return lua_state_.runtimeGC(); }
+  uint64_t pooledCoroutines() { return lua_state_.pooledCoroutines(); }
+  const LuaScriptStats& scriptStats() const { return script_stats_; }
 
 private:
+  static LuaScriptStats generateScriptStats(const std::string& lua_code, Stats::Scope& scope);
+
   uint64_t request_function_slot_{};
   uint64_t response_function_slot_{};
 
   Filters::Common::Lua::ThreadLocalState lua_state_;
+  const LuaScriptStats script_stats_;
 };
 
 using PerLuaCodeSetupPtr = std::unique_ptr<PerLuaCodeSetup>;
@@ -455,6 +477,7 @@ public:
     return nullptr;
   }
   bool clearRouteCache() const { return clear_route_cache_; }
+  bool executionStatsEnabled() const { return execution_stats_enabled_; }
 
   const LuaFilterStats& stats() const { return stats_; }
 
@@ -468,6 +491,7 @@ private:
   }
 
   const bool clear_route_cache_{};
+  const bool execution_stats_enabled_{};
   PerLuaCodeSetupPtr default_lua_code_setup_;
   absl::flat_hash_map<std::string, PerLuaCodeSetupPtr> per_lua_code_setups_map_;
   LuaFilterStats stats_;
@@ -514,8 +538,8 @@ public:
                                           bool end_stream) override {
     PerLuaCodeSetup* setup = getPerLuaCodeSetup();
     const int function_ref = setup ? setup->requestFunctionRef() : LUA_REFNIL;
-    return doHeaders(request_stream_wrapper_, request_coroutine_, decoder_callbacks_, function_ref,
-                     setup, headers, end_stream);
+    return doHeaders(request_stream_wrapper_, request_coroutine_, request_script_stats_,
+                     decoder_callbacks_, function_ref, setup, headers, end_stream);
   }
   Http::FilterDataStatus decodeData(Buffer::Instance& data, bool end_stream) override {
     return doData(request_stream_wrapper_, data, end_stream);
@@ -535,8 +559,8 @@ public:
                                           bool end_stream) override {
     PerLuaCodeSetup* setup = getPerLuaCodeSetup();
     const int function_ref = setup ? setup->responseFunctionRef() : LUA_REFNIL;
-    return doHeaders(response_stream_wrapper_, response_coroutine_, encoder_callbacks_,
-                     function_ref, setup, headers, end_stream);
+    return doHeaders(response_stream_wrapper_, response_coroutine_, response_script_stats_,
+                     encoder_callbacks_, function_ref, setup, headers, end_stream);
   }
   Http::FilterDataStatus encodeData(Buffer::Instance& data, bool end_stream) override {
     return doData(response_stream_wrapper_, data, end_stream);
@@ -662,11 +686,14 @@ private:
 
   Http::FilterHeadersStatus doHeaders(StreamHandleRef& handle,
                                       Filters::Common::Lua::CoroutinePtr& coroutine,
+                                      const LuaScriptStats*& script_stats,
                                       FilterCallbacks& callbacks, int function_ref,
                                       PerLuaCodeSetup* setup,
                                       Http::RequestOrResponseHeaderMap& headers, bool end_stream);
   Http::FilterDataStatus doData(StreamHandleRef& handle, Buffer::Instance& data, bool end_stream);
   Http::FilterTrailersStatus doTrailers(StreamHandleRef& handle, Http::HeaderMap& trailers);
+  void recordExecutionStats(const Filters::Common::Lua::Coroutine& coroutine,
+                            const LuaScriptStats& script_stats);
 
   FilterConfigConstSharedPtr config_;
   const FilterConfigPerRoute* per_route_config_{};
@@ -688,6 +715,9 @@ private:
   // seems like a safer fix for now.
   Filters::Common::Lua::CoroutinePtr request_coroutine_;
   Filters::Common::Lua::CoroutinePtr response_coroutine_;
+  // The stats of the scripts the coroutines run.
+  const LuaScriptStats* request_script_stats_{};
+  const LuaScriptStats* response_script_stats_{};
 
   DecoderCallbacks decoder_callbacks_{*this};
   EncoderCallbacks encoder_callbacks_{*this};
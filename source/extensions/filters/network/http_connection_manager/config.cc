@@ -453,7 +453,14 @@ HttpConnectionManagerConfig::HttpConnectionManagerConfig(
               ? absl::flat_hash_set<uint32_t>(
                     config.forward_proto_config().http_destination_ports().begin(),
                     config.forward_proto_config().http_destination_ports().end())
-              : absl::flat_hash_set<uint32_t>{}) {
+              : absl::flat_hash_set<uint32_t>{}),
+      filter_instrumentation_(config.has_filter_instrumentation()
+                                  ? std::make_unique<Http::FilterInstrumentation>(
+                                        config.filter_instrumentation(), stats_prefix_,
+                                        context_.scope(),
+                                        context_.serverFactoryContext().timeSource(),
+                                        context_.serverFactoryContext().api().randomGenerator())
+                                  : nullptr) {
   if (!creation_status.ok()) {
     return;
   }
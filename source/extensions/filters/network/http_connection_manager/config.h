@@ -285,6 +285,9 @@ public:
   const absl::flat_hash_set<uint32_t>& httpDestinationPorts() const override {
     return http_destination_ports_;
   }
+  Http::FilterInstrumentation* filterInstrumentation() override {
+    return filter_instrumentation_.get();
+  }
 
 private:
   enum class CodecType { HTTP1, HTTP2, HTTP3, AUTO };
@@ -386,6 +389,7 @@ private:
   const bool add_proxy_protocol_connection_state_;
   const absl::flat_hash_set<uint32_t> https_destination_ports_;
   const absl::flat_hash_set<uint32_t> http_destination_ports_;
+  const Http::FilterInstrumentationPtr filter_instrumentation_;
 };
 
 /**
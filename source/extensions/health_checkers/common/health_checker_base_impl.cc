@@ -5,7 +5,9 @@
 #include "envoy/data/core/v3/health_check_event.pb.h"
 #include "envoy/stats/scope.h"
 
+#include "source/common/common/hash.h"
 #include "source/common/network/utility.h"
+#include "source/common/protobuf/utility.h"
 #include "source/common/router/router.h"
 #include "source/common/runtime/runtime_features.h"
 
@@ -43,7 +45,12 @@ HealthCheckerImplBase::HealthCheckerImplBase(const Cluster& cluster,
       member_update_cb_{cluster_.prioritySet().addMemberUpdateCb(
           [this](const HostVector& hosts_added, const HostVector& hosts_removed) {
             onClusterMemberUpdate(hosts_added, hosts_removed);
-          })} {}
+          })},
+      shared_results_(initSharedResults(config)),
+      shared_results_lease_duration_(PROTOBUF_GET_MS_OR_DEFAULT(
+          config.shared_results(), lease_duration, 3 * interval_.count())),
+      shared_results_seed_(HashUtil::xxHash64(cluster.info()->name(), MessageUtil::hash(config))),
+      shared_results_lease_key_(HashUtil::xxHash64("lease", shared_results_seed_)) {}
 
 std::shared_ptr<const Network::TransportSocketOptionsImpl>
 HealthCheckerImplBase::initTransportSocketOptions(
@@ -72,6 +79,22 @@ MetadataConstSharedPtr HealthCheckerImplBase::initTransportSocketMatchMetadata(
   return nullptr;
 }
 
+SharedHealthCheckResultsSharedPtr
+HealthCheckerImplBase::initSharedResults(const envoy::config::core::v3::HealthCheck& config) {
+  if (!config.has_shared_results()) {
+    return nullptr;
+  }
+  auto results_or_error = SharedHealthCheckResults::open(
+      config.shared_results().path(),
+      PROTOBUF_GET_WRAPPED_OR_DEFAULT(config.shared_results(), max_hosts, 65536));
+  if (!results_or_error.ok()) {
+    // The hosts can still be probed by this process alone, so this is not a configuration error.
+    ENVOY_LOG(warn, "not sharing health check results: {}", results_or_error.status().message());
+    return nullptr;
+  }
+  return std::move(results_or_error.value());
+}
+
 HealthCheckerImplBase::~HealthCheckerImplBase() {
   // First clear callbacks that otherwise will be run from
   // ActiveHealthCheckSession::onDeferredDeleteBase(). This prevents invoking a callback on a
@@ -98,6 +121,13 @@ void HealthCheckerImplBase::incHealthy() { stats_.healthy_.add(1); }
 
 void HealthCheckerImplBase::incDegraded() { stats_.degraded_.add(1); }
 
+bool HealthCheckerImplBase::probesLocally() {
+  return shared_results_ == nullptr ||
+         shared_results_->holdLease(shared_results_lease_key_,
+                                    dispatcher_.timeSource().systemTime(),
+                                    shared_results_lease_duration_);
+}
+
 std::chrono::milliseconds HealthCheckerImplBase::interval(HealthState state,
                                                           HealthTransition changed_state) const {
   // See if the cluster has ever made a connection. If not, we use a much slower interval to keep
@@ -252,9 +282,17 @@ void HealthCheckerImplBase::start() {
 HealthCheckerImplBase::ActiveHealthCheckSession::ActiveHealthCheckSession(
     HealthCheckerImplBase& parent, HostSharedPtr host)
     : host_(host), parent_(parent),
-      interval_timer_(parent.dispatcher_.createTimer([this]() -> void { onIntervalBase(); })),
-      timeout_timer_(parent.dispatcher_.createTimer([this]() -> void { onTimeoutBase(); })),
-      time_source_(parent.dispatcher_.timeSource()) {
+      // Every host has these timers, and they are re-armed at each check, so they are kept on the
+      // dispatcher's timer wheel.
+      interval_timer_(
+          parent.dispatcher_.createWheelTimer([this]() -> void { onIntervalBase(); })),
+      timeout_timer_(parent.dispatcher_.createWheelTimer([this]() -> void { onTimeoutBase(); })),
+      time_source_(parent.dispatcher_.timeSource()),
+      shared_results_key_(parent.shared_results_ != nullptr
+                              ? HashUtil::xxHash64(host->healthCheckAddress()->asStringView(),
+                                                   parent.shared_results_seed_)
+                              : 0),
+      last_shared_result_(time_source_.monotonicTime()) {
 
   if (!host->healthFlagGet(Host::HealthFlag::FAILED_ACTIVE_HC)) {
     parent.incHealthy();
@@ -293,6 +331,10 @@ void HealthCheckerImplBase::ActiveHealthCheckSession::onDeferredDeleteBase() {
 }
 
 void HealthCheckerImplBase::ActiveHealthCheckSession::handleSuccess(bool degraded) {
+  publishResult(degraded ? SharedHealthCheckResults::Outcome::Degraded
+                         : SharedHealthCheckResults::Outcome::Healthy,
+                envoy::data::core::v3::ACTIVE, false);
+
   // If we are healthy, reset the # of unhealthy to zero.
   num_unhealthy_ = 0;
 
@@ -416,6 +458,7 @@ HealthTransition HealthCheckerImplBase::ActiveHealthCheckSession::setUnhealthy(
 
 void HealthCheckerImplBase::ActiveHealthCheckSession::handleFailure(
     envoy::data::core::v3::HealthCheckFailureType type, bool retriable) {
+  publishResult(SharedHealthCheckResults::Outcome::Unhealthy, type, retriable);
   HealthTransition changed_state = setUnhealthy(type, retriable);
   // It's possible that the previous call caused this session to be deferred deleted.
   if (timeout_timer_ != nullptr) {
@@ -440,11 +483,68 @@ HealthCheckerImplBase::ActiveHealthCheckSession::clearPendingFlag(HealthTransiti
 }
 
 void HealthCheckerImplBase::ActiveHealthCheckSession::onIntervalBase() {
+  if (!parent_.probesLocally() && onSharedInterval()) {
+    return;
+  }
   onInterval();
   timeout_timer_->enableTimer(parent_.timeout_);
   parent_.stats_.attempt_.inc();
 }
 
+bool HealthCheckerImplBase::ActiveHealthCheckSession::onSharedInterval() {
+  const absl::optional<SharedHealthCheckResults::Result> result =
+      parent_.shared_results_->find(shared_results_key_);
+  if (!result.has_value() || result->sequence_ == shared_results_sequence_) {
+    // The probing process has not checked the host since the last interval. It may not know the
+    // host yet, e.g. while its cluster is being updated, so it is only waited for a while.
+    if (time_source_.monotonicTime() - last_shared_result_ >
+        parent_.shared_results_lease_duration_ + parent_.interval_) {
+      return false;
+    }
+    interval_timer_->enableTimer(
+        parent_.interval(host_->healthFlagGet(Host::HealthFlag::FAILED_ACTIVE_HC)
+                             ? HealthState::Unhealthy
+                             : HealthState::Healthy,
+                         HealthTransition::Unchanged));
+    return true;
+  }
+
+  shared_results_sequence_ = result->sequence_;
+  last_shared_result_ = time_source_.monotonicTime();
+  parent_.stats_.shared_result_.inc();
+  applying_shared_result_ = true;
+  switch (result->outcome_) {
+  case SharedHealthCheckResults::Outcome::Healthy:
+    handleSuccess(false);
+    break;
+  case SharedHealthCheckResults::Outcome::Degraded:
+    handleSuccess(true);
+    break;
+  case SharedHealthCheckResults::Outcome::Unhealthy:
+    handleFailure(result->failure_type_, result->retriable_);
+    break;
+  }
+  applying_shared_result_ = false;
+  return true;
+}
+
+void HealthCheckerImplBase::ActiveHealthCheckSession::publishResult(
+    SharedHealthCheckResults::Outcome outcome,
+    envoy::data::core::v3::HealthCheckFailureType failure_type, bool retriable) {
+  if (parent_.shared_results_ == nullptr || applying_shared_result_) {
+    return;
+  }
+  const uint64_t sequence =
+      parent_.shared_results_->publish(shared_results_key_, outcome, failure_type, retriable);
+  if (sequence == 0) {
+    ENVOY_LOG_EVERY_POW_2(warn, "shared health check results are full, {} is not shared",
+                          host_->address()->asStringView());
+    return;
+  }
+  // So that the result is not applied again if another process takes the lease over.
+  shared_results_sequence_ = sequence;
+}
+
 void HealthCheckerImplBase::ActiveHealthCheckSession::onTimeoutBase() {
   onTimeout();
   handleFailure(envoy::data::core::v3::NETWORK_TIMEOUT);
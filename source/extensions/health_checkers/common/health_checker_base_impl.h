@@ -14,6 +14,7 @@
 #include "source/common/common/logger.h"
 #include "source/common/common/matchers.h"
 #include "source/common/network/transport_socket_options_impl.h"
+#include "source/extensions/health_checkers/common/shared_health_check_results.h"
 
 namespace Envoy {
 namespace Upstream {
@@ -26,6 +27,7 @@ namespace Upstream {
   COUNTER(failure)                                                                                 \
   COUNTER(network_failure)                                                                         \
   COUNTER(passive_failure)                                                                         \
+  COUNTER(shared_result)                                                                           \
   COUNTER(success)                                                                                 \
   COUNTER(verify_cluster)                                                                          \
   GAUGE(degraded, Accumulate)                                                                      \
@@ -73,6 +75,12 @@ protected:
     HostSharedPtr host_;
 
   private:
+    // Applies the latest result published by the process probing the host, if there is a new one,
+    // instead of probing it. Returns false if that process has published no new result for longer
+    // than its lease plus an interval, in which case the host is probed locally.
+    bool onSharedInterval();
+    void publishResult(SharedHealthCheckResults::Outcome outcome,
+                       envoy::data::core::v3::HealthCheckFailureType failure_type, bool retriable);
     // Clears the pending flag if it is set. By clearing this flag we're marking the host as having
     // been health checked.
     // Returns the changed state to use following the flag update.
@@ -91,6 +99,12 @@ protected:
     uint32_t num_healthy_{};
     bool first_check_{true};
     TimeSource& time_source_;
+    // The host's key in the shared results, the sequence number of the last result applied or
+    // published, and when the last result of another process was applied.
+    const uint64_t shared_results_key_;
+    uint64_t shared_results_sequence_{};
+    MonotonicTime last_shared_result_;
+    bool applying_shared_result_{};
   };
 
   using ActiveHealthCheckSessionPtr = std::unique_ptr<ActiveHealthCheckSession>;
@@ -135,6 +149,8 @@ private:
   HealthCheckerStats generateStats(Stats::Scope& scope);
   void incHealthy();
   void incDegraded();
+  // Whether this process probes the hosts, rather than reading the results of another process.
+  bool probesLocally();
   std::chrono::milliseconds interval(HealthState state, HealthTransition changed_state) const;
   std::chrono::milliseconds intervalWithJitter(uint64_t base_time_ms,
                                                std::chrono::milliseconds interval_jitter) const;
@@ -147,6 +163,8 @@ private:
   initTransportSocketOptions(const envoy::config::core::v3::HealthCheck& config);
   static MetadataConstSharedPtr
   initTransportSocketMatchMetadata(const envoy::config::core::v3::HealthCheck& config);
+  static SharedHealthCheckResultsSharedPtr
+  initSharedResults(const envoy::config::core::v3::HealthCheck& config);
 
   std::list<HostStatusCb> callbacks_;
   const std::chrono::milliseconds interval_;
@@ -162,6 +180,13 @@ private:
   const std::shared_ptr<const Network::TransportSocketOptionsImpl> transport_socket_options_;
   const MetadataConstSharedPtr transport_socket_match_metadata_;
   const Common::CallbackHandlePtr member_update_cb_;
+  const SharedHealthCheckResultsSharedPtr shared_results_;
+  const std::chrono::milliseconds shared_results_lease_duration_;
+  // Mixed into the keys of the hosts in the shared results, so that only identical health checks of
+  // the same cluster share results.
+  const uint64_t shared_results_seed_;
+  // Identifies the lease of this health check, held by the process which probes its hosts.
+  const uint64_t shared_results_lease_key_;
   bool started_{false};
 };
 
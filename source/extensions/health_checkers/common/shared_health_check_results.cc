@@ -0,0 +1,244 @@
+#include "source/extensions/health_checkers/common/shared_health_check_results.h"
+
+#include "envoy/common/exception.h"
+#include "envoy/common/platform.h"
+
+#include "source/common/api/os_sys_calls_impl.h"
+#include "source/common/common/assert.h"
+#include "source/common/common/cleanup.h"
+#include "source/common/common/fmt.h"
+#include "source/common/common/macros.h"
+#include "source/common/common/utility.h"
+#include "source/common/memory/shared_region.h"
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
+
+namespace Envoy {
+namespace Upstream {
+
+namespace {
+
+// How long a process which finds the region created by another waits for it to be sized and
+// laid out. The creator does both right after creating the file, so a region which is still not
+// ready by then was left behind by a process which exited.
+constexpr std::chrono::milliseconds RegionTimeout{1000};
+
+// A key of 0 marks an empty slot.
+constexpr uint64_t EmptyKey = 0;
+
+// The layout of a slot's result: the outcome, the failure type, the retriable flag, and above them
+// the sequence number.
+constexpr uint64_t OutcomeShift = 0;
+constexpr uint64_t FailureTypeShift = 8;
+constexpr uint64_t RetriableShift = 16;
+constexpr uint64_t SequenceShift = 17;
+constexpr uint64_t ByteMask = 0xff;
+
+// The layout of a lease slot's result: the owner, and above it the time the lease expires at, in
+// milliseconds since the epoch. Both change with a single compare and swap.
+constexpr uint64_t LeaseExpiryShift = 20;
+static_assert(SharedHealthCheckResults::MaxOwner == (1 << LeaseExpiryShift) - 1);
+
+uint64_t nonEmptyKey(uint64_t key) { return key == EmptyKey ? 1 : key; }
+
+// The regions mapped by this process, by path. Mappings are kept for the life of the process, so
+// that a health checker recreated by a config update keeps the leases of its predecessor.
+struct MappedRegions {
+  absl::Mutex mutex_;
+  absl::flat_hash_map<std::string, SharedHealthCheckResultsSharedPtr> regions_
+      ABSL_GUARDED_BY(mutex_);
+};
+
+MappedRegions& mappedRegions() { MUTABLE_CONSTRUCT_ON_FIRST_USE(MappedRegions); }
+
+#ifndef WIN32
+absl::StatusOr<SharedHealthCheckResultsSharedPtr> mapRegion(const std::string& path,
+                                                            uint64_t capacity) {
+  Api::OsSysCalls& os_sys_calls = Api::OsSysCallsSingleton::get();
+  // Only the process which creates the file sizes it, so that the size never changes under a
+  // process which has mapped it.
+  bool created = true;
+  Api::SysCallIntResult result = os_sys_calls.open(path.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+  if (result.return_value_ == -1 && result.errno_ == EEXIST) {
+    created = false;
+    result = os_sys_calls.open(path.c_str(), O_RDWR);
+  }
+  if (result.return_value_ == -1) {
+    return absl::InvalidArgumentError(
+        fmt::format("unable to open {}: {}", path, errorDetails(result.errno_)));
+  }
+  const os_fd_t fd = result.return_value_;
+  Cleanup close_fd([&os_sys_calls, fd]() { os_sys_calls.close(fd); });
+
+  auto mapping_or_error = Memory::SharedRegion::mapFile(
+      fd, path, created ? SharedHealthCheckResults::bytesRequired(capacity) : 0, RegionTimeout);
+  RETURN_IF_NOT_OK_REF(mapping_or_error.status());
+  const Memory::SharedRegion::Mapping& mapping = mapping_or_error.value();
+  auto region_or_error = SharedHealthCheckResults::initialize(mapping.memory_, mapping.size_,
+                                                              capacity, RegionTimeout);
+  if (!region_or_error.ok()) {
+    Memory::SharedRegion::unmapFile(mapping);
+    return absl::Status(region_or_error.status().code(),
+                        fmt::format("{}: {}", path, region_or_error.status().message()));
+  }
+  return SharedHealthCheckResultsSharedPtr{std::move(region_or_error.value())};
+}
+#endif
+
+} // namespace
+
+struct SharedHealthCheckResults::Header {
+  Memory::SharedRegion::Header region_;
+  std::atomic<uint64_t> slots_used_;
+  // The number of times a process attached to the region, from which each takes its identifier.
+  std::atomic<uint64_t> attached_;
+};
+
+const Memory::SharedRegion& SharedHealthCheckResults::layout() {
+  // "envoyhcr", identifying a region laid out by initialize(). Increment the version whenever the
+  // layout of the region changes.
+  CONSTRUCT_ON_FIRST_USE(Memory::SharedRegion, "shared health check region", 0x656e766f79686372,
+                         3, sizeof(Header), sizeof(Slot));
+}
+
+uint64_t SharedHealthCheckResults::bytesRequired(uint64_t capacity) {
+  return layout().bytesRequired(capacity);
+}
+
+absl::StatusOr<std::unique_ptr<SharedHealthCheckResults>>
+SharedHealthCheckResults::initialize(void* memory, uint64_t size, uint64_t capacity,
+                                     std::chrono::milliseconds timeout) {
+  // The rest of the header and the slots start out zero-filled, which is all they need.
+  auto capacity_or_error =
+      layout().createOrAttach(memory, size, capacity, timeout, [](uint64_t) {});
+  RETURN_IF_NOT_OK_REF(capacity_or_error.status());
+  // Unique among the processes attached, unless one of them stays attached while MaxOwner others
+  // come and go.
+  const uint64_t owner =
+      reinterpret_cast<Header*>(memory)->attached_.fetch_add(1) % MaxOwner + 1;
+  return std::unique_ptr<SharedHealthCheckResults>(new SharedHealthCheckResults(memory, owner));
+}
+
+absl::StatusOr<SharedHealthCheckResultsSharedPtr>
+SharedHealthCheckResults::open(const std::string& path, uint64_t capacity) {
+#ifdef WIN32
+  UNREFERENCED_PARAMETER(path);
+  UNREFERENCED_PARAMETER(capacity);
+  return absl::UnimplementedError("shared health check results are not supported on Windows");
+#else
+  MappedRegions& mapped = mappedRegions();
+  absl::MutexLock lock(&mapped.mutex_);
+  auto it = mapped.regions_.find(path);
+  if (it != mapped.regions_.end()) {
+    return it->second;
+  }
+  auto region_or_error = mapRegion(path, capacity);
+  RETURN_IF_NOT_OK_REF(region_or_error.status());
+  mapped.regions_.emplace(path, region_or_error.value());
+  return region_or_error;
+#endif
+}
+
+SharedHealthCheckResults::SharedHealthCheckResults(void* memory, uint64_t owner)
+    : header_(reinterpret_cast<Header*>(memory)),
+      slots_(reinterpret_cast<Slot*>(reinterpret_cast<char*>(memory) + sizeof(Header))),
+      owner_(owner) {}
+
+uint64_t SharedHealthCheckResults::capacity() const { return header_->region_.capacity_; }
+
+uint64_t SharedHealthCheckResults::size() const { return header_->slots_used_.load(); }
+
+SharedHealthCheckResults::Slot* SharedHealthCheckResults::findSlot(uint64_t key,
+                                                                   bool allocate) const {
+  const uint64_t mask = header_->region_.capacity_ - 1;
+  for (uint64_t probe = 0; probe <= mask; ++probe) {
+    Slot& slot = slots_[(key + probe) & mask];
+    uint64_t slot_key = slot.key_.load(std::memory_order_acquire);
+    if (slot_key == EmptyKey) {
+      if (!allocate) {
+        return nullptr;
+      }
+      if (slot.key_.compare_exchange_strong(slot_key, key, std::memory_order_acq_rel)) {
+        ++header_->slots_used_;
+        return &slot;
+      }
+      // Another process claimed the slot first, possibly for the same key.
+    }
+    if (slot_key == key) {
+      return &slot;
+    }
+  }
+  return nullptr;
+}
+
+uint64_t
+SharedHealthCheckResults::publish(uint64_t key, Outcome outcome,
+                                  envoy::data::core::v3::HealthCheckFailureType failure_type,
+                                  bool retriable) {
+  Slot* slot = findSlot(nonEmptyKey(key), true);
+  if (slot == nullptr) {
+    return 0;
+  }
+  const uint64_t fields = (static_cast<uint64_t>(outcome) << OutcomeShift) |
+                          ((static_cast<uint64_t>(failure_type) & ByteMask) << FailureTypeShift) |
+                          (static_cast<uint64_t>(retriable) << RetriableShift);
+  uint64_t result = slot->result_.load(std::memory_order_relaxed);
+  uint64_t sequence;
+  do {
+    sequence = (result >> SequenceShift) + 1;
+  } while (!slot->result_.compare_exchange_weak(result, (sequence << SequenceShift) | fields,
+                                                std::memory_order_release,
+                                                std::memory_order_relaxed));
+  return sequence;
+}
+
+absl::optional<SharedHealthCheckResults::Result>
+SharedHealthCheckResults::find(uint64_t key) const {
+  const Slot* slot = findSlot(nonEmptyKey(key), false);
+  if (slot == nullptr) {
+    return absl::nullopt;
+  }
+  const uint64_t result = slot->result_.load(std::memory_order_acquire);
+  const uint64_t outcome = (result >> OutcomeShift) & ByteMask;
+  if (outcome < static_cast<uint64_t>(Outcome::Healthy) ||
+      outcome > static_cast<uint64_t>(Outcome::Unhealthy)) {
+    // The slot has been claimed, but its first result is not published yet.
+    return absl::nullopt;
+  }
+  return Result{static_cast<Outcome>(outcome),
+                static_cast<envoy::data::core::v3::HealthCheckFailureType>(
+                    (result >> FailureTypeShift) & ByteMask),
+                ((result >> RetriableShift) & 1) != 0, result >> SequenceShift};
+}
+
+bool SharedHealthCheckResults::holdLease(uint64_t key, SystemTime now,
+                                         std::chrono::milliseconds duration) {
+  Slot* slot = findSlot(nonEmptyKey(key), true);
+  if (slot == nullptr) {
+    return true;
+  }
+  const uint64_t now_ms =
+      std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()).count();
+  const uint64_t renewed = ((now_ms + duration.count()) << LeaseExpiryShift) | owner_;
+  uint64_t lease = slot->result_.load(std::memory_order_acquire);
+  // Several processes may find the lease expired at once. Only the first to swap in its own
+  // identifier takes it over.
+  do {
+    const uint64_t expiry_ms = lease >> LeaseExpiryShift;
+    if ((lease & MaxOwner) != owner_) {
+      if (expiry_ms > now_ms) {
+        return false;
+      }
+    } else if (expiry_ms > now_ms + duration.count() / 2) {
+      // The holder is asked once per host and interval, but only renews once half of the lease
+      // has run out, which leaves it the other half to renew before another process takes over.
+      return true;
+    }
+  } while (!slot->result_.compare_exchange_weak(lease, renewed, std::memory_order_acq_rel,
+                                                std::memory_order_acquire));
+  return true;
+}
+
+} // namespace Upstream
+} // namespace Envoy
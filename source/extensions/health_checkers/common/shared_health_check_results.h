@@ -0,0 +1,133 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "envoy/common/time.h"
+#include "envoy/data/core/v3/health_check_event.pb.h"
+
+#include "source/common/memory/shared_region.h"
+
+#include "absl/status/statusor.h"
+#include "absl/types/optional.h"
+
+namespace Envoy {
+namespace Upstream {
+
+/**
+ * The latest health check result of each host, laid out in a block of memory that several
+ * processes map from the same file. For each health check, one process at a time holds its lease
+ * and probes its hosts, publishing the outcome of each probe. The others find the outcomes in the
+ * region instead of probing, and take over the lease if it is not renewed in time.
+ *
+ * Hosts and leases are identified by a 64-bit key, which the health checker derives from its
+ * cluster and its configuration, and for a host from the host's address. Each lease takes a slot
+ * like a host. Slots are claimed lock-free and are never released, so the region must be sized
+ * for every host and health check over the lifetime of the processes sharing it.
+ */
+class SharedHealthCheckResults {
+public:
+  enum class Outcome : uint8_t { Healthy = 1, Degraded = 2, Unhealthy = 3 };
+
+  struct Result {
+    Outcome outcome_;
+    envoy::data::core::v3::HealthCheckFailureType failure_type_;
+    bool retriable_;
+    // Incremented each time a result is published for the host, so that readers can tell a new
+    // result from one they have already applied.
+    uint64_t sequence_;
+  };
+
+  struct Slot {
+    std::atomic<uint64_t> key_;
+    // The result of a host, or the holder and expiry time of a lease.
+    std::atomic<uint64_t> result_;
+  };
+
+  // The largest identifier of a process holding a lease. Each attachment to the region takes the
+  // next identifier, wrapping around after MaxOwner.
+  static constexpr uint64_t MaxOwner = (1 << 20) - 1;
+
+  /**
+   * @param capacity the number of hosts the region can hold, rounded up to a power of two.
+   * @return the number of bytes of memory needed for a region of the given capacity.
+   */
+  static uint64_t bytesRequired(uint64_t capacity);
+
+  /**
+   * Lays out an empty region in zero-filled memory, or attaches to the region another process
+   * has laid out in it. Safe to call from several processes at once.
+   * @param memory the region's memory, aligned to 8 bytes.
+   * @param size the number of bytes of memory mapped.
+   * @param capacity the capacity to lay the region out with, if it is empty.
+   * @param timeout how long to wait for another process to finish laying the region out.
+   * @return the region, or an error if the memory holds an incompatible region, or one which
+   *         was not laid out in time.
+   */
+  static absl::StatusOr<std::unique_ptr<SharedHealthCheckResults>>
+  initialize(void* memory, uint64_t size, uint64_t capacity, std::chrono::milliseconds timeout);
+
+  /**
+   * Maps the region held in a file, creating the file if it does not exist. The health checkers
+   * of a process which use the same file share one mapping.
+   * @param path the path of the file.
+   * @param capacity the capacity to lay the region out with, if the file is new.
+   * @return the region, or an error if the file could not be mapped.
+   */
+  static absl::StatusOr<std::shared_ptr<SharedHealthCheckResults>> open(const std::string& path,
+                                                                        uint64_t capacity);
+
+  /**
+   * Publishes the outcome of a probe of a host.
+   * @return the sequence number of the published result, or 0 if the region is full.
+   */
+  uint64_t publish(uint64_t key, Outcome outcome,
+               envoy::data::core::v3::HealthCheckFailureType failure_type, bool retriable);
+
+  /**
+   * @return the latest result published for a host, if any.
+   */
+  absl::optional<Result> find(uint64_t key) const;
+
+  /**
+   * Renews a lease if this process holds it and less than half of it is left, or takes it over if
+   * it has expired. The lease is only read otherwise.
+   * @param key identifies the lease, e.g. a health check.
+   * @param now the current wall clock time, which is comparable across processes.
+   * @param duration how long the lease lasts without being renewed.
+   * @return whether this process holds the lease, and so should probe the hosts. Also true if the
+   *         region is full, so that the hosts are probed by every process rather than by none.
+   */
+  bool holdLease(uint64_t key, SystemTime now, std::chrono::milliseconds duration);
+
+  /**
+   * @return the number of hosts the region can hold.
+   */
+  uint64_t capacity() const;
+
+  /**
+   * @return the number of slots in use.
+   */
+  uint64_t size() const;
+
+private:
+  struct Header;
+
+  static const Memory::SharedRegion& layout();
+
+  SharedHealthCheckResults(void* memory, uint64_t owner);
+
+  Slot* findSlot(uint64_t key, bool allocate) const;
+
+  Header* header_;
+  Slot* slots_;
+  const uint64_t owner_;
+};
+
+using SharedHealthCheckResultsSharedPtr = std::shared_ptr<SharedHealthCheckResults>;
+
+} // namespace Upstream
+} // namespace Envoy
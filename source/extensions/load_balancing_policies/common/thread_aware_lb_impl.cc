@@ -172,8 +172,9 @@ void ThreadAwareLoadBalancerBase::refresh() {
     double max_normalized_weight = 0.0;
     normalizeWeights(*host_set, per_priority_state->global_panic_, normalized_host_weights,
                      min_normalized_weight, max_normalized_weight, locality_weighted_balancing_);
-    per_priority_state->current_lb_ = createLoadBalancer(
-        std::move(normalized_host_weights), min_normalized_weight, max_normalized_weight);
+    per_priority_state->current_lb_ =
+        createLoadBalancer(priority, std::move(normalized_host_weights), min_normalized_weight,
+                           max_normalized_weight);
   }
 
   {
@@ -297,7 +298,7 @@ ThreadAwareLoadBalancerBase::BoundedLoadHashingLoadBalancer::chooseHost(uint64_t
   if (host == nullptr) {
     return {nullptr};
   }
-  const double weight = normalized_host_weights_map_.at(host);
+  const double weight = normalized_host_weights_map_.at(host.get());
   double overload_factor = hostOverloadFactor(*host, weight);
   if (overload_factor <= 1.0) {
     ENVOY_LOG_MISC(debug,
@@ -310,11 +311,15 @@ ThreadAwareLoadBalancerBase::BoundedLoadHashingLoadBalancer::chooseHost(uint64_t
   // When a host is overloaded, we choose the next host in a random manner rather than picking the
   // next one in the ring. The random sequence is seeded by the hash, so the same input gets the
   // same sequence of hosts all the time.
+  //
+  // Only the positions of the shuffle which have been swapped are stored, so that a pick which
+  // finds an eligible host after a few probes doesn't pay for a permutation of all of the hosts.
   const uint32_t num_hosts = normalized_host_weights_.size();
-  auto host_index = std::vector<uint32_t>(num_hosts);
-  for (uint32_t i = 0; i < num_hosts; i++) {
-    host_index[i] = i;
-  }
+  absl::flat_hash_map<uint32_t, uint32_t> swapped_host_index;
+  const auto host_index = [&swapped_host_index](uint32_t i) -> uint32_t {
+    const auto it = swapped_host_index.find(i);
+    return it == swapped_host_index.end() ? i : it->second;
+  };
 
   // Not using Random::RandomGenerator as it does not take a seed. Seeded RNG is a requirement
   // here as we need the same shuffle sequence for the same hash every time.
@@ -337,9 +342,10 @@ ThreadAwareLoadBalancerBase::BoundedLoadHashingLoadBalancer::chooseHost(uint64_t
   for (uint32_t i = 0; i < num_hosts; i++) {
     // The random shuffle algorithm
     const uint32_t j = uniform_int(random, num_hosts - i);
-    std::swap(host_index[i], host_index[i + j]);
-
-    const uint32_t k = host_index[i];
+    const uint32_t k = host_index(i + j);
+    if (j != 0) {
+      swapped_host_index[i + j] = host_index(i);
+    }
     alt_host = normalized_host_weights_[k].first;
     if (alt_host == host) {
       continue;
@@ -11,6 +11,7 @@
 #include "source/common/http/hash_policy.h"
 #include "source/extensions/load_balancing_policies/common/load_balancer_impl.h"
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/strings/string_view.h"
 #include "absl/synchronization/mutex.h"
 
@@ -18,7 +19,7 @@ namespace Envoy {
 namespace Upstream {
 
 using NormalizedHostWeightVector = std::vector<std::pair<HostConstSharedPtr, double>>;
-using NormalizedHostWeightMap = std::map<HostConstSharedPtr, double>;
+using NormalizedHostWeightMap = absl::flat_hash_map<const Host*, double>;
 
 using HashPolicyProto = envoy::config::route::v3::RouteAction::HashPolicy;
 using HashPolicySharedPtr = std::shared_ptr<Http::HashPolicy>;
@@ -81,8 +82,9 @@ public:
     const NormalizedHostWeightMap
     initNormalizedHostWeightMap(const NormalizedHostWeightVector& normalized_host_weights) {
       NormalizedHostWeightMap normalized_host_weights_map;
+      normalized_host_weights_map.reserve(normalized_host_weights.size());
       for (auto const& item : normalized_host_weights) {
-        normalized_host_weights_map[item.first] = item.second;
+        normalized_host_weights_map[item.first.get()] = item.second;
       }
       return normalized_host_weights_map;
     }
@@ -174,7 +176,7 @@ private:
   };
 
   virtual HashingLoadBalancerSharedPtr
-  createLoadBalancer(const NormalizedHostWeightVector& normalized_host_weights,
+  createLoadBalancer(uint32_t priority, const NormalizedHostWeightVector& normalized_host_weights,
                      double min_normalized_weight, double max_normalized_weight) PURE;
   void refresh();
 
@@ -0,0 +1,16 @@
+#include "source/extensions/load_balancing_policies/least_latency/config.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace LoadBalancingPolicies {
+namespace LeastLatency {
+
+/**
+ * Static registration for the Factory. @see RegisterFactory.
+ */
+REGISTER_FACTORY(Factory, Upstream::TypedLoadBalancerFactory);
+
+} // namespace LeastLatency
+} // namespace LoadBalancingPolicies
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "envoy/extensions/load_balancing_policies/least_latency/v3/least_latency.pb.h"
+#include "envoy/extensions/load_balancing_policies/least_latency/v3/least_latency.pb.validate.h"
+#include "envoy/server/factory_context.h"
+#include "envoy/upstream/load_balancer.h"
+
+#include "source/common/upstream/load_balancer_factory_base.h"
+#include "source/extensions/load_balancing_policies/least_latency/least_latency_lb.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace LoadBalancingPolicies {
+namespace LeastLatency {
+
+using LeastLatencyLbProto =
+    envoy::extensions::load_balancing_policies::least_latency::v3::LeastLatency;
+
+class Factory : public Upstream::TypedLoadBalancerFactoryBase<LeastLatencyLbProto> {
+public:
+  Factory()
+      : Upstream::TypedLoadBalancerFactoryBase<LeastLatencyLbProto>(
+            "envoy.load_balancing_policies.least_latency") {}
+
+  Upstream::ThreadAwareLoadBalancerPtr create(OptRef<const Upstream::LoadBalancerConfig> lb_config,
+                                              const Upstream::ClusterInfo& cluster_info,
+                                              const Upstream::PrioritySet& priority_set,
+                                              Runtime::Loader& runtime,
+                                              Envoy::Random::RandomGenerator& random,
+                                              TimeSource& time_source) override {
+    return std::make_unique<Upstream::LeastLatencyLoadBalancer>(
+        lb_config, cluster_info, priority_set, runtime, random, time_source);
+  }
+
+  absl::StatusOr<Upstream::LoadBalancerConfigPtr>
+  loadConfig(Server::Configuration::ServerFactoryContext&,
+             const Protobuf::Message& config) override {
+    ASSERT(dynamic_cast<const LeastLatencyLbProto*>(&config) != nullptr);
+    const LeastLatencyLbProto& typed_config = dynamic_cast<const LeastLatencyLbProto&>(config);
+    return Upstream::LoadBalancerConfigPtr{new Upstream::LeastLatencyLbConfig(typed_config)};
+  }
+};
+
+DECLARE_FACTORY(Factory);
+
+} // namespace LeastLatency
+} // namespace LoadBalancingPolicies
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,150 @@
+#include "source/extensions/load_balancing_policies/least_latency/least_latency_lb.h"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+
+#include "source/common/protobuf/utility.h"
+
+namespace Envoy {
+namespace Upstream {
+
+LeastLatencyLbConfig::LeastLatencyLbConfig(const LeastLatencyLbProto& lb_proto)
+    : lb_config_(lb_proto),
+      decay_time_(
+          std::chrono::milliseconds(PROTOBUF_GET_MS_OR_DEFAULT(lb_proto, decay_time, 10000))),
+      default_latency_(
+          std::chrono::milliseconds(PROTOBUF_GET_MS_OR_DEFAULT(lb_proto, default_latency, 10))),
+      failure_latency_(
+          std::chrono::milliseconds(PROTOBUF_GET_MS_OR_DEFAULT(lb_proto, failure_latency, 1000))),
+      choice_count_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(lb_proto, choice_count, 2)) {}
+
+void LeastLatencyHostLbPolicyData::onUpstreamResponseLatency(std::chrono::microseconds latency,
+                                                             MonotonicTime received_time) {
+  const int64_t now_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                             received_time.time_since_epoch())
+                             .count();
+  const int64_t last_ns = last_sample_ns_.exchange(now_ns, std::memory_order_relaxed);
+  const double sample_us = latency.count();
+  if (last_ns == NoSamples) {
+    ewma_us_.store(sample_us, std::memory_order_relaxed);
+    return;
+  }
+  // Samples from other workers may arrive out of order, and are then weighted as if they arrived
+  // at the same time as the previous one.
+  const double weight = decayFactor(now_ns - last_ns);
+  double ewma_us = ewma_us_.load(std::memory_order_relaxed);
+  double updated_us;
+  do {
+    // A sample above the average replaces it, so that a host which slows down is avoided at once.
+    updated_us = sample_us > ewma_us ? sample_us : ewma_us * weight + sample_us * (1 - weight);
+  } while (!ewma_us_.compare_exchange_weak(ewma_us, updated_us, std::memory_order_relaxed));
+}
+
+void LeastLatencyHostLbPolicyData::onUpstreamRequestFailure(std::chrono::microseconds elapsed,
+                                                            MonotonicTime failure_time) {
+  onUpstreamResponseLatency(std::max(elapsed, failure_latency_), failure_time);
+}
+
+absl::optional<double> LeastLatencyHostLbPolicyData::latency(MonotonicTime now) const {
+  const int64_t last_ns = last_sample_ns_.load(std::memory_order_relaxed);
+  if (last_ns == NoSamples) {
+    return absl::nullopt;
+  }
+  const int64_t now_ns =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(now.time_since_epoch()).count();
+  // Stale samples say little about the host, so a host which was slow is retried eventually, and
+  // one which was fast is no longer favored.
+  return default_latency_us_ +
+         (ewma_us_.load(std::memory_order_relaxed) - default_latency_us_) *
+             decayFactor(now_ns - last_ns);
+}
+
+double LeastLatencyHostLbPolicyData::decayFactor(int64_t elapsed_ns) const {
+  return elapsed_ns > 0 ? std::exp(-elapsed_ns / decay_time_ns_) : 1.0;
+}
+
+LeastLatencyLoadBalancer::WorkerLocalLb::WorkerLocalLb(
+    const PrioritySet& priority_set, const PrioritySet* local_priority_set, ClusterLbStats& stats,
+    Runtime::Loader& runtime, Random::RandomGenerator& random, uint32_t healthy_panic_threshold,
+    const LeastLatencyLbConfig& lb_config, TimeSource& time_source)
+    : ZoneAwareLoadBalancerBase(
+          priority_set, local_priority_set, stats, runtime, random, healthy_panic_threshold,
+          LoadBalancerConfigHelper::localityLbConfigFromProto(lb_config.lb_config_)),
+      choice_count_(lb_config.choice_count_),
+      default_latency_us_(lb_config.default_latency_.count()), time_source_(time_source) {}
+
+double LeastLatencyLoadBalancer::WorkerLocalLb::cost(const Host& host, MonotonicTime now) const {
+  absl::optional<double> latency_us;
+  if (auto data = host.typedLbPolicyData<LeastLatencyHostLbPolicyData>(); data.has_value()) {
+    latency_us = data->latency(now);
+  }
+  return latency_us.value_or(default_latency_us_) * (host.stats().rq_active_.value() + 1);
+}
+
+HostConstSharedPtr
+LeastLatencyLoadBalancer::WorkerLocalLb::chooseHostOnce(LoadBalancerContext* context) {
+  const uint64_t random_hash = random(false);
+  const absl::optional<HostsSource> hosts_source = hostSourceToUse(context, random_hash);
+  if (!hosts_source) {
+    return nullptr;
+  }
+
+  const HostVector& hosts_to_use = hostSourceToHosts(*hosts_source);
+  if (hosts_to_use.empty()) {
+    return nullptr;
+  }
+
+  const MonotonicTime now = time_source_.monotonicTime();
+  const HostSharedPtr* candidate_host = &hosts_to_use[random_hash % hosts_to_use.size()];
+  double candidate_cost = cost(**candidate_host, now);
+  for (uint32_t choice_idx = 1; choice_idx < choice_count_; ++choice_idx) {
+    const HostSharedPtr& sampled_host = hosts_to_use[random_.random() % hosts_to_use.size()];
+    const double sampled_cost = cost(*sampled_host, now);
+    if (sampled_cost < candidate_cost) {
+      candidate_host = &sampled_host;
+      candidate_cost = sampled_cost;
+    }
+  }
+  return *candidate_host;
+}
+
+Upstream::LoadBalancerPtr
+LeastLatencyLoadBalancer::WorkerLocalLbFactory::create(Upstream::LoadBalancerParams params) {
+  return std::make_unique<WorkerLocalLb>(
+      params.priority_set, params.local_priority_set, cluster_info_.lbStats(), runtime_, random_,
+      PROTOBUF_PERCENT_TO_ROUNDED_INTEGER_OR_DEFAULT(cluster_info_.lbConfig(),
+                                                     healthy_panic_threshold, 100, 50),
+      lb_config_, time_source_);
+}
+
+LeastLatencyLoadBalancer::LeastLatencyLoadBalancer(
+    OptRef<const Upstream::LoadBalancerConfig> lb_config, const Upstream::ClusterInfo& cluster_info,
+    const Upstream::PrioritySet& priority_set, Runtime::Loader& runtime,
+    Envoy::Random::RandomGenerator& random, TimeSource& time_source)
+    : lb_config_(dynamic_cast<const LeastLatencyLbConfig&>(*lb_config)),
+      priority_set_(priority_set),
+      factory_(std::make_shared<WorkerLocalLbFactory>(lb_config_, cluster_info, runtime, random,
+                                                      time_source)) {}
+
+absl::Status LeastLatencyLoadBalancer::initialize() {
+  for (const auto& host_set : priority_set_.hostSetsPerPriority()) {
+    addLbPolicyDataToHosts(host_set->hosts());
+  }
+  priority_update_cb_ = priority_set_.addPriorityUpdateCb(
+      [this](uint32_t, const HostVector& hosts_added, const HostVector&) {
+        addLbPolicyDataToHosts(hosts_added);
+      });
+  return absl::OkStatus();
+}
+
+void LeastLatencyLoadBalancer::addLbPolicyDataToHosts(const HostVector& hosts) {
+  for (const auto& host : hosts) {
+    if (!host->typedLbPolicyData<LeastLatencyHostLbPolicyData>().has_value()) {
+      host->addLbPolicyData(std::make_unique<LeastLatencyHostLbPolicyData>(lb_config_));
+    }
+  }
+}
+
+} // namespace Upstream
+} // namespace Envoy
@@ -0,0 +1,150 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <memory>
+
+#include "envoy/common/time.h"
+#include "envoy/extensions/load_balancing_policies/least_latency/v3/least_latency.pb.h"
+#include "envoy/upstream/upstream.h"
+
+#include "source/common/common/callback_impl.h"
+#include "source/common/common/logger.h"
+#include "source/extensions/load_balancing_policies/common/load_balancer_impl.h"
+
+#include "absl/status/status.h"
+#include "absl/types/optional.h"
+
+namespace Envoy {
+namespace Upstream {
+
+using LeastLatencyLbProto =
+    envoy::extensions::load_balancing_policies::least_latency::v3::LeastLatency;
+
+/**
+ * Load balancer config used to wrap the config proto.
+ */
+class LeastLatencyLbConfig : public Upstream::LoadBalancerConfig {
+public:
+  LeastLatencyLbConfig(const LeastLatencyLbProto& lb_proto);
+
+  LeastLatencyLbProto lb_config_;
+  std::chrono::nanoseconds decay_time_;
+  std::chrono::microseconds default_latency_;
+  std::chrono::microseconds failure_latency_;
+  uint32_t choice_count_;
+};
+
+/**
+ * The per host state of the least latency load balancer: a peak exponentially weighted moving
+ * average of the response latency of the host. A request which fails without a response counts as
+ * a response with the failure latency, or the time it took to fail if longer. The state is shared
+ * by the load balancers of all the workers, and is updated without locking.
+ */
+class LeastLatencyHostLbPolicyData : public HostLbPolicyData {
+public:
+  explicit LeastLatencyHostLbPolicyData(const LeastLatencyLbConfig& lb_config)
+      : decay_time_ns_(lb_config.decay_time_.count()),
+        default_latency_us_(lb_config.default_latency_.count()),
+        failure_latency_(lb_config.failure_latency_) {}
+
+  // Upstream::HostLbPolicyData
+  bool receivesOrcaLoadReport() const override { return false; }
+  void onUpstreamResponseLatency(std::chrono::microseconds latency,
+                                 MonotonicTime received_time) override;
+  void onUpstreamRequestFailure(std::chrono::microseconds elapsed,
+                                MonotonicTime failure_time) override;
+
+  /**
+   * @return the average latency in microseconds, decayed towards the default latency as of the
+   *         given time, or absl::nullopt if no latency has been reported yet.
+   */
+  absl::optional<double> latency(MonotonicTime now) const;
+
+private:
+  static constexpr int64_t NoSamples = std::numeric_limits<int64_t>::min();
+
+  double decayFactor(int64_t elapsed_ns) const;
+
+  const double decay_time_ns_;
+  const double default_latency_us_;
+  const std::chrono::microseconds failure_latency_;
+  std::atomic<double> ewma_us_{0};
+  // The time of the last sample in nanoseconds since the epoch of the monotonic clock. The average
+  // and the time are not updated together, so a reader may pair a new time with an old average,
+  // which only makes the average decay a little less for that read.
+  std::atomic<int64_t> last_sample_ns_{NoSamples};
+};
+
+/**
+ * A load balancer which picks the host with the lowest latency cost out of a number of randomly
+ * chosen hosts. The cost of a host is its peak EWMA latency multiplied by its active requests plus
+ * one, so that both slow and busy hosts are avoided.
+ */
+class LeastLatencyLoadBalancer : public Upstream::ThreadAwareLoadBalancer,
+                                 protected Logger::Loggable<Logger::Id::upstream> {
+public:
+  // This class is used to handle the load balancing on the worker thread.
+  class WorkerLocalLb : public ZoneAwareLoadBalancerBase {
+  public:
+    WorkerLocalLb(const PrioritySet& priority_set, const PrioritySet* local_priority_set,
+                  ClusterLbStats& stats, Runtime::Loader& runtime, Random::RandomGenerator& random,
+                  uint32_t healthy_panic_threshold, const LeastLatencyLbConfig& lb_config,
+                  TimeSource& time_source);
+
+    // Upstream::ZoneAwareLoadBalancerBase
+    HostConstSharedPtr chooseHostOnce(LoadBalancerContext* context) override;
+    HostConstSharedPtr peekAnotherHost(LoadBalancerContext*) override { return nullptr; }
+
+  private:
+    double cost(const Host& host, MonotonicTime now) const;
+
+    const uint32_t choice_count_;
+    const double default_latency_us_;
+    TimeSource& time_source_;
+  };
+
+  // Factory used to create worker-local load balancer on the worker thread.
+  class WorkerLocalLbFactory : public Upstream::LoadBalancerFactory {
+  public:
+    WorkerLocalLbFactory(const LeastLatencyLbConfig& lb_config,
+                         const Upstream::ClusterInfo& cluster_info, Runtime::Loader& runtime,
+                         Envoy::Random::RandomGenerator& random, TimeSource& time_source)
+        : lb_config_(lb_config), cluster_info_(cluster_info), runtime_(runtime), random_(random),
+          time_source_(time_source) {}
+
+    Upstream::LoadBalancerPtr create(Upstream::LoadBalancerParams params) override;
+
+    bool recreateOnHostChange() const override { return false; }
+
+  private:
+    const LeastLatencyLbConfig& lb_config_;
+    const Upstream::ClusterInfo& cluster_info_;
+    Runtime::Loader& runtime_;
+    Envoy::Random::RandomGenerator& random_;
+    TimeSource& time_source_;
+  };
+
+  LeastLatencyLoadBalancer(OptRef<const Upstream::LoadBalancerConfig> lb_config,
+                           const Upstream::ClusterInfo& cluster_info,
+                           const Upstream::PrioritySet& priority_set, Runtime::Loader& runtime,
+                           Envoy::Random::RandomGenerator& random, TimeSource& time_source);
+
+  // Upstream::ThreadAwareLoadBalancer
+  Upstream::LoadBalancerFactorySharedPtr factory() override { return factory_; }
+  absl::Status initialize() override;
+
+private:
+  // Attaches the latency state to the given hosts, on the main thread.
+  void addLbPolicyDataToHosts(const HostVector& hosts);
+
+  const LeastLatencyLbConfig& lb_config_;
+  const Upstream::PrioritySet& priority_set_;
+  std::shared_ptr<WorkerLocalLbFactory> factory_;
+  Envoy::Common::CallbackHandlePtr priority_update_cb_;
+};
+
+} // namespace Upstream
+} // namespace Envoy
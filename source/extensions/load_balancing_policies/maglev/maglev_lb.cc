@@ -1,5 +1,10 @@
 #include "source/extensions/load_balancing_policies/maglev/maglev_lb.h"
 
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <utility>
+
 #include "envoy/config/cluster/v3/cluster.pb.h"
 
 #include "source/common/runtime/runtime_features.h"
@@ -7,6 +12,24 @@
 namespace Envoy {
 namespace Upstream {
 namespace {
+
+// The assignment of a slot which is yet to be assigned to a host.
+constexpr uint32_t UnassignedSlot = std::numeric_limits<uint32_t>::max();
+
+// Returns the multiplicative inverse of value modulo a prime modulus, with which the position of a
+// slot in a host's permutation can be computed.
+uint64_t modularInverse(uint64_t value, uint64_t modulus) {
+  int64_t t = 0;
+  int64_t new_t = 1;
+  int64_t r = modulus;
+  int64_t new_r = value % modulus;
+  while (new_r != 0) {
+    const int64_t quotient = r / new_r;
+    t = std::exchange(new_t, t - quotient * new_t);
+    r = std::exchange(new_r, r - quotient * new_r);
+  }
+  return t < 0 ? t + modulus : t;
+}
 bool shouldUseCompactTable(size_t num_hosts, uint64_t table_size) {
   // Don't use compact maglev on 32-bit platforms.
   if constexpr (!(ENVOY_BIT_ARRAY_SUPPORTED)) {
@@ -38,19 +61,22 @@ public:
   static MaglevTableSharedPtr
   createMaglevTable(const NormalizedHostWeightVector& normalized_host_weights,
                     double max_normalized_weight, uint64_t table_size,
-                    bool use_hostname_for_hashing, MaglevLoadBalancerStats& stats) {
+                    bool use_hostname_for_hashing, MaglevLoadBalancerStats& stats,
+                    const MaglevTable* previous_table) {
 
     MaglevTableSharedPtr maglev_table;
     if (shouldUseCompactTable(normalized_host_weights.size(), table_size)) {
-      maglev_table =
-          std::make_shared<CompactMaglevTable>(normalized_host_weights, max_normalized_weight,
-                                               table_size, use_hostname_for_hashing, stats);
+      maglev_table = std::make_shared<CompactMaglevTable>(normalized_host_weights,
+                                                          max_normalized_weight, table_size,
+                                                          use_hostname_for_hashing, stats,
+                                                          previous_table);
       ENVOY_LOG(debug, "creating compact maglev table given table size {} and number of hosts {}",
                 table_size, normalized_host_weights.size());
     } else {
-      maglev_table =
-          std::make_shared<OriginalMaglevTable>(normalized_host_weights, max_normalized_weight,
-                                                table_size, use_hostname_for_hashing, stats);
+      maglev_table = std::make_shared<OriginalMaglevTable>(normalized_host_weights,
+                                                           max_normalized_weight, table_size,
+                                                           use_hostname_for_hashing, stats,
+                                                           previous_table);
       ENVOY_LOG(debug, "creating original maglev table given table size {} and number of hosts {}",
                 table_size, normalized_host_weights.size());
     }
@@ -80,12 +106,23 @@ TypedMaglevLbConfig::TypedMaglevLbConfig(const MaglevLbProto& lb_config,
       lb_config_(lb_config) {}
 
 ThreadAwareLoadBalancerBase::HashingLoadBalancerSharedPtr
-MaglevLoadBalancer::createLoadBalancer(const NormalizedHostWeightVector& normalized_host_weights,
+MaglevLoadBalancer::createLoadBalancer(uint32_t priority,
+                                       const NormalizedHostWeightVector& normalized_host_weights,
                                        double /* min_normalized_weight */,
                                        double max_normalized_weight) {
-  HashingLoadBalancerSharedPtr maglev_lb =
+  const MaglevTable* previous_table = nullptr;
+  if (incremental_table_rebuild_) {
+    if (priority >= previous_tables_.size()) {
+      previous_tables_.resize(priority + 1);
+    }
+    previous_table = previous_tables_[priority].get();
+  }
+  MaglevTableSharedPtr maglev_lb =
       MaglevFactory::createMaglevTable(normalized_host_weights, max_normalized_weight, table_size_,
-                                       use_hostname_for_hashing_, stats_);
+                                       use_hostname_for_hashing_, stats_, previous_table);
+  if (incremental_table_rebuild_) {
+    previous_tables_[priority] = maglev_lb;
+  }
 
   if (hash_balance_factor_ == 0) {
     return maglev_lb;
@@ -97,7 +134,7 @@ MaglevLoadBalancer::createLoadBalancer(const NormalizedHostWeightVector& normali
 
 void MaglevTable::constructMaglevTableInternal(
     const NormalizedHostWeightVector& normalized_host_weights, double max_normalized_weight,
-    bool use_hostname_for_hashing) {
+    bool use_hostname_for_hashing, const MaglevTable* previous_table) {
   // We can't do anything sensible with no hosts.
   if (normalized_host_weights.empty()) {
     ENVOY_LOG(debug, "maglev: normalized hosts weights is empty, skipping building table");
@@ -132,7 +169,18 @@ void MaglevTable::constructMaglevTableInternal(
                                      weight);
   }
 
-  constructImplementationInternals(table_build_entries, max_normalized_weight);
+  if (previous_table != nullptr && previous_table->hasHosts()) {
+    absl::flat_hash_map<absl::string_view, uint32_t> entry_index_by_key;
+    entry_index_by_key.reserve(sorted_host_weights.size());
+    for (uint32_t i = 0; i < sorted_host_weights.size(); ++i) {
+      entry_index_by_key.emplace(std::get<0>(sorted_host_weights[i]), i);
+    }
+    constructImplementationFromAssignment(
+        table_build_entries, incrementalAssignment(*previous_table, table_build_entries,
+                                                   entry_index_by_key, use_hostname_for_hashing));
+  } else {
+    constructImplementationInternals(table_build_entries, max_normalized_weight);
+  }
 
   // Update Stats
   uint64_t min_entries_per_host = table_size_;
@@ -149,6 +197,144 @@ void MaglevTable::constructMaglevTableInternal(
   }
 }
 
+std::vector<uint32_t> MaglevTable::incrementalAssignment(
+    const MaglevTable& previous_table, std::vector<TableBuildEntry>& table_build_entries,
+    const absl::flat_hash_map<absl::string_view, uint32_t>& entry_index_by_key,
+    bool use_hostname_for_hashing) {
+  const uint32_t num_entries = table_build_entries.size();
+
+  // The number of slots each host is entitled to, in proportion to its weight, with the slots left
+  // over by rounding down going to the hosts with the largest remainders.
+  double total_weight = 0;
+  for (const auto& entry : table_build_entries) {
+    total_weight += entry.weight_;
+  }
+  std::vector<uint64_t> targets(num_entries);
+  std::vector<std::pair<double, uint32_t>> remainders;
+  remainders.reserve(num_entries);
+  uint64_t targeted = 0;
+  for (uint32_t i = 0; i < num_entries; ++i) {
+    const double share = table_build_entries[i].weight_ / total_weight * table_size_;
+    targets[i] = static_cast<uint64_t>(share);
+    targeted += targets[i];
+    remainders.emplace_back(share - targets[i], i);
+  }
+  std::sort(remainders.begin(), remainders.end(), [](const auto& a, const auto& b) {
+    return a.first > b.first || (a.first == b.first && a.second < b.second);
+  });
+  for (uint32_t i = 0; targeted < table_size_; i = (i + 1) % num_entries) {
+    ++targets[remainders[i].second];
+    ++targeted;
+  }
+  // Rounding errors in the shares may leave the targets over the table size by a slot.
+  for (uint32_t i = num_entries - 1; targeted > table_size_;
+       i = (i + num_entries - 1) % num_entries) {
+    if (targets[remainders[i].second] > 0) {
+      --targets[remainders[i].second];
+      --targeted;
+    }
+  }
+
+  // Keep the slots of the hosts which remain. Hosts are looked up by their hash key once each.
+  std::vector<uint32_t> assignment(table_size_, UnassignedSlot);
+  absl::flat_hash_map<const Host*, uint32_t> entry_index_by_previous_host;
+  const Host* last_host = nullptr;
+  uint32_t last_index = UnassignedSlot;
+  for (uint64_t slot = 0; slot < table_size_; ++slot) {
+    const HostConstSharedPtr& host = previous_table.hostAtSlot(slot);
+    if (host.get() != last_host) {
+      auto [it, inserted] = entry_index_by_previous_host.try_emplace(host.get(), UnassignedSlot);
+      if (inserted) {
+        const auto entry_it = entry_index_by_key.find(hashKey(host, use_hostname_for_hashing));
+        if (entry_it != entry_index_by_key.end()) {
+          it->second = entry_it->second;
+        }
+      }
+      last_host = host.get();
+      last_index = it->second;
+    }
+    if (last_index != UnassignedSlot) {
+      assignment[slot] = last_index;
+      table_build_entries[last_index].count_++;
+    }
+  }
+
+  // A host which owns more slots than it is entitled to gives up those which come last in its
+  // permutation, which a build from scratch would be the least likely to assign to it.
+  std::vector<std::vector<std::pair<uint64_t, uint64_t>>> excess_slots(num_entries);
+  std::vector<uint64_t> inverse_skips(num_entries);
+  bool any_excess = false;
+  for (uint32_t i = 0; i < num_entries; ++i) {
+    if (table_build_entries[i].count_ > targets[i]) {
+      inverse_skips[i] = modularInverse(table_build_entries[i].skip_, table_size_);
+      any_excess = true;
+    }
+  }
+  if (any_excess) {
+    for (uint64_t slot = 0; slot < table_size_; ++slot) {
+      const uint32_t i = assignment[slot];
+      if (i == UnassignedSlot || table_build_entries[i].count_ <= targets[i]) {
+        continue;
+      }
+      const TableBuildEntry& entry = table_build_entries[i];
+      const uint64_t position =
+          ((slot + table_size_ - entry.offset_) % table_size_) * inverse_skips[i] % table_size_;
+      excess_slots[i].emplace_back(position, slot);
+    }
+    for (uint32_t i = 0; i < num_entries; ++i) {
+      auto& slots = excess_slots[i];
+      if (slots.empty()) {
+        continue;
+      }
+      const uint64_t excess = table_build_entries[i].count_ - targets[i];
+      std::nth_element(slots.begin(), slots.begin() + excess, slots.end(),
+                       std::greater<std::pair<uint64_t, uint64_t>>());
+      for (uint64_t k = 0; k < excess; ++k) {
+        assignment[slots[k].second] = UnassignedSlot;
+      }
+      table_build_entries[i].count_ = targets[i];
+    }
+  }
+
+  // Hand out the unassigned slots as a build from scratch would, with the hosts which are short of
+  // their share taking turns to claim the next unassigned slot in their permutation. The number of
+  // unassigned slots is the total shortfall, so every turn finds one.
+  std::vector<uint32_t> short_entries;
+  for (uint32_t i = 0; i < num_entries; ++i) {
+    if (table_build_entries[i].count_ < targets[i]) {
+      short_entries.push_back(i);
+    }
+  }
+  while (!short_entries.empty()) {
+    size_t still_short = 0;
+    for (const uint32_t i : short_entries) {
+      TableBuildEntry& entry = table_build_entries[i];
+      uint64_t c = permutation(entry);
+      while (assignment[c] != UnassignedSlot) {
+        entry.next_++;
+        c = permutation(entry);
+      }
+      assignment[c] = i;
+      entry.next_++;
+      entry.count_++;
+      if (entry.count_ < targets[i]) {
+        short_entries[still_short++] = i;
+      }
+    }
+    short_entries.resize(still_short);
+  }
+  return assignment;
+}
+
+void OriginalMaglevTable::constructImplementationFromAssignment(
+    const std::vector<TableBuildEntry>& table_build_entries,
+    const std::vector<uint32_t>& assignment) {
+  table_.reserve(table_size_);
+  for (const uint32_t index : assignment) {
+    table_.push_back(table_build_entries[index].host_);
+  }
+}
+
 void OriginalMaglevTable::constructImplementationInternals(
     std::vector<TableBuildEntry>& table_build_entries, double max_normalized_weight) {
   // Size internal representation for maglev table correctly.
@@ -183,11 +369,24 @@ void OriginalMaglevTable::constructImplementationInternals(
 CompactMaglevTable::CompactMaglevTable(const NormalizedHostWeightVector& normalized_host_weights,
                                        double max_normalized_weight, uint64_t table_size,
                                        bool use_hostname_for_hashing,
-                                       MaglevLoadBalancerStats& stats)
+                                       MaglevLoadBalancerStats& stats,
+                                       const MaglevTable* previous_table)
     : MaglevTable(table_size, stats),
       table_(absl::bit_width(normalized_host_weights.size()), table_size) {
   constructMaglevTableInternal(normalized_host_weights, max_normalized_weight,
-                               use_hostname_for_hashing);
+                               use_hostname_for_hashing, previous_table);
+}
+
+void CompactMaglevTable::constructImplementationFromAssignment(
+    const std::vector<TableBuildEntry>& table_build_entries,
+    const std::vector<uint32_t>& assignment) {
+  host_table_.reserve(table_build_entries.size());
+  for (const auto& entry : table_build_entries) {
+    host_table_.emplace_back(entry.host_);
+  }
+  for (uint64_t slot = 0; slot < table_size_; ++slot) {
+    table_.set(slot, assignment[slot]);
+  }
 }
 
 void CompactMaglevTable::constructImplementationInternals(
@@ -311,7 +510,8 @@ MaglevLoadBalancer::MaglevLoadBalancer(const PrioritySet& priority_set, ClusterL
               ? config.consistent_hashing_lb_config().use_hostname_for_hashing()
               : false),
       hash_balance_factor_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config.consistent_hashing_lb_config(),
-                                                           hash_balance_factor, 0)) {
+                                                           hash_balance_factor, 0)),
+      incremental_table_rebuild_(config.incremental_table_rebuild()) {
   ENVOY_LOG(debug, "maglev table size: {}", table_size_);
   // The table size must be prime number.
   if (!Primes::isPrime(table_size_)) {
@@ -12,6 +12,8 @@
 #include "source/common/common/bit_array.h"
 #include "source/extensions/load_balancing_policies/common/thread_aware_lb_impl.h"
 
+#include "absl/container/flat_hash_map.h"
+
 namespace Envoy {
 namespace Upstream {
 
@@ -89,21 +91,53 @@ protected:
   uint64_t permutation(const TableBuildEntry& entry);
 
   /**
-   * Template method for constructing the Maglev table.
+   * Template method for constructing the Maglev table. If a previous table is given, the table is
+   * built incrementally from it rather than from scratch: the slots of the hosts which remain keep
+   * their assignments, and only the slots of removed hosts, and of hosts which now own more than
+   * their share, are reassigned.
    */
   void constructMaglevTableInternal(const NormalizedHostWeightVector& normalized_host_weights,
-                                    double max_normalized_weight, bool use_hostname_for_hashing);
+                                    double max_normalized_weight, bool use_hostname_for_hashing,
+                                    const MaglevTable* previous_table);
+
+  /**
+   * @return whether the table assigns its slots to any host.
+   */
+  virtual bool hasHosts() const PURE;
+
+  /**
+   * @return the host assigned to a slot of a table which has hosts.
+   */
+  virtual const HostConstSharedPtr& hostAtSlot(uint64_t slot) const PURE;
 
   const uint64_t table_size_;
   MaglevLoadBalancerStats& stats_;
 
 private:
+  /**
+   * Assigns every slot to the index of a table build entry, keeping the assignments of the
+   * previous table as far as the hosts' shares of the table allow.
+   */
+  std::vector<uint32_t>
+  incrementalAssignment(const MaglevTable& previous_table,
+                        std::vector<TableBuildEntry>& table_build_entries,
+                        const absl::flat_hash_map<absl::string_view, uint32_t>& entry_index_by_key,
+                        bool use_hostname_for_hashing);
+
   /**
    * Implementation specific construction of data structures to represent the
    * Maglev Table.
    */
   virtual void constructImplementationInternals(std::vector<TableBuildEntry>& table_build_entries,
                                                 double max_normalized_weight) PURE;
+
+  /**
+   * Implementation specific construction of data structures to represent the Maglev Table, from
+   * the index of the table build entry assigned to each slot.
+   */
+  virtual void
+  constructImplementationFromAssignment(const std::vector<TableBuildEntry>& table_build_entries,
+                                        const std::vector<uint32_t>& assignment) PURE;
 };
 
 /**
@@ -114,10 +148,11 @@ class OriginalMaglevTable : public MaglevTable {
 public:
   OriginalMaglevTable(const NormalizedHostWeightVector& normalized_host_weights,
                       double max_normalized_weight, uint64_t table_size,
-                      bool use_hostname_for_hashing, MaglevLoadBalancerStats& stats)
+                      bool use_hostname_for_hashing, MaglevLoadBalancerStats& stats,
+                      const MaglevTable* previous_table = nullptr)
       : MaglevTable(table_size, stats) {
     constructMaglevTableInternal(normalized_host_weights, max_normalized_weight,
-                                 use_hostname_for_hashing);
+                                 use_hostname_for_hashing, previous_table);
   }
   ~OriginalMaglevTable() override = default;
 
@@ -126,9 +161,17 @@ public:
 
   void logMaglevTable(bool use_hostname_for_hashing) const override;
 
+protected:
+  // MaglevTable
+  bool hasHosts() const override { return !table_.empty(); }
+  const HostConstSharedPtr& hostAtSlot(uint64_t slot) const override { return table_[slot]; }
+
 private:
   void constructImplementationInternals(std::vector<TableBuildEntry>& table_build_entries,
                                         double max_normalized_weight) override;
+  void
+  constructImplementationFromAssignment(const std::vector<TableBuildEntry>& table_build_entries,
+                                        const std::vector<uint32_t>& assignment) override;
 
   std::vector<HostConstSharedPtr> table_;
 };
@@ -143,7 +186,8 @@ class CompactMaglevTable : public MaglevTable {
 public:
   CompactMaglevTable(const NormalizedHostWeightVector& normalized_host_weights,
                      double max_normalized_weight, uint64_t table_size,
-                     bool use_hostname_for_hashing, MaglevLoadBalancerStats& stats);
+                     bool use_hostname_for_hashing, MaglevLoadBalancerStats& stats,
+                     const MaglevTable* previous_table = nullptr);
   ~CompactMaglevTable() override = default;
 
   // ThreadAwareLoadBalancerBase::HashingLoadBalancer
@@ -151,9 +195,19 @@ public:
 
   void logMaglevTable(bool use_hostname_for_hashing) const override;
 
+protected:
+  // MaglevTable
+  bool hasHosts() const override { return !host_table_.empty(); }
+  const HostConstSharedPtr& hostAtSlot(uint64_t slot) const override {
+    return host_table_[table_.get(slot)];
+  }
+
 private:
   void constructImplementationInternals(std::vector<TableBuildEntry>& table_build_entries,
                                         double max_normalized_weight) override;
+  void
+  constructImplementationFromAssignment(const std::vector<TableBuildEntry>& table_build_entries,
+                                        const std::vector<uint32_t>& assignment) override;
 
   // Leverage a BitArray to more compactly fit represent the MaglevTable.
   // The BitArray will index into the host_table_ which will provide the given
@@ -180,7 +234,7 @@ public:
 private:
   // ThreadAwareLoadBalancerBase
   HashingLoadBalancerSharedPtr
-  createLoadBalancer(const NormalizedHostWeightVector& normalized_host_weights,
+  createLoadBalancer(uint32_t priority, const NormalizedHostWeightVector& normalized_host_weights,
                      double /* min_normalized_weight */, double max_normalized_weight) override;
 
   Stats::ScopeSharedPtr scope_;
@@ -188,6 +242,10 @@ private:
   const uint64_t table_size_;
   const bool use_hostname_for_hashing_;
   const uint32_t hash_balance_factor_;
+  const bool incremental_table_rebuild_;
+  // The last table built for each priority, which the next one is built from if
+  // incremental_table_rebuild_ is set.
+  std::vector<MaglevTableSharedPtr> previous_tables_;
 };
 
 } // namespace Upstream
@@ -71,11 +71,6 @@ public:
 private:
   using HashFunction = RingHashLbProto::HashFunction;
 
-  struct RingEntry {
-    uint64_t hash_;
-    HostConstSharedPtr host_;
-  };
-
   struct Ring : public HashingLoadBalancer {
     Ring(const NormalizedHostWeightVector& normalized_host_weights, double min_normalized_weight,
          uint64_t min_ring_size, uint64_t max_ring_size, HashFunction hash_function,
@@ -84,7 +79,12 @@ private:
     // ThreadAwareLoadBalancerBase::HashingLoadBalancer
     HostSelectionResponse chooseHost(uint64_t hash, uint32_t attempt) const override;
 
-    std::vector<RingEntry> ring_;
+    // The ring is kept as the sorted hashes and, at the same positions, the index into hosts_ of
+    // the host each hash belongs to, so that an entry takes 12 bytes rather than a hash and a host
+    // pointer.
+    std::vector<uint64_t> hashes_;
+    std::vector<uint32_t> host_indices_;
+    std::vector<HostConstSharedPtr> hosts_;
 
     RingHashLoadBalancerStats& stats_;
   };
@@ -92,7 +92,8 @@ private:
 
   // ThreadAwareLoadBalancerBase
   HashingLoadBalancerSharedPtr
-  createLoadBalancer(const NormalizedHostWeightVector& normalized_host_weights,
+  createLoadBalancer(uint32_t /* priority */,
+                     const NormalizedHostWeightVector& normalized_host_weights,
                      double min_normalized_weight, double /* max_normalized_weight */) override {
     HashingLoadBalancerSharedPtr ring_hash_lb =
         std::make_shared<Ring>(normalized_host_weights, min_normalized_weight, min_ring_size_,
@@ -22,6 +22,7 @@
 #include "source/common/protobuf/protobuf.h"
 #include "source/common/protobuf/utility.h"
 #include "source/common/runtime/runtime_features.h"
+#include "source/extensions/network/dns_resolver/cares/sharded_dns_impl.h"
 
 #include "absl/strings/str_join.h"
 #include "ares.h"
@@ -678,6 +679,10 @@ public:
     }
     auto csv_or_error = DnsResolverImpl::maybeBuildResolversCsv(resolvers);
     RETURN_IF_NOT_OK(csv_or_error.status());
+    if (cares.num_resolver_threads().value() > 0) {
+      return std::make_shared<Network::ShardedDnsResolverImpl>(
+          cares, dispatcher, api, csv_or_error.value(), cares.num_resolver_threads().value());
+    }
     return std::make_shared<Network::DnsResolverImpl>(cares, dispatcher, csv_or_error.value(),
                                                       api.rootScope());
   }
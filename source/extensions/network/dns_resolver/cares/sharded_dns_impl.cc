@@ -0,0 +1,167 @@
+#include "source/extensions/network/dns_resolver/cares/sharded_dns_impl.h"
+
+#include "source/common/common/assert.h"
+
+#include "absl/hash/hash.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_join.h"
+
+namespace Envoy {
+namespace Network {
+
+ShardedDnsResolverImpl::ShardedDnsResolverImpl(
+    const envoy::extensions::network::dns_resolver::cares::v3::CaresDnsResolverConfig& config,
+    Event::Dispatcher& dispatcher, Api::Api& api, absl::optional<std::string> resolvers_csv,
+    uint32_t num_shards)
+    : dispatcher_(dispatcher),
+      flush_batches_(dispatcher.createSchedulableCallback([this]() { flushBatches(); })) {
+  ASSERT(num_shards > 0);
+  ENVOY_LOG(debug, "starting c-ares resolver with {} resolver threads", num_shards);
+  shards_.reserve(num_shards);
+  for (uint32_t i = 0; i < num_shards; ++i) {
+    auto shard = std::make_unique<Shard>();
+    shard->dispatcher_ = api.allocateDispatcher(absl::StrCat("dns_cares_", i));
+    // The resolvers and their stats are created here, as the dispatchers are not yet running.
+    shard->resolver_ = std::make_unique<DnsResolverImpl>(config, *shard->dispatcher_,
+                                                         resolvers_csv, api.rootScope());
+    Shard& shard_ref = *shard;
+    shard->flush_completions_ = shard->dispatcher_->createSchedulableCallback(
+        [this, &shard_ref]() { flushCompletions(shard_ref); });
+    shards_.push_back(std::move(shard));
+  }
+  for (uint32_t i = 0; i < num_shards; ++i) {
+    Shard& shard = *shards_[i];
+    shard.thread_ = api.threadFactory().createThread(
+        [&shard]() {
+          shard.dispatcher_->run(Event::Dispatcher::RunType::RunUntilExit);
+          // Any queries still in flight complete with ARES_EDESTRUCTION, and are not reported.
+          shard.resolver_.reset();
+          shard.flush_completions_.reset();
+          shard.completions_.clear();
+          shard.dispatcher_->shutdown();
+        },
+        Thread::Options{absl::StrCat("dns_cares_", i)});
+  }
+}
+
+ShardedDnsResolverImpl::~ShardedDnsResolverImpl() {
+  shutting_down_ = true;
+  for (auto& shard : shards_) {
+    shard->dispatcher_->exit();
+  }
+  for (auto& shard : shards_) {
+    shard->thread_->join();
+  }
+  ENVOY_LOG(debug, "c-ares resolver threads joined");
+}
+
+ActiveDnsQuery* ShardedDnsResolverImpl::resolve(const std::string& dns_name,
+                                                DnsLookupFamily dns_lookup_family,
+                                                ResolveCb callback) {
+  ASSERT(dispatcher_.isThreadSafe());
+  Shard& shard = *shards_[absl::Hash<std::string>()(dns_name) % shards_.size()];
+  auto query = std::make_shared<PendingQuery>(dns_name, dns_lookup_family, std::move(callback),
+                                              *shard.dispatcher_);
+  query->addTrace(static_cast<uint8_t>(ShardedDnsTrace::Queued));
+  ActiveDnsQuery* active_query = query.get();
+  shard.batch_.push_back(std::move(query));
+  if (!flush_batches_->enabled()) {
+    flush_batches_->scheduleCallbackCurrentIteration();
+  }
+  return active_query;
+}
+
+void ShardedDnsResolverImpl::resetNetworking() {
+  for (auto& shard : shards_) {
+    Shard& shard_ref = *shard;
+    shard->dispatcher_->post([&shard_ref]() { shard_ref.resolver_->resetNetworking(); });
+  }
+}
+
+void ShardedDnsResolverImpl::flushBatches() {
+  for (auto& shard : shards_) {
+    if (shard->batch_.empty()) {
+      continue;
+    }
+    Shard& shard_ref = *shard;
+    shard->dispatcher_->post([this, &shard_ref, queries = std::move(shard->batch_)]() mutable {
+      startQueries(shard_ref, std::move(queries));
+    });
+    shard->batch_.clear();
+  }
+}
+
+void ShardedDnsResolverImpl::startQueries(Shard& shard,
+                                          std::vector<PendingQuerySharedPtr> queries) {
+  ASSERT(shard.dispatcher_->isThreadSafe());
+  for (const PendingQuerySharedPtr& query : queries) {
+    if (query->cancelled_) {
+      continue;
+    }
+    query->addTrace(static_cast<uint8_t>(ShardedDnsTrace::Starting));
+    // Null if the query completed synchronously, in which case the callback has already run.
+    query->resolver_query_ = shard.resolver_->resolve(
+        query->dns_name_, query->dns_lookup_family_,
+        [&shard, query](ResolutionStatus status, absl::string_view details,
+                        std::list<DnsResponse>&& response) {
+          query->resolver_query_ = nullptr;
+          query->addTrace(static_cast<uint8_t>(ShardedDnsTrace::Resolved));
+          shard.completions_.push_back([query, status, details = std::string(details),
+                                        response = std::move(response)]() mutable {
+            if (!query->cancelled_) {
+              query->addTrace(static_cast<uint8_t>(ShardedDnsTrace::Callback));
+              query->callback_(status, details, std::move(response));
+            }
+          });
+          if (!shard.flush_completions_->enabled()) {
+            shard.flush_completions_->scheduleCallbackCurrentIteration();
+          }
+        });
+  }
+}
+
+void ShardedDnsResolverImpl::PendingQuery::cancel(CancelReason reason) {
+  cancelled_ = true;
+  addTrace(static_cast<uint8_t>(ShardedDnsTrace::Cancelled));
+  // Also cancel the query on its resolver thread if it is in flight there, so that the resolver
+  // does not report its result. A query which is not started yet is skipped when it is.
+  shard_dispatcher_.post([query = shared_from_this(), reason]() {
+    if (query->resolver_query_ != nullptr) {
+      query->resolver_query_->cancel(reason);
+      query->resolver_query_ = nullptr;
+    }
+  });
+}
+
+void ShardedDnsResolverImpl::PendingQuery::addTrace(uint8_t trace) {
+  absl::MutexLock lock(mutex_);
+  traces_.push_back(Trace{trace, std::chrono::steady_clock::now()}); // NO_CHECK_FORMAT(real_time)
+}
+
+std::string ShardedDnsResolverImpl::PendingQuery::getTraces() {
+  absl::MutexLock lock(mutex_);
+  return absl::StrJoin(traces_, ",", [](std::string* out, const Trace& trace) {
+    absl::StrAppend(out, trace.trace_, "=", trace.time_.time_since_epoch().count());
+  });
+}
+
+void ShardedDnsResolverImpl::flushCompletions(Shard& shard) {
+  if (shutting_down_) {
+    shard.completions_.clear();
+    return;
+  }
+  dispatcher_.post([alive = std::weak_ptr<bool>(alive_),
+                    completions = std::move(shard.completions_)]() {
+    for (const auto& completion : completions) {
+      // A callback may destroy the resolver, after which the remaining results are dropped.
+      if (alive.expired()) {
+        return;
+      }
+      completion();
+    }
+  });
+  shard.completions_.clear();
+}
+
+} // namespace Network
+} // namespace Envoy
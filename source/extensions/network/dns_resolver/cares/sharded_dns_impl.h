@@ -0,0 +1,122 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/api/api.h"
+#include "envoy/event/dispatcher.h"
+#include "envoy/event/schedulable_cb.h"
+#include "envoy/network/dns.h"
+#include "envoy/thread/thread.h"
+
+#include "source/common/common/logger.h"
+#include "source/extensions/network/dns_resolver/cares/dns_impl.h"
+
+#include "absl/synchronization/mutex.h"
+
+namespace Envoy {
+namespace Network {
+
+// Trace information for the sharded c-ares resolver.
+enum class ShardedDnsTrace : uint8_t {
+  Queued = 0,
+  Starting = 1,
+  Resolved = 2,
+  Cancelled = 3,
+  Callback = 4,
+};
+
+/**
+ * Implementation of DnsResolver that resolves on a number of dedicated threads, each of which
+ * runs its own c-ares channel, so that the work of a high rate of resolutions is not done on the
+ * thread that owns the resolver. Queries are assigned to a thread by a hash of the name. The
+ * queries issued during an event loop iteration are handed to each thread in a single post, and
+ * the results each thread completes during one of its own iterations are returned in a single post
+ * to the owning dispatcher, on which all callbacks are invoked.
+ *
+ * A query records traces as it passes from the owning thread to a resolver thread and back. The
+ * queries of the c-ares resolvers record no traces of their own, so there are none to forward.
+ */
+class ShardedDnsResolverImpl : public DnsResolver, protected Logger::Loggable<Logger::Id::dns> {
+public:
+  ShardedDnsResolverImpl(
+      const envoy::extensions::network::dns_resolver::cares::v3::CaresDnsResolverConfig& config,
+      Event::Dispatcher& dispatcher, Api::Api& api, absl::optional<std::string> resolvers_csv,
+      uint32_t num_shards);
+  ~ShardedDnsResolverImpl() override;
+
+  // Network::DnsResolver
+  ActiveDnsQuery* resolve(const std::string& dns_name, DnsLookupFamily dns_lookup_family,
+                          ResolveCb callback) override;
+  void resetNetworking() override;
+
+  uint32_t numShards() const { return shards_.size(); }
+
+private:
+  class PendingQuery : public ActiveDnsQuery, public std::enable_shared_from_this<PendingQuery> {
+  public:
+    PendingQuery(const std::string& dns_name, DnsLookupFamily dns_lookup_family, ResolveCb callback,
+                 Event::Dispatcher& shard_dispatcher)
+        : dns_name_(dns_name), dns_lookup_family_(dns_lookup_family),
+          callback_(std::move(callback)), shard_dispatcher_(shard_dispatcher) {}
+
+    // Network::ActiveDnsQuery
+    void cancel(CancelReason reason) override;
+    void addTrace(uint8_t trace) override;
+    std::string getTraces() override;
+
+    const std::string dns_name_;
+    const DnsLookupFamily dns_lookup_family_;
+    // Only invoked on the owning dispatcher.
+    const ResolveCb callback_;
+    // The dispatcher of the resolver thread the query is assigned to.
+    Event::Dispatcher& shard_dispatcher_;
+    // Set on the owning thread, and read by the resolver thread to skip queries which were
+    // cancelled before they were started.
+    std::atomic<bool> cancelled_{false};
+    // The query of the resolver thread's resolver while it is in flight, only accessed on the
+    // resolver thread.
+    ActiveDnsQuery* resolver_query_{};
+
+  private:
+    // Traces are added on both the owning thread and the resolver thread.
+    absl::Mutex mutex_;
+    std::vector<Trace> traces_ ABSL_GUARDED_BY(mutex_);
+  };
+  using PendingQuerySharedPtr = std::shared_ptr<PendingQuery>;
+
+  struct Shard {
+    Event::DispatcherPtr dispatcher_;
+    // Created before the resolver thread starts, and then only used and destroyed on it.
+    std::unique_ptr<DnsResolverImpl> resolver_;
+    Thread::ThreadPtr thread_;
+    // The queries assigned to the shard in the current iteration of the owning dispatcher.
+    std::vector<PendingQuerySharedPtr> batch_;
+    // The results completed in the current iteration of the shard's dispatcher, only accessed on
+    // the resolver thread.
+    std::vector<std::function<void()>> completions_;
+    Event::SchedulableCallbackPtr flush_completions_;
+  };
+
+  // Hands the batched queries to the resolver threads.
+  void flushBatches();
+  // Runs on a resolver thread.
+  void startQueries(Shard& shard, std::vector<PendingQuerySharedPtr> queries);
+  // Runs on a resolver thread.
+  void flushCompletions(Shard& shard);
+
+  Event::Dispatcher& dispatcher_;
+  std::vector<std::unique_ptr<Shard>> shards_;
+  const Event::SchedulableCallbackPtr flush_batches_;
+  // Results posted to the owning dispatcher hold a weak reference to this, and are dropped if the
+  // resolver has been destroyed by the time they run.
+  const std::shared_ptr<bool> alive_{std::make_shared<bool>(true)};
+  // Set once the resolver threads are stopping, after which they post no more results.
+  std::atomic<bool> shutting_down_{false};
+};
+
+} // namespace Network
+} // namespace Envoy
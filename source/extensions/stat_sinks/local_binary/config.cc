@@ -0,0 +1,68 @@
+#include "source/extensions/stat_sinks/local_binary/config.h"
+
+#include <memory>
+
+#include "envoy/extensions/stat_sinks/local_binary/v3/local_binary.pb.h"
+#include "envoy/extensions/stat_sinks/local_binary/v3/local_binary.pb.validate.h"
+#include "envoy/registry/registry.h"
+
+#include "source/common/network/address_impl.h"
+#include "source/common/protobuf/utility.h"
+#include "source/extensions/stat_sinks/local_binary/local_binary_sink.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace StatSinks {
+namespace LocalBinary {
+
+absl::StatusOr<Stats::SinkPtr>
+LocalBinarySinkFactory::createStatsSink(const Protobuf::Message& config,
+                                        Server::Configuration::ServerFactoryContext& server) {
+  const auto& sink_config = MessageUtil::downcastAndValidate<
+      const envoy::extensions::stat_sinks::local_binary::v3::LocalBinarySink&>(
+      config, server.messageValidationContext().staticValidationVisitor());
+
+  FrameWriterPtr writer;
+  switch (sink_config.destination_case()) {
+  case envoy::extensions::stat_sinks::local_binary::v3::LocalBinarySink::kUnixSocket: {
+    auto address_or_error = Network::Address::PipeInstance::create(
+        sink_config.unix_socket().path(), sink_config.unix_socket().mode());
+    RETURN_IF_NOT_OK_REF(address_or_error.status());
+    ENVOY_LOG(debug, "local binary stats socket: {}", (*address_or_error)->asString());
+    writer = std::make_unique<DatagramFrameWriter>(
+        std::move(address_or_error.value()),
+        PROTOBUF_GET_WRAPPED_OR_DEFAULT(sink_config, resync_interval_flushes, 12));
+    break;
+  }
+  case envoy::extensions::stat_sinks::local_binary::v3::LocalBinarySink::kFilePath:
+    ENVOY_LOG(debug, "local binary stats file: {}", sink_config.file_path());
+    writer = std::make_unique<FileFrameWriter>(
+        server.api().fileSystem().createFile(
+            {Filesystem::DestinationType::File, sink_config.file_path()}),
+        PROTOBUF_GET_WRAPPED_OR_DEFAULT(sink_config, max_file_bytes, 64 * 1024 * 1024));
+    break;
+  case envoy::extensions::stat_sinks::local_binary::v3::LocalBinarySink::DESTINATION_NOT_SET:
+    PANIC_DUE_TO_PROTO_UNSET;
+  }
+
+  return std::make_unique<LocalBinarySink>(
+      server.scope().symbolTable(), std::move(writer),
+      PROTOBUF_GET_WRAPPED_OR_DEFAULT(sink_config, max_frame_bytes, 64 * 1024),
+      PROTOBUF_GET_WRAPPED_OR_DEFAULT(sink_config, retire_after_flushes, 5));
+}
+
+ProtobufTypes::MessagePtr LocalBinarySinkFactory::createEmptyConfigProto() {
+  return std::make_unique<envoy::extensions::stat_sinks::local_binary::v3::LocalBinarySink>();
+}
+
+std::string LocalBinarySinkFactory::name() const { return LocalBinaryName; }
+
+/**
+ * Static registration for the local binary stats sink factory. @see RegisterFactory.
+ */
+REGISTER_FACTORY(LocalBinarySinkFactory, Server::Configuration::StatsSinkFactory);
+
+} // namespace LocalBinary
+} // namespace StatSinks
+} // namespace Extensions
+} // namespace Envoy
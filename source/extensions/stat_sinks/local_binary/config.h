@@ -0,0 +1,35 @@
+#pragma once
+
+#include "envoy/server/instance.h"
+
+#include "source/server/configuration_impl.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace StatSinks {
+namespace LocalBinary {
+
+constexpr char LocalBinaryName[] = "envoy.stat_sinks.local_binary";
+
+/**
+ * Config registration for the local binary stats sink. @see StatsSinkFactory.
+ */
+class LocalBinarySinkFactory : Logger::Loggable<Logger::Id::config>,
+                               public Server::Configuration::StatsSinkFactory {
+public:
+  // StatsSinkFactory
+  absl::StatusOr<Stats::SinkPtr>
+  createStatsSink(const Protobuf::Message& config,
+                  Server::Configuration::ServerFactoryContext& server) override;
+
+  ProtobufTypes::MessagePtr createEmptyConfigProto() override;
+
+  std::string name() const override;
+};
+
+DECLARE_FACTORY(LocalBinarySinkFactory);
+
+} // namespace LocalBinary
+} // namespace StatSinks
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,233 @@
+#include "source/extensions/stat_sinks/local_binary/decoder.h"
+
+#include <utility>
+
+#include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace StatSinks {
+namespace LocalBinary {
+
+namespace {
+
+absl::Status truncated(absl::string_view what) {
+  return absl::InvalidArgumentError(absl::StrCat("truncated ", what));
+}
+
+} // namespace
+
+absl::Status Decoder::decodeFrame(absl::string_view frame) {
+  // Whatever goes wrong, the dictionary may now be incomplete, so wait for the next Reset frame.
+  const bool was_synced = std::exchange(synced_, false);
+  if (!absl::StartsWith(frame, FrameMagic)) {
+    return absl::InvalidArgumentError("bad frame magic");
+  }
+  WireReader reader(frame.substr(FrameMagic.size()));
+  uint8_t flags;
+  uint64_t sequence, frame_index, snapshot_time_ms;
+  if (!reader.readByte(flags) || !reader.readVarint(sequence) || !reader.readVarint(frame_index) ||
+      !reader.readVarint(snapshot_time_ms)) {
+    return truncated("frame header");
+  }
+  if (flags & FrameFlags::Reset) {
+    tokens_.clear();
+    metrics_.clear();
+  } else if (!was_synced || !followsLastFrame(sequence, frame_index)) {
+    tokens_.clear();
+    metrics_.clear();
+    return absl::DataLossError(
+        absl::StrCat("frame ", frame_index, " of flush ", sequence,
+                     " does not follow the last frame decoded, waiting for a reset frame"));
+  }
+  sequence_ = sequence;
+  frame_index_ = frame_index;
+  snapshot_time_ms_ = snapshot_time_ms;
+  flush_complete_ = (flags & FrameFlags::EndOfFlush) != 0;
+
+  absl::Status status = decodeRecords(reader);
+  synced_ = status.ok();
+  return status;
+}
+
+bool Decoder::followsLastFrame(uint64_t sequence, uint64_t frame_index) const {
+  if (flush_complete_) {
+    return sequence == sequence_ + 1 && frame_index == 0;
+  }
+  return sequence == sequence_ && frame_index == frame_index_ + 1;
+}
+
+absl::Status Decoder::decodeRecords(WireReader& reader) {
+  uint64_t previous_id = 0;
+  while (!reader.empty()) {
+    uint8_t type;
+    reader.readByte(type);
+    switch (static_cast<RecordType>(type)) {
+    case RecordType::Token: {
+      uint64_t id, length;
+      absl::string_view token;
+      if (!reader.readVarint(id) || !reader.readVarint(length) ||
+          !reader.readBytes(length, token)) {
+        return truncated("token record");
+      }
+      tokens_[id] = std::string(token);
+      break;
+    }
+    case RecordType::Metric: {
+      absl::Status status = decodeMetric(reader);
+      if (!status.ok()) {
+        return status;
+      }
+      break;
+    }
+    case RecordType::Retire: {
+      uint64_t id;
+      if (!reader.readVarint(id)) {
+        return truncated("retire record");
+      }
+      metrics_.erase(id);
+      break;
+    }
+    case RecordType::Counter:
+    case RecordType::Gauge:
+    case RecordType::TextReadout:
+    case RecordType::Histogram: {
+      absl::Status status = decodeValue(static_cast<RecordType>(type), reader, previous_id);
+      if (!status.ok()) {
+        return status;
+      }
+      break;
+    }
+    default:
+      return absl::InvalidArgumentError(
+          absl::StrCat("unknown record type ", static_cast<int>(type)));
+    }
+  }
+  return absl::OkStatus();
+}
+
+absl::Status Decoder::decodeFile(absl::string_view data) {
+  WireReader reader(data);
+  while (!reader.empty()) {
+    uint64_t length;
+    absl::string_view frame;
+    if (!reader.readVarint(length) || !reader.readBytes(length, frame)) {
+      return truncated("file frame");
+    }
+    absl::Status status = decodeFrame(frame);
+    if (!status.ok()) {
+      return status;
+    }
+  }
+  return absl::OkStatus();
+}
+
+const Decoder::Metric* Decoder::find(absl::string_view name) const {
+  for (const auto& [id, metric] : metrics_) {
+    if (metric.name_ == name) {
+      return &metric;
+    }
+  }
+  return nullptr;
+}
+
+absl::Status Decoder::decodeMetric(WireReader& reader) {
+  uint64_t id, token_count;
+  uint8_t type;
+  if (!reader.readVarint(id) || !reader.readByte(type) || !reader.readVarint(token_count)) {
+    return truncated("metric record");
+  }
+  if (type > static_cast<uint8_t>(MetricType::Histogram)) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("unknown metric type ", static_cast<int>(type)));
+  }
+  Metric metric;
+  metric.type_ = static_cast<MetricType>(type);
+  for (uint64_t i = 0; i < token_count; ++i) {
+    uint64_t token_id;
+    if (!reader.readVarint(token_id)) {
+      return truncated("metric record");
+    }
+    auto iter = tokens_.find(token_id);
+    if (iter == tokens_.end()) {
+      return absl::InvalidArgumentError(absl::StrCat("unknown token ", token_id));
+    }
+    absl::StrAppend(&metric.name_, i == 0 ? "" : ".", iter->second);
+  }
+  if (metric.type_ == MetricType::Histogram) {
+    uint64_t bucket_count;
+    if (!reader.readVarint(bucket_count)) {
+      return truncated("metric record");
+    }
+    for (uint64_t i = 0; i < bucket_count; ++i) {
+      double bound;
+      if (!reader.readFixed64(bound)) {
+        return truncated("metric record");
+      }
+      metric.bucket_bounds_.push_back(bound);
+    }
+  }
+  metrics_[id] = std::move(metric);
+  return absl::OkStatus();
+}
+
+absl::Status Decoder::decodeValue(RecordType type, WireReader& reader, uint64_t& previous_id) {
+  uint64_t id_delta;
+  if (!reader.readVarint(id_delta)) {
+    return truncated("value record");
+  }
+  const uint64_t id = previous_id + zigzagDecode(id_delta);
+  previous_id = id;
+  auto iter = metrics_.find(id);
+  if (iter == metrics_.end()) {
+    return absl::InvalidArgumentError(absl::StrCat("unknown metric ", id));
+  }
+  Metric& metric = iter->second;
+  metric.updated_sequence_ = sequence_;
+
+  switch (type) {
+  case RecordType::Counter:
+    if (!reader.readVarint(metric.last_delta_)) {
+      return truncated("counter record");
+    }
+    metric.value_ += metric.last_delta_;
+    break;
+  case RecordType::Gauge: {
+    uint64_t difference;
+    if (!reader.readVarint(difference)) {
+      return truncated("gauge record");
+    }
+    metric.value_ += zigzagDecode(difference);
+    break;
+  }
+  case RecordType::TextReadout: {
+    uint64_t length;
+    absl::string_view text;
+    if (!reader.readVarint(length) || !reader.readBytes(length, text)) {
+      return truncated("text readout record");
+    }
+    metric.text_ = std::string(text);
+    break;
+  }
+  default: {
+    if (!reader.readVarint(metric.interval_sample_count_) ||
+        !reader.readFixed64(metric.interval_sample_sum_)) {
+      return truncated("histogram record");
+    }
+    metric.interval_buckets_.resize(metric.bucket_bounds_.size());
+    for (uint64_t& count : metric.interval_buckets_) {
+      if (!reader.readVarint(count)) {
+        return truncated("histogram record");
+      }
+    }
+    break;
+  }
+  }
+  return absl::OkStatus();
+}
+
+} // namespace LocalBinary
+} // namespace StatSinks
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "source/extensions/stat_sinks/local_binary/wire_format.h"
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
+#include "absl/strings/string_view.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace StatSinks {
+namespace LocalBinary {
+
+/**
+ * Reference decoder for the local binary wire format, see wire_format.h. It rebuilds the metrics
+ * described by a stream of frames, and is meant to be embedded in the agent reading the stream as
+ * well as to be used in tests. A decoder is not thread-safe.
+ */
+class Decoder {
+public:
+  struct Metric {
+    std::string name_;
+    MetricType type_;
+    // For counters the sum of the deltas received since the last reset, for gauges the current
+    // value.
+    uint64_t value_{};
+    // For counters the delta received in the last flush that updated this metric.
+    uint64_t last_delta_{};
+    std::string text_;
+    // For histograms the bucket upper bounds, and the sample count, sum and disjoint bucket counts
+    // of the last interval that had samples.
+    std::vector<double> bucket_bounds_;
+    std::vector<uint64_t> interval_buckets_;
+    uint64_t interval_sample_count_{};
+    double interval_sample_sum_{};
+    // Sequence number of the last flush that carried a value for this metric.
+    uint64_t updated_sequence_{};
+  };
+
+  /**
+   * Decodes a single frame, as received from a datagram socket. A frame that does not directly
+   * follow the last one decoded means that frames were lost, or that the decoder started in the
+   * middle of the stream. The decoder then drops everything it knows and ignores frames until the
+   * next Reset frame.
+   * @return a DataLoss error if the frame was ignored for that reason, or another error if the
+   *         frame is malformed or refers to unknown tokens or metrics. After any error the
+   *         decoder waits for the next Reset frame.
+   */
+  absl::Status decodeFrame(absl::string_view frame);
+
+  /**
+   * Decodes the length prefixed frames of a file written by the sink.
+   */
+  absl::Status decodeFile(absl::string_view data);
+
+  /**
+   * @return the known metrics, keyed by their wire id.
+   */
+  const absl::flat_hash_map<uint64_t, Metric>& metrics() const { return metrics_; }
+
+  /**
+   * @return the metric with the given name, or nullptr if it is not known.
+   */
+  const Metric* find(absl::string_view name) const;
+
+  // Sequence number of the last frame decoded, and whether it completed its flush.
+  uint64_t sequence() const { return sequence_; }
+  bool flushComplete() const { return flush_complete_; }
+  uint64_t snapshotTimeMs() const { return snapshot_time_ms_; }
+
+  // Whether the decoder has seen a Reset frame and no frame was lost since.
+  bool synced() const { return synced_; }
+
+private:
+  bool followsLastFrame(uint64_t sequence, uint64_t frame_index) const;
+  absl::Status decodeRecords(WireReader& reader);
+  absl::Status decodeMetric(WireReader& reader);
+  absl::Status decodeValue(RecordType type, WireReader& reader, uint64_t& previous_id);
+
+  absl::flat_hash_map<uint64_t, std::string> tokens_;
+  absl::flat_hash_map<uint64_t, Metric> metrics_;
+  uint64_t sequence_{};
+  uint64_t frame_index_{};
+  uint64_t snapshot_time_ms_{};
+  bool flush_complete_{};
+  bool synced_{};
+};
+
+} // namespace LocalBinary
+} // namespace StatSinks
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,209 @@
+#include "source/extensions/stat_sinks/local_binary/encoder.h"
+
+#include <chrono>
+
+#include "envoy/stats/histogram.h"
+#include "envoy/stats/stats.h"
+
+#include "source/common/common/assert.h"
+
+#include "absl/container/inlined_vector.h"
+#include "absl/strings/str_split.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace StatSinks {
+namespace LocalBinary {
+
+Encoder::Encoder(Stats::SymbolTable& symbol_table, uint64_t max_frame_bytes,
+                 uint32_t retire_after_flushes)
+    : symbol_table_(symbol_table), max_frame_bytes_(max_frame_bytes),
+      retire_after_flushes_(retire_after_flushes) {}
+
+void Encoder::reset() {
+  metrics_.clear();
+  tokens_.clear();
+  free_ids_.clear();
+  next_metric_id_ = 0;
+  reset_pending_ = true;
+}
+
+void Encoder::encode(Stats::MetricSnapshot& snapshot, const FrameCallback& frame_cb) {
+  frame_cb_ = &frame_cb;
+  ++sequence_;
+  frame_index_ = 0;
+  snapshot_time_ms_ = std::chrono::duration_cast<std::chrono::milliseconds>(
+                          snapshot.snapshotTime().time_since_epoch())
+                          .count();
+  startFrame();
+
+  for (const auto& counter : snapshot.counters()) {
+    MetricState& state = metricState(counter.counter_.get(), MetricType::Counter, nullptr);
+    if (counter.delta_ != 0) {
+      reserve(1 + 2 * MaxVarintSize);
+      appendValueHeader(RecordType::Counter, state.id_);
+      appendVarint(frame_, counter.delta_);
+    }
+  }
+
+  for (const auto& gauge : snapshot.gauges()) {
+    MetricState& state = metricState(gauge.get(), MetricType::Gauge, nullptr);
+    const uint64_t value = gauge.get().value();
+    if (value != state.last_value_) {
+      reserve(1 + 2 * MaxVarintSize);
+      appendValueHeader(RecordType::Gauge, state.id_);
+      // Gauges are unsigned, but the difference is sent as a wrapping signed value so that small
+      // decreases stay small on the wire.
+      appendVarint(frame_, zigzagEncode(static_cast<int64_t>(value - state.last_value_)));
+      state.last_value_ = value;
+    }
+  }
+
+  for (const auto& text_readout : snapshot.textReadouts()) {
+    MetricState& state = metricState(text_readout.get(), MetricType::TextReadout, nullptr);
+    std::string value = text_readout.get().value();
+    if (value != state.last_text_) {
+      reserve(1 + 2 * MaxVarintSize + value.size());
+      appendValueHeader(RecordType::TextReadout, state.id_);
+      appendVarint(frame_, value.size());
+      frame_.append(value);
+      state.last_text_ = std::move(value);
+    }
+  }
+
+  for (const auto& histogram : snapshot.histograms()) {
+    const Stats::HistogramStatistics& statistics = histogram.get().intervalStatistics();
+    MetricState& state = metricState(histogram.get(), MetricType::Histogram, &statistics);
+    if (statistics.sampleCount() == 0) {
+      continue;
+    }
+    const std::vector<uint64_t>& cumulative = statistics.computedBuckets();
+    reserve(1 + 2 * MaxVarintSize + 8 + cumulative.size() * MaxVarintSize);
+    appendValueHeader(RecordType::Histogram, state.id_);
+    appendVarint(frame_, statistics.sampleCount());
+    appendFixed64(frame_, statistics.sampleSum());
+    uint64_t previous = 0;
+    for (const uint64_t count : cumulative) {
+      appendVarint(frame_, count - previous);
+      previous = count;
+    }
+  }
+
+  retireStaleMetrics();
+  emitFrame(true);
+  frame_cb_ = nullptr;
+}
+
+Encoder::MetricState& Encoder::metricState(const Stats::Metric& metric, MetricType type,
+                                           const Stats::HistogramStatistics* statistics) {
+  const Stats::StatName stat_name = metric.statName();
+  auto iter = metrics_.find(stat_name);
+  if (iter != metrics_.end()) {
+    iter->second->last_flush_ = sequence_;
+    return *iter->second;
+  }
+
+  uint32_t id;
+  if (free_ids_.empty()) {
+    id = next_metric_id_++;
+  } else {
+    id = free_ids_.back();
+    free_ids_.pop_back();
+  }
+  auto state = std::make_unique<MetricState>(stat_name, symbol_table_, id);
+  state->last_flush_ = sequence_;
+
+  // Tokens are described before the metric that uses them, so look them all up first.
+  const std::string name = symbol_table_.toString(stat_name);
+  absl::InlinedVector<uint32_t, 8> token_ids;
+  for (absl::string_view token : absl::StrSplit(name, '.')) {
+    token_ids.push_back(tokenId(token));
+  }
+
+  const uint64_t bucket_count = statistics != nullptr ? statistics->supportedBuckets().size() : 0;
+  reserve(2 + (2 + token_ids.size() + bucket_count) * MaxVarintSize + 8 * bucket_count);
+  frame_.push_back(static_cast<char>(RecordType::Metric));
+  appendVarint(frame_, id);
+  frame_.push_back(static_cast<char>(type));
+  appendVarint(frame_, token_ids.size());
+  for (const uint32_t token_id : token_ids) {
+    appendVarint(frame_, token_id);
+  }
+  if (statistics != nullptr) {
+    appendVarint(frame_, bucket_count);
+    for (const double bound : statistics->supportedBuckets()) {
+      appendFixed64(frame_, bound);
+    }
+  }
+
+  MetricState& result = *state;
+  metrics_.emplace(result.storage_.statName(), std::move(state));
+  return result;
+}
+
+uint32_t Encoder::tokenId(absl::string_view token) {
+  auto iter = tokens_.find(token);
+  if (iter != tokens_.end()) {
+    return iter->second;
+  }
+  const uint32_t id = tokens_.size();
+  tokens_.emplace(token, id);
+  reserve(1 + 2 * MaxVarintSize + token.size());
+  frame_.push_back(static_cast<char>(RecordType::Token));
+  appendVarint(frame_, id);
+  appendVarint(frame_, token.size());
+  frame_.append(token.data(), token.size());
+  return id;
+}
+
+void Encoder::retireStaleMetrics() {
+  for (auto iter = metrics_.begin(); iter != metrics_.end();) {
+    if (sequence_ - iter->second->last_flush_ < retire_after_flushes_) {
+      ++iter;
+      continue;
+    }
+    reserve(1 + MaxVarintSize);
+    frame_.push_back(static_cast<char>(RecordType::Retire));
+    appendVarint(frame_, iter->second->id_);
+    free_ids_.push_back(iter->second->id_);
+    metrics_.erase(iter++);
+  }
+}
+
+void Encoder::reserve(uint64_t record_bytes) {
+  if (frame_.size() > header_bytes_ && frame_.size() + record_bytes > max_frame_bytes_) {
+    emitFrame(false);
+    startFrame();
+  }
+}
+
+void Encoder::appendValueHeader(RecordType type, uint32_t id) {
+  frame_.push_back(static_cast<char>(type));
+  appendVarint(frame_, zigzagEncode(static_cast<int64_t>(id) - previous_id_));
+  previous_id_ = id;
+}
+
+void Encoder::startFrame() {
+  frame_.clear();
+  frame_.append(FrameMagic.data(), FrameMagic.size());
+  frame_.push_back(static_cast<char>(reset_pending_ ? FrameFlags::Reset : 0));
+  appendVarint(frame_, sequence_);
+  appendVarint(frame_, frame_index_++);
+  appendVarint(frame_, snapshot_time_ms_);
+  header_bytes_ = frame_.size();
+  previous_id_ = 0;
+  reset_pending_ = false;
+}
+
+void Encoder::emitFrame(bool end_of_flush) {
+  if (end_of_flush) {
+    frame_[FrameMagic.size()] |= static_cast<char>(FrameFlags::EndOfFlush);
+  }
+  ASSERT(frame_cb_ != nullptr);
+  (*frame_cb_)(frame_);
+}
+
+} // namespace LocalBinary
+} // namespace StatSinks
+} // namespace Extensions
+} // namespace Envoy
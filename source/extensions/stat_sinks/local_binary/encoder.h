@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "envoy/stats/sink.h"
+#include "envoy/stats/symbol_table.h"
+
+#include "source/common/stats/symbol_table.h"
+#include "source/extensions/stat_sinks/local_binary/wire_format.h"
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace StatSinks {
+namespace LocalBinary {
+
+/**
+ * Turns metric snapshots into frames of the local binary wire format, see wire_format.h. The
+ * encoder remembers which tokens and metrics it has already described and the last gauge and
+ * text readout values it sent, so that each flush only carries new definitions and changed
+ * values. It is only used from the flushing thread.
+ */
+class Encoder {
+public:
+  using FrameCallback = std::function<void(absl::string_view frame)>;
+
+  Encoder(Stats::SymbolTable& symbol_table, uint64_t max_frame_bytes,
+          uint32_t retire_after_flushes);
+
+  /**
+   * Encodes a snapshot, calling frame_cb for every completed frame in order. The last frame of
+   * the flush carries the EndOfFlush flag.
+   */
+  void encode(Stats::MetricSnapshot& snapshot, const FrameCallback& frame_cb);
+
+  /**
+   * Forgets all definitions and values, so that the next flush starts with a Reset frame and
+   * describes every metric again. Used when the receiver may have lost part of the stream.
+   */
+  void reset();
+
+  uint64_t numTokens() const { return tokens_.size(); }
+  uint64_t numMetrics() const { return metrics_.size(); }
+
+private:
+  struct MetricState {
+    MetricState(Stats::StatName stat_name, Stats::SymbolTable& symbol_table, uint32_t id)
+        : storage_(stat_name, symbol_table), id_(id) {}
+
+    Stats::StatNameManagedStorage storage_;
+    const uint32_t id_;
+    uint64_t last_flush_{};
+    uint64_t last_value_{};
+    std::string last_text_;
+  };
+  using MetricStatePtr = std::unique_ptr<MetricState>;
+
+  MetricState& metricState(const Stats::Metric& metric, MetricType type,
+                           const Stats::HistogramStatistics* statistics);
+  uint32_t tokenId(absl::string_view token);
+  void retireStaleMetrics();
+
+  // Makes sure that a record of up to record_bytes fits into the current frame, emitting the
+  // current frame first if needed. A single record larger than a frame gets a frame of its own.
+  void reserve(uint64_t record_bytes);
+  void appendValueHeader(RecordType type, uint32_t id);
+  void startFrame();
+  void emitFrame(bool end_of_flush);
+
+  Stats::SymbolTable& symbol_table_;
+  const uint64_t max_frame_bytes_;
+  const uint32_t retire_after_flushes_;
+  const FrameCallback* frame_cb_{};
+
+  // Keyed by the StatName held in the value, which is why the value is boxed.
+  Stats::StatNameHashMap<MetricStatePtr> metrics_;
+  absl::flat_hash_map<std::string, uint32_t> tokens_;
+  std::vector<uint32_t> free_ids_;
+  uint32_t next_metric_id_{};
+
+  std::string frame_;
+  uint64_t header_bytes_{};
+  uint64_t sequence_{};
+  uint64_t frame_index_{};
+  uint64_t snapshot_time_ms_{};
+  uint32_t previous_id_{};
+  bool reset_pending_{true};
+};
+
+} // namespace LocalBinary
+} // namespace StatSinks
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,96 @@
+#include "source/extensions/stat_sinks/local_binary/local_binary_sink.h"
+
+#include "envoy/buffer/buffer.h"
+#include "envoy/network/socket.h"
+
+#include "source/common/network/socket_interface.h"
+#include "source/common/network/utility.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace StatSinks {
+namespace LocalBinary {
+
+namespace {
+
+constexpr Filesystem::FlagSet FileFlags{1 << Filesystem::File::Operation::Write |
+                                        1 << Filesystem::File::Operation::Create};
+
+} // namespace
+
+DatagramFrameWriter::DatagramFrameWriter(Network::Address::InstanceConstSharedPtr address,
+                                         uint32_t resync_interval_flushes)
+    : address_(std::move(address)),
+      io_handle_(Network::ioHandleForAddr(Network::Socket::Type::Datagram, address_, {})),
+      resync_interval_flushes_(resync_interval_flushes) {}
+
+bool DatagramFrameWriter::prepareFlush() {
+  if (resync_interval_flushes_ == 0 || ++flushes_since_resync_ < resync_interval_flushes_) {
+    return false;
+  }
+  flushes_since_resync_ = 0;
+  return true;
+}
+
+bool DatagramFrameWriter::write(absl::string_view frame) {
+  Buffer::RawSlice slice{const_cast<char*>(frame.data()), frame.size()};
+  return Network::Utility::writeToSocket(*io_handle_, &slice, 1, nullptr, *address_).ok();
+}
+
+FileFrameWriter::FileFrameWriter(Filesystem::FilePtr file, uint64_t max_file_bytes)
+    : file_(std::move(file)), max_file_bytes_(max_file_bytes) {}
+
+bool FileFrameWriter::prepareFlush() {
+  if (file_->isOpen() && file_bytes_ < max_file_bytes_) {
+    return false;
+  }
+  if (file_->isOpen()) {
+    file_->close();
+  }
+  // Opening without Append truncates the file, so whatever comes next starts over.
+  const Api::IoCallBoolResult result = file_->open(FileFlags);
+  if (!result.return_value_) {
+    ENVOY_LOG_EVERY_POW_2(warn, "unable to open stats file '{}': {}", file_->path(),
+                          result.err_->getErrorDetails());
+  }
+  file_bytes_ = 0;
+  return true;
+}
+
+bool FileFrameWriter::write(absl::string_view frame) {
+  if (!file_->isOpen()) {
+    return false;
+  }
+  length_prefix_.clear();
+  appendVarint(length_prefix_, frame.size());
+  if (!file_->write(length_prefix_).ok() || !file_->write(frame).ok()) {
+    // A partially written frame can't be skipped by the reader, so start over with a new file.
+    file_->close();
+    return false;
+  }
+  file_bytes_ += length_prefix_.size() + frame.size();
+  return true;
+}
+
+LocalBinarySink::LocalBinarySink(Stats::SymbolTable& symbol_table, FrameWriterPtr writer,
+                                 uint64_t max_frame_bytes, uint32_t retire_after_flushes)
+    : writer_(std::move(writer)), encoder_(symbol_table, max_frame_bytes, retire_after_flushes) {}
+
+void LocalBinarySink::flush(Stats::MetricSnapshot& snapshot) {
+  if (writer_->prepareFlush()) {
+    encoder_.reset();
+  }
+  bool written = true;
+  encoder_.encode(snapshot, [this, &written](absl::string_view frame) {
+    written = written && writer_->write(frame);
+  });
+  if (!written) {
+    ENVOY_LOG_EVERY_POW_2(debug, "local binary stats flush was not fully written");
+    encoder_.reset();
+  }
+}
+
+} // namespace LocalBinary
+} // namespace StatSinks
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "envoy/filesystem/filesystem.h"
+#include "envoy/network/address.h"
+#include "envoy/network/io_handle.h"
+#include "envoy/stats/sink.h"
+
+#include "source/common/common/logger.h"
+#include "source/extensions/stat_sinks/local_binary/encoder.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace StatSinks {
+namespace LocalBinary {
+
+/**
+ * Destination of the frames produced by the sink.
+ */
+class FrameWriter {
+public:
+  virtual ~FrameWriter() = default;
+
+  /**
+   * Called before each flush.
+   * @return true if the receiver may have lost earlier frames, so that the flush must start over
+   *         with a Reset frame.
+   */
+  virtual bool prepareFlush() PURE;
+
+  /**
+   * Writes one frame.
+   * @return false if the frame could not be written.
+   */
+  virtual bool write(absl::string_view frame) PURE;
+};
+
+using FrameWriterPtr = std::unique_ptr<FrameWriter>;
+
+/**
+ * Sends each frame as one datagram to a Unix domain socket. The socket is non-blocking, so a
+ * receiver that falls behind causes the rest of the flush to be dropped and the next flush to
+ * start over. A datagram can also be lost without the send failing, for example when the receiver
+ * restarts, so every resync_interval_flushes flushes start over as well. Zero disables this.
+ */
+class DatagramFrameWriter : public FrameWriter {
+public:
+  DatagramFrameWriter(Network::Address::InstanceConstSharedPtr address,
+                      uint32_t resync_interval_flushes);
+
+  // FrameWriter
+  bool prepareFlush() override;
+  bool write(absl::string_view frame) override;
+
+private:
+  const Network::Address::InstanceConstSharedPtr address_;
+  const Network::IoHandlePtr io_handle_;
+  const uint32_t resync_interval_flushes_;
+  uint32_t flushes_since_resync_{};
+};
+
+/**
+ * Appends length prefixed frames to a file, truncating it at the start of the first flush after
+ * it grew beyond max_file_bytes.
+ */
+class FileFrameWriter : public FrameWriter, Logger::Loggable<Logger::Id::stats> {
+public:
+  FileFrameWriter(Filesystem::FilePtr file, uint64_t max_file_bytes);
+
+  // FrameWriter
+  bool prepareFlush() override;
+  bool write(absl::string_view frame) override;
+
+private:
+  const Filesystem::FilePtr file_;
+  const uint64_t max_file_bytes_;
+  uint64_t file_bytes_{};
+  std::string length_prefix_;
+};
+
+/**
+ * Stats sink writing the local binary wire format, see wire_format.h.
+ */
+class LocalBinarySink : public Stats::Sink, Logger::Loggable<Logger::Id::stats> {
+public:
+  LocalBinarySink(Stats::SymbolTable& symbol_table, FrameWriterPtr writer,
+                  uint64_t max_frame_bytes, uint32_t retire_after_flushes);
+
+  // Stats::Sink
+  void flush(Stats::MetricSnapshot& snapshot) override;
+  void onHistogramComplete(const Stats::Histogram&, uint64_t) override {}
+
+private:
+  const FrameWriterPtr writer_;
+  Encoder encoder_;
+};
+
+} // namespace LocalBinary
+} // namespace StatSinks
+} // namespace Extensions
+} // namespace Envoy
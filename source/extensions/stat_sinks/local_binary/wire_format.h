@@ -0,0 +1,169 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#include "absl/strings/string_view.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace StatSinks {
+namespace LocalBinary {
+
+/**
+ * Wire format of the local binary stats stream.
+ *
+ * Each flush is written as one or more frames. A frame is self-delimiting when written to a
+ * datagram socket; in a file each frame is preceded by its length as a varint. A frame starts
+ * with a header:
+ *
+ *   magic     4 bytes  "ELB1"
+ *   flags     1 byte   FrameFlags
+ *   sequence  varint   flush sequence number, incremented once per flush
+ *   index     varint   index of the frame within its flush, starting at zero
+ *   time      varint   snapshot time in milliseconds since the epoch
+ *
+ * followed by records, each made of a one byte RecordType and its payload:
+ *
+ *   Token        varint token id, varint length, bytes
+ *   Metric       varint metric id, 1 byte MetricType, varint token count, varint token ids;
+ *                histograms add varint bucket count and a fixed64 upper bound per bucket
+ *   Retire       varint metric id
+ *   Counter      zigzag id delta, varint latched counter delta
+ *   Gauge        zigzag id delta, zigzag difference from the last value sent
+ *   TextReadout  zigzag id delta, varint length, bytes
+ *   Histogram    zigzag id delta, varint interval sample count, fixed64 interval sample sum,
+ *                varint interval count per bucket
+ *
+ * Tokens are the dot separated elements of metric names. Token and Metric records are sent once,
+ * before the first value record that refers to them, and stay valid until a frame with the Reset
+ * flag. Value records refer to metrics by the difference from the id of the previous value record
+ * in the same frame, starting from zero, so frames can be decoded independently given the
+ * dictionary. Metrics whose value did not change since the previous flush are omitted. fixed64
+ * values are the little-endian IEEE 754 representation of a double.
+ *
+ * Only the first frame of a flush can carry the Reset flag. A receiver that misses a frame, which
+ * it can tell from the sequence number and frame index, or that starts reading in the middle of
+ * the stream can't know the whole dictionary and must wait for the next Reset frame. The datagram
+ * writer therefore starts over with a Reset frame periodically, not only after a failed write.
+ */
+
+constexpr absl::string_view FrameMagic{"ELB1"};
+
+enum FrameFlags : uint8_t {
+  // The decoder must drop all tokens, metrics and values it knows of before decoding this frame.
+  Reset = 0x1,
+  // This is the last frame of the flush.
+  EndOfFlush = 0x2,
+};
+
+enum class RecordType : uint8_t {
+  Token = 1,
+  Metric = 2,
+  Retire = 3,
+  Counter = 4,
+  Gauge = 5,
+  TextReadout = 6,
+  Histogram = 7,
+};
+
+enum class MetricType : uint8_t {
+  Counter = 0,
+  Gauge = 1,
+  TextReadout = 2,
+  Histogram = 3,
+};
+
+// Upper bound of the encoded size of a varint.
+constexpr uint64_t MaxVarintSize = 10;
+
+inline void appendVarint(std::string& out, uint64_t value) {
+  while (value >= 0x80) {
+    out.push_back(static_cast<char>(value | 0x80));
+    value >>= 7;
+  }
+  out.push_back(static_cast<char>(value));
+}
+
+inline uint64_t zigzagEncode(int64_t value) {
+  return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+inline int64_t zigzagDecode(uint64_t value) {
+  return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+inline void appendFixed64(std::string& out, double value) {
+  uint64_t bits;
+  static_assert(sizeof(bits) == sizeof(value));
+  std::memcpy(&bits, &value, sizeof(bits));
+  for (int i = 0; i < 8; ++i) {
+    out.push_back(static_cast<char>(bits >> (8 * i)));
+  }
+}
+
+/**
+ * Bounds checked reader over an encoded frame. Each read returns false once the input is
+ * exhausted or malformed, leaving the output unspecified.
+ */
+class WireReader {
+public:
+  explicit WireReader(absl::string_view data) : data_(data) {}
+
+  bool empty() const { return data_.empty(); }
+
+  bool readByte(uint8_t& value) {
+    if (data_.empty()) {
+      return false;
+    }
+    value = static_cast<uint8_t>(data_.front());
+    data_.remove_prefix(1);
+    return true;
+  }
+
+  bool readVarint(uint64_t& value) {
+    value = 0;
+    for (uint32_t shift = 0; shift < 64; shift += 7) {
+      uint8_t byte;
+      if (!readByte(byte)) {
+        return false;
+      }
+      value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+      if ((byte & 0x80) == 0) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  bool readFixed64(double& value) {
+    if (data_.size() < 8) {
+      return false;
+    }
+    uint64_t bits = 0;
+    for (int i = 0; i < 8; ++i) {
+      bits |= static_cast<uint64_t>(static_cast<uint8_t>(data_[i])) << (8 * i);
+    }
+    std::memcpy(&value, &bits, sizeof(value));
+    data_.remove_prefix(8);
+    return true;
+  }
+
+  bool readBytes(uint64_t length, absl::string_view& value) {
+    if (data_.size() < length) {
+      return false;
+    }
+    value = data_.substr(0, length);
+    data_.remove_prefix(length);
+    return true;
+  }
+
+private:
+  absl::string_view data_;
+};
+
+} // namespace LocalBinary
+} // namespace StatSinks
+} // namespace Extensions
+} // namespace Envoy
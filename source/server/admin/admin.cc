@@ -132,20 +132,24 @@ AdminImpl::AdminImpl(const std::string& profile_path, Server::Instance& server,
                       MAKE_ADMIN_HANDLER(clusters_handler_.handlerClusters), false, false,
                       {{Admin::ParamDescriptor::Type::String, "filter",
                         "Regular expression (Google re2) for filtering clusters by name"}}),
-          makeHandler(
-              "/config_dump", "dump current Envoy configs",
-              MAKE_ADMIN_HANDLER(config_dump_handler_.handlerConfigDump), false, false,
-              {{Admin::ParamDescriptor::Type::String, "resource", "The resource to dump"},
-               {Admin::ParamDescriptor::Type::String, "mask",
-                "The mask to apply. When both resource and mask are specified, "
-                "the mask is applied to every element in the desired repeated field so that only a "
-                "subset of fields are returned. The mask is parsed as a Protobuf::FieldMask"},
-               {Admin::ParamDescriptor::Type::String, "name_regex",
-                "Dump only the currently loaded configurations whose names match the specified "
-                "regex. Can be used with both resource and mask query parameters."},
-               {Admin::ParamDescriptor::Type::Boolean, "include_eds",
-                "Dump currently loaded configuration including EDS. See the response definition "
-                "for more information"}}),
+          {"/config_dump",
+           "dump current Envoy configs",
+           [this](AdminStream& admin_stream) -> Admin::RequestPtr {
+             return config_dump_handler_.makeRequest(admin_stream);
+           },
+           false,
+           false,
+           {{Admin::ParamDescriptor::Type::String, "resource", "The resource to dump"},
+            {Admin::ParamDescriptor::Type::String, "mask",
+             "The mask to apply. When both resource and mask are specified, "
+             "the mask is applied to every element in the desired repeated field so that only a "
+             "subset of fields are returned. The mask is parsed as a Protobuf::FieldMask"},
+            {Admin::ParamDescriptor::Type::String, "name_regex",
+             "Dump only the currently loaded configurations whose names match the specified "
+             "regex. Can be used with both resource and mask query parameters."},
+            {Admin::ParamDescriptor::Type::Boolean, "include_eds",
+             "Dump currently loaded configuration including EDS. See the response definition "
+             "for more information"}}},
           makeHandler("/init_dump", "dump current Envoy init manager information (experimental)",
                       MAKE_ADMIN_HANDLER(init_dump_handler_.handlerInitDump), false, false,
                       {{Admin::ParamDescriptor::Type::String, "mask",
@@ -176,6 +180,13 @@ AdminImpl::AdminImpl(const std::string& profile_path, Server::Instance& server,
                         "enable",
                         "enable/disable the allocation profiler",
                         {"y", "n"}}}),
+          makeHandler("/profile/cpu",
+                      "print the recent CPU profile in pprof format (if enabled)",
+                      MAKE_ADMIN_HANDLER(profiling_handler_.handlerContinuousCpuProfile), false,
+                      false,
+                      {{Admin::ParamDescriptor::Type::String, "seconds",
+                        "The length of the profile, in seconds. Defaults to, and is capped at, "
+                        "the configured max_window."}}),
           makeHandler("/healthcheck/fail", "cause the server to fail health checks",
                       MAKE_ADMIN_HANDLER(server_cmd_handler_.handlerHealthcheckFail), false, true),
           makeHandler("/healthcheck/ok", "cause the server to pass health checks",
@@ -228,20 +239,28 @@ AdminImpl::AdminImpl(const std::string& profile_path, Server::Instance& server,
                       MAKE_ADMIN_HANDLER(server_info_handler_.handlerServerInfo), false, false),
           makeHandler("/ready", "print server state, return 200 if LIVE, otherwise return 503",
                       MAKE_ADMIN_HANDLER(server_info_handler_.handlerReady), false, false),
+          makeHandler("/slow_callbacks",
+                      "print the slow event loop callbacks of each thread (if enabled)",
+                      MAKE_ADMIN_HANDLER(server_info_handler_.handlerSlowCallbacks), false, false),
           stats_handler_.statsHandler(false /* not active mode */),
-          makeHandler("/stats/prometheus", "print server stats in prometheus format",
-                      MAKE_ADMIN_HANDLER(stats_handler_.handlerPrometheusStats), false, false,
-                      {{ParamDescriptor::Type::Boolean, "usedonly",
-                        "Only include stats that have been written by system since restart"},
-                       {ParamDescriptor::Type::Boolean, "text_readouts",
-                        "Render text_readouts as new gaugues with value 0 (increases Prometheus "
-                        "data size)"},
-                       {ParamDescriptor::Type::String, "filter",
-                        "Regular expression (Google re2) for filtering stats"},
-                       {ParamDescriptor::Type::Enum,
-                        "histogram_buckets",
-                        "Histogram bucket display mode",
-                        {"cumulative", "summary"}}}),
+          {"/stats/prometheus",
+           "print server stats in prometheus format",
+           [this](AdminStream& admin_stream) -> Admin::RequestPtr {
+             return stats_handler_.makePrometheusRequest(admin_stream);
+           },
+           false,
+           false,
+           {{ParamDescriptor::Type::Boolean, "usedonly",
+             "Only include stats that have been written by system since restart"},
+            {ParamDescriptor::Type::Boolean, "text_readouts",
+             "Render text_readouts as new gaugues with value 0 (increases Prometheus "
+             "data size)"},
+            {ParamDescriptor::Type::String, "filter",
+             "Regular expression (Google re2) for filtering stats"},
+            {ParamDescriptor::Type::Enum,
+             "histogram_buckets",
+             "Histogram bucket display mode",
+             {"cumulative", "summary"}}}},
           makeHandler("/stats/recentlookups", "Show recent stat-name lookups",
                       MAKE_ADMIN_HANDLER(stats_handler_.handlerStatsRecentLookups), false, false),
           makeHandler("/stats/recentlookups/clear", "clear list of stat-name lookups and counter",
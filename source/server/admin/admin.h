@@ -256,6 +256,7 @@ public:
   const absl::flat_hash_set<uint32_t>& httpDestinationPorts() const override {
     return http_destination_ports_;
   }
+  Http::FilterInstrumentation* filterInstrumentation() override { return nullptr; }
 
 private:
   friend class AdminTestingPeer;
@@ -37,6 +37,12 @@ Http::FilterTrailersStatus AdminFilter::decodeTrailers(Http::RequestTrailerMap&)
 }
 
 void AdminFilter::onDestroy() {
+  if (watermark_callbacks_added_) {
+    decoder_callbacks_->removeDownstreamWatermarkCallbacks(*this);
+    watermark_callbacks_added_ = false;
+  }
+  resume_callback_.reset();
+  request_.reset();
   for (const auto& callback : on_destroy_callbacks_) {
     callback();
   }
@@ -92,18 +98,42 @@ void AdminFilter::onComplete() {
   decoder_callbacks_->encodeHeaders(std::move(header_map), false,
                                     StreamInfo::ResponseCodeDetails::get().AdminFilterResponse);
 
-  // TODO(#31087): use high/lower watermarks to apply flow-control to the admin http port.
-  bool more_data;
-  do {
+  request_ = std::move(handler);
+  decoder_callbacks_->addDownstreamWatermarkCallbacks(*this);
+  watermark_callbacks_added_ = true;
+  sendChunks();
+}
+
+void AdminFilter::sendChunks() {
+  bool more_data = true;
+  while (more_data && high_watermark_count_ == 0 && request_ != nullptr) {
     Buffer::OwnedImpl response;
-    more_data = handler->nextChunk(response);
+    more_data = request_->nextChunk(response);
     bool end_stream = end_stream_on_complete_ && !more_data;
     ENVOY_LOG_MISC(debug, "nextChunk: response.length={} more_data={} end_stream={}",
                    response.length(), more_data, end_stream);
     if (response.length() > 0 || end_stream) {
       decoder_callbacks_->encodeData(response, end_stream);
     }
-  } while (more_data);
+  }
+  if (!more_data) {
+    request_.reset();
+  }
+}
+
+void AdminFilter::onAboveWriteBufferHighWatermark() { ++high_watermark_count_; }
+
+void AdminFilter::onBelowWriteBufferLowWatermark() {
+  ASSERT(high_watermark_count_ > 0);
+  if (--high_watermark_count_ > 0 || request_ == nullptr) {
+    return;
+  }
+  // Resume from the event loop rather than from within the write of the connection.
+  if (resume_callback_ == nullptr) {
+    resume_callback_ =
+        decoder_callbacks_->dispatcher().createSchedulableCallback([this]() { sendChunks(); });
+  }
+  resume_callback_->scheduleCallbackCurrentIteration();
 }
 
 } // namespace Server
@@ -3,6 +3,7 @@
 #include <functional>
 #include <list>
 
+#include "envoy/event/schedulable_cb.h"
 #include "envoy/http/filter.h"
 #include "envoy/server/admin.h"
 
@@ -18,10 +19,14 @@ namespace Envoy {
 namespace Server {
 
 /**
- * A terminal HTTP filter that implements server admin functionality.
+ * A terminal HTTP filter that implements server admin functionality. Chunks of streaming responses
+ * are only produced while the downstream connection is below its high watermark, so that a large
+ * response is not buffered in full for a slow client, and the main thread can process other events
+ * in between.
  */
 class AdminFilter : public Http::PassThroughFilter,
                     public AdminStream,
+                    public Http::DownstreamWatermarkCallbacks,
                     Logger::Loggable<Logger::Id::admin> {
 public:
   using AdminServerCallbackFunction = std::function<Http::Code(
@@ -59,15 +64,31 @@ public:
   }
   Http::Utility::QueryParamsMulti queryParams() const override;
 
+  // Http::DownstreamWatermarkCallbacks
+  void onAboveWriteBufferHighWatermark() override;
+  void onBelowWriteBufferLowWatermark() override;
+
 private:
   /**
    * Called when an admin request has been completely received.
    */
   void onComplete();
+
+  /**
+   * Sends the chunks of the response until it is complete or the downstream connection goes over
+   * its high watermark.
+   */
+  void sendChunks();
+
   const Admin& admin_;
   Http::RequestHeaderMap* request_headers_{};
   std::list<std::function<void()>> on_destroy_callbacks_;
   bool end_stream_on_complete_ = true;
+  // The request whose response is being sent, if it isn't complete yet.
+  Admin::RequestPtr request_;
+  Event::SchedulableCallbackPtr resume_callback_;
+  uint32_t high_watermark_count_{};
+  bool watermark_callbacks_added_{};
 };
 
 } // namespace Server
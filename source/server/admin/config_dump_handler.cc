@@ -1,5 +1,7 @@
 #include "source/server/admin/config_dump_handler.h"
 
+#include <algorithm>
+
 #include "envoy/config/core/v3/health_check.pb.h"
 #include "envoy/config/endpoint/v3/endpoint.pb.h"
 
@@ -11,6 +13,9 @@
 #include "source/common/network/utility.h"
 #include "source/server/admin/utils.h"
 
+#include "absl/strings/str_replace.h"
+#include "absl/strings/strip.h"
+
 namespace Envoy {
 namespace Server {
 
@@ -144,51 +149,190 @@ buildNameMatcher(const Http::Utility::QueryParamsMulti& params, Regex::Engine& e
                                                  regex_or_error.status().message()));
 }
 
+// The serialization of a ConfigDump with at least one config, around its configs, and between
+// configs or the elements of a repeated field.
+constexpr absl::string_view DumpHead = "{\n \"configs\": [\n";
+constexpr absl::string_view DumpTail = "\n ]\n}\n";
+constexpr absl::string_view Separator = ",\n";
+// The indentation of the fields of a config, and of the elements of its repeated fields.
+constexpr absl::string_view FieldIndent = "   ";
+constexpr absl::string_view ElementIndent = "    ";
+
+// Moves the elements of a repeated message field out of the message, in order.
+std::vector<ProtobufTypes::MessagePtr> releaseElements(Protobuf::Message& message,
+                                                       const Protobuf::FieldDescriptor* field) {
+  const Protobuf::Reflection* reflection = message.GetReflection();
+  std::vector<ProtobufTypes::MessagePtr> elements(reflection->FieldSize(message, field));
+  for (auto it = elements.rbegin(); it != elements.rend(); ++it) {
+    it->reset(reflection->ReleaseLast(&message, field));
+  }
+  return elements;
+}
+
+// Serializes a config as the element of ConfigDump.configs.
+std::string serializeConfig(const Protobuf::Message& config) {
+  envoy::admin::v3::ConfigDump dump;
+  dump.add_configs()->PackFrom(config);
+  std::string json = MessageUtil::getJsonStringFromMessageOrError(dump, true); // pretty-print
+  absl::string_view view = json;
+  if (absl::ConsumePrefix(&view, DumpHead) && absl::ConsumeSuffix(&view, DumpTail)) {
+    return std::string(view);
+  }
+  // A serialization error, which is written as is.
+  return json;
+}
+
+// Serializes an element of a repeated field of a config, at the indentation it has in the dump.
+std::string serializeElement(Protobuf::Message& element) {
+  MessageUtil::redact(element);
+  const std::string json = MessageUtil::getJsonStringFromMessageOrError(element, true);
+  absl::string_view view = json;
+  absl::ConsumeSuffix(&view, "\n");
+  return absl::StrCat(ElementIndent,
+                      absl::StrReplaceAll(view, {{"\n", absl::StrCat("\n", ElementIndent)}}));
+}
+
 } // namespace
 
-ConfigDumpHandler::ConfigDumpHandler(ConfigTracker& config_tracker, Server::Instance& server)
-    : HandlerContextBase(server), config_tracker_(config_tracker) {}
+ConfigDumpRequest::ConfigDumpRequest(const ConfigDumpHandler& handler,
+                                     Http::Utility::QueryParamsMulti query_params)
+    : handler_(handler), query_params_(std::move(query_params)) {}
 
-Http::Code ConfigDumpHandler::handlerConfigDump(Http::ResponseHeaderMap& response_headers,
-                                                Buffer::Instance& response,
-                                                AdminStream& admin_stream) const {
-  Http::Utility::QueryParamsMulti query_params = admin_stream.queryParams();
+Http::Code ConfigDumpRequest::start(Http::ResponseHeaderMap& response_headers) {
   const absl::optional<std::string> resource =
-      Utility::nonEmptyQueryParam(query_params, "resource");
-  const absl::optional<std::string> mask = Utility::nonEmptyQueryParam(query_params, "mask");
-  const bool include_eds = shouldIncludeEdsInDump(query_params);
+      Utility::nonEmptyQueryParam(query_params_, "resource");
+  const absl::optional<std::string> mask = Utility::nonEmptyQueryParam(query_params_, "mask");
+  const bool include_eds = shouldIncludeEdsInDump(query_params_);
   const absl::StatusOr<Matchers::StringMatcherPtr> name_matcher =
-      buildNameMatcher(query_params, server_.regexEngine());
+      buildNameMatcher(query_params_, handler_.server_.regexEngine());
   if (!name_matcher.ok()) {
-    response.add(name_matcher.status().ToString());
+    pieces_.push_back(name_matcher.status().ToString());
     response_headers.setReferenceContentType(Http::Headers::get().ContentTypeValues.Text);
     return Http::Code::BadRequest;
   }
 
-  envoy::admin::v3::ConfigDump dump;
-
   absl::optional<std::pair<Http::Code, std::string>> err;
   if (resource.has_value()) {
-    err = addResourceToDump(dump, mask, resource.value(), **name_matcher, include_eds);
+    err = handler_.addResourceToDump(configs_, mask, resource.value(), **name_matcher, include_eds);
   } else {
-    err = addAllConfigToDump(dump, mask, **name_matcher, include_eds);
+    err = handler_.addAllConfigToDump(configs_, mask, **name_matcher, include_eds);
   }
   if (err.has_value()) {
+    configs_.clear();
     response_headers.addReference(Http::Headers::get().XContentTypeOptions,
                                   Http::Headers::get().XContentTypeOptionValues.Nosniff);
     response_headers.setReferenceContentType(Http::Headers::get().ContentTypeValues.Text);
-    response.add(err.value().second);
+    pieces_.push_back(std::move(err.value().second));
     return err.value().first;
   }
-  MessageUtil::redact(dump);
 
   response_headers.setReferenceContentType(Http::Headers::get().ContentTypeValues.Json);
-  response.add(MessageUtil::getJsonStringFromMessageOrError(dump, true)); // pretty-print
+  if (configs_.empty()) {
+    pieces_.push_back(
+        MessageUtil::getJsonStringFromMessageOrError(envoy::admin::v3::ConfigDump(), true));
+  } else {
+    pieces_.push_back(std::string(DumpHead));
+  }
   return Http::Code::OK;
 }
 
+bool ConfigDumpRequest::nextChunk(Buffer::Instance& response) {
+  const uint64_t limit = response.length() + chunk_size_;
+  while (response.length() < limit) {
+    if (pieces_.empty()) {
+      if (next_config_ == configs_.size()) {
+        return false;
+      }
+      ProtobufTypes::MessagePtr config = std::move(configs_[next_config_++]);
+      addConfigPieces(*config);
+      pieces_.push_back(std::string(next_config_ == configs_.size() ? DumpTail : Separator));
+      continue;
+    }
+    if (auto* text = absl::get_if<std::string>(&pieces_.front()); text != nullptr) {
+      response.add(*text);
+    } else {
+      response.add(serializeElement(*absl::get<ProtobufTypes::MessagePtr>(pieces_.front())));
+    }
+    pieces_.pop_front();
+  }
+  return !pieces_.empty() || next_config_ < configs_.size();
+}
+
+void ConfigDumpRequest::addConfigPieces(Protobuf::Message& config) {
+  // Leave a single element in each repeated message field, whose serialization marks where the
+  // elements go. Well-known types are left alone, as they may not serialize as objects.
+  const Protobuf::Descriptor* descriptor = config.GetDescriptor();
+  const Protobuf::Reflection* reflection = config.GetReflection();
+  std::vector<std::pair<const Protobuf::FieldDescriptor*, std::vector<ProtobufTypes::MessagePtr>>>
+      streamed_fields;
+  for (int i = 0; i < descriptor->field_count(); ++i) {
+    const Protobuf::FieldDescriptor* field = descriptor->field(i);
+    if (!field->is_repeated() || field->is_map() ||
+        field->cpp_type() != Protobuf::FieldDescriptor::CPPTYPE_MESSAGE ||
+        absl::StartsWith(field->message_type()->full_name(), "google.protobuf.") ||
+        reflection->FieldSize(config, field) == 0) {
+      continue;
+    }
+    streamed_fields.emplace_back(field, releaseElements(config, field));
+    reflection->AddMessage(&config, field);
+  }
+  MessageUtil::redact(config);
+  const std::string skeleton = serializeConfig(config);
+
+  // Find the elements of each field, which are the only lines between the opening line of the
+  // field and its closing bracket at the indentation of the fields of the config.
+  struct Placeholder {
+    size_t begin_;
+    size_t end_;
+    std::vector<ProtobufTypes::MessagePtr>* elements_;
+  };
+  std::vector<Placeholder> placeholders;
+  const std::string close = absl::StrCat("\n", FieldIndent, "]");
+  for (auto& [field, elements] : streamed_fields) {
+    const std::string open = absl::StrCat("\n", FieldIndent, "\"", field->name(), "\": [\n");
+    const size_t begin = skeleton.find(open);
+    const size_t end =
+        begin == std::string::npos ? begin : skeleton.find(close, begin + open.size() - 1);
+    if (end == std::string::npos) {
+      // The config couldn't be serialized, serialize it as a whole to report the error.
+      for (auto& [restored_field, restored_elements] : streamed_fields) {
+        reflection->RemoveLast(&config, restored_field);
+        for (ProtobufTypes::MessagePtr& element : restored_elements) {
+          reflection->AddAllocatedMessage(&config, restored_field, element.release());
+        }
+      }
+      MessageUtil::redact(config);
+      pieces_.push_back(serializeConfig(config));
+      return;
+    }
+    placeholders.push_back({begin + open.size(), end, &elements});
+  }
+  std::sort(placeholders.begin(), placeholders.end(),
+            [](const Placeholder& a, const Placeholder& b) { return a.begin_ < b.begin_; });
+
+  size_t position = 0;
+  for (const Placeholder& placeholder : placeholders) {
+    pieces_.push_back(skeleton.substr(position, placeholder.begin_ - position));
+    for (size_t i = 0; i < placeholder.elements_->size(); ++i) {
+      if (i > 0) {
+        pieces_.push_back(std::string(Separator));
+      }
+      pieces_.push_back(std::move((*placeholder.elements_)[i]));
+    }
+    position = placeholder.end_;
+  }
+  pieces_.push_back(skeleton.substr(position));
+}
+
+ConfigDumpHandler::ConfigDumpHandler(ConfigTracker& config_tracker, Server::Instance& server)
+    : HandlerContextBase(server), config_tracker_(config_tracker) {}
+
+Admin::RequestPtr ConfigDumpHandler::makeRequest(AdminStream& admin_stream) const {
+  return std::make_unique<ConfigDumpRequest>(*this, admin_stream.queryParams());
+}
+
 absl::optional<std::pair<Http::Code, std::string>> ConfigDumpHandler::addResourceToDump(
-    envoy::admin::v3::ConfigDump& dump, const absl::optional<std::string>& mask,
+    ConfigVector& configs, const absl::optional<std::string>& mask,
     const std::string& resource, const Matchers::StringMatcher& name_matcher,
     bool include_eds) const {
   Envoy::Server::ConfigTracker::CbsMap callbacks_map = config_tracker_.getCallbacksMap();
@@ -217,19 +361,17 @@ absl::optional<std::pair<Http::Code, std::string>> ConfigDumpHandler::addResourc
                       field_descriptor->name(), field_descriptor->name()))};
     }
 
-    auto repeated = reflection->GetRepeatedPtrField<Protobuf::Message>(*message, field_descriptor);
-    for (Protobuf::Message& msg : repeated) {
+    for (ProtobufTypes::MessagePtr& msg : releaseElements(*message, field_descriptor)) {
       if (mask.has_value()) {
         Protobuf::FieldMask field_mask;
         ProtobufUtil::FieldMaskUtil::FromString(mask.value(), &field_mask);
-        if (!trimResourceMessage(field_mask, msg)) {
+        if (!trimResourceMessage(field_mask, *msg)) {
           return absl::optional<std::pair<Http::Code, std::string>>{std::make_pair(
               Http::Code::BadRequest, absl::StrCat("FieldMask ", field_mask.DebugString(),
                                                    " could not be successfully used."))};
         }
       }
-      auto* config = dump.add_configs();
-      config->PackFrom(msg);
+      configs.push_back(std::move(msg));
     }
 
     // We found the desired resource so there is no need to continue iterating over
@@ -242,7 +384,7 @@ absl::optional<std::pair<Http::Code, std::string>> ConfigDumpHandler::addResourc
 }
 
 absl::optional<std::pair<Http::Code, std::string>> ConfigDumpHandler::addAllConfigToDump(
-    envoy::admin::v3::ConfigDump& dump, const absl::optional<std::string>& mask,
+    ConfigVector& configs, const absl::optional<std::string>& mask,
     const Matchers::StringMatcher& name_matcher, bool include_eds) const {
   Envoy::Server::ConfigTracker::CbsMap callbacks_map = config_tracker_.getCallbacksMap();
   if (include_eds) {
@@ -271,10 +413,9 @@ absl::optional<std::pair<Http::Code, std::string>> ConfigDumpHandler::addAllConf
       }
     }
 
-    auto* config = dump.add_configs();
-    config->PackFrom(*message);
+    configs.push_back(std::move(message));
   }
-  if (dump.configs().empty() && mask.has_value()) {
+  if (configs.empty() && mask.has_value()) {
     return absl::optional<std::pair<Http::Code, std::string>>{std::make_pair(
         Http::Code::BadRequest,
         absl::StrCat("FieldMask ", *mask, " could not be successfully applied to any configs."))};
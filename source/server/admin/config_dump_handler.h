@@ -1,5 +1,8 @@
 #pragma once
 
+#include <deque>
+#include <vector>
+
 #include "envoy/admin/v3/config_dump.pb.h"
 #include "envoy/buffer/buffer.h"
 #include "envoy/config/endpoint/v3/endpoint_components.pb.h"
@@ -8,10 +11,12 @@
 #include "envoy/server/admin.h"
 #include "envoy/server/instance.h"
 
+#include "source/common/http/utility.h"
 #include "source/server/admin/config_tracker_impl.h"
 #include "source/server/admin/handler_ctx.h"
 
 #include "absl/strings/string_view.h"
+#include "absl/types/variant.h"
 
 namespace Envoy {
 namespace Server {
@@ -21,12 +26,16 @@ class ConfigDumpHandler : public HandlerContextBase {
 public:
   ConfigDumpHandler(ConfigTracker& config_tracker, Server::Instance& server);
 
-  Http::Code handlerConfigDump(Http::ResponseHeaderMap& response_headers,
-                               Buffer::Instance& response, AdminStream&) const;
+  Admin::RequestPtr makeRequest(AdminStream& admin_stream) const;
 
 private:
+  friend class ConfigDumpRequest;
+
+  // The configs of a dump, in order, each of which is packed into ConfigDump.configs.
+  using ConfigVector = std::vector<ProtobufTypes::MessagePtr>;
+
   absl::optional<std::pair<Http::Code, std::string>>
-  addAllConfigToDump(envoy::admin::v3::ConfigDump& dump, const absl::optional<std::string>& mask,
+  addAllConfigToDump(ConfigVector& configs, const absl::optional<std::string>& mask,
                      const Matchers::StringMatcher& name_matcher, bool include_eds) const;
   /**
    * Add the config matching the passed resource to the passed config dump.
@@ -34,7 +43,7 @@ private:
    * to the admin response.
    */
   absl::optional<std::pair<Http::Code, std::string>>
-  addResourceToDump(envoy::admin::v3::ConfigDump& dump, const absl::optional<std::string>& mask,
+  addResourceToDump(ConfigVector& configs, const absl::optional<std::string>& mask,
                     const std::string& resource, const Matchers::StringMatcher& name_matcher,
                     bool include_eds) const;
 
@@ -49,5 +58,39 @@ private:
   ConfigTracker& config_tracker_;
 };
 
+/**
+ * Streams a config dump. The configs are collected when the request starts, and serialized one
+ * resource at a time as chunks are requested: the elements of the top level repeated fields of
+ * each config, e.g. the clusters of the ClustersConfigDump, are serialized individually and
+ * released once written. The output is identical to serializing the whole ConfigDump at once.
+ */
+class ConfigDumpRequest : public Admin::Request {
+public:
+  static constexpr uint64_t DefaultChunkSize = 2 * 1000 * 1000;
+
+  ConfigDumpRequest(const ConfigDumpHandler& handler, Http::Utility::QueryParamsMulti query_params);
+
+  // Admin::Request
+  Http::Code start(Http::ResponseHeaderMap& response_headers) override;
+  bool nextChunk(Buffer::Instance& response) override;
+
+  // Sets the chunk size.
+  void setChunkSize(uint64_t chunk_size) { chunk_size_ = chunk_size; }
+
+private:
+  // Either text to write as is, or a resource to serialize when it is reached.
+  using Piece = absl::variant<std::string, ProtobufTypes::MessagePtr>;
+
+  // Splits the serialization of a config into pieces, around the elements of its repeated fields.
+  void addConfigPieces(Protobuf::Message& config);
+
+  const ConfigDumpHandler& handler_;
+  const Http::Utility::QueryParamsMulti query_params_;
+  uint64_t chunk_size_{DefaultChunkSize};
+  ConfigDumpHandler::ConfigVector configs_;
+  size_t next_config_{};
+  std::deque<Piece> pieces_;
+};
+
 } // namespace Server
 } // namespace Envoy
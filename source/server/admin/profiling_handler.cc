@@ -1,8 +1,11 @@
 #include "source/server/admin/profiling_handler.h"
 
+#include "source/common/profiler/continuous_cpu_profiler.h"
 #include "source/common/profiler/profiler.h"
 #include "source/server/admin/utils.h"
 
+#include "absl/strings/numbers.h"
+
 namespace Envoy {
 namespace Server {
 
@@ -21,6 +24,11 @@ Http::Code ProfilingHandler::handlerCpuProfiler(Http::ResponseHeaderMap&,
 
   bool enable = enableVal.value() == "y";
   if (enable && !Profiler::Cpu::profilerEnabled()) {
+    if (Profiler::ContinuousCpuProfiler::instance() != nullptr) {
+      // Both profilers rely on SIGPROF.
+      response.add("the continuous CPU profiler is running, see /profile/cpu");
+      return Http::Code::BadRequest;
+    }
     if (!Profiler::Cpu::startProfiler(profile_path_)) {
       response.add("failure to start the profiler");
       return Http::Code::InternalServerError;
@@ -80,6 +88,31 @@ Http::Code ProfilingHandler::handlerHeapProfiler(Http::ResponseHeaderMap&,
   return res;
 }
 
+Http::Code ProfilingHandler::handlerContinuousCpuProfile(Http::ResponseHeaderMap& response_headers,
+                                                         Buffer::Instance& response,
+                                                         AdminStream& admin_stream) {
+  Profiler::ContinuousCpuProfiler* profiler = Profiler::ContinuousCpuProfiler::instance();
+  if (profiler == nullptr) {
+    response.add("The continuous CPU profiler is not enabled in the bootstrap config");
+    return Http::Code::NotFound;
+  }
+
+  std::chrono::seconds window = profiler->maxWindow();
+  const auto seconds = admin_stream.queryParams().getFirstValue("seconds");
+  if (seconds.has_value() && !seconds.value().empty()) {
+    uint32_t value;
+    if (!absl::SimpleAtoi(seconds.value(), &value) || value == 0) {
+      response.add("?seconds=<positive integer>\n");
+      return Http::Code::BadRequest;
+    }
+    window = std::min(window, std::chrono::seconds(value));
+  }
+
+  response_headers.setContentType("application/octet-stream");
+  response.add(profiler->profile(window));
+  return Http::Code::OK;
+}
+
 Http::Code TcmallocProfilingHandler::handlerHeapDump(Http::ResponseHeaderMap&,
                                                      Buffer::Instance& response, AdminStream&) {
   auto dump_result = Profiler::TcmallocProfiler::tcmallocHeapProfile();
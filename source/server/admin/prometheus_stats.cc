@@ -124,7 +124,7 @@ public:
     for (const auto* text_readout : text_readouts) {
       auto tags = text_readout->tags();
       tags.push_back(Stats::Tag{"text_value", text_readout->value()});
-      const std::string formattedTags = PrometheusStatsFormatter::formattedTags(tags);
+      const std::string formattedTags = formatTags(tags);
       output.add(fmt::format("{0}{{{1}}} 0\n", prefixed_tag_extracted_name, formattedTags));
     }
   }
@@ -151,7 +151,7 @@ private:
 
     generateTypeOutput(output, type, prefixed_tag_extracted_name);
     for (const auto* metric : metrics) {
-      const std::string formatted_tags = PrometheusStatsFormatter::formattedTags(metric->tags());
+      const std::string formatted_tags = formatTags(metric->tags());
       output.add(fmt::format("{0}{{{1}}} {2}\n", prefixed_tag_extracted_name, formatted_tags,
                              metric->value()));
     }
@@ -168,7 +168,7 @@ private:
     generateTypeOutput(output, "histogram", prefixed_tag_extracted_name);
 
     for (const auto* histogram : histograms) {
-      const std::string tags = PrometheusStatsFormatter::formattedTags(histogram->tags());
+      const std::string tags = formatTags(histogram->tags());
       const std::string hist_tags = histogram->tags().empty() ? EMPTY_STRING : (tags + ",");
 
       const Stats::HistogramStatistics& stats = histogram->cumulativeStatistics();
@@ -206,7 +206,7 @@ private:
     generateTypeOutput(output, "summary", prefixed_tag_extracted_name);
 
     for (const auto* histogram : histograms) {
-      const std::string tags = PrometheusStatsFormatter::formattedTags(histogram->tags());
+      const std::string tags = formatTags(histogram->tags());
       const std::string hist_tags = histogram->tags().empty() ? EMPTY_STRING : (tags + ",");
 
       const Stats::HistogramStatistics& stats = histogram->intervalStatistics();
@@ -323,7 +323,7 @@ private:
     metric->mutable_label()->Reserve(tags.size());
     for (const auto& tag : tags) {
       auto* label = metric->add_label();
-      label->set_name(sanitizeName(tag.name_));
+      label->set_name(labelName(tag.name_));
       label->set_value(sanitizeValue(tag.value_));
     }
   }
@@ -772,6 +772,49 @@ uint64_t outputPrimitiveStatType(Buffer::Instance& response, const StatsParams&
   return result;
 }
 
+// Note: This assumes that there is no overlap in stat name between per-endpoint stats and all
+// other stats. If this is not true, then the counters/gauges for per-endpoint need to be combined
+// with the other counters and gauges so that stats can be properly grouped.
+uint64_t outputHostMetrics(Buffer::Instance& response, const StatsParams& params,
+                           const Upstream::ClusterManager& cluster_manager,
+                           const PrometheusStatsFormatter::OutputFormat& output_format,
+                           const Stats::CustomStatNamespaces& custom_namespaces) {
+  std::vector<Stats::PrimitiveCounterSnapshot> host_counters;
+  std::vector<Stats::PrimitiveGaugeSnapshot> host_gauges;
+  Upstream::HostUtility::forEachHostMetric(
+      cluster_manager,
+      [&](Stats::PrimitiveCounterSnapshot&& metric) {
+        host_counters.emplace_back(std::move(metric));
+      },
+      [&](Stats::PrimitiveGaugeSnapshot&& metric) { host_gauges.emplace_back(std::move(metric)); });
+
+  return outputPrimitiveStatType(response, params, host_counters, output_format,
+                                 custom_namespaces) +
+         outputPrimitiveStatType(response, params, host_gauges, output_format, custom_namespaces);
+}
+
+PrometheusStatsFormatter::OutputFormat::HistogramType histogramType(const StatsParams& params) {
+  using HistogramType = PrometheusStatsFormatter::OutputFormat::HistogramType;
+
+  // Validation of bucket modes is handled separately.
+  switch (params.histogram_buckets_mode_) {
+  case Utility::HistogramBucketsMode::Summary:
+    return HistogramType::Summary;
+  case Utility::HistogramBucketsMode::Unset:
+  case Utility::HistogramBucketsMode::Cumulative:
+    return HistogramType::ClassicHistogram;
+  case Utility::HistogramBucketsMode::PrometheusNative:
+    return HistogramType::NativeHistogram;
+  // "Detailed" and "Disjoint" don't make sense for prometheus histogram semantics. These types were
+  // have been filtered out in validateParams().
+  case Utility::HistogramBucketsMode::Detailed:
+  case Utility::HistogramBucketsMode::Disjoint:
+    break;
+  }
+  IS_ENVOY_BUG("unsupported prometheus histogram bucket mode");
+  return HistogramType::ClassicHistogram;
+}
+
 // Determine the format based on Accept header, using first-match priority.
 // Per HTTP spec, clients SHOULD send media types in priority order.
 // Text format is only selected if explicitly requested as version 0.0.4 or as fallback.
@@ -819,6 +862,57 @@ bool useProtobufFormat(const StatsParams& params, const Http::RequestHeaderMap&
 
 } // namespace
 
+PrometheusStatsFormatter::NameCache::NameCache(Stats::SymbolTable& symbol_table,
+                                               const Stats::CustomStatNamespaces& custom_namespaces)
+    : symbol_table_(symbol_table), custom_namespaces_(custom_namespaces) {}
+
+const absl::optional<std::string>&
+PrometheusStatsFormatter::NameCache::metricName(Stats::StatName tag_extracted_name) {
+  auto iter = metric_names_.find(tag_extracted_name);
+  if (iter != metric_names_.end()) {
+    iter->second->used_ = true;
+    return iter->second->name_;
+  }
+  auto cached = std::make_unique<CachedMetricName>(tag_extracted_name, symbol_table_);
+  cached->name_ = PrometheusStatsFormatter::metricName(symbol_table_.toString(tag_extracted_name),
+                                                       custom_namespaces_);
+  const Stats::StatName key = cached->storage_.statName();
+  return metric_names_.emplace(key, std::move(cached)).first->second->name_;
+}
+
+const std::string& PrometheusStatsFormatter::NameCache::tagName(const std::string& name) {
+  auto iter = tag_names_.find(name);
+  if (iter == tag_names_.end()) {
+    iter = tag_names_.emplace(name, sanitizeName(name)).first;
+  }
+  return iter->second;
+}
+
+void PrometheusStatsFormatter::NameCache::sweep() {
+  absl::erase_if(metric_names_, [](const auto& entry) { return !entry.second->used_; });
+  for (auto& entry : metric_names_) {
+    entry.second->used_ = false;
+  }
+}
+
+std::string
+PrometheusStatsFormatter::OutputFormat::formatTags(const std::vector<Stats::Tag>& tags) const {
+  if (name_cache_ == nullptr) {
+    return PrometheusStatsFormatter::formattedTags(tags);
+  }
+  std::vector<std::string> buf;
+  buf.reserve(tags.size());
+  for (const Stats::Tag& tag : tags) {
+    buf.push_back(
+        fmt::format("{}=\"{}\"", name_cache_->tagName(tag.name_), sanitizeValue(tag.value_)));
+  }
+  return absl::StrJoin(buf, ",");
+}
+
+std::string PrometheusStatsFormatter::OutputFormat::labelName(const std::string& tag_name) const {
+  return name_cache_ == nullptr ? sanitizeName(tag_name) : name_cache_->tagName(tag_name);
+}
+
 std::string PrometheusStatsFormatter::formattedTags(const std::vector<Stats::Tag>& tags) {
   std::vector<std::string> buf;
   buf.reserve(tags.size());
@@ -888,30 +982,7 @@ uint64_t PrometheusStatsFormatter::generateWithOutputFormat(
     const StatsParams& params, const Stats::CustomStatNamespaces& custom_namespaces,
     OutputFormat& output_format) {
 
-  OutputFormat::HistogramType hist_type;
-
-  // Validation of bucket modes is handled separately.
-  switch (params.histogram_buckets_mode_) {
-  case Utility::HistogramBucketsMode::Summary:
-    hist_type = OutputFormat::HistogramType::Summary;
-    break;
-  case Utility::HistogramBucketsMode::Unset:
-  case Utility::HistogramBucketsMode::Cumulative:
-    hist_type = OutputFormat::HistogramType::ClassicHistogram;
-    break;
-  case Utility::HistogramBucketsMode::PrometheusNative:
-    hist_type = OutputFormat::HistogramType::NativeHistogram;
-    break;
-  // "Detailed" and "Disjoint" don't make sense for prometheus histogram semantics. These types were
-  // have been filtered out in validateParams().
-  case Utility::HistogramBucketsMode::Detailed:
-  case Utility::HistogramBucketsMode::Disjoint:
-    hist_type = OutputFormat::HistogramType::ClassicHistogram;
-    IS_ENVOY_BUG("unsupported prometheus histogram bucket mode");
-    break;
-  }
-
-  output_format.setHistogramType(hist_type);
+  output_format.setHistogramType(histogramType(params));
 
   uint64_t metric_name_count = 0;
   metric_name_count +=
@@ -926,22 +997,8 @@ uint64_t PrometheusStatsFormatter::generateWithOutputFormat(
   metric_name_count += outputStatType<Stats::ParentHistogram>(response, params, histograms,
                                                               output_format, custom_namespaces);
 
-  // Note: This assumes that there is no overlap in stat name between per-endpoint stats and all
-  // other stats. If this is not true, then the counters/gauges for per-endpoint need to be combined
-  // with the above counter/gauge calls so that stats can be properly grouped.
-  std::vector<Stats::PrimitiveCounterSnapshot> host_counters;
-  std::vector<Stats::PrimitiveGaugeSnapshot> host_gauges;
-  Upstream::HostUtility::forEachHostMetric(
-      cluster_manager,
-      [&](Stats::PrimitiveCounterSnapshot&& metric) {
-        host_counters.emplace_back(std::move(metric));
-      },
-      [&](Stats::PrimitiveGaugeSnapshot&& metric) { host_gauges.emplace_back(std::move(metric)); });
-
-  metric_name_count +=
-      outputPrimitiveStatType(response, params, host_counters, output_format, custom_namespaces);
   metric_name_count +=
-      outputPrimitiveStatType(response, params, host_gauges, output_format, custom_namespaces);
+      outputHostMetrics(response, params, cluster_manager, output_format, custom_namespaces);
 
   return metric_name_count;
 }
@@ -994,5 +1051,191 @@ uint64_t PrometheusStatsFormatter::statsAsPrometheus(
                                      response, params, custom_namespaces);
 }
 
+PrometheusStatsRequest::PrometheusStatsRequest(Stats::Store& stats, const StatsParams& params,
+                                               const Upstream::ClusterManager& cluster_manager,
+                                               const Http::RequestHeaderMap& request_headers,
+                                               const Stats::CustomStatNamespaces& custom_namespaces,
+                                               PrometheusStatsFormatter::NameCache* name_cache)
+    : stats_(stats), params_(params), cluster_manager_(cluster_manager),
+      custom_namespaces_(custom_namespaces), name_cache_(name_cache),
+      use_protobuf_(useProtobufFormat(params, request_headers)),
+      counter_groups_(Stats::StatNameLessThan(stats.symbolTable())),
+      gauge_groups_(Stats::StatNameLessThan(stats.symbolTable())),
+      text_readout_groups_(Stats::StatNameLessThan(stats.symbolTable())),
+      histogram_groups_(Stats::StatNameLessThan(stats.symbolTable())) {}
+
+Http::Code PrometheusStatsRequest::start(Http::ResponseHeaderMap& response_headers) {
+  if (use_protobuf_) {
+    response_headers.setReferenceContentType(
+        "application/vnd.google.protobuf; "
+        "proto=io.prometheus.client.MetricFamily; encoding=delimited");
+    output_format_ = std::make_unique<ProtobufFormat>(params_.native_histogram_max_buckets_);
+  } else {
+    output_format_ = std::make_unique<TextFormat>();
+  }
+  output_format_->setHistogramType(histogramType(params_));
+  output_format_->setNameCache(name_cache_);
+  startPhase(Phase::Counters);
+  return Http::Code::OK;
+}
+
+bool PrometheusStatsRequest::nextChunk(Buffer::Instance& response) {
+  // Like StatsRequest, add up to chunk_size_ bytes to the response, which the
+  // caller does not have to drain between calls.
+  const uint64_t limit = response.length() + chunk_size_;
+  // Walk the store at most once per call, leaving the next batch to the next
+  // call even if the chunk is not full, so that no call walks it repeatedly.
+  bool collected = false;
+  while (phase_ != Phase::Done && response.length() < limit) {
+    if (phase_ == Phase::HostMetrics) {
+      // As in StatsRequest, per-host metrics are rendered in one batch, as
+      // there is nothing to hold on to in order to pause the iteration.
+      outputHostMetrics(response, params_, cluster_manager_, *output_format_, custom_namespaces_);
+      startPhase(Phase::Done);
+    } else if (!renderBatch(response, limit)) {
+      // The response is full.
+    } else if (last_batch_) {
+      startPhase(static_cast<Phase>(static_cast<int>(phase_) + 1));
+    } else if (collected) {
+      return true;
+    } else {
+      collectBatch();
+      collected = true;
+    }
+  }
+
+  if (phase_ != Phase::Done) {
+    return true;
+  }
+  if (name_cache_ != nullptr) {
+    name_cache_->sweep();
+  }
+  return false;
+}
+
+void PrometheusStatsRequest::startPhase(Phase phase) {
+  phase_ = phase;
+  resume_after_.reset();
+  last_batch_ = false;
+}
+
+void PrometheusStatsRequest::collectBatch() {
+  switch (phase_) {
+  case Phase::Counters:
+    last_batch_ = populateGroups<Stats::Counter>(
+        counter_groups_,
+        [this](const Stats::StatFn<Stats::Counter>& fn) { stats_.forEachCounter(nullptr, fn); });
+    break;
+  case Phase::Gauges:
+    last_batch_ =
+        populateGroups<Stats::Gauge>(gauge_groups_, [this](const Stats::StatFn<Stats::Gauge>& fn) {
+          stats_.forEachGauge(nullptr, fn);
+        });
+    break;
+  case Phase::TextReadouts:
+    last_batch_ = !params_.prometheus_text_readouts_ ||
+                  populateGroups<Stats::TextReadout>(
+                      text_readout_groups_, [this](const Stats::StatFn<Stats::TextReadout>& fn) {
+                        stats_.forEachTextReadout(nullptr, fn);
+                      });
+    break;
+  case Phase::Histograms:
+    last_batch_ = populateGroups<Stats::ParentHistogram>(
+        histogram_groups_, [this](const Stats::StatFn<Stats::ParentHistogram>& fn) {
+          stats_.forEachHistogram(nullptr, fn);
+        });
+    break;
+  case Phase::HostMetrics:
+  case Phase::Done:
+    PANIC("not reached");
+  }
+}
+
+bool PrometheusStatsRequest::renderBatch(Buffer::Instance& response, uint64_t limit) {
+  switch (phase_) {
+  case Phase::Counters:
+    return renderGroups(counter_groups_, response, limit);
+  case Phase::Gauges:
+    return renderGroups(gauge_groups_, response, limit);
+  case Phase::TextReadouts:
+    return renderGroups(text_readout_groups_, response, limit);
+  case Phase::Histograms:
+    return renderGroups(histogram_groups_, response, limit);
+  case Phase::HostMetrics:
+  case Phase::Done:
+    break;
+  }
+  PANIC("not reached");
+}
+
+template <class StatType>
+bool PrometheusStatsRequest::populateGroups(
+    MetricGroups<StatType>& groups,
+    const std::function<void(const Stats::StatFn<StatType>&)>& for_each) {
+  ASSERT(groups.empty());
+  const Stats::StatNameLessThan less_than(stats_.symbolTable());
+  uint64_t num_metrics = 0;
+  // A metric of the first family left to a later batch, which keeps its name
+  // alive. Families from it on are not collected.
+  Stats::RefcountPtr<StatType> first_excluded;
+  for_each([&](StatType& metric) {
+    if (!params_.shouldShowMetric(metric)) {
+      return;
+    }
+    const Stats::StatName name = metric.tagExtractedStatName();
+    if ((resume_after_ != nullptr && !less_than(resume_after_->statName(), name)) ||
+        (first_excluded != nullptr && !less_than(name, first_excluded->tagExtractedStatName()))) {
+      return;
+    }
+    groups[name].emplace_back(&metric);
+    ++num_metrics;
+    // Drop the last families once the batch is full, keeping at least one, as
+    // a family must be rendered with all of its metrics.
+    while (num_metrics > batch_size_ && groups.size() > 1) {
+      auto last = std::prev(groups.end());
+      num_metrics -= last->second.size();
+      first_excluded = last->second.front();
+      groups.erase(last);
+    }
+  });
+
+  if (!groups.empty()) {
+    resume_after_ = std::make_unique<Stats::StatNameManagedStorage>(
+        std::prev(groups.end())->first, stats_.symbolTable());
+  }
+  return first_excluded == nullptr;
+}
+
+template <class StatType>
+bool PrometheusStatsRequest::renderGroups(MetricGroups<StatType>& groups,
+                                          Buffer::Instance& response, uint64_t limit) {
+  std::vector<const StatType*> metrics;
+  while (!groups.empty() && response.length() < limit) {
+    auto group = groups.begin();
+    absl::optional<std::string> uncached_name;
+    const absl::optional<std::string>* name;
+    if (name_cache_ != nullptr) {
+      name = &name_cache_->metricName(group->first);
+    } else {
+      uncached_name = PrometheusStatsFormatter::metricName(
+          stats_.symbolTable().toString(group->first), custom_namespaces_);
+      name = &uncached_name;
+    }
+
+    if (name->has_value()) {
+      metrics.clear();
+      metrics.reserve(group->second.size());
+      for (const Stats::RefcountPtr<StatType>& metric : group->second) {
+        metrics.push_back(metric.get());
+      }
+      std::sort(metrics.begin(), metrics.end(), MetricLessThan());
+      output_format_->generateOutput(response, metrics, name->value());
+    }
+    // The group's key is owned by its metrics, so it must be erased as a whole.
+    groups.erase(group);
+  }
+  return groups.empty();
+}
+
 } // namespace Server
 } // namespace Envoy
@@ -1,14 +1,20 @@
 #pragma once
 
+#include <map>
 #include <string>
 
 #include "envoy/buffer/buffer.h"
+#include "envoy/server/admin.h"
 #include "envoy/stats/custom_stat_namespaces.h"
 #include "envoy/stats/histogram.h"
 #include "envoy/stats/stats.h"
+#include "envoy/stats/store.h"
 
+#include "source/common/stats/symbol_table.h"
 #include "source/server/admin/stats_params.h"
 
+#include "absl/container/flat_hash_map.h"
+
 namespace Envoy {
 namespace Server {
 /**
@@ -18,6 +24,53 @@ namespace Server {
  */
 class PrometheusStatsFormatter {
 public:
+  /**
+   * Caches the sanitized Prometheus names of metric families and tags, so they
+   * can be reused across scrapes. The names only depend on the stat names and
+   * the custom stat namespaces, which are fixed for the lifetime of the cache.
+   * This is not thread-safe; it is intended to be used from the main thread.
+   */
+  class NameCache {
+  public:
+    NameCache(Stats::SymbolTable& symbol_table,
+              const Stats::CustomStatNamespaces& custom_namespaces);
+
+    /**
+     * @return the prefixed metric name for the tag-extracted stat name, as
+     *         computed by metricName(), or nullopt if it can't be exported.
+     */
+    const absl::optional<std::string>& metricName(Stats::StatName tag_extracted_name);
+
+    /**
+     * @return the sanitized label name for a tag name.
+     */
+    const std::string& tagName(const std::string& name);
+
+    /**
+     * Drops the metric names that were not looked up since the previous call,
+     * so that families of removed stats don't accumulate.
+     */
+    void sweep();
+
+    uint64_t size() const { return metric_names_.size(); }
+
+  private:
+    struct CachedMetricName {
+      CachedMetricName(Stats::StatName stat_name, Stats::SymbolTable& symbol_table)
+          : storage_(stat_name, symbol_table) {}
+
+      Stats::StatNameManagedStorage storage_;
+      absl::optional<std::string> name_;
+      bool used_{true};
+    };
+
+    Stats::SymbolTable& symbol_table_;
+    const Stats::CustomStatNamespaces& custom_namespaces_;
+    // Keyed by the StatName held in the value, which is why the value is boxed.
+    Stats::StatNameHashMap<std::unique_ptr<CachedMetricName>> metric_names_;
+    absl::flat_hash_map<std::string, std::string> tag_names_;
+  };
+
   // Responsible for converting groups of metrics into the raw output format (such as prometheus
   // text exposition format or prometheus protobuf exposition format).
   class OutputFormat {
@@ -34,6 +87,9 @@ public:
 
     HistogramType histogramType() const { return histogram_type_; }
 
+    // Sets the cache used to sanitize tag names, which may be nullptr.
+    void setNameCache(NameCache* name_cache) { name_cache_ = name_cache; }
+
     // Return the prometheus output for a group of Counters.
     virtual void generateOutput(Buffer::Instance& output,
                                 const std::vector<const Stats::Counter*>& counters,
@@ -64,8 +120,16 @@ public:
                                 const std::vector<const Stats::ParentHistogram*>& histograms,
                                 const std::string& prefixed_tag_extracted_name) const PURE;
 
+  protected:
+    // Equivalent to PrometheusStatsFormatter::formattedTags(), using the name cache if set.
+    std::string formatTags(const std::vector<Stats::Tag>& tags) const;
+
+    // Sanitizes a tag name for use as a label name, using the name cache if set.
+    std::string labelName(const std::string& tag_name) const;
+
   private:
     HistogramType histogram_type_;
+    NameCache* name_cache_{nullptr};
   };
 
   /**
@@ -136,5 +200,94 @@ public:
              const Stats::CustomStatNamespaces& custom_namespace_factory);
 };
 
+/**
+ * Streams stats in Prometheus format in chunks. Rather than snapshotting all
+ * the stats and rendering them in one pass, this collects the metric families
+ * of one stat type at a time, in order of tag-extracted name, and renders
+ * families until the chunk is full, releasing them as they are emitted. The
+ * output is identical to PrometheusStatsFormatter::statsAsPrometheus().
+ *
+ * The families are collected in batches of about batch size stats, each batch
+ * resuming after the last family of the previous one. A family gathers the
+ * stats of every scope sharing its tag-extracted name, so collecting a batch
+ * walks all the stats of the type, but only holds on to those of the batch.
+ * Peak memory is bounded by the batch size, or by the largest family if that is
+ * larger, and each call to nextChunk() walks the store at most once.
+ */
+class PrometheusStatsRequest : public Admin::Request {
+public:
+  static constexpr uint64_t DefaultChunkSize = 2 * 1000 * 1000;
+  static constexpr uint64_t DefaultBatchSize = 100 * 1000;
+
+  /**
+   * @param name_cache optional cache of sanitized names, which must outlive the request.
+   */
+  PrometheusStatsRequest(Stats::Store& stats, const StatsParams& params,
+                         const Upstream::ClusterManager& cluster_manager,
+                         const Http::RequestHeaderMap& request_headers,
+                         const Stats::CustomStatNamespaces& custom_namespaces,
+                         PrometheusStatsFormatter::NameCache* name_cache);
+
+  // Admin::Request
+  Http::Code start(Http::ResponseHeaderMap& response_headers) override;
+  bool nextChunk(Buffer::Instance& response) override;
+
+  // Sets the chunk size.
+  void setChunkSize(uint64_t chunk_size) { chunk_size_ = chunk_size; }
+
+  // Sets the number of stats to collect per batch.
+  void setBatchSize(uint64_t batch_size) { batch_size_ = batch_size; }
+
+private:
+  // Ordered as stat types are emitted by PrometheusStatsFormatter.
+  enum class Phase { Counters, Gauges, TextReadouts, Histograms, HostMetrics, Done };
+
+  template <class StatType>
+  using MetricGroups =
+      std::map<Stats::StatName, std::vector<Stats::RefcountPtr<StatType>>, Stats::StatNameLessThan>;
+
+  // Advances to the next phase.
+  void startPhase(Phase phase);
+
+  // Collects the next batch of metric families of the current phase.
+  void collectBatch();
+
+  // Renders the collected families of the current phase until the response
+  // reaches limit. Returns true when all of them have been rendered.
+  bool renderBatch(Buffer::Instance& response, uint64_t limit);
+
+  // Collects the metrics of a type that pass the filters, grouped by
+  // tag-extracted name, for the families after resume_after_, until about
+  // batch_size_ metrics are collected. Returns true if the batch holds the
+  // last family of the type.
+  template <class StatType>
+  bool populateGroups(MetricGroups<StatType>& groups,
+                      const std::function<void(const Stats::StatFn<StatType>&)>& for_each);
+
+  // Renders metric families until the response reaches limit. Returns true
+  // when all families have been rendered.
+  template <class StatType>
+  bool renderGroups(MetricGroups<StatType>& groups, Buffer::Instance& response, uint64_t limit);
+
+  Stats::Store& stats_;
+  const StatsParams params_;
+  const Upstream::ClusterManager& cluster_manager_;
+  const Stats::CustomStatNamespaces& custom_namespaces_;
+  PrometheusStatsFormatter::NameCache* const name_cache_;
+  const bool use_protobuf_;
+  std::unique_ptr<PrometheusStatsFormatter::OutputFormat> output_format_;
+  Phase phase_{Phase::Counters};
+  // The tag-extracted name of the last family collected in the current phase.
+  std::unique_ptr<Stats::StatNameManagedStorage> resume_after_;
+  // Whether the last batch of the current phase has been collected.
+  bool last_batch_{};
+  MetricGroups<Stats::Counter> counter_groups_;
+  MetricGroups<Stats::Gauge> gauge_groups_;
+  MetricGroups<Stats::TextReadout> text_readout_groups_;
+  MetricGroups<Stats::ParentHistogram> histogram_groups_;
+  uint64_t chunk_size_{DefaultChunkSize};
+  uint64_t batch_size_{DefaultBatchSize};
+};
+
 } // namespace Server
 } // namespace Envoy
@@ -1,7 +1,9 @@
 #include "source/server/admin/server_info_handler.h"
 
 #include "envoy/admin/v3/memory.pb.h"
+#include "envoy/admin/v3/slow_callbacks.pb.h"
 
+#include "source/common/event/slow_callback_tracker.h"
 #include "source/common/http/headers.h"
 #include "source/common/memory/stats.h"
 #include "source/common/version/version.h"
@@ -110,5 +112,34 @@ Http::Code ServerInfoHandler::handlerServerInfo(Http::ResponseHeaderMap& headers
   return Http::Code::OK;
 }
 
+Http::Code ServerInfoHandler::handlerSlowCallbacks(Http::ResponseHeaderMap& response_headers,
+                                                   Buffer::Instance& response, AdminStream&) {
+  if (!server_.bootstrap().has_slow_callback_tracker()) {
+    response.add("Slow callback tracking is not enabled. To enable, set slow_callback_tracker in "
+                 "the bootstrap.\n");
+    return Http::Code::NotFound;
+  }
+
+  response_headers.setReferenceContentType(Http::Headers::get().ContentTypeValues.Json);
+  envoy::admin::v3::SlowCallbacks slow_callbacks;
+  Event::SlowCallbackTracker::forEach([&slow_callbacks](
+                                          const Event::SlowCallbackTracker& tracker) {
+    envoy::admin::v3::DispatcherSlowCallbacks& dispatcher = *slow_callbacks.add_dispatchers();
+    dispatcher.set_name(tracker.dispatcherName());
+    dispatcher.set_sampled_callbacks(tracker.sampledCallbacks());
+    dispatcher.set_slow_callbacks(tracker.slowCallbacks());
+    for (const Event::SlowCallbackTracker::Record& record : tracker.records()) {
+      envoy::admin::v3::SlowCallback& callback = *dispatcher.add_callbacks();
+      TimestampUtil::systemClockToTimestamp(record.time_, *callback.mutable_time());
+      callback.set_type(static_cast<envoy::admin::v3::SlowCallback::Type>(record.type_));
+      *callback.mutable_duration() =
+          Protobuf::util::TimeUtil::MicrosecondsToDuration(record.duration_.count());
+      callback.set_tracked_object(record.tracked_object_);
+    }
+  });
+  response.add(MessageUtil::getJsonStringFromMessageOrError(slow_callbacks, true, true));
+  return Http::Code::OK;
+}
+
 } // namespace Server
 } // namespace Envoy
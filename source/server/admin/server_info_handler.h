@@ -35,6 +35,9 @@ public:
 
   Http::Code handleMemoryTcmallocStats(Http::ResponseHeaderMap& response_headers,
                                        Buffer::Instance& response, AdminStream&);
+
+  Http::Code handlerSlowCallbacks(Http::ResponseHeaderMap& response_headers,
+                                  Buffer::Instance& response, AdminStream&);
 };
 
 } // namespace Server
@@ -20,33 +20,6 @@ namespace Server {
 
 const uint64_t RecentLookupsCapacity = 100;
 
-namespace {
-// Implements a chunked request for Prometheus stats.
-class PrometheusRequest : public Admin::Request {
-public:
-  PrometheusRequest(StatsHandler& handler, const StatsParams& params, AdminStream& admin_stream)
-      : handler_(handler), params_(params), admin_stream_(admin_stream) {}
-
-  Http::Code start(Http::ResponseHeaderMap& response_headers) override {
-    code_ = handler_.prometheusFlushAndRender(params_, admin_stream_.getRequestHeaders(),
-                                              response_headers, response_);
-    return code_;
-  }
-
-  bool nextChunk(Buffer::Instance& response) override {
-    response.move(response_);
-    return false;
-  }
-
-private:
-  StatsHandler& handler_;
-  const StatsParams params_;
-  AdminStream& admin_stream_;
-  Buffer::OwnedImpl response_;
-  Http::Code code_{Http::Code::OK};
-};
-} // namespace
-
 StatsHandler::StatsHandler(Server::Instance& server) : HandlerContextBase(server) {}
 
 Http::Code StatsHandler::handlerResetCounters(Http::ResponseHeaderMap&, Buffer::Instance& response,
@@ -107,14 +80,7 @@ Admin::RequestPtr StatsHandler::makeRequest(AdminStream& admin_stream) {
   }
 
   if (params.format_ == StatsFormat::Prometheus) {
-    // TODO(#16139): modify streaming algorithm to cover Prometheus.
-    //
-    // This may be easiest to accomplish by populating the set
-    // with tagExtractedName(), and allowing for vectors of
-    // stats as multiples will have the same tag-extracted names.
-    // Ideally we'd find a way to do this without slowing down
-    // the non-Prometheus implementations.
-    return std::make_unique<PrometheusRequest>(*this, params, admin_stream);
+    return makePrometheusRequest(params, admin_stream);
   }
 
   if (params.histogram_buckets_mode_ == Utility::HistogramBucketsMode::PrometheusNative) {
@@ -143,10 +109,35 @@ Admin::RequestPtr StatsHandler::makeRequest(Stats::Store& stats, const StatsPara
   return std::make_unique<StatsRequest>(stats, params, cluster_manager, url_handler_fn);
 }
 
-Http::Code StatsHandler::handlerPrometheusStats(Http::ResponseHeaderMap& response_headers,
-                                                Buffer::Instance& response,
-                                                AdminStream& admin_stream) {
-  return prometheusStats(admin_stream.getRequestHeaders(), response_headers, response);
+Admin::RequestPtr StatsHandler::makePrometheusRequest(AdminStream& admin_stream) {
+  StatsParams params;
+  Buffer::OwnedImpl response;
+  Http::Code code = params.parse(admin_stream.getRequestHeaders().getPathValue(), response);
+  if (code != Http::Code::OK) {
+    return Admin::makeStaticTextRequest(response, code);
+  }
+  return makePrometheusRequest(params, admin_stream);
+}
+
+Admin::RequestPtr StatsHandler::makePrometheusRequest(const StatsParams& params,
+                                                      AdminStream& admin_stream) {
+  const Http::RequestHeaderMap& request_headers = admin_stream.getRequestHeaders();
+  absl::Status params_status = PrometheusStatsFormatter::validateParams(params, request_headers);
+  if (!params_status.ok()) {
+    return Admin::makeStaticTextRequest(params_status.message(), Http::Code::BadRequest);
+  }
+  if (server_.statsConfig().flushOnAdmin()) {
+    server_.flushStats();
+  }
+
+  const Stats::CustomStatNamespaces& custom_namespaces = server_.api().customStatNamespaces();
+  if (prometheus_name_cache_ == nullptr) {
+    prometheus_name_cache_ = std::make_unique<PrometheusStatsFormatter::NameCache>(
+        server_.stats().symbolTable(), custom_namespaces);
+  }
+  return std::make_unique<PrometheusStatsRequest>(server_.stats(), params, server_.clusterManager(),
+                                                  request_headers, custom_namespaces,
+                                                  prometheus_name_cache_.get());
 }
 
 Http::Code StatsHandler::prometheusStats(const Http::RequestHeaderMap& request_headers,
@@ -10,6 +10,7 @@
 #include "envoy/server/instance.h"
 
 #include "source/server/admin/handler_ctx.h"
+#include "source/server/admin/prometheus_stats.h"
 #include "source/server/admin/stats_request.h"
 #include "source/server/admin/utils.h"
 
@@ -33,8 +34,6 @@ public:
                                               Buffer::Instance& response, AdminStream&);
   Http::Code handlerStatsRecentLookupsEnable(Http::ResponseHeaderMap& response_headers,
                                              Buffer::Instance& response, AdminStream&);
-  Http::Code handlerPrometheusStats(Http::ResponseHeaderMap& response_headers,
-                                    Buffer::Instance& response, AdminStream&);
 
   /**
    * Parses and executes a prometheus stats request.
@@ -96,6 +95,18 @@ public:
                                        const Upstream::ClusterManager& cm,
                                        StatsRequest::UrlHandlerFn url_handler_fn = nullptr);
   Admin::RequestPtr makeRequest(AdminStream&);
+
+  /**
+   * Creates a request streaming the stats in Prometheus format, as served by
+   * /stats/prometheus. Sanitized metric and label names are cached across
+   * requests.
+   */
+  Admin::RequestPtr makePrometheusRequest(AdminStream& admin_stream);
+
+private:
+  Admin::RequestPtr makePrometheusRequest(const StatsParams& params, AdminStream& admin_stream);
+
+  std::unique_ptr<PrometheusStatsFormatter::NameCache> prometheus_name_cache_;
 };
 
 } // namespace Server
@@ -1,6 +1,7 @@
 #include "source/server/hot_restart_impl.h"
 
 #include <sys/prctl.h>
+#include <sys/stat.h>
 #include <sys/types.h>
 #include <sys/un.h>
 
@@ -17,6 +18,7 @@
 #include "source/common/api/os_sys_calls_impl_hot_restart.h"
 #include "source/common/common/fmt.h"
 #include "source/common/common/lock_guard.h"
+#include "source/common/memory/shared_region.h"
 
 #include "absl/strings/string_view.h"
 
@@ -82,6 +84,54 @@ SharedMemory* attachSharedMemory(uint32_t base_id, uint32_t restart_epoch) {
   return shmem;
 }
 
+Stats::SharedStatRegionPtr attachSharedStatRegion(uint32_t base_id, uint32_t restart_epoch,
+                                                  uint64_t capacity) {
+  if (capacity == 0) {
+    return nullptr;
+  }
+  Api::OsSysCalls& os_sys_calls = Api::OsSysCallsSingleton::get();
+  Api::HotRestartOsSysCalls& hot_restart_os_sys_calls = Api::HotRestartOsSysCallsSingleton::get();
+
+  int flags = O_RDWR;
+  const std::string shmem_name = fmt::format("/envoy_shared_stats_{}", base_id);
+  if (restart_epoch == 0) {
+    flags |= O_CREAT | O_EXCL;
+    hot_restart_os_sys_calls.shmUnlink(shmem_name.c_str());
+  }
+
+  const Api::SysCallIntResult result =
+      hot_restart_os_sys_calls.shmOpen(shmem_name.c_str(), flags, S_IRUSR | S_IWUSR);
+  if (result.return_value_ == -1) {
+    if (restart_epoch > 0) {
+      // The parent keeps its stats in process memory, so they are transferred over RPC.
+      ENVOY_LOG_MISC(warn, "cannot open shared stats region {}, transferring parent stats: {}",
+                     shmem_name, errorDetails(result.errno_));
+      return nullptr;
+    }
+    PANIC(fmt::format("cannot open shared stats region {} check user permissions. Error: {}",
+                      shmem_name, errorDetails(result.errno_)));
+  }
+
+  // The parent's capacity is the one that counts, so the child maps the file at the size the
+  // parent gave it, which it did before starting the child.
+  const uint64_t size = restart_epoch == 0 ? Stats::SharedStatRegion::bytesRequired(capacity) : 0;
+  absl::StatusOr<Memory::SharedRegion::Mapping> mapping = Memory::SharedRegion::mapFile(
+      result.return_value_, shmem_name, size, std::chrono::milliseconds(0));
+  os_sys_calls.close(result.return_value_);
+  RELEASE_ASSERT(mapping.ok(), std::string(mapping.status().message()));
+
+  if (restart_epoch == 0) {
+    return Stats::SharedStatRegion::create(mapping->memory_, capacity, restart_epoch);
+  }
+  absl::StatusOr<Stats::SharedStatRegionPtr> region =
+      Stats::SharedStatRegion::attach(mapping->memory_, mapping->size_, restart_epoch);
+  RELEASE_ASSERT(region.ok(), fmt::format("Hot restart shared stats region mismatch! You must have "
+                                          "hot restarted into a not-hot-restart-compatible new "
+                                          "version of Envoy: {}",
+                                          region.status().message()));
+  return std::move(region.value());
+}
+
 void initializeMutex(pthread_mutex_t& mutex) {
   pthread_mutexattr_t attribute;
   pthread_mutexattr_init(&attribute);
@@ -97,13 +147,15 @@ void initializeMutex(pthread_mutex_t& mutex) {
 // the socket names to entirely prevent collisions between consecutive base ids.
 HotRestartImpl::HotRestartImpl(uint32_t base_id, uint32_t restart_epoch,
                                const std::string& socket_path, mode_t socket_mode,
-                               bool skip_hot_restart_on_no_parent, bool skip_parent_stats)
+                               bool skip_hot_restart_on_no_parent, bool skip_parent_stats,
+                               uint64_t stats_capacity)
     : base_id_(base_id), scaled_base_id_(base_id * 10),
       as_child_(HotRestartingChild(scaled_base_id_, restart_epoch, socket_path, socket_mode,
                                    skip_hot_restart_on_no_parent, skip_parent_stats)),
       as_parent_(HotRestartingParent(scaled_base_id_, restart_epoch, socket_path, socket_mode)),
       shmem_(attachSharedMemory(scaled_base_id_, restart_epoch)), log_lock_(shmem_->log_lock_),
-      access_log_lock_(shmem_->access_log_lock_) {
+      access_log_lock_(shmem_->access_log_lock_),
+      shared_stat_region_(attachSharedStatRegion(scaled_base_id_, restart_epoch, stats_capacity)) {
   // If our parent ever goes away just terminate us so that we don't have to rely on ops/launching
   // logic killing the entire process tree. We should never exist without our parent.
   int rc = prctl(PR_SET_PDEATHSIG, SIGTERM);
@@ -132,6 +184,9 @@ OptRef<Network::ParentDrainedCallbackRegistrar> HotRestartImpl::parentDrainedCal
 }
 
 void HotRestartImpl::initialize(Event::Dispatcher& dispatcher, Server::Instance& server) {
+  if (shared_stat_region_ != nullptr) {
+    as_child_.retainSharedParentGeneration(*server.stats().rootScope());
+  }
   as_parent_.initialize(dispatcher, server);
   as_child_.initialize(dispatcher);
 }
@@ -140,15 +195,25 @@ absl::optional<HotRestart::AdminShutdownResponse> HotRestartImpl::sendParentAdmi
   return as_child_.sendParentAdminShutdownRequest();
 }
 
-void HotRestartImpl::sendParentTerminateRequest() { as_child_.sendParentTerminateRequest(); }
+void HotRestartImpl::sendParentTerminateRequest() {
+  as_child_.sendParentTerminateRequest();
+  if (shared_stat_region_ != nullptr) {
+    // The parent's gauge contributions are dropped even if it never withdraws them.
+    shared_stat_region_->retireParentEpoch();
+  }
+}
 
 HotRestart::ServerStatsFromParent
 HotRestartImpl::mergeParentStatsIfAny(Stats::StoreRoot& stats_store) {
-  std::unique_ptr<envoy::HotRestartMessage> wrapper_msg = as_child_.getParentStats();
+  std::unique_ptr<envoy::HotRestartMessage> wrapper_msg =
+      as_child_.getParentStats(shared_stat_region_ != nullptr);
   ServerStatsFromParent response;
   // getParentStats() will happily and cleanly return nullptr if we have no parent.
   if (wrapper_msg) {
-    as_child_.mergeParentStats(stats_store, wrapper_msg->reply().stats());
+    // Shared stats hold the parent's values already.
+    if (shared_stat_region_ == nullptr) {
+      as_child_.mergeParentStats(stats_store, wrapper_msg->reply().stats());
+    }
     response.parent_memory_allocated_ = wrapper_msg->reply().stats().memory_allocated();
     response.parent_connections_ = wrapper_msg->reply().stats().num_connections();
   }
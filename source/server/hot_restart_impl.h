@@ -13,6 +13,7 @@
 
 #include "source/common/common/assert.h"
 #include "source/common/stats/allocator.h"
+#include "source/common/stats/shared_stat_region.h"
 #include "source/server/hot_restarting_child.h"
 #include "source/server/hot_restarting_parent.h"
 
@@ -45,6 +46,19 @@ static const uint64_t SHMEM_FLAGS_INITIALIZING = 0x1;
  */
 SharedMemory* attachSharedMemory(uint32_t base_id, uint32_t restart_epoch);
 
+/**
+ * Create or attach to the shared memory segment holding the stats shared with the parent and
+ * child processes, depending on whether we are the first running envoy.
+ *
+ * @param base_id uint32_t that is the base id flag used to start this Envoy.
+ * @param restart_epoch uint32_t the restart epoch flag used to start this Envoy.
+ * @param capacity uint64_t the number of stats the segment holds. No segment is used if 0.
+ * @return the stat region, or nullptr if there is none to share, e.g. because the parent was not
+ *         started with a stats capacity.
+ */
+Stats::SharedStatRegionPtr attachSharedStatRegion(uint32_t base_id, uint32_t restart_epoch,
+                                                  uint64_t capacity);
+
 /**
  * Initialize a pthread mutex for process shared locking.
  */
@@ -98,7 +112,8 @@ private:
 class HotRestartImpl : public HotRestart {
 public:
   HotRestartImpl(uint32_t base_id, uint32_t restart_epoch, const std::string& socket_path,
-                 mode_t socket_mode, bool skip_hot_restart_on_no_parent, bool skip_parent_stats);
+                 mode_t socket_mode, bool skip_hot_restart_on_no_parent, bool skip_parent_stats,
+                 uint64_t stats_capacity);
 
   // Server::HotRestart
   void drainParentListeners() override;
@@ -125,6 +140,12 @@ public:
    */
   static std::string hotRestartVersion();
 
+  /**
+   * @return the region in which stats are shared with the parent and child processes, or nullptr
+   *         if stats are transferred from the parent over RPC.
+   */
+  Stats::SharedStatRegion* sharedStatRegion() { return shared_stat_region_.get(); }
+
 private:
   friend class HotRestartUdpForwardingTestHelper;
   uint32_t base_id_;
@@ -136,6 +157,8 @@ private:
   SharedMemory* shmem_;
   ProcessSharedMutex log_lock_;
   ProcessSharedMutex access_log_lock_;
+  // Like shmem_, the memory of the region stays mapped until process end.
+  Stats::SharedStatRegionPtr shared_stat_region_;
 };
 
 } // namespace Server
@@ -147,13 +147,13 @@ int HotRestartingChild::duplicateParentListenSocket(const std::string& address,
   return wrapped_reply->reply().pass_listen_socket().fd();
 }
 
-std::unique_ptr<HotRestartMessage> HotRestartingChild::getParentStats() {
+std::unique_ptr<HotRestartMessage> HotRestartingChild::getParentStats(bool shared_memory_stats) {
   if (parent_terminated_ || skip_parent_stats_) {
     return nullptr;
   }
 
   HotRestartMessage wrapped_request;
-  wrapped_request.mutable_request()->mutable_stats();
+  wrapped_request.mutable_request()->mutable_stats()->set_shared_memory_stats(shared_memory_stats);
   main_rpc_stream_.sendHotRestartMessage(parent_address_, wrapped_request);
 
   std::unique_ptr<HotRestartMessage> wrapped_reply =
@@ -246,6 +246,9 @@ void HotRestartingChild::sendParentTerminateRequest() {
     // for details).
     stat_merger_.reset();
   }
+  if (shared_hot_restart_generation_ != nullptr) {
+    shared_hot_restart_generation_->add(parent_hot_restart_generation_);
+  }
 }
 
 void HotRestartingChild::mergeParentStats(Stats::Store& stats_store,
@@ -268,6 +271,11 @@ void HotRestartingChild::mergeParentStats(Stats::Store& stats_store,
   stat_merger_->mergeStats(stats_proto.counter_deltas(), stats_proto.gauges(), dynamics);
 }
 
+void HotRestartingChild::retainSharedParentGeneration(Stats::Scope& scope) {
+  shared_hot_restart_generation_ = &hotRestartGeneration(scope);
+  parent_hot_restart_generation_ = shared_hot_restart_generation_->value();
+}
+
 absl::Status HotRestartingChild::onSocketEventUdpForwarding() {
   std::unique_ptr<HotRestartMessage> wrapped_request;
   while ((wrapped_request =
@@ -57,12 +57,18 @@ public:
   // From Network::ParentDrainedCallbackRegistrar.
   void registerParentDrainedCallback(const Network::Address::InstanceConstSharedPtr& addr,
                                      absl::AnyInvocable<void()> action) override;
-  std::unique_ptr<envoy::HotRestartMessage> getParentStats();
+  // shared_memory_stats indicates that counters and gauges are shared with the parent in shared
+  // memory, so that the parent doesn't need to send them.
+  std::unique_ptr<envoy::HotRestartMessage> getParentStats(bool shared_memory_stats);
   void drainParentListeners();
   absl::optional<HotRestart::AdminShutdownResponse> sendParentAdminShutdownRequest();
   void sendParentTerminateRequest();
   void mergeParentStats(Stats::Store& stats_store,
                         const envoy::HotRestartMessage::Reply::Stats& stats_proto);
+  // When stats are shared with the parent in shared memory, the parent withdraws its contribution
+  // to the hot restart generation gauge when it exits. This records it, to be carried over when
+  // the parent is terminated. Must be called before this process contributes to the gauge.
+  void retainSharedParentGeneration(Stats::Scope& scope);
 
 protected:
   absl::Status onSocketEventUdpForwarding();
@@ -83,6 +89,8 @@ private:
   sockaddr_un parent_address_udp_forwarding_;
   std::unique_ptr<Stats::StatMerger> stat_merger_{};
   Stats::StatName hot_restart_generation_stat_name_;
+  Stats::Gauge* shared_hot_restart_generation_{};
+  uint64_t parent_hot_restart_generation_{};
   // There are multiple listener instances per address that must all be reactivated
   // when the parent is drained, so a multimap is used to contain them.
   std::unordered_multimap<std::string, absl::AnyInvocable<void()>>
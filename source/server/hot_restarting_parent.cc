@@ -85,7 +85,8 @@ void HotRestartingParent::onSocketEvent() {
 
     case HotRestartMessage::Request::kStats: {
       HotRestartMessage wrapped_reply;
-      internal_->exportStatsToChild(wrapped_reply.mutable_reply()->mutable_stats());
+      internal_->exportStatsToChild(wrapped_reply.mutable_reply()->mutable_stats(),
+                                    wrapped_request->request().stats().shared_memory_stats());
       main_rpc_stream_.sendHotRestartMessage(child_address_, wrapped_reply);
       break;
     }
@@ -176,7 +177,14 @@ HotRestartingParent::Internal::getListenSocketsForChild(const HotRestartMessage:
 // implementation can negate the benefit of symbolized stat names by periodically reaching the
 // magnitude of memory usage that they are meant to avoid, since this map holds full-string
 // names. The problem can be solved by splitting the export up over many chunks.
-void HotRestartingParent::Internal::exportStatsToChild(HotRestartMessage::Reply::Stats* stats) {
+void HotRestartingParent::Internal::exportStatsToChild(HotRestartMessage::Reply::Stats* stats,
+                                                       bool shared_memory_stats) {
+  stats->set_memory_allocated(Memory::Stats::totalCurrentlyAllocated());
+  stats->set_num_connections(server_->listenerManager().numConnections());
+  if (shared_memory_stats) {
+    return;
+  }
+
   server_->stats().forEachSinkedGauge(nullptr, [this, stats](Stats::Gauge& gauge) mutable {
     if (gauge.used()) {
       const std::string name = gauge.name();
@@ -197,8 +205,6 @@ void HotRestartingParent::Internal::exportStatsToChild(HotRestartMessage::Reply:
       }
     }
   });
-  stats->set_memory_allocated(Memory::Stats::totalCurrentlyAllocated());
-  stats->set_num_connections(server_->listenerManager().numConnections());
 }
 
 void HotRestartingParent::Internal::recordDynamics(HotRestartMessage::Reply::Stats* stats,
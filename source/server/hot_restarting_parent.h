@@ -36,7 +36,9 @@ public:
     envoy::HotRestartMessage
     getListenSocketsForChild(const envoy::HotRestartMessage::Request& request);
     // 'stats' is a field in the reply protobuf to be sent to the child, which we should populate.
-    void exportStatsToChild(envoy::HotRestartMessage::Reply::Stats* stats);
+    // Counters and gauges are left out if the child shares them with us in shared memory.
+    void exportStatsToChild(envoy::HotRestartMessage::Reply::Stats* stats,
+                            bool shared_memory_stats = false);
     void recordDynamics(envoy::HotRestartMessage::Reply::Stats* stats, const std::string& name,
                         Stats::StatName stat_name);
     void drainListeners();
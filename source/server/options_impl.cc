@@ -77,10 +77,21 @@ OptionsImpl::OptionsImpl(std::vector<std::string> args,
       " instance periodically during the draining period. This can potentially be an"
       " expensive operation; set this to true to reset all stats in child process.",
       cmd, false);
+  TCLAP::ValueArg<uint64_t> hot_restart_stats_capacity(
+      "", "hot-restart-stats-capacity",
+      "The number of counters and gauges to hold in shared memory, where the child instance"
+      " continues from the parent's values instead of copying them from the parent. Stats beyond"
+      " the capacity are copied as usual. 0 disables shared memory stats.",
+      false, 0, "uint64_t", cmd);
   TCLAP::ValueArg<std::string> base_id_path(
       "", "base-id-path", "Path to which the base ID is written", false, "", "string", cmd);
   TCLAP::ValueArg<uint32_t> concurrency("", "concurrency", "# of worker threads to run", false,
                                         std::thread::hardware_concurrency(), "uint32_t", cmd);
+  TCLAP::ValueArg<uint32_t> startup_concurrency(
+      "", "startup-concurrency",
+      "# of threads to build the TLS contexts of the static configuration on at startup. 0 builds"
+      " them on the main thread.",
+      false, 0, "uint32_t", cmd);
   TCLAP::ValueArg<std::string> config_path("c", "config-path", "Path to configuration file", false,
                                            "", "string", cmd);
   TCLAP::ValueArg<std::string> config_yaml(
@@ -254,6 +265,7 @@ OptionsImpl::OptionsImpl(std::vector<std::string> args,
   use_dynamic_base_id_ = use_dynamic_base_id.getValue();
   skip_hot_restart_on_no_parent_ = skip_hot_restart_on_no_parent.getValue();
   skip_hot_restart_parent_stats_ = skip_hot_restart_parent_stats.getValue();
+  hot_restart_stats_capacity_ = hot_restart_stats_capacity.getValue();
   base_id_path_ = base_id_path.getValue();
   restart_epoch_ = restart_epoch.getValue();
 
@@ -275,6 +287,7 @@ OptionsImpl::OptionsImpl(std::vector<std::string> args,
     }
     concurrency_ = std::max(1U, concurrency.getValue());
   }
+  startup_concurrency_ = startup_concurrency.getValue();
 
   config_path_ = config_path.getValue();
   config_yaml_ = config_yaml.getValue();
@@ -404,8 +417,10 @@ Server::CommandLineOptionsPtr OptionsImpl::toCommandLineOptions() const {
   command_line_options->set_use_dynamic_base_id(useDynamicBaseId());
   command_line_options->set_skip_hot_restart_on_no_parent(skipHotRestartOnNoParent());
   command_line_options->set_skip_hot_restart_parent_stats(skipHotRestartParentStats());
+  command_line_options->set_hot_restart_stats_capacity(hotRestartStatsCapacity());
   command_line_options->set_base_id_path(baseIdPath());
   command_line_options->set_concurrency(concurrency());
+  command_line_options->set_startup_concurrency(startupConcurrency());
   command_line_options->set_config_path(configPath());
   command_line_options->set_config_yaml(configYaml());
   command_line_options->set_allow_unknown_static_fields(allow_unknown_static_fields_);
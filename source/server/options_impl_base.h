@@ -34,8 +34,10 @@ public:
   void setUseDynamicBaseId(bool use_dynamic_base_id) { use_dynamic_base_id_ = use_dynamic_base_id; }
   void setSkipHotRestartOnNoParent(bool skip) { skip_hot_restart_on_no_parent_ = skip; }
   void setSkipHotRestartParentStats(bool skip) { skip_hot_restart_parent_stats_ = skip; }
+  void setHotRestartStatsCapacity(uint64_t capacity) { hot_restart_stats_capacity_ = capacity; }
   void setBaseIdPath(const std::string& base_id_path) { base_id_path_ = base_id_path; }
   void setConcurrency(uint32_t concurrency) { concurrency_ = concurrency; }
+  void setStartupConcurrency(uint32_t concurrency) { startup_concurrency_ = concurrency; }
   void setConfigPath(const std::string& config_path) { config_path_ = config_path; }
   void setConfigProto(const envoy::config::bootstrap::v3::Bootstrap& config_proto) {
     *config_proto_ = config_proto;
@@ -109,8 +111,10 @@ public:
   bool useDynamicBaseId() const override { return use_dynamic_base_id_; }
   bool skipHotRestartOnNoParent() const override { return skip_hot_restart_on_no_parent_; }
   bool skipHotRestartParentStats() const override { return skip_hot_restart_parent_stats_; }
+  uint64_t hotRestartStatsCapacity() const override { return hot_restart_stats_capacity_; }
   const std::string& baseIdPath() const override { return base_id_path_; }
   uint32_t concurrency() const override { return concurrency_; }
+  uint32_t startupConcurrency() const override { return startup_concurrency_; }
   const std::string& configPath() const override { return config_path_; }
   const envoy::config::bootstrap::v3::Bootstrap& configProto() const override {
     return *config_proto_;
@@ -184,8 +188,10 @@ private:
   bool use_dynamic_base_id_{false};
   bool skip_hot_restart_on_no_parent_{false};
   bool skip_hot_restart_parent_stats_{false};
+  uint64_t hot_restart_stats_capacity_{0};
   std::string base_id_path_;
   uint32_t concurrency_{1};
+  uint32_t startup_concurrency_{0};
   std::string config_path_;
   std::unique_ptr<envoy::config::bootstrap::v3::Bootstrap> config_proto_{
       new envoy::config::bootstrap::v3::Bootstrap()};
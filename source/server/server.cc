@@ -741,6 +741,16 @@ absl::Status InstanceBase::initializeOrThrow(Network::Address::InstanceConstShar
   if (bootstrap_.enable_dispatcher_stats()) {
     dispatcher_->initializeStats(*stats_store_.rootScope(), "server.");
   }
+  if (bootstrap_.has_slow_callback_tracker()) {
+    dispatcher_->initializeSlowCallbackTracker(
+        Utility::slowCallbackTrackerConfig(bootstrap_.slow_callback_tracker()));
+  }
+  if (bootstrap_.has_continuous_cpu_profiler()) {
+    auto profiler_or_error =
+        Profiler::ContinuousCpuProfiler::create(bootstrap_.continuous_cpu_profiler(), *dispatcher_);
+    RETURN_IF_NOT_OK_REF(profiler_or_error.status());
+    continuous_cpu_profiler_ = std::move(profiler_or_error.value());
+  }
 
   // The broad order of initialization from this point on is the following:
   // 1. Statically provisioned configuration (bootstrap) are loaded.
@@ -831,7 +841,13 @@ absl::Status InstanceBase::initializeOrThrow(Network::Address::InstanceConstShar
   // thread local data per above. See MainImpl::initialize() for why ConfigImpl
   // is constructed as part of the InstanceBase and then populated once
   // cluster_manager_factory_ is available.
+  // The TLS contexts of the static clusters and listeners are built in parallel when
+  // --startup-concurrency is set. The cluster manager builds those of the clusters before it
+  // starts any xDS connection, and those of the listeners are built here, before workers start.
+  ssl_context_manager_->deferContextBuilds(options_.startupConcurrency());
   RETURN_IF_NOT_OK(config_.initialize(bootstrap_, *this, *cluster_manager_factory_));
+  RETURN_IF_NOT_OK(ssl_context_manager_->buildDeferredContexts());
+  ssl_context_manager_->deferContextBuilds(0);
 
   // Instruct the listener manager to create the LDS provider if needed. This must be done later
   // because various items do not yet exist when the listener manager is created.
@@ -1075,6 +1091,7 @@ void InstanceBase::run() {
   }
 
   main_dispatch_loop_started_.store(true);
+  Profiler::ContinuousCpuProfiler::setThreadLabel("main_thread");
 
   dispatcher_->post([this] { notifyCallbacksForStage(Stage::Startup); });
   dispatcher_->run(Event::Dispatcher::RunType::Block);
@@ -34,6 +34,7 @@
 #include "source/common/http/context_impl.h"
 #include "source/common/init/manager_impl.h"
 #include "source/common/memory/stats.h"
+#include "source/common/profiler/continuous_cpu_profiler.h"
 #include "source/common/protobuf/message_validator_impl.h"
 #include "source/common/quic/quic_stat_names.h"
 #include "source/common/router/context_impl.h"
@@ -413,6 +414,7 @@ private:
   Configuration::MainImpl config_;
   Network::DnsResolverSharedPtr dns_resolver_;
   Event::TimerPtr stat_flush_timer_;
+  Profiler::ContinuousCpuProfilerPtr continuous_cpu_profiler_;
   DrainManagerPtr drain_manager_;
   std::unique_ptr<Upstream::ClusterManagerFactory> cluster_manager_factory_;
   std::unique_ptr<Server::GuardDog> main_thread_guard_dog_;
@@ -3,6 +3,7 @@
 #include "envoy/common/exception.h"
 
 #include "source/common/common/assert.h"
+#include "source/common/protobuf/utility.h"
 
 namespace Envoy {
 namespace Server {
@@ -53,6 +54,13 @@ absl::Status maybeSetApplicationLogFormat(
   return absl::OkStatus();
 }
 
+Event::SlowCallbackTrackerConfig
+slowCallbackTrackerConfig(const envoy::config::bootstrap::v3::SlowCallbackTracker& config) {
+  return {std::chrono::milliseconds(PROTOBUF_GET_MS_OR_DEFAULT(config, threshold, 50)),
+          PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, sampling_interval, 10),
+          PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_records, 64)};
+}
+
 } // namespace Utility
 } // namespace Server
 } // namespace Envoy
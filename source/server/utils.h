@@ -2,6 +2,7 @@
 
 #include "envoy/admin/v3/server_info.pb.h"
 #include "envoy/config/bootstrap/v3/bootstrap.pb.h"
+#include "envoy/event/dispatcher.h"
 #include "envoy/init/manager.h"
 #include "envoy/server/options.h"
 
@@ -23,6 +24,13 @@ absl::Status assertExclusiveLogFormatMethod(
 absl::Status maybeSetApplicationLogFormat(
     const envoy::config::bootstrap::v3::Bootstrap::ApplicationLogConfig& application_log_config);
 
+/**
+ * @return the dispatcher slow callback tracker configuration of the bootstrap, with defaults
+ *         applied.
+ */
+Event::SlowCallbackTrackerConfig
+slowCallbackTrackerConfig(const envoy::config::bootstrap::v3::SlowCallbackTracker& config);
+
 } // namespace Utility
 } // namespace Server
 } // namespace Envoy
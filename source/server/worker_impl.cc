@@ -10,7 +10,9 @@
 #include "envoy/thread_local/thread_local.h"
 
 #include "source/common/config/utility.h"
+#include "source/common/profiler/continuous_cpu_profiler.h"
 #include "source/server/listener_manager_factory.h"
+#include "source/server/utils.h"
 
 namespace Envoy {
 namespace Server {
@@ -121,6 +123,11 @@ void WorkerImpl::start(OptRef<GuardDog> guard_dog, const std::function<void()>&
 
 void WorkerImpl::initializeStats(Stats::Scope& scope) { dispatcher_->initializeStats(scope); }
 
+void WorkerImpl::initializeSlowCallbackTracker(
+    const envoy::config::bootstrap::v3::SlowCallbackTracker& config) {
+  dispatcher_->initializeSlowCallbackTracker(Utility::slowCallbackTrackerConfig(config));
+}
+
 void WorkerImpl::stop() {
   // It's possible for the server to cleanly shut down while cluster initialization during startup
   // is happening, so we might not yet have a thread.
@@ -144,6 +151,7 @@ void WorkerImpl::stopListener(Network::ListenerConfig& listener,
 
 void WorkerImpl::threadRoutine(OptRef<GuardDog> guard_dog, const std::function<void()>& cb) {
   ENVOY_LOG(debug, "worker entering dispatch loop");
+  Profiler::ContinuousCpuProfiler::setThreadLabel(dispatcher_->name());
   // The watch dog must be created after the dispatcher starts running and has post events flushed,
   // as this is when TLS stat scopes start working.
   dispatcher_->post([this, &guard_dog, cb]() {
@@ -64,6 +64,8 @@ public:
                           std::function<void()> completion) override;
   void start(OptRef<GuardDog> guard_dog, const std::function<void()>& cb) override;
   void initializeStats(Stats::Scope& scope) override;
+  void initializeSlowCallbackTracker(
+      const envoy::config::bootstrap::v3::SlowCallbackTracker& config) override;
   void stop() override;
   void stopListener(Network::ListenerConfig& listener,
                     const Network::ExtraShutdownListenerOptions& options,
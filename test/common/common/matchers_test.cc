@@ -498,6 +498,83 @@ TEST_F(StringMatcher, Memory) {
   }
 }
 
+class StringMatcherList : public BaseTest {
+public:
+  Protobuf::RepeatedPtrField<envoy::type::matcher::v3::StringMatcher> parseMatchers(
+      const std::string& yaml) {
+    envoy::type::matcher::v3::ListStringMatcher list;
+    TestUtility::loadFromYaml(yaml, list);
+    return list.patterns();
+  }
+};
+
+// The first matching matcher is reported in list order, whether it is evaluated through the regex
+// set or on its own.
+TEST_F(StringMatcherList, FirstMatch) {
+  const Matchers::StringMatcherListImpl list(parseMatchers(R"EOF(
+patterns:
+- safe_regex:
+    regex: "x-[a-z]+-id"
+- exact: "x-request-id"
+- prefix: "x-"
+- safe_regex:
+    regex: "x-.*"
+- safe_regex:
+    google_re2: {}
+    regex: "y-.*"
+- safe_regex:
+    regex: "y-[0-9]+"
+)EOF"),
+                                             context_);
+  EXPECT_EQ(6, list.size());
+  EXPECT_EQ(0, list.firstMatch("x-request-id"));
+  EXPECT_EQ(2, list.firstMatch("x-1"));
+  EXPECT_EQ(4, list.firstMatch("y-12"));
+  EXPECT_EQ(absl::nullopt, list.firstMatch("z"));
+  EXPECT_TRUE(list.anyMatch("y-a"));
+  EXPECT_FALSE(list.anyMatch("authorization"));
+}
+
+// Matches are the same as evaluating each matcher in turn.
+TEST_F(StringMatcherList, SameAsSequentialMatching) {
+  const auto matchers = parseMatchers(R"EOF(
+patterns:
+- safe_regex:
+    regex: "/api/v[0-9]+/users"
+- suffix: ".css"
+- safe_regex:
+    regex: "/api/.+"
+- safe_regex:
+    regex: "/static/.+"
+- contains: "admin"
+- safe_regex:
+    regex: ".*admin.*"
+)EOF");
+  const Matchers::StringMatcherListImpl list(matchers, context_);
+  for (absl::string_view value : {"/api/v1/users", "/static/a.css", "/static/", "/admin", "",
+                                  "/api/", "/api/v1/admin", "/other"}) {
+    absl::optional<uint32_t> expected;
+    for (int i = 0; i < matchers.size(); ++i) {
+      if (Matchers::StringMatcherImpl(matchers[i], context_).match(value)) {
+        expected = i;
+        break;
+      }
+    }
+    EXPECT_EQ(expected, list.firstMatch(value)) << value;
+  }
+}
+
+TEST_F(StringMatcherList, MatcherPointers) {
+  std::vector<Matchers::StringMatcherPtr> matchers;
+  envoy::type::matcher::v3::StringMatcher matcher;
+  matcher.set_exact("foo");
+  matchers.push_back(std::make_unique<Matchers::StringMatcherImpl>(matcher, context_));
+  const Matchers::StringMatcherListImpl list(std::move(matchers));
+  EXPECT_FALSE(list.empty());
+  EXPECT_TRUE(list.anyMatch("foo"));
+  EXPECT_FALSE(list.anyMatch("bar"));
+}
+
 class PathMatcher : public BaseTest {};
 
 TEST_F(PathMatcher, MatchExactPath) {
@@ -1,13 +1,16 @@
 // Note: this should be run with --compilation_mode=opt, and would benefit from
 // a quiescent system with disabled cstate power management.
 
+#include <algorithm>
 #include <regex>
 
 #include "source/common/common/assert.h"
 
+#include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
 #include "benchmark/benchmark.h"
 #include "re2/re2.h"
+#include "re2/set.h"
 
 // NOLINT(namespace-envoy)
 
@@ -126,3 +129,70 @@ static void BM_RE2_AltPattern(benchmark::State& state) {
   RELEASE_ASSERT(passes > 0, "");
 }
 BENCHMARK(BM_RE2_AltPattern);
+
+// Builds a route table like list of path regexes, e.g. "/api/v2/service17/[a-z]+/[0-9]+".
+static std::vector<std::string> routePatterns(int64_t count) {
+  std::vector<std::string> patterns;
+  patterns.reserve(count);
+  for (int64_t i = 0; i < count; ++i) {
+    patterns.push_back(absl::StrCat("/api/v", i % 3, "/service", i, "/[a-z]+/[0-9]+"));
+  }
+  return patterns;
+}
+
+// Paths that match the first pattern, no pattern at all and the last pattern.
+static std::vector<std::string> routePaths(int64_t count) {
+  const int64_t last = count - 1;
+  std::vector<std::string> paths{"/api/v0/service0/users/42", "/static/assets/app.js"};
+  paths.push_back(absl::StrCat("/api/v", last % 3, "/service", last, "/orders/7"));
+  return paths;
+}
+
+// Matches a path against every pattern in turn, which is what a route table without multi-pattern
+// matching does for a path that only matches a late route or none at all.
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_RE2_SequentialPatterns(benchmark::State& state) {
+  std::vector<std::unique_ptr<re2::RE2>> regexes;
+  for (const std::string& pattern : routePatterns(state.range(0))) {
+    regexes.push_back(std::make_unique<re2::RE2>(pattern));
+  }
+  const std::vector<std::string> paths = routePaths(state.range(0));
+  uint32_t passes = 0;
+  for (auto _ : state) { // NOLINT
+    for (const std::string& path : paths) {
+      for (const auto& regex : regexes) {
+        if (re2::RE2::FullMatch(path, *regex)) {
+          ++passes;
+          break;
+        }
+      }
+    }
+  }
+  RELEASE_ASSERT(passes > 0, "");
+}
+BENCHMARK(BM_RE2_SequentialPatterns)->Arg(100)->Arg(1000);
+
+// Matches a path against all patterns at once with an anchored RE2::Set, which is what sibling
+// safe_regex matchers compiled into a matcher set by the google_re2 engine do, and picks the first
+// matching pattern.
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_RE2_SetPatterns(benchmark::State& state) {
+  re2::RE2::Set set(re2::RE2::Quiet, re2::RE2::ANCHOR_BOTH);
+  for (const std::string& pattern : routePatterns(state.range(0))) {
+    RELEASE_ASSERT(set.Add(pattern, nullptr) >= 0, "");
+  }
+  RELEASE_ASSERT(set.Compile(), "");
+  const std::vector<std::string> paths = routePaths(state.range(0));
+  std::vector<int> matched;
+  uint32_t passes = 0;
+  for (auto _ : state) { // NOLINT
+    for (const std::string& path : paths) {
+      if (set.Match(path, &matched)) {
+        benchmark::DoNotOptimize(*std::min_element(matched.begin(), matched.end()));
+        ++passes;
+      }
+    }
+  }
+  RELEASE_ASSERT(passes > 0, "");
+}
+BENCHMARK(BM_RE2_SetPatterns)->Arg(100)->Arg(1000);
@@ -140,6 +140,43 @@ TEST(Utility, ParseRegex) {
   }
 }
 
+// A matcher set reports exactly the expressions whose individual matchers match.
+TEST(GoogleReEngine, MatcherSet) {
+  GoogleReEngine engine;
+  const std::vector<std::string> regexes{"/api/v[0-9]+/users", "/api/.+", "/static/.+", "users",
+                                         "/api/v1/users/[0-9]+"};
+  auto set = engine.matcherSet(regexes);
+  ASSERT_TRUE(set.ok());
+  EXPECT_EQ(5, (*set)->size());
+
+  std::vector<uint32_t> matched;
+  EXPECT_TRUE((*set)->match("/api/v1/users", matched));
+  EXPECT_EQ((std::vector<uint32_t>{0, 1}), matched);
+
+  EXPECT_TRUE((*set)->match("/api/v1/users/42", matched));
+  EXPECT_EQ((std::vector<uint32_t>{1, 4}), matched);
+
+  EXPECT_TRUE((*set)->match("/other", matched));
+  EXPECT_TRUE(matched.empty());
+
+  for (absl::string_view value :
+       {"/api/v1/users", "/static/users/a.css", "users", "/users", "/", "", "/api/"}) {
+    EXPECT_TRUE((*set)->match(value, matched));
+    for (uint32_t i = 0; i < regexes.size(); ++i) {
+      const bool in_set = std::find(matched.begin(), matched.end(), i) != matched.end();
+      EXPECT_EQ(engine.matcher(regexes[i]).value()->match(value), in_set)
+          << regexes[i] << " " << value;
+    }
+  }
+}
+
+TEST(GoogleReEngine, MatcherSetInvalidExpression) {
+  GoogleReEngine engine;
+  auto set = engine.matcherSet({"/api/.+", "/api/("});
+  EXPECT_FALSE(set.ok());
+  EXPECT_EQ(absl::StatusCode::kInvalidArgument, set.status().code());
+}
+
 } // namespace
 } // namespace Regex
 } // namespace Envoy
@@ -360,6 +360,56 @@ TEST_F(ConnPoolImplBaseTest, ExplicitPreconnectNotHealthy) {
   EXPECT_FALSE(pool_.maybePreconnectImpl(1));
 }
 
+TEST_F(ConnPoolImplDispatcherBaseTest, AdaptivePreconnect) {
+  cluster_->adaptive_preconnect_ =
+      Upstream::AdaptivePreconnectConfig{std::chrono::milliseconds(1000), 1.5};
+  ON_CALL(*cluster_, maxConnectionDuration)
+      .WillByDefault(Return(absl::optional<std::chrono::milliseconds>()));
+  Upstream::ClusterTrafficStats& stats = *cluster_->traffic_stats_;
+
+  // With no demand yet, the first stream is provisioned for 1.5 streams, so one connection is
+  // preconnected along with the one for the stream.
+  EXPECT_CALL(pool_, instantiateActiveClient).Times(2);
+  pool_.newStreamImpl(context_, /*can_send_early_data=*/false);
+  CHECK_STATE(0 /*active*/, 1 /*pending*/, 2 /*capacity*/);
+  EXPECT_FALSE(clients_[0]->preconnected_);
+  EXPECT_TRUE(clients_[1]->preconnected_);
+
+  EXPECT_CALL(pool_, onPoolReady);
+  clients_[0]->onEvent(Network::ConnectionEvent::Connected);
+  clients_[1]->onEvent(Network::ConnectionEvent::Connected);
+  EXPECT_EQ(ActiveClient::State::Busy, clients_[0]->state());
+  EXPECT_EQ(ActiveClient::State::Ready, clients_[1]->state());
+
+  // The next stream uses the preconnected connection, and 3 streams are now anticipated.
+  EXPECT_CALL(pool_, onPoolReady);
+  EXPECT_CALL(pool_, instantiateActiveClient);
+  pool_.newStreamImpl(context_, /*can_send_early_data=*/false);
+  EXPECT_EQ(1, stats.upstream_cx_preconnect_hit_.value());
+  CHECK_STATE(2 /*active*/, 0 /*pending*/, 1 /*capacity*/);
+  EXPECT_TRUE(clients_[2]->preconnected_);
+
+  // Once the average demand has reached 2, a completed stream leaves its connection open.
+  time_system_.advanceTimeWait(std::chrono::seconds(10));
+  --clients_[0]->active_streams_;
+  pool_.onStreamClosed(*clients_[0], false);
+  EXPECT_EQ(ActiveClient::State::Ready, clients_[0]->state());
+  CHECK_STATE(1 /*active*/, 0 /*pending*/, 2 /*capacity*/);
+
+  // Once it has decayed to 1, the pool keeps capacity for 1.5 streams and retires the rest.
+  time_system_.advanceTimeWait(std::chrono::seconds(10));
+  --clients_[1]->active_streams_;
+  pool_.onStreamClosed(*clients_[1], false);
+  EXPECT_EQ(ActiveClient::State::Closed, clients_[1]->state());
+  CHECK_STATE(0 /*active*/, 0 /*pending*/, 2 /*capacity*/);
+  EXPECT_EQ(0, stats.upstream_cx_preconnect_wasted_.value());
+
+  // The connection which was preconnected but never used is wasted.
+  pool_.destructAllConnections();
+  EXPECT_EQ(1, stats.upstream_cx_preconnect_hit_.value());
+  EXPECT_EQ(1, stats.upstream_cx_preconnect_wasted_.value());
+}
+
 TEST_F(ConnPoolImplDispatcherBaseTest, MaxConnectionDurationTimerNull) {
   // Force a null max connection duration optional.
   // newActiveClientAndStream() will expect the connection duration timer to remain null.
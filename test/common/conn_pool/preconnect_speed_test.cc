@@ -0,0 +1,210 @@
+// Note: this should be run with --compilation_mode=opt.
+//
+// Simulates a step in load on a connection pool in simulated time, with a fixed connect latency and
+// connections that drain after a number of streams, and reports how long streams waited for a
+// connection under each preconnect mode. The reported time is that of the simulation itself, the
+// counters are the results:
+//   p50_wait_ms, p99_wait_ms: the percentiles of the time streams spent pending.
+//   connections: the connections established.
+//   preconnect_hit, preconnect_wasted: the upstream_cx_preconnect_* stats.
+
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include "source/common/conn_pool/conn_pool_base.h"
+
+#include "test/common/upstream/utility.h"
+#include "test/mocks/server/overload_manager.h"
+#include "test/mocks/upstream/cluster_info.h"
+#include "test/test_common/simulated_time_system.h"
+#include "test/test_common/utility.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace ConnectionPool {
+namespace {
+
+using testing::NiceMock;
+using testing::Return;
+
+constexpr std::chrono::milliseconds ConnectLatency{5};
+constexpr std::chrono::milliseconds StreamDuration{20};
+constexpr uint32_t StreamsPerConnection = 100;
+
+class SimulatedClient : public ActiveClient {
+public:
+  explicit SimulatedClient(ConnPoolImplBase& parent)
+      : ActiveClient(parent, StreamsPerConnection, 1),
+        connected_timer_(parent.dispatcher().createTimer(
+            [this]() { onEvent(Network::ConnectionEvent::Connected); })) {
+    connected_timer_->enableTimer(ConnectLatency);
+  }
+
+  void initializeReadFilters() override {}
+  void close(Network::ConnectionCloseType, absl::string_view) override {
+    connected_timer_->disableTimer();
+    parent_.onConnectionEvent(*this, "", Network::ConnectionEvent::LocalClose);
+  }
+  uint64_t id() const override { return 0; }
+  bool closingWithIncompleteStream() const override { return false; }
+  uint32_t numActiveStreams() const override { return active_streams_; }
+  absl::optional<Http::Protocol> protocol() const override { return absl::nullopt; }
+  void onEvent(Network::ConnectionEvent event) override {
+    parent_.onConnectionEvent(*this, "", event);
+  }
+
+  uint32_t active_streams_{};
+
+private:
+  const Event::TimerPtr connected_timer_;
+};
+
+struct SimulatedStream : public AttachContext {
+  explicit SimulatedStream(MonotonicTime created) : created_(created) {}
+  const MonotonicTime created_;
+};
+
+class SimulatedPool : public ConnPoolImplBase {
+public:
+  SimulatedPool(Upstream::HostConstSharedPtr host, Event::Dispatcher& dispatcher,
+                Upstream::ClusterConnectivityState& state,
+                Server::OverloadManager& overload_manager)
+      : ConnPoolImplBase(host, Upstream::ResourcePriority::Default, dispatcher, nullptr, nullptr,
+                         state, overload_manager) {}
+  ~SimulatedPool() override { destructAllConnections(); }
+
+  // Completes the streams which have run for StreamDuration.
+  void completeStreams() {
+    const MonotonicTime now = dispatcher().timeSource().monotonicTime();
+    while (!running_.empty() && running_.front().first <= now) {
+      SimulatedClient& client = *running_.front().second;
+      running_.pop_front();
+      --client.active_streams_;
+      onStreamClosed(client, false);
+    }
+  }
+
+  bool hasRunningStreams() const { return !running_.empty(); }
+
+  // ConnPoolImplBase
+  ConnectionPool::Cancellable* newPendingStream(AttachContext& context,
+                                                bool can_send_early_data) override {
+    return addPendingStream(
+        std::make_unique<PendingStreamImpl>(*this, context, can_send_early_data));
+  }
+  ActiveClientPtr instantiateActiveClient() override {
+    auto client = std::make_unique<SimulatedClient>(*this);
+    client->real_host_description_ = host();
+    return client;
+  }
+  void onPoolFailure(const Upstream::HostDescriptionConstSharedPtr&, absl::string_view,
+                     ConnectionPool::PoolFailureReason, AttachContext&) override {
+    ++failures_;
+  }
+  void onPoolReady(ActiveClient& client, AttachContext& context) override {
+    const MonotonicTime now = dispatcher().timeSource().monotonicTime();
+    waits_ms_.push_back(std::chrono::duration<double, std::milli>(
+                            now - typedContext<SimulatedStream>(context).created_)
+                            .count());
+    auto& simulated_client = static_cast<SimulatedClient&>(client);
+    ++simulated_client.active_streams_;
+    running_.emplace_back(now + StreamDuration, &simulated_client);
+  }
+
+  std::vector<double> waits_ms_;
+  uint64_t failures_{};
+
+private:
+  class PendingStreamImpl : public PendingStream {
+  public:
+    PendingStreamImpl(ConnPoolImplBase& parent, AttachContext& context, bool can_send_early_data)
+        : PendingStream(parent, can_send_early_data), context_(context) {}
+    AttachContext& context() override { return context_; }
+
+  private:
+    AttachContext& context_;
+  };
+
+  // The streams attached to connections, in the order they complete.
+  std::deque<std::pair<MonotonicTime, SimulatedClient*>> running_;
+};
+
+double percentile(std::vector<double>& values, double fraction) {
+  if (values.empty()) {
+    return 0;
+  }
+  auto nth = values.begin() + static_cast<size_t>(fraction * (values.size() - 1));
+  std::nth_element(values.begin(), nth, values.end());
+  return *nth;
+}
+
+} // namespace
+
+// Runs a second of 1 new stream per millisecond followed by a second of 10 per millisecond, for
+// each preconnect mode: 0 for none, 1 for a per-upstream ratio of 1.5, and 2 for adaptive
+// preconnecting with a headroom ratio of 1.5.
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_PreconnectStepLoad(::benchmark::State& state) {
+  const int64_t mode = state.range(0);
+  std::vector<double> waits_ms;
+  uint64_t connections = 0;
+  uint64_t preconnect_hit = 0;
+  uint64_t preconnect_wasted = 0;
+  for (auto _ : state) { // NOLINT
+    Event::SimulatedTimeSystem time_system;
+    Api::ApiPtr api = Api::createApiForTest(time_system);
+    Event::DispatcherPtr dispatcher = api->allocateDispatcher("test_thread");
+    auto cluster = std::make_shared<NiceMock<Upstream::MockClusterInfo>>();
+    cluster->resetResourceManager(1 << 20, 1 << 20, 1 << 20, 1, 1);
+    if (mode == 1) {
+      ON_CALL(*cluster, perUpstreamPreconnectRatio()).WillByDefault(Return(1.5));
+    } else if (mode == 2) {
+      cluster->adaptive_preconnect_ =
+          Upstream::AdaptivePreconnectConfig{std::chrono::milliseconds(1000), 1.5};
+    }
+    Upstream::HostSharedPtr host = Upstream::makeTestHost(cluster, "tcp://127.0.0.1:80");
+    Upstream::ClusterConnectivityState connectivity_state;
+    NiceMock<Server::MockOverloadManager> overload_manager;
+    std::deque<SimulatedStream> streams;
+    {
+      SimulatedPool pool(host, *dispatcher, connectivity_state, overload_manager);
+      for (uint32_t ms = 0; ms < 2000; ++ms) {
+        const uint32_t new_streams = ms < 1000 ? 1 : 10;
+        for (uint32_t i = 0; i < new_streams; ++i) {
+          streams.emplace_back(time_system.monotonicTime());
+          pool.newStreamImpl(streams.back(), false);
+        }
+        time_system.advanceTimeAndRun(std::chrono::milliseconds(1), *dispatcher,
+                                      Event::Dispatcher::RunType::NonBlock);
+        pool.completeStreams();
+      }
+      while (pool.hasRunningStreams() || pool.hasPendingStreams()) {
+        time_system.advanceTimeAndRun(std::chrono::milliseconds(1), *dispatcher,
+                                      Event::Dispatcher::RunType::NonBlock);
+        pool.completeStreams();
+      }
+      if (pool.failures_ != 0) {
+        state.SkipWithError("Streams failed");
+      }
+      waits_ms = std::move(pool.waits_ms_);
+    }
+    dispatcher->clearDeferredDeleteList();
+    const Upstream::ClusterTrafficStats& stats = *cluster->traffic_stats_;
+    connections = stats.upstream_cx_total_.value();
+    preconnect_hit = stats.upstream_cx_preconnect_hit_.value();
+    preconnect_wasted = stats.upstream_cx_preconnect_wasted_.value();
+  }
+  state.counters["p50_wait_ms"] = percentile(waits_ms, 0.5);
+  state.counters["p99_wait_ms"] = percentile(waits_ms, 0.99);
+  state.counters["connections"] = connections;
+  state.counters["preconnect_hit"] = preconnect_hit;
+  state.counters["preconnect_wasted"] = preconnect_wasted;
+}
+BENCHMARK(BM_PreconnectStepLoad)->Arg(0)->Arg(1)->Arg(2)->Unit(::benchmark::kMillisecond);
+
+} // namespace ConnectionPool
+} // namespace Envoy
@@ -561,6 +561,29 @@ TEST_F(DispatcherImplTest, Timer) {
   timerTest([](Timer& timer) { timer.enableHRTimer(std::chrono::microseconds(50)); });
 }
 
+TEST_F(DispatcherImplTest, WheelTimer) {
+  TimerPtr timer;
+  dispatcher_->post([this, &timer]() {
+    Thread::LockGuard lock(mu_);
+    timer = dispatcher_->createWheelTimer([this]() {
+      {
+        Thread::LockGuard lock(mu_);
+        ASSERT(!work_finished_);
+        work_finished_ = true;
+      }
+      cv_.notifyOne();
+    });
+    EXPECT_FALSE(timer->enabled());
+    timer->enableTimer(std::chrono::milliseconds(10));
+    EXPECT_TRUE(timer->enabled());
+  });
+
+  Thread::LockGuard lock(mu_);
+  while (!work_finished_) {
+    cv_.wait(mu_);
+  }
+}
+
 TEST_F(DispatcherImplTest, TimerWithScope) {
   TimerPtr timer;
   MockScopeTrackedObject scope;
@@ -1492,6 +1515,92 @@ TEST_F(DispatcherWithWatchdogTest, TouchBeforeFdEvent) {
   dispatcher_->run(Dispatcher::RunType::NonBlock);
 }
 
+class DispatcherWithSlowCallbackTrackerTest : public testing::Test {
+protected:
+  DispatcherWithSlowCallbackTrackerTest()
+      : api_(Api::createApiForTest(time_system_)),
+        dispatcher_(api_->allocateDispatcher("slow_callback_test_thread")) {
+    dispatcher_->initializeSlowCallbackTracker({std::chrono::milliseconds(10), 1, 64});
+    // The tracker is created by a post callback.
+    dispatcher_->run(Dispatcher::RunType::NonBlock);
+  }
+
+  std::vector<SlowCallbackTracker::Record> records() {
+    std::vector<SlowCallbackTracker::Record> records;
+    SlowCallbackTracker::forEach([&records](const SlowCallbackTracker& tracker) {
+      if (tracker.dispatcherName() == "slow_callback_test_thread") {
+        records = tracker.records();
+      }
+    });
+    return records;
+  }
+
+  std::function<void()> slowCallback() {
+    return [this]() { time_system_.advanceTimeAsync(std::chrono::milliseconds(20)); };
+  }
+
+  Event::SimulatedTimeSystem time_system_;
+  Api::ApiPtr api_;
+  DispatcherPtr dispatcher_;
+};
+
+TEST_F(DispatcherWithSlowCallbackTrackerTest, RecordsEachCallbackType) {
+  dispatcher_->post(slowCallback());
+  dispatcher_->run(Dispatcher::RunType::NonBlock);
+
+  auto timer = dispatcher_->createTimer(slowCallback());
+  timer->enableTimer(std::chrono::milliseconds(0));
+  dispatcher_->run(Dispatcher::RunType::NonBlock);
+
+  auto cb = dispatcher_->createSchedulableCallback(slowCallback());
+  cb->scheduleCallbackCurrentIteration();
+  dispatcher_->run(Dispatcher::RunType::NonBlock);
+
+  os_fd_t fd = Api::OsSysCallsSingleton::get().socket(AF_INET6, SOCK_DGRAM, 0).return_value_;
+  ASSERT_TRUE(SOCKET_VALID(fd));
+  Event::FileEventPtr file_event = dispatcher_->createFileEvent(
+      fd,
+      [this](uint32_t) {
+        slowCallback()();
+        return absl::OkStatus();
+      },
+      Event::PlatformDefaultTriggerType, FileReadyType::Read);
+  file_event->activate(FileReadyType::Read);
+  dispatcher_->run(Dispatcher::RunType::NonBlock);
+
+  // Deferred deletion from within a callback runs in its own callback.
+  dispatcher_->post([this]() { DeferredTaskUtil::deferredRun(*dispatcher_, slowCallback()); });
+  dispatcher_->run(Dispatcher::RunType::NonBlock);
+
+  const std::vector<SlowCallbackTracker::Record> recorded = records();
+  ASSERT_EQ(5, recorded.size());
+  EXPECT_EQ(SlowCallbackTracker::CallbackType::Post, recorded[0].type_);
+  EXPECT_EQ(SlowCallbackTracker::CallbackType::Timer, recorded[1].type_);
+  EXPECT_EQ(SlowCallbackTracker::CallbackType::SchedulableCallback, recorded[2].type_);
+  EXPECT_EQ(SlowCallbackTracker::CallbackType::FileEvent, recorded[3].type_);
+  EXPECT_EQ(SlowCallbackTracker::CallbackType::SchedulableCallback, recorded[4].type_);
+  for (const SlowCallbackTracker::Record& record : recorded) {
+    EXPECT_EQ(std::chrono::milliseconds(20), record.duration_);
+  }
+  Api::OsSysCallsSingleton::get().close(fd);
+}
+
+TEST_F(DispatcherWithSlowCallbackTrackerTest, RecordsTrackedObject) {
+  MessageTrackedObject object("connection");
+  dispatcher_->post([this, &object]() {
+    ScopeTrackerScopeState scope(&object, *dispatcher_);
+    slowCallback()();
+  });
+  dispatcher_->post([this, &object]() {
+    ScopeTrackerScopeState scope(&object, *dispatcher_);
+  });
+  dispatcher_->run(Dispatcher::RunType::NonBlock);
+
+  const std::vector<SlowCallbackTracker::Record> recorded = records();
+  ASSERT_EQ(1, recorded.size());
+  EXPECT_EQ("connection", recorded[0].tracked_object_);
+}
+
 class DispatcherConnectionTest : public testing::Test {
 protected:
   DispatcherConnectionTest()
@@ -0,0 +1,189 @@
+#include <string>
+#include <vector>
+
+#include "source/common/event/slow_callback_tracker.h"
+
+#include "test/test_common/simulated_time_system.h"
+#include "test/test_common/utility.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Event {
+namespace {
+
+using CallbackType = SlowCallbackTracker::CallbackType;
+
+class SlowCallbackTrackerTest : public testing::Test {
+public:
+  void initialize(uint32_t sampling_interval, uint32_t max_records) {
+    tracker_ = std::make_unique<SlowCallbackTracker>("worker_0", time_system_,
+                                                     std::chrono::milliseconds(10),
+                                                     sampling_interval, max_records);
+  }
+
+  void runCallback(CallbackType type, std::chrono::milliseconds duration) {
+    SlowCallbackTracker::ScopedCallback callback(tracker_.get(), type);
+    time_system_.advanceTimeWait(duration);
+  }
+
+  std::vector<std::chrono::microseconds> durations() {
+    std::vector<std::chrono::microseconds> durations;
+    for (const SlowCallbackTracker::Record& record : tracker_->records()) {
+      durations.push_back(record.duration_);
+    }
+    return durations;
+  }
+
+  Event::SimulatedTimeSystem time_system_;
+  SlowCallbackTrackerPtr tracker_;
+};
+
+TEST_F(SlowCallbackTrackerTest, RecordsCallbacksOverThreshold) {
+  initialize(1, 4);
+  runCallback(CallbackType::FileEvent, std::chrono::milliseconds(5));
+  runCallback(CallbackType::Timer, std::chrono::milliseconds(10));
+  runCallback(CallbackType::Post, std::chrono::milliseconds(30));
+
+  EXPECT_EQ(3, tracker_->sampledCallbacks());
+  EXPECT_EQ(2, tracker_->slowCallbacks());
+  const std::vector<SlowCallbackTracker::Record> records = tracker_->records();
+  ASSERT_EQ(2, records.size());
+  EXPECT_EQ(CallbackType::Timer, records[0].type_);
+  EXPECT_EQ(std::chrono::milliseconds(10), records[0].duration_);
+  EXPECT_EQ(CallbackType::Post, records[1].type_);
+  EXPECT_EQ(std::chrono::milliseconds(30), records[1].duration_);
+  EXPECT_EQ(time_system_.systemTime(), records[1].time_);
+}
+
+TEST_F(SlowCallbackTrackerTest, SamplingInterval) {
+  initialize(3, 4);
+  for (int i = 0; i < 6; ++i) {
+    runCallback(CallbackType::Timer, std::chrono::milliseconds(20 + i));
+  }
+
+  // Only the third and sixth callbacks are timed.
+  EXPECT_EQ(2, tracker_->sampledCallbacks());
+  EXPECT_EQ(durations(), std::vector<std::chrono::microseconds>(
+                             {std::chrono::milliseconds(22), std::chrono::milliseconds(25)}));
+}
+
+TEST_F(SlowCallbackTrackerTest, RingBufferKeepsMostRecent) {
+  initialize(1, 2);
+  runCallback(CallbackType::Timer, std::chrono::milliseconds(11));
+  runCallback(CallbackType::Timer, std::chrono::milliseconds(12));
+  runCallback(CallbackType::Timer, std::chrono::milliseconds(13));
+  EXPECT_EQ(durations(), std::vector<std::chrono::microseconds>(
+                             {std::chrono::milliseconds(12), std::chrono::milliseconds(13)}));
+  runCallback(CallbackType::Timer, std::chrono::milliseconds(14));
+  EXPECT_EQ(durations(), std::vector<std::chrono::microseconds>(
+                             {std::chrono::milliseconds(13), std::chrono::milliseconds(14)}));
+  EXPECT_EQ(4, tracker_->slowCallbacks());
+}
+
+// The state of the innermost object which was active when the threshold was crossed is captured.
+TEST_F(SlowCallbackTrackerTest, CapturesTrackedObject) {
+  initialize(1, 4);
+  MessageTrackedObject connection("connection");
+  MessageTrackedObject stream("stream");
+  {
+    SlowCallbackTracker::ScopedCallback callback(tracker_.get(), CallbackType::FileEvent);
+    time_system_.advanceTimeWait(std::chrono::milliseconds(5));
+    tracker_->onTrackedObjectPopped(stream);
+    time_system_.advanceTimeWait(std::chrono::milliseconds(5));
+    tracker_->onTrackedObjectPopped(connection);
+  }
+  {
+    SlowCallbackTracker::ScopedCallback callback(tracker_.get(), CallbackType::FileEvent);
+    time_system_.advanceTimeWait(std::chrono::milliseconds(10));
+    tracker_->onTrackedObjectPopped(stream);
+    tracker_->onTrackedObjectPopped(connection);
+  }
+  {
+    SlowCallbackTracker::ScopedCallback callback(tracker_.get(), CallbackType::FileEvent);
+    time_system_.advanceTimeWait(std::chrono::milliseconds(10));
+  }
+
+  const std::vector<SlowCallbackTracker::Record> records = tracker_->records();
+  ASSERT_EQ(3, records.size());
+  EXPECT_EQ("connection", records[0].tracked_object_);
+  EXPECT_EQ("stream", records[1].tracked_object_);
+  EXPECT_EQ("", records[2].tracked_object_);
+}
+
+TEST_F(SlowCallbackTrackerTest, TruncatesTrackedObject) {
+  initialize(1, 4);
+  const std::string state(2 * SlowCallbackTracker::MaxTrackedObjectSize, 'a');
+  MessageTrackedObject object(state);
+  {
+    SlowCallbackTracker::ScopedCallback callback(tracker_.get(), CallbackType::Timer);
+    time_system_.advanceTimeWait(std::chrono::milliseconds(10));
+    tracker_->onTrackedObjectPopped(object);
+  }
+
+  const std::vector<SlowCallbackTracker::Record> records = tracker_->records();
+  ASSERT_EQ(1, records.size());
+  EXPECT_EQ(state.substr(0, SlowCallbackTracker::MaxTrackedObjectSize), records[0].tracked_object_);
+}
+
+// Objects popped outside of a timed callback are ignored.
+TEST_F(SlowCallbackTrackerTest, IgnoresPopsOutsideOfCallbacks) {
+  initialize(2, 4);
+  MessageTrackedObject object("object");
+  time_system_.advanceTimeWait(std::chrono::milliseconds(20));
+  tracker_->onTrackedObjectPopped(object);
+  {
+    // Not sampled.
+    SlowCallbackTracker::ScopedCallback callback(tracker_.get(), CallbackType::Timer);
+    tracker_->onTrackedObjectPopped(object);
+  }
+  runCallback(CallbackType::Timer, std::chrono::milliseconds(10));
+
+  const std::vector<SlowCallbackTracker::Record> records = tracker_->records();
+  ASSERT_EQ(1, records.size());
+  EXPECT_EQ("", records[0].tracked_object_);
+}
+
+// A callback run by a nested event loop is accounted to the outer callback.
+TEST_F(SlowCallbackTrackerTest, NestedCallbacks) {
+  initialize(1, 4);
+  {
+    SlowCallbackTracker::ScopedCallback outer(tracker_.get(), CallbackType::Post);
+    runCallback(CallbackType::Timer, std::chrono::milliseconds(20));
+  }
+
+  EXPECT_EQ(1, tracker_->sampledCallbacks());
+  const std::vector<SlowCallbackTracker::Record> records = tracker_->records();
+  ASSERT_EQ(1, records.size());
+  EXPECT_EQ(CallbackType::Post, records[0].type_);
+}
+
+TEST_F(SlowCallbackTrackerTest, NullTracker) {
+  SlowCallbackTracker::ScopedCallback callback(nullptr, CallbackType::Timer);
+}
+
+TEST_F(SlowCallbackTrackerTest, ForEachSortedByName) {
+  initialize(1, 4);
+  SlowCallbackTracker main_thread("main_thread", time_system_, std::chrono::milliseconds(10), 1,
+                                  4);
+  std::vector<std::string> names;
+  SlowCallbackTracker::forEach([&names](const SlowCallbackTracker& tracker) {
+    if (tracker.dispatcherName() == "worker_0" || tracker.dispatcherName() == "main_thread") {
+      names.push_back(tracker.dispatcherName());
+    }
+  });
+  EXPECT_EQ(names, std::vector<std::string>({"main_thread", "worker_0"}));
+
+  tracker_.reset();
+  names.clear();
+  SlowCallbackTracker::forEach([&names](const SlowCallbackTracker& tracker) {
+    if (tracker.dispatcherName() == "worker_0") {
+      names.push_back(tracker.dispatcherName());
+    }
+  });
+  EXPECT_TRUE(names.empty());
+}
+
+} // namespace
+} // namespace Event
+} // namespace Envoy
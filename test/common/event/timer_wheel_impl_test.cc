@@ -0,0 +1,298 @@
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <vector>
+
+#include "envoy/common/scope_tracker.h"
+#include "envoy/event/timer.h"
+
+#include "source/common/common/random_generator.h"
+#include "source/common/event/dispatcher_impl.h"
+#include "source/common/event/timer_wheel_impl.h"
+
+#include "test/mocks/common.h"
+#include "test/mocks/event/wrapped_dispatcher.h"
+#include "test/test_common/simulated_time_system.h"
+#include "test/test_common/utility.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Event {
+namespace {
+
+using testing::MockFunction;
+
+class ScopeTrackingDispatcher : public WrappedDispatcher {
+public:
+  ScopeTrackingDispatcher(DispatcherPtr dispatcher)
+      : WrappedDispatcher(*dispatcher), dispatcher_(std::move(dispatcher)) {}
+
+  void pushTrackedObject(const ScopeTrackedObject* object) override {
+    scope_ = object;
+    return impl_.pushTrackedObject(object);
+  }
+
+  void popTrackedObject(const ScopeTrackedObject* expected_object) override {
+    scope_ = nullptr;
+    return impl_.popTrackedObject(expected_object);
+  }
+
+  const ScopeTrackedObject* scope_{nullptr};
+
+private:
+  DispatcherPtr dispatcher_;
+};
+
+class TimerWheelTest : public testing::Test, public TestUsingSimulatedTime {
+public:
+  TimerWheelTest()
+      : api_(Api::createApiForTest()), dispatcher_(api_->allocateDispatcher("test_thread")) {}
+
+  void advance(std::chrono::milliseconds duration) {
+    simTime().advanceTimeAndRun(duration, dispatcher_, Dispatcher::RunType::NonBlock);
+  }
+
+  Api::ApiPtr api_;
+  ScopeTrackingDispatcher dispatcher_;
+};
+
+TEST_F(TimerWheelTest, CreateAndDestroy) {
+  TimerWheelImpl wheel(dispatcher_);
+  MockFunction<TimerCb> callback;
+  auto timer = wheel.createTimer(callback.AsStdFunction());
+  EXPECT_FALSE(timer->enabled());
+}
+
+TEST_F(TimerWheelTest, FiresAtDeadline) {
+  TimerWheelImpl wheel(dispatcher_);
+  MockFunction<TimerCb> callback;
+  auto timer = wheel.createTimer(callback.AsStdFunction());
+
+  timer->enableTimer(std::chrono::seconds(10));
+  EXPECT_TRUE(timer->enabled());
+  EXPECT_EQ(1, wheel.size());
+
+  advance(std::chrono::milliseconds(9999));
+  EXPECT_TRUE(timer->enabled());
+
+  EXPECT_CALL(callback, Call());
+  advance(std::chrono::milliseconds(1));
+  EXPECT_FALSE(timer->enabled());
+  EXPECT_EQ(0, wheel.size());
+}
+
+TEST_F(TimerWheelTest, HighResolutionTimerRoundsUp) {
+  TimerWheelImpl wheel(dispatcher_);
+  MockFunction<TimerCb> callback;
+  auto timer = wheel.createTimer(callback.AsStdFunction());
+
+  timer->enableHRTimer(std::chrono::microseconds(1500));
+  advance(std::chrono::milliseconds(1));
+  EXPECT_TRUE(timer->enabled());
+
+  EXPECT_CALL(callback, Call());
+  advance(std::chrono::milliseconds(1));
+}
+
+TEST_F(TimerWheelTest, ZeroDuration) {
+  TimerWheelImpl wheel(dispatcher_);
+  MockFunction<TimerCb> callback;
+  auto timer = wheel.createTimer(callback.AsStdFunction());
+
+  timer->enableTimer(std::chrono::milliseconds::zero());
+  EXPECT_CALL(callback, Call());
+  advance(std::chrono::milliseconds(1));
+}
+
+TEST_F(TimerWheelTest, EnableAndDisableTimer) {
+  TimerWheelImpl wheel(dispatcher_);
+  MockFunction<TimerCb> callback;
+  auto timer = wheel.createTimer(callback.AsStdFunction());
+
+  timer->enableTimer(std::chrono::seconds(30));
+  timer->disableTimer();
+  EXPECT_FALSE(timer->enabled());
+  EXPECT_EQ(0, wheel.size());
+
+  // The strict mock callback catches the timer firing anyway.
+  advance(std::chrono::seconds(60));
+}
+
+TEST_F(TimerWheelTest, ReenableMovesDeadline) {
+  TimerWheelImpl wheel(dispatcher_);
+  MockFunction<TimerCb> callback;
+  auto timer = wheel.createTimer(callback.AsStdFunction());
+
+  timer->enableTimer(std::chrono::seconds(10));
+  advance(std::chrono::seconds(5));
+  timer->enableTimer(std::chrono::seconds(10));
+  EXPECT_EQ(1, wheel.size());
+  advance(std::chrono::seconds(9));
+
+  EXPECT_CALL(callback, Call());
+  advance(std::chrono::seconds(1));
+
+  // A deadline can also move earlier.
+  timer->enableTimer(std::chrono::hours(1));
+  timer->enableTimer(std::chrono::milliseconds(50));
+  EXPECT_CALL(callback, Call());
+  advance(std::chrono::milliseconds(50));
+}
+
+TEST_F(TimerWheelTest, DestroyEnabledTimer) {
+  TimerWheelImpl wheel(dispatcher_);
+  MockFunction<TimerCb> callback;
+  auto timer = wheel.createTimer(callback.AsStdFunction());
+
+  timer->enableTimer(std::chrono::seconds(1));
+  timer.reset();
+  EXPECT_EQ(0, wheel.size());
+  advance(std::chrono::seconds(2));
+}
+
+TEST_F(TimerWheelTest, FiresInDeadlineOrderAcrossLevels) {
+  TimerWheelImpl wheel(dispatcher_);
+  const std::vector<std::chrono::milliseconds> durations = {
+      std::chrono::hours(2), std::chrono::milliseconds(5), std::chrono::seconds(5),
+      std::chrono::milliseconds(100), std::chrono::milliseconds(4096)};
+  std::vector<std::chrono::milliseconds> fired;
+  std::vector<TimerPtr> timers;
+  const MonotonicTime start = simTime().monotonicTime();
+  for (std::chrono::milliseconds duration : durations) {
+    timers.push_back(wheel.createTimer([&, duration]() {
+      EXPECT_EQ(start + duration, simTime().monotonicTime());
+      fired.push_back(duration);
+    }));
+    timers.back()->enableTimer(duration);
+  }
+
+  // Stop a millisecond short of each deadline, and then reach it.
+  std::vector<std::chrono::milliseconds> sorted = durations;
+  std::sort(sorted.begin(), sorted.end());
+  std::chrono::milliseconds elapsed{};
+  for (std::chrono::milliseconds duration : sorted) {
+    advance(duration - elapsed - std::chrono::milliseconds(1));
+    EXPECT_TRUE(fired.empty() || fired.back() < duration);
+    advance(std::chrono::milliseconds(1));
+    elapsed = duration;
+    ASSERT_FALSE(fired.empty());
+    EXPECT_EQ(duration, fired.back());
+  }
+  EXPECT_EQ(std::vector<std::chrono::milliseconds>(
+                {std::chrono::milliseconds(5), std::chrono::milliseconds(100),
+                 std::chrono::milliseconds(4096), std::chrono::seconds(5), std::chrono::hours(2)}),
+            fired);
+}
+
+TEST_F(TimerWheelTest, CallbackFreesAnotherDueTimer) {
+  TimerWheelImpl wheel(dispatcher_);
+  TimerPtr first;
+  TimerPtr second;
+  int fired = 0;
+  first = wheel.createTimer([&]() {
+    ++fired;
+    second.reset();
+  });
+  second = wheel.createTimer([&]() {
+    ++fired;
+    first.reset();
+  });
+  first->enableTimer(std::chrono::milliseconds(10));
+  second->enableTimer(std::chrono::milliseconds(10));
+
+  // Whichever timer fires first frees the other before it can fire.
+  advance(std::chrono::milliseconds(10));
+  EXPECT_EQ(1, fired);
+  EXPECT_NE(first == nullptr, second == nullptr);
+  EXPECT_EQ(0, wheel.size());
+}
+
+TEST_F(TimerWheelTest, CallbackReenablesTimer) {
+  TimerWheelImpl wheel(dispatcher_);
+  MockFunction<TimerCb> callback;
+  TimerPtr timer = wheel.createTimer(callback.AsStdFunction());
+  EXPECT_CALL(callback, Call()).Times(3).WillRepeatedly([&]() {
+    timer->enableTimer(std::chrono::milliseconds::zero());
+  });
+  timer->enableTimer(std::chrono::milliseconds(1));
+
+  // A timer re-enabled from its callback fires at a later tick, not in the same one.
+  advance(std::chrono::milliseconds(1));
+  advance(std::chrono::milliseconds(1));
+  advance(std::chrono::milliseconds(1));
+  timer->disableTimer();
+}
+
+TEST_F(TimerWheelTest, IdleWheelCatchesUp) {
+  TimerWheelImpl wheel(dispatcher_);
+  MockFunction<TimerCb> callback;
+  auto timer = wheel.createTimer(callback.AsStdFunction());
+
+  advance(std::chrono::hours(10));
+  timer->enableTimer(std::chrono::seconds(1));
+  advance(std::chrono::milliseconds(999));
+
+  EXPECT_CALL(callback, Call());
+  advance(std::chrono::milliseconds(1));
+}
+
+TEST_F(TimerWheelTest, ScopeTracking) {
+  TimerWheelImpl wheel(dispatcher_);
+  MockScopeTrackedObject scope;
+  MockFunction<TimerCb> callback;
+  auto timer = wheel.createTimer(callback.AsStdFunction());
+
+  timer->enableTimer(std::chrono::milliseconds(5), &scope);
+  EXPECT_CALL(callback, Call()).WillOnce([&]() { EXPECT_EQ(&scope, dispatcher_.scope_); });
+  advance(std::chrono::milliseconds(5));
+  EXPECT_EQ(nullptr, dispatcher_.scope_);
+}
+
+// Enables, re-enables and disables many timers at random, and checks that each fires exactly when
+// the time reaches its deadline.
+TEST_F(TimerWheelTest, RandomTimers) {
+  TimerWheelImpl wheel(dispatcher_);
+  Random::RandomGeneratorImpl random;
+  struct Tracked {
+    TimerPtr timer_;
+    absl::optional<MonotonicTime> deadline_;
+  };
+  std::vector<Tracked> tracked(1000);
+  for (Tracked& entry : tracked) {
+    entry.timer_ = wheel.createTimer([this, &entry]() {
+      ASSERT_TRUE(entry.deadline_.has_value());
+      EXPECT_LE(*entry.deadline_, simTime().monotonicTime());
+      entry.deadline_.reset();
+    });
+  }
+
+  for (int round = 0; round < 500; ++round) {
+    for (int change = 0; change < 20; ++change) {
+      Tracked& entry = tracked[random.random() % tracked.size()];
+      if (random.random() % 4 == 0) {
+        entry.timer_->disableTimer();
+        entry.deadline_.reset();
+      } else {
+        // Spread the durations over several levels of the wheel.
+        const std::chrono::milliseconds duration(random.random() % (1 << (random.random() % 20)));
+        entry.timer_->enableTimer(duration);
+        entry.deadline_ = simTime().monotonicTime() + duration;
+      }
+    }
+    advance(std::chrono::milliseconds(1 + random.random() % 5000));
+    for (const Tracked& entry : tracked) {
+      // Every timer whose deadline has passed has fired.
+      EXPECT_TRUE(!entry.deadline_.has_value() || *entry.deadline_ > simTime().monotonicTime());
+      EXPECT_EQ(entry.deadline_.has_value(), entry.timer_->enabled());
+    }
+  }
+  for (Tracked& entry : tracked) {
+    entry.timer_.reset();
+  }
+  EXPECT_EQ(0, wheel.size());
+}
+
+} // namespace
+} // namespace Event
+} // namespace Envoy
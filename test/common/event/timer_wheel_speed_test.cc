@@ -0,0 +1,110 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+//
+// Compares the cost of arming and firing large numbers of timers, such as a timer per upstream host
+// for health checking, on the dispatcher's libevent timers (wheel = 0) and on its timer wheel
+// (wheel = 1).
+
+#include <chrono>
+#include <functional>
+#include <vector>
+
+#include "source/common/common/random_generator.h"
+#include "source/common/event/dispatcher_impl.h"
+
+#include "test/test_common/utility.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Event {
+namespace {
+
+std::vector<TimerPtr> createTimers(Dispatcher& dispatcher, bool wheel, uint32_t num_timers,
+                                   const std::function<void(uint32_t)>& callback) {
+  std::vector<TimerPtr> timers;
+  timers.reserve(num_timers);
+  for (uint32_t i = 0; i < num_timers; ++i) {
+    TimerCb timer_callback = [&callback, i]() { callback(i); };
+    timers.push_back(wheel ? dispatcher.createWheelTimer(std::move(timer_callback))
+                           : dispatcher.createTimer(std::move(timer_callback)));
+  }
+  return timers;
+}
+
+// Durations between 1 and 60 seconds, as health check intervals with jitter would be.
+std::vector<std::chrono::milliseconds> randomDurations(uint32_t count) {
+  Random::RandomGeneratorImpl random;
+  std::vector<std::chrono::milliseconds> durations;
+  durations.reserve(count);
+  for (uint32_t i = 0; i < count; ++i) {
+    durations.emplace_back(1000 + random.random() % 59000);
+  }
+  return durations;
+}
+
+} // namespace
+
+// Re-arms each of a number of armed timers for a new duration.
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_ArmTimers(::benchmark::State& state) {
+  const uint32_t num_timers = state.range(0);
+  const bool wheel = state.range(1) != 0;
+  Api::ApiPtr api = Api::createApiForTest();
+  DispatcherPtr dispatcher = api->allocateDispatcher("test_thread");
+  const std::function<void(uint32_t)> callback = [](uint32_t) {};
+  std::vector<TimerPtr> timers = createTimers(*dispatcher, wheel, num_timers, callback);
+  const std::vector<std::chrono::milliseconds> durations = randomDurations(num_timers);
+  for (uint32_t i = 0; i < num_timers; ++i) {
+    timers[i]->enableTimer(durations[i]);
+  }
+
+  uint32_t offset = 0;
+  for (auto _ : state) { // NOLINT
+    for (uint32_t i = 0; i < num_timers; ++i) {
+      timers[i]->enableTimer(durations[(i + offset) % num_timers]);
+    }
+    ++offset;
+  }
+  state.SetItemsProcessed(state.iterations() * num_timers);
+}
+BENCHMARK(BM_ArmTimers)
+    ->ArgsProduct({{1000, 100000}, {0, 1}})
+    ->Unit(::benchmark::kMillisecond);
+
+// Fires a number of due timers, each of which re-arms itself for a later interval, as a health
+// check session does.
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_FireTimers(::benchmark::State& state) {
+  const uint32_t num_timers = state.range(0);
+  const bool wheel = state.range(1) != 0;
+  Api::ApiPtr api = Api::createApiForTest();
+  DispatcherPtr dispatcher = api->allocateDispatcher("test_thread");
+  const std::vector<std::chrono::milliseconds> durations = randomDurations(num_timers);
+  uint32_t fired = 0;
+  std::vector<TimerPtr> timers;
+  const std::function<void(uint32_t)> callback = [&](uint32_t i) {
+    timers[i]->enableTimer(durations[i]);
+    ++fired;
+  };
+  timers = createTimers(*dispatcher, wheel, num_timers, callback);
+
+  for (auto _ : state) { // NOLINT
+    state.PauseTiming();
+    for (uint32_t i = 0; i < num_timers; ++i) {
+      timers[i]->enableTimer(std::chrono::milliseconds::zero());
+    }
+    fired = 0;
+    state.ResumeTiming();
+    while (fired < num_timers) {
+      dispatcher->run(Dispatcher::RunType::NonBlock);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * num_timers);
+}
+BENCHMARK(BM_FireTimers)
+    ->ArgsProduct({{1000, 100000}, {0, 1}})
+    ->Unit(::benchmark::kMillisecond);
+
+} // namespace Event
+} // namespace Envoy
@@ -254,6 +254,7 @@ public:
   const absl::flat_hash_set<uint32_t>& httpDestinationPorts() const override {
     return http_destination_ports_;
   }
+  FilterInstrumentation* filterInstrumentation() override { return nullptr; }
 
   const envoy::extensions::filters::network::http_connection_manager::v3::HttpConnectionManager
       config_;
@@ -1,6 +1,7 @@
 #include <chrono>
 
 #include "test/common/http/conn_manager_impl_test_base.h"
+#include "test/common/stats/stat_test_utility.h"
 #include "test/common/http/custom_header_extension.h"
 #include "test/extensions/filters/network/common/fuzz/utils/fakes.h"
 #include "test/server/utility.h"
@@ -2902,5 +2903,38 @@ TEST_F(HttpConnectionManagerImplTest, TestRefreshRouteCluster) {
   filter->callbacks_->encodeData(response_data, true);
 }
 
+// The filter callbacks of a sampled stream are measured under the filter config names.
+TEST_F(HttpConnectionManagerImplTest, FilterInstrumentationSampledStream) {
+  Stats::TestUtil::TestStore store;
+  envoy::extensions::filters::network::http_connection_manager::v3::HttpConnectionManager::
+      FilterInstrumentation config;
+  config.mutable_sampling_interval()->set_value(1);
+  filter_instrumentation_ = std::make_unique<FilterInstrumentation>(
+      config, "http.test.", *store.rootScope(), test_time_.timeSystem(), random_);
+  setup();
+  setupFilterChain(2, 0);
+
+  EXPECT_CALL(*decoder_filters_[0], decodeHeaders(_, true))
+      .WillOnce(Return(FilterHeadersStatus::Continue));
+  EXPECT_CALL(*decoder_filters_[1], decodeHeaders(_, true))
+      .WillOnce(Return(FilterHeadersStatus::StopIteration));
+  startRequest(true);
+
+  EXPECT_EQ(1,
+            store.histogramValues("http.test.filter_instrumentation.0.decode_headers.wall_time_us",
+                                  false)
+                .size());
+  EXPECT_EQ(1,
+            store.histogramValues("http.test.filter_instrumentation.1.decode_headers.cpu_time_us",
+                                  false)
+                .size());
+  EXPECT_FALSE(
+      store.histogramRecordedValues("http.test.filter_instrumentation.0.decode_data.wall_time_us"));
+
+  doRemoteClose();
+  // The instrumentation refers to the symbol table of the store.
+  filter_instrumentation_.reset();
+}
+
 } // namespace Http
 } // namespace Envoy
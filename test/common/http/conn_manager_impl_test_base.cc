@@ -155,6 +155,9 @@ public:
   const absl::flat_hash_set<uint32_t>& httpDestinationPorts() const override {
     return parent_.httpDestinationPorts();
   }
+  FilterInstrumentation* filterInstrumentation() override {
+    return parent_.filterInstrumentation();
+  }
 
 private:
   ConnectionManagerConfig& parent_;
@@ -226,6 +226,7 @@ public:
   const absl::flat_hash_set<uint32_t>& httpDestinationPorts() const override {
     return http_destination_ports_;
   }
+  FilterInstrumentation* filterInstrumentation() override { return filter_instrumentation_.get(); }
 
   // Simple helper to wrapper filter to the factory function.
   FilterFactoryCb createDecoderFilterFactoryCb(StreamDecoderFilterSharedPtr filter) {
@@ -357,6 +358,7 @@ public:
       header_validator_config_overrides_;
   absl::flat_hash_set<uint32_t> https_destination_ports_;
   absl::flat_hash_set<uint32_t> http_destination_ports_;
+  FilterInstrumentationPtr filter_instrumentation_;
 };
 
 class HttpConnectionManagerImplTest : public HttpConnectionManagerImplMixin,
@@ -0,0 +1,265 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+//
+// Compares workers which each use their own connection pool to a host with workers which share the
+// pool of a carrier worker: the latency that the hop to the carrier adds to a request, and the
+// number of upstream pools, and so connections, that each needs.
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "source/common/common/utility.h"
+#include "source/common/http/cross_worker_conn_pool.h"
+#include "source/common/http/header_map_impl.h"
+#include "source/common/network/socket_impl.h"
+#include "source/common/stream_info/stream_info_impl.h"
+
+#include "test/benchmark/main.h"
+#include "test/common/upstream/utility.h"
+#include "test/mocks/upstream/cluster_info.h"
+#include "test/test_common/thread_factory_for_test.h"
+#include "test/test_common/utility.h"
+
+#include "absl/container/flat_hash_map.h"
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Http {
+namespace {
+
+// A pool whose streams are ready immediately, and whose upstream answers each request as soon as
+// it is encoded.
+class FakeUpstreamPool : public ConnectionPool::Instance,
+                         public RequestEncoder,
+                         public Stream {
+public:
+  // ConnectionPool::Instance
+  bool hasActiveConnections() const override { return false; }
+  ConnectionPool::Cancellable* newStream(ResponseDecoder& response_decoder,
+                                         ConnectionPool::Callbacks& callbacks,
+                                         const StreamOptions&) override {
+    response_decoder_ = &response_decoder;
+    callbacks.onPoolReady(*this, nullptr, stream_info_, Protocol::Http2);
+    return nullptr;
+  }
+  absl::string_view protocolDescription() const override { return "HTTP/2"; }
+  void addIdleCallback(IdleCb) override {}
+  bool isIdle() const override { return true; }
+  void drainConnections(Envoy::ConnectionPool::DrainBehavior) override {}
+  Upstream::HostDescriptionConstSharedPtr host() const override { return nullptr; }
+  bool maybePreconnect(float) override { return false; }
+
+  // RequestEncoder
+  Status encodeHeaders(const RequestHeaderMap&, bool) override {
+    response_decoder_->decodeHeaders(ResponseHeaderMapImpl::create(), true);
+    return okStatus();
+  }
+  void encodeTrailers(const RequestTrailerMap&) override {}
+  void enableTcpTunneling() override {}
+  void encodeData(Buffer::Instance&, bool) override {}
+  Stream& getStream() override { return *this; }
+  void encodeMetadata(const MetadataMapVector&) override {}
+  Http1StreamEncoderOptionsOptRef http1StreamEncoderOptions() override { return absl::nullopt; }
+
+  // Stream
+  void addCallbacks(StreamCallbacks&) override {}
+  void removeCallbacks(StreamCallbacks&) override {}
+  CodecEventCallbacks* registerCodecEventCallbacks(CodecEventCallbacks*) override {
+    return nullptr;
+  }
+  void resetStream(StreamResetReason) override {}
+  void readDisable(bool) override {}
+  uint32_t bufferLimit() const override { return 0; }
+  const Network::ConnectionInfoProvider& connectionInfoProvider() override {
+    return connection_info_;
+  }
+  void setFlushTimeout(std::chrono::milliseconds) override {}
+  Buffer::BufferMemoryAccountSharedPtr account() const override { return nullptr; }
+  void setAccount(Buffer::BufferMemoryAccountSharedPtr) override {}
+  const StreamInfo::BytesMeterSharedPtr& bytesMeter() override { return bytes_meter_; }
+  absl::optional<uint32_t> codecStreamId() const override { return absl::nullopt; }
+
+private:
+  ResponseDecoder* response_decoder_{};
+  Network::ConnectionInfoSetterImpl connection_info_{nullptr, nullptr};
+  StreamInfo::BytesMeterSharedPtr bytes_meter_{std::make_shared<StreamInfo::BytesMeter>()};
+  RealTimeSource time_source_;
+  StreamInfo::StreamInfoImpl stream_info_{Protocol::Http2, time_source_, nullptr,
+                                          StreamInfo::FilterState::LifeSpan::Connection};
+};
+
+// Sends one header-only request and waits for its response.
+class Request : public ConnectionPool::Callbacks, public ResponseDecoder {
+public:
+  explicit Request(std::function<void()> on_response) : on_response_(std::move(on_response)) {}
+
+  void send(ConnectionPool::Instance& pool) { pool.newStream(*this, *this, {false, true}); }
+
+  // ConnectionPool::Callbacks
+  void onPoolFailure(ConnectionPool::PoolFailureReason, absl::string_view,
+                     Upstream::HostDescriptionConstSharedPtr) override {
+    on_response_();
+  }
+  void onPoolReady(RequestEncoder& encoder, Upstream::HostDescriptionConstSharedPtr,
+                   StreamInfo::StreamInfo&, absl::optional<Protocol>) override {
+    const Status status = encoder.encodeHeaders(headers_, true);
+    RELEASE_ASSERT(status.ok(), "");
+  }
+
+  // ResponseDecoder
+  void decode1xxHeaders(ResponseHeaderMapPtr&&) override {}
+  void decodeHeaders(ResponseHeaderMapPtr&&, bool end_stream) override {
+    if (end_stream) {
+      on_response_();
+    }
+  }
+  void decodeData(Buffer::Instance&, bool) override {}
+  void decodeTrailers(ResponseTrailerMapPtr&&) override {}
+  void decodeMetadata(MetadataMapPtr&&) override {}
+  void dumpState(std::ostream&, int) const override {}
+
+private:
+  const std::function<void()> on_response_;
+  TestRequestHeaderMapImpl headers_{{":method", "GET"}, {":path", "/"}, {":authority", "host"}};
+};
+
+} // namespace
+
+// Measures the round trip of a request on a worker's own pool (shared = 0), and through a pool
+// carried by a worker running on another thread (shared = 1).
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_RequestRoundTrip(::benchmark::State& state) {
+  const bool shared = state.range(0) != 0;
+  Api::ApiPtr api = Api::createApiForTest();
+  Event::DispatcherPtr worker_dispatcher = api->allocateDispatcher("worker_0");
+  Event::DispatcherPtr carrier_dispatcher = api->allocateDispatcher("worker_1");
+  auto relay = std::make_shared<CrossWorkerRelay>(*worker_dispatcher);
+  auto carrier = std::make_shared<CrossWorkerRelay>(*carrier_dispatcher);
+  Thread::ThreadPtr carrier_thread = Thread::threadFactoryForTest().createThread(
+      [&]() { carrier_dispatcher->run(Event::Dispatcher::RunType::RunUntilExit); });
+
+  std::shared_ptr<Upstream::MockClusterInfo> cluster{
+      new testing::NiceMock<Upstream::MockClusterInfo>()};
+  FakeUpstreamPool upstream_pool;
+  CrossWorkerConnPool cross_worker_pool(relay, carrier,
+                                        Upstream::makeTestHost(cluster, "tcp://127.0.0.1:9000"),
+                                        Protocol::Http2, [&]() { return &upstream_pool; });
+  ConnectionPool::Instance& pool =
+      shared ? static_cast<ConnectionPool::Instance&>(cross_worker_pool) : upstream_pool;
+
+  Request request([&]() {
+    if (shared) {
+      worker_dispatcher->exit();
+    }
+  });
+  for (auto _ : state) { // NOLINT
+    request.send(pool);
+    if (shared) {
+      worker_dispatcher->run(Event::Dispatcher::RunType::RunUntilExit);
+    }
+  }
+
+  carrier_dispatcher->post([&]() {
+    carrier->shutdown();
+    carrier_dispatcher->exit();
+  });
+  carrier_thread->join();
+  relay->shutdown();
+  worker_dispatcher->run(Event::Dispatcher::RunType::NonBlock);
+}
+BENCHMARK(BM_RequestRoundTrip)->Arg(0)->Arg(1)->Unit(::benchmark::kMicrosecond);
+
+// Sends a request from each worker to each host, and counts the upstream pools that carried them.
+// Every pool holds at least one connection, so with per-worker pools (shared = 0) there are
+// workers * hosts of them, and with shared pools (shared = 1) one per host.
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_UpstreamPools(::benchmark::State& state) {
+  const uint32_t num_workers = state.range(0);
+  const uint32_t num_hosts = state.range(1);
+  const bool shared = state.range(2) != 0;
+  if (Envoy::benchmark::skipExpensiveBenchmarks() && num_hosts > 100) {
+    state.SkipWithError("Skipping expensive benchmark");
+    return;
+  }
+
+  Api::ApiPtr api = Api::createApiForTest();
+  std::shared_ptr<Upstream::MockClusterInfo> cluster{
+      new testing::NiceMock<Upstream::MockClusterInfo>()};
+  std::vector<Upstream::HostSharedPtr> hosts;
+  for (uint32_t i = 0; i < num_hosts; ++i) {
+    hosts.push_back(Upstream::makeTestHost(
+        cluster, fmt::format("tcp://10.{}.{}.{}:80", i >> 16, (i >> 8) & 0xff, i & 0xff)));
+  }
+  std::vector<Event::DispatcherPtr> dispatchers;
+  std::vector<CrossWorkerRelaySharedPtr> relays;
+  CrossWorkerCarriers carriers(num_workers);
+  for (uint32_t i = 0; i < num_workers; ++i) {
+    dispatchers.push_back(api->allocateDispatcher(fmt::format("worker_{}", i)));
+    relays.push_back(std::make_shared<CrossWorkerRelay>(*dispatchers.back()));
+    carriers.add(relays.back());
+  }
+
+  size_t upstream_pools = 0;
+  for (auto _ : state) { // NOLINT
+    state.PauseTiming();
+    // The upstream pools of each worker, by host.
+    std::vector<absl::flat_hash_map<uint32_t, std::unique_ptr<FakeUpstreamPool>>> worker_pools(
+        num_workers);
+    auto upstream_pool = [&](uint32_t worker, uint32_t host) -> FakeUpstreamPool& {
+      std::unique_ptr<FakeUpstreamPool>& pool = worker_pools[worker][host];
+      if (pool == nullptr) {
+        pool = std::make_unique<FakeUpstreamPool>();
+      }
+      return *pool;
+    };
+    std::vector<std::unique_ptr<CrossWorkerConnPool>> cross_worker_pools;
+    std::vector<std::unique_ptr<Request>> requests;
+    state.ResumeTiming();
+
+    for (uint32_t worker = 0; worker < num_workers; ++worker) {
+      for (uint32_t host = 0; host < num_hosts; ++host) {
+        requests.push_back(std::make_unique<Request>([]() {}));
+        CrossWorkerRelaySharedPtr carrier = shared ? carriers.carrierFor(*hosts[host]) : nullptr;
+        if (carrier == nullptr || carrier == relays[worker]) {
+          requests.back()->send(upstream_pool(worker, host));
+          continue;
+        }
+        const uint32_t carrier_worker =
+            std::find(relays.begin(), relays.end(), carrier) - relays.begin();
+        cross_worker_pools.push_back(std::make_unique<CrossWorkerConnPool>(
+            relays[worker], carrier, hosts[host], Protocol::Http2,
+            [&, carrier_worker, host]() { return &upstream_pool(carrier_worker, host); }));
+        requests.back()->send(*cross_worker_pools.back());
+      }
+    }
+    // Deliver the requests and responses posted between the workers.
+    for (int round = 0; round < 4; ++round) {
+      for (Event::DispatcherPtr& dispatcher : dispatchers) {
+        dispatcher->run(Event::Dispatcher::RunType::NonBlock);
+      }
+    }
+
+    state.PauseTiming();
+    upstream_pools = 0;
+    for (const auto& pools : worker_pools) {
+      upstream_pools += pools.size();
+    }
+    cross_worker_pools.clear();
+    for (Event::DispatcherPtr& dispatcher : dispatchers) {
+      dispatcher->run(Event::Dispatcher::RunType::NonBlock);
+    }
+    state.ResumeTiming();
+  }
+  state.counters["upstream_pools"] = upstream_pools;
+
+  for (CrossWorkerRelaySharedPtr& relay : relays) {
+    relay->shutdown();
+  }
+}
+BENCHMARK(BM_UpstreamPools)
+    ->ArgsProduct({{8, 64}, {100, 30000}, {0, 1}})
+    ->Unit(::benchmark::kMillisecond);
+
+} // namespace Http
+} // namespace Envoy
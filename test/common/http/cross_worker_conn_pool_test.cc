@@ -0,0 +1,318 @@
+#include <memory>
+
+#include "source/common/http/cross_worker_conn_pool.h"
+
+#include "test/common/http/common.h"
+#include "test/common/upstream/utility.h"
+#include "test/mocks/common.h"
+#include "test/mocks/http/conn_pool.h"
+#include "test/mocks/http/mocks.h"
+#include "test/mocks/http/stream_decoder.h"
+#include "test/mocks/http/stream_encoder.h"
+#include "test/mocks/stream_info/mocks.h"
+#include "test/mocks/upstream/cluster_info.h"
+#include "test/test_common/printers.h"
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::Invoke;
+using testing::NiceMock;
+
+namespace Envoy {
+namespace Http {
+namespace {
+
+// Runs two workers on real dispatchers driven from the test thread: the one that creates the
+// streams, and the carrier whose connection pool (a mock) carries them.
+class CrossWorkerConnPoolTest : public testing::Test {
+public:
+  CrossWorkerConnPoolTest()
+      : api_(Api::createApiForTest()), worker_dispatcher_(api_->allocateDispatcher("worker_0")),
+        carrier_dispatcher_(api_->allocateDispatcher("worker_1")),
+        relay_(std::make_shared<CrossWorkerRelay>(*worker_dispatcher_)),
+        carrier_(std::make_shared<CrossWorkerRelay>(*carrier_dispatcher_)),
+        host_(Upstream::makeTestHost(cluster_, "tcp://127.0.0.1:9000")),
+        pool_(std::make_unique<CrossWorkerConnPool>(
+            relay_, carrier_, host_, Protocol::Http2,
+            [this]() -> ConnectionPool::Instance* {
+              return carrier_pool_available_ ? &carrier_pool_ : nullptr;
+            })) {
+    ON_CALL(carrier_pool_, newStream(_, _, _))
+        .WillByDefault(Invoke([this](ResponseDecoder& decoder, ConnectionPool::Callbacks& callbacks,
+                                     const ConnectionPool::Instance::StreamOptions&) {
+          carried_decoder_ = &decoder;
+          carried_callbacks_ = &callbacks;
+          return &carrier_handle_;
+        }));
+  }
+
+  ~CrossWorkerConnPoolTest() override {
+    pool_.reset();
+    carrier_->shutdown();
+    relay_->shutdown();
+    runWorkers();
+  }
+
+  // Runs both workers until the events they post to each other have been delivered.
+  void runWorkers() {
+    for (int i = 0; i < 4; ++i) {
+      carrier_dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+      worker_dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+    }
+  }
+
+  // Creates a stream and has the carrier's pool make it ready.
+  void newReadyStream() {
+    EXPECT_NE(nullptr, pool_->newStream(decoder_, callbacks_, {false, true}));
+    runWorkers();
+    ASSERT_NE(nullptr, carried_callbacks_);
+    carried_callbacks_->onPoolReady(encoder_, host_, carrier_stream_info_, Protocol::Http2);
+    EXPECT_CALL(callbacks_.pool_ready_, ready());
+    runWorkers();
+    ASSERT_NE(nullptr, callbacks_.outer_encoder_);
+  }
+
+  void sendRequest() {
+    TestRequestHeaderMapImpl headers{{":method", "GET"}, {":path", "/"}, {":authority", "host"}};
+    EXPECT_CALL(encoder_, encodeHeaders(HeaderMapEqualRef(&headers), true));
+    EXPECT_TRUE(callbacks_.outer_encoder_->encodeHeaders(headers, true).ok());
+    runWorkers();
+  }
+
+  std::shared_ptr<Upstream::MockClusterInfo> cluster_{new NiceMock<Upstream::MockClusterInfo>()};
+  Api::ApiPtr api_;
+  Event::DispatcherPtr worker_dispatcher_;
+  Event::DispatcherPtr carrier_dispatcher_;
+  CrossWorkerRelaySharedPtr relay_;
+  CrossWorkerRelaySharedPtr carrier_;
+  Upstream::HostSharedPtr host_;
+  NiceMock<ConnectionPool::MockInstance> carrier_pool_;
+  bool carrier_pool_available_{true};
+  NiceMock<Envoy::ConnectionPool::MockCancellable> carrier_handle_;
+  ResponseDecoder* carried_decoder_{};
+  ConnectionPool::Callbacks* carried_callbacks_{};
+  NiceMock<MockRequestEncoder> encoder_;
+  NiceMock<StreamInfo::MockStreamInfo> carrier_stream_info_;
+  NiceMock<MockResponseDecoder> decoder_;
+  ConnPoolCallbacks callbacks_;
+  std::unique_ptr<CrossWorkerConnPool> pool_;
+};
+
+// A request and its response are relayed between the workers, and the pool is idle afterwards.
+TEST_F(CrossWorkerConnPoolTest, RoundTrip) {
+  newReadyStream();
+  EXPECT_FALSE(pool_->isIdle());
+  sendRequest();
+
+  EXPECT_CALL(decoder_, decodeHeaders_(_, false));
+  EXPECT_CALL(decoder_, decodeData(BufferStringEqual("hello"), true));
+  carried_decoder_->decodeHeaders(
+      ResponseHeaderMapPtr{new TestResponseHeaderMapImpl{{":status", "200"}}}, false);
+  Buffer::OwnedImpl data("hello");
+  carried_decoder_->decodeData(data, true);
+  runWorkers();
+
+  EXPECT_TRUE(pool_->isIdle());
+  EXPECT_FALSE(pool_->hasActiveConnections());
+}
+
+// Invalid request headers are rejected on the stream's worker.
+TEST_F(CrossWorkerConnPoolTest, InvalidRequestHeaders) {
+  newReadyStream();
+  TestRequestHeaderMapImpl headers{{":path", "/"}};
+  EXPECT_CALL(encoder_, encodeHeaders(_, _)).Times(0);
+  EXPECT_FALSE(callbacks_.outer_encoder_->encodeHeaders(headers, true).ok());
+  runWorkers();
+}
+
+// Cancelling a stream before it is ready cancels it on the carrier's pool.
+TEST_F(CrossWorkerConnPoolTest, CancelBeforeReady) {
+  ConnectionPool::Cancellable* handle = pool_->newStream(decoder_, callbacks_, {false, true});
+  ASSERT_NE(nullptr, handle);
+  runWorkers();
+
+  EXPECT_CALL(carrier_handle_, cancel(Envoy::ConnectionPool::CancelPolicy::Default));
+  handle->cancel(Envoy::ConnectionPool::CancelPolicy::Default);
+  EXPECT_TRUE(pool_->isIdle());
+  runWorkers();
+}
+
+TEST_F(CrossWorkerConnPoolTest, PoolFailure) {
+  EXPECT_NE(nullptr, pool_->newStream(decoder_, callbacks_, {false, true}));
+  runWorkers();
+
+  carried_callbacks_->onPoolFailure(ConnectionPool::PoolFailureReason::Timeout, "timed out",
+                                    host_);
+  EXPECT_CALL(callbacks_.pool_failure_, ready());
+  runWorkers();
+  EXPECT_EQ(ConnectionPool::PoolFailureReason::Timeout, callbacks_.reason_);
+  EXPECT_EQ("timed out", callbacks_.transport_failure_reason_);
+  EXPECT_TRUE(pool_->isIdle());
+}
+
+// The stream fails if the carrier worker no longer has a pool for the host.
+TEST_F(CrossWorkerConnPoolTest, NoCarrierPool) {
+  carrier_pool_available_ = false;
+  EXPECT_CALL(carrier_pool_, newStream(_, _, _)).Times(0);
+  EXPECT_NE(nullptr, pool_->newStream(decoder_, callbacks_, {false, true}));
+  EXPECT_CALL(callbacks_.pool_failure_, ready());
+  runWorkers();
+  EXPECT_EQ(ConnectionPool::PoolFailureReason::LocalConnectionFailure, callbacks_.reason_);
+  EXPECT_EQ("no carrier connection pool", callbacks_.transport_failure_reason_);
+}
+
+// A reset of the carried stream is raised on the stream's worker.
+TEST_F(CrossWorkerConnPoolTest, CarriedStreamReset) {
+  newReadyStream();
+  NiceMock<MockStreamCallbacks> stream_callbacks;
+  callbacks_.outer_encoder_->getStream().addCallbacks(stream_callbacks);
+  sendRequest();
+
+  encoder_.stream_.resetStream(StreamResetReason::RemoteReset);
+  EXPECT_CALL(stream_callbacks, onResetStream(StreamResetReason::RemoteReset, _));
+  runWorkers();
+  EXPECT_TRUE(pool_->isIdle());
+}
+
+// Resetting the stream on its worker resets the carried stream.
+TEST_F(CrossWorkerConnPoolTest, RequesterReset) {
+  newReadyStream();
+  NiceMock<MockStreamCallbacks> stream_callbacks;
+  callbacks_.outer_encoder_->getStream().addCallbacks(stream_callbacks);
+
+  EXPECT_CALL(stream_callbacks, onResetStream(StreamResetReason::LocalReset, _));
+  callbacks_.outer_encoder_->getStream().resetStream(StreamResetReason::LocalReset);
+  EXPECT_TRUE(pool_->isIdle());
+
+  EXPECT_CALL(encoder_.stream_, resetStream(StreamResetReason::LocalReset));
+  runWorkers();
+}
+
+// Watermarks of the carried stream are raised on the stream, and read disabling the stream read
+// disables the carried stream.
+TEST_F(CrossWorkerConnPoolTest, FlowControl) {
+  newReadyStream();
+  NiceMock<MockStreamCallbacks> stream_callbacks;
+  callbacks_.outer_encoder_->getStream().addCallbacks(stream_callbacks);
+
+  encoder_.stream_.runHighWatermarkCallbacks();
+  EXPECT_CALL(stream_callbacks, onAboveWriteBufferHighWatermark());
+  runWorkers();
+  encoder_.stream_.runLowWatermarkCallbacks();
+  EXPECT_CALL(stream_callbacks, onBelowWriteBufferLowWatermark());
+  runWorkers();
+
+  EXPECT_CALL(encoder_.stream_, readDisable(true));
+  callbacks_.outer_encoder_->getStream().readDisable(true);
+  runWorkers();
+}
+
+// The request body posted to the carrier counts against the carried stream's buffer limit until
+// the carrier has encoded it, so that the caller stops reading while the carrier is behind.
+TEST_F(CrossWorkerConnPoolTest, RequestBodyInFlightIsBounded) {
+  ON_CALL(encoder_.stream_, bufferLimit()).WillByDefault(testing::Return(10));
+  newReadyStream();
+  NiceMock<MockStreamCallbacks> stream_callbacks;
+  callbacks_.outer_encoder_->getStream().addCallbacks(stream_callbacks);
+  TestRequestHeaderMapImpl headers{{":method", "POST"}, {":path", "/"}, {":authority", "host"}};
+  EXPECT_TRUE(callbacks_.outer_encoder_->encodeHeaders(headers, false).ok());
+
+  EXPECT_CALL(stream_callbacks, onAboveWriteBufferHighWatermark()).Times(0);
+  Buffer::OwnedImpl first("0123456");
+  callbacks_.outer_encoder_->encodeData(first, false);
+  testing::Mock::VerifyAndClearExpectations(&stream_callbacks);
+  EXPECT_CALL(stream_callbacks, onAboveWriteBufferHighWatermark());
+  Buffer::OwnedImpl second("789ab");
+  callbacks_.outer_encoder_->encodeData(second, false);
+  // Still above the limit, which is only signalled once.
+  Buffer::OwnedImpl third("cd");
+  callbacks_.outer_encoder_->encodeData(third, false);
+  testing::Mock::VerifyAndClearExpectations(&stream_callbacks);
+
+  // Once the carrier has encoded the body, the caller may read again.
+  EXPECT_CALL(encoder_, encodeData(_, false)).Times(3);
+  EXPECT_CALL(stream_callbacks, onBelowWriteBufferLowWatermark());
+  runWorkers();
+}
+
+// When the carrier worker shuts down, its carried streams are reset and new streams fail.
+TEST_F(CrossWorkerConnPoolTest, CarrierShutdown) {
+  newReadyStream();
+  NiceMock<MockStreamCallbacks> stream_callbacks;
+  callbacks_.outer_encoder_->getStream().addCallbacks(stream_callbacks);
+
+  EXPECT_CALL(encoder_.stream_, resetStream(StreamResetReason::ConnectionTermination));
+  carrier_->shutdown();
+  EXPECT_CALL(stream_callbacks, onResetStream(StreamResetReason::ConnectionTermination, _));
+  runWorkers();
+  EXPECT_TRUE(pool_->isIdle());
+
+  ConnPoolCallbacks callbacks;
+  EXPECT_CALL(callbacks.pool_failure_, ready());
+  EXPECT_EQ(nullptr, pool_->newStream(decoder_, callbacks, {false, true}));
+  EXPECT_EQ("carrier worker shut down", callbacks.transport_failure_reason_);
+}
+
+// A pool being drained for deletion only reports idle once its streams are done.
+TEST_F(CrossWorkerConnPoolTest, DrainAndDelete) {
+  ReadyWatcher idle;
+  pool_->addIdleCallback([&]() { idle.ready(); });
+  newReadyStream();
+
+  EXPECT_CALL(idle, ready()).Times(0);
+  pool_->drainConnections(Envoy::ConnectionPool::DrainBehavior::DrainAndDelete);
+  testing::Mock::VerifyAndClearExpectations(&idle);
+
+  sendRequest();
+  EXPECT_CALL(idle, ready());
+  carried_decoder_->decodeHeaders(
+      ResponseHeaderMapPtr{new TestResponseHeaderMapImpl{{":status", "200"}}}, true);
+  runWorkers();
+}
+
+// Destroying the pool fails the streams which are not ready yet.
+TEST_F(CrossWorkerConnPoolTest, DestroyWithPendingStream) {
+  EXPECT_NE(nullptr, pool_->newStream(decoder_, callbacks_, {false, true}));
+  runWorkers();
+
+  EXPECT_CALL(callbacks_.pool_failure_, ready());
+  pool_.reset();
+  EXPECT_CALL(carrier_handle_, cancel(_));
+  runWorkers();
+}
+
+TEST_F(CrossWorkerConnPoolTest, Carriers) {
+  CrossWorkerCarriers carriers(2);
+  EXPECT_EQ(nullptr, carriers.carrierFor(*host_));
+
+  EXPECT_TRUE(carriers.add(relay_));
+  EXPECT_TRUE(carriers.add(carrier_));
+  EXPECT_FALSE(carriers.add(std::make_shared<CrossWorkerRelay>(*worker_dispatcher_)));
+
+  // A host is always carried by the same worker.
+  CrossWorkerRelaySharedPtr host_carrier = carriers.carrierFor(*host_);
+  ASSERT_NE(nullptr, host_carrier);
+  EXPECT_EQ(host_carrier, carriers.carrierFor(*host_));
+
+  // Hosts are spread over the workers.
+  bool carried_by_relay = false;
+  bool carried_by_carrier = false;
+  for (int port = 9000; port < 9100; ++port) {
+    CrossWorkerRelaySharedPtr relay = carriers.carrierFor(
+        *Upstream::makeTestHost(cluster_, fmt::format("tcp://127.0.0.1:{}", port)));
+    carried_by_relay |= relay == relay_;
+    carried_by_carrier |= relay == carrier_;
+  }
+  EXPECT_TRUE(carried_by_relay);
+  EXPECT_TRUE(carried_by_carrier);
+
+  host_carrier->shutdown();
+  EXPECT_EQ(nullptr, carriers.carrierFor(*host_));
+}
+
+} // namespace
+} // namespace Http
+} // namespace Envoy
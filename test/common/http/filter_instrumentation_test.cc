@@ -0,0 +1,165 @@
+#include <array>
+
+#include "envoy/extensions/filters/network/http_connection_manager/v3/http_connection_manager.pb.h"
+
+#include "source/common/http/filter_instrumentation.h"
+
+#include "test/common/stats/stat_test_utility.h"
+#include "test/mocks/common.h"
+#include "test/test_common/simulated_time_system.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::ElementsAre;
+using testing::Return;
+
+namespace Envoy {
+namespace Http {
+namespace {
+
+using FilterInstrumentationConfig = envoy::extensions::filters::network::http_connection_manager::
+    v3::HttpConnectionManager::FilterInstrumentation;
+
+class FilterInstrumentationTest : public testing::Test {
+public:
+  void initialize() {
+    instrumentation_ = std::make_unique<FilterInstrumentation>(config_, "http.ingress.",
+                                                               *store_.rootScope(), time_system_,
+                                                               random_);
+  }
+
+  std::vector<uint64_t> values(const std::string& filter_name, const std::string& callback,
+                               const std::string& metric) {
+    return store_.histogramValues(
+        absl::StrCat("http.ingress.filter_instrumentation.", filter_name, ".", callback, ".",
+                     metric),
+        false);
+  }
+
+  FilterInstrumentationConfig config_;
+  Stats::TestUtil::TestStore store_;
+  Event::SimulatedTimeSystem time_system_;
+  testing::NiceMock<Random::MockRandomGenerator> random_;
+  FilterInstrumentationPtr instrumentation_;
+};
+
+TEST_F(FilterInstrumentationTest, SampleStream) {
+  config_.mutable_sampling_interval()->set_value(4);
+  initialize();
+
+  EXPECT_CALL(random_, random()).WillOnce(Return(8)).WillOnce(Return(9));
+  EXPECT_TRUE(instrumentation_->sampleStream());
+  EXPECT_FALSE(instrumentation_->sampleStream());
+}
+
+TEST_F(FilterInstrumentationTest, DefaultSamplingInterval) {
+  initialize();
+
+  EXPECT_CALL(random_, random()).WillOnce(Return(200)).WillOnce(Return(250));
+  EXPECT_TRUE(instrumentation_->sampleStream());
+  EXPECT_FALSE(instrumentation_->sampleStream());
+}
+
+// Each filter and callback gets its own histograms.
+TEST_F(FilterInstrumentationTest, RecordsPerFilterAndCallback) {
+  initialize();
+  const FilterInstrumentation::FilterStats& router =
+      instrumentation_->filterStats("envoy.filters.http.router");
+  const FilterInstrumentation::FilterStats& buffer =
+      instrumentation_->filterStats("envoy.filters.http.buffer");
+
+  {
+    FilterInstrumentation::ScopedSample sample(*instrumentation_, router,
+                                               FilterInstrumentation::Callback::DecodeHeaders);
+    time_system_.advanceTimeWait(std::chrono::milliseconds(5));
+  }
+  {
+    FilterInstrumentation::ScopedSample sample(*instrumentation_, router,
+                                               FilterInstrumentation::Callback::DecodeHeaders);
+    time_system_.advanceTimeWait(std::chrono::milliseconds(2));
+  }
+  {
+    FilterInstrumentation::ScopedSample sample(*instrumentation_, buffer,
+                                               FilterInstrumentation::Callback::EncodeData);
+  }
+
+  EXPECT_THAT(values("envoy.filters.http.router", "decode_headers", "wall_time_us"),
+              ElementsAre(5000, 2000));
+  EXPECT_EQ(2, values("envoy.filters.http.router", "decode_headers", "cpu_time_us").size());
+  EXPECT_THAT(values("envoy.filters.http.buffer", "encode_data", "wall_time_us"), ElementsAre(0));
+  EXPECT_FALSE(store_.histogramRecordedValues(
+      "http.ingress.filter_instrumentation.envoy.filters.http.router.decode_data.wall_time_us"));
+  // Allocations are only recorded when requested.
+  EXPECT_FALSE(store_
+                   .findHistogramByString("http.ingress.filter_instrumentation.envoy.filters.http."
+                                          "router.decode_headers.allocated_bytes")
+                   .has_value());
+}
+
+TEST_F(FilterInstrumentationTest, RecordAllocatedBytes) {
+  config_.set_record_allocated_bytes(true);
+  initialize();
+
+  {
+    FilterInstrumentation::ScopedSample sample(
+        *instrumentation_, instrumentation_->filterStats("envoy.filters.http.router"),
+        FilterInstrumentation::Callback::EncodeHeaders);
+    auto allocation = std::make_unique<std::array<char, 4096>>();
+    EXPECT_NE(nullptr, allocation);
+  }
+
+  if (FilterInstrumentation::allocationHookSupported()) {
+    EXPECT_THAT(values("envoy.filters.http.router", "encode_headers", "allocated_bytes"),
+                ElementsAre(testing::Ge(4096)));
+  } else {
+    EXPECT_FALSE(store_.histogramRecordedValues(
+        "http.ingress.filter_instrumentation.envoy.filters.http.router.encode_headers."
+        "allocated_bytes"));
+  }
+}
+
+// The histograms of a filter are resolved once and reused by the following callbacks.
+TEST_F(FilterInstrumentationTest, Measure) {
+  initialize();
+  const FilterInstrumentation::FilterStats* stats = nullptr;
+
+  EXPECT_EQ(1, FilterInstrumentation::measure(nullptr, stats, "envoy.filters.http.router",
+                                              FilterInstrumentation::Callback::DecodeHeaders,
+                                              []() { return 1; }));
+  EXPECT_EQ(nullptr, stats);
+  EXPECT_FALSE(store_
+                   .findHistogramByString("http.ingress.filter_instrumentation.envoy.filters.http."
+                                          "router.decode_headers.wall_time_us")
+                   .has_value());
+
+  EXPECT_EQ(2, FilterInstrumentation::measure(instrumentation_.get(), stats,
+                                              "envoy.filters.http.router",
+                                              FilterInstrumentation::Callback::DecodeHeaders,
+                                              []() { return 2; }));
+  ASSERT_NE(nullptr, stats);
+  EXPECT_EQ(stats, &instrumentation_->filterStats("envoy.filters.http.router"));
+  FilterInstrumentation::measure(instrumentation_.get(), stats, "envoy.filters.http.router",
+                                 FilterInstrumentation::Callback::DecodeData, []() { return 3; });
+
+  EXPECT_EQ(1, values("envoy.filters.http.router", "decode_headers", "wall_time_us").size());
+  EXPECT_EQ(1, values("envoy.filters.http.router", "decode_data", "cpu_time_us").size());
+}
+
+TEST_F(FilterInstrumentationTest, ThreadCpuTime) {
+  const std::chrono::nanoseconds start = FilterInstrumentation::threadCpuTime();
+  volatile uint64_t sum = 0;
+  for (uint64_t i = 0; i < 1000000; ++i) {
+    sum = sum + i * i;
+  }
+  EXPECT_NE(0, sum);
+#ifdef __linux__
+  EXPECT_GT(FilterInstrumentation::threadCpuTime(), start);
+#else
+  EXPECT_EQ(FilterInstrumentation::threadCpuTime(), start);
+#endif
+}
+
+} // namespace
+} // namespace Http
+} // namespace Envoy
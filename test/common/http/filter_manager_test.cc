@@ -6,6 +6,7 @@
 #include "envoy/matcher/matcher.h"
 #include "envoy/stream_info/filter_state.h"
 
+#include "source/common/buffer/buffer_impl.h"
 #include "source/common/http/filter_manager.h"
 #include "source/common/http/matching/inputs.h"
 #include "source/common/matcher/exact_map_matcher.h"
@@ -13,6 +14,8 @@
 #include "source/common/stream_info/filter_state_impl.h"
 #include "source/common/stream_info/stream_info_impl.h"
 
+#include "test/common/stats/stat_test_utility.h"
+#include "test/mocks/common.h"
 #include "test/mocks/event/mocks.h"
 #include "test/mocks/http/mocks.h"
 #include "test/mocks/local_reply/mocks.h"
@@ -328,6 +331,52 @@ TEST_F(FilterManagerTest, OnLocalReply) {
   filter_manager_->destroyFilters();
 }
 
+// Every filter callback of an instrumented stream is measured under the filter's config name.
+TEST_F(FilterManagerTest, FilterInstrumentation) {
+  initialize();
+  Stats::TestUtil::TestStore store;
+  NiceMock<Random::MockRandomGenerator> random;
+  FilterInstrumentation instrumentation(
+      envoy::extensions::filters::network::http_connection_manager::v3::HttpConnectionManager::
+          FilterInstrumentation(),
+      "http.test.", *store.rootScope(), time_source_, random);
+  filter_manager_->setFilterInstrumentation(instrumentation);
+
+  std::shared_ptr<MockStreamDecoderFilter> decoder_filter(new NiceMock<MockStreamDecoderFilter>());
+  std::shared_ptr<MockStreamFilter> stream_filter(new NiceMock<MockStreamFilter>());
+
+  RequestHeaderMapPtr headers{
+      new TestRequestHeaderMapImpl{{":authority", "host"}, {":path", "/"}, {":method", "GET"}}};
+  ON_CALL(filter_manager_callbacks_, requestHeaders()).WillByDefault(Return(makeOptRef(*headers)));
+
+  EXPECT_CALL(filter_factory_, createFilterChain(_))
+      .WillOnce(Invoke([&](FilterChainFactoryCallbacks& callbacks) -> bool {
+        callbacks.setFilterConfigName("first");
+        createDecoderFilterFactoryCb(decoder_filter)(callbacks);
+        callbacks.setFilterConfigName("second");
+        createStreamFilterFactoryCb(stream_filter)(callbacks);
+        return true;
+      }));
+  filter_manager_->createDownstreamFilterChain();
+  filter_manager_->requestHeadersInitialized();
+  filter_manager_->decodeHeaders(*headers, false);
+  Buffer::OwnedImpl data("hello");
+  filter_manager_->decodeData(data, true);
+
+  auto samples = [&store](absl::string_view name) {
+    return store.histogramValues(absl::StrCat("http.test.filter_instrumentation.", name), false)
+        .size();
+  };
+  EXPECT_EQ(1, samples("first.decode_headers.wall_time_us"));
+  EXPECT_EQ(1, samples("first.decode_data.cpu_time_us"));
+  EXPECT_EQ(1, samples("second.decode_headers.cpu_time_us"));
+  EXPECT_EQ(1, samples("second.decode_data.wall_time_us"));
+  EXPECT_FALSE(store.histogramRecordedValues(
+      "http.test.filter_instrumentation.second.encode_headers.wall_time_us"));
+
+  filter_manager_->destroyFilters();
+}
+
 TEST_F(FilterManagerTest, MultipleOnLocalReply) {
   initialize();
 
@@ -7385,6 +7385,15 @@ TEST_P(ListenerManagerImplWithDispatcherStatsTest, DispatherStatsWithCorrectPref
   ASSERT_TRUE(manager_->startWorkers(guard_dog_, callback_.AsStdFunction()).ok());
 }
 
+// Validate that the workers track slow callbacks when configured in the bootstrap.
+TEST_P(ListenerManagerImplTest, SlowCallbackTracker) {
+  server_.bootstrap_.mutable_slow_callback_tracker()->mutable_max_records()->set_value(16);
+  EXPECT_CALL(*worker_, start(_, _));
+  EXPECT_CALL(*worker_, initializeSlowCallbackTracker(
+                            ProtoEq(server_.bootstrap_.slow_callback_tracker())));
+  ASSERT_TRUE(manager_->startWorkers(guard_dog_, callback_.AsStdFunction()).ok());
+}
+
 TEST_P(ListenerManagerImplWithRealFiltersTest, ApiListener) {
   const std::string yaml = R"EOF(
 name: test_api_listener
@@ -0,0 +1,319 @@
+#include <map>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <csignal>
+#endif
+
+#include "envoy/config/bootstrap/v3/bootstrap.pb.h"
+
+#include "source/common/profiler/continuous_cpu_profiler.h"
+
+#include "test/test_common/utility.h"
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/match.h"
+#include "absl/strings/str_join.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Profiler {
+namespace {
+
+using testing::ElementsAre;
+using testing::UnorderedElementsAre;
+
+// A pprof sample, with the locations resolved to function names.
+struct Sample {
+  std::string thread_;
+  std::vector<std::string> frames_;
+  uint64_t count_;
+  uint64_t cpu_nanos_;
+
+  bool operator==(const Sample& other) const {
+    return thread_ == other.thread_ && frames_ == other.frames_ && count_ == other.count_ &&
+           cpu_nanos_ == other.cpu_nanos_;
+  }
+  friend std::ostream& operator<<(std::ostream& os, const Sample& sample) {
+    return os << sample.thread_ << " [" << absl::StrJoin(sample.frames_, ", ") << "] "
+              << sample.count_ << " " << sample.cpu_nanos_;
+  }
+};
+
+struct Profile {
+  std::vector<Sample> samples_;
+  std::vector<std::string> strings_;
+  int64_t time_nanos_{};
+  int64_t duration_nanos_{};
+  int64_t period_{};
+};
+
+uint64_t readVarint(absl::string_view& data) {
+  uint64_t value = 0;
+  for (int shift = 0;; shift += 7) {
+    EXPECT_FALSE(data.empty());
+    if (data.empty()) {
+      return value;
+    }
+    const uint8_t byte = data[0];
+    data.remove_prefix(1);
+    value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+    if ((byte & 0x80) == 0) {
+      return value;
+    }
+  }
+}
+
+struct Field {
+  uint64_t value_{};
+  std::string bytes_;
+};
+
+// Decodes the varint and length-delimited fields of a message, keyed by field number.
+std::multimap<uint32_t, Field> decodeMessage(absl::string_view data) {
+  std::multimap<uint32_t, Field> fields;
+  while (!data.empty()) {
+    const uint64_t tag = readVarint(data);
+    Field field;
+    if ((tag & 7) == 2) {
+      const uint64_t size = readVarint(data);
+      field.bytes_ = std::string(data.substr(0, size));
+      data.remove_prefix(size);
+    } else {
+      EXPECT_EQ(0, tag & 7);
+      field.value_ = readVarint(data);
+    }
+    fields.emplace(tag >> 3, std::move(field));
+  }
+  return fields;
+}
+
+std::vector<uint64_t> decodePacked(absl::string_view data) {
+  std::vector<uint64_t> values;
+  while (!data.empty()) {
+    values.push_back(readVarint(data));
+  }
+  return values;
+}
+
+const Field& onlyField(const std::multimap<uint32_t, Field>& fields, uint32_t number) {
+  EXPECT_EQ(1, fields.count(number));
+  return fields.find(number)->second;
+}
+
+Profile decodeProfile(absl::string_view data) {
+  const std::multimap<uint32_t, Field> fields = decodeMessage(data);
+  Profile profile;
+  auto [strings_begin, strings_end] = fields.equal_range(6);
+  for (auto it = strings_begin; it != strings_end; ++it) {
+    profile.strings_.push_back(it->second.bytes_);
+  }
+  EXPECT_EQ("", profile.strings_[0]);
+
+  absl::flat_hash_map<uint64_t, std::string> functions;
+  auto [functions_begin, functions_end] = fields.equal_range(5);
+  for (auto it = functions_begin; it != functions_end; ++it) {
+    const auto function = decodeMessage(it->second.bytes_);
+    functions[onlyField(function, 1).value_] = profile.strings_[onlyField(function, 2).value_];
+  }
+  absl::flat_hash_map<uint64_t, std::string> locations;
+  auto [locations_begin, locations_end] = fields.equal_range(4);
+  for (auto it = locations_begin; it != locations_end; ++it) {
+    const auto location = decodeMessage(it->second.bytes_);
+    const auto line = decodeMessage(onlyField(location, 4).bytes_);
+    locations[onlyField(location, 1).value_] = functions[onlyField(line, 1).value_];
+  }
+
+  auto [samples_begin, samples_end] = fields.equal_range(2);
+  for (auto it = samples_begin; it != samples_end; ++it) {
+    const auto sample = decodeMessage(it->second.bytes_);
+    Sample decoded;
+    for (const uint64_t id : decodePacked(onlyField(sample, 1).bytes_)) {
+      decoded.frames_.push_back(locations[id]);
+    }
+    const std::vector<uint64_t> values = decodePacked(onlyField(sample, 2).bytes_);
+    EXPECT_EQ(2, values.size());
+    decoded.count_ = values[0];
+    decoded.cpu_nanos_ = values[1];
+    if (sample.count(3) > 0) {
+      const auto label = decodeMessage(onlyField(sample, 3).bytes_);
+      EXPECT_EQ("thread", profile.strings_[onlyField(label, 1).value_]);
+      decoded.thread_ = profile.strings_[onlyField(label, 2).value_];
+    }
+    profile.samples_.push_back(std::move(decoded));
+  }
+  profile.time_nanos_ = onlyField(fields, 9).value_;
+  profile.duration_nanos_ = onlyField(fields, 10).value_;
+  profile.period_ = onlyField(fields, 12).value_;
+  return profile;
+}
+
+class CpuProfileTableTest : public testing::Test {
+public:
+  void initialize(uint32_t max_stacks) {
+    table_ = std::make_unique<CpuProfileTable>(max_stacks, std::chrono::seconds(10),
+                                               std::chrono::milliseconds(10), now_);
+  }
+
+  void advance(std::chrono::seconds duration) {
+    now_ += duration;
+    system_now_ += duration;
+    table_->flush(now_);
+  }
+
+  Profile profile(std::chrono::seconds window) {
+    return decodeProfile(table_->profile(window, now_, system_now_));
+  }
+
+  MonotonicTime now_{std::chrono::seconds(1000)};
+  SystemTime system_now_{std::chrono::seconds(1700000000)};
+  std::unique_ptr<CpuProfileTable> table_;
+  const std::vector<uintptr_t> stack_a_{0x1000, 0x2000};
+  const std::vector<uintptr_t> stack_b_{0x3000, 0x2000};
+};
+
+TEST_F(CpuProfileTableTest, AggregatesSamples) {
+  initialize(100);
+  table_->addSample("worker_0", stack_a_);
+  table_->addSample("worker_0", stack_a_);
+  table_->addSample("worker_1", stack_a_);
+  advance(std::chrono::seconds(1));
+  table_->addSample("worker_0", stack_b_);
+  EXPECT_EQ(3, table_->numStacks());
+
+  const Profile result = profile(std::chrono::seconds(5));
+  EXPECT_THAT(result.samples_,
+              UnorderedElementsAre(Sample{"worker_0", {"0x1000", "0x2000"}, 2, 20000000},
+                                   Sample{"worker_1", {"0x1000", "0x2000"}, 1, 10000000},
+                                   Sample{"worker_0", {"0x3000", "0x2000"}, 1, 10000000}));
+  EXPECT_EQ(10000000, result.period_);
+  EXPECT_EQ(1000000000, result.duration_nanos_);
+  EXPECT_EQ(1700000000000000000, result.time_nanos_);
+}
+
+TEST_F(CpuProfileTableTest, Window) {
+  initialize(100);
+  table_->addSample("worker_0", stack_a_);
+  advance(std::chrono::seconds(3));
+  table_->addSample("worker_0", stack_b_);
+  advance(std::chrono::seconds(1));
+
+  EXPECT_THAT(profile(std::chrono::seconds(1)).samples_,
+              ElementsAre(Sample{"worker_0", {"0x3000", "0x2000"}, 1, 10000000}));
+  EXPECT_EQ(2, profile(std::chrono::seconds(5)).samples_.size());
+}
+
+TEST_F(CpuProfileTableTest, EvictsBucketsOutsideOfMaxWindow) {
+  initialize(100);
+  table_->addSample("worker_0", stack_a_);
+  advance(std::chrono::seconds(1));
+  table_->addSample("worker_0", stack_a_);
+  table_->addSample("worker_0", stack_b_);
+  advance(std::chrono::seconds(10));
+  EXPECT_EQ(2, table_->numStacks());
+
+  // The bucket of the first sample is evicted, while stack_a_ is still referenced by the second
+  // one.
+  advance(std::chrono::seconds(1));
+  EXPECT_EQ(2, table_->numStacks());
+  EXPECT_THAT(profile(std::chrono::seconds(60)).samples_,
+              UnorderedElementsAre(Sample{"worker_0", {"0x1000", "0x2000"}, 1, 10000000},
+                                   Sample{"worker_0", {"0x3000", "0x2000"}, 1, 10000000}));
+
+  advance(std::chrono::seconds(10));
+  EXPECT_EQ(0, table_->numStacks());
+  EXPECT_TRUE(profile(std::chrono::seconds(60)).samples_.empty());
+
+  // The ids of the forgotten stacks are reused.
+  table_->addSample("worker_0", stack_b_);
+  EXPECT_THAT(profile(std::chrono::seconds(60)).samples_,
+              ElementsAre(Sample{"worker_0", {"0x3000", "0x2000"}, 1, 10000000}));
+}
+
+TEST_F(CpuProfileTableTest, MaxStacks) {
+  initialize(1);
+  table_->addSample("worker_0", stack_a_);
+  table_->addSample("worker_0", stack_b_);
+  table_->addSample("worker_1", stack_a_);
+  table_->addSample("worker_0", stack_a_);
+  table_->addDroppedSamples(3);
+  EXPECT_EQ(1, table_->numStacks());
+
+  EXPECT_THAT(profile(std::chrono::seconds(5)).samples_,
+              UnorderedElementsAre(Sample{"worker_0", {"0x1000", "0x2000"}, 2, 20000000},
+                                   Sample{"", {"[dropped samples]"}, 5, 50000000}));
+}
+
+TEST_F(CpuProfileTableTest, SymbolizesFunctions) {
+  initialize(100);
+  table_->addSample("worker_0", {reinterpret_cast<uintptr_t>(&readVarint)});
+  const Profile result = profile(std::chrono::seconds(5));
+  ASSERT_EQ(1, result.samples_.size());
+  ASSERT_EQ(1, result.samples_[0].frames_.size());
+  // The symbol may not be available, e.g. in stripped binaries.
+  const std::string& frame = result.samples_[0].frames_[0];
+  EXPECT_TRUE(absl::StrContains(frame, "readVarint") || absl::StartsWith(frame, "0x")) << frame;
+}
+
+#ifdef __linux__
+// Spins until the profiler has taken a sample of this thread.
+TEST(ContinuousCpuProfilerTest, SamplesThreads) {
+  Api::ApiPtr api = Api::createApiForTest();
+  Event::DispatcherPtr dispatcher = api->allocateDispatcher("test_thread");
+  envoy::config::bootstrap::v3::ContinuousCpuProfiler config;
+  config.mutable_sampling_frequency()->set_value(1000);
+
+  auto profiler_or_error = ContinuousCpuProfiler::create(config, *dispatcher);
+  ASSERT_TRUE(profiler_or_error.ok()) << profiler_or_error.status();
+  ContinuousCpuProfilerPtr profiler = std::move(profiler_or_error.value());
+  EXPECT_EQ(profiler.get(), ContinuousCpuProfiler::instance());
+  EXPECT_EQ(std::chrono::seconds(60), profiler->maxWindow());
+  EXPECT_EQ(absl::StatusCode::kFailedPrecondition,
+            ContinuousCpuProfiler::create(config, *dispatcher).status().code());
+
+  ContinuousCpuProfiler::setThreadLabel("test_thread");
+  bool sampled = false;
+  volatile uint64_t sink = 0;
+  for (int i = 0; i < 1000 && !sampled; ++i) {
+    for (int j = 0; j < 1000000; ++j) {
+      sink = sink + j;
+    }
+    const Profile profile = decodeProfile(profiler->profile(std::chrono::seconds(60)));
+    for (const Sample& sample : profile.samples_) {
+      sampled |= sample.thread_ == "test_thread" && !sample.frames_.empty();
+    }
+  }
+  EXPECT_TRUE(sampled);
+
+  profiler.reset();
+  EXPECT_EQ(nullptr, ContinuousCpuProfiler::instance());
+}
+
+void testProfilingHandler(int) {}
+
+TEST(ContinuousCpuProfilerTest, RestoresPreviousSignalHandler) {
+  Api::ApiPtr api = Api::createApiForTest();
+  Event::DispatcherPtr dispatcher = api->allocateDispatcher("test_thread");
+  struct sigaction action {};
+  action.sa_handler = testProfilingHandler;
+  sigemptyset(&action.sa_mask);
+  struct sigaction original;
+  ASSERT_EQ(0, sigaction(SIGPROF, &action, &original));
+
+  auto profiler_or_error = ContinuousCpuProfiler::create({}, *dispatcher);
+  ASSERT_TRUE(profiler_or_error.ok()) << profiler_or_error.status();
+  struct sigaction current;
+  ASSERT_EQ(0, sigaction(SIGPROF, nullptr, &current));
+  EXPECT_NE(current.sa_handler, testProfilingHandler);
+
+  profiler_or_error.value().reset();
+  ASSERT_EQ(0, sigaction(SIGPROF, &original, &current));
+  EXPECT_EQ(current.sa_handler, testProfilingHandler);
+}
+#endif
+
+} // namespace
+} // namespace Profiler
+} // namespace Envoy
@@ -2546,6 +2546,364 @@ virtual_hosts:
   }
 }
 
+// A regex engine that supports matcher sets by evaluating RE2 expressions one at a time. It counts
+// the scans done through sets and the matches done through individual matchers.
+class CountingRegexEngine : public Regex::Engine {
+public:
+  class CountingMatcher : public Regex::CompiledMatcher {
+  public:
+    CountingMatcher(Regex::CompiledMatcherPtr matcher, uint64_t& calls)
+        : matcher_(std::move(matcher)), calls_(calls) {}
+
+    using Regex::CompiledMatcher::match;
+    bool match(absl::string_view value) const override {
+      ++calls_;
+      return matcher_->match(value);
+    }
+    std::string replaceAll(absl::string_view value, absl::string_view substitution) const override {
+      return matcher_->replaceAll(value, substitution);
+    }
+    const std::string& pattern() const override { return matcher_->pattern(); }
+
+  private:
+    const Regex::CompiledMatcherPtr matcher_;
+    uint64_t& calls_;
+  };
+
+  class SequentialMatcherSet : public Regex::CompiledMatcherSet {
+  public:
+    SequentialMatcherSet(std::vector<Regex::CompiledMatcherPtr> matchers, uint64_t& calls,
+                         const bool& fail)
+        : matchers_(std::move(matchers)), calls_(calls), fail_(fail) {}
+
+    bool match(absl::string_view value, std::vector<uint32_t>& matched) const override {
+      ++calls_;
+      matched.clear();
+      if (fail_) {
+        return false;
+      }
+      for (uint32_t i = 0; i < matchers_.size(); ++i) {
+        if (matchers_[i]->match(value)) {
+          matched.push_back(i);
+        }
+      }
+      return true;
+    }
+    uint32_t size() const override { return matchers_.size(); }
+
+  private:
+    const std::vector<Regex::CompiledMatcherPtr> matchers_;
+    uint64_t& calls_;
+    const bool& fail_;
+  };
+
+  absl::StatusOr<Regex::CompiledMatcherPtr> matcher(const std::string& regex) const override {
+    return std::make_unique<CountingMatcher>(engine_.matcher(regex).value(), matcher_calls_);
+  }
+
+  absl::StatusOr<Regex::CompiledMatcherSetPtr>
+  matcherSet(const std::vector<std::string>& regexes) const override {
+    std::vector<Regex::CompiledMatcherPtr> matchers;
+    for (const std::string& regex : regexes) {
+      matchers.push_back(engine_.matcher(regex).value());
+    }
+    set_regexes_.push_back(regexes);
+    return std::make_unique<SequentialMatcherSet>(std::move(matchers), set_calls_,
+                                                  fail_set_matches_);
+  }
+
+  Regex::GoogleReEngine engine_;
+  mutable std::vector<std::vector<std::string>> set_regexes_;
+  mutable uint64_t matcher_calls_{};
+  mutable uint64_t set_calls_{};
+  bool fail_set_matches_{};
+};
+
+class CountingRegexEngineFactoryContext : public Server::Configuration::MockServerFactoryContext {
+public:
+  Regex::Engine& regexEngine() override { return engine_; }
+
+  CountingRegexEngine engine_;
+};
+
+class RegexRouteMatcherSetTest : public testing::Test, public TestScopedRuntime {
+protected:
+  RegexRouteMatcherSetTest() {
+    mergeValues({{"envoy.reloadable_features.route_regex_matcher_set", "true"}});
+  }
+
+  std::string routeName(const TestConfigImpl& config, const std::string& path,
+                        const std::string& header = "") {
+    Http::TestRequestHeaderMapImpl headers = genHeaders("www.lyft.com", path, "GET");
+    if (!header.empty()) {
+      headers.addCopy("x-canary", header);
+    }
+    return config.route(headers, 0)->routeName();
+  }
+
+  NiceMock<CountingRegexEngineFactoryContext> factory_context_;
+  absl::Status creation_status_ = absl::OkStatus();
+};
+
+// When the regex engine supports matcher sets, the path regexes of a virtual host's routes are
+// matched in a single scan and only regex routes whose regex matched are evaluated further.
+TEST_F(RegexRouteMatcherSetTest, RegexRoutesMatchedInOneScan) {
+  const std::string yaml = R"EOF(
+virtual_hosts:
+- name: local_service
+  domains: ["*"]
+  routes:
+  - match:
+      safe_regex:
+        regex: "/api/v[0-9]+/users"
+    name: "users"
+    route:
+      cluster: local_service
+  - match:
+      prefix: "/static"
+    name: "static"
+    route:
+      cluster: local_service
+  - match:
+      safe_regex:
+        regex: "/api/v[0-9]+/orders/[0-9]+"
+      headers:
+      - name: x-canary
+        string_match:
+          exact: "true"
+    name: "orders-canary"
+    route:
+      cluster: local_service
+  - match:
+      safe_regex:
+        regex: "/api/v[0-9]+/orders/[0-9]+"
+    name: "orders"
+    route:
+      cluster: local_service
+  - match:
+      safe_regex:
+        regex: ".*"
+    name: "catchall"
+    route:
+      cluster: local_service
+  )EOF";
+
+  TestConfigImpl config(parseRouteConfigurationFromYaml(yaml), factory_context_, false,
+                        creation_status_);
+  ASSERT_TRUE(creation_status_.ok());
+  const CountingRegexEngine& engine = factory_context_.engine_;
+  ASSERT_EQ(1, engine.set_regexes_.size());
+  EXPECT_THAT(engine.set_regexes_[0],
+              ElementsAre("/api/v[0-9]+/users", "/api/v[0-9]+/orders/[0-9]+",
+                          "/api/v[0-9]+/orders/[0-9]+", ".*"));
+
+  // Only the regex of the selected route is evaluated after the scan.
+  EXPECT_EQ("users", routeName(config, "/api/v1/users?limit=10"));
+  EXPECT_EQ(1, engine.set_calls_);
+  EXPECT_EQ(1, engine.matcher_calls_);
+
+  EXPECT_EQ("orders", routeName(config, "/api/v2/orders/42"));
+  EXPECT_EQ(2, engine.set_calls_);
+  EXPECT_EQ(2, engine.matcher_calls_);
+
+  EXPECT_EQ("orders-canary", routeName(config, "/api/v2/orders/42", "true"));
+  EXPECT_EQ(3, engine.set_calls_);
+  EXPECT_EQ(3, engine.matcher_calls_);
+
+  // The users regex is skipped without being evaluated.
+  EXPECT_EQ("static", routeName(config, "/static/app.js"));
+  EXPECT_EQ(4, engine.set_calls_);
+  EXPECT_EQ(3, engine.matcher_calls_);
+
+  EXPECT_EQ("catchall", routeName(config, "/api/v1/users/42"));
+  EXPECT_EQ(5, engine.set_calls_);
+  EXPECT_EQ(4, engine.matcher_calls_);
+}
+
+// The scanned path is sanitized in the same way as for individual regex matches.
+TEST_F(RegexRouteMatcherSetTest, IgnorePathParameters) {
+  const std::string yaml = R"EOF(
+ignore_path_parameters_in_path_matching: true
+virtual_hosts:
+- name: local_service
+  domains: ["*"]
+  routes:
+  - match:
+      safe_regex:
+        regex: "/users/[0-9]+"
+    name: "user"
+    route:
+      cluster: local_service
+  - match:
+      safe_regex:
+        regex: "/users/.*"
+    name: "users"
+    route:
+      cluster: local_service
+  )EOF";
+
+  TestConfigImpl config(parseRouteConfigurationFromYaml(yaml), factory_context_, false,
+                        creation_status_);
+  ASSERT_TRUE(creation_status_.ok());
+  EXPECT_EQ("user", routeName(config, "/users/42;version=3?a=b"));
+  EXPECT_EQ("users", routeName(config, "/users/me;version=3"));
+  EXPECT_EQ(2, factory_context_.engine_.set_calls_);
+}
+
+// When the set cannot be evaluated, every regex route is matched individually.
+TEST_F(RegexRouteMatcherSetTest, FailedScanMatchesRoutesIndividually) {
+  const std::string yaml = R"EOF(
+virtual_hosts:
+- name: local_service
+  domains: ["*"]
+  routes:
+  - match:
+      safe_regex:
+        regex: "/users/[0-9]+"
+    name: "user"
+    route:
+      cluster: local_service
+  - match:
+      safe_regex:
+        regex: "/users/.*"
+    name: "users"
+    route:
+      cluster: local_service
+  )EOF";
+
+  TestConfigImpl config(parseRouteConfigurationFromYaml(yaml), factory_context_, false,
+                        creation_status_);
+  ASSERT_TRUE(creation_status_.ok());
+  factory_context_.engine_.fail_set_matches_ = true;
+  EXPECT_EQ("users", routeName(config, "/users/me"));
+  EXPECT_EQ(1, factory_context_.engine_.set_calls_);
+  EXPECT_EQ(2, factory_context_.engine_.matcher_calls_);
+}
+
+// The set is only scanned once a lookup reaches a regex route, so a request matched by an earlier
+// route does not pay for it.
+TEST_F(RegexRouteMatcherSetTest, ScanDeferredToFirstRegexRoute) {
+  const std::string yaml = R"EOF(
+virtual_hosts:
+- name: local_service
+  domains: ["*"]
+  routes:
+  - match:
+      prefix: "/static"
+    name: "static"
+    route:
+      cluster: local_service
+  - match:
+      safe_regex:
+        regex: "/users/[0-9]+"
+    name: "user"
+    route:
+      cluster: local_service
+  - match:
+      safe_regex:
+        regex: "/users/.*"
+    name: "users"
+    route:
+      cluster: local_service
+  )EOF";
+
+  TestConfigImpl config(parseRouteConfigurationFromYaml(yaml), factory_context_, false,
+                        creation_status_);
+  ASSERT_TRUE(creation_status_.ok());
+  EXPECT_EQ("static", routeName(config, "/static/app.js"));
+  EXPECT_EQ(0, factory_context_.engine_.set_calls_);
+  EXPECT_EQ(0, factory_context_.engine_.matcher_calls_);
+
+  EXPECT_EQ("users", routeName(config, "/users/me"));
+  EXPECT_EQ(1, factory_context_.engine_.set_calls_);
+  EXPECT_EQ(1, factory_context_.engine_.matcher_calls_);
+}
+
+// Without the runtime feature, every regex route is matched individually.
+TEST_F(RegexRouteMatcherSetTest, DisabledByRuntime) {
+  mergeValues({{"envoy.reloadable_features.route_regex_matcher_set", "false"}});
+  const std::string yaml = R"EOF(
+virtual_hosts:
+- name: local_service
+  domains: ["*"]
+  routes:
+  - match:
+      safe_regex:
+        regex: "/users/[0-9]+"
+    name: "user"
+    route:
+      cluster: local_service
+  - match:
+      safe_regex:
+        regex: "/users/.*"
+    name: "users"
+    route:
+      cluster: local_service
+  )EOF";
+
+  TestConfigImpl config(parseRouteConfigurationFromYaml(yaml), factory_context_, false,
+                        creation_status_);
+  ASSERT_TRUE(creation_status_.ok());
+  EXPECT_EQ("users", routeName(config, "/users/me"));
+  EXPECT_TRUE(factory_context_.engine_.set_regexes_.empty());
+  EXPECT_EQ(0, factory_context_.engine_.set_calls_);
+  EXPECT_EQ(2, factory_context_.engine_.matcher_calls_);
+}
+
+// The set holds the first 64 regex routes, and later ones are matched individually.
+TEST_F(RegexRouteMatcherSetTest, RegexRoutesBeyondSetSize) {
+  envoy::config::route::v3::RouteConfiguration route_config;
+  auto* virtual_host = route_config.add_virtual_hosts();
+  virtual_host->set_name("local_service");
+  virtual_host->add_domains("*");
+  for (uint32_t i = 0; i < 65; ++i) {
+    auto* route = virtual_host->add_routes();
+    route->set_name(absl::StrCat("route", i));
+    route->mutable_match()->mutable_safe_regex()->set_regex(absl::StrCat("/route", i));
+    route->mutable_route()->set_cluster("local_service");
+  }
+
+  TestConfigImpl config(route_config, factory_context_, false, creation_status_);
+  ASSERT_TRUE(creation_status_.ok());
+  ASSERT_EQ(1, factory_context_.engine_.set_regexes_.size());
+  EXPECT_EQ(64, factory_context_.engine_.set_regexes_[0].size());
+
+  EXPECT_EQ("route63", routeName(config, "/route63"));
+  EXPECT_EQ(1, factory_context_.engine_.matcher_calls_);
+  EXPECT_EQ("route64", routeName(config, "/route64"));
+  EXPECT_EQ(2, factory_context_.engine_.matcher_calls_);
+  EXPECT_EQ(2, factory_context_.engine_.set_calls_);
+}
+
+// A single regex route does not use a matcher set.
+TEST_F(RegexRouteMatcherSetTest, SingleRegexRoute) {
+  const std::string yaml = R"EOF(
+virtual_hosts:
+- name: local_service
+  domains: ["*"]
+  routes:
+  - match:
+      prefix: "/static"
+    name: "static"
+    route:
+      cluster: local_service
+  - match:
+      safe_regex:
+        regex: "/users/[0-9]+"
+    name: "user"
+    route:
+      cluster: local_service
+  )EOF";
+
+  TestConfigImpl config(parseRouteConfigurationFromYaml(yaml), factory_context_, false,
+                        creation_status_);
+  ASSERT_TRUE(creation_status_.ok());
+  EXPECT_EQ("user", routeName(config, "/users/42"));
+  EXPECT_TRUE(factory_context_.engine_.set_regexes_.empty());
+  EXPECT_EQ(0, factory_context_.engine_.set_calls_);
+  EXPECT_EQ(1, factory_context_.engine_.matcher_calls_);
+}
+
 // Tests that when 'ignore_port_in_host_matching' is true, port from host header
 // is ignored in host matching.
 TEST_F(RouteMatcherTest, IgnorePortInHostMatching) {
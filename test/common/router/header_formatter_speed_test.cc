@@ -4,6 +4,7 @@
 #include "test/mocks/common.h"
 #include "test/test_common/utility.h"
 
+#include "absl/strings/str_cat.h"
 #include "benchmark/benchmark.h"
 
 namespace Envoy {
@@ -31,8 +32,8 @@ static void bmEvaluateHeaders(benchmark::State& state) {
       header_value_option->set_append_action(HeaderValueOption::OVERWRITE_IF_EXISTS_OR_ADD);
     }
     mutable_header->set_key(fmt::format("test{}", i));
-    // The value of the header to add is a static string. HeaderParser::configure will allocate a
-    // simple formatter which does no real formatting and returns the same string.
+    // The value of the header to add is a static string, which HeaderParser adds as is without
+    // invoking its formatter.
     mutable_header->set_value("TEST");
   }
 
@@ -46,5 +47,51 @@ static void bmEvaluateHeaders(benchmark::State& state) {
 
 BENCHMARK(bmEvaluateHeaders)->DenseRange(2, 20, 2);
 
+// Creates a parser that overwrites `count` headers named <prefix><i> with a constant value.
+static HeaderParserPtr constantHeaderParser(absl::string_view prefix, int64_t count) {
+  Protobuf::RepeatedPtrField<envoy::config::core::v3::HeaderValueOption> headers_to_add;
+  for (int64_t i = 0; i < count; i++) {
+    envoy::config::core::v3::HeaderValueOption* header_value_option = headers_to_add.Add();
+    header_value_option->set_append_action(HeaderValueOption::OVERWRITE_IF_EXISTS_OR_ADD);
+    header_value_option->mutable_header()->set_key(absl::StrCat(prefix, i));
+    header_value_option->mutable_header()->set_value("TEST");
+  }
+  return HeaderParser::configure(headers_to_add).value();
+}
+
+// Compares evaluating the route configuration, virtual host and route level parsers of a route
+// one after the other (plan=0) with evaluating the HeaderMutationPlan compiled from them (plan=1),
+// which is what the router does. Every level overwrites headers_per_level constant headers.
+static void bmEvaluateHeaderLevels(benchmark::State& state) {
+  auto request_header = Http::RequestHeaderMapImpl::create();
+  request_header->addCopy(Http::LowerCaseString("bar"), "a");
+
+  Event::SimulatedTimeSystem time_system;
+  const auto stream_info = std::make_unique<Envoy::TestStreamInfo>(time_system);
+
+  const HeaderParserPtr global = constantHeaderParser("global", state.range(0));
+  const HeaderParserPtr vhost = constantHeaderParser("vhost", state.range(0));
+  const HeaderParserPtr route = constantHeaderParser("route", state.range(0));
+  const std::array<const HeaderParser*, 3> parsers{global.get(), vhost.get(), route.get()};
+  const HeaderMutationPlanConstSharedPtr plan = HeaderMutationPlan::compile(parsers);
+
+  if (state.range(1) != 0) {
+    for (auto _ : state) { // NOLINT: Silences warning about dead store
+      plan->evaluateHeaders(*request_header, {request_header.get()}, *stream_info);
+    }
+  } else {
+    for (auto _ : state) { // NOLINT: Silences warning about dead store
+      for (const HeaderParser* parser : parsers) {
+        parser->evaluateHeaders(*request_header, {request_header.get()}, *stream_info);
+      }
+    }
+  }
+  state.counters["passes"] = state.range(1) != 0 ? plan->passes() : parsers.size();
+}
+
+BENCHMARK(bmEvaluateHeaderLevels)
+    ->ArgNames({"headers_per_level", "plan"})
+    ->ArgsProduct({{1, 4, 8}, {0, 1}});
+
 } // namespace Router
 } // namespace Envoy
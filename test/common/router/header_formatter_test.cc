@@ -1204,6 +1204,119 @@ response_headers_to_remove: ["x-baz-header"]
   }
 }
 
+HeaderParserPtr requestHeaderParser(const std::string& headers_yaml) {
+  const auto route = parseRouteFromV3Yaml("match: { prefix: \"/\" }\nroute: { cluster: www2 }\n" +
+                                          headers_yaml);
+  return HeaderParser::configure(route.request_headers_to_add(), route.request_headers_to_remove())
+      .value();
+}
+
+// Evaluates the plan of the parsers and checks that the result is the same as evaluating the
+// parsers one after the other.
+Http::TestRequestHeaderMapImpl
+evaluatePlanAndParsers(const HeaderMutationPlan& plan,
+                       const std::vector<const HeaderParser*>& parsers,
+                       const Http::TestRequestHeaderMapImpl& original_headers) {
+  NiceMock<Envoy::StreamInfo::MockStreamInfo> stream_info;
+  Http::TestRequestHeaderMapImpl plan_headers(original_headers);
+  plan.evaluateHeaders(plan_headers, {&plan_headers}, stream_info);
+
+  Http::TestRequestHeaderMapImpl parser_headers(original_headers);
+  for (const HeaderParser* parser : parsers) {
+    parser->evaluateHeaders(parser_headers, {&parser_headers}, stream_info);
+  }
+  EXPECT_EQ(parser_headers, plan_headers);
+  return plan_headers;
+}
+
+TEST(HeaderMutationPlanTest, ConstantHeadersFoldedIntoOnePass) {
+  HeaderParserPtr global = requestHeaderParser(R"EOF(
+request_headers_to_add:
+  - header: { key: "x-a", value: "1" }
+    append_action: APPEND_IF_EXISTS_OR_ADD
+  - header: { key: "x-copy", value: "%REQ(x-src)%" }
+    append_action: ADD_IF_ABSENT
+request_headers_to_remove: ["x-removed"]
+)EOF");
+  HeaderParserPtr vhost = requestHeaderParser(R"EOF(
+request_headers_to_add:
+  - header: { key: "x-b", value: "2" }
+    append_action: OVERWRITE_IF_EXISTS_OR_ADD
+  - header: { key: "x-a", value: "3" }
+    append_action: APPEND_IF_EXISTS_OR_ADD
+)EOF");
+  const std::vector<const HeaderParser*> parsers{global.get(), vhost.get(),
+                                                 &HeaderParser::defaultParser()};
+  const auto plan = HeaderMutationPlan::compile(parsers);
+  EXPECT_EQ(1, plan->passes());
+
+  const auto headers = evaluatePlanAndParsers(
+      *plan, parsers, {{"x-src", "s"}, {"x-b", "old"}, {"x-removed", "r"}});
+  EXPECT_EQ("s", headers.get_("x-copy"));
+  EXPECT_EQ("2", headers.get_("x-b"));
+  EXPECT_EQ(2, headers.get(Http::LowerCaseString("x-a")).size());
+  EXPECT_FALSE(headers.has("x-removed"));
+}
+
+// A later overwrite of a header added by an earlier parser must replace the added value.
+TEST(HeaderMutationPlanTest, OverwriteOfAddedHeaderNotFolded) {
+  HeaderParserPtr first = requestHeaderParser(R"EOF(
+request_headers_to_add:
+  - header: { key: "x-a", value: "1" }
+    append_action: APPEND_IF_EXISTS_OR_ADD
+)EOF");
+  HeaderParserPtr second = requestHeaderParser(R"EOF(
+request_headers_to_add:
+  - header: { key: "x-a", value: "2" }
+    append_action: OVERWRITE_IF_EXISTS_OR_ADD
+)EOF");
+  const std::vector<const HeaderParser*> parsers{first.get(), second.get()};
+  const auto plan = HeaderMutationPlan::compile(parsers);
+  EXPECT_EQ(2, plan->passes());
+
+  const auto headers = evaluatePlanAndParsers(*plan, parsers, {{"x-a", "0"}});
+  EXPECT_EQ(1, headers.get(Http::LowerCaseString("x-a")).size());
+  EXPECT_EQ("2", headers.get_("x-a"));
+}
+
+// Formatted values, conditional actions and removals may depend on the headers set by earlier
+// parsers, so they get a pass of their own.
+TEST(HeaderMutationPlanTest, DependentHeadersNotFolded) {
+  HeaderParserPtr first = requestHeaderParser(R"EOF(
+request_headers_to_add:
+  - header: { key: "x-a", value: "1" }
+    append_action: OVERWRITE_IF_EXISTS_OR_ADD
+)EOF");
+  HeaderParserPtr formatted = requestHeaderParser(R"EOF(
+request_headers_to_add:
+  - header: { key: "x-copy", value: "%REQ(x-a)%" }
+)EOF");
+  HeaderParserPtr conditional = requestHeaderParser(R"EOF(
+request_headers_to_add:
+  - header: { key: "x-a", value: "2" }
+    append_action: ADD_IF_ABSENT
+)EOF");
+  HeaderParserPtr removal = requestHeaderParser(R"EOF(
+request_headers_to_remove: ["x-copy"]
+)EOF");
+
+  for (const HeaderParser* parser : {formatted.get(), conditional.get(), removal.get()}) {
+    const std::vector<const HeaderParser*> parsers{first.get(), parser};
+    const auto plan = HeaderMutationPlan::compile(parsers);
+    EXPECT_EQ(2, plan->passes());
+    const auto headers = evaluatePlanAndParsers(*plan, parsers, {{"x-copy", "0"}});
+    EXPECT_EQ("1", headers.get_("x-a"));
+  }
+}
+
+TEST(HeaderMutationPlanTest, EmptyParsersDropped) {
+  const std::vector<const HeaderParser*> parsers{&HeaderParser::defaultParser(),
+                                                 &HeaderParser::defaultParser()};
+  const auto plan = HeaderMutationPlan::compile(parsers);
+  EXPECT_EQ(0, plan->passes());
+  evaluatePlanAndParsers(*plan, parsers, {{"x-a", "0"}});
+}
+
 } // namespace
 } // namespace Router
 } // namespace Envoy
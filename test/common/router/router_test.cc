@@ -8309,5 +8309,113 @@ TEST_F(RouterTest, OrcaLoadReportSkipsEntriesNotInterestedInOrca) {
   response_decoder->decodeHeaders(std::move(response_headers), true);
 }
 
+class TestResponseLatencyLbData : public Upstream::HostLbPolicyData {
+public:
+  bool receivesOrcaLoadReport() const override { return false; }
+  MOCK_METHOD(void, onUpstreamResponseLatency, (std::chrono::microseconds, MonotonicTime),
+              (override));
+  MOCK_METHOD(void, onUpstreamRequestFailure, (std::chrono::microseconds, MonotonicTime),
+              (override));
+};
+
+// The time to the first byte of the response is reported to the host lb policy data on the
+// response headers.
+TEST_F(RouterTest, ResponseLatencyReportedToHostLbPolicyData) {
+  EXPECT_CALL(callbacks_.route_->route_entry_, timeout())
+      .WillOnce(Return(std::chrono::milliseconds(0)));
+  EXPECT_CALL(callbacks_.dispatcher_, createTimer_(_)).Times(0);
+
+  NiceMock<Http::MockRequestEncoder> encoder;
+  Http::ResponseDecoder* response_decoder = nullptr;
+  expectNewStreamWithImmediateEncoder(encoder, &response_decoder, Http::Protocol::Http10);
+
+  Http::TestRequestHeaderMapImpl headers;
+  HttpTestUtility::addDefaultHeaders(headers);
+  router_->decodeHeaders(headers, true);
+
+  auto host_lb_policy_data = std::make_unique<TestResponseLatencyLbData>();
+  auto* host_lb_policy_data_raw_ptr = host_lb_policy_data.get();
+  cm_.thread_local_cluster_.conn_pool_.host_->addLbPolicyData(std::move(host_lb_policy_data));
+
+  EXPECT_CALL(*host_lb_policy_data_raw_ptr, onUpstreamResponseLatency(_, _))
+      .WillOnce(Invoke([](std::chrono::microseconds latency, MonotonicTime) {
+        EXPECT_GE(latency.count(), 0);
+      }));
+  Http::ResponseHeaderMapPtr response_headers(
+      new Http::TestResponseHeaderMapImpl{{":status", "200"}});
+  response_decoder->decodeHeaders(std::move(response_headers), true);
+}
+
+// A request which times out without a response is reported to the host lb policy data.
+TEST_F(RouterTest, TimeoutReportedToHostLbPolicyData) {
+  NiceMock<Http::MockRequestEncoder> encoder;
+  Http::ResponseDecoder* response_decoder = nullptr;
+  expectNewStreamWithImmediateEncoder(encoder, &response_decoder, Http::Protocol::Http10);
+  expectResponseTimerCreate();
+
+  Http::TestRequestHeaderMapImpl headers;
+  HttpTestUtility::addDefaultHeaders(headers);
+  router_->decodeHeaders(headers, true);
+
+  auto host_lb_policy_data = std::make_unique<TestResponseLatencyLbData>();
+  auto* host_lb_policy_data_raw_ptr = host_lb_policy_data.get();
+  cm_.thread_local_cluster_.conn_pool_.host_->addLbPolicyData(std::move(host_lb_policy_data));
+
+  EXPECT_CALL(*host_lb_policy_data_raw_ptr, onUpstreamRequestFailure(_, _));
+  EXPECT_CALL(*host_lb_policy_data_raw_ptr, onUpstreamResponseLatency(_, _)).Times(0);
+  EXPECT_CALL(encoder.stream_, resetStream(Http::StreamResetReason::LocalReset));
+  EXPECT_CALL(callbacks_, encodeHeaders_(_, false));
+  EXPECT_CALL(callbacks_, encodeData(_, true));
+  response_timeout_->invokeCallback();
+}
+
+// A request which is reset before the response headers is reported to the host lb policy data.
+TEST_F(RouterTest, ResetBeforeResponseReportedToHostLbPolicyData) {
+  NiceMock<Http::MockRequestEncoder> encoder;
+  Http::ResponseDecoder* response_decoder = nullptr;
+  expectNewStreamWithImmediateEncoder(encoder, &response_decoder, Http::Protocol::Http10);
+  expectResponseTimerCreate();
+
+  Http::TestRequestHeaderMapImpl headers;
+  HttpTestUtility::addDefaultHeaders(headers);
+  router_->decodeHeaders(headers, true);
+
+  auto host_lb_policy_data = std::make_unique<TestResponseLatencyLbData>();
+  auto* host_lb_policy_data_raw_ptr = host_lb_policy_data.get();
+  cm_.thread_local_cluster_.conn_pool_.host_->addLbPolicyData(std::move(host_lb_policy_data));
+
+  EXPECT_CALL(*host_lb_policy_data_raw_ptr, onUpstreamRequestFailure(_, _));
+  EXPECT_CALL(callbacks_, sendLocalReply(Http::Code::ServiceUnavailable, _, _, _, _))
+      .WillOnce(InvokeWithoutArgs([] {}));
+  encoder.stream_.resetStream(Http::StreamResetReason::RemoteReset);
+}
+
+// A reset once the response headers have been received is not a slow response, and is not
+// reported to the host lb policy data.
+TEST_F(RouterTest, ResetAfterResponseHeadersNotReportedToHostLbPolicyData) {
+  NiceMock<Http::MockRequestEncoder> encoder;
+  Http::ResponseDecoder* response_decoder = nullptr;
+  expectNewStreamWithImmediateEncoder(encoder, &response_decoder, Http::Protocol::Http10);
+  expectResponseTimerCreate();
+
+  Http::TestRequestHeaderMapImpl headers;
+  HttpTestUtility::addDefaultHeaders(headers);
+  router_->decodeHeaders(headers, true);
+
+  auto host_lb_policy_data = std::make_unique<TestResponseLatencyLbData>();
+  auto* host_lb_policy_data_raw_ptr = host_lb_policy_data.get();
+  cm_.thread_local_cluster_.conn_pool_.host_->addLbPolicyData(std::move(host_lb_policy_data));
+
+  EXPECT_CALL(*host_lb_policy_data_raw_ptr, onUpstreamResponseLatency(_, _));
+  EXPECT_CALL(*host_lb_policy_data_raw_ptr, onUpstreamRequestFailure(_, _)).Times(0);
+  EXPECT_CALL(callbacks_, encodeHeaders_(_, false));
+  Http::ResponseHeaderMapPtr response_headers(
+      new Http::TestResponseHeaderMapImpl{{":status", "200"}});
+  response_decoder->decodeHeaders(std::move(response_headers), false);
+
+  EXPECT_CALL(callbacks_, sendLocalReply(_, _, _, _, _)).WillOnce(InvokeWithoutArgs([] {}));
+  encoder.stream_.resetStream(Http::StreamResetReason::RemoteReset);
+}
+
 } // namespace Router
 } // namespace Envoy
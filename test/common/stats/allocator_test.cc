@@ -626,6 +626,111 @@ TEST_F(AllocatorTest, ForEachSinkedTextReadout) {
   EXPECT_EQ(num_iterations, 0);
 }
 
+// A second process, the hot restart child of alloc_'s, attached to the same shared stat region.
+class SharedStatAllocatorTest : public AllocatorTest {
+protected:
+  SharedStatAllocatorTest()
+      : memory_(SharedStatRegion::bytesRequired(4) / sizeof(uint64_t)),
+        region_(SharedStatRegion::create(memory_.data(), 4, 0)),
+        other_region_(
+            SharedStatRegion::attach(memory_.data(), memory_.size() * sizeof(uint64_t), 1).value()),
+        other_pool_(other_symbol_table_), other_alloc_(other_symbol_table_) {
+    alloc_.setSharedStatRegion(region_.get());
+    other_alloc_.setSharedStatRegion(other_region_.get());
+  }
+  ~SharedStatAllocatorTest() override { other_pool_.clear(); }
+
+  std::vector<uint64_t> memory_;
+  SharedStatRegionPtr region_;
+  SharedStatRegionPtr other_region_;
+  SymbolTableImpl other_symbol_table_;
+  StatNamePool other_pool_;
+  Allocator other_alloc_;
+};
+
+TEST_F(SharedStatAllocatorTest, CountersShareValues) {
+  CounterSharedPtr c1 = alloc_.makeCounter(makeStat("counter.name"), StatName(), {});
+  c1->add(5);
+  EXPECT_EQ(5, c1->latch());
+
+  // The other process picks up the value, and the increments since the last latch.
+  c1->add(2);
+  CounterSharedPtr c2 = other_alloc_.makeCounter(other_pool_.add("counter.name"), StatName(), {});
+  EXPECT_TRUE(c2->used());
+  EXPECT_EQ(7, c2->value());
+  c2->inc();
+  c1->inc();
+  EXPECT_EQ(9, c1->value());
+  EXPECT_EQ(4, c2->latch());
+  EXPECT_EQ(0, c2->latch());
+
+  // Resetting a counter doesn't affect the other process.
+  c2->reset();
+  EXPECT_EQ(0, c2->value());
+  EXPECT_EQ(9, c1->value());
+  c2->inc();
+  EXPECT_EQ(1, c2->value());
+  EXPECT_EQ(10, c1->value());
+  EXPECT_EQ(1, region_->size());
+}
+
+TEST_F(SharedStatAllocatorTest, AccumulatedGaugesShareValues) {
+  GaugeSharedPtr g1 =
+      alloc_.makeGauge(makeStat("gauge.name"), StatName(), {}, Gauge::ImportMode::Accumulate);
+  g1->set(10);
+  {
+    GaugeSharedPtr g2 = other_alloc_.makeGauge(other_pool_.add("gauge.name"), StatName(), {},
+                                               Gauge::ImportMode::Accumulate);
+    EXPECT_EQ(10, g2->value());
+    g2->add(3);
+    g2->set(5);
+    g1->sub(2);
+    EXPECT_EQ(13, g1->value());
+    EXPECT_EQ(13, g2->value());
+  }
+  // The other process's contribution is withdrawn along with its gauge.
+  EXPECT_EQ(8, g1->value());
+
+  // Gauges that aren't transferred across hot restarts are not shared.
+  GaugeSharedPtr g3 =
+      alloc_.makeGauge(makeStat("never.import"), StatName(), {}, Gauge::ImportMode::NeverImport);
+  g3->set(1);
+  GaugeSharedPtr g4 = other_alloc_.makeGauge(other_pool_.add("never.import"), StatName(), {},
+                                             Gauge::ImportMode::NeverImport);
+  EXPECT_EQ(0, g4->value());
+  EXPECT_EQ(1, region_->size());
+}
+
+// The contribution of a parent which is terminated stops counting, even if its gauge outlives it.
+TEST_F(SharedStatAllocatorTest, RetiredParentGauge) {
+  GaugeSharedPtr g1 =
+      alloc_.makeGauge(makeStat("gauge.name"), StatName(), {}, Gauge::ImportMode::Accumulate);
+  g1->set(10);
+  GaugeSharedPtr g2 = other_alloc_.makeGauge(other_pool_.add("gauge.name"), StatName(), {},
+                                             Gauge::ImportMode::Accumulate);
+  g2->add(3);
+  EXPECT_EQ(13, g2->value());
+
+  other_region_->retireParentEpoch();
+  EXPECT_EQ(3, g2->value());
+  g1.reset();
+  EXPECT_EQ(3, g2->value());
+}
+
+TEST_F(SharedStatAllocatorTest, RegionFull) {
+  std::vector<CounterSharedPtr> counters;
+  for (uint32_t i = 0; i < region_->capacity(); ++i) {
+    counters.push_back(alloc_.makeCounter(makeStat(absl::StrCat("counter", i)), StatName(), {}));
+  }
+  CounterSharedPtr local;
+  EXPECT_LOG_CONTAINS("warn", "shared stat region of capacity 4 is full",
+                      local = alloc_.makeCounter(makeStat("local"), StatName(), {}));
+  local->inc();
+  CounterSharedPtr other = other_alloc_.makeCounter(other_pool_.add("local"), StatName(), {});
+  EXPECT_EQ(0, other->value());
+  EXPECT_EQ(1, local->value());
+}
+
 } // namespace
 } // namespace Stats
 } // namespace Envoy
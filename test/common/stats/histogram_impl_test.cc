@@ -1,10 +1,14 @@
+#include <limits>
+
 #include "envoy/config/metrics/v3/stats.pb.h"
 
 #include "source/common/stats/histogram_impl.h"
 
 #include "test/mocks/server/server_factory_context.h"
+#include "test/test_common/thread_factory_for_test.h"
 #include "test/test_common/utility.h"
 
+#include "absl/synchronization/notification.h"
 #include "gtest/gtest.h"
 
 namespace Envoy {
@@ -121,5 +125,83 @@ TEST_F(HistogramSettingsImplTest, ScaledPercent) {
   EXPECT_EQ(settings_->buckets("abcd"), ConstSupportedBuckets({0.1, 2}));
 }
 
+class AtomicLogLinearHistogramTest : public testing::Test {
+public:
+  AtomicLogLinearHistogramTest() : drained_(hist_alloc()), expected_(hist_alloc()) {}
+  ~AtomicLogLinearHistogramTest() override {
+    hist_free(drained_);
+    hist_free(expected_);
+  }
+
+  void record(uint64_t value) {
+    histogram_.recordValue(value);
+    hist_insert_intscale(expected_, value, 0, 1);
+  }
+
+  // Compares bucket by bucket, as the circllhist equality helpers also compare the allocated size.
+  void expectDrainedEqualsExpected() {
+    ASSERT_EQ(hist_num_buckets(expected_), hist_num_buckets(drained_));
+    for (int i = 0; i < hist_num_buckets(expected_); ++i) {
+      hist_bucket_t expected_bucket, drained_bucket;
+      uint64_t expected_count, drained_count;
+      hist_bucket_idx_bucket(expected_, i, &expected_bucket, &expected_count);
+      hist_bucket_idx_bucket(drained_, i, &drained_bucket, &drained_count);
+      EXPECT_EQ(expected_bucket.val, drained_bucket.val);
+      EXPECT_EQ(expected_bucket.exp, drained_bucket.exp);
+      EXPECT_EQ(expected_count, drained_count);
+    }
+  }
+
+  AtomicLogLinearHistogram histogram_;
+  histogram_t* drained_;
+  histogram_t* expected_;
+};
+
+// Values end up in the same buckets as with circllhist's own integer insertion.
+TEST_F(AtomicLogLinearHistogramTest, MatchesCircllhistBuckets) {
+  for (uint64_t value : {0UL, 1UL, 9UL, 10UL, 11UL, 99UL, 100UL, 101UL, 999UL, 1000UL, 12345UL,
+                         99999UL, 1000000UL, 123456789UL, 9999999999UL, 1UL << 40, 1UL << 62,
+                         9223372036854775807UL}) {
+    record(value);
+  }
+  for (uint64_t value = 0, step = 1; value < 1000000000; value += step, step = step * 3 / 2 + 1) {
+    record(value);
+  }
+  EXPECT_EQ(hist_sample_count(expected_), histogram_.drainTo(drained_));
+  expectDrainedEqualsExpected();
+
+  // Draining again moves nothing.
+  EXPECT_EQ(0, histogram_.drainTo(drained_));
+  expectDrainedEqualsExpected();
+}
+
+// Values that circllhist would record as negative are clamped to INT64_MAX.
+TEST_F(AtomicLogLinearHistogramTest, ClampsLargeValues) {
+  histogram_.recordValue(std::numeric_limits<uint64_t>::max());
+  hist_insert_intscale(expected_, std::numeric_limits<int64_t>::max(), 0, 1);
+  EXPECT_EQ(1, histogram_.drainTo(drained_));
+  expectDrainedEqualsExpected();
+}
+
+// Samples recorded while another thread drains are moved exactly once.
+TEST_F(AtomicLogLinearHistogramTest, ConcurrentRecordAndDrain) {
+  constexpr uint64_t NumSamples = 1000000;
+  absl::Notification done;
+  Thread::ThreadPtr writer = Thread::threadFactoryForTest().createThread([this, &done]() {
+    for (uint64_t i = 0; i < NumSamples; ++i) {
+      histogram_.recordValue(i % 5000);
+    }
+    done.Notify();
+  });
+  uint64_t drained = 0;
+  while (!done.HasBeenNotified()) {
+    drained += histogram_.drainTo(drained_);
+  }
+  writer->join();
+  drained += histogram_.drainTo(drained_);
+  EXPECT_EQ(NumSamples, drained);
+  EXPECT_EQ(NumSamples, hist_sample_count(drained_));
+}
+
 } // namespace Stats
 } // namespace Envoy
@@ -0,0 +1,132 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+//
+// Compares the time it takes a hot restart child to take over its parent's counters, when they are
+// copied from the parent by name and merged, and when they are shared in a SharedStatRegion.
+
+#include <string>
+#include <vector>
+
+#include "source/common/protobuf/protobuf.h"
+#include "source/common/stats/allocator.h"
+#include "source/common/stats/shared_stat_region.h"
+#include "source/common/stats/stat_merger.h"
+#include "source/common/stats/symbol_table.h"
+#include "source/common/stats/thread_local_store.h"
+
+#include "test/benchmark/main.h"
+
+#include "absl/strings/str_cat.h"
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Stats {
+
+class HotRestartStatsPerf {
+public:
+  HotRestartStatsPerf(uint64_t num_stats, bool shared)
+      : memory_(shared ? SharedStatRegion::bytesRequired(num_stats) / sizeof(uint64_t) : 0),
+        region_(shared ? SharedStatRegion::create(memory_.data(), num_stats, 0) : nullptr),
+        parent_pool_(parent_symbol_table_), parent_alloc_(parent_symbol_table_) {
+    parent_alloc_.setSharedStatRegion(region_.get());
+    for (uint64_t i = 0; i < num_stats; ++i) {
+      names_.push_back(absl::StrCat("cluster.cluster_", i / 100, ".stat_", i % 100));
+      parent_counters_.push_back(
+          parent_alloc_.makeCounter(parent_pool_.add(names_.back()), StatName(), {}));
+    }
+  }
+
+  // Counts on the parent's counters, as happens between the child's merges.
+  void countInParent() {
+    for (CounterSharedPtr& counter : parent_counters_) {
+      counter->inc();
+    }
+  }
+
+  // Copies the parent's counters to a child store, as HotRestartingParent and HotRestartingChild
+  // do over RPC.
+  void mergeIntoChild(Store& child_store) {
+    Protobuf::Map<std::string, uint64_t> counter_deltas;
+    parent_alloc_.forEachCounter(nullptr, [&counter_deltas](Counter& counter) {
+      const uint64_t delta = counter.latch();
+      if (delta > 0) {
+        counter_deltas[counter.name()] = delta;
+      }
+    });
+    StatMerger stat_merger(child_store);
+    stat_merger.mergeStats(counter_deltas, Protobuf::Map<std::string, uint64_t>());
+  }
+
+  // Creates the child's counters, which continue from the parent's values in the shared region.
+  void attachChild(StatNamePool& child_pool, Allocator& child_alloc,
+                   std::vector<CounterSharedPtr>& child_counters) {
+    child_alloc.setSharedStatRegion(region_.get());
+    for (const std::string& name : names_) {
+      child_counters.push_back(child_alloc.makeCounter(child_pool.add(name), StatName(), {}));
+    }
+  }
+
+private:
+  std::vector<uint64_t> memory_;
+  SharedStatRegionPtr region_;
+  std::vector<std::string> names_;
+  SymbolTableImpl parent_symbol_table_;
+  StatNamePool parent_pool_;
+  Allocator parent_alloc_;
+  std::vector<CounterSharedPtr> parent_counters_;
+};
+
+} // namespace Stats
+} // namespace Envoy
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_MergedHandoff(benchmark::State& state) {
+  if (Envoy::benchmark::skipExpensiveBenchmarks() && state.range(0) > 1000) {
+    state.SkipWithError("Skipping expensive benchmark");
+    return;
+  }
+  Envoy::Stats::HotRestartStatsPerf context(state.range(0), false);
+  for (auto _ : state) { // NOLINT
+    state.PauseTiming();
+    context.countInParent();
+    Envoy::Stats::SymbolTableImpl child_symbol_table;
+    Envoy::Stats::Allocator child_alloc(child_symbol_table);
+    auto child_store = std::make_unique<Envoy::Stats::ThreadLocalStoreImpl>(child_alloc);
+    state.ResumeTiming();
+
+    context.mergeIntoChild(*child_store);
+
+    state.PauseTiming();
+    child_store->shutdownThreading();
+    child_store.reset();
+    state.ResumeTiming();
+  }
+}
+BENCHMARK(BM_MergedHandoff)->Arg(1000)->Arg(1000000)->Unit(benchmark::kMillisecond);
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_SharedRegionHandoff(benchmark::State& state) {
+  if (Envoy::benchmark::skipExpensiveBenchmarks() && state.range(0) > 1000) {
+    state.SkipWithError("Skipping expensive benchmark");
+    return;
+  }
+  Envoy::Stats::HotRestartStatsPerf context(state.range(0), true);
+  for (auto _ : state) { // NOLINT
+    state.PauseTiming();
+    context.countInParent();
+    Envoy::Stats::SymbolTableImpl child_symbol_table;
+    auto child_pool = std::make_unique<Envoy::Stats::StatNamePool>(child_symbol_table);
+    auto child_alloc = std::make_unique<Envoy::Stats::Allocator>(child_symbol_table);
+    std::vector<Envoy::Stats::CounterSharedPtr> child_counters;
+    state.ResumeTiming();
+
+    context.attachChild(*child_pool, *child_alloc, child_counters);
+
+    state.PauseTiming();
+    child_counters.clear();
+    child_alloc.reset();
+    child_pool.reset();
+    state.ResumeTiming();
+  }
+}
+BENCHMARK(BM_SharedRegionHandoff)->Arg(1000)->Arg(1000000)->Unit(benchmark::kMillisecond);
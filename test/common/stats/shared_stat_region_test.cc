@@ -0,0 +1,155 @@
+#include <string>
+#include <vector>
+
+#include "source/common/stats/shared_stat_region.h"
+
+#include "test/test_common/thread_factory_for_test.h"
+
+#include "absl/strings/str_cat.h"
+#include "absl/synchronization/notification.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Stats {
+namespace {
+
+class SharedStatRegionTest : public testing::Test {
+protected:
+  SharedStatRegionPtr createRegion(uint64_t capacity) {
+    memory_.assign(SharedStatRegion::bytesRequired(capacity) / sizeof(uint64_t), 0);
+    return SharedStatRegion::create(memory_.data(), capacity, 0);
+  }
+
+  absl::StatusOr<SharedStatRegionPtr> attach(uint32_t epoch) {
+    return SharedStatRegion::attach(memory_.data(), memory_.size() * sizeof(uint64_t), epoch);
+  }
+
+  std::vector<uint64_t> memory_;
+};
+
+TEST_F(SharedStatRegionTest, CapacityIsRoundedUp) {
+  EXPECT_EQ(1024, createRegion(1000)->capacity());
+  EXPECT_EQ(1, createRegion(0)->capacity());
+}
+
+TEST_F(SharedStatRegionTest, FindOrAllocate) {
+  SharedStatRegionPtr region = createRegion(16);
+  SharedStatRegion::Slot* a = region->findOrAllocate("a");
+  ASSERT_NE(nullptr, a);
+  EXPECT_EQ(0, a->value_);
+  a->value_ = 5;
+  SharedStatRegion::Slot* b = region->findOrAllocate("b");
+  EXPECT_NE(a, b);
+  EXPECT_EQ(a, region->findOrAllocate("a"));
+  EXPECT_EQ(2, region->size());
+}
+
+// Another process attaching to the region sees the same slots.
+TEST_F(SharedStatRegionTest, Attach) {
+  SharedStatRegionPtr region = createRegion(16);
+  region->findOrAllocate("cluster.a.upstream_rq_total")->value_ = 42;
+
+  absl::StatusOr<SharedStatRegionPtr> attached = attach(1);
+  ASSERT_TRUE(attached.ok());
+  EXPECT_EQ(16, (*attached)->capacity());
+  EXPECT_EQ(1, (*attached)->size());
+  EXPECT_EQ(42, (*attached)->findOrAllocate("cluster.a.upstream_rq_total")->value_);
+}
+
+TEST_F(SharedStatRegionTest, AttachIncompatible) {
+  createRegion(16);
+  EXPECT_EQ("shared stat region of 8 bytes is too small",
+            SharedStatRegion::attach(memory_.data(), 8, 1).status().message());
+  EXPECT_EQ("shared stat region of 128 bytes does not fit a capacity of 16",
+            SharedStatRegion::attach(memory_.data(), 128, 1).status().message());
+
+  std::vector<uint64_t> zeroes(memory_.size());
+  EXPECT_EQ("shared stat region has an incompatible layout",
+            SharedStatRegion::attach(zeroes.data(), zeroes.size() * sizeof(uint64_t), 1)
+                .status()
+                .message());
+}
+
+TEST_F(SharedStatRegionTest, Full) {
+  SharedStatRegionPtr region = createRegion(4);
+  for (int i = 0; i < 4; ++i) {
+    EXPECT_NE(nullptr, region->findOrAllocate(absl::StrCat("stat", i)));
+  }
+  EXPECT_EQ(nullptr, region->findOrAllocate("one.too.many"));
+  EXPECT_NE(nullptr, region->findOrAllocate("stat3"));
+}
+
+TEST_F(SharedStatRegionTest, NameArenaFull) {
+  SharedStatRegionPtr region = createRegion(2);
+  const std::string long_name(SharedStatRegion::NameBytesPerSlot * 2, 'x');
+  EXPECT_NE(nullptr, region->findOrAllocate(long_name));
+  EXPECT_EQ(nullptr, region->findOrAllocate("y"));
+}
+
+// Each epoch contributes to a gauge separately. The contribution of a parent which is terminated
+// without withdrawing it, e.g. because it crashed, stops counting when it is retired or when its
+// epoch's successor attaches.
+TEST_F(SharedStatRegionTest, GaugeContributionsPerEpoch) {
+  SharedStatRegionPtr epoch0 = createRegion(16);
+  SharedStatRegion::Slot* slot = epoch0->findOrAllocate("gauge");
+  epoch0->gaugeContribution(*slot) += 5;
+
+  SharedStatRegionPtr epoch1 = attach(1).value();
+  epoch1->gaugeContribution(*slot) += 3;
+  EXPECT_EQ(8, epoch0->gaugeValue(*slot));
+  EXPECT_EQ(8, epoch1->gaugeValue(*slot));
+
+  epoch1->retireParentEpoch();
+  EXPECT_EQ(3, epoch1->gaugeValue(*slot));
+
+  // The next epoch replaces the contribution its grandparent left.
+  SharedStatRegionPtr epoch2 = attach(2).value();
+  EXPECT_EQ(0, epoch2->gaugeContribution(*slot));
+  epoch2->gaugeContribution(*slot) += 1;
+  EXPECT_EQ(4, epoch2->gaugeValue(*slot));
+
+  // Retiring a parent whose parity is taken by a child keeps the child's contributions.
+  epoch1->retireParentEpoch();
+  epoch0->retireParentEpoch();
+  EXPECT_EQ(4, epoch2->gaugeValue(*slot));
+}
+
+TEST_F(SharedStatRegionTest, GaugeContributionsWithoutRetire) {
+  SharedStatRegionPtr epoch0 = createRegion(16);
+  SharedStatRegion::Slot* slot = epoch0->findOrAllocate("gauge");
+  epoch0->gaugeContribution(*slot) += 5;
+
+  // The parent exits without withdrawing its contribution, and without being retired.
+  ASSERT_TRUE(attach(1).ok());
+  SharedStatRegionPtr epoch2 = attach(2).value();
+  EXPECT_EQ(0, epoch2->gaugeValue(*slot));
+}
+
+// Threads racing to add the same names settle on one slot per name.
+TEST_F(SharedStatRegionTest, ConcurrentAllocation) {
+  SharedStatRegionPtr region = createRegion(1024);
+  const uint32_t num_threads = 8;
+  const uint32_t num_names = 1000;
+  std::vector<Thread::ThreadPtr> threads;
+  absl::Notification go;
+  for (uint32_t i = 0; i < num_threads; ++i) {
+    threads.push_back(Thread::threadFactoryForTest().createThread([&]() {
+      go.WaitForNotification();
+      for (uint32_t j = 0; j < num_names; ++j) {
+        ++region->findOrAllocate(absl::StrCat("stat", j))->value_;
+      }
+    }));
+  }
+  go.Notify();
+  for (auto& thread : threads) {
+    thread->join();
+  }
+  EXPECT_EQ(num_names, region->size());
+  for (uint32_t j = 0; j < num_names; ++j) {
+    EXPECT_EQ(num_threads, region->findOrAllocate(absl::StrCat("stat", j))->value_);
+  }
+}
+
+} // namespace
+} // namespace Stats
+} // namespace Envoy
@@ -232,7 +232,6 @@ TEST_F(StatNameTest, TestSuccessfulDecode) {
 class StatNameDeathTest : public StatNameTest {
 public:
   void decodeSymbolVec(const SymbolVec& symbol_vec) {
-    Thread::LockGuard lock(table_.lock_);
     for (Symbol symbol : symbol_vec) {
       table_.fromSymbol(symbol);
     }
@@ -532,20 +531,10 @@ TEST_F(StatNameTest, RacingSymbolCreation) {
   access.setReady();
   accesses.Wait();
 
-  // In a perfect world, we could use reader-locks in the SymbolTable
-  // implementation, and there should be zero additional contentions
-  // after latching 'create_contentions' above. And we can definitely
-  // have this world, but this slows down BM_CreateRace in
-  // symbol_table_speed_test.cc, even on a 72-core machine.
-  //
-  // Thus it is better to avoid symbol-table contention by refactoring
-  // all stat-creation code to symbolize all stat string elements at
-  // construction, as composition does not require a lock.
-  //
-  // See this commit
-  // https://github.com/envoyproxy/envoy/pull/5321/commits/ef712d0f5a11ff49831c1935e8a2ef8a0a935bc9
-  // for a working reader-lock implementation, which would pass this EXPECT:
-  //     EXPECT_EQ(create_contentions, mutex_tracer.numContentions());
+  // Tokens that are already in the table are looked up with a shared lock,
+  // so these accesses should not contend with each other. We don't
+  // EXPECT_EQ(create_contentions, mutex_tracer.numContentions()) though, as
+  // threads still finishing their creations may hold the lock exclusively.
   //
   // Note also that we cannot guarantee there *will* be contentions
   // as a machine or OS is free to run all threads serially.
@@ -624,6 +613,39 @@ TEST_F(StatNameTest, MutexContentionOnExistingSymbols) {
   }
 }
 
+// Decodes and compares names held by the test while other threads add and
+// remove symbols, which re-uses freed symbols and grows the decode table.
+TEST_F(StatNameTest, DecodeWhileAddingAndFreeingSymbols) {
+  Thread::ThreadFactory& thread_factory = Thread::threadFactoryForTest();
+  StatNameManagedStorage held_a("held.name.a", table_);
+  StatNameManagedStorage held_b("held.name.b", table_);
+
+  constexpr int num_threads = 8;
+  constexpr int num_iterations = 2000;
+  std::vector<Thread::ThreadPtr> threads;
+  threads.reserve(num_threads);
+  ConditionalInitializer start;
+  for (int i = 0; i < num_threads; ++i) {
+    threads.push_back(thread_factory.createThread([this, i, &start, &held_a, &held_b]() {
+      start.wait();
+      for (int j = 0; j < num_iterations; ++j) {
+        if (i % 2 == 0) {
+          StatNameManagedStorage transient(absl::StrCat("held.thread", i, ".", j), table_);
+          EXPECT_EQ(absl::StrCat("held.thread", i, ".", j), table_.toString(transient.statName()));
+        } else {
+          EXPECT_EQ("held.name.a", table_.toString(held_a.statName()));
+          EXPECT_TRUE(table_.lessThan(held_a.statName(), held_b.statName()));
+        }
+      }
+    }));
+  }
+  start.setReady();
+  for (auto& thread : threads) {
+    thread->join();
+  }
+  EXPECT_EQ(4, table_.numSymbols());
+}
+
 TEST_F(StatNameTest, SharedStatNameStorageSetInsertAndFind) {
   StatNameStorageSet set;
   const int iters = 10;
@@ -121,6 +121,63 @@ static std::vector<Envoy::Stats::StatName> prepareNames(Envoy::Stats::StatNamePo
   return names;
 }
 
+// The multi-threaded benchmarks below share a symbol table and a set of names
+// between benchmark threads. They are leaked, as the table expects all names to
+// be freed before it is destroyed.
+struct SharedNames {
+  SharedNames() : pool_(table_) { names_ = prepareNames(pool_, 64); }
+
+  Envoy::Stats::SymbolTableImpl table_;
+  Envoy::Stats::StatNamePool pool_;
+  std::vector<Envoy::Stats::StatName> names_;
+};
+
+static SharedNames& sharedNames() { MUTABLE_CONSTRUCT_ON_FIRST_USE(SharedNames); }
+
+// Encodes names whose tokens are all in the table, as done when looking up
+// existing stats by name.
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void bmEncodeExistingThreaded(benchmark::State& state) {
+  SharedNames& shared = sharedNames();
+  const std::string name = shared.table_.toString(shared.names_[state.thread_index()]);
+  for (auto _ : state) {
+    UNREFERENCED_PARAMETER(_);
+    Envoy::Stats::StatNameStorage storage(name, shared.table_);
+    storage.free(shared.table_);
+  }
+}
+BENCHMARK(bmEncodeExistingThreaded)->ThreadRange(1, 16)->UseRealTime();
+
+// Encodes names with one token that is new to the table, such as per-cluster
+// stats created while clusters are added.
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void bmEncodeNewThreaded(benchmark::State& state) {
+  SharedNames& shared = sharedNames();
+  uint64_t count = 0;
+  for (auto _ : state) {
+    UNREFERENCED_PARAMETER(_);
+    Envoy::Stats::StatNameStorage storage(
+        absl::StrCat("cluster.c", state.thread_index(), "_", ++count, ".upstream_rq_total"),
+        shared.table_);
+    storage.free(shared.table_);
+  }
+}
+BENCHMARK(bmEncodeNewThreaded)->ThreadRange(1, 16)->UseRealTime();
+
+// Decodes names, as done by admin endpoints and stats sinks while workers
+// create stats.
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void bmDecodeThreaded(benchmark::State& state) {
+  SharedNames& shared = sharedNames();
+  uint32_t index = state.thread_index();
+  for (auto _ : state) {
+    UNREFERENCED_PARAMETER(_);
+    benchmark::DoNotOptimize(shared.table_.toString(shared.names_[index]));
+    index = (index + 1) % shared.names_.size();
+  }
+}
+BENCHMARK(bmDecodeThreaded)->ThreadRange(1, 16)->UseRealTime();
+
 // NOLINTNEXTLINE(readability-identifier-naming)
 static void bmCompareElements(benchmark::State& state) {
   Envoy::Stats::SymbolTableImpl symbol_table;
@@ -393,6 +393,20 @@ TEST(TagExtractorTest, DefaultTagExtractors) {
                          "http.fault.aborts_injected",
                          {fault_connection_manager, fault_downstream_cluster});
 
+  // HTTP filter instrumentation
+  Tag instrumented_connection_manager;
+  instrumented_connection_manager.name_ = tag_names.HTTP_CONN_MANAGER_PREFIX;
+  instrumented_connection_manager.value_ = "ingress";
+
+  Tag http_filter_name;
+  http_filter_name.name_ = tag_names.HTTP_FILTER_NAME;
+  http_filter_name.value_ = "envoy.filters.http.router";
+
+  regex_tester.testRegex(
+      "http.ingress.filter_instrumentation.envoy.filters.http.router.decode_headers.cpu_time_us",
+      "http.filter_instrumentation.decode_headers.cpu_time_us",
+      {instrumented_connection_manager, http_filter_name});
+
   // HTTP Connection Manager and Route
   Tag rds_hcm;
   rds_hcm.name_ = tag_names.HTTP_CONN_MANAGER_PREFIX;
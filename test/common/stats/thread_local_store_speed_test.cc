@@ -13,12 +13,14 @@
 #include "source/common/stats/thread_local_store.h"
 #include "source/common/thread_local/thread_local_impl.h"
 
+#include "test/benchmark/main.h"
 #include "test/common/stats/stat_test_utility.h"
 #include "test/mocks/server/server_factory_context.h"
 #include "test/test_common/simulated_time_system.h"
 #include "test/test_common/test_time.h"
 #include "test/test_common/utility.h"
 
+#include "absl/strings/str_cat.h"
 #include "benchmark/benchmark.h"
 
 namespace Envoy {
@@ -56,6 +58,18 @@ public:
     }
   }
 
+  void createHistograms(uint64_t count) {
+    Stats::Scope& scope = *store_.rootScope();
+    histograms_.reserve(count);
+    for (uint64_t i = 0; i < count; ++i) {
+      histograms_.push_back(&scope.histogramFromString(absl::StrCat("cluster.c", i, ".rq_time"),
+                                                       Stats::Histogram::Unit::Milliseconds));
+    }
+  }
+
+  std::vector<Stats::Histogram*>& histograms() { return histograms_; }
+  void mergeHistograms() { store_.mergeHistograms([]() {}); }
+
   void initThreading() {
     if (!Envoy::Event::Libevent::Global::initialized()) {
       Envoy::Event::Libevent::Global::initialize();
@@ -84,6 +98,7 @@ private:
   Api::ApiPtr api_;
   envoy::config::metrics::v3::StatsConfig stats_config_;
   std::vector<std::unique_ptr<Stats::StatNameManagedStorage>> stat_names_;
+  std::vector<Stats::Histogram*> histograms_;
 };
 
 } // namespace Envoy
@@ -138,5 +153,59 @@ static void BM_StatsWithTlsAndRejectionsWithoutDot(benchmark::State& state) {
 }
 BENCHMARK(BM_StatsWithTlsAndRejectionsWithoutDot);
 
+// Measures the cost of recording a histogram value from the thread that owns the thread local
+// histogram, which is the hot path for request latencies.
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_HistogramRecordValue(benchmark::State& state) {
+  Envoy::ThreadLocalStorePerf context;
+  context.initThreading();
+  context.createHistograms(1);
+  Envoy::Stats::Histogram& histogram = *context.histograms()[0];
+
+  uint64_t value = 0;
+  for (auto _ : state) { // NOLINT
+    histogram.recordValue(value);
+    value = (value + 7919) % 100000;
+  }
+}
+BENCHMARK(BM_HistogramRecordValue);
+
+// Measures the latency of merging all histograms on the main thread during a stats flush, with
+// state.range(0) histograms of which state.range(1) recorded a sample since the previous merge.
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_HistogramMerge(benchmark::State& state) {
+  if (Envoy::benchmark::skipExpensiveBenchmarks() && state.range(0) > 1000) {
+    state.SkipWithError("Skipping expensive benchmark");
+    return;
+  }
+  Envoy::ThreadLocalStorePerf context;
+  context.initThreading();
+  context.createHistograms(state.range(0));
+  std::vector<Envoy::Stats::Histogram*>& histograms = context.histograms();
+  // Creates the thread local histograms, and marks them as used.
+  for (Envoy::Stats::Histogram* histogram : histograms) {
+    histogram->recordValue(1);
+  }
+  context.mergeHistograms();
+
+  const uint64_t active = state.range(1);
+  uint64_t next = 0;
+  for (auto _ : state) { // NOLINT
+    state.PauseTiming();
+    for (uint64_t i = 0; i < active; ++i) {
+      histograms[next]->recordValue(next % 1000);
+      next = (next + 1) % histograms.size();
+    }
+    state.ResumeTiming();
+    context.mergeHistograms();
+  }
+}
+BENCHMARK(BM_HistogramMerge)
+    ->Args({1000, 10})
+    ->Args({100000, 0})
+    ->Args({100000, 1000})
+    ->Args({100000, 100000})
+    ->Unit(benchmark::kMillisecond);
+
 // TODO(jmarantz): add multi-threaded variant of this test, that aggressively
 // looks up stats in multiple threads to try to trigger contention issues.
@@ -454,6 +454,33 @@ TEST_F(StatsThreadLocalStoreTest, BasicScope) {
   tls_.shutdownThread();
 }
 
+// Threads that are not registered with thread local storage look stats up in the central cache.
+TEST_F(StatsThreadLocalStoreTest, UnregisteredThreadLookup) {
+  InSequence s;
+  store_->initializeThreading(main_thread_dispatcher_, tls_);
+
+  Counter& c1 = scope_.counterFromString("c1");
+  Gauge& g1 = scope_.gaugeFromString("g1", Gauge::ImportMode::Accumulate);
+  Histogram& h1 = scope_.histogramFromString("h1", Histogram::Unit::Unspecified);
+  TextReadout& t1 = scope_.textReadoutFromString("t1");
+
+  tls_.registered_ = false;
+  EXPECT_EQ(&c1, &scope_.counterFromString("c1"));
+  EXPECT_EQ(&g1, &scope_.gaugeFromString("g1", Gauge::ImportMode::Accumulate));
+  EXPECT_EQ(&h1, &scope_.histogramFromString("h1", Histogram::Unit::Unspecified));
+  EXPECT_EQ(&t1, &scope_.textReadoutFromString("t1"));
+  Counter& c2 = scope_.counterFromString("c2");
+  EXPECT_EQ("c2", c2.name());
+
+  tls_.registered_ = true;
+  EXPECT_EQ(&c2, &scope_.counterFromString("c2"));
+  EXPECT_EQ(2UL, store_->counters().size());
+
+  tls_.shutdownGlobalThreading();
+  store_->shutdownThreading();
+  tls_.shutdownThread();
+}
+
 TEST_F(StatsThreadLocalStoreTest, HistogramScopeOverlap) {
   InSequence s;
   store_->initializeThreading(main_thread_dispatcher_, tls_);
@@ -2096,6 +2123,13 @@ TEST_F(HistogramTest, MultiHistogramMultipleMerges) {
   // Do not insert any value and validate that intervalSummary is empty for both the histograms and
   // cumulativeSummary has right values.
   EXPECT_EQ(2, validateMerge());
+
+  // Idle histograms skip recomputing their statistics, which must still be the same.
+  EXPECT_EQ(2, validateMerge());
+
+  // And recording again after being idle is merged properly.
+  expectCallAndAccumulate(h1, 4);
+  EXPECT_EQ(2, validateMerge());
 }
 
 TEST_F(HistogramTest, BasicScopeHistogramMerge) {
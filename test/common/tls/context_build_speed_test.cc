@@ -0,0 +1,105 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+//
+// Measures how long it takes for the TLS contexts of N listeners to become ready at startup, when
+// they are built serially on the main thread (--startup-concurrency 0) and when their builds are
+// deferred and run on a pool of startup threads.
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/extensions/transport_sockets/tls/v3/cert.pb.h"
+
+#include "source/common/stats/allocator.h"
+#include "source/common/stats/symbol_table.h"
+#include "source/common/stats/thread_local_store.h"
+#include "source/common/tls/context_manager_impl.h"
+#include "source/common/tls/server_context_config_impl.h"
+#include "source/common/tls/server_ssl_socket.h"
+
+#include "test/benchmark/main.h"
+#include "test/mocks/server/server_factory_context.h"
+#include "test/test_common/environment.h"
+#include "test/test_common/thread_factory_for_test.h"
+#include "test/test_common/utility.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+
+using testing::NiceMock;
+using testing::ReturnRef;
+
+class ContextBuildPerf {
+public:
+  ContextBuildPerf() : store_(alloc_), api_(Api::createApiForTest()) {
+    ON_CALL(factory_context_.server_context_, api()).WillByDefault(ReturnRef(*api_));
+    ON_CALL(server_factory_context_.api_, threadFactory())
+        .WillByDefault(ReturnRef(Thread::threadFactoryForTest()));
+    const std::string tls_context_yaml = R"EOF(
+  common_tls_context:
+    tls_certificates:
+      certificate_chain:
+        filename: "{{ test_rundir }}/test/common/tls/test_data/unittest_cert.pem"
+      private_key:
+        filename: "{{ test_rundir }}/test/common/tls/test_data/unittest_key.pem"
+  )EOF";
+    TestUtility::loadFromYaml(TestEnvironment::substitute(tls_context_yaml), tls_context_);
+  }
+
+  ~ContextBuildPerf() { store_.shutdownThreading(); }
+
+  // Creates the socket factories of num_contexts listeners and waits for their contexts to be
+  // built, as the server does while loading its static configuration.
+  void buildContexts(uint32_t num_contexts, uint32_t startup_concurrency) {
+    manager_.deferContextBuilds(startup_concurrency);
+    for (uint32_t i = 0; i < num_contexts; ++i) {
+      socket_factories_.push_back(*ServerSslSocketFactory::create(
+          *ServerContextConfigImpl::create(tls_context_, factory_context_, {}, false), manager_,
+          *store_.rootScope()));
+    }
+    THROW_IF_NOT_OK(manager_.buildDeferredContexts());
+    manager_.deferContextBuilds(0);
+  }
+
+  void clear() { socket_factories_.clear(); }
+
+private:
+  Stats::SymbolTableImpl symbol_table_;
+  Stats::Allocator alloc_{symbol_table_};
+  Stats::ThreadLocalStoreImpl store_;
+  Api::ApiPtr api_;
+  NiceMock<Server::Configuration::MockTransportSocketFactoryContext> factory_context_;
+  NiceMock<Server::Configuration::MockServerFactoryContext> server_factory_context_;
+  ContextManagerImpl manager_{server_factory_context_};
+  envoy::extensions::transport_sockets::tls::v3::DownstreamTlsContext tls_context_;
+  std::vector<std::unique_ptr<ServerSslSocketFactory>> socket_factories_;
+};
+
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_BuildListenerContexts(benchmark::State& state) {
+  if (Envoy::benchmark::skipExpensiveBenchmarks() && state.range(0) > 100) {
+    state.SkipWithError("Skipping expensive benchmark");
+    return;
+  }
+  Envoy::Extensions::TransportSockets::Tls::ContextBuildPerf context;
+  for (auto _ : state) { // NOLINT
+    context.buildContexts(state.range(0), state.range(1));
+
+    state.PauseTiming();
+    context.clear();
+    state.ResumeTiming();
+  }
+}
+BENCHMARK(BM_BuildListenerContexts)
+    ->ArgsProduct({{100, 1000}, {0, 2, 8}})
+    ->Unit(benchmark::kMillisecond);
@@ -12,6 +12,7 @@
 #include "source/common/secret/sds_api.h"
 #include "source/common/ssl/ssl.h"
 #include "source/common/stats/isolated_store_impl.h"
+#include "source/common/stats/thread_local_store.h"
 #include "source/common/tls/context_config_impl.h"
 #include "source/common/tls/context_impl.h"
 #include "source/common/tls/server_context_config_impl.h"
@@ -32,6 +33,7 @@
 #include "test/test_common/environment.h"
 #include "test/test_common/simulated_time_system.h"
 #include "test/test_common/test_runtime.h"
+#include "test/test_common/thread_factory_for_test.h"
 #include "test/test_common/utility.h"
 
 #include "gtest/gtest.h"
@@ -693,6 +695,81 @@ TEST_F(SslContextImplTest, MustHaveSubjectOrSAN) {
             "Invalid TLS context has neither subject CN nor SAN names");
 }
 
+// While builds are deferred, socket factories are handed their contexts by
+// buildDeferredContexts(), which builds them on several threads.
+TEST_F(SslContextImplTest, DeferredContextBuilds) {
+  ON_CALL(server_factory_context_.api_, threadFactory())
+      .WillByDefault(ReturnRef(Thread::threadFactoryForTest()));
+  // Contexts create their stats on the build threads, which needs a thread safe store.
+  Stats::SymbolTableImpl symbol_table;
+  Stats::Allocator alloc(symbol_table);
+  Stats::ThreadLocalStoreImpl store(alloc);
+
+  envoy::extensions::transport_sockets::tls::v3::DownstreamTlsContext tls_context;
+  const std::string tls_context_yaml = R"EOF(
+  common_tls_context:
+    tls_certificates:
+      certificate_chain:
+        filename: "{{ test_rundir }}/test/common/tls/test_data/unittest_cert.pem"
+      private_key:
+        filename: "{{ test_rundir }}/test/common/tls/test_data/unittest_key.pem"
+  )EOF";
+  TestUtility::loadFromYaml(TestEnvironment::substitute(tls_context_yaml), tls_context);
+  auto create_socket_factory = [&]() {
+    return *ServerSslSocketFactory::create(
+        *ServerContextConfigImpl::create(tls_context, factory_context_, {}, false), manager_,
+        *store.rootScope());
+  };
+  auto count_contexts = [this]() {
+    uint32_t count = 0;
+    manager_.iterateContexts([&count](const Envoy::Ssl::Context&) { ++count; });
+    return count;
+  };
+
+  manager_.deferContextBuilds(4);
+  std::vector<std::unique_ptr<ServerSslSocketFactory>> socket_factories;
+  for (int i = 0; i < 8; ++i) {
+    socket_factories.push_back(create_socket_factory());
+  }
+  // Destroying a factory cancels its build.
+  socket_factories.pop_back();
+  EXPECT_EQ(0, count_contexts());
+  EXPECT_NE(nullptr, dynamic_cast<NotReadySslSocket*>(
+                         socket_factories[0]->createDownstreamTransportSocket().get()));
+
+  ASSERT_TRUE(manager_.buildDeferredContexts().ok());
+  EXPECT_EQ(7, count_contexts());
+  for (const auto& socket_factory : socket_factories) {
+    Network::TransportSocketPtr socket = socket_factory->createDownstreamTransportSocket();
+    EXPECT_NE(nullptr, extractSslCtx(socket.get()));
+  }
+
+  manager_.deferContextBuilds(0);
+  socket_factories.push_back(create_socket_factory());
+  EXPECT_EQ(8, count_contexts());
+}
+
+TEST_F(SslContextImplTest, DeferredContextBuildError) {
+  envoy::extensions::transport_sockets::tls::v3::DownstreamTlsContext tls_context;
+  const std::string tls_context_yaml = R"EOF(
+  common_tls_context:
+    tls_certificates:
+    - certificate_chain:
+        filename: "{{ test_rundir }}/test/common/tls/test_data/no_subject_cert.pem"
+      private_key:
+        filename: "{{ test_rundir }}/test/common/tls/test_data/no_subject_key.pem"
+  )EOF";
+  TestUtility::loadFromYaml(TestEnvironment::substitute(tls_context_yaml), tls_context);
+
+  manager_.deferContextBuilds(2);
+  auto socket_factory_or_error = ServerSslSocketFactory::create(
+      *ServerContextConfigImpl::create(tls_context, factory_context_, {}, false), manager_,
+      *store_.rootScope());
+  ASSERT_TRUE(socket_factory_or_error.ok());
+  EXPECT_EQ(manager_.buildDeferredContexts().message(),
+            "Invalid TLS context has neither subject CN nor SAN names");
+}
+
 class SslServerContextImplOcspTest : public SslContextImplTest {
 public:
   Envoy::Ssl::ServerContextSharedPtr loadConfig(ServerContextConfigImpl& cfg) {
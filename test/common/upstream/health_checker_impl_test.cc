@@ -3,6 +3,7 @@
 #include <ostream>
 #include <string>
 
+#include "envoy/common/platform.h"
 #include "envoy/config/core/v3/base.pb.h"
 #include "envoy/config/core/v3/health_check.pb.h"
 #include "envoy/config/core/v3/health_check.pb.validate.h"
@@ -14,6 +15,7 @@
 #include "source/common/buffer/buffer_impl.h"
 #include "source/common/buffer/zero_copy_input_stream_impl.h"
 #include "source/common/common/base64.h"
+#include "source/common/common/hash.h"
 #include "source/common/grpc/common.h"
 #include "source/common/http/headers.h"
 #include "source/common/json/json_loader.h"
@@ -21,6 +23,7 @@
 #include "source/common/protobuf/utility.h"
 #include "source/common/upstream/health_checker_impl.h"
 #include "source/common/upstream/upstream_impl.h"
+#include "source/extensions/health_checkers/common/shared_health_check_results.h"
 #include "source/extensions/health_checkers/grpc/health_checker_impl.h"
 #include "source/extensions/health_checkers/http/health_checker_impl.h"
 #include "source/extensions/health_checkers/tcp/health_checker_impl.h"
@@ -40,6 +43,7 @@
 #include "test/mocks/upstream/health_check_event_logger.h"
 #include "test/mocks/upstream/host_set.h"
 #include "test/mocks/upstream/transport_socket_match.h"
+#include "test/test_common/environment.h"
 #include "test/test_common/printers.h"
 #include "test/test_common/simulated_time_system.h"
 #include "test/test_common/test_runtime.h"
@@ -4886,6 +4890,179 @@ TEST_F(TcpHealthCheckerImplTest, SuccessProxyProtocol) {
   read_filter_->onData(response, false);
 }
 
+#ifndef WIN32
+class TcpHealthCheckerSharedResultsTest : public TcpHealthCheckerImplTest {
+public:
+  ~TcpHealthCheckerSharedResultsTest() override {
+    if (peer_memory_ != nullptr) {
+      ::munmap(peer_memory_, peer_size_);
+    }
+  }
+
+  void setupSharedResults() {
+    path_ = TestEnvironment::temporaryPath(TestUtility::uniqueFilename("shared_hc_results"));
+    config_ = parseHealthCheckFromV3Yaml(fmt::format(R"EOF(
+    timeout: 1s
+    interval: 1s
+    unhealthy_threshold: 2
+    healthy_threshold: 2
+    tcp_health_check:
+      send:
+        text: "01"
+      receive:
+      - text: "02"
+    shared_results:
+      path: {}
+      max_hosts: 16
+      lease_duration: 3s
+    )EOF",
+                                                     path_));
+    health_checker_ = std::make_shared<TcpHealthCheckerImpl>(
+        *cluster_, config_, dispatcher_, runtime_, random_,
+        HealthCheckEventLoggerPtr(event_logger_storage_.release()));
+    cluster_->prioritySet().getMockHostSet(0)->hosts_ = {
+        makeTestHost(cluster_->info_, "tcp://127.0.0.1:80")};
+  }
+
+  // Maps the file of the health checker's shared results a second time, as another process would.
+  void attachPeer() {
+    const int fd = ::open(path_.c_str(), O_RDWR);
+    RELEASE_ASSERT(fd != -1, "");
+    struct stat stat_buf;
+    RELEASE_ASSERT(::fstat(fd, &stat_buf) == 0, "");
+    peer_size_ = stat_buf.st_size;
+    peer_memory_ = ::mmap(nullptr, peer_size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    RELEASE_ASSERT(peer_memory_ != MAP_FAILED, "");
+    peer_ =
+        std::move(SharedHealthCheckResults::initialize(peer_memory_, peer_size_, 16).value());
+  }
+
+  uint64_t seed() const {
+    return HashUtil::xxHash64(cluster_->info_->name(), MessageUtil::hash(config_));
+  }
+  uint64_t hostKey() const { return HashUtil::xxHash64("127.0.0.1:80", seed()); }
+  uint64_t leaseKey() const { return HashUtil::xxHash64("lease", seed()); }
+
+  std::string path_;
+  envoy::config::core::v3::HealthCheck config_;
+  void* peer_memory_{};
+  uint64_t peer_size_{};
+  std::unique_ptr<SharedHealthCheckResults> peer_;
+};
+
+// The process holding the lease probes the hosts, and publishes the results.
+TEST_F(TcpHealthCheckerSharedResultsTest, ProberPublishesResults) {
+  InSequence s;
+
+  setupSharedResults();
+  attachPeer();
+  expectSessionCreate();
+  expectClientCreate();
+  EXPECT_CALL(*connection_, write(_, _));
+  EXPECT_CALL(*timeout_timer_, enableTimer(_, _));
+  health_checker_->start();
+  EXPECT_FALSE(peer_->holdLease(leaseKey(), simTime().systemTime(), std::chrono::seconds(3)));
+
+  connection_->raiseEvent(Network::ConnectionEvent::Connected);
+  EXPECT_CALL(*timeout_timer_, disableTimer());
+  EXPECT_CALL(*interval_timer_, enableTimer(_, _));
+  Buffer::OwnedImpl response;
+  addUint8(response, 2);
+  read_filter_->onData(response, false);
+
+  absl::optional<SharedHealthCheckResults::Result> result = peer_->find(hostKey());
+  ASSERT_TRUE(result.has_value());
+  EXPECT_EQ(SharedHealthCheckResults::Outcome::Healthy, result->outcome_);
+  EXPECT_EQ(1, result->sequence_);
+  EXPECT_EQ(1UL, cluster_->info_->stats_store_.counter("health_check.attempt").value());
+  EXPECT_EQ(0UL, cluster_->info_->stats_store_.counter("health_check.shared_result").value());
+}
+
+// While another process holds the lease, the hosts are not probed, and the results published by
+// that process are applied instead. The lease is taken over once it is no longer renewed.
+TEST_F(TcpHealthCheckerSharedResultsTest, FollowerAppliesSharedResults) {
+  InSequence s;
+
+  setupSharedResults();
+  attachPeer();
+  EXPECT_TRUE(peer_->holdLease(leaseKey(), simTime().systemTime(), std::chrono::seconds(3)));
+  expectSessionCreate();
+  EXPECT_CALL(dispatcher_, createClientConnection_(_, _, _, _)).Times(0);
+  EXPECT_CALL(*interval_timer_, enableTimer(_, _));
+  health_checker_->start();
+
+  EXPECT_TRUE(peer_->publish(hostKey(), SharedHealthCheckResults::Outcome::Unhealthy,
+                             envoy::data::core::v3::ACTIVE, false));
+  EXPECT_CALL(event_logger_, logEjectUnhealthy(_, _, envoy::data::core::v3::ACTIVE));
+  EXPECT_CALL(event_logger_, logUnhealthy(_, _, envoy::data::core::v3::ACTIVE, true));
+  EXPECT_CALL(*timeout_timer_, disableTimer());
+  EXPECT_CALL(*interval_timer_, enableTimer(_, _));
+  interval_timer_->invokeCallback();
+  EXPECT_TRUE(cluster_->prioritySet().getMockHostSet(0)->hosts_[0]->healthFlagGet(
+      Host::HealthFlag::FAILED_ACTIVE_HC));
+
+  // A result is applied once.
+  EXPECT_CALL(*interval_timer_, enableTimer(_, _));
+  interval_timer_->invokeCallback();
+  EXPECT_EQ(1UL, cluster_->info_->stats_store_.counter("health_check.shared_result").value());
+  EXPECT_EQ(0UL, cluster_->info_->stats_store_.counter("health_check.attempt").value());
+
+  // Applying the peer's result does not publish it again.
+  EXPECT_EQ(1, peer_->find(hostKey())->sequence_);
+
+  simTime().advanceTimeWait(std::chrono::seconds(3));
+  expectClientCreate();
+  EXPECT_CALL(*connection_, write(_, _));
+  EXPECT_CALL(*timeout_timer_, enableTimer(_, _));
+  interval_timer_->invokeCallback();
+  EXPECT_FALSE(peer_->holdLease(leaseKey(), simTime().systemTime(), std::chrono::seconds(3)));
+  EXPECT_EQ(1UL, cluster_->info_->stats_store_.counter("health_check.attempt").value());
+}
+
+// A host the process holding the lease publishes no results for, e.g. because it does not know the
+// host yet, is probed locally once no result has arrived for the lease plus an interval.
+TEST_F(TcpHealthCheckerSharedResultsTest, FollowerProbesWithoutSharedResults) {
+  InSequence s;
+
+  setupSharedResults();
+  attachPeer();
+  EXPECT_TRUE(peer_->holdLease(leaseKey(), simTime().systemTime(), std::chrono::seconds(3)));
+  expectSessionCreate();
+  EXPECT_CALL(*interval_timer_, enableTimer(_, _));
+  health_checker_->start();
+
+  simTime().advanceTimeWait(std::chrono::seconds(2));
+  EXPECT_TRUE(peer_->holdLease(leaseKey(), simTime().systemTime(), std::chrono::seconds(3)));
+  EXPECT_CALL(*interval_timer_, enableTimer(_, _));
+  interval_timer_->invokeCallback();
+  EXPECT_EQ(0UL, cluster_->info_->stats_store_.counter("health_check.attempt").value());
+
+  simTime().advanceTimeWait(std::chrono::milliseconds(2500));
+  EXPECT_TRUE(peer_->holdLease(leaseKey(), simTime().systemTime(), std::chrono::seconds(3)));
+  expectClientCreate();
+  EXPECT_CALL(*connection_, write(_, _));
+  EXPECT_CALL(*timeout_timer_, enableTimer(_, _));
+  interval_timer_->invokeCallback();
+  EXPECT_EQ(1UL, cluster_->info_->stats_store_.counter("health_check.attempt").value());
+
+  // The local result is published, but not applied again as if it came from another process.
+  connection_->raiseEvent(Network::ConnectionEvent::Connected);
+  EXPECT_CALL(*timeout_timer_, disableTimer());
+  EXPECT_CALL(*interval_timer_, enableTimer(_, _));
+  Buffer::OwnedImpl response;
+  addUint8(response, 2);
+  read_filter_->onData(response, false);
+  EXPECT_EQ(1, peer_->find(hostKey())->sequence_);
+
+  EXPECT_CALL(*connection_, write(_, _));
+  EXPECT_CALL(*timeout_timer_, enableTimer(_, _));
+  interval_timer_->invokeCallback();
+  EXPECT_EQ(2UL, cluster_->info_->stats_store_.counter("health_check.attempt").value());
+  EXPECT_EQ(0UL, cluster_->info_->stats_store_.counter("health_check.shared_result").value());
+}
+#endif
+
 class TestGrpcHealthCheckerImpl : public GrpcHealthCheckerImpl {
 public:
   using GrpcHealthCheckerImpl::GrpcHealthCheckerImpl;
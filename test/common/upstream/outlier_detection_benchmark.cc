@@ -0,0 +1,105 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+//
+// Measures the interval processing of the outlier detector, which computes the success rate
+// statistics of every host of a cluster.
+
+#include <memory>
+#include <string>
+
+#include "envoy/config/cluster/v3/outlier_detection.pb.h"
+
+#include "source/common/upstream/outlier_detection_impl.h"
+
+#include "test/benchmark/main.h"
+#include "test/common/upstream/utility.h"
+#include "test/mocks/event/mocks.h"
+#include "test/mocks/runtime/mocks.h"
+#include "test/mocks/upstream/cluster_priority_set.h"
+#include "test/mocks/upstream/host_set.h"
+#include "test/test_common/simulated_time_system.h"
+
+#include "absl/strings/str_cat.h"
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Upstream {
+namespace Outlier {
+namespace {
+
+using testing::NiceMock;
+
+class OutlierDetectionBenchmark {
+public:
+  explicit OutlierDetectionBenchmark(uint32_t num_hosts) {
+    for (uint32_t i = 0; i < num_hosts; ++i) {
+      hosts_.push_back(makeTestHost(cluster_.info_,
+                                    absl::StrCat("tcp://10.0.", i / 256, ".", i % 256, ":80")));
+    }
+    detector_ = DetectorImpl::create(cluster_, config_, dispatcher_, runtime_, time_system_,
+                                     nullptr, random_)
+                    .value();
+  }
+
+  // Loads each host with 100 requests, at success rates spread evenly between 90% and 100%. As
+  // the spread is within 1.9 standard deviations of the mean, no host is ejected and every
+  // interval processes all of the hosts.
+  void loadRequests() {
+    for (size_t i = 0; i < hosts_.size(); ++i) {
+      const uint32_t failures = i % 11;
+      for (uint32_t request = 0; request < 100; ++request) {
+        hosts_[i]->outlierDetector().putResult(request < failures ? Result::ExtOriginRequestFailed
+                                                                  : Result::ExtOriginRequestSuccess,
+                                               request < failures ? 503 : 200);
+      }
+    }
+  }
+
+  void runInterval() { interval_timer_->invokeCallback(); }
+
+  DetectorImpl& detector() { return *detector_; }
+
+private:
+  NiceMock<MockClusterMockPrioritySet> cluster_;
+  HostVector& hosts_ = cluster_.prioritySet().getMockHostSet(0)->hosts_;
+  NiceMock<Event::MockDispatcher> dispatcher_;
+  NiceMock<Runtime::MockLoader> runtime_;
+  NiceMock<Random::MockRandomGenerator> random_;
+  NiceMock<Event::MockTimer>* interval_timer_ = new NiceMock<Event::MockTimer>(&dispatcher_);
+  Event::SimulatedTimeSystem time_system_;
+  envoy::config::cluster::v3::OutlierDetection config_;
+  std::shared_ptr<DetectorImpl> detector_;
+};
+
+} // namespace
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_SuccessRateInterval(::benchmark::State& state) {
+  const uint32_t num_hosts = state.range(0);
+  if (benchmark::skipExpensiveBenchmarks() && num_hosts > 1000) {
+    state.SkipWithError("Skipping expensive benchmark");
+    return;
+  }
+  OutlierDetectionBenchmark bench(num_hosts);
+
+  for (auto _ : state) { // NOLINT
+    state.PauseTiming();
+    bench.loadRequests();
+    state.ResumeTiming();
+    bench.runInterval();
+  }
+  if (bench.detector().successRateAverage(
+          DetectorHostMonitor::SuccessRateMonitorType::ExternalOrigin) < 0) {
+    state.SkipWithError("Success rate was not computed");
+  }
+  state.SetItemsProcessed(state.iterations() * num_hosts);
+}
+BENCHMARK(BM_SuccessRateInterval)
+    ->Arg(1000)
+    ->Arg(10000)
+    ->Arg(50000)
+    ->Unit(::benchmark::kMillisecond);
+
+} // namespace Outlier
+} // namespace Upstream
+} // namespace Envoy
@@ -1,4 +1,5 @@
 #include <chrono>
+#include <cmath>
 #include <cstdint>
 #include <memory>
 #include <string>
@@ -2778,19 +2779,38 @@ TEST(OutlierDetectionEventLoggerImplTest, All) {
 }
 
 TEST(OutlierUtility, SRThreshold) {
-  std::vector<HostSuccessRatePair> data = {
-      HostSuccessRatePair(nullptr, 50),  HostSuccessRatePair(nullptr, 100),
-      HostSuccessRatePair(nullptr, 100), HostSuccessRatePair(nullptr, 100),
-      HostSuccessRatePair(nullptr, 100),
-  };
-  double sum = 450;
+  std::vector<double> data = {50, 100, 100, 100, 100};
 
   DetectorImpl::EjectionPair success_rate_nums =
-      DetectorImpl::successRateEjectionThreshold(sum, data, 1.9);
+      DetectorImpl::successRateEjectionThreshold(data, 1.9);
   EXPECT_EQ(90.0, success_rate_nums.success_rate_average_); // average success rate
   EXPECT_EQ(52.0, success_rate_nums.ejection_threshold_);   //  ejection threshold
 }
 
+// The statistics are summed in lanes, and must match those summed in order whatever the number of
+// data points.
+TEST(OutlierUtility, SRThresholdMatchesSequentialSum) {
+  for (size_t size = 1; size <= 37; ++size) {
+    std::vector<double> data;
+    double sum = 0;
+    for (size_t i = 0; i < size; ++i) {
+      data.push_back(100.0 - (i * 7) % 41);
+      sum += data.back();
+    }
+    const double mean = sum / size;
+    double variance = 0;
+    for (double success_rate : data) {
+      variance += (success_rate - mean) * (success_rate - mean);
+    }
+    variance /= size;
+
+    DetectorImpl::EjectionPair success_rate_nums =
+        DetectorImpl::successRateEjectionThreshold(data, 1.9);
+    EXPECT_DOUBLE_EQ(mean, success_rate_nums.success_rate_average_);
+    EXPECT_DOUBLE_EQ(mean - 1.9 * std::sqrt(variance), success_rate_nums.ejection_threshold_);
+  }
+}
+
 TEST_F(OutlierDetectorImplTest, DegradedHostDetection) {
   const std::string yaml = R"EOF(
 interval: 10s
@@ -0,0 +1,242 @@
+#include <chrono>
+#include <memory>
+#include <vector>
+
+#include "source/extensions/health_checkers/common/shared_health_check_results.h"
+
+#include "test/test_common/environment.h"
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Upstream {
+namespace {
+
+using Outcome = SharedHealthCheckResults::Outcome;
+
+class SharedHealthCheckResultsTest : public testing::Test {
+protected:
+  // Zero-filled memory, as a freshly sized file maps to.
+  void* allocate(uint64_t capacity) {
+    memory_.assign(SharedHealthCheckResults::bytesRequired(capacity) / sizeof(uint64_t), 0);
+    return memory_.data();
+  }
+
+  std::unique_ptr<SharedHealthCheckResults> attach(uint64_t capacity) {
+    auto region_or_error = SharedHealthCheckResults::initialize(
+        memory_.data(), memory_.size() * sizeof(uint64_t), capacity, timeout_);
+    EXPECT_TRUE(region_or_error.ok()) << region_or_error.status();
+    return std::move(region_or_error.value());
+  }
+
+  std::vector<uint64_t> memory_;
+  const SystemTime now_{std::chrono::seconds(1000)};
+  const std::chrono::milliseconds timeout_{10};
+};
+
+TEST_F(SharedHealthCheckResultsTest, LayoutIsSharedByAttachingProcesses) {
+  allocate(5);
+  auto first = attach(5);
+  EXPECT_EQ(8, first->capacity());
+  // A process attaching later uses the capacity it finds, whatever it asks for.
+  auto second = attach(2);
+  EXPECT_EQ(8, second->capacity());
+
+  EXPECT_TRUE(first->publish(42, Outcome::Healthy, envoy::data::core::v3::ACTIVE, false));
+  EXPECT_EQ(1, second->size());
+  ASSERT_TRUE(second->find(42).has_value());
+  EXPECT_EQ(Outcome::Healthy, second->find(42)->outcome_);
+}
+
+TEST_F(SharedHealthCheckResultsTest, PublishAndFind) {
+  allocate(4);
+  auto region = attach(4);
+  EXPECT_FALSE(region->find(7).has_value());
+
+  EXPECT_EQ(1,
+            region->publish(7, Outcome::Unhealthy, envoy::data::core::v3::NETWORK_TIMEOUT, true));
+  absl::optional<SharedHealthCheckResults::Result> result = region->find(7);
+  ASSERT_TRUE(result.has_value());
+  EXPECT_EQ(Outcome::Unhealthy, result->outcome_);
+  EXPECT_EQ(envoy::data::core::v3::NETWORK_TIMEOUT, result->failure_type_);
+  EXPECT_TRUE(result->retriable_);
+  EXPECT_EQ(1, result->sequence_);
+
+  EXPECT_EQ(2, region->publish(7, Outcome::Degraded, envoy::data::core::v3::ACTIVE, false));
+  result = region->find(7);
+  ASSERT_TRUE(result.has_value());
+  EXPECT_EQ(Outcome::Degraded, result->outcome_);
+  EXPECT_EQ(envoy::data::core::v3::ACTIVE, result->failure_type_);
+  EXPECT_FALSE(result->retriable_);
+  EXPECT_EQ(2, result->sequence_);
+  EXPECT_EQ(1, region->size());
+
+  // Key 0 marks an empty slot, but is still usable as a host's key.
+  EXPECT_TRUE(region->publish(0, Outcome::Healthy, envoy::data::core::v3::ACTIVE, false));
+  ASSERT_TRUE(region->find(0).has_value());
+  EXPECT_EQ(Outcome::Healthy, region->find(0)->outcome_);
+}
+
+TEST_F(SharedHealthCheckResultsTest, Full) {
+  allocate(2);
+  auto region = attach(2);
+  EXPECT_TRUE(region->publish(1, Outcome::Healthy, envoy::data::core::v3::ACTIVE, false));
+  EXPECT_TRUE(region->publish(3, Outcome::Healthy, envoy::data::core::v3::ACTIVE, false));
+  EXPECT_EQ(0, region->publish(5, Outcome::Healthy, envoy::data::core::v3::ACTIVE, false));
+  EXPECT_FALSE(region->find(5).has_value());
+  // Hosts which already have a slot keep publishing.
+  EXPECT_TRUE(region->publish(3, Outcome::Unhealthy, envoy::data::core::v3::ACTIVE, false));
+  EXPECT_EQ(2, region->size());
+}
+
+TEST_F(SharedHealthCheckResultsTest, Lease) {
+  allocate(2);
+  auto first = attach(2);
+  auto second = attach(2);
+  const std::chrono::milliseconds duration{3000};
+
+  EXPECT_TRUE(first->holdLease(10, now_, duration));
+  EXPECT_FALSE(second->holdLease(10, now_, duration));
+  // Renewed by its holder before it expires.
+  EXPECT_TRUE(first->holdLease(10, now_ + std::chrono::seconds(2), duration));
+  EXPECT_FALSE(second->holdLease(10, now_ + std::chrono::seconds(4), duration));
+
+  // Taken over once it expires.
+  EXPECT_TRUE(second->holdLease(10, now_ + std::chrono::seconds(5), duration));
+  EXPECT_FALSE(first->holdLease(10, now_ + std::chrono::seconds(5), duration));
+}
+
+// The holder only writes the lease once half of it has run out, however often it is asked.
+TEST_F(SharedHealthCheckResultsTest, LeaseRenewedOnceHalfOfItIsLeft) {
+  allocate(2);
+  auto first = attach(2);
+  auto second = attach(2);
+  const std::chrono::milliseconds duration{3000};
+
+  EXPECT_TRUE(first->holdLease(10, now_, duration));
+  // Not renewed, so it still expires 3s after it was taken.
+  EXPECT_TRUE(first->holdLease(10, now_ + std::chrono::milliseconds(1400), duration));
+  EXPECT_FALSE(second->holdLease(10, now_ + std::chrono::milliseconds(2999), duration));
+  EXPECT_TRUE(second->holdLease(10, now_ + std::chrono::seconds(3), duration));
+
+  // Renewed with less than half of it left.
+  EXPECT_TRUE(second->holdLease(10, now_ + std::chrono::milliseconds(4600), duration));
+  EXPECT_FALSE(first->holdLease(10, now_ + std::chrono::milliseconds(7500), duration));
+  EXPECT_TRUE(first->holdLease(10, now_ + std::chrono::milliseconds(7600), duration));
+}
+
+// Every process attached to a region holds leases under an identifier of its own.
+TEST_F(SharedHealthCheckResultsTest, LeaseOwnersAreUnique) {
+  allocate(2);
+  std::vector<std::unique_ptr<SharedHealthCheckResults>> regions;
+  for (int i = 0; i < 100; ++i) {
+    regions.push_back(attach(2));
+  }
+  const std::chrono::milliseconds duration{3000};
+  EXPECT_TRUE(regions[37]->holdLease(10, now_, duration));
+  for (size_t i = 0; i < regions.size(); ++i) {
+    EXPECT_EQ(i == 37, regions[i]->holdLease(10, now_, duration)) << i;
+  }
+}
+
+// Each health check has a lease of its own, so that a process probes the hosts of the health
+// checks it holds the lease of, and not of every health check sharing the region.
+TEST_F(SharedHealthCheckResultsTest, LeasePerKey) {
+  allocate(2);
+  auto first = attach(2);
+  auto second = attach(2);
+  const std::chrono::milliseconds duration{3000};
+
+  EXPECT_TRUE(first->holdLease(10, now_, duration));
+  EXPECT_TRUE(second->holdLease(11, now_, duration));
+  EXPECT_FALSE(first->holdLease(11, now_, duration));
+  EXPECT_FALSE(second->holdLease(10, now_, duration));
+  EXPECT_EQ(2, first->size());
+}
+
+// Without a slot for the lease, every process probes the hosts, rather than none.
+TEST_F(SharedHealthCheckResultsTest, LeaseFull) {
+  allocate(1);
+  auto first = attach(1);
+  auto second = attach(1);
+  const std::chrono::milliseconds duration{3000};
+
+  EXPECT_EQ(1, first->publish(7, Outcome::Healthy, envoy::data::core::v3::ACTIVE, false));
+  EXPECT_TRUE(first->holdLease(10, now_, duration));
+  EXPECT_TRUE(second->holdLease(10, now_, duration));
+}
+
+TEST_F(SharedHealthCheckResultsTest, IncompatibleLayout) {
+  allocate(4);
+  auto region = attach(4);
+  // The magic number follows the state in the header.
+  memory_[1] = 0;
+  auto region_or_error = SharedHealthCheckResults::initialize(
+      memory_.data(), memory_.size() * sizeof(uint64_t), 4, timeout_);
+  EXPECT_FALSE(region_or_error.ok());
+  EXPECT_EQ("shared health check region has an incompatible layout",
+            region_or_error.status().message());
+}
+
+TEST_F(SharedHealthCheckResultsTest, TooSmall) {
+  allocate(4);
+  auto region_or_error = SharedHealthCheckResults::initialize(
+      memory_.data(), memory_.size() * sizeof(uint64_t), 8, timeout_);
+  EXPECT_FALSE(region_or_error.ok());
+  // The memory is left empty for a process asking for a capacity which fits.
+  EXPECT_NE(nullptr, attach(4));
+}
+
+// A process which exits while laying the region out doesn't leave the others waiting forever.
+TEST_F(SharedHealthCheckResultsTest, LayOutNeverFinished) {
+  allocate(4);
+  // The state leads the header, and 1 marks a region being laid out.
+  memory_[0] = 1;
+  auto region_or_error = SharedHealthCheckResults::initialize(
+      memory_.data(), memory_.size() * sizeof(uint64_t), 4, timeout_);
+  EXPECT_EQ(absl::StatusCode::kUnavailable, region_or_error.status().code());
+  EXPECT_EQ("shared health check region was not laid out within 10ms; the process laying it out "
+            "may have exited, in which case it must be removed",
+            region_or_error.status().message());
+}
+
+#ifndef WIN32
+TEST_F(SharedHealthCheckResultsTest, Open) {
+  const std::string path =
+      TestEnvironment::temporaryPath(TestUtility::uniqueFilename("shared_health_check_results"));
+  auto region_or_error = SharedHealthCheckResults::open(path, 16);
+  ASSERT_TRUE(region_or_error.ok()) << region_or_error.status();
+  SharedHealthCheckResultsSharedPtr region = region_or_error.value();
+  EXPECT_EQ(16, region->capacity());
+  EXPECT_TRUE(region->publish(9, Outcome::Healthy, envoy::data::core::v3::ACTIVE, false));
+
+  // The health checkers of a process share one mapping of a file.
+  region_or_error = SharedHealthCheckResults::open(path, 64);
+  ASSERT_TRUE(region_or_error.ok()) << region_or_error.status();
+  EXPECT_EQ(region, region_or_error.value());
+}
+
+// A process which exits between creating the file and sizing it doesn't leave the others waiting
+// forever.
+TEST_F(SharedHealthCheckResultsTest, OpenNeverSized) {
+  const std::string path =
+      TestEnvironment::temporaryPath(TestUtility::uniqueFilename("shared_health_check_results"));
+  TestEnvironment::writeStringToFileForTest(path, "", true);
+  auto region_or_error = SharedHealthCheckResults::open(path, 16);
+  EXPECT_EQ(absl::StatusCode::kUnavailable, region_or_error.status().code());
+  EXPECT_THAT(std::string(region_or_error.status().message()),
+              testing::HasSubstr("was not sized within 1000ms"));
+}
+
+TEST_F(SharedHealthCheckResultsTest, OpenError) {
+  auto region_or_error = SharedHealthCheckResults::open(
+      TestEnvironment::temporaryPath("does/not/exist/shared_health_check_results"), 16);
+  EXPECT_FALSE(region_or_error.ok());
+}
+#endif
+
+} // namespace
+} // namespace Upstream
+} // namespace Envoy
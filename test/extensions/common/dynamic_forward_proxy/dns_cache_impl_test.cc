@@ -971,6 +971,165 @@ TEST_F(DnsCacheImplTest, DisableRefreshOnFailureContainsSuccessfulHost) {
              1 /* added */, 0 /* removed */, 1 /* num hosts */);
 }
 
+// A failed resolution is served from the cache for the negative cache TTL before a request
+// re-resolves the host.
+TEST_F(DnsCacheImplTest, NegativeCacheTtl) {
+  config_.set_disable_dns_refresh_on_failure(true);
+  config_.mutable_dns_negative_cache_ttl()->set_seconds(10);
+
+  initialize();
+  InSequence s;
+
+  MockLoadDnsCacheEntryCallbacks callbacks;
+  Network::DnsResolver::ResolveCb resolve_cb;
+  new Event::MockTimer(&context_.server_context_.dispatcher_); // refresh_timer
+  Event::MockTimer* query_timeout_timer =
+      new Event::MockTimer(&context_.server_context_.dispatcher_);
+  EXPECT_CALL(*query_timeout_timer, enableTimer(std::chrono::milliseconds(5000), nullptr));
+  EXPECT_CALL(*resolver_, resolve("foo.com", _, _))
+      .WillOnce(DoAll(SaveArg<2>(&resolve_cb), Return(&resolver_->active_query_)));
+  auto result = dns_cache_->loadDnsCacheEntry("foo.com", 80, false, callbacks);
+  EXPECT_EQ(DnsCache::LoadDnsCacheEntryStatus::Loading, result.status_);
+
+  EXPECT_CALL(*query_timeout_timer, disableTimer());
+  EXPECT_CALL(callbacks, onLoadDnsCacheComplete(DnsHostInfoAddressIsNull()));
+  EXPECT_CALL(update_callbacks_,
+              onDnsResolutionComplete("foo.com:80", DnsHostInfoAddressIsNull(),
+                                      Network::DnsResolver::ResolutionStatus::Failure));
+  resolve_cb(Network::DnsResolver::ResolutionStatus::Failure, "", TestUtility::makeDnsResponse({}));
+
+  // Within the negative cache TTL the failure is a cache hit.
+  simTime().advanceTimeWait(std::chrono::seconds(9));
+  result = dns_cache_->loadDnsCacheEntry("foo.com", 80, false, callbacks);
+  EXPECT_EQ(DnsCache::LoadDnsCacheEntryStatus::InCache, result.status_);
+  EXPECT_EQ(result.handle_, nullptr);
+  ASSERT_NE(absl::nullopt, result.host_info_);
+  EXPECT_EQ(Network::DnsResolver::ResolutionStatus::Failure,
+            (*result.host_info_)->resolutionStatus());
+  EXPECT_EQ(1, TestUtility::findCounter(context_.store_, "dns_cache.foo.negative_cache_hit")
+                   ->value());
+  checkStats(1 /* attempt */, 0 /* success */, 1 /* failure */, 0 /* address changed */,
+             1 /* added */, 0 /* removed */, 1 /* num hosts */);
+
+  // Once it has passed the host is re-resolved.
+  simTime().advanceTimeWait(std::chrono::seconds(1));
+  new Event::MockTimer(&context_.server_context_.dispatcher_); // refresh_timer
+  query_timeout_timer = new Event::MockTimer(&context_.server_context_.dispatcher_);
+  EXPECT_CALL(*query_timeout_timer, enableTimer(std::chrono::milliseconds(5000), nullptr));
+  EXPECT_CALL(*resolver_, resolve("foo.com", _, _))
+      .WillOnce(DoAll(SaveArg<2>(&resolve_cb), Return(&resolver_->active_query_)));
+  result = dns_cache_->loadDnsCacheEntry("foo.com", 80, false, callbacks);
+  EXPECT_EQ(DnsCache::LoadDnsCacheEntryStatus::Loading, result.status_);
+  EXPECT_NE(result.handle_, nullptr);
+  checkStats(2 /* attempt */, 0 /* success */, 1 /* failure */, 0 /* address changed */,
+             2 /* added */, 1 /* removed */, 1 /* num hosts */);
+
+  EXPECT_CALL(*query_timeout_timer, disableTimer());
+  EXPECT_CALL(update_callbacks_, onDnsHostAddOrUpdate("foo.com:80", _));
+  EXPECT_CALL(callbacks,
+              onLoadDnsCacheComplete(DnsHostInfoEquals("10.0.0.1:80", "foo.com", false)));
+  EXPECT_CALL(update_callbacks_, onDnsResolutionComplete("foo.com:80", _, _));
+  resolve_cb(Network::DnsResolver::ResolutionStatus::Completed, "",
+             TestUtility::makeDnsResponse({"10.0.0.1"}));
+}
+
+// A forced refresh of a resolved host is served its current addresses while the host is
+// re-resolved in the background, and they are kept if the re-resolution fails.
+TEST_F(DnsCacheImplTest, StaleWhileRevalidate) {
+  config_.set_stale_while_revalidate(true);
+
+  initialize();
+  InSequence s;
+
+  MockLoadDnsCacheEntryCallbacks callbacks;
+  Network::DnsResolver::ResolveCb resolve_cb;
+  Event::MockTimer* refresh_timer = new Event::MockTimer(&context_.server_context_.dispatcher_);
+  Event::MockTimer* timeout_timer = new Event::MockTimer(&context_.server_context_.dispatcher_);
+  EXPECT_CALL(*timeout_timer, enableTimer(std::chrono::milliseconds(5000), nullptr));
+  EXPECT_CALL(*resolver_, resolve("foo.com", _, _))
+      .WillOnce(DoAll(SaveArg<2>(&resolve_cb), Return(&resolver_->active_query_)));
+  auto result = dns_cache_->loadDnsCacheEntry("foo.com", 80, false, callbacks);
+  EXPECT_EQ(DnsCache::LoadDnsCacheEntryStatus::Loading, result.status_);
+
+  EXPECT_CALL(*timeout_timer, disableTimer());
+  EXPECT_CALL(update_callbacks_, onDnsHostAddOrUpdate("foo.com:80", _));
+  EXPECT_CALL(callbacks,
+              onLoadDnsCacheComplete(DnsHostInfoEquals("10.0.0.1:80", "foo.com", false)));
+  EXPECT_CALL(update_callbacks_, onDnsResolutionComplete("foo.com:80", _, _));
+  EXPECT_CALL(*refresh_timer, enableTimer(std::chrono::milliseconds(dns_ttl_), _));
+  resolve_cb(Network::DnsResolver::ResolutionStatus::Completed, "",
+             TestUtility::makeDnsResponse({"10.0.0.1"}));
+
+  // The forced refresh doesn't wait for the resolution.
+  EXPECT_CALL(*refresh_timer, disableTimer());
+  EXPECT_CALL(*timeout_timer, enableTimer(std::chrono::milliseconds(5000), nullptr));
+  EXPECT_CALL(*resolver_, resolve("foo.com", _, _))
+      .WillOnce(DoAll(SaveArg<2>(&resolve_cb), Return(&resolver_->active_query_)));
+  result = dns_cache_->loadDnsCacheEntryWithForceRefresh("foo.com", 80, false, true, callbacks);
+  EXPECT_EQ(DnsCache::LoadDnsCacheEntryStatus::InCache, result.status_);
+  EXPECT_EQ(result.handle_, nullptr);
+  ASSERT_NE(absl::nullopt, result.host_info_);
+  EXPECT_THAT(*result.host_info_, DnsHostInfoEquals("10.0.0.1:80", "foo.com", false));
+
+  // Another forced refresh while the host is resolving doesn't start another resolution.
+  result = dns_cache_->loadDnsCacheEntryWithForceRefresh("foo.com", 80, false, true, callbacks);
+  EXPECT_EQ(DnsCache::LoadDnsCacheEntryStatus::InCache, result.status_);
+  EXPECT_EQ(2, TestUtility::findCounter(context_.store_, "dns_cache.foo.stale_hit")->value());
+  checkStats(2 /* attempt */, 1 /* success */, 0 /* failure */, 1 /* address changed */,
+             1 /* added */, 0 /* removed */, 1 /* num hosts */);
+
+  EXPECT_CALL(*timeout_timer, disableTimer());
+  EXPECT_CALL(update_callbacks_,
+              onDnsResolutionComplete("foo.com:80",
+                                      DnsHostInfoEquals("10.0.0.1:80", "foo.com", false),
+                                      Network::DnsResolver::ResolutionStatus::Failure));
+  EXPECT_CALL(*refresh_timer, enableTimer(_, _));
+  resolve_cb(Network::DnsResolver::ResolutionStatus::Failure, "", TestUtility::makeDnsResponse({}));
+
+  result = dns_cache_->loadDnsCacheEntry("foo.com", 80, false, callbacks);
+  EXPECT_EQ(DnsCache::LoadDnsCacheEntryStatus::InCache, result.status_);
+  ASSERT_NE(absl::nullopt, result.host_info_);
+  EXPECT_THAT(*result.host_info_, DnsHostInfoEquals("10.0.0.1:80", "foo.com", false));
+}
+
+// Requests on a thread for a host which the thread is already loading don't post another load.
+TEST_F(DnsCacheImplTest, CoalescePendingCacheLoads) {
+  initialize();
+  InSequence s;
+
+  Event::PostCb post_cb;
+  EXPECT_CALL(context_.server_context_.dispatcher_, post(_)).WillOnce([&post_cb](Event::PostCb cb) {
+    post_cb = std::move(cb);
+  });
+  MockLoadDnsCacheEntryCallbacks callbacks1;
+  auto result1 = dns_cache_->loadDnsCacheEntry("foo.com", 80, false, callbacks1);
+  EXPECT_EQ(DnsCache::LoadDnsCacheEntryStatus::Loading, result1.status_);
+  EXPECT_NE(result1.handle_, nullptr);
+
+  MockLoadDnsCacheEntryCallbacks callbacks2;
+  auto result2 = dns_cache_->loadDnsCacheEntry("foo.com", 80, false, callbacks2);
+  EXPECT_EQ(DnsCache::LoadDnsCacheEntryStatus::Loading, result2.status_);
+  EXPECT_NE(result2.handle_, nullptr);
+  EXPECT_EQ(1, TestUtility::findCounter(context_.store_, "dns_cache.foo.cache_load_coalesced")
+                   ->value());
+
+  Network::DnsResolver::ResolveCb resolve_cb;
+  EXPECT_CALL(*resolver_, resolve("foo.com", _, _))
+      .WillOnce(DoAll(SaveArg<2>(&resolve_cb), Return(&resolver_->active_query_)));
+  post_cb();
+  checkStats(1 /* attempt */, 0 /* success */, 0 /* failure */, 0 /* address changed */,
+             1 /* added */, 0 /* removed */, 1 /* num hosts */);
+
+  EXPECT_CALL(update_callbacks_, onDnsHostAddOrUpdate("foo.com:80", _));
+  EXPECT_CALL(callbacks2,
+              onLoadDnsCacheComplete(DnsHostInfoEquals("10.0.0.1:80", "foo.com", false)));
+  EXPECT_CALL(callbacks1,
+              onLoadDnsCacheComplete(DnsHostInfoEquals("10.0.0.1:80", "foo.com", false)));
+  EXPECT_CALL(update_callbacks_, onDnsResolutionComplete("foo.com:80", _, _));
+  resolve_cb(Network::DnsResolver::ResolutionStatus::Completed, "",
+             TestUtility::makeDnsResponse({"10.0.0.1"}));
+}
+
 TEST_F(DnsCacheImplTest, ResolveFailureWithFailureRefreshRate) {
   *config_.mutable_dns_failure_refresh_rate()->mutable_base_interval() =
       Protobuf::util::TimeUtil::SecondsToDuration(7);
@@ -0,0 +1,177 @@
+// Measures throughput and compression ratio of the gzip, brotli and zstd compressor libraries for
+// every compression level on a fixed synthetic corpus. The results describe the trade-off curve
+// used by the compressor filter's adaptive effort, and can be reproduced with e.g.
+//
+//   bazel run -c opt //test/extensions/compression/common/compressor:compression_level_speed_test
+//
+// Throughput is reported as bytes_per_second of uncompressed input and the ratio as the
+// uncompressed size divided by the compressed size.
+
+#include <random>
+
+#include "envoy/extensions/compression/brotli/compressor/v3/brotli.pb.h"
+#include "envoy/extensions/compression/gzip/compressor/v3/gzip.pb.h"
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/extensions/compression/brotli/compressor/brotli_compressor_impl.h"
+#include "source/extensions/compression/brotli/compressor/config.h"
+#include "source/extensions/compression/gzip/compressor/config.h"
+#include "source/extensions/compression/gzip/compressor/zlib_compressor_impl.h"
+#include "source/extensions/compression/zstd/compressor/zstd_compressor_impl.h"
+
+#include "test/benchmark/main.h"
+
+#include "absl/strings/str_cat.h"
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Compression {
+namespace {
+
+constexpr uint64_t CorpusSize = 256 * 1024;
+constexpr uint64_t ChunkSize = 16 * 1024;
+
+// Builds a deterministic corpus resembling a typical compressible API response: a JSON array of
+// objects with repeated keys, values drawn from a bounded vocabulary and random numbers. The
+// generator is seeded with a constant and only uses the raw engine output, so the corpus is
+// identical across platforms and standard libraries.
+std::string buildCorpus() {
+  static constexpr absl::string_view Words[] = {
+      "envoy",   "proxy",   "cluster", "listener", "route",  "upstream", "downstream", "filter",
+      "header",  "request", "stream",  "timeout",  "retry",  "health",   "endpoint",   "region",
+      "primary", "canary",  "zone-a",  "zone-b",   "active", "draining", "warming",    "ready"};
+  std::mt19937 prng(1234);
+  std::string corpus = "[";
+  uint64_t id = 0;
+  while (corpus.size() < CorpusSize) {
+    absl::StrAppend(&corpus, id == 0 ? "" : ",", "{\"id\":", id++, ",\"name\":\"",
+                    Words[prng() % std::size(Words)], "-", Words[prng() % std::size(Words)],
+                    "\",\"status\":\"", Words[prng() % std::size(Words)],
+                    "\",\"latency_ms\":", prng() % 10000, ",\"bytes\":", prng(), ",\"tags\":[\"",
+                    Words[prng() % std::size(Words)], "\",\"", Words[prng() % std::size(Words)],
+                    "\"]}");
+  }
+  corpus.resize(CorpusSize - 1);
+  corpus += "]";
+  return corpus;
+}
+
+const std::string& corpus() { CONSTRUCT_ON_FIRST_USE(std::string, buildCorpus()); }
+
+// Compresses the corpus in fixed-size chunks, flushing after each chunk like the compressor filter
+// does for each body frame, and returns the total compressed size.
+uint64_t compressCorpus(Envoy::Compression::Compressor::Compressor& compressor) {
+  const std::string& input = corpus();
+  uint64_t compressed_bytes = 0;
+  for (uint64_t offset = 0; offset < input.size(); offset += ChunkSize) {
+    Buffer::OwnedImpl chunk(absl::string_view(input).substr(offset, ChunkSize));
+    const bool last = offset + ChunkSize >= input.size();
+    compressor.compress(chunk, last ? Envoy::Compression::Compressor::State::Finish
+                                    : Envoy::Compression::Compressor::State::Flush);
+    compressed_bytes += chunk.length();
+  }
+  return compressed_bytes;
+}
+
+void reportResults(::benchmark::State& state, uint64_t compressed_bytes) {
+  state.SetBytesProcessed(state.iterations() * corpus().size());
+  state.counters["ratio"] = static_cast<double>(corpus().size()) / compressed_bytes;
+}
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+void gzipLevel(::benchmark::State& state) {
+  const auto level =
+      static_cast<Gzip::Compressor::ZlibCompressorImpl::CompressionLevel>(state.range(0));
+  uint64_t compressed_bytes = 0;
+  for (auto _ : state) {
+    UNREFERENCED_PARAMETER(_);
+    Gzip::Compressor::ZlibCompressorImpl compressor(Gzip::Compressor::DefaultChunkSize);
+    compressor.init(level, Gzip::Compressor::ZlibCompressorImpl::CompressionStrategy::Standard,
+                    Gzip::Compressor::DefaultWindowBits | Gzip::Compressor::GzipHeaderValue,
+                    Gzip::Compressor::DefaultMemoryLevel);
+    compressed_bytes = compressCorpus(compressor);
+  }
+  reportResults(state, compressed_bytes);
+}
+BENCHMARK(gzipLevel)->DenseRange(1, 9, 1)->Unit(::benchmark::kMillisecond);
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+void brotliLevel(::benchmark::State& state) {
+  const uint32_t quality = state.range(0);
+  if (benchmark::skipExpensiveBenchmarks() && quality > 9) {
+    state.SkipWithError("Skipping expensive brotli quality.");
+    return;
+  }
+  uint64_t compressed_bytes = 0;
+  for (auto _ : state) {
+    UNREFERENCED_PARAMETER(_);
+    Brotli::Compressor::BrotliCompressorImpl compressor(
+        quality, Brotli::Compressor::DefaultWindowBits, Brotli::Compressor::DefaultInputBlockBits,
+        false, Brotli::Compressor::BrotliCompressorImpl::EncoderMode::Default,
+        Brotli::Compressor::DefaultChunkSize);
+    compressed_bytes = compressCorpus(compressor);
+  }
+  reportResults(state, compressed_bytes);
+}
+BENCHMARK(brotliLevel)->DenseRange(0, 11, 1)->Unit(::benchmark::kMillisecond);
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+void zstdLevel(::benchmark::State& state) {
+  const uint32_t level = state.range(0);
+  if (benchmark::skipExpensiveBenchmarks() && level > 9) {
+    state.SkipWithError("Skipping expensive zstd level.");
+    return;
+  }
+  const Zstd::Compressor::ZstdCDictManagerPtr cdict_manager;
+  uint64_t compressed_bytes = 0;
+  for (auto _ : state) {
+    UNREFERENCED_PARAMETER(_);
+    Zstd::Compressor::ZstdCompressorImpl compressor(level, false, 0, cdict_manager,
+                                                    ZSTD_CStreamOutSize());
+    compressed_bytes = compressCorpus(compressor);
+  }
+  reportResults(state, compressed_bytes);
+}
+BENCHMARK(zstdLevel)->DenseRange(1, 19, 1)->Unit(::benchmark::kMillisecond);
+
+// Measures the compressors created by the library factories for a relative effort between 0 and 1
+// (in steps of 0.25), which is what the compressor filter requests under CPU pressure.
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+void gzipEffort(::benchmark::State& state) {
+  envoy::extensions::compression::gzip::compressor::v3::Gzip proto;
+  proto.set_compression_level(
+      envoy::extensions::compression::gzip::compressor::v3::Gzip::BEST_COMPRESSION);
+  Gzip::Compressor::GzipCompressorFactory factory(proto);
+  const double effort = state.range(0) / 4.0;
+  uint64_t compressed_bytes = 0;
+  for (auto _ : state) {
+    UNREFERENCED_PARAMETER(_);
+    auto compressor = factory.createCompressorWithEffort(effort);
+    compressed_bytes = compressCorpus(*compressor);
+  }
+  reportResults(state, compressed_bytes);
+}
+BENCHMARK(gzipEffort)->DenseRange(0, 4, 1)->Unit(::benchmark::kMillisecond);
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+void brotliEffort(::benchmark::State& state) {
+  envoy::extensions::compression::brotli::compressor::v3::Brotli proto;
+  proto.mutable_quality()->set_value(9);
+  Brotli::Compressor::BrotliCompressorFactory factory(proto);
+  const double effort = state.range(0) / 4.0;
+  uint64_t compressed_bytes = 0;
+  for (auto _ : state) {
+    UNREFERENCED_PARAMETER(_);
+    auto compressor = factory.createCompressorWithEffort(effort);
+    compressed_bytes = compressCorpus(*compressor);
+  }
+  reportResults(state, compressed_bytes);
+}
+BENCHMARK(brotliEffort)->DenseRange(0, 4, 1)->Unit(::benchmark::kMillisecond);
+
+} // namespace
+} // namespace Compression
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,38 @@
+#include "source/extensions/compression/common/compressor/factory_base.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Compression {
+namespace Common {
+namespace Compressor {
+namespace {
+
+TEST(ScaledCompressionLevelTest, FullEffortUsesConfiguredLevel) {
+  EXPECT_EQ(9, scaledCompressionLevel(1, 9, 1.0));
+  EXPECT_EQ(11, scaledCompressionLevel(0, 11, 1.0));
+}
+
+TEST(ScaledCompressionLevelTest, NoEffortUsesFastestLevel) {
+  EXPECT_EQ(1, scaledCompressionLevel(1, 9, 0.0));
+  EXPECT_EQ(0, scaledCompressionLevel(0, 11, 0.0));
+}
+
+TEST(ScaledCompressionLevelTest, InterpolatesAndRounds) {
+  EXPECT_EQ(5, scaledCompressionLevel(1, 9, 0.5));
+  EXPECT_EQ(3, scaledCompressionLevel(1, 9, 0.25));
+  EXPECT_EQ(8, scaledCompressionLevel(0, 11, 0.7));
+}
+
+TEST(ScaledCompressionLevelTest, ConfiguredLevelAtOrBelowFastest) {
+  EXPECT_EQ(1, scaledCompressionLevel(1, 1, 0.5));
+  EXPECT_EQ(0, scaledCompressionLevel(1, 0, 0.0));
+}
+
+} // namespace
+} // namespace Compressor
+} // namespace Common
+} // namespace Compression
+} // namespace Extensions
+} // namespace Envoy
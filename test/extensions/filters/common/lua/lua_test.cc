@@ -5,12 +5,14 @@
 
 #include "test/mocks/common.h"
 #include "test/mocks/thread_local/mocks.h"
+#include "test/test_common/simulated_time_system.h"
 #include "test/test_common/utility.h"
 
 #include "gmock/gmock.h"
 
 using testing::_;
 using testing::InSequence;
+using testing::Invoke;
 using testing::NiceMock;
 
 namespace Envoy {
@@ -41,8 +43,8 @@ class LuaTest : public testing::Test {
 public:
   LuaTest() : yield_callback_([this]() { on_yield_.ready(); }) {}
 
-  void setup(const std::string& code) {
-    state_ = std::make_unique<ThreadLocalState>(code, tls_);
+  void setup(const std::string& code, const ThreadLocalStateOptions& options = {}) {
+    state_ = std::make_unique<ThreadLocalState>(code, tls_, options);
     state_->registerType<TestObject>();
   }
 
@@ -178,6 +180,130 @@ TEST_F(LuaTest, MarkDead) {
   lua_gc(cr1->luaState(), LUA_GCCOLLECT, 0);
 }
 
+// Coroutines that finished cleanly are reused up to the configured pool size.
+TEST_F(LuaTest, CoroutinePoolReusesFinishedCoroutines) {
+  const std::string SCRIPT{R"EOF(
+    function callMe(value)
+      return value
+    end
+  )EOF"};
+
+  ThreadLocalStateOptions options;
+  options.coroutine_pool_size = 1;
+  setup(SCRIPT, options);
+  const int function_ref = state_->getGlobalRef(state_->registerGlobal("callMe", initializers_));
+
+  CoroutinePtr cr1(state_->createCoroutine());
+  CoroutinePtr cr2(state_->createCoroutine());
+  lua_State* thread1 = cr1->luaState();
+  lua_pushnumber(thread1, 1);
+  cr1->start(function_ref, 1, yield_callback_);
+  EXPECT_EQ(cr1->state(), Coroutine::State::Finished);
+  EXPECT_EQ(1, lua_gettop(thread1));
+  lua_pushnumber(cr2->luaState(), 2);
+  cr2->start(function_ref, 1, yield_callback_);
+
+  cr1.reset();
+  EXPECT_EQ(1, state_->pooledCoroutines());
+  // The pool is full so the second thread is released.
+  cr2.reset();
+  EXPECT_EQ(1, state_->pooledCoroutines());
+
+  // The pooled thread is handed out again with an empty stack and can run another function.
+  CoroutinePtr cr3(state_->createCoroutine());
+  EXPECT_EQ(thread1, cr3->luaState());
+  EXPECT_EQ(0, state_->pooledCoroutines());
+  EXPECT_EQ(0, lua_gettop(thread1));
+  lua_pushnumber(thread1, 3);
+  cr3->start(function_ref, 1, yield_callback_);
+  EXPECT_EQ(cr3->state(), Coroutine::State::Finished);
+  EXPECT_EQ(3, lua_tonumber(thread1, -1));
+}
+
+// Coroutines that raised an error or are still suspended are never reused.
+TEST_F(LuaTest, CoroutinePoolSkipsUnfinishedCoroutines) {
+  const std::string SCRIPT{R"EOF(
+    function callMe(object)
+      object:testCall()
+      coroutine.yield()
+    end
+
+    function fail()
+      error("boom")
+    end
+  )EOF"};
+
+  ThreadLocalStateOptions options;
+  options.coroutine_pool_size = 2;
+  setup(SCRIPT, options);
+  const int yield_ref = state_->getGlobalRef(state_->registerGlobal("callMe", initializers_));
+  const int fail_ref = state_->getGlobalRef(state_->registerGlobal("fail", initializers_));
+
+  CoroutinePtr cr1(state_->createCoroutine());
+  LuaDeathRef<TestObject> ref(TestObject::create(cr1->luaState()), true);
+  EXPECT_CALL(*ref.get(), doTestCall(_));
+  EXPECT_CALL(on_yield_, ready());
+  cr1->start(yield_ref, 1, yield_callback_);
+  EXPECT_EQ(cr1->state(), Coroutine::State::Yielded);
+  EXPECT_FALSE(cr1->reusable());
+
+  CoroutinePtr cr2(state_->createCoroutine());
+  EXPECT_THROW_WITH_MESSAGE(cr2->start(fail_ref, 0, yield_callback_), LuaException,
+                            "[string \"...\"]:8: boom");
+  EXPECT_FALSE(cr2->reusable());
+
+  cr1.reset();
+  cr2.reset();
+  EXPECT_EQ(0, state_->pooledCoroutines());
+
+  EXPECT_CALL(*ref.get(), onDestroy());
+  ref.reset();
+  state_->runtimeGC();
+}
+
+// Accounting tracks the time spent running the coroutine and the heap growth it caused, but not
+// the time it spends suspended.
+TEST_F(LuaTest, CoroutineAccounting) {
+  const std::string SCRIPT{R"EOF(
+    function callMe(object)
+      object:testCall()
+      local t = {}
+      for i = 1, 1000 do
+        t[i] = {i}
+      end
+      coroutine.yield()
+      global_table = t
+    end
+  )EOF"};
+
+  setup(SCRIPT);
+  Event::SimulatedTimeSystem time_system;
+  const int function_ref = state_->getGlobalRef(state_->registerGlobal("callMe", initializers_));
+
+  CoroutinePtr cr(state_->createCoroutine());
+  cr->enableAccounting(time_system);
+  LuaDeathRef<TestObject> ref(TestObject::create(cr->luaState()), true);
+  EXPECT_CALL(*ref.get(), doTestCall(_)).WillOnce(Invoke([&](lua_State*) {
+    time_system.advanceTimeWait(std::chrono::microseconds(5));
+    return 0;
+  }));
+  EXPECT_CALL(on_yield_, ready()).WillOnce(Invoke([&]() {
+    time_system.advanceTimeWait(std::chrono::microseconds(10));
+  }));
+  cr->start(function_ref, 1, yield_callback_);
+  EXPECT_EQ(cr->state(), Coroutine::State::Yielded);
+  EXPECT_EQ(std::chrono::microseconds(5), cr->executionTime());
+  EXPECT_GT(cr->heapGrowthBytes(), 1000);
+
+  cr->resume(0, yield_callback_);
+  EXPECT_EQ(cr->state(), Coroutine::State::Finished);
+  EXPECT_EQ(std::chrono::microseconds(5), cr->executionTime());
+
+  EXPECT_CALL(*ref.get(), onDestroy());
+  ref.reset();
+  state_->runtimeGC();
+}
+
 class ThreadSafeTest : public testing::Test {
 public:
   ThreadSafeTest()
@@ -9,6 +9,7 @@
 #include "test/mocks/protobuf/mocks.h"
 #include "test/mocks/runtime/mocks.h"
 #include "test/mocks/server/factory_context.h"
+#include "test/mocks/server/overload_manager.h"
 #include "test/mocks/stats/mocks.h"
 #include "test/mocks/stream_info/mocks.h"
 #include "test/test_common/utility.h"
@@ -25,6 +26,7 @@ namespace {
 using envoy::extensions::filters::http::compressor::v3::CompressorPerRoute;
 using testing::NiceMock;
 using testing::Return;
+using testing::ReturnRef;
 
 class TestCompressorFactory : public Envoy::Compression::Compressor::CompressorFactory {
 public:
@@ -36,13 +38,19 @@ public:
     EXPECT_CALL(*compressor, compress(_, _)).Times(expected_compress_calls_);
     return compressor;
   }
+  Envoy::Compression::Compressor::CompressorPtr createCompressorWithEffort(double effort) override {
+    last_effort_ = effort;
+    return createCompressor();
+  }
   const std::string& statsPrefix() const override { CONSTRUCT_ON_FIRST_USE(std::string, "test."); }
   const std::string& contentEncoding() const override { return content_encoding_; }
 
   void setExpectedCompressCalls(uint32_t calls) { expected_compress_calls_ = calls; }
+  double lastEffort() const { return last_effort_; }
 
 private:
   uint32_t expected_compress_calls_{1};
+  double last_effort_{1.0};
   const std::string content_encoding_;
 };
 
@@ -73,7 +81,8 @@ public:
     auto compressor_factory = std::make_unique<TestCompressorFactory>("test");
     compressor_factory_ = compressor_factory.get();
     config_ = std::make_shared<CompressorFilterConfig>(compressor, "test.", *stats_.rootScope(),
-                                                       runtime_, std::move(compressor_factory));
+                                                       runtime_, std::move(compressor_factory),
+                                                       overload_manager_);
     filter_ = std::make_unique<CompressorFilter>(config_);
     filter_->setDecoderFilterCallbacks(decoder_callbacks_);
     filter_->setEncoderFilterCallbacks(encoder_callbacks_);
@@ -187,6 +196,7 @@ public:
   std::string response_stats_prefix_;
   Stats::TestUtil::TestStore stats_;
   NiceMock<Runtime::MockLoader> runtime_;
+  NiceMock<Server::MockOverloadManager> overload_manager_;
   NiceMock<Http::MockStreamDecoderFilterCallbacks> decoder_callbacks_;
   NiceMock<Http::MockStreamEncoderFilterCallbacks> encoder_callbacks_;
   NiceMock<StreamInfo::MockStreamInfo> stream_info_;
@@ -1319,6 +1329,103 @@ TEST_F(CompressorFilterTest, StrongEtagLengthTwoRemovedWhenCompressing) {
   EXPECT_FALSE(headers.has("etag"));
 }
 
+// Without adaptive_effort the overload state is not consulted and the configured level is used.
+TEST_F(CompressorFilterTest, AdaptiveEffortNotConfigured) {
+  const Server::OverloadActionState saturated = Server::OverloadActionState::saturated();
+  ON_CALL(overload_manager_.overload_state_,
+          getState(Server::OverloadActionNames::get().ReduceCompressionEffort))
+      .WillByDefault(ReturnRef(saturated));
+  doRequestNoCompression({{":method", "get"}, {"accept-encoding", "test"}});
+  Http::TestResponseHeaderMapImpl headers{{":method", "get"}, {"content-length", "256"}};
+  doResponseCompression(headers, false);
+  EXPECT_EQ(1.0, compressor_factory_->lastEffort());
+}
+
+// The compression effort follows the reduce_compression_effort overload action.
+TEST_F(CompressorFilterTest, AdaptiveEffortFollowsOverloadState) {
+  setUpFilter(R"EOF(
+{
+  "response_direction_config": {
+    "common_config": {
+      "adaptive_effort": {}
+    }
+  },
+  "compressor_library": {
+     "name": "test",
+     "typed_config": {
+       "@type": "type.googleapis.com/envoy.extensions.compression.gzip.compressor.v3.Gzip"
+     }
+  }
+}
+)EOF");
+  response_stats_prefix_ = "response.";
+  const Server::OverloadActionState scaled(UnitFloat(0.25));
+  ON_CALL(overload_manager_.overload_state_,
+          getState(Server::OverloadActionNames::get().ReduceCompressionEffort))
+      .WillByDefault(ReturnRef(scaled));
+  doRequestNoCompression({{":method", "get"}, {"accept-encoding", "test"}});
+  Http::TestResponseHeaderMapImpl headers{{":method", "get"}, {"content-length", "256"}};
+  doResponseCompression(headers, false);
+  EXPECT_FLOAT_EQ(0.75, compressor_factory_->lastEffort());
+  EXPECT_EQ(1, stats_.counter("test.compressor.test.test.response.reduced_effort").value());
+}
+
+// Messages smaller than adaptive_effort.min_content_length keep the configured level.
+TEST_F(CompressorFilterTest, AdaptiveEffortSkipsSmallMessages) {
+  setUpFilter(R"EOF(
+{
+  "request_direction_config": {
+    "common_config": {
+      "adaptive_effort": {
+        "min_content_length": 1024
+      }
+    }
+  },
+  "compressor_library": {
+     "name": "test",
+     "typed_config": {
+       "@type": "type.googleapis.com/envoy.extensions.compression.gzip.compressor.v3.Gzip"
+     }
+  }
+}
+)EOF");
+  const Server::OverloadActionState saturated = Server::OverloadActionState::saturated();
+  ON_CALL(overload_manager_.overload_state_,
+          getState(Server::OverloadActionNames::get().ReduceCompressionEffort))
+      .WillByDefault(ReturnRef(saturated));
+  doRequestCompression({{":method", "post"}, {"content-length", "256"}}, false);
+  EXPECT_EQ(1.0, compressor_factory_->lastEffort());
+  EXPECT_EQ(0, stats_.counter("test.compressor.test.test.request.reduced_effort").value());
+}
+
+// Messages without a Content-Length header are treated as large.
+TEST_F(CompressorFilterTest, AdaptiveEffortNoContentLength) {
+  setUpFilter(R"EOF(
+{
+  "request_direction_config": {
+    "common_config": {
+      "adaptive_effort": {
+        "min_content_length": 1024
+      }
+    }
+  },
+  "compressor_library": {
+     "name": "test",
+     "typed_config": {
+       "@type": "type.googleapis.com/envoy.extensions.compression.gzip.compressor.v3.Gzip"
+     }
+  }
+}
+)EOF");
+  const Server::OverloadActionState saturated = Server::OverloadActionState::saturated();
+  ON_CALL(overload_manager_.overload_state_,
+          getState(Server::OverloadActionNames::get().ReduceCompressionEffort))
+      .WillByDefault(ReturnRef(saturated));
+  doRequestCompression({{":method", "post"}}, false);
+  EXPECT_EQ(0.0, compressor_factory_->lastEffort());
+  EXPECT_EQ(1, stats_.counter("test.compressor.test.test.request.reduced_effort").value());
+}
+
 // Tests for weaken_etag_on_compress: when true, strong ETags are weakened (W/ prefix) instead of
 // removed.
 TEST_F(CompressorFilterTest, WeakenEtagOnCompressStrongEtag) {
@@ -0,0 +1,90 @@
+// Measures the request rate of a small Lua script that touches request and response headers, with
+// and without coroutine pooling and incremental GC steps. For example:
+//
+//   bazel run -c opt //test/extensions/filters/http/lua:lua_filter_speed_test
+//
+// Throughput is reported as items_per_second, where an item is one request/response pair.
+
+#include "envoy/extensions/filters/http/lua/v3/lua.pb.h"
+
+#include "source/common/stats/isolated_store_impl.h"
+#include "source/extensions/filters/http/lua/lua_filter.h"
+
+#include "test/mocks/api/mocks.h"
+#include "test/mocks/http/mocks.h"
+#include "test/mocks/thread_local/mocks.h"
+#include "test/mocks/upstream/cluster_manager.h"
+#include "test/test_common/test_time.h"
+#include "test/test_common/utility.h"
+
+#include "benchmark/benchmark.h"
+#include "gmock/gmock.h"
+
+using testing::NiceMock;
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Lua {
+
+constexpr absl::string_view Script = R"EOF(
+  function envoy_on_request(request_handle)
+    local headers = request_handle:headers()
+    local parts = {}
+    for word in string.gmatch(headers:get(":path"), "[^/]+") do
+      parts[#parts + 1] = word
+    end
+    headers:add("x-path-depth", tostring(#parts))
+  end
+
+  function envoy_on_response(response_handle)
+    response_handle:headers():add("x-lua", "1")
+  end
+)EOF";
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void luaRequests(benchmark::State& state) {
+  NiceMock<ThreadLocal::MockInstance> tls;
+  NiceMock<Upstream::MockClusterManager> cluster_manager;
+  NiceMock<Api::MockApi> api;
+  Stats::IsolatedStoreImpl stats_store;
+  Event::TestRealTimeSystem time_system;
+
+  envoy::extensions::filters::http::lua::v3::Lua proto_config;
+  proto_config.mutable_default_source_code()->set_inline_string(std::string(Script));
+  proto_config.mutable_runtime()->set_coroutine_pool_size(state.range(0));
+  proto_config.mutable_runtime()->set_gc_step_size_kb(state.range(1));
+  proto_config.mutable_runtime()->set_execution_stats(state.range(2) != 0);
+  auto config = std::make_shared<FilterConfig>(proto_config, tls, cluster_manager, api,
+                                               *stats_store.rootScope(), "bench.");
+
+  NiceMock<Http::MockStreamDecoderFilterCallbacks> decoder_callbacks;
+  NiceMock<Http::MockStreamEncoderFilterCallbacks> encoder_callbacks;
+
+  for (auto _ : state) { // NOLINT
+    Filter filter(config, time_system);
+    filter.setDecoderFilterCallbacks(decoder_callbacks);
+    filter.setEncoderFilterCallbacks(encoder_callbacks);
+
+    Http::TestRequestHeaderMapImpl request_headers{{":path", "/api/v1/users/1234"}};
+    filter.decodeHeaders(request_headers, true);
+    Http::TestResponseHeaderMapImpl response_headers{{":status", "200"}};
+    filter.encodeHeaders(response_headers, true);
+    filter.onDestroy();
+  }
+
+  state.SetItemsProcessed(state.iterations());
+  state.counters["lua_heap_kb"] = config->perLuaCodeSetup()->runtimeBytesUsed() / 1024.0;
+}
+BENCHMARK(luaRequests)
+    ->ArgNames({"pool", "gc_step_kb", "stats"})
+    ->Args({0, 0, 0})
+    ->Args({128, 0, 0})
+    ->Args({0, 8, 0})
+    ->Args({128, 8, 0})
+    ->Args({128, 8, 1});
+
+} // namespace Lua
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -5,6 +5,7 @@
 #include "envoy/data/core/v3/tlv_metadata.pb.h"
 
 #include "source/common/buffer/buffer_impl.h"
+#include "source/common/common/hash.h"
 #include "source/common/http/message_impl.h"
 #include "source/common/stream_info/stream_info_impl.h"
 #include "source/extensions/filters/http/lua/lua_filter.h"
@@ -4499,6 +4500,123 @@ TEST_F(LuaHttpFilterTest, GetRouteFromHandleNoRoute) {
   EXPECT_EQ(2, stats_store_.counter("test.lua.executions").value());
 }
 
+// Finished coroutines are returned to the per-worker pool when the filter is destroyed and reused
+// by the next stream.
+TEST_F(LuaHttpFilterTest, CoroutinePool) {
+  envoy::extensions::filters::http::lua::v3::Lua proto_config;
+  proto_config.mutable_default_source_code()->set_inline_string(HEADER_ONLY_SCRIPT);
+  proto_config.mutable_runtime()->set_coroutine_pool_size(1);
+  proto_config.mutable_runtime()->set_gc_step_size_kb(16);
+  setupConfig(proto_config, {});
+  PerLuaCodeSetup* setup = config_->perLuaCodeSetup();
+
+  for (int i = 0; i < 3; ++i) {
+    // Replacing the filter releases the coroutine of the previous stream.
+    setupFilter();
+    EXPECT_EQ(i == 0 ? 0 : 1, setup->pooledCoroutines());
+    Http::TestRequestHeaderMapImpl request_headers{{":path", "/"}};
+    EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(request_headers, true));
+    EXPECT_EQ(0, setup->pooledCoroutines());
+    filter_->onDestroy();
+  }
+
+  setupFilter();
+  EXPECT_EQ(1, setup->pooledCoroutines());
+  EXPECT_EQ(0, stats_store_.counter("test.lua.errors").value());
+  EXPECT_EQ(3, stats_store_.counter("test.lua.executions").value());
+}
+
+// A coroutine that failed is not pooled.
+TEST_F(LuaHttpFilterTest, CoroutinePoolSkipsFailedScripts) {
+  const std::string SCRIPT{R"EOF(
+    function envoy_on_request(request_handle)
+      error("boom")
+    end
+  )EOF"};
+
+  envoy::extensions::filters::http::lua::v3::Lua proto_config;
+  proto_config.mutable_default_source_code()->set_inline_string(SCRIPT);
+  proto_config.mutable_runtime()->set_coroutine_pool_size(1);
+  setupConfig(proto_config, {});
+  setupFilter();
+
+  Http::TestRequestHeaderMapImpl request_headers{{":path", "/"}};
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(request_headers, true));
+  filter_->onDestroy();
+  setupFilter();
+  EXPECT_EQ(0, config_->perLuaCodeSetup()->pooledCoroutines());
+  EXPECT_EQ(1, stats_store_.counter("test.lua.errors").value());
+}
+
+// Returns the name of a per-script stat.
+std::string scriptStatName(const std::string& lua_code, absl::string_view stat) {
+  return absl::StrCat("lua.script.", absl::Hex(HashUtil::xxHash64(lua_code), absl::kZeroPad16),
+                      ".", stat);
+}
+
+// Execution time and heap growth are only recorded when enabled.
+TEST_F(LuaHttpFilterTest, ExecutionStats) {
+  const std::string execution_time = scriptStatName(HEADER_ONLY_SCRIPT, "execution_time");
+  const std::string heap_growth = scriptStatName(HEADER_ONLY_SCRIPT, "heap_growth");
+  {
+    setup(HEADER_ONLY_SCRIPT);
+    Http::TestRequestHeaderMapImpl request_headers{{":path", "/"}};
+    EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(request_headers, true));
+    filter_->onDestroy();
+    EXPECT_FALSE(stats_store_.histogramRecordedValues(execution_time));
+    EXPECT_FALSE(stats_store_.histogramRecordedValues(heap_growth));
+  }
+
+  envoy::extensions::filters::http::lua::v3::Lua proto_config;
+  proto_config.mutable_default_source_code()->set_inline_string(HEADER_ONLY_SCRIPT);
+  proto_config.mutable_runtime()->set_execution_stats(true);
+  setupConfig(proto_config, {});
+  setupFilter();
+
+  Http::TestRequestHeaderMapImpl request_headers{{":path", "/"}};
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(request_headers, true));
+  filter_->onDestroy();
+  EXPECT_EQ(1, stats_store_.histogramValues(execution_time, false).size());
+  EXPECT_EQ(1, stats_store_.histogramValues(heap_growth, false).size());
+
+  // Replace the filter so that the fixture does not destroy it a second time.
+  setupFilter();
+}
+
+// Filters running the same script record into the same execution stats, whatever their stat
+// prefix.
+TEST_F(LuaHttpFilterTest, ExecutionStatsPerScript) {
+  envoy::extensions::filters::http::lua::v3::Lua proto_config;
+  proto_config.mutable_default_source_code()->set_inline_string(HEADER_ONLY_SCRIPT);
+  proto_config.mutable_runtime()->set_execution_stats(true);
+  for (const char* stat_prefix : {"foo", "bar"}) {
+    proto_config.set_stat_prefix(stat_prefix);
+    setupConfig(proto_config, {});
+    setupFilter();
+    Http::TestRequestHeaderMapImpl request_headers{{":path", "/"}};
+    EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(request_headers, true));
+    filter_->onDestroy();
+  }
+  EXPECT_EQ(1, stats_store_.counter("test.lua.foo.executions").value());
+  EXPECT_EQ(1, stats_store_.counter("test.lua.bar.executions").value());
+  EXPECT_EQ(2, stats_store_.histogramValues(scriptStatName(HEADER_ONLY_SCRIPT, "execution_time"),
+                                            false)
+                   .size());
+
+  // A different script records into its own stats.
+  const std::string other_script = absl::StrCat(HEADER_ONLY_SCRIPT, "\n-- other\n");
+  proto_config.mutable_default_source_code()->set_inline_string(other_script);
+  setupConfig(proto_config, {});
+  setupFilter();
+  Http::TestRequestHeaderMapImpl request_headers{{":path", "/"}};
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(request_headers, true));
+  filter_->onDestroy();
+  EXPECT_EQ(1, stats_store_.histogramValues(scriptStatName(other_script, "execution_time"), false)
+                   .size());
+
+  setupFilter();
+}
+
 } // namespace
 } // namespace Lua
 } // namespace HttpFilters
@@ -3969,6 +3969,46 @@ http_filters:
   EXPECT_TRUE(http_ports.contains(8080));
 }
 
+TEST_F(HttpConnectionManagerConfigTest, FilterInstrumentation) {
+  const std::string yaml_string = R"EOF(
+stat_prefix: router
+route_config:
+  name: local_route
+filter_instrumentation:
+  sampling_interval: 10
+http_filters:
+- name: envoy.filters.http.router
+  typed_config:
+    "@type": type.googleapis.com/envoy.extensions.filters.http.router.v3.Router
+  )EOF";
+
+  HttpConnectionManagerConfig config(parseHttpConnectionManagerFromYaml(yaml_string), context_,
+                                     date_provider_, route_config_provider_manager_,
+                                     &scoped_routes_config_provider_manager_, tracer_manager_,
+                                     filter_config_provider_manager_, creation_status_);
+  EXPECT_TRUE(creation_status_.ok());
+  EXPECT_NE(nullptr, config.filterInstrumentation());
+}
+
+TEST_F(HttpConnectionManagerConfigTest, FilterInstrumentationNotConfigured) {
+  const std::string yaml_string = R"EOF(
+stat_prefix: router
+route_config:
+  name: local_route
+http_filters:
+- name: envoy.filters.http.router
+  typed_config:
+    "@type": type.googleapis.com/envoy.extensions.filters.http.router.v3.Router
+  )EOF";
+
+  HttpConnectionManagerConfig config(parseHttpConnectionManagerFromYaml(yaml_string), context_,
+                                     date_provider_, route_config_provider_manager_,
+                                     &scoped_routes_config_provider_manager_, tracer_manager_,
+                                     filter_config_provider_manager_, creation_status_);
+  EXPECT_TRUE(creation_status_.ok());
+  EXPECT_EQ(nullptr, config.filterInstrumentation());
+}
+
 // Test empty forward_proto_config is valid (feature disabled).
 TEST_F(HttpConnectionManagerConfigTest, ForwardProtoConfigEmpty) {
   const std::string yaml_string = R"EOF(
@@ -0,0 +1,57 @@
+#include "envoy/config/core/v3/extension.pb.h"
+
+#include "source/extensions/load_balancing_policies/least_latency/config.h"
+
+#include "test/mocks/server/factory_context.h"
+#include "test/mocks/upstream/cluster_info.h"
+#include "test/mocks/upstream/priority_set.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace LoadBalancingPolicies {
+namespace LeastLatency {
+namespace {
+
+TEST(LeastLatencyConfigTest, ValidateFail) {
+  NiceMock<Server::Configuration::MockServerFactoryContext> context;
+  NiceMock<Upstream::MockClusterInfo> cluster_info;
+  NiceMock<Upstream::MockPrioritySet> main_thread_priority_set;
+  NiceMock<Upstream::MockPrioritySet> thread_local_priority_set;
+
+  envoy::config::core::v3::TypedExtensionConfig config;
+  config.set_name("envoy.load_balancing_policies.least_latency");
+  LeastLatencyLbProto config_msg;
+  config.mutable_typed_config()->PackFrom(config_msg);
+
+  auto& factory = Config::Utility::getAndCheckFactory<Upstream::TypedLoadBalancerFactory>(config);
+  EXPECT_EQ("envoy.load_balancing_policies.least_latency", factory.name());
+
+  auto lb_config = factory.loadConfig(context, *factory.createEmptyConfigProto()).value();
+
+  auto thread_aware_lb =
+      factory.create(*lb_config, cluster_info, main_thread_priority_set, context.runtime_loader_,
+                     context.api_.random_, context.time_system_);
+  EXPECT_NE(nullptr, thread_aware_lb);
+
+  ASSERT_TRUE(thread_aware_lb->initialize().ok());
+
+  auto thread_local_lb_factory = thread_aware_lb->factory();
+  EXPECT_NE(nullptr, thread_local_lb_factory);
+
+  auto thread_local_lb = thread_local_lb_factory->create({thread_local_priority_set, nullptr});
+  EXPECT_NE(nullptr, thread_local_lb);
+}
+
+TEST(LeastLatencyConfigTest, Defaults) {
+  Upstream::LeastLatencyLbConfig lb_config{LeastLatencyLbProto()};
+  EXPECT_EQ(std::chrono::seconds(10), lb_config.decay_time_);
+  EXPECT_EQ(std::chrono::milliseconds(10), lb_config.default_latency_);
+  EXPECT_EQ(std::chrono::seconds(1), lb_config.failure_latency_);
+  EXPECT_EQ(2, lb_config.choice_count_);
+}
+
+} // namespace
+} // namespace LeastLatency
+} // namespace LoadBalancingPolicies
+} // namespace Extensions
+} // namespace Envoy
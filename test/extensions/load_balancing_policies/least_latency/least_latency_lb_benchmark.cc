@@ -0,0 +1,160 @@
+// Note: this should be run with --compilation_mode=opt.
+//
+// Simulates a cluster in which some of the hosts are slower than the others, in simulated time,
+// and reports the latency of the requests when they are balanced by the least request and the
+// least latency load balancers. The latency of a request is drawn from an exponential distribution
+// whose mean grows with the number of requests active on the host. The reported time is that of
+// the simulation itself, the counters are the results:
+//   p50_latency_us, p99_latency_us, p999_latency_us: the percentiles of the request latency.
+//   slow_host_share: the fraction of the requests sent to the slow hosts.
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <queue>
+#include <random>
+#include <vector>
+
+#include "source/extensions/load_balancing_policies/least_latency/least_latency_lb.h"
+#include "source/extensions/load_balancing_policies/least_request/least_request_lb.h"
+
+#include "test/benchmark/main.h"
+#include "test/extensions/load_balancing_policies/common/benchmark_base_tester.h"
+
+namespace Envoy {
+namespace Upstream {
+namespace {
+
+constexpr uint32_t NumHosts = 10;
+constexpr uint32_t NumSlowHosts = 2;
+constexpr double FastHostLatencyUs = 1000;
+constexpr double SlowHostLatencyUs = 5000;
+// The increase of the mean latency of a host per request active on it.
+constexpr double LatencyPerActiveRequest = 0.1;
+constexpr std::chrono::microseconds Step{100};
+constexpr std::chrono::seconds SimulationDuration{2};
+
+class LatencySimulationTester : public BaseTester {
+public:
+  LatencySimulationTester(bool least_latency) : BaseTester(NumHosts) {
+    if (least_latency) {
+      lb_config_ = std::make_unique<LeastLatencyLbConfig>(LeastLatencyLbProto());
+      thread_aware_lb_ = std::make_unique<LeastLatencyLoadBalancer>(
+          *lb_config_, *info_, priority_set_, runtime_, random_, simTime());
+      RELEASE_ASSERT(thread_aware_lb_->initialize().ok(), "");
+      lb_ = thread_aware_lb_->factory()->create(lb_params_);
+    } else {
+      lb_ = std::make_unique<LeastRequestLoadBalancer>(
+          priority_set_, &local_priority_set_, stats_, runtime_, random_, 50,
+          envoy::extensions::load_balancing_policies::least_request::v3::LeastRequest(),
+          simTime());
+    }
+    const HostVector& hosts = priority_set_.hostSetsPerPriority()[0]->hosts();
+    for (uint32_t i = 0; i < NumSlowHosts; ++i) {
+      slow_hosts_.push_back(hosts[i].get());
+    }
+  }
+
+  // Sends the given number of requests per step for the duration of the simulation, and collects
+  // the latency of each request once it completes.
+  void run(uint32_t requests_per_step) {
+    std::mt19937_64 generator(1);
+    std::exponential_distribution<double> service_time;
+    for (auto elapsed = std::chrono::microseconds(0);
+         elapsed < SimulationDuration || !running_.empty(); elapsed += Step) {
+      completeRequests();
+      if (elapsed >= SimulationDuration) {
+        simTime().advanceTimeWait(Step);
+        continue;
+      }
+      const MonotonicTime now = simTime().monotonicTime();
+      for (uint32_t i = 0; i < requests_per_step; ++i) {
+        HostConstSharedPtr host = lb_->chooseHost(nullptr).host;
+        const bool slow =
+            std::find(slow_hosts_.begin(), slow_hosts_.end(), host.get()) != slow_hosts_.end();
+        slow_requests_ += slow;
+        const double mean_us = (slow ? SlowHostLatencyUs : FastHostLatencyUs) *
+                               (1 + LatencyPerActiveRequest * host->stats().rq_active_.value());
+        const auto latency =
+            std::chrono::microseconds(static_cast<int64_t>(mean_us * service_time(generator)));
+        host->stats().rq_active_.inc();
+        running_.push({now + latency, latency, std::move(host)});
+      }
+      simTime().advanceTimeWait(Step);
+    }
+  }
+
+  double slowHostShare() const {
+    return latencies_us_.empty() ? 0 : static_cast<double>(slow_requests_) / latencies_us_.size();
+  }
+
+  std::vector<double> latencies_us_;
+
+private:
+  struct RunningRequest {
+    MonotonicTime completion_time_;
+    std::chrono::microseconds latency_;
+    HostConstSharedPtr host_;
+
+    bool operator>(const RunningRequest& other) const {
+      return completion_time_ > other.completion_time_;
+    }
+  };
+
+  // Completes the requests whose latency has elapsed, and reports it as the router would.
+  void completeRequests() {
+    const MonotonicTime now = simTime().monotonicTime();
+    while (!running_.empty() && running_.top().completion_time_ <= now) {
+      const RunningRequest& request = running_.top();
+      request.host_->stats().rq_active_.dec();
+      for (size_t i = 0; i < request.host_->lbPolicyDataCount(); ++i) {
+        request.host_->lbPolicyDataAt(i)->onUpstreamResponseLatency(request.latency_, now);
+      }
+      latencies_us_.push_back(request.latency_.count());
+      running_.pop();
+    }
+  }
+
+  std::unique_ptr<LeastLatencyLbConfig> lb_config_;
+  ThreadAwareLoadBalancerPtr thread_aware_lb_;
+  LoadBalancerPtr lb_;
+  std::vector<const Host*> slow_hosts_;
+  std::priority_queue<RunningRequest, std::vector<RunningRequest>, std::greater<>> running_;
+  uint64_t slow_requests_{};
+};
+
+double percentile(std::vector<double>& values, double fraction) {
+  if (values.empty()) {
+    return 0;
+  }
+  auto nth = values.begin() + static_cast<size_t>(fraction * (values.size() - 1));
+  std::nth_element(values.begin(), nth, values.end());
+  return *nth;
+}
+
+// Runs the simulation with the least request load balancer for mode 0, and with the least latency
+// load balancer for mode 1, at a number of requests per 100us.
+void benchmarkLatencySimulation(::benchmark::State& state) {
+  const bool least_latency = state.range(0) == 1;
+  const uint32_t requests_per_step = state.range(1);
+
+  std::vector<double> latencies_us;
+  double slow_host_share = 0;
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    LatencySimulationTester tester(least_latency);
+    tester.run(requests_per_step);
+    slow_host_share = tester.slowHostShare();
+    latencies_us = std::move(tester.latencies_us_);
+  }
+  state.counters["p50_latency_us"] = percentile(latencies_us, 0.5);
+  state.counters["p99_latency_us"] = percentile(latencies_us, 0.99);
+  state.counters["p999_latency_us"] = percentile(latencies_us, 0.999);
+  state.counters["slow_host_share"] = slow_host_share;
+}
+BENCHMARK(benchmarkLatencySimulation)
+    ->ArgsProduct({{0, 1}, {1, 4}})
+    ->Unit(::benchmark::kMillisecond);
+
+} // namespace
+} // namespace Upstream
+} // namespace Envoy
@@ -0,0 +1,216 @@
+#include <chrono>
+#include <cmath>
+#include <memory>
+
+#include "source/extensions/load_balancing_policies/least_latency/config.h"
+#include "source/extensions/load_balancing_policies/least_latency/least_latency_lb.h"
+
+#include "test/extensions/load_balancing_policies/common/load_balancer_impl_base_test.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Upstream {
+namespace {
+
+using testing::Return;
+
+class LeastLatencyHostLbPolicyDataTest : public testing::Test {
+protected:
+  // A decay time of 10s, a default latency of 10ms and a failure latency of 1s.
+  const LeastLatencyLbConfig lb_config_{LeastLatencyLbProto()};
+  LeastLatencyHostLbPolicyData data_{lb_config_};
+  const MonotonicTime now_{std::chrono::seconds(1)};
+};
+
+TEST_F(LeastLatencyHostLbPolicyDataTest, NoSamples) {
+  EXPECT_FALSE(data_.latency(now_).has_value());
+}
+
+TEST_F(LeastLatencyHostLbPolicyDataTest, FirstSampleSetsAverage) {
+  data_.onUpstreamResponseLatency(std::chrono::microseconds(500), now_);
+  EXPECT_DOUBLE_EQ(500, data_.latency(now_).value());
+}
+
+TEST_F(LeastLatencyHostLbPolicyDataTest, PeakSampleReplacesAverage) {
+  data_.onUpstreamResponseLatency(std::chrono::microseconds(500), now_);
+  data_.onUpstreamResponseLatency(std::chrono::microseconds(5000), now_ + std::chrono::seconds(1));
+  EXPECT_DOUBLE_EQ(5000, data_.latency(now_ + std::chrono::seconds(1)).value());
+}
+
+TEST_F(LeastLatencyHostLbPolicyDataTest, LowerSampleIsWeightedByElapsedTime) {
+  data_.onUpstreamResponseLatency(std::chrono::microseconds(1000), now_);
+
+  // A sample at the same time as the previous one does not move the average.
+  data_.onUpstreamResponseLatency(std::chrono::microseconds(100), now_);
+  EXPECT_DOUBLE_EQ(1000, data_.latency(now_).value());
+
+  // After one decay time, the previous average keeps a weight of 1/e.
+  const MonotonicTime later = now_ + std::chrono::seconds(10);
+  data_.onUpstreamResponseLatency(std::chrono::microseconds(100), later);
+  const double weight = std::exp(-1.0);
+  EXPECT_DOUBLE_EQ(1000 * weight + 100 * (1 - weight), data_.latency(later).value());
+}
+
+// Without new samples the average decays towards the default latency, from above for a host which
+// was slow and from below for a host which was fast.
+TEST_F(LeastLatencyHostLbPolicyDataTest, AverageDecaysWithoutSamples) {
+  data_.onUpstreamResponseLatency(std::chrono::microseconds(50000), now_);
+  EXPECT_DOUBLE_EQ(10000 + 40000 * std::exp(-2.0),
+                   data_.latency(now_ + std::chrono::seconds(20)).value());
+  // A time before the last sample does not move the average.
+  EXPECT_DOUBLE_EQ(50000, data_.latency(now_ - std::chrono::seconds(1)).value());
+
+  LeastLatencyHostLbPolicyData fast_data(lb_config_);
+  fast_data.onUpstreamResponseLatency(std::chrono::microseconds(1000), now_);
+  EXPECT_DOUBLE_EQ(10000 - 9000 * std::exp(-2.0),
+                   fast_data.latency(now_ + std::chrono::seconds(20)).value());
+}
+
+// A request which fails without a response counts as a response with the failure latency, or the
+// time it took to fail if longer.
+TEST_F(LeastLatencyHostLbPolicyDataTest, FailureCountsAsFailureLatency) {
+  data_.onUpstreamResponseLatency(std::chrono::microseconds(1000), now_);
+  data_.onUpstreamRequestFailure(std::chrono::microseconds(0), now_);
+  EXPECT_DOUBLE_EQ(1000000, data_.latency(now_).value());
+
+  data_.onUpstreamRequestFailure(std::chrono::seconds(2), now_);
+  EXPECT_DOUBLE_EQ(2000000, data_.latency(now_).value());
+}
+
+class LeastLatencyLoadBalancerTest : public LoadBalancerTestBase {
+public:
+  void init() {
+    lb_config_ = std::make_unique<LeastLatencyLbConfig>(config_);
+    thread_aware_lb_ = std::make_unique<LeastLatencyLoadBalancer>(
+        *lb_config_, *info_, priority_set_, runtime_, random_, simTime());
+    ASSERT_TRUE(thread_aware_lb_->initialize().ok());
+    lb_ = thread_aware_lb_->factory()->create({priority_set_, nullptr});
+  }
+
+  void addHosts() {
+    hostSet().healthy_hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:80"),
+                                makeTestHost(info_, "tcp://127.0.0.1:81")};
+    hostSet().hosts_ = hostSet().healthy_hosts_;
+    hostSet().runCallbacks(hostSet().hosts_, {});
+  }
+
+  void reportLatency(const HostSharedPtr& host, std::chrono::microseconds latency) {
+    auto data = host->typedLbPolicyData<LeastLatencyHostLbPolicyData>();
+    ASSERT_TRUE(data.has_value());
+    data->onUpstreamResponseLatency(latency, simTime().monotonicTime());
+  }
+
+  void reportFailure(const HostSharedPtr& host) {
+    auto data = host->typedLbPolicyData<LeastLatencyHostLbPolicyData>();
+    ASSERT_TRUE(data.has_value());
+    data->onUpstreamRequestFailure(std::chrono::microseconds(0), simTime().monotonicTime());
+  }
+
+  LeastLatencyLbProto config_;
+  std::unique_ptr<LeastLatencyLbConfig> lb_config_;
+  ThreadAwareLoadBalancerPtr thread_aware_lb_;
+  LoadBalancerPtr lb_;
+};
+
+TEST_P(LeastLatencyLoadBalancerTest, NoHosts) {
+  init();
+
+  EXPECT_EQ(nullptr, lb_->peekAnotherHost(nullptr));
+  EXPECT_EQ(nullptr, lb_->chooseHost(nullptr).host);
+}
+
+TEST_P(LeastLatencyLoadBalancerTest, LbPolicyDataAddedToHosts) {
+  hostSet().hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:80")};
+  init();
+  EXPECT_TRUE(hostSet().hosts_[0]->typedLbPolicyData<LeastLatencyHostLbPolicyData>().has_value());
+
+  addHosts();
+  for (const auto& host : hostSet().hosts_) {
+    EXPECT_TRUE(host->typedLbPolicyData<LeastLatencyHostLbPolicyData>().has_value());
+    EXPECT_EQ(1, host->lbPolicyDataCount());
+  }
+}
+
+TEST_P(LeastLatencyLoadBalancerTest, PicksLowerLatency) {
+  init();
+  addHosts();
+  reportLatency(hostSet().healthy_hosts_[0], std::chrono::microseconds(5000));
+  reportLatency(hostSet().healthy_hosts_[1], std::chrono::microseconds(1000));
+
+  EXPECT_CALL(random_, random()).WillOnce(Return(0)).WillOnce(Return(1));
+  EXPECT_EQ(hostSet().healthy_hosts_[1], lb_->chooseHost(nullptr).host);
+
+  EXPECT_CALL(random_, random()).WillOnce(Return(1)).WillOnce(Return(0));
+  EXPECT_EQ(hostSet().healthy_hosts_[1], lb_->chooseHost(nullptr).host);
+}
+
+TEST_P(LeastLatencyLoadBalancerTest, ActiveRequestsScaleCost) {
+  init();
+  addHosts();
+  reportLatency(hostSet().healthy_hosts_[0], std::chrono::microseconds(2000));
+  reportLatency(hostSet().healthy_hosts_[1], std::chrono::microseconds(1000));
+
+  // 2000us * 1 is cheaper than 1000us * 3.
+  hostSet().healthy_hosts_[1]->stats().rq_active_.set(2);
+  EXPECT_CALL(random_, random()).WillOnce(Return(0)).WillOnce(Return(1));
+  EXPECT_EQ(hostSet().healthy_hosts_[0], lb_->chooseHost(nullptr).host);
+}
+
+TEST_P(LeastLatencyLoadBalancerTest, DefaultLatencyWithoutSamples) {
+  config_.mutable_default_latency()->set_seconds(1);
+  init();
+  addHosts();
+  reportLatency(hostSet().healthy_hosts_[1], std::chrono::milliseconds(100));
+
+  // The host without samples is assumed to take 1s.
+  EXPECT_CALL(random_, random()).WillOnce(Return(0)).WillOnce(Return(1));
+  EXPECT_EQ(hostSet().healthy_hosts_[1], lb_->chooseHost(nullptr).host);
+}
+
+TEST_P(LeastLatencyLoadBalancerTest, SlowHostRecoversAfterDecay) {
+  config_.mutable_decay_time()->set_seconds(1);
+  init();
+  addHosts();
+  reportLatency(hostSet().healthy_hosts_[0], std::chrono::milliseconds(100));
+
+  // Without new samples the average of the slow host decays towards the default latency of 10ms,
+  // below that of a host which has just responded in 20ms, so that the slow host is tried again.
+  simTime().advanceTimeWait(std::chrono::seconds(5));
+  reportLatency(hostSet().healthy_hosts_[1], std::chrono::milliseconds(20));
+  EXPECT_CALL(random_, random()).WillOnce(Return(1)).WillOnce(Return(0));
+  EXPECT_EQ(hostSet().healthy_hosts_[0], lb_->chooseHost(nullptr).host);
+}
+
+// A host whose requests fail without a response is avoided, like a slow host.
+TEST_P(LeastLatencyLoadBalancerTest, FailingHostIsAvoided) {
+  init();
+  addHosts();
+  reportLatency(hostSet().healthy_hosts_[0], std::chrono::microseconds(1000));
+  reportLatency(hostSet().healthy_hosts_[1], std::chrono::microseconds(2000));
+
+  reportFailure(hostSet().healthy_hosts_[0]);
+  EXPECT_CALL(random_, random()).WillOnce(Return(0)).WillOnce(Return(1));
+  EXPECT_EQ(hostSet().healthy_hosts_[1], lb_->chooseHost(nullptr).host);
+}
+
+TEST_P(LeastLatencyLoadBalancerTest, FailClusterOnPanic) {
+  config_.mutable_locality_lb_config()->mutable_zone_aware_lb_config()->set_fail_traffic_on_panic(
+      true);
+  init();
+
+  hostSet().healthy_hosts_ = {};
+  hostSet().hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:80"),
+                      makeTestHost(info_, "tcp://127.0.0.1:81")};
+  hostSet().runCallbacks({}, {});
+  EXPECT_EQ(nullptr, lb_->chooseHost(nullptr).host);
+}
+
+INSTANTIATE_TEST_SUITE_P(PrimaryOrFailover, LeastLatencyLoadBalancerTest,
+                         ::testing::Values(LoadBalancerTestParam{true},
+                                           LoadBalancerTestParam{false}));
+
+} // namespace
+} // namespace Upstream
+} // namespace Envoy
@@ -1,3 +1,6 @@
+#include <algorithm>
+#include <vector>
+
 #include "source/extensions/load_balancing_policies/maglev/maglev_lb.h"
 
 #include "test/benchmark/main.h"
@@ -9,9 +12,9 @@ namespace {
 
 class MaglevTester : public BaseTester {
 public:
-  MaglevTester(uint64_t num_hosts, uint32_t weighted_subset_percent = 0, uint32_t weight = 0)
+  MaglevTester(uint64_t num_hosts, uint32_t weighted_subset_percent = 0, uint32_t weight = 0,
+               const envoy::extensions::load_balancing_policies::maglev::v3::Maglev& config = {})
       : BaseTester(num_hosts, weighted_subset_percent, weight) {
-    envoy::extensions::load_balancing_policies::maglev::v3::Maglev config;
     maglev_lb_ = std::make_unique<MaglevLoadBalancer>(priority_set_, stats_, stats_scope_, runtime_,
                                                       random_, 50, config, hash_policy_);
   }
@@ -122,6 +125,70 @@ BENCHMARK(benchmarkMaglevLoadBalancerHostLoss)
     ->Args({500, 3, 10000})
     ->Unit(::benchmark::kMillisecond);
 
+void benchmarkMaglevLoadBalancerReplaceHosts(::benchmark::State& state) {
+  const uint64_t num_hosts = state.range(0);
+  const uint64_t hosts_to_replace = state.range(1);
+  const bool incremental = state.range(2) != 0;
+  envoy::extensions::load_balancing_policies::maglev::v3::Maglev config;
+  config.set_incremental_table_rebuild(incremental);
+
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    state.PauseTiming();
+    MaglevTester tester(num_hosts, 0, 0, config);
+    ASSERT_TRUE(tester.maglev_lb_->initialize().ok());
+    TestLoadBalancerContext context;
+    std::vector<HostConstSharedPtr> hosts;
+    hosts.reserve(MaglevTable::DefaultTableSize);
+    LoadBalancerPtr lb = tester.maglev_lb_->factory()->create(tester.lb_params_);
+    for (uint64_t i = 0; i < MaglevTable::DefaultTableSize; i++) {
+      tester.hash_policy_->hash_key_ = i;
+      hosts.push_back(lb->chooseHost(&context).host);
+    }
+
+    // Replace the first hosts_to_replace hosts with new ones, as a scale-down and scale-up would.
+    HostVector new_hosts = tester.priority_set_.hostSetsPerPriority()[0]->hosts();
+    HostVector hosts_removed(new_hosts.begin(), new_hosts.begin() + hosts_to_replace);
+    HostVector hosts_added;
+    for (uint64_t i = 0; i < hosts_to_replace; i++) {
+      hosts_added.push_back(
+          makeTestHost(tester.info_, fmt::format("tcp://10.1.{}.{}:6379", i / 256, i % 256)));
+      new_hosts[i] = hosts_added.back();
+    }
+    HostVectorConstSharedPtr updated_hosts = std::make_shared<HostVector>(new_hosts);
+    HostsPerLocalityConstSharedPtr hosts_per_locality = makeHostsPerLocality({new_hosts});
+
+    // Only time the table rebuild, which happens in the priority set update callback.
+    state.ResumeTiming();
+    tester.priority_set_.updateHosts(
+        0, HostSetImpl::partitionHosts(updated_hosts, hosts_per_locality), {}, hosts_added,
+        hosts_removed, absl::nullopt);
+    state.PauseTiming();
+
+    lb = tester.maglev_lb_->factory()->create(tester.lb_params_);
+    uint64_t num_moved = 0;
+    for (uint64_t i = 0; i < MaglevTable::DefaultTableSize; i++) {
+      tester.hash_policy_->hash_key_ = i;
+      const HostConstSharedPtr host = lb->chooseHost(&context).host;
+      // Keys of the replaced hosts have to move, only count those which move between the others.
+      if (host != hosts[i] &&
+          std::find(hosts_removed.begin(), hosts_removed.end(), hosts[i]) == hosts_removed.end()) {
+        num_moved++;
+      }
+    }
+    state.counters["percent_moved"] =
+        (static_cast<double>(num_moved) / MaglevTable::DefaultTableSize) * 100;
+    state.counters["optimal_percent_moved"] =
+        (static_cast<double>(hosts_to_replace) / num_hosts) * 100;
+    state.ResumeTiming();
+  }
+}
+BENCHMARK(benchmarkMaglevLoadBalancerReplaceHosts)
+    ->Args({500, 5, 0})
+    ->Args({500, 5, 1})
+    ->Args({5000, 50, 0})
+    ->Args({5000, 50, 1})
+    ->Unit(::benchmark::kMillisecond);
+
 void benchmarkMaglevLoadBalancerWeighted(::benchmark::State& state) {
   for (auto _ : state) { // NOLINT: Silences warning about dead store
     const uint64_t num_hosts = state.range(0);
@@ -181,6 +248,44 @@ BENCHMARK(benchmarkMaglevLoadBalancerWeighted)
     ->Args({500, 95, 75, 25, 10000})
     ->Unit(::benchmark::kMillisecond);
 
+void benchmarkMaglevLoadBalancerBoundedLoadChooseHost(::benchmark::State& state) {
+  const uint64_t num_hosts = state.range(0);
+  const uint64_t overloaded_percent = state.range(1);
+  const uint64_t keys_to_simulate = state.range(2);
+  envoy::extensions::load_balancing_policies::maglev::v3::Maglev config;
+  config.mutable_consistent_hashing_lb_config()->mutable_hash_balance_factor()->set_value(150);
+
+  MaglevTester tester(num_hosts, 0, 0, config);
+  ASSERT_TRUE(tester.maglev_lb_->initialize().ok());
+  // Each host is allowed 1.5 times its share of the active requests, so hosts with 3 times their
+  // share are overloaded, and the others are below it.
+  const HostVector& hosts = tester.priority_set_.hostSetsPerPriority()[0]->hosts();
+  const uint64_t num_overloaded = num_hosts * overloaded_percent / 100;
+  uint64_t overall_active = 0;
+  for (uint64_t i = 0; i < num_hosts; i++) {
+    const uint64_t active = i < num_overloaded ? 30 : 5;
+    hosts[i]->stats().rq_active_.set(active);
+    overall_active += active;
+  }
+  tester.info_->trafficStats()->upstream_rq_active_.set(overall_active);
+  LoadBalancerPtr lb = tester.maglev_lb_->factory()->create(tester.lb_params_);
+  TestLoadBalancerContext context;
+
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    for (uint64_t i = 0; i < keys_to_simulate; i++) {
+      tester.hash_policy_->hash_key_ = hashInt(i);
+      benchmark::DoNotOptimize(lb->chooseHost(&context).host);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * keys_to_simulate);
+}
+BENCHMARK(benchmarkMaglevLoadBalancerBoundedLoadChooseHost)
+    ->Args({500, 0, 10000})
+    ->Args({500, 10, 10000})
+    ->Args({500, 50, 10000})
+    ->Args({5000, 50, 10000})
+    ->Unit(::benchmark::kMillisecond);
+
 } // namespace
 } // namespace Upstream
 } // namespace Envoy
@@ -717,6 +717,140 @@ TEST_F(MaglevLoadBalancerTest, LocalityWeightedLopsided) {
   EXPECT_EQ(MaglevTable::DefaultTableSize - 1023, counts[0]);
 }
 
+// Returns the host chosen for each slot of a table of the given size.
+std::vector<HostConstSharedPtr> tableAssignments(LoadBalancer& lb, uint64_t table_size) {
+  std::vector<HostConstSharedPtr> assignments;
+  assignments.reserve(table_size);
+  for (uint64_t i = 0; i < table_size; ++i) {
+    TestLoadBalancerContext context(i);
+    assignments.push_back(lb.chooseHost(&context).host);
+  }
+  return assignments;
+}
+
+// An incremental rebuild keeps the slots of the remaining hosts when a host is removed, and
+// spreads the slots of the removed host over them.
+TEST_F(MaglevLoadBalancerTest, IncrementalRebuildHostRemoved) {
+  for (uint32_t i = 0; i < 10; ++i) {
+    host_set_.hosts_.push_back(makeTestHost(info_, fmt::format("tcp://127.0.0.1:{}", 90 + i)));
+  }
+  host_set_.healthy_hosts_ = host_set_.hosts_;
+  host_set_.runCallbacks({}, {});
+  config_.set_incremental_table_rebuild(true);
+  init(1009);
+  const std::vector<HostConstSharedPtr> before =
+      tableAssignments(*lb_->factory()->create(lb_params_), 1009);
+
+  const HostSharedPtr removed = host_set_.hosts_[3];
+  host_set_.hosts_.erase(host_set_.hosts_.begin() + 3);
+  host_set_.healthy_hosts_ = host_set_.hosts_;
+  host_set_.runCallbacks({}, {removed});
+  const std::vector<HostConstSharedPtr> after =
+      tableAssignments(*lb_->factory()->create(lb_params_), 1009);
+
+  for (uint64_t i = 0; i < 1009; ++i) {
+    if (before[i] != removed) {
+      EXPECT_EQ(before[i], after[i]);
+    } else {
+      EXPECT_NE(removed, after[i]);
+    }
+  }
+  // 1009 slots over 9 hosts.
+  EXPECT_EQ(112, lb_->stats().min_entries_per_host_.value());
+  EXPECT_EQ(113, lb_->stats().max_entries_per_host_.value());
+}
+
+// An incremental rebuild only moves the slots which a new host takes over.
+TEST_F(MaglevLoadBalancerTest, IncrementalRebuildHostAdded) {
+  for (uint32_t i = 0; i < 10; ++i) {
+    host_set_.hosts_.push_back(makeTestHost(info_, fmt::format("tcp://127.0.0.1:{}", 90 + i)));
+  }
+  host_set_.healthy_hosts_ = host_set_.hosts_;
+  host_set_.runCallbacks({}, {});
+  config_.set_incremental_table_rebuild(true);
+  init(1009);
+  const std::vector<HostConstSharedPtr> before =
+      tableAssignments(*lb_->factory()->create(lb_params_), 1009);
+
+  const HostSharedPtr added = makeTestHost(info_, "tcp://127.0.0.1:100");
+  host_set_.hosts_.push_back(added);
+  host_set_.healthy_hosts_ = host_set_.hosts_;
+  host_set_.runCallbacks({added}, {});
+  const std::vector<HostConstSharedPtr> after =
+      tableAssignments(*lb_->factory()->create(lb_params_), 1009);
+
+  uint64_t moved = 0;
+  for (uint64_t i = 0; i < 1009; ++i) {
+    if (before[i] != after[i]) {
+      EXPECT_EQ(added, after[i]);
+      ++moved;
+    }
+  }
+  // 1009 slots over 11 hosts.
+  EXPECT_EQ(91, lb_->stats().min_entries_per_host_.value());
+  EXPECT_EQ(92, lb_->stats().max_entries_per_host_.value());
+  EXPECT_GE(moved, 91);
+  EXPECT_LE(moved, 92);
+}
+
+// An incremental rebuild keeps the hosts' shares of the table in proportion to their weights, and
+// only moves slots to a host whose weight increased.
+TEST_F(MaglevLoadBalancerTest, IncrementalRebuildWeightChanged) {
+  for (uint32_t i = 0; i < 4; ++i) {
+    host_set_.hosts_.push_back(makeTestHost(info_, fmt::format("tcp://127.0.0.1:{}", 90 + i)));
+  }
+  host_set_.healthy_hosts_ = host_set_.hosts_;
+  host_set_.runCallbacks({}, {});
+  config_.set_incremental_table_rebuild(true);
+  init(1009);
+  const std::vector<HostConstSharedPtr> before =
+      tableAssignments(*lb_->factory()->create(lb_params_), 1009);
+
+  host_set_.hosts_[0]->weight(3);
+  host_set_.runCallbacks({}, {});
+  const std::vector<HostConstSharedPtr> after =
+      tableAssignments(*lb_->factory()->create(lb_params_), 1009);
+
+  for (uint64_t i = 0; i < 1009; ++i) {
+    if (before[i] != after[i]) {
+      EXPECT_EQ(host_set_.hosts_[0], after[i]);
+    }
+  }
+  // 1009 slots over weights of 3, 1, 1 and 1.
+  EXPECT_EQ(505, std::count(after.begin(), after.end(), host_set_.hosts_[0]));
+  EXPECT_EQ(168, lb_->stats().min_entries_per_host_.value());
+  EXPECT_EQ(505, lb_->stats().max_entries_per_host_.value());
+}
+
+// An incremental rebuild of a table wrapped for bounded load.
+TEST_F(MaglevLoadBalancerTest, IncrementalRebuildWithBoundedLoad) {
+  for (uint32_t i = 0; i < 6; ++i) {
+    host_set_.hosts_.push_back(makeTestHost(info_, fmt::format("tcp://127.0.0.1:{}", 90 + i)));
+  }
+  host_set_.healthy_hosts_ = host_set_.hosts_;
+  host_set_.runCallbacks({}, {});
+  config_.set_incremental_table_rebuild(true);
+  config_.mutable_consistent_hashing_lb_config()->mutable_hash_balance_factor()->set_value(150);
+  init(1009);
+  const std::vector<HostConstSharedPtr> before =
+      tableAssignments(*lb_->factory()->create(lb_params_), 1009);
+
+  const HostSharedPtr removed = host_set_.hosts_[0];
+  host_set_.hosts_.erase(host_set_.hosts_.begin());
+  host_set_.healthy_hosts_ = host_set_.hosts_;
+  host_set_.runCallbacks({}, {removed});
+  const std::vector<HostConstSharedPtr> after =
+      tableAssignments(*lb_->factory()->create(lb_params_), 1009);
+
+  for (uint64_t i = 0; i < 1009; ++i) {
+    if (before[i] != removed) {
+      EXPECT_EQ(before[i], after[i]);
+    }
+    EXPECT_NE(nullptr, after[i]);
+    EXPECT_NE(removed, after[i]);
+  }
+}
+
 TEST(TypedMaglevLbConfigTest, TypedMaglevLbConfigTest) {
   {
     envoy::config::cluster::v3::Cluster::MaglevLbConfig legacy;
@@ -36,6 +36,8 @@ void benchmarkRingHashLoadBalancerBuildRing(::benchmark::State& state) {
     const size_t end_mem = Memory::Stats::totalCurrentlyAllocated();
     state.counters["memory"] = end_mem - start_mem;
     state.counters["memory_per_host"] = (end_mem - start_mem) / num_hosts;
+    state.counters["memory_per_ring_entry"] =
+        static_cast<double>(end_mem - start_mem) / tester.ring_hash_lb_->stats().size_.value();
     state.ResumeTiming();
   }
 }
@@ -46,6 +48,7 @@ BENCHMARK(benchmarkRingHashLoadBalancerBuildRing)
     ->Args({100, 256000})
     ->Args({200, 256000})
     ->Args({500, 256000})
+    ->Args({500, 1024 * 1024})
     ->Unit(::benchmark::kMillisecond);
 
 void benchmarkRingHashLoadBalancerChooseHost(::benchmark::State& state) {
@@ -87,6 +90,35 @@ BENCHMARK(benchmarkRingHashLoadBalancerChooseHost)
     ->Args({500, 256000, 100000})
     ->Unit(::benchmark::kMillisecond);
 
+// Times picks alone, without collecting hit statistics, so that the cost of the ring search
+// dominates.
+void benchmarkRingHashLoadBalancerChooseHostLatency(::benchmark::State& state) {
+  const uint64_t num_hosts = state.range(0);
+  const uint64_t min_ring_size = state.range(1);
+  const uint64_t keys_to_simulate = state.range(2);
+  RingHashTester tester(num_hosts, min_ring_size);
+  ASSERT_TRUE(tester.ring_hash_lb_->initialize().ok());
+  LoadBalancerPtr lb = tester.ring_hash_lb_->factory()->create(tester.lb_params_);
+  TestLoadBalancerContext context;
+  std::vector<uint64_t> keys;
+  keys.reserve(keys_to_simulate);
+  for (uint64_t i = 0; i < keys_to_simulate; i++) {
+    keys.push_back(hashInt(i));
+  }
+
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    for (const uint64_t key : keys) {
+      tester.hash_policy_->hash_key_ = key;
+      benchmark::DoNotOptimize(lb->chooseHost(&context).host);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * keys_to_simulate);
+}
+BENCHMARK(benchmarkRingHashLoadBalancerChooseHostLatency)
+    ->Args({500, 65536, 100000})
+    ->Args({500, 1024 * 1024, 100000})
+    ->Unit(::benchmark::kMillisecond);
+
 void benchmarkRingHashLoadBalancerHostLoss(::benchmark::State& state) {
   const uint64_t num_hosts = state.range(0);
   const uint64_t min_ring_size = state.range(1);
@@ -0,0 +1,211 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+//
+// Measures the rate at which the c-ares resolver resolves distinct names against a stub DNS server
+// on the loopback interface, which answers every A and AAAA query from a thread of its own. The
+// resolver is run on the thread which owns it (resolver_threads = 0), or sharded over a number of
+// resolver threads. A fixed number of lookups are kept in flight, so that the stub server's socket
+// buffer does not overflow.
+
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <functional>
+#include <string>
+
+#include "envoy/config/core/v3/extension.pb.h"
+#include "envoy/extensions/network/dns_resolver/cares/v3/cares_dns_resolver.pb.h"
+#include "envoy/thread/thread.h"
+
+#include "source/common/common/assert.h"
+#include "source/common/network/dns_resolver/dns_factory_util.h"
+#include "source/extensions/network/dns_resolver/cares/dns_impl.h"
+
+#include "test/benchmark/main.h"
+#include "test/test_common/utility.h"
+
+#include "absl/strings/str_cat.h"
+#include "ares.h"
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Network {
+namespace {
+
+constexpr uint32_t LookupsInFlight = 64;
+
+// Answers each query for A or AAAA with a loopback address, on a thread of its own.
+class StubDnsServer {
+public:
+  explicit StubDnsServer(Thread::ThreadFactory& thread_factory) {
+    fd_ = ::socket(AF_INET, SOCK_DGRAM, 0);
+    RELEASE_ASSERT(fd_ >= 0, "socket failed");
+    const int buffer_size = 1 << 20;
+    ::setsockopt(fd_, SOL_SOCKET, SO_RCVBUF, &buffer_size, sizeof(buffer_size));
+    // Wake up periodically to check whether to stop.
+    timeval timeout{0, 50000};
+    ::setsockopt(fd_, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    RELEASE_ASSERT(::bind(fd_, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0,
+                   "bind failed");
+    socklen_t address_len = sizeof(address);
+    ::getsockname(fd_, reinterpret_cast<sockaddr*>(&address), &address_len);
+    port_ = ntohs(address.sin_port);
+    thread_ = thread_factory.createThread([this]() { serve(); });
+  }
+
+  ~StubDnsServer() {
+    stopping_ = true;
+    thread_->join();
+    ::close(fd_);
+  }
+
+  uint16_t port() const { return port_; }
+
+private:
+  void serve() {
+    unsigned char request[512];
+    while (!stopping_) {
+      sockaddr_in peer;
+      socklen_t peer_len = sizeof(peer);
+      const ssize_t received = ::recvfrom(fd_, request, sizeof(request), 0,
+                                          reinterpret_cast<sockaddr*>(&peer), &peer_len);
+      if (received <= 0) {
+        continue;
+      }
+      unsigned char* response = nullptr;
+      size_t response_len = 0;
+      if (buildResponse(request, received, &response, &response_len)) {
+        ::sendto(fd_, response, response_len, 0, reinterpret_cast<sockaddr*>(&peer), peer_len);
+        ares_free_string(response);
+      }
+    }
+  }
+
+  static bool buildResponse(const unsigned char* request, size_t request_len,
+                            unsigned char** response, size_t* response_len) {
+    ares_dns_record_t* query = nullptr;
+    if (ares_dns_parse(request, request_len, 0, &query) != ARES_SUCCESS) {
+      return false;
+    }
+    const char* name = nullptr;
+    ares_dns_rec_type_t type;
+    ares_dns_class_t dns_class;
+    ares_dns_record_t* answer = nullptr;
+    bool built = false;
+    if (ares_dns_record_query_cnt(query) == 1 &&
+        ares_dns_record_query_get(query, 0, &name, &type, &dns_class) == ARES_SUCCESS &&
+        ares_dns_record_create(&answer, ares_dns_record_get_id(query),
+                               ARES_FLAG_QR | ARES_FLAG_AA | ARES_FLAG_RD | ARES_FLAG_RA,
+                               ARES_OPCODE_QUERY, ARES_RCODE_NOERROR) == ARES_SUCCESS &&
+        ares_dns_record_query_add(answer, name, type, dns_class) == ARES_SUCCESS) {
+      ares_dns_rr_t* record = nullptr;
+      if (type == ARES_REC_TYPE_A) {
+        in_addr address;
+        address.s_addr = htonl(INADDR_LOOPBACK);
+        built = ares_dns_record_rr_add(&record, answer, ARES_SECTION_ANSWER, name, type,
+                                       ARES_CLASS_IN, 300) == ARES_SUCCESS &&
+                ares_dns_rr_set_addr(record, ARES_RR_A_ADDR, &address) == ARES_SUCCESS;
+      } else if (type == ARES_REC_TYPE_AAAA) {
+        ares_in6_addr address;
+        memset(&address, 0, sizeof(address));
+        address._S6_un._S6_u8[15] = 1;
+        built = ares_dns_record_rr_add(&record, answer, ARES_SECTION_ANSWER, name, type,
+                                       ARES_CLASS_IN, 300) == ARES_SUCCESS &&
+                ares_dns_rr_set_addr6(record, ARES_RR_AAAA_ADDR, &address) == ARES_SUCCESS;
+      } else {
+        // Other types are answered with no records.
+        built = true;
+      }
+      built = built && ares_dns_write(answer, response, response_len) == ARES_SUCCESS;
+    }
+    ares_dns_record_destroy(answer);
+    ares_dns_record_destroy(query);
+    return built;
+  }
+
+  int fd_;
+  uint16_t port_;
+  std::atomic<bool> stopping_{false};
+  Thread::ThreadPtr thread_;
+};
+
+} // namespace
+
+// Resolves a number of distinct names for both families, keeping LookupsInFlight lookups
+// outstanding, with a number of resolver threads.
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_ResolveNames(::benchmark::State& state) {
+  const uint32_t resolver_threads = state.range(0);
+  const uint32_t num_names = state.range(1);
+  if (benchmark::skipExpensiveBenchmarks() && num_names > 1000) {
+    state.SkipWithError("Skipping expensive benchmark");
+    return;
+  }
+  Api::ApiPtr api = Api::createApiForTest();
+  Event::DispatcherPtr dispatcher = api->allocateDispatcher("test_thread");
+  StubDnsServer server(api->threadFactory());
+
+  envoy::extensions::network::dns_resolver::cares::v3::CaresDnsResolverConfig cares;
+  auto* resolver_address = cares.add_resolvers()->mutable_socket_address();
+  resolver_address->set_address("127.0.0.1");
+  resolver_address->set_port_value(server.port());
+  cares.mutable_dns_resolver_options()->set_no_default_search_domain(true);
+  cares.mutable_query_timeout_seconds()->set_value(1);
+  if (resolver_threads > 0) {
+    cares.mutable_num_resolver_threads()->set_value(resolver_threads);
+  }
+  envoy::config::core::v3::TypedExtensionConfig typed_dns_resolver_config;
+  typed_dns_resolver_config.mutable_typed_config()->PackFrom(cares);
+  typed_dns_resolver_config.set_name(std::string(CaresDnsResolver));
+  DnsResolverSharedPtr resolver =
+      createDnsResolverFactoryFromTypedConfig(typed_dns_resolver_config)
+          .createDnsResolver(*dispatcher, *api, typed_dns_resolver_config)
+          .value();
+
+  uint64_t iteration = 0;
+  uint64_t failures = 0;
+  for (auto _ : state) { // NOLINT
+    uint32_t started = 0;
+    uint32_t completed = 0;
+    std::function<void()> start_next = [&]() {
+      const std::string name = absl::StrCat("host", started++, ".", iteration, ".benchmark.test");
+      resolver->resolve(name, DnsLookupFamily::All,
+                        [&](DnsResolver::ResolutionStatus status, absl::string_view,
+                            std::list<DnsResponse>&& response) {
+                          if (status != DnsResolver::ResolutionStatus::Completed ||
+                              response.size() != 2) {
+                            ++failures;
+                          }
+                          if (++completed == num_names) {
+                            dispatcher->exit();
+                          } else if (started < num_names) {
+                            start_next();
+                          }
+                        });
+    };
+    while (started < std::min(num_names, LookupsInFlight)) {
+      start_next();
+    }
+    dispatcher->run(Event::Dispatcher::RunType::RunUntilExit);
+    ++iteration;
+  }
+  if (failures > 0) {
+    state.SkipWithError("Resolutions failed");
+  }
+  state.SetItemsProcessed(state.iterations() * num_names);
+  resolver.reset();
+}
+BENCHMARK(BM_ResolveNames)
+    ->ArgsProduct({{0, 1, 4}, {1000, 10000}})
+    ->Unit(::benchmark::kMillisecond)
+    ->UseRealTime();
+
+} // namespace Network
+} // namespace Envoy
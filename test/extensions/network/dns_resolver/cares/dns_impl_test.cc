@@ -24,6 +24,7 @@
 #include "source/common/protobuf/protobuf.h"
 #include "source/common/stream_info/stream_info_impl.h"
 #include "source/extensions/network/dns_resolver/cares/dns_impl.h"
+#include "source/extensions/network/dns_resolver/cares/sharded_dns_impl.h"
 
 #include "test/common/stats/stat_test_utility.h"
 #include "test/mocks/api/mocks.h"
@@ -37,6 +38,8 @@
 
 #include "absl/container/fixed_array.h"
 #include "absl/container/node_hash_map.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_split.h"
 #include "ares.h"
 #include "ares_dns.h"
 #include "gtest/gtest.h"
@@ -50,6 +53,8 @@
 
 using testing::_;
 using testing::Contains;
+using testing::ElementsAre;
+using testing::HasSubstr;
 using testing::InSequence;
 using testing::IsSupersetOf;
 using testing::NiceMock;
@@ -2367,5 +2372,227 @@ TEST_P(DnsImplEdns0Test, Edns0ConfigurationApplied) {
   ares_destroy_options(&opts);
 }
 
+class ShardedDnsImplTest : public testing::TestWithParam<Address::IpVersion> {
+public:
+  ShardedDnsImplTest()
+      : api_(Api::createApiForTest(stats_store_)),
+        dispatcher_(api_->allocateDispatcher("test_thread")) {}
+
+  void SetUp() override {
+    server_ = std::make_unique<TestDnsServer>(*dispatcher_, false);
+    socket_ = std::make_shared<Network::Test::TcpListenSocketImmediateListen>(
+        Network::Test::getCanonicalLoopbackAddress(GetParam()));
+    NiceMock<Network::MockListenerConfig> listener_config;
+    Server::ThreadLocalOverloadStateOptRef overload_state;
+    listener_ = std::make_unique<Network::TcpListenerImpl>(
+        *dispatcher_, api_->randomGenerator(), runtime_, socket_, *server_,
+        listener_config.bindToPort(), listener_config.ignoreGlobalConnLimit(),
+        listener_config.shouldBypassOverloadManager(),
+        listener_config.maxConnectionsToAcceptPerSocketEvent(), overload_state);
+
+    // The resolver threads connect over TCP to the TestDnsServer, which is served by the test
+    // dispatcher.
+    envoy::extensions::network::dns_resolver::cares::v3::CaresDnsResolverConfig cares;
+    const auto& server_address = socket_->connectionInfoProvider().localAddress();
+    auto* resolver_address = cares.add_resolvers()->mutable_socket_address();
+    resolver_address->set_address(server_address->ip()->addressAsString());
+    resolver_address->set_port_value(server_address->ip()->port());
+    cares.mutable_dns_resolver_options()->set_use_tcp_for_dns_lookups(true);
+    cares.mutable_dns_resolver_options()->set_no_default_search_domain(true);
+    cares.mutable_num_resolver_threads()->set_value(2);
+    envoy::config::core::v3::TypedExtensionConfig typed_dns_resolver_config;
+    typed_dns_resolver_config.mutable_typed_config()->PackFrom(cares);
+    typed_dns_resolver_config.set_name(std::string(Network::CaresDnsResolver));
+    Network::DnsResolverFactory& dns_resolver_factory =
+        createDnsResolverFactoryFromTypedConfig(typed_dns_resolver_config);
+    resolver_ =
+        dns_resolver_factory.createDnsResolver(*dispatcher_, *api_, typed_dns_resolver_config)
+            .value();
+  }
+
+  void TearDown() override {
+    // The resolver threads are joined before the server they may be connected to goes away.
+    resolver_.reset();
+    listener_.reset();
+    server_.reset();
+  }
+
+protected:
+  Stats::TestUtil::TestStore stats_store_;
+  NiceMock<Runtime::MockLoader> runtime_;
+  std::unique_ptr<TestDnsServer> server_;
+  std::shared_ptr<Network::TcpListenSocket> socket_;
+  std::unique_ptr<Network::Listener> listener_;
+  Api::ApiPtr api_;
+  Event::DispatcherPtr dispatcher_;
+  DnsResolverSharedPtr resolver_;
+};
+
+INSTANTIATE_TEST_SUITE_P(IpVersions, ShardedDnsImplTest,
+                         testing::ValuesIn(TestEnvironment::getIpVersionsForTest()),
+                         TestUtility::ipTestParamsToString);
+
+TEST_P(ShardedDnsImplTest, CreatesShardedResolver) {
+  auto* sharded = dynamic_cast<ShardedDnsResolverImpl*>(resolver_.get());
+  ASSERT_NE(nullptr, sharded);
+  EXPECT_EQ(2, sharded->numShards());
+}
+
+// Validate that names resolved on several resolver threads are each delivered to their own
+// callback, on the thread which owns the resolver.
+TEST_P(ShardedDnsImplTest, ResolvesOnResolverThreads) {
+  constexpr uint32_t NumNames = 20;
+  for (uint32_t i = 0; i < NumNames; ++i) {
+    server_->addHosts(absl::StrCat("host", i, ".sharded.domain"), {absl::StrCat("10.0.0.", i)},
+                      RecordType::A);
+  }
+
+  absl::node_hash_map<std::string, std::string> results;
+  for (uint32_t i = 0; i < NumNames; ++i) {
+    const std::string name = absl::StrCat("host", i, ".sharded.domain");
+    resolver_->resolve(name, DnsLookupFamily::V4Only,
+                       [&, name](DnsResolver::ResolutionStatus status, absl::string_view,
+                                 std::list<DnsResponse>&& response) {
+                         EXPECT_TRUE(dispatcher_->isThreadSafe());
+                         EXPECT_EQ(DnsResolver::ResolutionStatus::Completed, status);
+                         ASSERT_EQ(1, response.size());
+                         results[name] =
+                             response.front().addrInfo().address_->ip()->addressAsString();
+                         if (results.size() == NumNames) {
+                           dispatcher_->exit();
+                         }
+                       });
+  }
+  dispatcher_->run(Event::Dispatcher::RunType::RunUntilExit);
+
+  for (uint32_t i = 0; i < NumNames; ++i) {
+    EXPECT_EQ(absl::StrCat("10.0.0.", i), results[absl::StrCat("host", i, ".sharded.domain")]);
+  }
+  EXPECT_EQ(NumNames, stats_store_.counter("dns.cares.resolve_total").value());
+}
+
+// Validate that both families of a lookup are resolved together on one resolver thread.
+TEST_P(ShardedDnsImplTest, ResolvesAll) {
+  server_->addHosts("some.good.domain", {"201.134.56.7"}, RecordType::A);
+  server_->addHosts("some.good.domain", {"1::2"}, RecordType::AAAA);
+
+  std::list<std::string> addresses;
+  resolver_->resolve("some.good.domain", DnsLookupFamily::All,
+                     [&](DnsResolver::ResolutionStatus status, absl::string_view,
+                         std::list<DnsResponse>&& response) {
+                       EXPECT_EQ(DnsResolver::ResolutionStatus::Completed, status);
+                       for (const DnsResponse& entry : response) {
+                         addresses.push_back(entry.addrInfo().address_->ip()->addressAsString());
+                       }
+                       dispatcher_->exit();
+                     });
+  dispatcher_->run(Event::Dispatcher::RunType::RunUntilExit);
+  EXPECT_THAT(addresses, UnorderedElementsAreArray({"201.134.56.7", "1::2"}));
+}
+
+// Validate that the callback of a cancelled query is not invoked.
+TEST_P(ShardedDnsImplTest, Cancel) {
+  server_->addHosts("some.good.domain", {"201.134.56.7"}, RecordType::A);
+
+  ActiveDnsQuery* query = resolver_->resolve(
+      "some.good.domain", DnsLookupFamily::V4Only,
+      [](DnsResolver::ResolutionStatus, absl::string_view, std::list<DnsResponse>&&) {
+        FAIL() << "cancelled query callback invoked";
+      });
+  ASSERT_NE(nullptr, query);
+  query->cancel(Network::ActiveDnsQuery::CancelReason::QueryAbandoned);
+
+  resolver_->resolve("some.good.domain", DnsLookupFamily::V4Only,
+                     [&](DnsResolver::ResolutionStatus status, absl::string_view,
+                         std::list<DnsResponse>&&) {
+                       EXPECT_EQ(DnsResolver::ResolutionStatus::Completed, status);
+                       dispatcher_->exit();
+                     });
+  dispatcher_->run(Event::Dispatcher::RunType::RunUntilExit);
+}
+
+// Validate that a query which is in flight on its resolver thread is cancelled there, and that
+// its callback is not invoked.
+TEST_P(ShardedDnsImplTest, CancelInFlight) {
+  server_->addHosts("some.good.domain", {"201.134.56.7"}, RecordType::A);
+
+  ActiveDnsQuery* query = resolver_->resolve(
+      "some.good.domain", DnsLookupFamily::V4Only,
+      [](DnsResolver::ResolutionStatus, absl::string_view, std::list<DnsResponse>&&) {
+        FAIL() << "cancelled query callback invoked";
+      });
+  ASSERT_NE(nullptr, query);
+  // Hand the query to its resolver thread before cancelling it.
+  dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+  query->cancel(Network::ActiveDnsQuery::CancelReason::Timeout);
+  EXPECT_THAT(query->getTraces(),
+              HasSubstr(absl::StrCat(static_cast<uint8_t>(ShardedDnsTrace::Cancelled), "=")));
+
+  resolver_->resolve("some.good.domain", DnsLookupFamily::V4Only,
+                     [&](DnsResolver::ResolutionStatus status, absl::string_view,
+                         std::list<DnsResponse>&&) {
+                       EXPECT_EQ(DnsResolver::ResolutionStatus::Completed, status);
+                       dispatcher_->exit();
+                     });
+  dispatcher_->run(Event::Dispatcher::RunType::RunUntilExit);
+}
+
+// Validate that a query records its passage through its resolver thread, in order.
+TEST_P(ShardedDnsImplTest, Traces) {
+  server_->addHosts("some.good.domain", {"201.134.56.7"}, RecordType::A);
+
+  ActiveDnsQuery* query = nullptr;
+  query = resolver_->resolve(
+      "some.good.domain", DnsLookupFamily::V4Only,
+      [&](DnsResolver::ResolutionStatus status, absl::string_view, std::list<DnsResponse>&&) {
+        EXPECT_EQ(DnsResolver::ResolutionStatus::Completed, status);
+        std::vector<std::string> traces;
+        for (absl::string_view trace : absl::StrSplit(query->getTraces(), ',')) {
+          traces.emplace_back(trace.substr(0, trace.find('=')));
+        }
+        EXPECT_THAT(traces,
+                    ElementsAre(absl::StrCat(static_cast<uint8_t>(ShardedDnsTrace::Queued)),
+                                absl::StrCat(static_cast<uint8_t>(ShardedDnsTrace::Starting)),
+                                absl::StrCat(static_cast<uint8_t>(ShardedDnsTrace::Resolved)),
+                                absl::StrCat(static_cast<uint8_t>(ShardedDnsTrace::Callback))));
+        dispatcher_->exit();
+      });
+  ASSERT_NE(nullptr, query);
+  dispatcher_->run(Event::Dispatcher::RunType::RunUntilExit);
+}
+
+// Validate that destroying the resolver with queries which are yet to be handed to a resolver
+// thread, or which are in flight on one, invokes no callbacks.
+TEST_P(ShardedDnsImplTest, DestructPending) {
+  server_->addHosts("some.good.domain", {"201.134.56.7"}, RecordType::A);
+  const auto callback = [](DnsResolver::ResolutionStatus, absl::string_view,
+                           std::list<DnsResponse>&&) { FAIL() << "callback invoked"; };
+
+  EXPECT_NE(nullptr, resolver_->resolve("some.good.domain", DnsLookupFamily::V4Only, callback));
+  // Hand the query to its resolver thread. The server is not served until the dispatcher runs
+  // again, so the query remains in flight.
+  dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+  EXPECT_NE(nullptr, resolver_->resolve("other.good.domain", DnsLookupFamily::V4Only, callback));
+
+  resolver_.reset();
+  dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+}
+
+// Validate that resetting the networking reinitializes the channel of every resolver thread
+// before the queries issued after it are started.
+TEST_P(ShardedDnsImplTest, ResetNetworking) {
+  server_->addHosts("some.good.domain", {"201.134.56.7"}, RecordType::A);
+
+  resolver_->resetNetworking();
+  resolver_->resolve("some.good.domain", DnsLookupFamily::V4Only,
+                     [&](DnsResolver::ResolutionStatus status, absl::string_view,
+                         std::list<DnsResponse>&&) {
+                       EXPECT_EQ(DnsResolver::ResolutionStatus::Completed, status);
+                       dispatcher_->exit();
+                     });
+  dispatcher_->run(Event::Dispatcher::RunType::RunUntilExit);
+  EXPECT_EQ(2, stats_store_.counter("dns.cares.reinits").value());
+}
+
 } // namespace Network
 } // namespace Envoy
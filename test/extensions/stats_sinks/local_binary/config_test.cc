@@ -0,0 +1,70 @@
+#include "envoy/extensions/stat_sinks/local_binary/v3/local_binary.pb.h"
+#include "envoy/registry/registry.h"
+
+#include "source/extensions/stat_sinks/local_binary/config.h"
+#include "source/extensions/stat_sinks/local_binary/local_binary_sink.h"
+
+#include "test/mocks/server/instance.h"
+#include "test/test_common/environment.h"
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::NiceMock;
+
+namespace Envoy {
+namespace Extensions {
+namespace StatSinks {
+namespace LocalBinary {
+namespace {
+
+Stats::SinkPtr createSink(const std::string& yaml) {
+  envoy::extensions::stat_sinks::local_binary::v3::LocalBinarySink sink_config;
+  TestUtility::loadFromYaml(yaml, sink_config);
+
+  Server::Configuration::StatsSinkFactory* factory =
+      Registry::FactoryRegistry<Server::Configuration::StatsSinkFactory>::getFactory(
+          LocalBinaryName);
+  EXPECT_NE(factory, nullptr);
+  ProtobufTypes::MessagePtr message = factory->createEmptyConfigProto();
+  TestUtility::jsonConvert(sink_config, *message);
+
+  NiceMock<Server::Configuration::MockServerFactoryContext> server;
+  return factory->createStatsSink(*message, server).value();
+}
+
+TEST(LocalBinaryConfigTest, FileSink) {
+  Stats::SinkPtr sink = createSink(fmt::format(R"EOF(
+file_path: {}
+max_file_bytes: 1048576
+)EOF",
+                                               TestEnvironment::temporaryPath("stats.bin")));
+  EXPECT_NE(dynamic_cast<LocalBinarySink*>(sink.get()), nullptr);
+}
+
+TEST(LocalBinaryConfigTest, UnixSocketSink) {
+  const std::string path = TestEnvironment::unixDomainSocketPath("stats.sock");
+  Stats::SinkPtr sink = createSink(fmt::format(R"EOF(
+unix_socket:
+  path: {}
+max_frame_bytes: 16384
+retire_after_flushes: 3
+resync_interval_flushes: 6
+)EOF",
+                                               path));
+  EXPECT_NE(dynamic_cast<LocalBinarySink*>(sink.get()), nullptr);
+}
+
+TEST(LocalBinaryConfigTest, DestinationIsRequired) {
+  envoy::extensions::stat_sinks::local_binary::v3::LocalBinarySink sink_config;
+  NiceMock<Server::Configuration::MockServerFactoryContext> server;
+  LocalBinarySinkFactory factory;
+  EXPECT_THROW(factory.createStatsSink(sink_config, server).IgnoreError(), EnvoyException);
+}
+
+} // namespace
+} // namespace LocalBinary
+} // namespace StatSinks
+} // namespace Extensions
+} // namespace Envoy
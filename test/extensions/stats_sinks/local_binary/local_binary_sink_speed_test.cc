@@ -0,0 +1,131 @@
+// Measures the cost of a flush of the local binary stats encoder as a function of the number of
+// counters, for the first flush (which describes every metric) and for steady state flushes where
+// one counter in a hundred changed. For example:
+//
+//   bazel run -c opt //test/extensions/stats_sinks/local_binary:local_binary_sink_speed_test
+//
+// Throughput is reported as items_per_second, where an item is one metric of the snapshot, and
+// the encoded size of a flush as bytes_per_flush.
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/stats/sink.h"
+
+#include "source/common/stats/isolated_store_impl.h"
+#include "source/extensions/stat_sinks/local_binary/encoder.h"
+
+#include "test/benchmark/main.h"
+
+#include "absl/strings/str_cat.h"
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace StatSinks {
+namespace LocalBinary {
+namespace {
+
+class TestSnapshot : public Stats::MetricSnapshot {
+public:
+  // Stats::MetricSnapshot
+  const std::vector<CounterSnapshot>& counters() override { return counters_; }
+  const std::vector<std::reference_wrapper<const Stats::Gauge>>& gauges() override {
+    return gauges_;
+  }
+  const std::vector<std::reference_wrapper<const Stats::ParentHistogram>>& histograms() override {
+    return histograms_;
+  }
+  const std::vector<std::reference_wrapper<const Stats::TextReadout>>& textReadouts() override {
+    return text_readouts_;
+  }
+  const std::vector<Stats::PrimitiveCounterSnapshot>& hostCounters() override {
+    return host_counters_;
+  }
+  const std::vector<Stats::PrimitiveGaugeSnapshot>& hostGauges() override { return host_gauges_; }
+  SystemTime snapshotTime() const override { return SystemTime(); }
+
+  std::vector<CounterSnapshot> counters_;
+  std::vector<std::reference_wrapper<const Stats::Gauge>> gauges_;
+  std::vector<std::reference_wrapper<const Stats::ParentHistogram>> histograms_;
+  std::vector<std::reference_wrapper<const Stats::TextReadout>> text_readouts_;
+  std::vector<Stats::PrimitiveCounterSnapshot> host_counters_;
+  std::vector<Stats::PrimitiveGaugeSnapshot> host_gauges_;
+};
+
+// Creates num_counters counters with names shaped like per-cluster stats, so that tokens are
+// shared the way they are in a real deployment.
+void populateSnapshot(Stats::IsolatedStoreImpl& store, TestSnapshot& snapshot,
+                      uint64_t num_counters) {
+  static constexpr absl::string_view Suffixes[] = {
+      "upstream_rq_total", "upstream_rq_2xx",         "upstream_rq_5xx",
+      "upstream_cx_total", "upstream_cx_destroy",     "upstream_rq_retry",
+      "lb_healthy_panic",  "membership_change",       "upstream_rq_timeout",
+      "upstream_cx_none_healthy"};
+  snapshot.counters_.reserve(num_counters);
+  for (uint64_t i = 0; i < num_counters; ++i) {
+    Stats::Counter& counter = store.rootScope()->counterFromString(absl::StrCat(
+        "cluster.service_", i / std::size(Suffixes), ".", Suffixes[i % std::size(Suffixes)]));
+    snapshot.counters_.push_back({1, counter});
+  }
+}
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+void firstFlush(::benchmark::State& state) {
+  const uint64_t num_counters = state.range(0);
+  if (benchmark::skipExpensiveBenchmarks() && num_counters > 100000) {
+    state.SkipWithError("Skipping expensive benchmark");
+    return;
+  }
+  Stats::IsolatedStoreImpl store;
+  TestSnapshot snapshot;
+  populateSnapshot(store, snapshot, num_counters);
+
+  uint64_t bytes = 0;
+  for (auto _ : state) {
+    UNREFERENCED_PARAMETER(_);
+    Encoder encoder(store.symbolTable(), 64 * 1024, 5);
+    bytes = 0;
+    encoder.encode(snapshot, [&bytes](absl::string_view frame) { bytes += frame.size(); });
+  }
+  state.SetItemsProcessed(state.iterations() * num_counters);
+  state.counters["bytes_per_flush"] = bytes;
+}
+BENCHMARK(firstFlush)->RangeMultiplier(10)->Range(1000, 1000000)->Unit(::benchmark::kMillisecond);
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+void steadyStateFlush(::benchmark::State& state) {
+  const uint64_t num_counters = state.range(0);
+  if (benchmark::skipExpensiveBenchmarks() && num_counters > 100000) {
+    state.SkipWithError("Skipping expensive benchmark");
+    return;
+  }
+  Stats::IsolatedStoreImpl store;
+  TestSnapshot snapshot;
+  populateSnapshot(store, snapshot, num_counters);
+  Encoder encoder(store.symbolTable(), 64 * 1024, 5);
+  encoder.encode(snapshot, [](absl::string_view) {});
+  for (uint64_t i = 0; i < num_counters; ++i) {
+    snapshot.counters_[i].delta_ = i % 100 == 0 ? i : 0;
+  }
+
+  uint64_t bytes = 0;
+  for (auto _ : state) {
+    UNREFERENCED_PARAMETER(_);
+    bytes = 0;
+    encoder.encode(snapshot, [&bytes](absl::string_view frame) { bytes += frame.size(); });
+  }
+  state.SetItemsProcessed(state.iterations() * num_counters);
+  state.counters["bytes_per_flush"] = bytes;
+}
+BENCHMARK(steadyStateFlush)
+    ->RangeMultiplier(10)
+    ->Range(1000, 1000000)
+    ->Unit(::benchmark::kMillisecond);
+
+} // namespace
+} // namespace LocalBinary
+} // namespace StatSinks
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,409 @@
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "source/common/network/address_impl.h"
+#include "source/common/stats/histogram_impl.h"
+#include "source/extensions/stat_sinks/local_binary/decoder.h"
+#include "source/extensions/stat_sinks/local_binary/encoder.h"
+#include "source/extensions/stat_sinks/local_binary/local_binary_sink.h"
+
+#include "test/common/stats/stat_test_utility.h"
+#include "test/mocks/stats/mocks.h"
+#include "test/test_common/environment.h"
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::NiceMock;
+using testing::Return;
+
+namespace Envoy {
+namespace Extensions {
+namespace StatSinks {
+namespace LocalBinary {
+namespace {
+
+class LocalBinaryEncoderTest : public testing::Test {
+protected:
+  ~LocalBinaryEncoderTest() override {
+    for (histogram_t* hist : hists_) {
+      hist_free(hist);
+    }
+  }
+
+  NiceMock<Stats::MockCounter>& addCounter(const std::string& name, uint64_t delta) {
+    counters_.emplace_back(std::make_unique<NiceMock<Stats::MockCounter>>());
+    counters_.back()->name_ = name;
+    snapshot_.counters_.push_back({delta, *counters_.back()});
+    return *counters_.back();
+  }
+
+  NiceMock<Stats::MockGauge>& addGauge(const std::string& name, uint64_t value) {
+    gauges_.emplace_back(std::make_unique<NiceMock<Stats::MockGauge>>());
+    gauges_.back()->name_ = name;
+    gauges_.back()->value_ = value;
+    snapshot_.gauges_.push_back(*gauges_.back());
+    return *gauges_.back();
+  }
+
+  void addTextReadout(const std::string& name, const std::string& value) {
+    text_readouts_.emplace_back(std::make_unique<NiceMock<Stats::MockTextReadout>>());
+    text_readouts_.back()->name_ = name;
+    text_readouts_.back()->value_ = value;
+    snapshot_.text_readouts_.push_back(*text_readouts_.back());
+  }
+
+  void addHistogram(const std::string& name, const std::vector<double>& values) {
+    histogram_t* hist = hist_alloc();
+    for (const double value : values) {
+      hist_insert(hist, value, 1);
+    }
+    hists_.push_back(hist);
+    hist_stats_.push_back(std::make_unique<Stats::HistogramStatisticsImpl>(hist));
+    histograms_.emplace_back(std::make_unique<NiceMock<Stats::MockParentHistogram>>());
+    histograms_.back()->name_ = name;
+    ON_CALL(*histograms_.back(), intervalStatistics())
+        .WillByDefault(testing::ReturnRef(*hist_stats_.back()));
+    snapshot_.histograms_.push_back(*histograms_.back());
+  }
+
+  // Encodes the snapshot and feeds the frames to the decoder, returning them.
+  std::vector<std::string> flush() {
+    std::vector<std::string> frames;
+    encoder_.encode(snapshot_, [&frames](absl::string_view frame) { frames.emplace_back(frame); });
+    for (const std::string& frame : frames) {
+      EXPECT_OK(decoder_.decodeFrame(frame));
+    }
+    return frames;
+  }
+
+  uint64_t totalBytes(const std::vector<std::string>& frames) {
+    uint64_t bytes = 0;
+    for (const std::string& frame : frames) {
+      bytes += frame.size();
+    }
+    return bytes;
+  }
+
+  Stats::TestUtil::TestSymbolTable symbol_table_;
+  NiceMock<Stats::MockMetricSnapshot> snapshot_;
+  std::vector<std::unique_ptr<NiceMock<Stats::MockCounter>>> counters_;
+  std::vector<std::unique_ptr<NiceMock<Stats::MockGauge>>> gauges_;
+  std::vector<std::unique_ptr<NiceMock<Stats::MockTextReadout>>> text_readouts_;
+  std::vector<std::unique_ptr<NiceMock<Stats::MockParentHistogram>>> histograms_;
+  std::vector<histogram_t*> hists_;
+  std::vector<std::unique_ptr<Stats::HistogramStatisticsImpl>> hist_stats_;
+  Encoder encoder_{*symbol_table_, 64 * 1024, 2};
+  Decoder decoder_;
+};
+
+TEST_F(LocalBinaryEncoderTest, RoundTrip) {
+  addCounter("cluster.foo.upstream_rq", 5);
+  addGauge("cluster.foo.membership_total", 42);
+  addTextReadout("server.version", "1.2.3");
+  addHistogram("cluster.foo.upstream_rq_time", {1, 5, 5, 100});
+
+  const std::vector<std::string> frames = flush();
+  ASSERT_EQ(1, frames.size());
+  EXPECT_TRUE(decoder_.flushComplete());
+  EXPECT_EQ(1, decoder_.sequence());
+  EXPECT_EQ(4, encoder_.numMetrics());
+  // "cluster" and "foo" are shared between the metric names.
+  EXPECT_EQ(7, encoder_.numTokens());
+
+  const Decoder::Metric* counter = decoder_.find("cluster.foo.upstream_rq");
+  ASSERT_NE(nullptr, counter);
+  EXPECT_EQ(MetricType::Counter, counter->type_);
+  EXPECT_EQ(5, counter->value_);
+
+  const Decoder::Metric* gauge = decoder_.find("cluster.foo.membership_total");
+  ASSERT_NE(nullptr, gauge);
+  EXPECT_EQ(MetricType::Gauge, gauge->type_);
+  EXPECT_EQ(42, gauge->value_);
+
+  const Decoder::Metric* text_readout = decoder_.find("server.version");
+  ASSERT_NE(nullptr, text_readout);
+  EXPECT_EQ("1.2.3", text_readout->text_);
+
+  const Decoder::Metric* histogram = decoder_.find("cluster.foo.upstream_rq_time");
+  ASSERT_NE(nullptr, histogram);
+  EXPECT_EQ(MetricType::Histogram, histogram->type_);
+  EXPECT_EQ(4, histogram->interval_sample_count_);
+  EXPECT_DOUBLE_EQ(hist_stats_[0]->sampleSum(), histogram->interval_sample_sum_);
+  EXPECT_EQ(Stats::HistogramSettingsImpl::defaultBuckets(), histogram->bucket_bounds_);
+  uint64_t samples = 0;
+  for (const uint64_t count : histogram->interval_buckets_) {
+    samples += count;
+  }
+  EXPECT_EQ(4, samples);
+}
+
+TEST_F(LocalBinaryEncoderTest, OnlyChangesAreSentAfterFirstFlush) {
+  for (int i = 0; i < 100; ++i) {
+    addCounter(absl::StrCat("cluster.c", i, ".upstream_rq"), 1);
+  }
+  auto& gauge = addGauge("server.live", 10);
+  const uint64_t first_bytes = totalBytes(flush());
+
+  for (auto& counter : snapshot_.counters_) {
+    counter.delta_ = 0;
+  }
+  snapshot_.counters_[7].delta_ = 3;
+  const uint64_t second_bytes = totalBytes(flush());
+  EXPECT_LT(second_bytes * 20, first_bytes);
+  EXPECT_EQ(4, decoder_.find("cluster.c7.upstream_rq")->value_);
+  EXPECT_EQ(1, decoder_.find("cluster.c8.upstream_rq")->value_);
+  EXPECT_EQ(1, decoder_.find("cluster.c8.upstream_rq")->updated_sequence_);
+  EXPECT_EQ(2, decoder_.find("cluster.c7.upstream_rq")->updated_sequence_);
+
+  gauge.value_ = 3;
+  flush();
+  EXPECT_EQ(3, decoder_.find("server.live")->value_);
+}
+
+TEST_F(LocalBinaryEncoderTest, SplitsFramesAtMaxFrameBytes) {
+  Encoder encoder(*symbol_table_, 512, 2);
+  for (int i = 0; i < 200; ++i) {
+    addCounter(absl::StrCat("cluster.c", i, ".upstream_rq"), i + 1);
+  }
+  std::vector<std::string> frames;
+  encoder.encode(snapshot_, [&frames](absl::string_view frame) { frames.emplace_back(frame); });
+  ASSERT_GT(frames.size(), 1);
+  for (size_t i = 0; i < frames.size(); ++i) {
+    EXPECT_LE(frames[i].size(), 512);
+    EXPECT_OK(decoder_.decodeFrame(frames[i]));
+    EXPECT_EQ(i + 1 == frames.size(), decoder_.flushComplete());
+  }
+  for (int i = 0; i < 200; ++i) {
+    EXPECT_EQ(i + 1, decoder_.find(absl::StrCat("cluster.c", i, ".upstream_rq"))->value_);
+  }
+}
+
+TEST_F(LocalBinaryEncoderTest, RetiresMissingMetricsAndReusesIds) {
+  addCounter("a.b", 1);
+  addCounter("a.c", 1);
+  flush();
+  EXPECT_EQ(2, decoder_.metrics().size());
+
+  // "a.c" disappears from the snapshot and is retired after two flushes.
+  snapshot_.counters_.pop_back();
+  flush();
+  EXPECT_EQ(2, decoder_.metrics().size());
+  flush();
+  EXPECT_EQ(1, decoder_.metrics().size());
+  EXPECT_EQ(nullptr, decoder_.find("a.c"));
+
+  addCounter("a.d", 7);
+  flush();
+  EXPECT_EQ(2, encoder_.numMetrics());
+  EXPECT_EQ(7, decoder_.find("a.d")->value_);
+  EXPECT_EQ(4, decoder_.find("a.b")->value_);
+}
+
+TEST_F(LocalBinaryEncoderTest, ResetResendsDictionary) {
+  addCounter("a.b", 1);
+  addGauge("a.g", 5);
+  flush();
+
+  encoder_.reset();
+  Decoder fresh_decoder;
+  std::vector<std::string> frames;
+  encoder_.encode(snapshot_, [&frames](absl::string_view frame) { frames.emplace_back(frame); });
+  for (const std::string& frame : frames) {
+    EXPECT_OK(fresh_decoder.decodeFrame(frame));
+    EXPECT_OK(decoder_.decodeFrame(frame));
+  }
+  EXPECT_EQ(1, fresh_decoder.find("a.b")->value_);
+  EXPECT_EQ(5, fresh_decoder.find("a.g")->value_);
+  // The reset frame also clears what the old decoder knew, so both agree.
+  EXPECT_EQ(1, decoder_.find("a.b")->value_);
+  EXPECT_EQ(5, decoder_.find("a.g")->value_);
+}
+
+TEST_F(LocalBinaryEncoderTest, DecoderWaitsForResetAfterLostFrame) {
+  Encoder encoder(*symbol_table_, 512, 2);
+  for (int i = 0; i < 100; ++i) {
+    addCounter(absl::StrCat("cluster.c", i, ".upstream_rq"), 1);
+  }
+  std::vector<std::string> frames;
+  encoder.encode(snapshot_, [&frames](absl::string_view frame) { frames.emplace_back(frame); });
+  ASSERT_GT(frames.size(), 2);
+
+  // The second frame is lost, so the third one can't be trusted to refer to known metrics.
+  EXPECT_OK(decoder_.decodeFrame(frames[0]));
+  EXPECT_TRUE(decoder_.synced());
+  EXPECT_EQ(absl::StatusCode::kDataLoss, decoder_.decodeFrame(frames[2]).code());
+  EXPECT_FALSE(decoder_.synced());
+  EXPECT_TRUE(decoder_.metrics().empty());
+
+  // Nor can any later frame, until the encoder starts over.
+  snapshot_.counters_[5].delta_ = 2;
+  frames.clear();
+  encoder.encode(snapshot_, [&frames](absl::string_view frame) { frames.emplace_back(frame); });
+  EXPECT_EQ(absl::StatusCode::kDataLoss, decoder_.decodeFrame(frames[0]).code());
+
+  encoder.reset();
+  frames.clear();
+  encoder.encode(snapshot_, [&frames](absl::string_view frame) { frames.emplace_back(frame); });
+  for (const std::string& frame : frames) {
+    EXPECT_OK(decoder_.decodeFrame(frame));
+  }
+  EXPECT_TRUE(decoder_.synced());
+  EXPECT_EQ(100, decoder_.metrics().size());
+  EXPECT_EQ(2, decoder_.find("cluster.c5.upstream_rq")->value_);
+}
+
+TEST_F(LocalBinaryEncoderTest, DecoderRejectsMalformedFrames) {
+  addCounter("a.b", 1);
+  std::vector<std::string> frames;
+  encoder_.encode(snapshot_, [&frames](absl::string_view frame) { frames.emplace_back(frame); });
+  ASSERT_EQ(1, frames.size());
+
+  Decoder decoder;
+  EXPECT_FALSE(decoder.decodeFrame("nope").ok());
+  EXPECT_FALSE(decoder.decodeFrame(frames[0].substr(0, frames[0].size() - 1)).ok());
+  std::string bad_type = frames[0];
+  bad_type.push_back(42);
+  EXPECT_FALSE(decoder.decodeFrame(bad_type).ok());
+
+  // Values for metrics that were never described can't be decoded.
+  snapshot_.counters_[0].delta_ = 2;
+  frames.clear();
+  encoder_.encode(snapshot_, [&frames](absl::string_view frame) { frames.emplace_back(frame); });
+  EXPECT_FALSE(Decoder().decodeFrame(frames[0]).ok());
+}
+
+class MockFrameWriter : public FrameWriter {
+public:
+  MOCK_METHOD(bool, prepareFlush, ());
+  MOCK_METHOD(bool, write, (absl::string_view frame));
+};
+
+TEST_F(LocalBinaryEncoderTest, SinkStartsOverAfterFailedWrite) {
+  addCounter("a.b", 1);
+  auto writer = std::make_unique<MockFrameWriter>();
+  MockFrameWriter& writer_ref = *writer;
+  LocalBinarySink sink(*symbol_table_, std::move(writer), 64 * 1024, 5);
+
+  std::vector<std::string> frames;
+  EXPECT_CALL(writer_ref, prepareFlush()).WillRepeatedly(Return(false));
+  EXPECT_CALL(writer_ref, write(testing::_))
+      .WillOnce(Return(false))
+      .WillOnce([&frames](absl::string_view frame) {
+        frames.emplace_back(frame);
+        return true;
+      });
+  sink.flush(snapshot_);
+  sink.flush(snapshot_);
+
+  ASSERT_EQ(1, frames.size());
+  EXPECT_OK(decoder_.decodeFrame(frames[0]));
+  EXPECT_EQ(1, decoder_.find("a.b")->value_);
+}
+
+// Captures the frames instead of sending them, keeping the resync schedule of the datagram writer.
+class CapturingDatagramFrameWriter : public DatagramFrameWriter {
+public:
+  CapturingDatagramFrameWriter(std::vector<std::string>& frames, uint32_t resync_interval_flushes)
+      : DatagramFrameWriter(Network::Address::PipeInstance::create(
+                                TestEnvironment::unixDomainSocketPath("local_binary_stats.sock"))
+                                .value(),
+                            resync_interval_flushes),
+        frames_(frames) {}
+
+  bool write(absl::string_view frame) override {
+    frames_.emplace_back(frame);
+    return true;
+  }
+
+private:
+  std::vector<std::string>& frames_;
+};
+
+TEST_F(LocalBinaryEncoderTest, LateDatagramReceiverDecodesAfterResync) {
+  addCounter("a.b", 1);
+  addGauge("a.g", 5);
+  std::vector<std::string> frames;
+  LocalBinarySink sink(*symbol_table_,
+                       std::make_unique<CapturingDatagramFrameWriter>(frames, 3), 64 * 1024, 5);
+
+  // The receiver starts after the first flush, which carried the dictionary, so it can't decode
+  // the second one.
+  sink.flush(snapshot_);
+  frames.clear();
+  Decoder late;
+  sink.flush(snapshot_);
+  ASSERT_EQ(1, frames.size());
+  EXPECT_EQ(absl::StatusCode::kDataLoss, late.decodeFrame(frames[0]).code());
+  frames.clear();
+
+  // The third flush starts over and describes every metric again.
+  gauges_[0]->value_ = 7;
+  sink.flush(snapshot_);
+  ASSERT_EQ(1, frames.size());
+  EXPECT_OK(late.decodeFrame(frames[0]));
+  EXPECT_TRUE(late.synced());
+  EXPECT_EQ(1, late.find("a.b")->value_);
+  EXPECT_EQ(7, late.find("a.g")->value_);
+
+  // Following flushes decode normally.
+  frames.clear();
+  sink.flush(snapshot_);
+  ASSERT_EQ(1, frames.size());
+  EXPECT_OK(late.decodeFrame(frames[0]));
+  EXPECT_EQ(2, late.find("a.b")->value_);
+}
+
+TEST(DatagramFrameWriterTest, ResyncInterval) {
+  auto address = Network::Address::PipeInstance::create(
+                     TestEnvironment::unixDomainSocketPath("local_binary_stats.sock"))
+                     .value();
+  DatagramFrameWriter writer(address, 3);
+  std::vector<bool> resyncs;
+  for (int i = 0; i < 7; ++i) {
+    resyncs.push_back(writer.prepareFlush());
+  }
+  EXPECT_EQ(std::vector<bool>({false, false, true, false, false, true, false}), resyncs);
+
+  DatagramFrameWriter never(address, 0);
+  for (int i = 0; i < 7; ++i) {
+    EXPECT_FALSE(never.prepareFlush());
+  }
+}
+
+TEST_F(LocalBinaryEncoderTest, FileWriterTruncatesAndStartsOver) {
+  Api::ApiPtr api = Api::createApiForTest();
+  const std::string path = TestEnvironment::temporaryPath("local_binary_stats");
+  for (int i = 0; i < 50; ++i) {
+    addCounter(absl::StrCat("cluster.c", i, ".upstream_rq"), 1);
+  }
+  LocalBinarySink sink(
+      *symbol_table_,
+      std::make_unique<FileFrameWriter>(
+          api->fileSystem().createFile({Filesystem::DestinationType::File, path}), 256),
+      64 * 1024, 5);
+
+  sink.flush(snapshot_);
+  Decoder decoder;
+  EXPECT_OK(decoder.decodeFile(api->fileSystem().fileReadToEnd(path).value()));
+  EXPECT_EQ(50, decoder.metrics().size());
+  const uint64_t first_size = api->fileSystem().fileSize(path);
+  EXPECT_GT(first_size, 256);
+
+  // The file is over its limit, so the next flush truncates it and describes every metric again.
+  snapshot_.counters_[3].delta_ = 4;
+  sink.flush(snapshot_);
+  Decoder restarted;
+  EXPECT_OK(restarted.decodeFile(api->fileSystem().fileReadToEnd(path).value()));
+  EXPECT_EQ(50, restarted.metrics().size());
+  EXPECT_EQ(4, restarted.find("cluster.c3.upstream_rq")->value_);
+  EXPECT_EQ(1, restarted.sequence() - decoder.sequence());
+}
+
+} // namespace
+} // namespace LocalBinary
+} // namespace StatSinks
+} // namespace Extensions
+} // namespace Envoy
@@ -91,6 +91,12 @@ public:
     return timer;
   }
 
+  // Wheel timers are created through createTimer_(), so that tests can expect a MockTimer whichever
+  // kind of timer the code under test uses.
+  Event::TimerPtr createWheelTimer(Event::TimerCb cb) override {
+    return createTimer(std::move(cb));
+  }
+
   Event::SchedulableCallbackPtr createSchedulableCallback(std::function<void()> cb) override {
     auto schedulable_cb = Event::SchedulableCallbackPtr{createSchedulableCallback_(cb)};
     if (!allow_null_callback_) {
@@ -118,6 +124,7 @@ public:
   MOCK_METHOD(void, registerWatchdog,
               (const Server::WatchDogSharedPtr&, std::chrono::milliseconds));
   MOCK_METHOD(void, initializeStats, (Stats::Scope&, const absl::optional<std::string>&));
+  MOCK_METHOD(void, initializeSlowCallbackTracker, (const SlowCallbackTrackerConfig&));
   MOCK_METHOD(void, clearDeferredDeleteList, ());
   MOCK_METHOD(Network::ServerConnection*, createServerConnection_, (StreamInfo::StreamInfo & info));
   MOCK_METHOD(Network::ClientConnection*, createClientConnection_,
@@ -31,6 +31,10 @@ public:
     impl_.initializeStats(scope, prefix);
   }
 
+  void initializeSlowCallbackTracker(const SlowCallbackTrackerConfig& config) override {
+    impl_.initializeSlowCallbackTracker(config);
+  }
+
   void clearDeferredDeleteList() override { impl_.clearDeferredDeleteList(); }
 
   Network::ServerConnectionPtr
@@ -69,6 +73,8 @@ public:
     return impl_.createScaledTimer(timer_type, std::move(cb));
   }
 
+  TimerPtr createWheelTimer(TimerCb cb) override { return impl_.createWheelTimer(std::move(cb)); }
+
   Event::SchedulableCallbackPtr createSchedulableCallback(std::function<void()> cb) override {
     return impl_.createSchedulableCallback(std::move(cb));
   }
@@ -715,6 +715,7 @@ public:
   MOCK_METHOD(bool, addProxyProtocolConnectionState, (), (const));
   MOCK_METHOD((const absl::flat_hash_set<uint32_t>&), httpsDestinationPorts, (), (const));
   MOCK_METHOD((const absl::flat_hash_set<uint32_t>&), httpDestinationPorts, (), (const));
+  MOCK_METHOD(FilterInstrumentation*, filterInstrumentation, ());
 
   class AllowInternalAddressConfig : public Http::InternalAddressConfig {
   public:
@@ -19,8 +19,10 @@ public:
   MOCK_METHOD(bool, useDynamicBaseId, (), (const));
   MOCK_METHOD(bool, skipHotRestartOnNoParent, (), (const));
   MOCK_METHOD(bool, skipHotRestartParentStats, (), (const));
+  MOCK_METHOD(uint64_t, hotRestartStatsCapacity, (), (const));
   MOCK_METHOD(const std::string&, baseIdPath, (), (const));
   MOCK_METHOD(uint32_t, concurrency, (), (const));
+  MOCK_METHOD(uint32_t, startupConcurrency, (), (const));
   MOCK_METHOD(const std::string&, configPath, (), (const));
   MOCK_METHOD(const envoy::config::bootstrap::v3::Bootstrap&, configProto, (), (const));
   MOCK_METHOD(const std::string&, configYaml, (), (const));
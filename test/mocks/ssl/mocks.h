@@ -31,6 +31,14 @@ public:
   MOCK_METHOD(absl::StatusOr<ServerContextSharedPtr>, createSslServerContext,
               (Stats::Scope & stats, const ServerContextConfig& config,
                ContextAdditionalInitFunc additional_init));
+  MOCK_METHOD(Common::CallbackHandlePtr, deferSslClientContext,
+              (Stats::Scope & scope, const ClientContextConfig& config,
+               ClientContextReadyCb on_ready));
+  MOCK_METHOD(Common::CallbackHandlePtr, deferSslServerContext,
+              (Stats::Scope & scope, const ServerContextConfig& config,
+               ServerContextReadyCb on_ready));
+  MOCK_METHOD(void, deferContextBuilds, (uint32_t concurrency));
+  MOCK_METHOD(absl::Status, buildDeferredContexts, ());
   MOCK_METHOD(absl::optional<uint32_t>, daysUntilFirstCertExpires, (), (const));
   MOCK_METHOD(absl::optional<uint64_t>, secondsUntilFirstOcspResponseExpires, (), (const));
   MOCK_METHOD(void, iterateContexts, (std::function<void(const Context&)> callback));
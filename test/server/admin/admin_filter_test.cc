@@ -1,6 +1,8 @@
 #include "source/server/admin/admin.h"
 #include "source/server/admin/admin_filter.h"
 
+#include "test/mocks/buffer/mocks.h"
+#include "test/mocks/event/mocks.h"
 #include "test/mocks/server/instance.h"
 #include "test/test_common/environment.h"
 
@@ -9,6 +11,7 @@
 
 using testing::ByMove;
 using testing::InSequence;
+using testing::Invoke;
 using testing::NiceMock;
 using testing::Return;
 
@@ -73,5 +76,48 @@ TEST_P(AdminFilterTest, Trailers) {
   EXPECT_EQ(Http::FilterTrailersStatus::StopIteration, filter_.decodeTrailers(request_trailers));
 }
 
+// Writes three chunks.
+class ThreeChunkRequest : public Admin::Request {
+public:
+  Http::Code start(Http::ResponseHeaderMap&) override { return Http::Code::OK; }
+  bool nextChunk(Buffer::Instance& response) override {
+    response.add(absl::StrCat("chunk", chunks_));
+    return ++chunks_ < 3;
+  }
+
+private:
+  uint32_t chunks_{};
+};
+
+TEST(AdminFilterFlowControlTest, PausesAboveHighWatermark) {
+  NiceMock<MockAdmin> admin;
+  AdminFilter filter(admin);
+  NiceMock<Http::MockStreamDecoderFilterCallbacks> callbacks;
+  filter.setDecoderFilterCallbacks(callbacks);
+  Http::TestRequestHeaderMapImpl request_headers{{":path", "/"}};
+  EXPECT_CALL(admin, makeRequest(_))
+      .WillOnce(Return(ByMove(std::make_unique<ThreeChunkRequest>())));
+  auto* resume_callback = new NiceMock<Event::MockSchedulableCallback>(&callbacks.dispatcher_);
+
+  EXPECT_CALL(callbacks, addDownstreamWatermarkCallbacks(_));
+  EXPECT_CALL(callbacks, encodeData(BufferStringEqual("chunk0"), false))
+      .WillOnce(Invoke([&filter](Buffer::Instance&, bool) {
+        filter.onAboveWriteBufferHighWatermark();
+        filter.onAboveWriteBufferHighWatermark();
+      }));
+  filter.decodeHeaders(request_headers, true);
+
+  // Chunks are only sent once all the high watermarks have cleared, from the event loop.
+  filter.onBelowWriteBufferLowWatermark();
+  EXPECT_CALL(*resume_callback, scheduleCallbackCurrentIteration());
+  filter.onBelowWriteBufferLowWatermark();
+  EXPECT_CALL(callbacks, encodeData(BufferStringEqual("chunk1"), false));
+  EXPECT_CALL(callbacks, encodeData(BufferStringEqual("chunk2"), true));
+  resume_callback->invokeCallback();
+
+  EXPECT_CALL(callbacks, removeDownstreamWatermarkCallbacks(_));
+  filter.onDestroy();
+}
+
 } // namespace Server
 } // namespace Envoy
@@ -175,6 +175,8 @@ TEST_P(AdminInstanceTest, Help) {
       level: desired logging level, this will change all loggers's level; One of (, trace, debug, info, warning, error, critical, off)
   /memory: print current allocation/heap usage
   /memory/tcmalloc: print TCMalloc stats
+  /profile/cpu: print the recent CPU profile in pprof format (if enabled)
+      seconds: The length of the profile, in seconds. Defaults to, and is capped at, the configured max_window.
   /quitquitquit (POST): exit the server
   /ready: print server state, return 200 if LIVE, otherwise return 503
   /reopen_logs (POST): reopen access logs
@@ -182,6 +184,7 @@ TEST_P(AdminInstanceTest, Help) {
   /runtime: print runtime values
   /runtime_modify (POST): Adds or modifies runtime values as passed in query parameters. To delete a previously added key, use an empty string as the value. Note that deletion only applies to overrides added via this endpoint; values loaded from disk can be modified via override but not deleted. E.g. ?key1=value1&key2=value2...
   /server_info: print server version/status information
+  /slow_callbacks: print the slow event loop callbacks of each thread (if enabled)
   /stats: print server stats
       usedonly: Only include stats that have been written by system since restart
       filter: Regular expression (Google re2) for filtering stats
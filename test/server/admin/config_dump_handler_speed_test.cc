@@ -0,0 +1,106 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+
+#include "envoy/admin/v3/config_dump.pb.h"
+#include "envoy/config/cluster/v3/cluster.pb.h"
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/http/header_map_impl.h"
+#include "source/common/protobuf/utility.h"
+#include "source/server/admin/config_dump_handler.h"
+#include "source/server/admin/config_tracker_impl.h"
+
+#include "test/mocks/server/instance.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Server {
+
+// Serves the dump of a ClustersConfigDump with the given number of dynamic clusters.
+class ConfigDumpTest {
+public:
+  explicit ConfigDumpTest(uint32_t num_clusters) {
+    entry_ = config_tracker_.add("clusters", [num_clusters](const Matchers::StringMatcher&) {
+      auto dump = std::make_unique<envoy::admin::v3::ClustersConfigDump>();
+      dump->set_version_info("v1");
+      for (uint32_t i = 0; i < num_clusters; ++i) {
+        envoy::config::cluster::v3::Cluster cluster;
+        cluster.set_name(absl::StrCat("cluster_", i));
+        cluster.set_type(envoy::config::cluster::v3::Cluster::EDS);
+        cluster.mutable_eds_cluster_config()->set_service_name(absl::StrCat("service_", i));
+        cluster.mutable_connect_timeout()->set_seconds(5);
+        cluster.mutable_circuit_breakers()->add_thresholds()->mutable_max_connections()->set_value(
+            1000);
+        auto* dynamic_cluster = dump->add_dynamic_active_clusters();
+        dynamic_cluster->set_version_info(absl::StrCat(i));
+        dynamic_cluster->mutable_last_updated()->set_seconds(1700000000);
+        dynamic_cluster->mutable_cluster()->PackFrom(cluster);
+      }
+      return dump;
+    });
+  }
+
+  // Builds the whole ConfigDump and serializes it at once, as the handler used to.
+  uint64_t buffered() {
+    Matchers::UniversalStringMatcher matcher;
+    envoy::admin::v3::ConfigDump dump;
+    for (const auto& [name, callback] : config_tracker_.getCallbacksMap()) {
+      dump.add_configs()->PackFrom(*callback(matcher));
+    }
+    MessageUtil::redact(dump);
+    return MessageUtil::getJsonStringFromMessageOrError(dump, true).size();
+  }
+
+  // Streams the dump, returning its size and the largest chunk.
+  uint64_t streamed(uint64_t& max_chunk) {
+    ConfigDumpRequest request(handler_, Http::Utility::QueryParamsMulti());
+    auto response_headers = Http::ResponseHeaderMapImpl::create();
+    RELEASE_ASSERT(request.start(*response_headers) == Http::Code::OK, "");
+    uint64_t size = 0;
+    max_chunk = 0;
+    bool more_data;
+    do {
+      Buffer::OwnedImpl chunk;
+      more_data = request.nextChunk(chunk);
+      size += chunk.length();
+      max_chunk = std::max<uint64_t>(max_chunk, chunk.length());
+    } while (more_data);
+    return size;
+  }
+
+private:
+  testing::NiceMock<MockInstance> server_;
+  ConfigTrackerImpl config_tracker_;
+  ConfigTracker::EntryOwnerPtr entry_;
+  ConfigDumpHandler handler_{config_tracker_, server_};
+};
+
+} // namespace Server
+} // namespace Envoy
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_BufferedConfigDump(benchmark::State& state) {
+  Envoy::Server::ConfigDumpTest test(state.range(0));
+  uint64_t size = 0;
+  for (auto _ : state) { // NOLINT
+    size = test.buffered();
+  }
+  state.SetLabel(absl::StrCat("output per iteration: ", size));
+}
+BENCHMARK(BM_BufferedConfigDump)->Arg(10000)->Arg(50000)->Unit(benchmark::kMillisecond);
+
+// Streams the same output as BM_BufferedConfigDump, reporting the largest chunk that is buffered
+// at a time.
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_StreamedConfigDump(benchmark::State& state) {
+  Envoy::Server::ConfigDumpTest test(state.range(0));
+  uint64_t size = 0;
+  uint64_t max_chunk = 0;
+  for (auto _ : state) { // NOLINT
+    size = test.streamed(max_chunk);
+  }
+  state.SetLabel(absl::StrCat("output per iteration: ", size));
+  state.counters["max_chunk"] = max_chunk;
+}
+BENCHMARK(BM_StreamedConfigDump)->Arg(10000)->Arg(50000)->Unit(benchmark::kMillisecond);
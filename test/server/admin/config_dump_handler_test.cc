@@ -676,6 +676,73 @@ ProtobufTypes::MessagePtr testDumpClustersConfig(const Matchers::StringMatcher&)
   return msg;
 }
 
+ProtobufTypes::MessagePtr testDumpManyClustersConfig(const Matchers::StringMatcher&) {
+  auto msg = std::make_unique<envoy::admin::v3::ClustersConfigDump>();
+  msg->set_version_info("v1");
+  for (int i = 0; i < 20; ++i) {
+    envoy::config::cluster::v3::Cluster cluster;
+    cluster.set_name(absl::StrCat("static_", i));
+    msg->add_static_clusters()->mutable_cluster()->PackFrom(cluster);
+    cluster.set_name(absl::StrCat("dynamic_", i));
+    cluster.mutable_http2_protocol_options()->set_allow_connect(true);
+    auto* dynamic_cluster = msg->add_dynamic_active_clusters();
+    dynamic_cluster->set_version_info(absl::StrCat(i));
+    dynamic_cluster->mutable_cluster()->PackFrom(cluster);
+  }
+  return msg;
+}
+
+// The streamed dump is identical to the serialization of the whole ConfigDump, however it is
+// split into chunks.
+TEST_P(AdminInstanceTest, ConfigDumpStreamsResources) {
+  auto clusters = admin_.getConfigTracker().add("clusters", testDumpManyClustersConfig);
+  auto listeners = admin_.getConfigTracker().add("listeners", [](const Matchers::StringMatcher&) {
+    auto msg = std::make_unique<Protobuf::StringValue>();
+    msg->set_value("listeners_config");
+    return msg;
+  });
+  envoy::admin::v3::ConfigDump dump;
+  Matchers::UniversalStringMatcher matcher;
+  dump.add_configs()->PackFrom(*testDumpManyClustersConfig(matcher));
+  Protobuf::StringValue listeners_config;
+  listeners_config.set_value("listeners_config");
+  dump.add_configs()->PackFrom(listeners_config);
+  const std::string expected_json = MessageUtil::getJsonStringFromMessageOrError(dump, true);
+
+  ConfigDumpHandler handler(admin_.getConfigTracker(), server_);
+  for (const uint64_t chunk_size : {1, 100, 1000000}) {
+    ConfigDumpRequest request(handler, Http::Utility::QueryParamsMulti());
+    request.setChunkSize(chunk_size);
+    Http::TestResponseHeaderMapImpl header_map;
+    EXPECT_EQ(Http::Code::OK, request.start(header_map));
+    EXPECT_EQ(Http::Headers::get().ContentTypeValues.Json, header_map.getContentTypeValue());
+    std::string output;
+    uint32_t chunks = 0;
+    bool more_data;
+    do {
+      Buffer::OwnedImpl chunk;
+      more_data = request.nextChunk(chunk);
+      output += chunk.toString();
+      ++chunks;
+    } while (more_data);
+    EXPECT_EQ(expected_json, output);
+    if (chunk_size == 1000000) {
+      EXPECT_EQ(1, chunks);
+    } else {
+      // At least one chunk per cluster.
+      EXPECT_LT(40, chunks);
+    }
+  }
+}
+
+TEST_P(AdminInstanceTest, ConfigDumpEmpty) {
+  Buffer::OwnedImpl response;
+  Http::TestResponseHeaderMapImpl header_map;
+  EXPECT_EQ(Http::Code::OK, getCallback("/config_dump", header_map, response));
+  EXPECT_EQ(MessageUtil::getJsonStringFromMessageOrError(envoy::admin::v3::ConfigDump(), true),
+            response.toString());
+}
+
 // Test that when using both resource and mask query parameters the JSON output contains
 // only the desired resource and the fields specified in the mask.
 TEST_P(AdminInstanceTest, ConfigDumpFiltersByResourceAndMask) {
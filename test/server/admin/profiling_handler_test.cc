@@ -1,7 +1,9 @@
+#include "source/common/profiler/continuous_cpu_profiler.h"
 #include "source/common/profiler/profiler.h"
 
 #include "test/server/admin/admin_instance.h"
 #include "test/test_common/logging.h"
+#include "test/test_common/utility.h"
 
 namespace Envoy {
 namespace Server {
@@ -108,5 +110,34 @@ TEST_P(AdminInstanceTest, AdminAllocationDump) {
 #endif
 }
 
+TEST_P(AdminInstanceTest, ContinuousCpuProfileNotEnabled) {
+  Buffer::OwnedImpl data;
+  Http::TestResponseHeaderMapImpl header_map;
+  EXPECT_EQ(Http::Code::NotFound, getCallback("/profile/cpu", header_map, data));
+}
+
+#ifdef __linux__
+TEST_P(AdminInstanceTest, ContinuousCpuProfile) {
+  Api::ApiPtr api = Api::createApiForTest();
+  Event::DispatcherPtr dispatcher = api->allocateDispatcher("test_thread");
+  auto profiler_or_error = Profiler::ContinuousCpuProfiler::create({}, *dispatcher);
+  ASSERT_TRUE(profiler_or_error.ok()) << profiler_or_error.status();
+  Profiler::ContinuousCpuProfilerPtr profiler = std::move(profiler_or_error.value());
+
+  Buffer::OwnedImpl data;
+  Http::TestResponseHeaderMapImpl header_map;
+  EXPECT_EQ(Http::Code::OK, getCallback("/profile/cpu?seconds=5", header_map, data));
+  EXPECT_EQ("application/octet-stream", header_map.getContentTypeValue());
+  EXPECT_NE(0, data.length());
+  EXPECT_EQ(Http::Code::OK, getCallback("/profile/cpu", header_map, data));
+  EXPECT_EQ(Http::Code::BadRequest, getCallback("/profile/cpu?seconds=0", header_map, data));
+  EXPECT_EQ(Http::Code::BadRequest, getCallback("/profile/cpu?seconds=abc", header_map, data));
+
+  // The gperftools profiler can't run concurrently.
+  EXPECT_EQ(Http::Code::BadRequest, postCallback("/cpuprofiler?enable=y", header_map, data));
+  EXPECT_FALSE(Profiler::Cpu::profilerEnabled());
+}
+#endif
+
 } // namespace Server
 } // namespace Envoy
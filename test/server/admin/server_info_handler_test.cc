@@ -1,9 +1,12 @@
 #include "envoy/admin/v3/memory.pb.h"
+#include "envoy/admin/v3/slow_callbacks.pb.h"
 
+#include "source/common/event/slow_callback_tracker.h"
 #include "source/common/tls/context_config_impl.h"
 
 #include "test/server/admin/admin_instance.h"
 #include "test/test_common/logging.h"
+#include "test/test_common/simulated_time_system.h"
 #include "test/test_common/test_runtime.h"
 
 using testing::Ge;
@@ -76,6 +79,47 @@ TEST_P(AdminInstanceTest, MemoryTcmalloc) {
 #endif
 }
 
+TEST_P(AdminInstanceTest, SlowCallbacksNotEnabled) {
+  Http::TestResponseHeaderMapImpl header_map;
+  Buffer::OwnedImpl response;
+  EXPECT_EQ(Http::Code::NotFound, getCallback("/slow_callbacks", header_map, response));
+  EXPECT_THAT(response.toString(), HasSubstr("Slow callback tracking is not enabled"));
+}
+
+TEST_P(AdminInstanceTest, SlowCallbacks) {
+  server_.bootstrap_.mutable_slow_callback_tracker();
+  Event::SimulatedTimeSystem time_system;
+  Event::SlowCallbackTracker tracker("test_dispatcher", time_system, std::chrono::milliseconds(10),
+                                     1, 4);
+  {
+    Event::SlowCallbackTracker::ScopedCallback callback(
+        &tracker, Event::SlowCallbackTracker::CallbackType::Timer);
+    time_system.advanceTimeWait(std::chrono::milliseconds(20));
+  }
+
+  Http::TestResponseHeaderMapImpl header_map;
+  Buffer::OwnedImpl response;
+  EXPECT_EQ(Http::Code::OK, getCallback("/slow_callbacks", header_map, response));
+  EXPECT_EQ("application/json", header_map.getContentTypeValue());
+  envoy::admin::v3::SlowCallbacks output_proto;
+  TestUtility::loadFromJson(response.toString(), output_proto);
+  // Other dispatchers of the test process may be tracked too.
+  const envoy::admin::v3::DispatcherSlowCallbacks* dispatcher = nullptr;
+  for (const auto& entry : output_proto.dispatchers()) {
+    if (entry.name() == "test_dispatcher") {
+      dispatcher = &entry;
+    }
+  }
+  ASSERT_NE(nullptr, dispatcher);
+  EXPECT_EQ(1, dispatcher->sampled_callbacks());
+  EXPECT_EQ(1, dispatcher->slow_callbacks());
+  ASSERT_EQ(1, dispatcher->callbacks_size());
+  EXPECT_EQ(envoy::admin::v3::SlowCallback::TIMER, dispatcher->callbacks(0).type());
+  EXPECT_EQ(20000, Protobuf::util::TimeUtil::DurationToMicroseconds(
+                       dispatcher->callbacks(0).duration()));
+  EXPECT_EQ("", dispatcher->callbacks(0).tracked_object());
+}
+
 TEST_P(AdminInstanceTest, GetReadyRequest) {
   NiceMock<Init::MockManager> initManager;
   ON_CALL(server_, initManager()).WillByDefault(ReturnRef(initManager));
@@ -1,7 +1,10 @@
 // Note: this should be run with --compilation_mode=opt, and would benefit from a
 // quiescent system with disabled cstate power management.
 
+#include <chrono>
+
 #include "source/common/buffer/buffer_impl.h"
+#include "source/common/common/utility.h"
 #include "source/common/http/header_map_impl.h"
 #include "source/common/stats/custom_stat_namespaces_impl.h"
 #include "source/common/stats/thread_local_store.h"
@@ -220,8 +223,45 @@ public:
     return count;
   }
 
+  /**
+   * Streams the stats saved in store_ in Prometheus format, draining each chunk.
+   *
+   * @param params the stats parameters.
+   * @param use_cache whether to reuse names cached by previous requests.
+   * @param max_chunk receives the largest chunk size.
+   * @param max_call receives the longest time spent in one call to the request,
+   *        which is dominated by collecting a batch of stats.
+   * @return the total size of the output.
+   */
+  uint64_t prometheusStream(const StatsParams& params, bool use_cache, uint64_t& max_chunk,
+                            std::chrono::nanoseconds& max_call) {
+    Buffer::OwnedImpl data;
+    auto request_headers = Http::RequestHeaderMapImpl::create();
+    auto response_headers = Http::ResponseHeaderMapImpl::create();
+    PrometheusStatsRequest request(*store_, params, cm_, *request_headers, custom_namespaces_,
+                                   use_cache ? &name_cache_ : nullptr);
+    RealTimeSource time_source;
+    MonotonicTime call_start = time_source.monotonicTime();
+    request.start(*response_headers);
+    max_call = time_source.monotonicTime() - call_start;
+    uint64_t count = 0;
+    max_chunk = 0;
+    bool more = true;
+    do {
+      call_start = time_source.monotonicTime();
+      more = request.nextChunk(data);
+      max_call = std::max<std::chrono::nanoseconds>(max_call,
+                                                    time_source.monotonicTime() - call_start);
+      count += data.length();
+      max_chunk = std::max<uint64_t>(max_chunk, data.length());
+      data.drain(data.length());
+    } while (more);
+    return count;
+  }
+
   std::vector<Stats::ScopeSharedPtr> scopes_;
   Envoy::Stats::CustomStatNamespacesImpl custom_namespaces_;
+  PrometheusStatsFormatter::NameCache name_cache_{store_->symbolTable(), custom_namespaces_};
   FastMockClusterManager cm_;
   bool endpoint_stats_initialized_{false};
 };
@@ -391,6 +431,36 @@ BENCHMARK_CAPTURE(BM_AllCountersPrometheus, per_endpoint_stats_disabled, false)
 BENCHMARK_CAPTURE(BM_AllCountersPrometheus, per_endpoint_stats_enabled, true)
     ->Unit(benchmark::kMillisecond);
 
+// Streams the same output as BM_AllCountersPrometheus in chunks, reporting the
+// largest chunk that is buffered at a time, with and without reusing the names
+// cached by previous iterations. Also reports the longest the main thread is
+// blocked in one call, which is mostly the time to collect all the counters, as
+// a metric family can only be rendered once the counters of every scope are
+// collected.
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_AllCountersPrometheusStreaming(benchmark::State& state, bool use_cache) {
+  Envoy::Server::StatsHandlerTest& test_context = testContext(false);
+  Envoy::Server::StatsParams params;
+  Envoy::Buffer::OwnedImpl response;
+  params.parse("?format=prometheus&type=Counters", response);
+
+  uint64_t count;
+  uint64_t max_chunk;
+  std::chrono::nanoseconds max_call;
+  for (auto _ : state) { // NOLINT
+    count = test_context.prometheusStream(params, use_cache, max_chunk, max_call);
+    RELEASE_ASSERT(count > 250 * 1000 * 1000, "expected count > 250M");
+  }
+
+  state.SetLabel(absl::StrCat("output per iteration: ", count));
+  state.counters["max_chunk"] = max_chunk;
+  state.counters["max_call_ms"] =
+      std::chrono::duration_cast<std::chrono::milliseconds>(max_call).count();
+}
+BENCHMARK_CAPTURE(BM_AllCountersPrometheusStreaming, uncached, false)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_AllCountersPrometheusStreaming, cached, true)->Unit(benchmark::kMillisecond);
+
 // NOLINTNEXTLINE(readability-identifier-naming)
 static void BM_UsedCountersPrometheus(benchmark::State& state, bool per_endpoint_stats) {
   Envoy::Server::StatsHandlerTest& test_context = testContext(per_endpoint_stats);
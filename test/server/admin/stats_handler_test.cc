@@ -1430,6 +1430,109 @@ envoy_cluster_upstream_cx_active{cluster="c2"} 12
   EXPECT_EQ(expected_response, code_response.second);
 }
 
+TEST_F(StatsHandlerPrometheusDefaultTest, StreamingMatchesBufferedOutput) {
+  createTestStats();
+  Stats::Histogram& h1 = store_->histogramFromString("h1", Stats::Histogram::Unit::Unspecified);
+  EXPECT_CALL(sink_, onHistogramComplete(Ref(h1), 300));
+  h1.recordValue(300);
+  store_->mergeHistograms([]() -> void {});
+
+  StatsParams params;
+  Buffer::OwnedImpl parse_response;
+  ASSERT_EQ(Http::Code::OK, params.parse("/stats?format=prometheus&text_readouts", parse_response));
+
+  Http::TestResponseHeaderMapImpl buffered_headers;
+  Buffer::OwnedImpl buffered;
+  StatsHandler::prometheusRender(*store_, custom_namespaces_, endpoints_helper_.cm_, params,
+                                 request_headers_, buffered_headers, buffered);
+
+  // Render the stats one family per chunk, twice, so the second request uses
+  // the names cached by the first.
+  PrometheusStatsFormatter::NameCache name_cache(store_->symbolTable(), custom_namespaces_);
+  for (int i = 0; i < 2; ++i) {
+    PrometheusStatsRequest request(*store_, params, endpoints_helper_.cm_, request_headers_,
+                                   custom_namespaces_, &name_cache);
+    request.setChunkSize(1);
+    Http::TestResponseHeaderMapImpl response_headers;
+    EXPECT_EQ(Http::Code::OK, request.start(response_headers));
+    std::string streamed;
+    uint32_t chunks = 0;
+    bool more;
+    do {
+      Buffer::OwnedImpl chunk;
+      more = request.nextChunk(chunk);
+      streamed += chunk.toString();
+      ++chunks;
+    } while (more);
+    EXPECT_EQ(buffered.toString(), streamed);
+    EXPECT_LT(4, chunks);
+    EXPECT_EQ(4, name_cache.size());
+  }
+}
+
+TEST_F(StatsHandlerPrometheusDefaultTest, StreamingInBatchesMatchesBufferedOutput) {
+  createTestStats();
+  // Families of several stats from different scopes, interleaved with
+  // families of a single stat.
+  for (const char* cluster : {"c3", "c4", "c5"}) {
+    Stats::StatNameTagVector tags{{makeStat("cluster"), makeStat(cluster)}};
+    store_->rootScope()
+        ->counterFromStatNameWithTags(makeStat("cluster.upstream.rq.total"), tags)
+        .add(1);
+    store_->rootScope()
+        ->counterFromStatNameWithTags(makeStat("cluster.upstream.cx.none"), tags)
+        .add(2);
+  }
+  store_->counterFromString("a_counter").add(3);
+  store_->counterFromString("z_counter").add(4);
+
+  StatsParams params;
+  Buffer::OwnedImpl parse_response;
+  ASSERT_EQ(Http::Code::OK, params.parse("/stats?format=prometheus", parse_response));
+
+  Http::TestResponseHeaderMapImpl buffered_headers;
+  Buffer::OwnedImpl buffered;
+  StatsHandler::prometheusRender(*store_, custom_namespaces_, endpoints_helper_.cm_, params,
+                                 request_headers_, buffered_headers, buffered);
+
+  // A batch smaller than a family still holds the whole family.
+  for (const uint64_t batch_size : {1, 2, 5, 1000}) {
+    PrometheusStatsRequest request(*store_, params, endpoints_helper_.cm_, request_headers_,
+                                   custom_namespaces_, nullptr);
+    request.setBatchSize(batch_size);
+    Http::TestResponseHeaderMapImpl response_headers;
+    EXPECT_EQ(Http::Code::OK, request.start(response_headers));
+    std::string streamed;
+    uint32_t calls = 0;
+    bool more;
+    do {
+      Buffer::OwnedImpl chunk;
+      more = request.nextChunk(chunk);
+      streamed += chunk.toString();
+      ++calls;
+    } while (more);
+    EXPECT_EQ(buffered.toString(), streamed) << "batch size " << batch_size;
+    // Each call collects at most one batch, so smaller batches take more calls.
+    if (batch_size == 1) {
+      EXPECT_LT(6, calls);
+    }
+  }
+}
+
+TEST_F(StatsHandlerPrometheusDefaultTest, NameCacheSweepsUnusedNames) {
+  PrometheusStatsFormatter::NameCache name_cache(store_->symbolTable(), custom_namespaces_);
+  const absl::optional<std::string>& name = name_cache.metricName(makeStat("cluster.rq"));
+  EXPECT_EQ("envoy_cluster_rq", name);
+  EXPECT_EQ(&name, &name_cache.metricName(makeStat("cluster.rq")));
+  EXPECT_EQ("a_b", name_cache.tagName("a.b"));
+
+  name_cache.sweep();
+  EXPECT_EQ(1, name_cache.size());
+  // The name was not looked up since the previous sweep.
+  name_cache.sweep();
+  EXPECT_EQ(0, name_cache.size());
+}
+
 TEST_F(StatsHandlerPrometheusDefaultTest, StatsHandlerPrometheusInvalidRegex) {
   const std::string url = "/stats?format=prometheus&filter=(+invalid)";
 
@@ -24,6 +24,7 @@ using testing::_;
 using testing::AnyNumber;
 using testing::Invoke;
 using testing::InvokeWithoutArgs;
+using testing::Return;
 using testing::WithArg;
 
 namespace Envoy {
@@ -68,7 +69,7 @@ public:
     EXPECT_CALL(os_sys_calls_, bind(_, _, _)).Times(4);
 
     // Test we match the correct stat with empty-slots before, after, or both.
-    hot_restart_ = std::make_unique<HotRestartImpl>(0, 0, socket_addr_, 0, false, false);
+    hot_restart_ = std::make_unique<HotRestartImpl>(0, 0, socket_addr_, 0, false, false, 0);
     hot_restart_->drainParentListeners();
 
     // We close both sockets, both ends, totaling 4.
@@ -134,7 +135,7 @@ TEST_P(DomainSocketErrorTest, DomainSocketAlreadyInUse) {
   });
   EXPECT_CALL(os_sys_calls_, close(_)).Times(GetParam());
 
-  EXPECT_THROW(std::make_unique<HotRestartImpl>(0, 0, socket_addr_, 0, false, false),
+  EXPECT_THROW(std::make_unique<HotRestartImpl>(0, 0, socket_addr_, 0, false, false, 0),
                Server::HotRestartDomainSocketInUseException);
 }
 
@@ -150,7 +151,7 @@ TEST_P(DomainSocketErrorTest, DomainSocketError) {
   });
   EXPECT_CALL(os_sys_calls_, close(_)).Times(GetParam());
 
-  EXPECT_THROW(std::make_unique<HotRestartImpl>(0, 0, socket_addr_, 0, false, false),
+  EXPECT_THROW(std::make_unique<HotRestartImpl>(0, 0, socket_addr_, 0, false, false, 0),
                EnvoyException);
 }
 
@@ -276,8 +277,9 @@ TEST_F(HotRestartImplTest, IsInitializingReflectsLifecyclePhases) {
   // Create the parent process first (restart_epoch == 0), and it should start in initializing
   // state.
   std::unique_ptr<HotRestartImpl> hri_epoch0;
-  ASSERT_NO_THROW(
-      { hri_epoch0 = std::make_unique<HotRestartImpl>(1, 0, socket_path, mode, false, false); });
+  ASSERT_NO_THROW({
+    hri_epoch0 = std::make_unique<HotRestartImpl>(1, 0, socket_path, mode, false, false, 0);
+  });
   EXPECT_TRUE(hri_epoch0->isInitializing());
 
   // Simulate the parent finishing its initialization by clearing the flag.
@@ -288,13 +290,70 @@ TEST_F(HotRestartImplTest, IsInitializingReflectsLifecyclePhases) {
 
   // Create the child process (restart_epoch > 0).
   std::unique_ptr<HotRestartImpl> hri_epoch1;
-  ASSERT_NO_THROW(
-      { hri_epoch1 = std::make_unique<HotRestartImpl>(0, 1, socket_path, mode, false, false); });
+  ASSERT_NO_THROW({
+    hri_epoch1 = std::make_unique<HotRestartImpl>(0, 1, socket_path, mode, false, false, 0);
+  });
   EXPECT_TRUE(hri_epoch1->isInitializing());
 
   // Ensure that the child's flag is cleared after call to drain parent listeners.
   ASSERT_NO_THROW({ hri_epoch1->drainParentListeners(); });
   EXPECT_FALSE(hri_epoch1->isInitializing());
 }
+
+class SharedStatRegionAttachTest : public testing::Test {
+public:
+  Api::MockOsSysCalls os_sys_calls_;
+  TestThreadsafeSingletonInjector<Api::OsSysCallsImpl> os_calls{&os_sys_calls_};
+  Api::MockHotRestartOsSysCalls hot_restart_os_sys_calls_;
+  TestThreadsafeSingletonInjector<Api::HotRestartOsSysCallsImpl> hot_restart_os_calls{
+      &hot_restart_os_sys_calls_};
+  std::vector<uint64_t> buffer_;
+};
+
+TEST_F(SharedStatRegionAttachTest, NoCapacity) {
+  EXPECT_CALL(hot_restart_os_sys_calls_, shmOpen(_, _, _)).Times(0);
+  EXPECT_EQ(nullptr, attachSharedStatRegion(0, 0, 0));
+}
+
+// The first process creates the region, and its child attaches to it with the size it was
+// created with.
+TEST_F(SharedStatRegionAttachTest, CreateAndAttach) {
+  EXPECT_CALL(hot_restart_os_sys_calls_, shmUnlink(_));
+  EXPECT_CALL(hot_restart_os_sys_calls_, shmOpen(_, O_RDWR | O_CREAT | O_EXCL, _))
+      .WillOnce(Return(Api::SysCallIntResult{7, 0}));
+  EXPECT_CALL(os_sys_calls_, ftruncate(7, _)).WillOnce(WithArg<1>(Invoke([this](off_t size) {
+    buffer_.resize(size / sizeof(uint64_t));
+    return Api::SysCallIntResult{0, 0};
+  })));
+  EXPECT_CALL(os_sys_calls_, mmap(_, _, _, _, 7, _)).WillRepeatedly(InvokeWithoutArgs([this]() {
+    return Api::SysCallPtrResult{buffer_.data(), 0};
+  }));
+  EXPECT_CALL(os_sys_calls_, close(7)).Times(2);
+  Stats::SharedStatRegionPtr parent_region = attachSharedStatRegion(10, 0, 1000);
+  ASSERT_NE(nullptr, parent_region);
+  EXPECT_EQ(1024, parent_region->capacity());
+  parent_region->findOrAllocate("a")->value_ = 42;
+
+  EXPECT_CALL(hot_restart_os_sys_calls_, shmOpen(_, O_RDWR, _))
+      .WillOnce(Return(Api::SysCallIntResult{7, 0}));
+  EXPECT_CALL(os_sys_calls_, fstat(7, _)).WillOnce(Invoke([this](int, struct stat* buf) {
+    buf->st_size = buffer_.size() * sizeof(uint64_t);
+    return Api::SysCallIntResult{0, 0};
+  }));
+  // The parent's capacity wins over the child's.
+  Stats::SharedStatRegionPtr child_region = attachSharedStatRegion(10, 1, 10);
+  ASSERT_NE(nullptr, child_region);
+  EXPECT_EQ(1024, child_region->capacity());
+  EXPECT_EQ(42, child_region->findOrAllocate("a")->value_);
+}
+
+// A child whose parent did not share stats falls back to having them transferred over RPC.
+TEST_F(SharedStatRegionAttachTest, ParentWithoutRegion) {
+  EXPECT_CALL(hot_restart_os_sys_calls_, shmUnlink(_)).Times(0);
+  EXPECT_CALL(hot_restart_os_sys_calls_, shmOpen(_, O_RDWR, _))
+      .WillOnce(Return(Api::SysCallIntResult{-1, ENOENT}));
+  EXPECT_LOG_CONTAINS("warn", "cannot open shared stats region /envoy_shared_stats_10",
+                      EXPECT_EQ(nullptr, attachSharedStatRegion(10, 1, 1000)));
+}
 } // namespace Server
 } // namespace Envoy
@@ -2,9 +2,11 @@
 
 #include "source/common/api/os_sys_calls_impl.h"
 #include "source/common/network/address_impl.h"
+#include "source/common/stats/utility.h"
 #include "source/server/hot_restarting_child.h"
 #include "source/server/hot_restarting_parent.h"
 
+#include "test/common/stats/stat_test_utility.h"
 #include "test/mocks/network/mocks.h"
 #include "test/mocks/server/instance.h"
 #include "test/mocks/server/listener_manager.h"
@@ -174,6 +176,27 @@ TEST_F(HotRestartingChildTest, ParentDrainedCallbacksAreCalledImmediatelyWhenAlr
                                                        callback2.AsStdFunction());
 }
 
+// With shared memory stats, the parent withdraws its contribution to the generation gauge when it
+// exits, so the child carries it over when terminating the parent.
+TEST_F(HotRestartingChildTest, RetainsSharedParentGeneration) {
+  Stats::TestUtil::TestStore store;
+  Stats::Gauge& generation = Stats::Utility::gaugeFromElements(
+      *store.rootScope(), {Stats::DynamicName("server.hot_restart_generation")},
+      Stats::Gauge::ImportMode::Accumulate);
+  // The parent's contribution.
+  generation.set(1);
+  hot_restarting_child_->retainSharedParentGeneration(*store.rootScope());
+  // The parent exits, and the child contributes its own.
+  generation.set(0);
+  generation.inc();
+  fake_parent_->expectParentTerminateMessages();
+  hot_restarting_child_->sendParentTerminateRequest();
+  EXPECT_EQ(2, generation.value());
+  // Terminating again has no effect.
+  hot_restarting_child_->sendParentTerminateRequest();
+  EXPECT_EQ(2, generation.value());
+}
+
 TEST_F(HotRestartingChildTest, LogsErrorOnReplyMessageInUdpStream) {
   envoy::HotRestartMessage msg;
   msg.mutable_reply();
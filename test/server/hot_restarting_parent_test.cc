@@ -365,6 +365,25 @@ TEST_F(HotRestartingParentTest, ExportStatsToChild) {
   }
 }
 
+// A child sharing stats with us in shared memory only needs the server stats.
+TEST_F(HotRestartingParentTest, ExportSharedMemoryStatsToChild) {
+  Stats::TestUtil::TestStore store;
+  MockListenerManager listener_manager;
+  EXPECT_CALL(server_, listenerManager()).WillRepeatedly(ReturnRef(listener_manager));
+  EXPECT_CALL(listener_manager, numConnections()).WillRepeatedly(Return(3));
+  EXPECT_CALL(server_, stats()).Times(0);
+
+  store.counter("c1").inc();
+  store.gauge("g1", Stats::Gauge::ImportMode::Accumulate).set(123);
+  HotRestartMessage::Reply::Stats stats;
+  hot_restarting_parent_.exportStatsToChild(&stats, true);
+  EXPECT_EQ(0, stats.counter_deltas_size());
+  EXPECT_EQ(0, stats.gauges_size());
+  EXPECT_EQ(3, stats.num_connections());
+  // The counter was not latched, so it is still exported to a child which doesn't share stats.
+  EXPECT_EQ(1, store.counter("c1").latch());
+}
+
 TEST_F(HotRestartingParentTest, RetainDynamicStats) {
   MockListenerManager listener_manager;
   Stats::SymbolTableImpl parent_symbol_table;
@@ -110,6 +110,8 @@ TEST_F(OptionsImplTest, All) {
       "--file-flush-interval-msec 9000 "
       "--skip-hot-restart-on-no-parent "
       "--skip-hot-restart-parent-stats "
+      "--hot-restart-stats-capacity 1000000 "
+      "--startup-concurrency 8 "
       "--drain-time-s 60 --log-format [%v] --parent-shutdown-time-s 90 "
       "--log-path "
       "/foo/bar "
@@ -120,6 +122,7 @@ TEST_F(OptionsImplTest, All) {
       "--socket-path /foo/envoy_domain_socket --socket-mode 644");
   EXPECT_EQ(Server::Mode::Validate, options->mode());
   EXPECT_EQ(2U, options->concurrency());
+  EXPECT_EQ(8U, options->startupConcurrency());
   EXPECT_EQ("hello", options->configPath());
   EXPECT_EQ("path", options->adminAddressPath());
   EXPECT_EQ(Network::Address::IpVersion::v6, options->localAddressIpVersion());
@@ -129,6 +132,7 @@ TEST_F(OptionsImplTest, All) {
   EXPECT_EQ("[%v]", options->logFormat());
   EXPECT_TRUE(options->logFormatSet());
   EXPECT_TRUE(options->skipHotRestartParentStats());
+  EXPECT_EQ(1000000U, options->hotRestartStatsCapacity());
   EXPECT_TRUE(options->skipHotRestartOnNoParent());
   EXPECT_EQ("/foo/bar", options->logPath());
   EXPECT_EQ(false, options->enableFineGrainLogging());
@@ -254,6 +258,7 @@ TEST_F(OptionsImplTest, SetAll) {
 
   EXPECT_EQ(options->baseId(), command_line_options->base_id());
   EXPECT_EQ(options->concurrency(), command_line_options->concurrency());
+  EXPECT_EQ(options->startupConcurrency(), command_line_options->startup_concurrency());
   EXPECT_EQ(options->configPath(), command_line_options->config_path());
   EXPECT_EQ(options->configYaml(), command_line_options->config_yaml());
   EXPECT_EQ(options->adminAddressPath(), command_line_options->admin_address_path());
@@ -553,6 +558,7 @@ TEST_F(OptionsImplTest, SkipHotRestartDefaults) {
   std::unique_ptr<OptionsImpl> options = createOptionsImpl({"envoy", "-c", "hello"});
   EXPECT_FALSE(options->skipHotRestartOnNoParent());
   EXPECT_FALSE(options->skipHotRestartParentStats());
+  EXPECT_EQ(0U, options->hotRestartStatsCapacity());
 }
 
 TEST_F(OptionsImplTest, LogFormatOverride) {
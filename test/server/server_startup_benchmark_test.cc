@@ -0,0 +1,158 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+//
+// Measures the time it takes a server to become ready to start its workers, from the construction
+// of the instance to the end of its initialization, for static configurations of N TLS clusters
+// and N / 4 TLS listeners, with the TLS contexts built serially on the main thread
+// (--startup-concurrency 0) and on a pool of startup threads.
+
+#include <memory>
+#include <string>
+
+#include "source/common/common/fmt.h"
+#include "source/common/init/manager_impl.h"
+#include "source/common/network/address_impl.h"
+#include "source/common/thread_local/thread_local_impl.h"
+#include "source/server/instance_impl.h"
+
+#include "test/benchmark/main.h"
+#include "test/integration/server.h"
+#include "test/mocks/common.h"
+#include "test/mocks/server/hot_restart.h"
+#include "test/mocks/server/options.h"
+#include "test/test_common/environment.h"
+#include "test/test_common/test_time.h"
+#include "test/test_common/thread_factory_for_test.h"
+#include "test/test_common/utility.h"
+
+#include "absl/strings/str_cat.h"
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Server {
+
+using testing::NiceMock;
+using testing::Return;
+
+class ServerStartupPerf {
+public:
+  ServerStartupPerf(uint32_t num_clusters, uint32_t startup_concurrency) {
+    options_.config_path_ = TestEnvironment::writeStringToFileForTest(
+        absl::StrCat("server_startup_", num_clusters, ".yaml"), bootstrap(num_clusters));
+    ON_CALL(options_, startupConcurrency()).WillByDefault(Return(startup_concurrency));
+  }
+
+  // Creates and initializes a server, returning once its static configuration is loaded and the
+  // server would start its workers.
+  void start() {
+    stats_store_ = std::make_unique<Stats::TestIsolatedStoreImpl>();
+    thread_local_ = std::make_unique<ThreadLocal::InstanceImpl>();
+    init_manager_ = std::make_unique<Init::ManagerImpl>("Server");
+    server_ = std::make_unique<InstanceImpl>(
+        *init_manager_, options_, time_system_, hooks_, restart_, *stats_store_, fakelock_,
+        std::make_unique<NiceMock<Random::MockRandomGenerator>>(), *thread_local_,
+        Thread::threadFactoryForTest(), Filesystem::fileSystemForTest(), nullptr);
+    server_->initialize(std::make_shared<Network::Address::Ipv4Instance>("127.0.0.1"),
+                        component_factory_);
+  }
+
+  void stop() {
+    server_.reset();
+    init_manager_.reset();
+    thread_local_.reset();
+    stats_store_.reset();
+  }
+
+private:
+  static std::string bootstrap(uint32_t num_clusters) {
+    const std::string certs = TestEnvironment::runfilesPath("test/common/tls/test_data");
+    std::string yaml = "static_resources:\n  clusters:\n";
+    for (uint32_t i = 0; i < num_clusters; ++i) {
+      absl::StrAppend(&yaml, fmt::format(R"EOF(
+  - name: cluster_{0}
+    connect_timeout: 1s
+    load_assignment:
+      cluster_name: cluster_{0}
+      endpoints:
+      - lb_endpoints:
+        - endpoint:
+            address:
+              socket_address:
+                address: 127.0.0.1
+                port_value: {1}
+    transport_socket:
+      name: envoy.transport_sockets.tls
+      typed_config:
+        "@type": type.googleapis.com/envoy.extensions.transport_sockets.tls.v3.UpstreamTlsContext
+        common_tls_context:
+          validation_context:
+            trusted_ca:
+              filename: {2}/ca_cert.pem
+)EOF",
+                                         i, 10000 + i, certs));
+    }
+    absl::StrAppend(&yaml, "  listeners:\n");
+    for (uint32_t i = 0; i < num_clusters / 4; ++i) {
+      absl::StrAppend(&yaml, fmt::format(R"EOF(
+  - name: listener_{0}
+    bind_to_port: false
+    address:
+      socket_address:
+        address: 127.0.0.1
+        port_value: {1}
+    filter_chains:
+    - transport_socket:
+        name: envoy.transport_sockets.tls
+        typed_config:
+          "@type": type.googleapis.com/envoy.extensions.transport_sockets.tls.v3.DownstreamTlsContext
+          common_tls_context:
+            tls_certificates:
+              certificate_chain:
+                filename: {2}/unittest_cert.pem
+              private_key:
+                filename: {2}/unittest_key.pem
+      filters:
+      - name: envoy.filters.network.tcp_proxy
+        typed_config:
+          "@type": type.googleapis.com/envoy.extensions.filters.network.tcp_proxy.v3.TcpProxy
+          stat_prefix: listener_{0}
+          cluster: cluster_{0}
+)EOF",
+                                         i, 20000 + i, certs));
+    }
+    return yaml;
+  }
+
+  NiceMock<MockOptions> options_;
+  DefaultListenerHooks hooks_;
+  NiceMock<MockHotRestart> restart_;
+  Thread::MutexBasicLockable fakelock_;
+  TestComponentFactory component_factory_;
+  Event::GlobalTimeSystem time_system_;
+  std::unique_ptr<Stats::TestIsolatedStoreImpl> stats_store_;
+  ThreadLocal::InstanceImplPtr thread_local_;
+  std::unique_ptr<Init::Manager> init_manager_;
+  std::unique_ptr<InstanceImpl> server_;
+};
+
+} // namespace Server
+} // namespace Envoy
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_ServerTimeToReady(benchmark::State& state) {
+  if (Envoy::benchmark::skipExpensiveBenchmarks() && state.range(0) > 100) {
+    state.SkipWithError("Skipping expensive benchmark");
+    return;
+  }
+  Envoy::Server::ServerStartupPerf server(state.range(0), state.range(1));
+  for (auto _ : state) { // NOLINT
+    server.start();
+
+    state.PauseTiming();
+    server.stop();
+    state.ResumeTiming();
+  }
+}
+BENCHMARK(BM_ServerTimeToReady)
+    ->ArgsProduct({{100, 1000, 8000}, {0, 2, 8}})
+    ->Unit(benchmark::kMillisecond);
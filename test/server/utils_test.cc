@@ -94,6 +94,27 @@ TEST(UtilsTest, MaybeSetApplicationLogFormat) {
   }
 }
 
+TEST(UtilsTest, SlowCallbackTrackerConfig) {
+  {
+    envoy::config::bootstrap::v3::SlowCallbackTracker config;
+    const Event::SlowCallbackTrackerConfig tracker_config = slowCallbackTrackerConfig(config);
+    EXPECT_EQ(std::chrono::milliseconds(50), tracker_config.threshold_);
+    EXPECT_EQ(10, tracker_config.sampling_interval_);
+    EXPECT_EQ(64, tracker_config.max_records_);
+  }
+
+  {
+    envoy::config::bootstrap::v3::SlowCallbackTracker config;
+    config.mutable_threshold()->set_seconds(1);
+    config.mutable_sampling_interval()->set_value(1);
+    config.mutable_max_records()->set_value(8);
+    const Event::SlowCallbackTrackerConfig tracker_config = slowCallbackTrackerConfig(config);
+    EXPECT_EQ(std::chrono::seconds(1), tracker_config.threshold_);
+    EXPECT_EQ(1, tracker_config.sampling_interval_);
+    EXPECT_EQ(8, tracker_config.max_records_);
+  }
+}
+
 } // namespace Utility
 } // namespace Server
 } // namespace Envoy